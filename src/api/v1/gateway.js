@@ -49,6 +49,7 @@ const { createSSEHandler, getBroadcaster } = require('../streaming');
 const { createWebSocketServer } = require('../streaming');
 const { Summarizer } = require('../../intelligence/analysis/summarization');
 const { createSummaryAdapter } = require('news-crawler-db');
+const { startDeferredIndexing, stopDeferredIndexing } = require('../../search/SearchIndexer');
 
 // Default configuration
 const DEFAULT_PORT = 4000;
@@ -121,6 +122,17 @@ function createGatewayApp(options = {}) {
     }
   }
 
+  // Export bodies are read on their own read-only connection: better-sqlite3
+  // runs no other statement on a connection while a row cursor is iterating
+  let contentDb = db;
+  if (!options.db) {
+    try {
+      contentDb = ensureDb(dbPath, { readonly: true });
+    } catch (err) {
+      logger.warn('[gateway] Could not open read connection for exports, sharing the main one:', err.message);
+    }
+  }
+
   // Create adapters
   const apiKeyAdapter = createApiKeyAdapter(db);
   const articlesAdapter = createArticlesAdapter(db);
@@ -293,6 +305,7 @@ function createGatewayApp(options = {}) {
   app.use('/api/v1/export', createExportRouter({
     articlesAdapter,
     domainsAdapter: articlesAdapter,
+    contentDb,
     logger
   }));
 
@@ -408,6 +421,7 @@ function createGatewayApp(options = {}) {
   return {
     app,
     db,
+    contentDb,
     apiKeyAdapter,
     articlesAdapter,
     searchAdapter
@@ -421,10 +435,15 @@ function createGatewayApp(options = {}) {
  */
 async function startGatewayServer(options = {}) {
   const port = options.port || process.env.API_GATEWAY_PORT || DEFAULT_PORT;
-  const { app, db, apiKeyAdapter, articlesAdapter } = createGatewayApp(options);
+  const { app, db, contentDb, apiKeyAdapter, articlesAdapter } = createGatewayApp(options);
   const broadcaster = app.locals.broadcaster;
   const logger = options.logger || console;
 
+  // Queue article index updates and apply them in batches from a timer, so
+  // crawler writes do not re-index row by row and search caching can key on
+  // the stored index generation
+  startDeferredIndexing(db, { logger });
+
   // Start periodic cleanup of rate limit store
   const cleanupInterval = setInterval(() => {
     cleanupStaleEntries();
@@ -434,6 +453,7 @@ async function startGatewayServer(options = {}) {
     const server = app.listen(port, (err) => {
       if (err) {
         clearInterval(cleanupInterval);
+        stopDeferredIndexing(db);
         return reject(err);
       }
 
@@ -478,12 +498,19 @@ async function startGatewayServer(options = {}) {
         close: async () => {
           clearInterval(cleanupInterval);
           wsServer.close();
+          try {
+            stopDeferredIndexing(db);
+          } catch (err) {
+            logger.warn('[gateway] Failed to flush search index queue:', err.message);
+          }
           return new Promise((resolveClose) => {
             server.close(() => {
-              try {
-                db.close();
-              } catch {
-                // Ignore
+              for (const handle of contentDb === db ? [db] : [db, contentDb]) {
+                try {
+                  handle.close();
+                } catch {
+                  // Ignore
+                }
               }
               resolveClose();
             });
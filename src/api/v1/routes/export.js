@@ -14,6 +14,7 @@
  */
 
 const express = require('express');
+const { pipeline } = require('stream');
 const { ExportService } = require('../../../data/export/ExportService');
 
 /**
@@ -23,6 +24,7 @@ const { ExportService } = require('../../../data/export/ExportService');
  * @param {Object} [options.domainsAdapter] - Domains database adapter
  * @param {Object} [options.analyticsAdapter] - Analytics database adapter
  * @param {Object} [options.exportConfig] - Export configuration
+ * @param {Database} [options.contentDb] - Database handle for streaming article bodies (body=true)
  * @param {Object} [options.logger] - Logger instance
  * @returns {express.Router} Export router
  */
@@ -32,6 +34,7 @@ function createExportRouter(options = {}) {
     domainsAdapter,
     analyticsAdapter,
     exportConfig = {},
+    contentDb = null,
     logger = console
   } = options;
 
@@ -42,6 +45,7 @@ function createExportRouter(options = {}) {
       articlesAdapter,
       domainsAdapter: domainsAdapter || articlesAdapter,
       analyticsAdapter,
+      contentDb,
       config: exportConfig,
       logger
     });
@@ -60,8 +64,10 @@ function createExportRouter(options = {}) {
    * - since: Start date (ISO 8601)
    * - until: End date (ISO 8601)
    * - host: Filter by hostname
-   * - limit: Maximum articles (default: 1000, max: 100000)
+   * - limit: Maximum articles (default: 1000, max: 100000; streamed cursor exports
+   *   default to every row and have no maximum)
    * - stream: Use streaming mode (for jsonl/csv)
+   * - body: Include decompressed HTML per article (streaming mode only)
    * - fields: Comma-separated fields for CSV
    */
   router.get('/articles', (req, res) => {
@@ -94,17 +100,36 @@ function createExportRouter(options = {}) {
         fields: req.query.fields ? req.query.fields.split(',').map(f => f.trim()) : null
       };
 
-      // Streaming mode
+      // Streaming mode. A cursor export has no row cap (and no default limit);
+      // OFFSET paging keeps it, since each page gets slower the deeper it goes
       if (req.query.stream === 'true' && (format === 'jsonl' || format === 'csv')) {
+        if (exportService.hasArticleCursor()) {
+          const requested = parseInt(req.query.limit, 10);
+          options.limit = Number.isFinite(requested) && requested > 0 ? requested : undefined;
+        }
+        const includeBody = req.query.body === 'true';
+        if (includeBody && !contentDb) {
+          return res.status(501).json({
+            success: false,
+            error: 'NOT_IMPLEMENTED',
+            message: 'Body export not configured'
+          });
+        }
+
+        const stream = exportService.createExportStream('articles', format, {
+          ...options,
+          includeBody
+        });
         res.setHeader('Content-Type', exportService.getContentType(format));
         res.setHeader('Content-Disposition', `attachment; filename="articles.${format}"`);
 
-        const stream = exportService.createExportStream('articles', format, options);
-        stream.pipe(res);
-        stream.on('error', (err) => {
-          logger.error('[export] Stream error:', err);
-          if (!res.headersSent) {
-            res.status(500).json({ error: 'Stream error' });
+        // pipeline() applies backpressure and stops reading rows if the client disconnects
+        pipeline(stream, res, (err) => {
+          if (err && err.code !== 'ERR_STREAM_PREMATURE_CLOSE') {
+            logger.error('[export] Stream error:', err);
+            if (!res.headersSent) {
+              res.status(500).json({ error: 'Stream error' });
+            }
           }
         });
         return;
@@ -32,7 +32,15 @@ class DecompressionWorkerPool extends EventEmitter {
     this.emit('initialized', { poolSize: this.poolSize });
   }
 
-  async decompress(buffer, algorithm = 'none', metadata = null) {
+  /**
+   * @param {Buffer|Uint8Array} buffer
+   * @param {string} [algorithm='none']
+   * @param {Object} [metadata] - Echoed back on the result
+   * @param {Object} [options]
+   * @param {Buffer} [options.dictionary] - Preset dictionary (deflate/zstd types)
+   * @param {string|number} [options.dictionaryId] - Stable id so each worker receives the dictionary once
+   */
+  async decompress(buffer, algorithm = 'none', metadata = null, options = {}) {
     if (!buffer || buffer.length === 0 || !algorithm || algorithm === 'none') {
       const safeBuffer = buffer ? Buffer.from(buffer) : Buffer.alloc(0);
       return {
@@ -60,7 +68,9 @@ class DecompressionWorkerPool extends EventEmitter {
         reject,
         metadata,
         start: Date.now(),
-        transferable
+        transferable,
+        dictionary: options && options.dictionary ? options.dictionary : null,
+        dictionaryId: options && options.dictionaryId != null ? String(options.dictionaryId) : null
       };
 
       const worker = this.availableWorkers.shift();
@@ -83,12 +93,22 @@ class DecompressionWorkerPool extends EventEmitter {
       algorithm: task.algorithm
     });
 
-    worker.postMessage({
+    const message = {
       type: 'decompress',
       taskId: task.taskId,
       algorithm: task.algorithm,
       buffer: task.transferable
-    }, [task.transferable]);
+    };
+    if (task.dictionary) {
+      // Workers keep dictionaries by id, so each one is copied over only once
+      const known = worker.__dictionaries || (worker.__dictionaries = new Set());
+      message.dictionaryId = task.dictionaryId;
+      if (!task.dictionaryId || !known.has(task.dictionaryId)) {
+        message.dictionary = task.dictionary;
+        if (task.dictionaryId) known.add(task.dictionaryId);
+      }
+    }
+    worker.postMessage(message, [task.transferable]);
 
     this.emit('task-started', {
       taskId: task.taskId,
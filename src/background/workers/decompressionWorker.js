@@ -5,6 +5,17 @@ if (!parentPort) {
   throw new Error('Decompression worker must be run as a worker thread');
 }
 
+const dictionaries = new Map(); // dictionaryId -> Buffer (sent once by the pool)
+
+function resolveDictionary(msg) {
+  if (msg.dictionary) {
+    const dictionary = Buffer.from(msg.dictionary.buffer || msg.dictionary, msg.dictionary.byteOffset || 0, msg.dictionary.byteLength);
+    if (msg.dictionaryId) dictionaries.set(msg.dictionaryId, dictionary);
+    return dictionary;
+  }
+  return msg.dictionaryId ? dictionaries.get(msg.dictionaryId) || null : null;
+}
+
 parentPort.on('message', (msg) => {
   if (!msg || msg.type !== 'decompress' || !msg.taskId) {
     return;
@@ -13,7 +24,7 @@ parentPort.on('message', (msg) => {
   try {
     const start = Date.now();
     const compressed = Buffer.isBuffer(msg.buffer) ? msg.buffer : Buffer.from(msg.buffer);
-    const result = decompress(compressed, msg.algorithm);
+    const result = decompress(compressed, msg.algorithm, { dictionary: resolveDictionary(msg) });
     const output = Buffer.isBuffer(result) ? result : Buffer.from(result);
 
     parentPort.postMessage({
@@ -2,12 +2,16 @@
 
 const cheerio = require('cheerio');
 const crypto = require('crypto');
-const { Readability } = require('@mozilla/readability');
 const { extractSchemaSignals } = require('./schemaSignals');
-const { createJsdom } = require('../../shared/utils/jsdomUtils');
+const { resolveParsedDocument } = require('../../shared/utils/ParsedDocument');
+const { findArticleXPath } = require('./pipeline/pageAnalysis');
 const { countWords } = require('../../shared/utils/textMetrics');
+const { hostOf } = require('./telemetry/TelemetryRingBuffer');
 const zlib = require('zlib');
 
+// _persistArticle/_persistHubPage result for saves queued in a write-behind buffer
+const DEFERRED = 'deferred';
+
 class ArticleProcessor {
   constructor(options = {}) {
     const {
@@ -21,7 +25,10 @@ class ArticleProcessor {
       articleHeaderCache,
       knownArticlesCache,
       events,
-      logger
+      logger,
+      analysisPool,
+      stageHistograms,
+      onSaveCommitted
     } = options;
 
     if (!linkExtractor) {
@@ -54,9 +61,18 @@ class ArticleProcessor {
     this.knownArticlesCache = knownArticlesCache || null;
     this.events = events || null;
     this.logger = logger || console;
+    // Optional AnalysisWorkerPool: Readability, schema signals and gzip sizing
+    // run off the event loop when present; in-process otherwise.
+    this.analysisPool = analysisPool && typeof analysisPool.analyze === 'function' ? analysisPool : null;
+    this._offloadStats = { offloaded: 0, fallbacks: 0 };
+    // Optional StageHistograms: Readability and persist latency per host
+    this.stageHistograms = stageHistograms || null;
+    // Write-behind saves are only counted once committed: process() reports
+    // them as deferred and this runs ({kind, url}) when the flush succeeds.
+    this.onSaveCommitted = typeof onSaveCommitted === 'function' ? onSaveCommitted : null;
 
     // P2 diagnostic: track content save decisions for periodic reporting
-    this._contentSaveStats = { total: 0, saved: 0, skippedNotArticle: 0, skippedNoDb: 0, skippedNoPersist: 0, errors: 0 };
+    this._contentSaveStats = { total: 0, saved: 0, deferred: 0, skippedNotArticle: 0, skippedNoDb: 0, skippedNoPersist: 0, errors: 0 };
     this._lastContentStatsLog = 0;
     this._contentStatsInterval = 50; // Log after every N pages processed
     this._dbEnabledWarned = false;
@@ -73,8 +89,10 @@ class ArticleProcessor {
     persistArticle = true,
     insertFetchRecord = true,
     insertLinkRecords = true,
-    linkSummary: providedLinkSummary = null,
-    $: providedCheerio = null
+    linkSummary = null,
+    $ = null,
+    parsedDocument = null,
+    analysis = null
   }) {
     if (!url) {
       throw new Error('ArticleProcessor.process requires url');
@@ -83,13 +101,64 @@ class ArticleProcessor {
       throw new Error('ArticleProcessor.process requires html string');
     }
 
-    const $ = providedCheerio || cheerio.load(html);
+    // Callers that already parsed the page (PageExecutionService) hand in the
+    // shared handle; standalone callers get a private one disposed on return.
+    const resolved = resolveParsedDocument(parsedDocument, html, url);
+    try {
+      const result = await this._processDocument({
+        url,
+        html,
+        fetchMeta,
+        depth,
+        normalizedUrl,
+        referrerUrl,
+        discoveredAt,
+        persistArticle,
+        insertFetchRecord,
+        insertLinkRecords,
+        providedLinkSummary: linkSummary,
+        $: $ || resolved.parsedDocument.$,
+        parsedDocument: resolved.parsedDocument,
+        analysis
+      });
+      result.parseStats = resolved.parsedDocument.getStats();
+      return result;
+    } finally {
+      if (resolved.owned) {
+        resolved.parsedDocument.dispose();
+      }
+    }
+  }
+
+  async _processDocument({
+    url,
+    html,
+    fetchMeta,
+    depth,
+    normalizedUrl,
+    referrerUrl,
+    discoveredAt,
+    persistArticle,
+    insertFetchRecord,
+    insertLinkRecords,
+    providedLinkSummary,
+    $,
+    parsedDocument,
+    analysis: providedAnalysis
+  }) {
+    // Start the off-thread analysis before link extraction so the two overlap.
+    const analysisPromise = this._startOffloadedAnalysis(html, url, providedAnalysis);
+
     const linkSummary = providedLinkSummary || this.linkExtractor.extract($);
     const navigationLinks = linkSummary.navigation || [];
     const articleLinks = linkSummary.articles || [];
     const allLinks = linkSummary.all || [];
 
-    const readability = this._runReadability(html, url);
+    // Off-thread, this measures the wait left after link extraction overlapped it
+    const readabilityStart = this.stageHistograms ? process.hrtime.bigint() : null;
+    const offloaded = analysisPromise ? await analysisPromise : null;
+    const readability = offloaded?.readability || this._runReadability(html, url, parsedDocument);
+    this._recordStage('readability', url, readabilityStart);
     const urlSignals = this.computeUrlSignals(url);
     const contentSignals = this.computeContentSignals($, html);
     const combinedSignals = this.combineSignals(urlSignals, contentSignals, { wordCount: readability.wordCount ?? undefined });
@@ -126,26 +195,27 @@ class ArticleProcessor {
     }
 
     if (persistArticle && isArticle && dbEnabled) {
+      const persistStart = this.stageHistograms ? process.hrtime.bigint() : null;
       articleSaved = await this._persistArticle({
         url,
         html,
+        $,
         metadata,
         readability,
+        offloaded,
         fetchMeta,
         referrerUrl,
         discoveredAt,
         depth
       });
-      if (articleSaved) {
-        this._contentSaveStats.saved++;
-      } else {
-        this._contentSaveStats.errors++;
-      }
+      this._recordStage('persist', url, persistStart);
+      this._noteSaveOutcome(articleSaved);
     } else if (persistArticle && isHub && dbEnabled) {
       // Hub pages are stored via the same upsertArticle path but with hub metadata
       hubSaved = await this._persistHubPage({
         url,
         html,
+        $,
         metadata,
         readability,
         fetchMeta,
@@ -155,11 +225,7 @@ class ArticleProcessor {
         navigationLinks,
         articleLinks
       });
-      if (hubSaved) {
-        this._contentSaveStats.saved++;
-      } else {
-        this._contentSaveStats.errors++;
-      }
+      this._noteSaveOutcome(hubSaved);
     } else if (!persistArticle) {
       this._contentSaveStats.skippedNoPersist++;
     } else if (!isArticle && !isHub) {
@@ -200,7 +266,7 @@ class ArticleProcessor {
       });
     }
 
-    if (articleSaved) {
+    if (articleSaved === true) {
       this.knownArticlesCache?.set(normalizedUrl || url, true);
     }
 
@@ -216,9 +282,11 @@ class ArticleProcessor {
       allLinks,
       statsDelta: {
         articlesFound: isArticle ? 1 : 0,
-        articlesSaved: articleSaved ? 1 : 0,
+        articlesSaved: articleSaved === true ? 1 : 0,
+        articlesDeferred: articleSaved === DEFERRED ? 1 : 0,
         hubsFound: isHub ? 1 : 0,
-        hubsSaved: hubSaved ? 1 : 0
+        hubsSaved: hubSaved === true ? 1 : 0,
+        hubsDeferred: hubSaved === DEFERRED ? 1 : 0
       },
       signals: {
         url: urlSignals,
@@ -270,7 +338,7 @@ class ArticleProcessor {
     return { title, date, section, url };
   }
 
-  _runReadability(html, url) {
+  _runReadability(html, url, parsedDocument) {
     let htmlSha = null;
     let text = null;
     let wordCount = null;
@@ -282,23 +350,12 @@ class ArticleProcessor {
     } catch (_) { /* ignore hash errors */ }
 
     try {
-      let dom = null;
-      try {
-        ({ dom } = createJsdom(html, { url }));
-        const document = dom.window.document;
-        const reader = new Readability(document);
-        const article = reader.parse();
-
-        if (article && article.textContent) {
-          text = article.textContent.trim();
-          wordCount = countWords(text);
-          language = document.documentElement.getAttribute('lang') || null;
-          articleXPath = this._findArticleXPath(document, article);
-        }
-      } finally {
-        if (dom) {
-          dom.window.close();
-        }
+      const { article, document } = parsedDocument.getReadability();
+      if (article && article.textContent) {
+        text = article.textContent.trim();
+        wordCount = countWords(text);
+        language = document.documentElement.getAttribute('lang') || null;
+        articleXPath = this._findArticleXPath(document, article);
       }
     } catch (err) {
       this._log('warn', 'Readability parsing failed:', err && err.message ? err.message : err);
@@ -308,108 +365,49 @@ class ArticleProcessor {
   }
 
   _findArticleXPath(document, readabilityArticle) {
-    try {
-      const text = readabilityArticle?.textContent || '';
-      if (!text) return null;
-      const targetLen = text.length;
-      const normalize = (s) => (s || '').trim();
-
-      const tmp = document.createElement('div');
-      tmp.innerHTML = readabilityArticle.content || '';
-      const rbParas = Array.from(tmp.querySelectorAll('p'))
-        .map((p) => normalize(p.textContent))
-        .filter(Boolean);
-      const rbTotal = rbParas.length;
-
-      const selectors = [
-        'article', '[role="article"]', '[itemprop="articleBody"]',
-        'main article', 'main [itemprop="articleBody"]',
-        '.article-body', '.content__article-body', '.story-body', '.entry-content', '.post-content', '.rich-text', '.ArticleBody', '.article__body',
-        'main', 'section', 'div[class*="article"]', 'div[id*="article"]'
-      ];
-      const candidates = new Set();
-      for (const sel of selectors) {
-        for (const el of document.querySelectorAll(sel)) {
-          candidates.add(el);
-          if (candidates.size > 200) break;
-        }
-        if (candidates.size > 200) break;
-      }
-      if (candidates.size === 0) {
-        for (const el of document.body.querySelectorAll('p, article, main, section')) {
-          candidates.add(el);
-        }
-      }
-
-      const navClassRe = /(nav|menu|footer|sidebar|comment|promo|related|share|social)/i;
-      const scoreOf = (el) => {
-        const t = normalize(el.textContent);
-        const len = t.length;
-        if (len === 0) return Number.POSITIVE_INFINITY;
-        const paras = el.querySelectorAll('p').length;
-        let linkText = 0;
-        for (const a of el.querySelectorAll('a')) {
-          linkText += normalize(a.textContent).length;
-        }
-        const density = len > 0 ? linkText / len : 0;
-        let score = Math.abs(len - targetLen);
-        score += Math.abs(paras - rbTotal) * 50;
-        if (density > 0.3) score += 10000;
-        const idcl = `${el.id || ''} ${el.className || ''}`;
-        if (navClassRe.test(idcl)) score += 5000;
-        let depth = 0;
-        for (let n = el; n && n.parentNode; n = n.parentNode) depth++;
-        score -= Math.min(depth, 20) * 5;
-        return score;
-      };
+    return findArticleXPath(document, readabilityArticle);
+  }
 
-      let best = null;
-      let bestScore = Number.POSITIVE_INFINITY;
-      for (const el of candidates) {
-        const s = scoreOf(el);
-        const len = normalize(el.textContent).length;
-        if (len < targetLen * 0.5) continue;
-        if (s < bestScore) {
-          best = el;
-          bestScore = s;
-        }
+  /**
+   * Kick off (or adopt) the worker-thread analysis for this page.
+   * Resolves to null on any pool failure so the caller falls back to the
+   * in-process path; a sick pool must never fail a page.
+   * @returns {Promise<Object|null>|null}
+   */
+  _startOffloadedAnalysis(html, url, providedAnalysis) {
+    const source = providedAnalysis || (this.analysisPool ? this.analysisPool.analyze({ html, url }) : null);
+    if (!source) return null;
+    return Promise.resolve(source).then((result) => {
+      if (result && result.readability) {
+        this._offloadStats.offloaded++;
+        return result;
       }
-      const node = best || document.body;
-
-      const getXPath = (el) => {
-        if (!el || el.nodeType !== 1) return '';
-        if (el === document.documentElement) return '/html';
-        const segs = [];
-        for (let n = el; n && n.nodeType === 1; n = n.parentNode) {
-          const name = n.localName;
-          if (!name) break;
-          if (n.parentNode) {
-            const siblings = Array.from(n.parentNode.children).filter((c) => c.localName === name);
-            if (siblings.length > 1) {
-              segs.unshift(`${name}[${siblings.indexOf(n) + 1}]`);
-            } else {
-              segs.unshift(name);
-            }
-          } else {
-            segs.unshift(name);
-          }
-          if (n === document.documentElement) break;
-        }
-        if (segs[0] !== 'html') segs.unshift('html');
-        return '/' + segs.join('/');
-      };
-      return getXPath(node);
-    } catch (_) {
+      this._offloadStats.fallbacks++;
       return null;
-    }
+    }, (err) => {
+      this._offloadStats.fallbacks++;
+      this._log('warn', 'Off-thread analysis failed, running in-process:', err && err.message ? err.message : err);
+      return null;
+    });
+  }
+
+  _recordStage(stage, url, startNs) {
+    if (!this.stageHistograms || startNs === null) return;
+    try {
+      this.stageHistograms.since(stage, hostOf(url), startNs);
+    } catch (_) { /* timing must never fail a page */ }
+  }
+
+  getOffloadStats() {
+    return { ...this._offloadStats };
   }
 
-  async _persistArticle({ url, html, metadata, readability, fetchMeta, referrerUrl, discoveredAt, depth }) {
+  async _persistArticle({ url, html, $, metadata, readability, offloaded = null, fetchMeta, referrerUrl, discoveredAt, depth }) {
     try {
       const adapter = this._getDbAdapter();
       if (!adapter) return false;
-      const canonicalUrl = this._extractCanonicalUrl(html);
-      const articleAnalysis = this._buildArticleAnalysis({ url, html, readability });
+      const canonicalUrl = this._extractCanonicalUrl(html, $);
+      const articleAnalysis = this._buildArticleAnalysis({ url, html, $, readability, schemaSignals: offloaded?.schemaSignals });
       const upsertResult = adapter.upsertArticle({
         url,
         title: metadata.title,
@@ -445,34 +443,43 @@ class ArticleProcessor {
         throw new Error(`adapter.upsertArticle returned null or falsy for ${url}`);
       }
 
-      const normalizedArticleUrl = (() => {
-        try { return this.normalizeUrl(url); } catch (_) { return url; }
-      })();
-      if (normalizedArticleUrl && this.articleHeaderCache) {
-        this.articleHeaderCache.set(normalizedArticleUrl, {
-          etag: fetchMeta?.etag || null,
-          last_modified: fetchMeta?.lastModified || null,
-          fetched_at: fetchMeta?.fetchedAtIso || null
-        });
-      }
-      if (normalizedArticleUrl && this.knownArticlesCache) {
-        this.knownArticlesCache.set(normalizedArticleUrl, true);
-      }
+      const commit = () => {
+        const normalizedArticleUrl = (() => {
+          try { return this.normalizeUrl(url); } catch (_) { return url; }
+        })();
+        if (normalizedArticleUrl && this.articleHeaderCache) {
+          this.articleHeaderCache.set(normalizedArticleUrl, {
+            etag: fetchMeta?.etag || null,
+            last_modified: fetchMeta?.lastModified || null,
+            fetched_at: fetchMeta?.fetchedAtIso || null
+          });
+        }
+        if (normalizedArticleUrl && this.knownArticlesCache) {
+          this.knownArticlesCache.set(normalizedArticleUrl, true);
+        }
 
-      const bytes = Buffer.byteLength(html, 'utf8');
-      let compressedBytes = 0;
-      try {
-        compressedBytes = zlib.gzipSync(html).length;
-      } catch (_) { }
+        const bytes = Buffer.byteLength(html, 'utf8');
+        let compressedBytes = offloaded && Number.isFinite(offloaded.compressedBytes) ? offloaded.compressedBytes : 0;
+        if (!offloaded) {
+          try {
+            compressedBytes = zlib.gzipSync(html).length;
+          } catch (_) { }
+        }
 
-      if (this.events && typeof this.events.incrementBytesSaved === 'function') {
-        this.events.incrementBytesSaved(bytes, compressedBytes);
-      }
+        if (this.events && typeof this.events.incrementBytesSaved === 'function') {
+          this.events.incrementBytesSaved(bytes, compressedBytes);
+        }
 
-      this._log('log', `Saved article: ${metadata.title}`);
-      if (this.events && typeof this.events.emitProgress === 'function') {
-        this.events.emitProgress();
+        this._log('log', `Saved article: ${metadata.title}`);
+        if (this.events && typeof this.events.emitProgress === 'function') {
+          this.events.emitProgress();
+        }
+      };
+
+      if (this._deferUntilCommitted(upsertResult, 'article', url, commit)) {
+        return DEFERRED;
       }
+      commit();
       return true;
     } catch (error) {
       this._log('error', `Failed to save article ${url}: ${error && error.message ? error.message : error}`);
@@ -488,25 +495,27 @@ class ArticleProcessor {
     }
   }
 
-  _extractCanonicalUrl(html) {
+  _extractCanonicalUrl(html, $ = null) {
     try {
-      const $ = cheerio.load(html);
-      const c = $('link[rel="canonical"]').attr('href');
+      const root = $ || cheerio.load(html);
+      const c = root('link[rel="canonical"]').attr('href');
       if (c) return this.normalizeUrl(c);
     } catch (_) { /* ignore */ }
     return null;
   }
 
-  _buildArticleAnalysis({ url, html, readability }) {
+  _buildArticleAnalysis({ url, html, $: providedCheerio = null, readability, schemaSignals: precomputedSchema = null }) {
     try {
-      const $ = cheerio.load(html || '');
+      const $ = providedCheerio || cheerio.load(html || '');
       const urlSig = this.computeUrlSignals(url);
       const contentSig = this.computeContentSignals($, html || '');
-      let schemaSignals = null;
-      try {
-        schemaSignals = extractSchemaSignals({ $, html: html || '' });
-      } catch (_) {
-        schemaSignals = contentSig?.schema || null;
+      let schemaSignals = precomputedSchema;
+      if (!schemaSignals) {
+        try {
+          schemaSignals = extractSchemaSignals({ $, html: html || '' });
+        } catch (_) {
+          schemaSignals = contentSig?.schema || null;
+        }
       }
       const combined = this.combineSignals(urlSig, { ...contentSig, schema: schemaSignals }, { wordCount: readability.wordCount ?? undefined });
       return {
@@ -659,12 +668,12 @@ class ArticleProcessor {
    * @param {object} params
    * @returns {boolean}
    */
-  async _persistHubPage({ url, html, metadata, readability, fetchMeta, referrerUrl, discoveredAt, depth, navigationLinks, articleLinks }) {
+  async _persistHubPage({ url, html, $, metadata, readability, fetchMeta, referrerUrl, discoveredAt, depth, navigationLinks, articleLinks }) {
     try {
       const adapter = this._getDbAdapter();
       if (!adapter) return false;
 
-      const canonicalUrl = this._extractCanonicalUrl(html);
+      const canonicalUrl = this._extractCanonicalUrl(html, $);
 
       // Build a minimal analysis record for the hub
       const hubAnalysis = {
@@ -675,7 +684,7 @@ class ArticleProcessor {
         wordCount: readability?.wordCount ?? null
       };
 
-      adapter.upsertArticle({
+      const upsertResult = adapter.upsertArticle({
         url,
         title: metadata?.title || 'Hub Page',
         date: null,
@@ -706,26 +715,33 @@ class ArticleProcessor {
         analysis: JSON.stringify(hubAnalysis)
       });
 
-      // Keep the conditional-GET header cache warm for hub pages too, so a
-      // within-run re-fetch of a hub (e.g. the seed) can send If-None-Match /
-      // If-Modified-Since instead of paying for a full 200 re-download.
-      const normalizedHubUrl = (() => {
-        try { return this.normalizeUrl(url); } catch (_) { return url; }
-      })();
-      if (normalizedHubUrl && this.articleHeaderCache && (fetchMeta?.etag || fetchMeta?.lastModified)) {
-        this.articleHeaderCache.set(normalizedHubUrl, {
-          etag: fetchMeta?.etag || null,
-          last_modified: fetchMeta?.lastModified || null,
-          fetched_at: fetchMeta?.fetchedAtIso || null
-        });
-      }
+      const commit = () => {
+        // Keep the conditional-GET header cache warm for hub pages too, so a
+        // within-run re-fetch of a hub (e.g. the seed) can send If-None-Match /
+        // If-Modified-Since instead of paying for a full 200 re-download.
+        const normalizedHubUrl = (() => {
+          try { return this.normalizeUrl(url); } catch (_) { return url; }
+        })();
+        if (normalizedHubUrl && this.articleHeaderCache && (fetchMeta?.etag || fetchMeta?.lastModified)) {
+          this.articleHeaderCache.set(normalizedHubUrl, {
+            etag: fetchMeta?.etag || null,
+            last_modified: fetchMeta?.lastModified || null,
+            fetched_at: fetchMeta?.fetchedAtIso || null
+          });
+        }
+
+        const bytes = Buffer.byteLength(html, 'utf8');
+        this._log('log', `Saved hub page: ${metadata?.title || url} (${bytes} bytes, ${navigationLinks?.length || 0} nav links, ${articleLinks?.length || 0} article links)`);
 
-      const bytes = Buffer.byteLength(html, 'utf8');
-      this._log('log', `Saved hub page: ${metadata?.title || url} (${bytes} bytes, ${navigationLinks?.length || 0} nav links, ${articleLinks?.length || 0} article links)`);
+        if (this.events && typeof this.events.emitProgress === 'function') {
+          this.events.emitProgress();
+        }
+      };
 
-      if (this.events && typeof this.events.emitProgress === 'function') {
-        this.events.emitProgress();
+      if (this._deferUntilCommitted(upsertResult, 'hub', url, commit)) {
+        return DEFERRED;
       }
+      commit();
       return true;
     } catch (error) {
       this._log('error', `Failed to save hub page ${url}: ${error?.message || error}`);
@@ -733,6 +749,45 @@ class ArticleProcessor {
     }
   }
 
+  /**
+   * A write-behind adapter returns `{deferred, onSettled}` before the row is
+   * committed. Run the save's bookkeeping (caches, byte totals, the saved
+   * counter via onSaveCommitted) only once the flush succeeds; a failed flush
+   * is already recorded as an error row by the buffer.
+   * @returns {boolean} true when the save was deferred
+   */
+  _deferUntilCommitted(upsertResult, kind, url, commit) {
+    if (!upsertResult || upsertResult.deferred !== true || typeof upsertResult.onSettled !== 'function') {
+      return false;
+    }
+    // Counted before registering: onSettled runs inline if a size flush already committed it
+    this._contentSaveStats.deferred++;
+    upsertResult.onSettled((ok) => {
+      this._contentSaveStats.deferred = Math.max(0, this._contentSaveStats.deferred - 1);
+      if (!ok) {
+        this._contentSaveStats.errors++;
+        return;
+      }
+      this._contentSaveStats.saved++;
+      try { commit(); } catch (_) { /* bookkeeping only */ }
+      if (this.onSaveCommitted) {
+        try { this.onSaveCommitted({ kind, url }); } catch (_) { /* ignore */ }
+      }
+    });
+    return true;
+  }
+
+  _noteSaveOutcome(saved) {
+    if (saved === DEFERRED) {
+      return; // settled by _deferUntilCommitted
+    }
+    if (saved) {
+      this._contentSaveStats.saved++;
+    } else {
+      this._contentSaveStats.errors++;
+    }
+  }
+
   _dbEnabled() {
     const adapter = this._getDbAdapter();
     if (!adapter) return false;
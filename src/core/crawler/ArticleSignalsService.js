@@ -1,16 +1,33 @@
 const { extractSchemaSignals } = require('./schemaSignals');
 
+function escapeRegex(value) {
+  return value.replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+}
+
+function compileSubstringRegex(patterns) {
+  if (!patterns.length) return null;
+  return new RegExp(patterns.map((pattern) => escapeRegex(pattern.toLowerCase())).join('|'));
+}
+
 class ArticleSignalsService {
   constructor({ baseUrl = null, logger = console, decisionConfigSet = null, articleSignalsConfig = null } = {}) {
     this.baseUrl = baseUrl;
     this.logger = logger || console;
     this.articleSignalsConfig = articleSignalsConfig || decisionConfigSet?.articleSignals || null;
-    this._compiledDatePathRegex = this._compileDatePathRegex(this.articleSignalsConfig);
+    this._compilePatterns();
   }
 
   setArticleSignalsConfig(articleSignalsConfig) {
     this.articleSignalsConfig = articleSignalsConfig || null;
+    this._compilePatterns();
+  }
+
+  // looksLikeArticle runs for every anchor on every page, so the substring
+  // lists are folded into one case-insensitive alternation per list up front
+  _compilePatterns() {
     this._compiledDatePathRegex = this._compileDatePathRegex(this.articleSignalsConfig);
+    this._compiledSkipRegex = compileSubstringRegex(this._getSkipPatterns());
+    this._compiledArticleRegex = compileSubstringRegex(this._getArticlePatterns());
   }
 
   _getDefaultSkipPatterns() {
@@ -62,13 +79,11 @@ class ArticleSignalsService {
     if (!url || typeof url !== 'string') return false;
     const urlStr = url.toLowerCase();
 
-    const skipPatterns = this._getSkipPatterns();
-    if (skipPatterns.some(pattern => urlStr.includes(String(pattern).toLowerCase()))) {
+    if (this._compiledSkipRegex && this._compiledSkipRegex.test(urlStr)) {
       return false;
     }
 
-    const articlePatterns = this._getArticlePatterns();
-    if (articlePatterns.some(pattern => urlStr.includes(String(pattern).toLowerCase()))) {
+    if (this._compiledArticleRegex && this._compiledArticleRegex.test(urlStr)) {
       return true;
     }
 
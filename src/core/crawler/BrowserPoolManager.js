@@ -9,6 +9,11 @@
  * Features:
  * - Pool of N browsers (configurable)
  * - acquire() returns least-used browser with release callback
+ * - acquirePage() hands out warm pages from a per-domain browser context,
+ *   with images/media/fonts and ad/tracker hosts blocked by request
+ *   interception; released pages are reset to about:blank and kept warm
+ * - Browsers are recycled after maxPagesPerBrowser pages or once their
+ *   process tree exceeds maxBrowserRssMb
  * - Health checks remove crashed browsers
  * - Automatic restart on errors
  * - Telemetry tracking for pool utilization
@@ -16,8 +21,10 @@
  * @module BrowserPoolManager
  */
 
+const fs = require('fs');
 const puppeteer = require('puppeteer');
 const EventEmitter = require('events');
+const { hostOf } = require('./telemetry/TelemetryRingBuffer');
 
 /**
  * Default Puppeteer launch options for stealth browsing
@@ -47,6 +54,170 @@ const DEFAULT_POOL_OPTIONS = {
   acquireTimeout: 10000       // Max time to wait for available browser
 };
 
+/**
+ * Default page pool configuration (acquirePage)
+ */
+const DEFAULT_PAGE_POOL_OPTIONS = {
+  pagesPerDomain: 2,               // Warm pages kept per domain context
+  maxWarmPages: 12,                // Warm pages kept across all domains
+  maxUsesPerPage: 25,              // Close a page after N navigations
+  maxConcurrentPagesPerBrowser: 4, // Pages open at once in one browser
+  maxBrowserRssMb: 1024,           // Recycle a browser above this RSS (0 disables)
+  rssCheckEveryReleases: 20,       // Sample RSS on every Nth release (and on health checks)
+  blockResources: true,
+  blockedResourceTypes: ['image', 'media', 'font'],
+  viewport: { width: 1920, height: 1080 }
+};
+
+/**
+ * Ad and tracker hosts blocked by default (suffix match)
+ */
+const DEFAULT_BLOCKED_HOSTS = [
+  'doubleclick.net',
+  'googlesyndication.com',
+  'googletagservices.com',
+  'googletagmanager.com',
+  'google-analytics.com',
+  'adservice.google.com',
+  'amazon-adsystem.com',
+  'adnxs.com',
+  'criteo.com',
+  'criteo.net',
+  'taboola.com',
+  'outbrain.com',
+  'scorecardresearch.com',
+  'chartbeat.com',
+  'chartbeat.net',
+  'hotjar.com',
+  'moatads.com',
+  'pubmatic.com',
+  'rubiconproject.com',
+  'casalemedia.com',
+  'quantserve.com',
+  'connect.facebook.net'
+];
+
+function createBlockingStats() {
+  return { blockedRequests: 0, allowedRequests: 0, blockedByType: {}, loadedBytes: 0 };
+}
+
+function isBlockedHost(url, hostPatterns) {
+  const host = hostOf(url);
+  if (!host) return false;
+  for (const pattern of hostPatterns) {
+    if (host === pattern || (host.length > pattern.length && host.endsWith(pattern) && host.charCodeAt(host.length - pattern.length - 1) === 46)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+function settle(action) {
+  try {
+    const result = action();
+    if (result && typeof result.catch === 'function') result.catch(() => {});
+  } catch (_) {
+    // Request already handled (e.g. page closed mid-navigation)
+  }
+}
+
+/**
+ * Block heavy resource types and ad/tracker hosts on a page via request
+ * interception. Blocked requests never leave the browser, so their size is
+ * unknown; `loadedBytes` sums Content-Length of what was allowed through.
+ *
+ * @param {Object} page - Puppeteer page
+ * @param {Object} [options]
+ * @param {string[]} [options.resourceTypes] - Puppeteer resource types to block
+ * @param {string[]} [options.hostPatterns] - Host suffixes to block
+ * @param {Object} [options.stats] - Counters to update (createBlockingStats shape)
+ * @returns {Promise<Object>} The stats object
+ */
+async function installResourceBlocking(page, options = {}) {
+  const types = new Set(options.resourceTypes || DEFAULT_PAGE_POOL_OPTIONS.blockedResourceTypes);
+  const hostPatterns = options.hostPatterns || DEFAULT_BLOCKED_HOSTS;
+  const stats = options.stats || createBlockingStats();
+
+  await page.setRequestInterception(true);
+  page.on('request', (request) => {
+    if (typeof request.isInterceptResolutionHandled === 'function' && request.isInterceptResolutionHandled()) return;
+    const type = request.resourceType();
+    let reason = types.has(type) ? type : null;
+    if (!reason && hostPatterns.length > 0 && isBlockedHost(request.url(), hostPatterns)) reason = 'ads';
+    if (reason) {
+      stats.blockedRequests++;
+      stats.blockedByType[reason] = (stats.blockedByType[reason] || 0) + 1;
+      settle(() => request.abort('blockedbyclient'));
+      return;
+    }
+    stats.allowedRequests++;
+    settle(() => request.continue());
+  });
+  page.on('response', (response) => {
+    try {
+      const length = Number(response.headers()['content-length']);
+      if (length > 0) stats.loadedBytes += length;
+    } catch (_) { /* headers unavailable */ }
+  });
+  return stats;
+}
+
+/**
+ * Resident memory of a browser's process tree in MB (Linux /proc; null
+ * elsewhere or when the process is not visible). The whole tree is walked:
+ * Chrome renderers are grandchildren, forked from the zygote, and a thread's
+ * children list only holds the processes that thread started.
+ * @param {Object} browser - Puppeteer browser
+ * @param {string} [procRoot='/proc']
+ * @returns {number|null}
+ */
+function readBrowserRssMb(browser, procRoot = '/proc') {
+  const pid = typeof browser?.process === 'function' ? browser.process()?.pid : null;
+  if (!pid) return null;
+  const rssKb = (id) => {
+    try {
+      const match = /VmRSS:\s+(\d+)/.exec(fs.readFileSync(`${procRoot}/${id}/status`, 'utf8'));
+      return match ? Number(match[1]) : 0;
+    } catch (_) {
+      return 0;
+    }
+  };
+  const childrenOf = (id) => {
+    const children = [];
+    let tasks;
+    try {
+      tasks = fs.readdirSync(`${procRoot}/${id}/task`);
+    } catch (_) {
+      return children; // exited, or no /proc: count the process alone
+    }
+    for (const task of tasks) {
+      try {
+        for (const child of fs.readFileSync(`${procRoot}/${id}/task/${task}/children`, 'utf8').trim().split(/\s+/)) {
+          if (child) children.push(child);
+        }
+      } catch (_) { /* thread exited or children list unavailable */ }
+    }
+    return children;
+  };
+  let totalKb = rssKb(pid);
+  if (totalKb === 0) return null;
+  const seen = new Set([String(pid)]);
+  const pending = childrenOf(pid);
+  while (pending.length > 0) {
+    const id = pending.pop();
+    if (seen.has(id)) continue;
+    seen.add(id);
+    totalKb += rssKb(id);
+    pending.push(...childrenOf(id));
+  }
+  return Math.round(totalKb / 1024);
+}
+
+function domainOf(target) {
+  const value = String(target || '');
+  return hostOf(value) || value.toLowerCase() || 'default';
+}
+
 /**
  * @typedef {Object} PooledBrowser
  * @property {string} id - Unique browser ID
@@ -68,6 +239,18 @@ class BrowserPoolManager extends EventEmitter {
    * @param {number} [opts.healthCheckIntervalMs=30000] - Health check interval
    * @param {number} [opts.minBrowsers=1] - Minimum warm browsers
    * @param {Object} [opts.launchOptions] - Puppeteer launch options
+   * @param {number} [opts.pagesPerDomain=2] - Warm pages kept per domain context
+   * @param {number} [opts.maxWarmPages=12] - Warm pages kept in total
+   * @param {number} [opts.maxUsesPerPage=25] - Navigations before a page is closed
+   * @param {number} [opts.maxConcurrentPagesPerBrowser=4] - Pages open at once per browser
+   * @param {number} [opts.maxBrowserRssMb=1024] - Recycle a browser above this RSS (0 disables)
+   * @param {number} [opts.rssCheckEveryReleases=20] - Releases between RSS samples of a browser;
+   *   the first release and every health check sample as well
+   * @param {boolean} [opts.blockResources=true] - Block heavy resources on pooled pages
+   * @param {string[]} [opts.blockedResourceTypes] - Resource types to block
+   * @param {string[]} [opts.blockedHosts] - Host suffixes to block (ads/trackers)
+   * @param {Function} [opts.launch] - Browser launcher (default puppeteer.launch)
+   * @param {Function} [opts.rssProvider] - (browser) => MB, overrides /proc sampling
    * @param {Object} [opts.logger] - Logger instance
    */
   constructor(opts = {}) {
@@ -81,9 +264,30 @@ class BrowserPoolManager extends EventEmitter {
     this.acquireTimeout = opts.acquireTimeout || DEFAULT_POOL_OPTIONS.acquireTimeout;
     this.launchOptions = { ...DEFAULT_LAUNCH_OPTIONS, ...opts.launchOptions };
     this.logger = opts.logger || console;
+    this._launch = typeof opts.launch === 'function' ? opts.launch : (options) => puppeteer.launch(options);
+    this.rssProvider = typeof opts.rssProvider === 'function' ? opts.rssProvider : readBrowserRssMb;
+
+    // Page pool
+    this.pagesPerDomain = opts.pagesPerDomain ?? DEFAULT_PAGE_POOL_OPTIONS.pagesPerDomain;
+    this.maxWarmPages = opts.maxWarmPages ?? DEFAULT_PAGE_POOL_OPTIONS.maxWarmPages;
+    this.maxUsesPerPage = opts.maxUsesPerPage || DEFAULT_PAGE_POOL_OPTIONS.maxUsesPerPage;
+    this.maxConcurrentPagesPerBrowser = opts.maxConcurrentPagesPerBrowser || DEFAULT_PAGE_POOL_OPTIONS.maxConcurrentPagesPerBrowser;
+    this.maxBrowserRssMb = opts.maxBrowserRssMb ?? DEFAULT_PAGE_POOL_OPTIONS.maxBrowserRssMb;
+    this.rssCheckEveryReleases = Math.max(1, opts.rssCheckEveryReleases || DEFAULT_PAGE_POOL_OPTIONS.rssCheckEveryReleases);
+    this.blockResources = opts.blockResources !== undefined ? !!opts.blockResources : DEFAULT_PAGE_POOL_OPTIONS.blockResources;
+    this.blockedResourceTypes = opts.blockedResourceTypes || DEFAULT_PAGE_POOL_OPTIONS.blockedResourceTypes;
+    this.blockedHosts = opts.blockedHosts || DEFAULT_BLOCKED_HOSTS;
+    this.viewport = opts.viewport !== undefined ? opts.viewport : DEFAULT_PAGE_POOL_OPTIONS.viewport;
     
     /** @type {Map<string, PooledBrowser>} */
     this._pool = new Map();
+
+    /**
+     * Browser contexts per domain: domain -> browserId -> {context, idle}
+     * @type {Map<string, Map<string, {browserId: string, domain: string, context: Object|null, idle: Array<{page: Object, uses: number}>}>>}
+     */
+    this._domainContexts = new Map();
+    this._warmPageCount = 0;
     
     /** @type {Set<string>} - IDs of browsers currently in use */
     this._inUse = new Set();
@@ -103,8 +307,17 @@ class BrowserPoolManager extends EventEmitter {
       healthChecksPassed: 0,
       healthChecksFailed: 0,
       waitTimeouts: 0,
-      peakPoolSize: 0
+      peakPoolSize: 0,
+      rssRecycles: 0,
+      pageAcquires: 0,
+      pagesCreated: 0,
+      pagesReused: 0,
+      pagesClosed: 0,
+      retiredBrowserPages: 0,
+      retiredBrowsers: 0
     };
+    this._blocking = createBlockingStats();
+    this._render = { count: 0, totalMs: 0, maxMs: 0 };
   }
 
   /**
@@ -139,7 +352,7 @@ class BrowserPoolManager extends EventEmitter {
     try {
       // Launch with timeout
       const browser = await Promise.race([
-        puppeteer.launch(this.launchOptions),
+        this._launch(this.launchOptions),
         new Promise((_, reject) => 
           setTimeout(() => reject(new Error('Browser launch timeout')), this.launchTimeout)
         )
@@ -157,7 +370,10 @@ class BrowserPoolManager extends EventEmitter {
         lastUsedAt: Date.now(),
         activePages: 0,
         healthy: true,
-        consecutiveErrors: 0
+        consecutiveErrors: 0,
+        retiring: false,
+        rssMb: null,
+        releasesSinceRss: null
       };
       
       this._pool.set(id, pooled);
@@ -190,6 +406,15 @@ class BrowserPoolManager extends EventEmitter {
     
     this._pool.delete(id);
     this._inUse.delete(id);
+    this._telemetry.retiredBrowsers++;
+    this._telemetry.retiredBrowserPages += pooled.pageCount;
+    for (const contexts of this._domainContexts.values()) {
+      const entry = contexts.get(id);
+      if (!entry) continue;
+      this._warmPageCount -= entry.idle.length;
+      this._telemetry.pagesClosed += entry.idle.length;
+      contexts.delete(id);
+    }
     
     try {
       await pooled.browser.close();
@@ -215,7 +440,7 @@ class BrowserPoolManager extends EventEmitter {
       if (this._inUse.has(id) || !pooled.healthy) continue;
       
       // Skip browsers that should be retired
-      if (pooled.pageCount >= this.maxPagesPerBrowser) continue;
+      if (pooled.retiring || pooled.pageCount >= this.maxPagesPerBrowser) continue;
       
       // Score by page count (prefer less used)
       const score = pooled.pageCount + (pooled.activePages * 10);
@@ -318,9 +543,18 @@ class BrowserPoolManager extends EventEmitter {
       pooled.consecutiveErrors = 0;
     }
     
+    // Sampling walks /proc synchronously, so it runs on the first release
+    // and then every rssCheckEveryReleases; health checks sample in between
+    if (!pooled.retiring && this.maxBrowserRssMb > 0) {
+      if (pooled.releasesSinceRss === null || ++pooled.releasesSinceRss >= this.rssCheckEveryReleases) {
+        this._checkRss(pooled);
+      }
+    }
+
     // Check if browser should be retired
-    if (pooled.pageCount >= this.maxPagesPerBrowser) {
-      this._telemetry.browserRetirements++;
+    if (pooled.retiring || pooled.pageCount >= this.maxPagesPerBrowser) {
+      if (!pooled.retiring) this._telemetry.browserRetirements++;
+      pooled.retiring = true;
       // Only remove if no active pages
       if (pooled.activePages === 0) {
         this._inUse.delete(id);
@@ -344,6 +578,266 @@ class BrowserPoolManager extends EventEmitter {
     this.emit('browser:released', { id, pageCount: pooled.pageCount });
   }
 
+  /**
+   * Acquire a page for a URL from the page pool
+   *
+   * Warm pages live in a browser context per domain (cookies and cache are
+   * shared by same-domain fetches, isolated from other domains). A cold
+   * acquire creates the page in the least-loaded browser; released pages are
+   * reset to about:blank and kept for the next fetch on that domain.
+   *
+   * @param {string} target - URL (or domain) the page will load
+   * @returns {Promise<{page: Object, browserId: string, domain: string, reused: boolean, release: (error?: Error|null) => Promise<void>}>}
+   * @throws {Error} If no browser has capacity within acquireTimeout
+   */
+  async acquirePage(target) {
+    if (this._shuttingDown) {
+      throw new Error('Pool is shutting down');
+    }
+    const startedAt = Date.now();
+    const domain = domainOf(target);
+    this._telemetry.pageAcquires++;
+
+    let slot = this._takeWarmPage(domain);
+    const reused = !!slot;
+    if (slot) {
+      this._telemetry.pagesReused++;
+    } else {
+      const pooled = await this._browserForPage();
+      pooled.activePages++;
+      try {
+        const entry = await this._contextFor(pooled, domain);
+        slot = { pooled, entry, meta: await this._createPage(pooled, entry) };
+      } catch (err) {
+        pooled.activePages = Math.max(0, pooled.activePages - 1);
+        throw err;
+      }
+      pooled.activePages--;
+    }
+
+    const { pooled, entry, meta } = slot;
+    pooled.activePages++;
+    pooled.lastUsedAt = Date.now();
+    this.emit('page:acquired', { browserId: pooled.id, domain, reused, acquireMs: Date.now() - startedAt });
+
+    let released = false;
+    return {
+      page: meta.page,
+      browserId: pooled.id,
+      domain,
+      reused,
+      release: async (error = null) => {
+        if (released) return;
+        released = true;
+        await this._releasePage(pooled.id, entry, meta, startedAt, error);
+      }
+    };
+  }
+
+  /**
+   * Pre-open pages for a domain so its first fetches skip page and
+   * context creation
+   * @param {string} target - URL or domain
+   * @param {number} [count=pagesPerDomain]
+   * @returns {Promise<number>} Pages warmed
+   */
+  async warmPages(target, count = this.pagesPerDomain) {
+    const domain = domainOf(target);
+    let warmed = 0;
+    while (warmed < count && this._warmPageCount < this.maxWarmPages && !this._shuttingDown) {
+      const pooled = this._findBrowserForPage() || (this._pool.size < this.maxBrowsers ? await this._launchBrowser() : null);
+      if (!pooled) break;
+      const entry = await this._contextFor(pooled, domain);
+      if (entry.idle.length >= this.pagesPerDomain) break;
+      entry.idle.push(await this._createPage(pooled, entry));
+      this._warmPageCount++;
+      warmed++;
+    }
+    return warmed;
+  }
+
+  /**
+   * @private
+   */
+  _takeWarmPage(domain) {
+    const contexts = this._domainContexts.get(domain);
+    if (!contexts) return null;
+    for (const entry of contexts.values()) {
+      if (entry.idle.length === 0) continue;
+      const pooled = this._pool.get(entry.browserId);
+      if (!pooled || !pooled.healthy || pooled.retiring || pooled.activePages >= this.maxConcurrentPagesPerBrowser) continue;
+      this._warmPageCount--;
+      return { pooled, entry, meta: entry.idle.pop() };
+    }
+    return null;
+  }
+
+  /**
+   * Least-loaded browser with room for another page
+   * @private
+   * @returns {PooledBrowser|null}
+   */
+  _findBrowserForPage() {
+    let best = null;
+    let bestScore = Infinity;
+    for (const [id, pooled] of this._pool) {
+      if (this._inUse.has(id) || !pooled.healthy || pooled.retiring) continue;
+      if (pooled.pageCount >= this.maxPagesPerBrowser) continue;
+      if (pooled.activePages >= this.maxConcurrentPagesPerBrowser) continue;
+      const score = pooled.pageCount + (pooled.activePages * 10);
+      if (score < bestScore) {
+        best = pooled;
+        bestScore = score;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @private
+   * @returns {Promise<PooledBrowser>}
+   */
+  async _browserForPage() {
+    let pooled = this._findBrowserForPage();
+    if (!pooled && this._pool.size < this.maxBrowsers) {
+      try {
+        pooled = await this._launchBrowser();
+      } catch (err) {
+        this.logger.warn(`[BrowserPoolManager] Launch failed, waiting for page capacity`);
+      }
+    }
+    if (!pooled) {
+      const waitEnd = Date.now() + this.acquireTimeout;
+      while (!pooled && Date.now() < waitEnd) {
+        await new Promise(r => setTimeout(r, 100));
+        pooled = this._findBrowserForPage();
+      }
+      if (!pooled) {
+        this._telemetry.waitTimeouts++;
+        throw new Error(`Acquire timeout: no browser available after ${this.acquireTimeout}ms`);
+      }
+    }
+    return pooled;
+  }
+
+  /**
+   * @private
+   */
+  async _contextFor(pooled, domain) {
+    let contexts = this._domainContexts.get(domain);
+    if (!contexts) {
+      contexts = new Map();
+      this._domainContexts.set(domain, contexts);
+    }
+    let entry = contexts.get(pooled.id);
+    if (!entry) {
+      const browser = pooled.browser;
+      let context = null;
+      if (typeof browser.createBrowserContext === 'function') {
+        context = await browser.createBrowserContext();
+      } else if (typeof browser.createIncognitoBrowserContext === 'function') {
+        context = await browser.createIncognitoBrowserContext();
+      }
+      entry = { browserId: pooled.id, domain, context, idle: [] };
+      contexts.set(pooled.id, entry);
+    }
+    return entry;
+  }
+
+  /**
+   * @private
+   */
+  async _createPage(pooled, entry) {
+    const page = await (entry.context || pooled.browser).newPage();
+    try {
+      if (this.viewport) {
+        await page.setViewport(this.viewport);
+      }
+      if (this.blockResources) {
+        await installResourceBlocking(page, {
+          resourceTypes: this.blockedResourceTypes,
+          hostPatterns: this.blockedHosts,
+          stats: this._blocking
+        });
+      }
+    } catch (err) {
+      try { await page.close(); } catch (_) {}
+      throw err;
+    }
+    this._telemetry.pagesCreated++;
+    return { page, uses: 0 };
+  }
+
+  /**
+   * @private
+   */
+  async _closePage(meta) {
+    this._telemetry.pagesClosed++;
+    try {
+      await meta.page.close();
+    } catch (_) { /* already closed with its browser */ }
+  }
+
+  /**
+   * @private
+   */
+  async _releasePage(id, entry, meta, startedAt, error) {
+    const renderMs = Date.now() - startedAt;
+    this._render.count++;
+    this._render.totalMs += renderMs;
+    if (renderMs > this._render.maxMs) this._render.maxMs = renderMs;
+    meta.uses++;
+
+    const pooled = this._pool.get(id);
+    const contexts = this._domainContexts.get(entry.domain);
+    let keep = !error && !!pooled && pooled.healthy && !pooled.retiring && !this._shuttingDown &&
+      pooled.pageCount + 1 < this.maxPagesPerBrowser &&
+      meta.uses < this.maxUsesPerPage &&
+      contexts?.get(id) === entry &&
+      entry.idle.length < this.pagesPerDomain &&
+      this._warmPageCount < this.maxWarmPages &&
+      !(typeof meta.page.isClosed === 'function' && meta.page.isClosed());
+    if (keep) {
+      try {
+        await meta.page.goto('about:blank', { waitUntil: 'domcontentloaded', timeout: 5000 });
+      } catch (_) {
+        keep = false;
+      }
+    }
+    if (keep) {
+      entry.idle.push(meta);
+      this._warmPageCount++;
+    } else {
+      await this._closePage(meta);
+    }
+
+    this.emit('page:released', { browserId: id, domain: entry.domain, renderMs, kept: keep });
+    if (pooled) {
+      await this._release(id, error);
+    }
+  }
+
+  /**
+   * Mark a browser for recycling when its process tree is over the RSS cap
+   * @private
+   */
+  _checkRss(pooled) {
+    pooled.releasesSinceRss = 0;
+    let rssMb = null;
+    try {
+      rssMb = this.rssProvider(pooled.browser);
+    } catch (_) {
+      rssMb = null;
+    }
+    if (!Number.isFinite(rssMb)) return;
+    pooled.rssMb = rssMb;
+    if (rssMb > this.maxBrowserRssMb) {
+      pooled.retiring = true;
+      this._telemetry.rssRecycles++;
+      this.logger.info(`[BrowserPoolManager] Browser ${pooled.id} at ${rssMb}MB RSS (cap ${this.maxBrowserRssMb}MB), recycling`);
+    }
+  }
+
   /**
    * Start periodic health check
    * @private
@@ -394,6 +888,15 @@ class BrowserPoolManager extends EventEmitter {
         
         pooled.healthy = true;
         this._telemetry.healthChecksPassed++;
+
+        if (!pooled.retiring && this.maxBrowserRssMb > 0) {
+          this._checkRss(pooled);
+        }
+        // Over the cap and idle: no release is coming to retire it
+        if (pooled.retiring && !this._inUse.has(id) && pooled.activePages === 0) {
+          toRemove.push({ id, reason: `retired (${pooled.rssMb}MB RSS)` });
+          continue;
+        }
         
         // Check for idle browsers above minimum
         if (this._pool.size > this.minBrowsers && 
@@ -453,11 +956,17 @@ class BrowserPoolManager extends EventEmitter {
         healthy: pooled.healthy,
         ageMs: Date.now() - pooled.createdAt,
         idleMs: Date.now() - pooled.lastUsedAt,
-        inUse: this._inUse.has(id)
+        inUse: this._inUse.has(id),
+        retiring: pooled.retiring,
+        rssMb: pooled.rssMb
       });
       totalActivePages += pooled.activePages;
     }
     
+    const t = this._telemetry;
+    const servedBrowsers = t.retiredBrowsers + this._pool.size;
+    const servedPages = t.retiredBrowserPages + browsers.reduce((sum, b) => sum + b.pageCount, 0);
+    
     return {
       pool: {
         size: this._pool.size,
@@ -465,11 +974,35 @@ class BrowserPoolManager extends EventEmitter {
         available: this._pool.size - this._inUse.size,
         totalActivePages
       },
+      pages: {
+        warm: this._warmPageCount,
+        domains: this._domainContexts.size,
+        acquires: t.pageAcquires,
+        created: t.pagesCreated,
+        reused: t.pagesReused,
+        closed: t.pagesClosed,
+        reuseRate: t.pageAcquires > 0 ? t.pagesReused / t.pageAcquires : 0,
+        pagesPerBrowser: servedBrowsers > 0 ? Math.round((servedPages / servedBrowsers) * 10) / 10 : 0
+      },
+      blocking: {
+        enabled: this.blockResources,
+        ...this._blocking,
+        blockedByType: { ...this._blocking.blockedByType }
+      },
+      render: {
+        count: this._render.count,
+        avgMs: this._render.count > 0 ? Math.round(this._render.totalMs / this._render.count) : null,
+        maxMs: this._render.maxMs
+      },
       config: {
         maxBrowsers: this.maxBrowsers,
         minBrowsers: this.minBrowsers,
         maxPagesPerBrowser: this.maxPagesPerBrowser,
-        maxIdleTimeMs: this.maxIdleTimeMs
+        maxIdleTimeMs: this.maxIdleTimeMs,
+        pagesPerDomain: this.pagesPerDomain,
+        maxWarmPages: this.maxWarmPages,
+        maxConcurrentPagesPerBrowser: this.maxConcurrentPagesPerBrowser,
+        maxBrowserRssMb: this.maxBrowserRssMb
       },
       telemetry: { ...this._telemetry },
       browsers
@@ -501,13 +1034,24 @@ class BrowserPoolManager extends EventEmitter {
     }
     
     await Promise.all(closePromises);
+    this._domainContexts.clear();
+    this._warmPageCount = 0;
     
     // Log final telemetry
     const t = this._telemetry;
-    this.logger.info(`[BrowserPoolManager] Final stats: launches=${t.browserLaunches} reuses=${t.browserReuses} retirements=${t.browserRetirements} crashes=${t.browserCrashes}`);
+    this.logger.info(`[BrowserPoolManager] Final stats: launches=${t.browserLaunches} reuses=${t.browserReuses} retirements=${t.browserRetirements} rssRecycles=${t.rssRecycles} crashes=${t.browserCrashes} pages=${t.pageAcquires} pageReuses=${t.pagesReused} blocked=${this._blocking.blockedRequests}`);
     
     this.emit('pool:destroyed', { telemetry: this._telemetry });
   }
 }
 
-module.exports = { BrowserPoolManager, DEFAULT_POOL_OPTIONS, DEFAULT_LAUNCH_OPTIONS };
+module.exports = {
+  BrowserPoolManager,
+  DEFAULT_POOL_OPTIONS,
+  DEFAULT_LAUNCH_OPTIONS,
+  DEFAULT_PAGE_POOL_OPTIONS,
+  DEFAULT_BLOCKED_HOSTS,
+  installResourceBlocking,
+  createBlockingStats,
+  readBrowserRssMb
+};
@@ -25,7 +25,8 @@ class ContentAcquisitionService {
     insertFetchRecord = true,
     insertLinkRecords = true,
     linkSummary = null,
-    cheerioRoot = null
+    cheerioRoot = null,
+    parsedDocument = null
   } = {}) {
     if (!url) {
       throw new Error('ContentAcquisitionService.acquire requires a url');
@@ -47,7 +48,8 @@ class ContentAcquisitionService {
         insertFetchRecord,
         insertLinkRecords,
         linkSummary,
-        $: cheerioRoot
+        $: cheerioRoot,
+        parsedDocument
       });
     } catch (error) {
       try {
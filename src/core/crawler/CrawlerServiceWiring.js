@@ -16,22 +16,26 @@ const { MilestoneTracker } = require('./MilestoneTracker');
 const { ErrorTracker } = require('./ErrorTracker');
 const { DomainThrottleManager } = require('./DomainThrottleManager');
 const { ArticleProcessor } = require('./ArticleProcessor');
+const { AnalysisWorkerPool } = require('./pipeline/AnalysisWorkerPool');
 const { NavigationDiscoveryService } = require('./NavigationDiscoveryService');
 const { ContentAcquisitionService } = require('./ContentAcquisitionService');
 const { FetchPipeline } = require('./FetchPipeline');
+const { HostConnectionManager } = require('./HostConnectionManager');
+const { StageHistograms } = require('./profiler/StageHistograms');
 const { PageExecutionService } = require('./PageExecutionService');
 const { UrlEligibilityService } = require('./UrlEligibilityService');
 const QueueManager = require('./QueueManager');
+const { FrontierSpillStore } = require('./frontier');
 const { RobotsAndSitemapCoordinator } = require('./RobotsAndSitemapCoordinator');
 const { AdaptiveSeedPlanner } = require('./planner/AdaptiveSeedPlanner');
-const robotsParser = require('robots-parser');
+const { robotsRulesParser } = require('./RobotsRules');
 const { loadSitemaps } = require('./sitemap');
 const PriorityCalculator = require('./PriorityCalculator');
 const { GazetteerManager } = require('./components/GazetteerManager');
 const { ConfigManager } = require('../../shared/config/ConfigManager');
 const { setPriorityConfigProfile, resolvePriorityProfileFromCrawlType } = require('../../shared/utils/priorityConfig');
 const { is_array } = require('lang-tools');
-const { parseRetryAfter } = require('./utils');
+const { parseRetryAfter, safeCall } = require('./utils');
 
 const DEFAULT_STARTUP_FETCH_TIMEOUT_MS = Number(process.env.CRAWLER_STARTUP_FETCH_TIMEOUT_MS || 15000);
 
@@ -91,6 +95,8 @@ function resolvePriorityProfileFromCrawlTypeLocal(crawlType) {
 function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} } = {}) {
   const options = rawOptions || {};
   const opts = Object.keys(resolvedOptions || {}).length ? resolvedOptions : (crawler._resolvedOptions || {});
+  // Injected transport (tests, replay benchmarks) for page, robots and sitemap fetches
+  const injectedFetchFn = typeof options.fetchFn === 'function' ? options.fetchFn : null;
 
   let decisionConfigSet = null;
   const decisionConfigSetSlug = (typeof opts.decisionConfigSetSlug === 'string' && opts.decisionConfigSetSlug.trim())
@@ -293,7 +299,20 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
   crawler.proxyManager.load();
 
   crawler.domainThrottle = new DomainThrottleManager({ state: crawler.state, pacerJitterMinMs: crawler.pacerJitterMinMs, pacerJitterMaxMs: crawler.pacerJitterMaxMs, getDbAdapter: () => crawler.dbAdapter });
-  crawler.articleProcessor = new ArticleProcessor({ linkExtractor: crawler.linkExtractor, normalizeUrl: (url, ctx) => crawler.normalizeUrl(url, ctx), looksLikeArticle: (url) => crawler.looksLikeArticle(url), computeUrlSignals: (url) => crawler._computeUrlSignals(url), computeContentSignals: ($, html) => crawler._computeContentSignals($, html), combineSignals: (urlSignals, contentSignals, opts) => crawler._combineSignals(urlSignals, contentSignals, opts), dbAdapter: () => crawler.dbAdapter, articleHeaderCache: crawler.state.getArticleHeaderCache(), knownArticlesCache: crawler.state.getKnownArticlesCache(), events: crawler.events, logger: console });
+  // Off-thread Readability/schema/gzip analysis; disabled unless analysisWorkers > 0
+  crawler.analysisPool = opts.analysisWorkers > 0
+    ? new AnalysisWorkerPool({ poolSize: opts.analysisWorkers, maxPending: opts.analysisMaxPending })
+    : null;
+  // Always-on fixed-memory latency histograms per stage/host; latencyHistograms: false turns them off
+  crawler.stageHistograms = opts.latencyHistograms === false
+    ? null
+    : new StageHistograms({ maxHosts: opts.latencyHistogramHosts });
+  crawler.articleProcessor = new ArticleProcessor({ linkExtractor: crawler.linkExtractor, normalizeUrl: (url, ctx) => crawler.normalizeUrl(url, ctx), looksLikeArticle: (url) => crawler.looksLikeArticle(url), computeUrlSignals: (url) => crawler._computeUrlSignals(url), computeContentSignals: ($, html) => crawler._computeContentSignals($, html), combineSignals: (urlSignals, contentSignals, opts) => crawler._combineSignals(urlSignals, contentSignals, opts), dbAdapter: () => crawler.dbAdapter, articleHeaderCache: crawler.state.getArticleHeaderCache(), knownArticlesCache: crawler.state.getKnownArticlesCache(), events: crawler.events, logger: console, analysisPool: crawler.analysisPool, stageHistograms: crawler.stageHistograms, onSaveCommitted: ({ kind, url }) => {
+    // Write-behind saves: counted and marked processed once the flush commits them
+    if (kind === 'article') crawler.state.incrementArticlesSaved(1);
+    const normalized = safeCall(() => crawler.normalizeUrl(url), url);
+    crawler.urlEligibilityService?.noteProcessed?.(normalized);
+  } });
   crawler.navigationDiscoveryService = new NavigationDiscoveryService({ linkExtractor: crawler.linkExtractor, normalizeUrl: (url, ctx) => crawler.normalizeUrl(url, ctx), looksLikeArticle: (url) => crawler.looksLikeArticle(url), logger: console });
   crawler.contentAcquisitionService = new ContentAcquisitionService({ articleProcessor: crawler.articleProcessor, logger: console });
   crawler.adaptiveSeedPlanner = new AdaptiveSeedPlanner({ baseUrl: crawler.baseUrl, state: crawler.state, telemetry: crawler.telemetry, normalizeUrl: (url) => crawler.normalizeUrl(url), enqueueRequest: (request) => crawler.enqueueRequest(request), logger: console });
@@ -308,8 +327,21 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
     getDbAdapter: () => crawler.dbAdapter,
     maxAgeHubMs: crawler.maxAgeHubMs,
     maxAgeArticleMs: crawler.maxAgeArticleMs,
-    urlDecisionOrchestrator: crawler.urlDecisionOrchestrator || null
+    urlDecisionOrchestrator: crawler.urlDecisionOrchestrator || null,
+    // Opt-in: warming scans every stored URL, bounded by the filter capacity
+    seenFilter: !opts.seenUrlFilter || opts.seenUrlFilter === 'off'
+      ? null
+      : { kind: opts.seenUrlFilter, capacity: opts.seenUrlFilterCapacity, warmLimit: opts.seenUrlFilterCapacity }
   });
+  // Tiered frontier: spill overflow to disk segments instead of dropping it
+  let frontierSpillStore = null;
+  if (opts.frontierSpillDir) {
+    try {
+      frontierSpillStore = new FrontierSpillStore({ dir: opts.frontierSpillDir });
+    } catch (e) {
+      console.warn('[CrawlerServiceWiring] Frontier spill store unavailable:', e.message);
+    }
+  }
   crawler.queue = new QueueManager({
     usePriorityQueue: crawler.usePriorityQueue,
     maxQueue: crawler.maxQueue,
@@ -326,6 +358,10 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
     getHostResumeTime: (host) => crawler._getHostResumeTime(host),
     isHostRateLimited: (host) => crawler._isHostRateLimited(host),
     jobIdProvider: () => crawler.jobId,
+    pullGate: () => (crawler.analysisPool ? crawler.analysisPool.waitForCapacity() : null),
+    spillStore: frontierSpillStore,
+    hotQueueCapacity: opts.frontierHotCapacity,
+    maxSpilled: opts.frontierMaxSpilled,
     onRateLimitDeferred: () => {
       try {
         crawler.state.incrementCacheRateLimitedDeferred();
@@ -335,11 +371,12 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
   crawler.robotsCoordinator = new RobotsAndSitemapCoordinator({
     baseUrl: crawler.baseUrl,
     domain: crawler.domain,
-    fetchImpl: timeoutFetch,
-    robotsParser,
+    fetchImpl: injectedFetchFn || timeoutFetch,
+    robotsParser: robotsRulesParser,
     loadSitemaps,
     useSitemap: crawler.useSitemap,
     sitemapMaxUrls: crawler.sitemapMaxUrls,
+    sitemapLastmodSince: crawler.sitemapLastmodSince,
     getUrlDecision: (url, ctx) => crawler._getUrlDecision(url, ctx),
     handlePolicySkip: (decision, info) => crawler._handlePolicySkip(decision, info),
     isOnDomain: (url) => crawler.isOnDomain(url),
@@ -411,8 +448,19 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
     console.warn('[CrawlerServiceWiring] domain_fetch_policies unavailable for puppeteer hosts:', err.message);
   }
 
+  // Per-host keep-alive pools (and optional HTTP/2) sized by politeness limits
+  crawler.connectionManager = opts.connectionPooling !== false
+    ? new HostConnectionManager({
+      maxSocketsPerHost: opts.maxSocketsPerHost,
+      idleTimeoutMs: opts.connectionIdleTimeoutMs,
+      http2: opts.http2 === true,
+      getHostSocketLimit: (host, max) => crawler.domainThrottle.getHostConnectionLimit(host, max),
+      stageHistograms: crawler.stageHistograms
+    })
+    : null;
+
   crawler.fetchPipeline = new FetchPipeline({
-    fetchFn: remoteFetchFn || undefined,
+    fetchFn: remoteFetchFn || injectedFetchFn || undefined,
     puppeteerFallback: { policyHosts: puppeteerPolicyHosts },
     getUrlDecision: (targetUrl, ctx) => crawler._getUrlDecision(targetUrl, ctx),
     normalizeUrl: (targetUrl, ctx) => crawler.normalizeUrl(targetUrl, ctx),
@@ -432,6 +480,12 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
     requestTimeoutMs: crawler.requestTimeoutMs,
     httpAgent: crawler.httpAgent,
     httpsAgent: crawler.httpsAgent,
+    connectionManager: crawler.connectionManager,
+    stageHistograms: crawler.stageHistograms,
+    streamBody: opts.streamBody !== false,
+    bodyByteCaps: (opts.capBodyBytes || opts.maxArticleBodyBytes || opts.maxHubBodyBytes)
+      ? { article: opts.maxArticleBodyBytes, hub: opts.maxHubBodyBytes }
+      : null,
     currentDownloads: crawler.state.currentDownloads,
     emitProgress: () => crawler.telemetry.progress(),
     note429: (host, retryAfterMs) => crawler.note429(host, retryAfterMs),
@@ -543,10 +597,12 @@ function wireCrawlerServices(crawler, { rawOptions = {}, resolvedOptions = {} }
     adaptiveSeedPlanner: crawler.adaptiveSeedPlanner,
     enqueueRequest: (request) => crawler.enqueueRequest(request),
     telemetry: crawler.telemetry,
+    stageHistograms: crawler.stageHistograms,
     recordError: (info) => crawler._recordError(info),
     normalizeUrl: (targetUrl) => crawler.normalizeUrl(targetUrl),
     looksLikeArticle: (targetUrl) => crawler.looksLikeArticle(targetUrl),
     noteDepthVisit: (normalized, depth) => crawler._noteDepthVisit(normalized, depth),
+    noteProcessed: (normalized) => crawler.urlEligibilityService?.noteProcessed(normalized),
     emitProgress: () => crawler.emitProgress(),
     getDbAdapter: () => crawler.dbAdapter,
     computeContentSignals: ($, html) => crawler._computeContentSignals($, html),
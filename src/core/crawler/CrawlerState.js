@@ -55,6 +55,9 @@ class CrawlerState {
 
     this.intelligentPlanSummary = null;
     this._plannerStageSeq = 0;
+
+    // Optional CheckpointJournal (see setJournal)
+    this.journal = null;
   }
 
   // --- Stats helpers ---
@@ -269,9 +272,18 @@ class CrawlerState {
   addVisited(normalizedUrl) {
     if (normalizedUrl) {
       this.visited.add(normalizedUrl);
+      if (this.journal) this.journal.recordVisited(normalizedUrl);
     }
   }
 
+  /**
+   * Record visits in a CheckpointJournal for incremental checkpoints.
+   * @param {Object|null} journal
+   */
+  setJournal(journal) {
+    this.journal = journal || null;
+  }
+
   hasSeededHub(normalizedUrl) {
     return this.seededHubUrls.has(normalizedUrl);
   }
@@ -92,6 +92,26 @@ class DomainThrottleManager {
     return false;
   }
 
+  /**
+   * How many connections are worth keeping open to a host under its current
+   * politeness limits. A host in backoff, rate-limited, or paced to at most
+   * one request per second gets a single (reused) socket; otherwise enough
+   * sockets to sustain its RPM at roughly two seconds per request.
+   * @param {string} host
+   * @param {number} [max=6] - Upper bound
+   * @returns {number}
+   */
+  getHostConnectionLimit(host, max = 6) {
+    const cap = Math.max(1, Math.floor(max));
+    if (!host) return cap;
+    const state = this.state.getDomainLimitState(host);
+    if (!state) return cap;
+    if (state.isLimited || (state.backoffUntil || 0) > nowMs()) return 1;
+    if ((state.politenessFloorMs || 0) >= 1000) return 1;
+    const rpm = state.rpm || 60;
+    return Math.max(1, Math.min(cap, Math.ceil((rpm / 60) * 2)));
+  }
+
   async acquireToken(host) {
     const state = this.getDomainState(host);
     if (!state) return;
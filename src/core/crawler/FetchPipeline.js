@@ -7,6 +7,14 @@ const EventEmitter = require('events');
 const http = require('http');
 const https = require('https');
 const { PuppeteerDomainManager } = require('./PuppeteerDomainManager');
+const {
+  readBodyStreaming,
+  classifyContentType,
+  resolveByteCap,
+  createDecodedStream,
+  readStreamText,
+  discardBody
+} = require('./StreamingBodyReader');
 
 // Lazy-load PuppeteerFetcher to avoid requiring puppeteer when not needed
 let PuppeteerFetcher = null;
@@ -79,18 +87,16 @@ function basicFetch(url, { headers, agent, signal } = {}) {
         agent
       },
       (res) => {
-        const chunks = [];
-        res.on('data', (chunk) => chunks.push(Buffer.from(chunk)));
-        res.on('end', () => {
-          const body = Buffer.concat(chunks);
-          const status = Number(res.statusCode || 0);
-          const headersFacade = createHeadersFacade(res.headers);
-          resolve({
-            status,
-            ok: status >= 200 && status < 300,
-            headers: headersFacade,
-            text: async () => body.toString('utf8')
-          });
+        // Resolve at headers like fetch() does; the decoded body is streamed
+        // so FetchPipeline can sniff <head> and stop reading early.
+        const status = Number(res.statusCode || 0);
+        const body = createDecodedStream(res, res.headers['content-encoding']);
+        resolve({
+          status,
+          ok: status >= 200 && status < 300,
+          headers: createHeadersFacade(res.headers),
+          body,
+          text: () => readStreamText(body)
         });
       }
     );
@@ -181,6 +187,7 @@ class FetchPipeline extends EventEmitter {
    * @param {number} opts.requestTimeoutMs
    * @param {import('http').Agent} opts.httpAgent
    * @param {import('https').Agent} opts.httpsAgent
+   * @param {import('./HostConnectionManager').HostConnectionManager} [opts.connectionManager] - Per-host pools; replaces the shared agents when set
    * @param {Map<string, any>} opts.currentDownloads
    * @param {() => void} opts.emitProgress
    * @param {(host: string, retryAfterMs: number|null) => void} opts.note429
@@ -194,6 +201,8 @@ class FetchPipeline extends EventEmitter {
   * @param {(info: object) => void} [opts.onCacheServed]
    * @param {{info: Function, warn: Function, error: Function} | undefined} opts.logger
    * @param {Function} [opts.fetchFn]
+   * @param {boolean} [opts.streamBody=true] - Stream bodies with <head> sniffing, early abort and byte caps
+   * @param {{article?: number, hub?: number, xml?: number, other?: number}} [opts.bodyByteCaps] - Per-type body byte caps (omit to read bodies in full)
   * @param {(decision: object, extras: object) => void} [opts.handlePolicySkip]
    */
   constructor(opts) {
@@ -217,6 +226,9 @@ class FetchPipeline extends EventEmitter {
     this.requestTimeoutMs = opts.requestTimeoutMs;
     this.httpAgent = opts.httpAgent;
     this.httpsAgent = opts.httpsAgent;
+    this.connectionManager = opts.connectionManager || null;
+    this.streamBody = opts.streamBody !== false;
+    this.bodyByteCaps = opts.bodyByteCaps && typeof opts.bodyByteCaps === 'object' ? opts.bodyByteCaps : null;
     this.currentDownloads = opts.currentDownloads;
     this.emitProgress = typeof opts.emitProgress === 'function' ? opts.emitProgress : () => {};
     this.note429 = opts.note429;
@@ -224,6 +236,8 @@ class FetchPipeline extends EventEmitter {
     this.recordError = opts.recordError;
     this.handleConnectionReset = opts.handleConnectionReset;
     this.telemetry = opts.telemetry || null;
+    // Optional StageHistograms: firstByte/download latency per host (hrtime)
+    this.stageHistograms = opts.stageHistograms || null;
     // Phase 1: Resilience services
     this.resilienceService = opts.resilienceService || null;
     this.contentValidationService = opts.contentValidationService || null;
@@ -293,6 +307,8 @@ class FetchPipeline extends EventEmitter {
     this.parseRetryAfter = opts.parseRetryAfter;
     this.onCacheServed = typeof opts.onCacheServed === 'function' ? opts.onCacheServed : null;
     this.fetchFn = typeof opts.fetchFn === 'function' ? opts.fetchFn : fetchImpl;
+    // HTTP/2 bypasses fetchFn, so only the built-in transport may use it
+    this._allowHttp2 = this.fetchFn === fetchImpl;
     this.logger = opts.logger || defaultLogger();
     this.handlePolicySkip = typeof opts.handlePolicySkip === 'function' ? opts.handlePolicySkip : null;
     
@@ -400,7 +416,11 @@ class FetchPipeline extends EventEmitter {
       healthCheckEnabled: puppeteerOpts.healthCheckEnabled !== false,
       healthCheckIntervalMs: puppeteerOpts.healthCheckIntervalMs || 30000,
       restartOnError: puppeteerOpts.restartOnError !== false,
-      maxConsecutiveErrors: puppeteerOpts.maxConsecutiveErrors || 3
+      maxConsecutiveErrors: puppeteerOpts.maxConsecutiveErrors || 3,
+      // Warm per-domain pages with images/media/fonts/ad hosts blocked
+      pagePool: puppeteerOpts.pagePool !== undefined ? puppeteerOpts.pagePool : true,
+      blockResources: puppeteerOpts.blockResources !== false,
+      blockedResourceTypes: puppeteerOpts.blockedResourceTypes
     });
     
     // Wire up telemetry events
@@ -432,6 +452,15 @@ class FetchPipeline extends EventEmitter {
     return this._puppeteerFetcher.getTelemetry();
   }
 
+  /**
+   * Get connection pool telemetry stats (handshakes, reuse, per-origin sockets)
+   * @returns {Object|null} Telemetry object or null if pooling is disabled
+   */
+  getConnectionTelemetry() {
+    if (!this.connectionManager) return null;
+    return this.connectionManager.getStats();
+  }
+
   /**
    * Check if a host should use Puppeteer fallback
    * @param {string} host
@@ -464,6 +493,86 @@ class FetchPipeline extends EventEmitter {
     );
   }
 
+  /**
+   * Issue one GET without following redirects. A proxy agent wins; otherwise
+   * the per-host connection manager supplies an HTTP/2 session or a pooled
+   * keep-alive agent, falling back to the shared agents when pooling is off.
+   * @param {string} url
+   * @param {{headers: Object, signal: AbortSignal, proxyAgent?: Object|null}} init
+   */
+  async _request(url, { headers, signal, proxyAgent = null }) {
+    let agent = proxyAgent;
+    if (!agent && this.connectionManager) {
+      if (this._allowHttp2) {
+        const http2Response = await this.connectionManager.requestHttp2(url, { headers, signal });
+        if (http2Response) return http2Response;
+      }
+      agent = this.connectionManager.agentFor(url);
+    }
+    if (!agent) {
+      agent = url.startsWith('http:') ? this.httpAgent : this.httpsAgent;
+    }
+    return this.fetchFn(url, {
+      headers,
+      agent,
+      signal,
+      redirect: 'manual'  // Handle redirects manually to fix protocol
+    });
+  }
+
+  /**
+   * Read a response body. Binary content types are dropped unread; HTML is
+   * streamed with its <head> judged as soon as it arrives, and every type is
+   * held to its byte cap (articles get a larger cap than hubs).
+   * @returns {Promise<{html: string, bytes: number, truncated: boolean, abortReason: string|null, head: Object|null}>}
+   */
+  async _readNetworkBody(response, { url, contentType, abortController }) {
+    if (!this.streamBody) {
+      const html = await response.text();
+      return { html, bytes: Buffer.byteLength(html, 'utf8'), truncated: false, abortReason: null, head: null };
+    }
+    const contentKind = classifyContentType(contentType);
+    if (contentKind === 'binary') {
+      discardBody(response);
+      safeCall(() => abortController.abort());
+      return { html: '', bytes: 0, truncated: false, abortReason: 'binary-content', head: null };
+    }
+    const urlLooksArticle = contentKind === 'html' && !!safeCall(() => this.looksLikeArticle(url), false);
+    return readBodyStreaming(response, {
+      byteCap: resolveByteCap(this.bodyByteCaps, { contentKind, isArticle: urlLooksArticle }),
+      abort: () => abortController.abort(),
+      signal: abortController.signal,
+      onHead: contentKind === 'html' ? (head) => this._judgeStreamedHead(url, head, urlLooksArticle) : null
+    });
+  }
+
+  /**
+   * Decide about a page from its <head>: stop when the canonical URL was
+   * already fetched or is refused by the URL policy, and raise the byte cap
+   * when og:type / JSON-LD mark a URL that did not look like one as an article.
+   */
+  _judgeStreamedHead(url, head, urlLooksArticle) {
+    if (head.canonical) {
+      const canonical = safeCall(() => this.normalizeUrl(new URL(head.canonical, url).href), null);
+      const self = safeCall(() => this.normalizeUrl(url), url);
+      // A canonical pointing at the site root is usually a template default, not a duplicate
+      const isRoot = canonical ? safeCall(() => new URL(canonical).pathname === '/', false) : false;
+      if (canonical && canonical !== self && !isRoot) {
+        if (this.hasVisited(canonical)) {
+          return { abortReason: 'canonical-already-visited' };
+        }
+        const decision = safeCall(() => this.getUrlDecision(canonical, { phase: 'fetch-canonical' }), null);
+        if (decision && decision.allow === false) {
+          return { abortReason: `canonical-${decision.reason || 'policy'}` };
+        }
+      }
+    }
+    if (head.looksLikeArticle && !urlLooksArticle) {
+      return { byteCap: resolveByteCap(this.bodyByteCaps, { contentKind: 'html', isArticle: true }) };
+    }
+    return null;
+  }
+
   /**
    * Cleanup Puppeteer resources (call when crawler is done)
    * @returns {Promise<Object|null>} Final telemetry stats or null
@@ -879,6 +988,7 @@ class FetchPipeline extends EventEmitter {
     }
 
     const started = Date.now();
+    const startedNs = this._stageMark(null, host, null);
     const requestStartedIso = new Date(started).toISOString();
     this.currentDownloads.set(normalizedUrl, { startedAt: started, policy: decision });
     this.emitProgress();
@@ -916,27 +1026,26 @@ class FetchPipeline extends EventEmitter {
       if (conditionalHeaders) Object.assign(headers, conditionalHeaders);
 
       // Determine which agent to use (proxy or direct)
-      let fetchAgent = parsedUrl.protocol === 'http:' ? this.httpAgent : this.httpsAgent;
+      let proxyAgent = null;
       this._currentProxyInfo = null;
       
       if (this.proxyManager && this.proxyManager.isEnabled()) {
         const proxyResult = this.proxyManager.getAgent(host);
         if (proxyResult) {
-          fetchAgent = proxyResult.agent;
+          proxyAgent = proxyResult.agent;
           this._currentProxyInfo = proxyResult.proxyInfo;
           this.logger.info(`[proxy] Using ${this._currentProxyInfo.name} for ${normalizedUrl}`, { type: 'PROXY' });
         }
       }
 
-      const response = await this.fetchFn(normalizedUrl, {
+      // requestTimeoutMs bounds the whole fetch, body included: the timer
+      // is only cleared (in finally) once the body has been read.
+      const response = await this._request(normalizedUrl, {
         headers,
-        agent: fetchAgent,
-        signal: abortController.signal,
-        redirect: 'manual'  // Handle redirects manually to fix protocol
+        proxyAgent,
+        signal: abortController.signal
       });
 
-      clearTimeout(timeoutHandle);
-
       // Handle redirects manually with protocol correction (support multiple redirects)
       let actualResponse = response;
       let finalUrl = normalizedUrl;
@@ -965,11 +1074,9 @@ class FetchPipeline extends EventEmitter {
         this.logger.info(`Following redirect ${redirectCount}: ${finalUrl} → ${redirectUrl}`);
         
         // Follow the redirect
-        actualResponse = await this.fetchFn(redirectUrl, {
+        actualResponse = await this._request(redirectUrl, {
           headers,
-          agent: redirectUrl.startsWith('https:') ? this.httpsAgent : this.httpAgent,
-          signal: abortController.signal,
-          redirect: 'manual'
+          signal: abortController.signal
         });
         finalUrl = redirectUrl;
       }
@@ -980,6 +1087,7 @@ class FetchPipeline extends EventEmitter {
       }
 
       const headersReady = Date.now();
+      const headersNs = this._stageMark('firstByte', host, startedNs);
       const ttfbMs = headersReady - started;
       const status = actualResponse.status;
       const etag = actualResponse.headers.get('etag') || null;
@@ -1135,11 +1243,17 @@ class FetchPipeline extends EventEmitter {
         });
       }
 
-      const html = await actualResponse.text();
+      const body = await this._readNetworkBody(actualResponse, {
+        url: finalUrl,
+        contentType: contentTypeHeader,
+        abortController
+      });
+      const html = body.html;
       const finished = Date.now();
+      this._stageMark('download', host, headersNs);
       const downloadMs = finished - headersReady;
       const totalMs = finished - started;
-      const bytesDownloaded = Buffer.byteLength(html, 'utf8');
+      const bytesDownloaded = body.bytes;
       const transferKbps = downloadMs > 0 ? (bytesDownloaded / 1024) / (downloadMs / 1000) : null;
       
       // Use finalUrl from redirect handling above, or fall back to normalizedUrl
@@ -1166,6 +1280,8 @@ class FetchPipeline extends EventEmitter {
         transferKbps,
         conditional: !!conditionalHeaders
       };
+      if (body.truncated) fetchMeta.bodyTruncated = true;
+      if (body.abortReason) fetchMeta.streamAbortReason = body.abortReason;
       fetchMeta.freshness = classifyFreshness({
         source: 'network',
         status: 'success',
@@ -1189,7 +1305,7 @@ class FetchPipeline extends EventEmitter {
           bytesDownloaded,
           transferKbps
         },
-        body: STORE_SUCCESS_RESPONSE_BODIES ? html : null,
+        body: STORE_SUCCESS_RESPONSE_BODIES && !body.truncated ? html : null,
         redirectChain
       });
 
@@ -1212,6 +1328,25 @@ class FetchPipeline extends EventEmitter {
         this.resilienceService.recordSuccess(host);
       }
 
+      // Streaming read stopped early: binary body or unwanted per its <head>
+      if (body.abortReason) {
+        this.logger.info(`[stream] Stopped ${finalUrl} after ${bytesDownloaded} bytes: ${body.abortReason}`, { type: 'NETWORK' });
+        this.emit('fetch:aborted', { url: finalUrl, reason: body.abortReason, bytes: bytesDownloaded });
+        return this._buildResult({
+          status: 'skipped',
+          source: 'stream-aborted',
+          url: finalUrl,
+          html: null,
+          fetchMeta,
+          decision,
+          reason: body.abortReason
+        });
+      }
+      if (body.truncated) {
+        // Kept for link discovery only; PageExecutionService does not persist it
+        this.logger.info(`[stream] Truncated ${finalUrl} at ${bytesDownloaded} bytes`, { type: 'NETWORK' });
+      }
+
       // Phase 1: Content validation - reject garbage content before processing
       if (this.contentValidationService && html) {
         const validation = this.contentValidationService.validate({
@@ -1631,6 +1766,21 @@ class FetchPipeline extends EventEmitter {
     this._hostRetryManager._emitHostBudgetTelemetry(stage, host, state, extras);
   }
 
+  /**
+   * Record `stage` for `host` since `sinceNs` into the stage histograms and
+   * return the current hrtime, so consecutive marks chain. A null stage
+   * just takes the timestamp. No-op (null) without histograms.
+   * @returns {bigint|null}
+   */
+  _stageMark(stage, host, sinceNs) {
+    if (!this.stageHistograms) return null;
+    const now = process.hrtime.bigint();
+    if (stage && sinceNs !== null) {
+      safeCall(() => this.stageHistograms.record(stage, host, now - sinceNs));
+    }
+    return now;
+  }
+
   _safeHost(url, fallback = null) {
     if (!url) return fallback;
     try {
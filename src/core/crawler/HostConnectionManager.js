@@ -0,0 +1,449 @@
+'use strict';
+
+const http = require('http');
+const https = require('https');
+const http2 = require('http2');
+const tls = require('tls');
+const { safeCall } = require('./utils');
+const { createDecodedStream, readStreamText } = require('./StreamingBodyReader');
+
+const DEFAULT_MAX_SOCKETS_PER_HOST = 6;
+const DEFAULT_IDLE_TIMEOUT_MS = 30000;
+const ALPN_PROBE_TIMEOUT_MS = 5000;
+
+/**
+ * HostConnectionManager - per-origin connection pools for FetchPipeline.
+ *
+ * Every origin gets its own keep-alive agent whose socket cap follows the
+ * host's politeness limits (`getHostSocketLimit`, normally
+ * DomainThrottleManager.getHostConnectionLimit), so a crawl-delayed host holds
+ * one warm connection instead of opening a fresh TCP/TLS handshake per
+ * request, and one busy host can no longer take every socket of a shared
+ * agent.
+ *
+ * With `http2` enabled, https origins are probed once with ALPN. Origins that
+ * negotiate h2 are served over a single multiplexed session (the probe socket
+ * becomes the session, so no handshake is wasted); everything else stays on
+ * the HTTP/1.1 agent.
+ *
+ * Idle pools are evicted by a background sweep: free sockets close after
+ * `idleTimeoutMs` of silence, and an origin with nothing in flight for that
+ * long drops its agent/session entirely.
+ */
+class HostConnectionManager {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxSocketsPerHost=6] - Upper bound on sockets per origin
+   * @param {(host: string, max: number) => number} [options.getHostSocketLimit] - Politeness-derived cap
+   * @param {number} [options.idleTimeoutMs=30000] - Idle time before sockets/pools are evicted
+   * @param {boolean} [options.http2=false] - Negotiate HTTP/2 with https origins
+   * @param {Object} [options.stageHistograms] - StageHistograms for dns/tcp/tls handshake latency
+   */
+  constructor(options = {}) {
+    this.maxSocketsPerHost = Math.max(1, Math.floor(options.maxSocketsPerHost || DEFAULT_MAX_SOCKETS_PER_HOST));
+    this.getHostSocketLimit = typeof options.getHostSocketLimit === 'function' ? options.getHostSocketLimit : null;
+    this.idleTimeoutMs = Math.max(1000, options.idleTimeoutMs || DEFAULT_IDLE_TIMEOUT_MS);
+    this.http2Enabled = options.http2 === true;
+    this.stageHistograms = options.stageHistograms || null;
+
+    this._origins = new Map(); // origin -> entry (see _entry)
+    this._totals = {
+      requests: 0,
+      handshakes: 0,
+      tlsHandshakes: 0,
+      handshakeMs: 0,
+      reusedRequests: 0,
+      http2Sessions: 0,
+      http2Streams: 0,
+      alpnProbes: 0,
+      evictedPools: 0,
+      errors: 0
+    };
+    this._sweepTimer = setInterval(() => this.evictIdle(), Math.max(500, Math.floor(this.idleTimeoutMs / 2)));
+    safeCall(() => this._sweepTimer.unref());
+    this._closed = false;
+  }
+
+  /**
+   * Keep-alive agent for a URL's origin, sized to the host's current limit.
+   * @param {string|URL} url
+   * @returns {import('http').Agent|import('https').Agent}
+   */
+  agentFor(url) {
+    const parsed = url instanceof URL ? url : new URL(url);
+    const entry = this._entry(parsed);
+    if (!entry.agent) {
+      entry.agent = this._createAgent(parsed.protocol === 'https:' ? https.Agent : http.Agent, entry);
+    }
+    const limit = this._socketLimit(parsed.hostname);
+    entry.agent.maxSockets = limit;
+    entry.agent.maxFreeSockets = limit;
+    entry.lastUsedAt = Date.now();
+    entry.requests += 1;
+    this._totals.requests += 1;
+    return entry.agent;
+  }
+
+  /**
+   * Issue a GET over HTTP/2 when the origin supports it. Resolves to a
+   * fetch-like response ({status, ok, headers.get, text}) or null when the
+   * caller should use the HTTP/1.1 agent instead.
+   * @param {string} url
+   * @param {{headers?: Object, signal?: AbortSignal}} [init]
+   * @returns {Promise<Object|null>}
+   */
+  async requestHttp2(url, { headers = {}, signal = null } = {}) {
+    if (!this.http2Enabled || this._closed) return null;
+    const parsed = new URL(url);
+    if (parsed.protocol !== 'https:') return null;
+    const entry = this._entry(parsed);
+    if (entry.protocol === 'http/1.1') return null;
+
+    const session = await this._sessionFor(entry, parsed, signal);
+    if (!session) return null;
+
+    entry.lastUsedAt = Date.now();
+    entry.requests += 1;
+    this._totals.requests += 1;
+    this._totals.http2Streams += 1;
+    if (entry.sessionStreams > 0) {
+      entry.reusedRequests += 1;
+      this._totals.reusedRequests += 1;
+    }
+    entry.sessionStreams += 1;
+    return this._http2Get(entry, session, parsed, headers, signal);
+  }
+
+  /**
+   * Close free sockets and sessions of origins idle for `idleTimeoutMs`.
+   * @returns {number} Pools evicted
+   */
+  evictIdle(now = Date.now()) {
+    let evicted = 0;
+    for (const entry of this._origins.values()) {
+      if (!entry.agent && !entry.session) continue;
+      if (now - entry.lastUsedAt < this.idleTimeoutMs || entry.inflight > 0) continue;
+      if (entry.agent && (hasEntries(entry.agent.sockets) || hasEntries(entry.agent.requests))) continue;
+      // The entry itself stays so the negotiated protocol is remembered
+      this._destroyEntry(entry);
+      evicted += 1;
+    }
+    this._totals.evictedPools += evicted;
+    return evicted;
+  }
+
+  /**
+   * Connection telemetry: handshakes vs reuses overall and per origin.
+   */
+  getStats() {
+    const totals = this._totals;
+    const origins = [];
+    let openSockets = 0;
+    let freeSockets = 0;
+    for (const entry of this._origins.values()) {
+      const active = entry.agent ? countSockets(entry.agent.sockets) : 0;
+      const free = entry.agent ? countSockets(entry.agent.freeSockets) : 0;
+      openSockets += active + free;
+      freeSockets += free;
+      origins.push({
+        origin: entry.origin,
+        protocol: entry.protocol || 'http/1.1',
+        maxSockets: entry.agent ? entry.agent.maxSockets : null,
+        activeSockets: active,
+        freeSockets: free,
+        http2Session: !!(entry.session && !entry.session.destroyed),
+        requests: entry.requests,
+        handshakes: entry.handshakes,
+        reusedRequests: entry.reusedRequests,
+        lastUsedAt: entry.lastUsedAt
+      });
+    }
+    return {
+      ...totals,
+      reuseRate: totals.requests > 0 ? Number((totals.reusedRequests / totals.requests).toFixed(3)) : null,
+      avgHandshakeMs: totals.tlsHandshakes > 0 ? Math.round(totals.handshakeMs / totals.tlsHandshakes) : null,
+      origins: origins.length,
+      openSockets,
+      freeSockets,
+      perOrigin: origins
+    };
+  }
+
+  destroy() {
+    this._closed = true;
+    clearInterval(this._sweepTimer);
+    for (const entry of this._origins.values()) {
+      this._destroyEntry(entry);
+    }
+    this._origins.clear();
+  }
+
+  _entry(parsed) {
+    const origin = parsed.origin;
+    let entry = this._origins.get(origin);
+    if (!entry) {
+      entry = {
+        origin,
+        host: parsed.hostname,
+        agent: null,
+        protocol: parsed.protocol === 'https:' ? null : 'http/1.1', // null = not negotiated yet
+        session: null,
+        sessionPromise: null,
+        sessionStreams: 0,
+        inflight: 0,
+        requests: 0,
+        handshakes: 0,
+        reusedRequests: 0,
+        lastUsedAt: Date.now()
+      };
+      this._origins.set(origin, entry);
+    }
+    return entry;
+  }
+
+  _socketLimit(host) {
+    const max = this.maxSocketsPerHost;
+    if (!this.getHostSocketLimit) return max;
+    const limit = safeCall(() => this.getHostSocketLimit(host, max), max);
+    return Number.isFinite(limit) ? Math.max(1, Math.min(max, Math.floor(limit))) : max;
+  }
+
+  _createAgent(BaseAgent, entry) {
+    const manager = this;
+    class PooledAgent extends BaseAgent {
+      createConnection(...args) {
+        const socket = super.createConnection(...args);
+        manager._noteHandshake(entry, socket);
+        return socket;
+      }
+
+      reuseSocket(socket, req) {
+        entry.reusedRequests += 1;
+        manager._totals.reusedRequests += 1;
+        return super.reuseSocket(socket, req);
+      }
+    }
+    return new PooledAgent({
+      keepAlive: true,
+      scheduling: 'lifo', // keep the warmest socket busy so the rest can idle out
+      timeout: this.idleTimeoutMs
+    });
+  }
+
+  _noteHandshake(entry, socket) {
+    entry.handshakes += 1;
+    this._totals.handshakes += 1;
+    if (!socket || typeof socket.once !== 'function') return;
+    const startedAt = Date.now();
+    socket.once('secureConnect', () => {
+      this._totals.tlsHandshakes += 1;
+      this._totals.handshakeMs += Date.now() - startedAt;
+    });
+    if (this.stageHistograms) this._timeHandshake(entry.host, socket);
+  }
+
+  /**
+   * Split a fresh socket's setup into dns (lookup), tcp (connect) and tls
+   * (secureConnect) for the stage histograms. Literal IPs skip 'lookup', so
+   * tcp then covers the whole time to connect.
+   */
+  _timeHandshake(host, socket) {
+    const histograms = this.stageHistograms;
+    let mark = process.hrtime.bigint();
+    const phase = (stage) => () => {
+      const now = process.hrtime.bigint();
+      safeCall(() => histograms.record(stage, host, now - mark));
+      mark = now;
+    };
+    socket.once('lookup', phase('dns'));
+    socket.once('connect', phase('tcp'));
+    socket.once('secureConnect', phase('tls'));
+  }
+
+  async _sessionFor(entry, parsed, signal) {
+    if (entry.session && !entry.session.destroyed && !entry.session.closed) return entry.session;
+    entry.session = null;
+    if (!entry.sessionPromise) {
+      entry.sessionPromise = this._openSession(entry, parsed).finally(() => {
+        entry.sessionPromise = null;
+      });
+    }
+    const session = await entry.sessionPromise;
+    if (signal && signal.aborted) throw abortError();
+    return session;
+  }
+
+  /**
+   * Open a TLS connection offering h2 and http/1.1. If the server picks h2 the
+   * socket is handed to an HTTP/2 session; otherwise the origin is pinned to
+   * HTTP/1.1 and the probe socket is closed.
+   */
+  _openSession(entry, parsed) {
+    const firstContact = entry.protocol === null;
+    if (firstContact) this._totals.alpnProbes += 1;
+    return new Promise((resolve) => {
+      const startedAt = Date.now();
+      const port = Number(parsed.port) || 443;
+      const socket = tls.connect({
+        host: parsed.hostname,
+        port,
+        servername: parsed.hostname,
+        ALPNProtocols: ['h2', 'http/1.1']
+      });
+      entry.handshakes += 1;
+      this._totals.handshakes += 1;
+
+      const timer = setTimeout(() => socket.destroy(new Error('ALPN negotiation timed out')), ALPN_PROBE_TIMEOUT_MS);
+      const settle = (session) => {
+        clearTimeout(timer);
+        resolve(session);
+      };
+
+      socket.once('error', () => {
+        this._totals.errors += 1;
+        // Let the HTTP/1.1 path surface the real network error.
+        if (firstContact) entry.protocol = 'http/1.1';
+        settle(null);
+      });
+      socket.once('secureConnect', () => {
+        this._totals.tlsHandshakes += 1;
+        this._totals.handshakeMs += Date.now() - startedAt;
+        if (socket.alpnProtocol !== 'h2') {
+          entry.protocol = 'http/1.1';
+          socket.destroy();
+          settle(null);
+          return;
+        }
+        entry.protocol = 'h2';
+        const session = http2.connect(entry.origin, { createConnection: () => socket });
+        session.on('error', () => {
+          this._totals.errors += 1;
+        });
+        session.on('close', () => {
+          if (entry.session === session) {
+            entry.session = null;
+            entry.sessionStreams = 0;
+          }
+        });
+        session.on('goaway', () => safeCall(() => session.close()));
+        safeCall(() => session.unref());
+        this._totals.http2Sessions += 1;
+        entry.session = session;
+        entry.sessionStreams = 0;
+        settle(session);
+      });
+    });
+  }
+
+  _http2Get(entry, session, parsed, headers, signal) {
+    return new Promise((resolve, reject) => {
+      const requestHeaders = {
+        ':method': 'GET',
+        ':path': `${parsed.pathname || '/'}${parsed.search || ''}`,
+        ':authority': parsed.host
+      };
+      for (const [name, value] of Object.entries(headers || {})) {
+        const key = name.toLowerCase();
+        // Connection-specific headers are illegal in HTTP/2
+        if (key === 'connection' || key === 'keep-alive' || key === 'host' || key === 'upgrade' || key === 'transfer-encoding') continue;
+        requestHeaders[key] = value;
+      }
+
+      let stream;
+      try {
+        stream = session.request(requestHeaders, { endStream: true });
+      } catch (err) {
+        reject(err);
+        return;
+      }
+      entry.inflight += 1;
+      safeCall(() => session.ref());
+
+      // The promise settles at response headers; the stream's slot is only
+      // released once it closes, so idle eviction never cuts a live body.
+      let settled = false;
+      let released = false;
+      let body = null;
+      const settle = (err, value) => {
+        if (settled) return;
+        settled = true;
+        if (err) reject(err);
+        else resolve(value);
+      };
+      const release = () => {
+        if (released) return;
+        released = true;
+        entry.inflight -= 1;
+        entry.lastUsedAt = Date.now();
+        if (entry.inflight === 0) safeCall(() => session.unref());
+        if (signal) safeCall(() => signal.removeEventListener('abort', onAbort));
+      };
+      const onAbort = () => {
+        const err = abortError();
+        safeCall(() => stream.close(http2.constants.NGHTTP2_CANCEL));
+        if (body) safeCall(() => body.destroy(err));
+        settle(err);
+        release();
+      };
+      if (signal) {
+        if (signal.aborted) {
+          onAbort();
+          return;
+        }
+        safeCall(() => signal.addEventListener('abort', onAbort, { once: true }));
+      }
+
+      stream.on('response', (responseHeaders) => {
+        const status = Number(responseHeaders[':status'] || 0);
+        body = createDecodedStream(stream, responseHeaders['content-encoding']);
+        settle(null, {
+          status,
+          ok: status >= 200 && status < 300,
+          httpVersion: '2.0',
+          headers: {
+            get(name) {
+              if (!name) return null;
+              const value = responseHeaders[String(name).toLowerCase()];
+              if (value == null) return null;
+              return Array.isArray(value) ? value.join(', ') : String(value);
+            }
+          },
+          body,
+          text: () => readStreamText(body)
+        });
+      });
+      stream.on('error', (err) => {
+        this._totals.errors += 1;
+        settle(err);
+      });
+      stream.on('close', () => {
+        settle(new Error(`HTTP/2 stream closed (code ${stream.rstCode})`));
+        release();
+      });
+    });
+  }
+
+  _destroyEntry(entry) {
+    if (entry.agent) safeCall(() => entry.agent.destroy());
+    if (entry.session) safeCall(() => entry.session.close());
+    entry.agent = null;
+    entry.session = null;
+  }
+}
+
+function abortError() {
+  return Object.assign(new Error('Aborted'), { name: 'AbortError' });
+}
+
+function hasEntries(map) {
+  return !!map && Object.keys(map).length > 0;
+}
+
+function countSockets(map) {
+  if (!map) return 0;
+  let count = 0;
+  for (const list of Object.values(map)) count += list.length;
+  return count;
+}
+
+module.exports = { HostConnectionManager };
@@ -0,0 +1,154 @@
+'use strict';
+
+const NAV_SELECTORS = Object.freeze([
+  'header a', 'nav a', 'footer a', '[role="navigation"] a', '.menu a', '.nav a',
+  '.navigation a', '.breadcrumb a', '.breadcrumbs a', '.pagination a', '.pager a'
+]);
+
+const ARTICLE_SELECTORS = Object.freeze([
+  'article a', '.article a', '.story a', '.content a[href*="/"]', 'a[href*="/article"]',
+  'a[href*="/story"]', 'a[href*="/news"]', 'a[href*="/world"]', 'a[href*="/politics"]',
+  'a[href*="/business"]', 'a[href*="/sport"]', 'a[href*="/culture"]', 'a[href*="/opinion"]',
+  'a[href*="/lifestyle"]', 'a[href*="/technology"]', 'h1 a', 'h2 a', 'h3 a'
+]);
+
+const NAV_SELECTOR = NAV_SELECTORS.join(', ');
+const ARTICLE_SELECTOR = ARTICLE_SELECTORS.join(', ');
+
+/**
+ * LinkClassifier - one-pass navigation/article link classification with a
+ * per-crawl href memo.
+ *
+ * `links.js` runs one cheerio query per selector (29 in total) and calls
+ * normalizeUrl / isOnDomain / looksLikeArticle for every match, so an href
+ * that appears in both `nav a` and `h2 a`, or on every page of the crawl
+ * (menus, footers), is parsed again each time. The classifier:
+ * - queries each selector group once as a single selector list, in
+ *   document order with no duplicate elements;
+ * - resolves each distinct raw href once per crawl (normalized URL and
+ *   on-domain flag), remembered in a bounded memo;
+ * - visits each anchor once and emits it into both result sets when it
+ *   belongs to both.
+ *
+ * Normalization is still delegated to the crawler (UrlPolicy via
+ * normalizeUrl), so the memo only caches its answers. The article check runs
+ * per link because its patterns can change with the decision config.
+ */
+class LinkClassifier {
+  /**
+   * @param {Object} options
+   * @param {(href: string) => string|null} options.normalizeUrl
+   * @param {(url: string) => boolean} options.isOnDomain
+   * @param {(url: string) => boolean} options.looksLikeArticle
+   * @param {number} [options.memoLimit=50000] - Distinct hrefs remembered per crawl
+   */
+  constructor(options = {}) {
+    const { normalizeUrl, isOnDomain, looksLikeArticle } = options;
+    if (typeof normalizeUrl !== 'function') {
+      throw new Error('LinkClassifier requires a normalizeUrl function');
+    }
+    if (typeof isOnDomain !== 'function') {
+      throw new Error('LinkClassifier requires an isOnDomain function');
+    }
+    if (typeof looksLikeArticle !== 'function') {
+      throw new Error('LinkClassifier requires a looksLikeArticle function');
+    }
+    this.normalizeUrl = normalizeUrl;
+    this.isOnDomain = isOnDomain;
+    this.looksLikeArticle = looksLikeArticle;
+    this.memoLimit = Math.max(1, options.memoLimit || 50000);
+    this._memo = new Map();
+    this._stats = { resolved: 0, memoHits: 0, anchors: 0 };
+  }
+
+  /**
+   * Normalize an href (memoized). Returns null for hrefs the policy rejects.
+   * @param {string} href
+   * @returns {{url: string, onDomain: boolean}|null}
+   */
+  resolve(href) {
+    const cached = this._memo.get(href);
+    if (cached !== undefined) {
+      this._stats.memoHits += 1;
+      return cached;
+    }
+    this._stats.resolved += 1;
+    const url = this.normalizeUrl(href);
+    const entry = url ? { url, onDomain: !!this.isOnDomain(url) } : null;
+    if (this._memo.size >= this.memoLimit) {
+      // Oldest first: site-wide menu links are seen early and re-added on the next page
+      this._memo.delete(this._memo.keys().next().value);
+    }
+    this._memo.set(href, entry);
+    return entry;
+  }
+
+  /**
+   * Classify every anchor on a page.
+   * @param {import('cheerio').CheerioAPI} $
+   * @returns {{navigation: Array, articles: Array}} Navigation links (on-domain only) and article links, deduped by URL
+   */
+  classify($) {
+    const navigation = [];
+    const articles = [];
+    const seenNav = new Set();
+    const seenArticles = new Set();
+    const navElements = new Set($(NAV_SELECTOR).toArray());
+    const articleElements = new Set($(ARTICLE_SELECTOR).toArray());
+
+    const visit = (el) => {
+      const inNav = navElements.has(el);
+      const inArticle = articleElements.has(el);
+      const href = el.attribs && el.attribs.href;
+      if (!href) return;
+      this._stats.anchors += 1;
+      const resolved = this.resolve(href);
+      if (!resolved || !resolved.onDomain) return;
+      const wantNav = inNav && !seenNav.has(resolved.url);
+      const wantArticle = inArticle && !seenArticles.has(resolved.url) && this.looksLikeArticle(resolved.url);
+      if (!wantNav && !wantArticle) return;
+      const $el = $(el);
+      const link = {
+        url: resolved.url,
+        anchor: $el.text().trim().slice(0, 200) || null,
+        rel: $el.attr('rel') || null,
+        onDomain: 1
+      };
+      if (wantNav) {
+        seenNav.add(resolved.url);
+        navigation.push(link);
+      }
+      if (wantArticle) {
+        seenArticles.add(resolved.url);
+        articles.push(wantNav ? { ...link } : link);
+      }
+    };
+
+    // Document order within each group; nodes in both groups are visited once
+    for (const el of navElements) visit(el);
+    for (const el of articleElements) {
+      if (!navElements.has(el)) visit(el);
+    }
+    return { navigation, articles };
+  }
+
+  getStats() {
+    const lookups = this._stats.resolved + this._stats.memoHits;
+    return {
+      anchors: this._stats.anchors,
+      resolved: this._stats.resolved,
+      memoHits: this._stats.memoHits,
+      memoHitRate: lookups ? Number((this._stats.memoHits / lookups).toFixed(3)) : null,
+      memoSize: this._memo.size
+    };
+  }
+
+  /**
+   * Forget memoized hrefs (e.g. when the crawl's base URL changes).
+   */
+  reset() {
+    this._memo.clear();
+  }
+}
+
+module.exports = { LinkClassifier, NAV_SELECTORS, ARTICLE_SELECTORS };
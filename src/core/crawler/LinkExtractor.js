@@ -1,7 +1,7 @@
 'use strict';
 
 const cheerio = require('cheerio');
-const Links = require('./links');
+const { LinkClassifier } = require('./LinkClassifier');
 
 class LinkExtractor {
   constructor(options = {}) {
@@ -18,20 +18,26 @@ class LinkExtractor {
     this.normalizeUrl = normalizeUrl;
     this.isOnDomain = isOnDomain;
     this.looksLikeArticle = looksLikeArticle;
+    // Built once per crawler; memoizes href normalization across pages
+    this.classifier = new LinkClassifier({
+      normalizeUrl: (u) => this.normalizeUrl(u),
+      isOnDomain: (u) => this.isOnDomain(u),
+      looksLikeArticle: (u) => this.looksLikeArticle(u),
+      memoLimit: options.memoLimit
+    });
   }
 
   extract(htmlOrCheerio, options = {}) {
     const $ = this._ensureCheerio(htmlOrCheerio);
     const { isCountryHubPage = false, totalPrioritisationMode = false } = options;
 
-    const navigationLinks = Links
-      .findNavigationLinks($, (u) => this.normalizeUrl(u), (u) => this.isOnDomain(u))
-      .filter((link) => link && link.onDomain);
+    const classified = this.classifier.classify($);
+    const navigationLinks = classified.navigation;
 
     let articleLinks = [];
     if (!totalPrioritisationMode || !isCountryHubPage) {
       // Normal behavior: extract article links
-      articleLinks = Links.findArticleLinks($, (u) => this.normalizeUrl(u), (u) => this.looksLikeArticle(u), (u) => this.isOnDomain(u));
+      articleLinks = classified.articles;
     } else {
       // Total prioritisation mode on country hub pages: only extract pagination links
       articleLinks = this._extractPaginationLinksOnly($, navigationLinks);
@@ -67,8 +73,9 @@ class LinkExtractor {
       const href = $(el).attr('href');
       if (!href) return;
 
-      const normalized = this.normalizeUrl(href);
-      if (!normalized || !this.isOnDomain(normalized)) return;
+      const resolved = this.classifier.resolve(href);
+      if (!resolved || !resolved.onDomain) return;
+      const normalized = resolved.url;
 
       // Avoid duplicates
       if (!paginationLinks.some(link => link.url === normalized)) {
@@ -113,6 +120,10 @@ class LinkExtractor {
     }
   }
 
+  getStats() {
+    return this.classifier.getStats();
+  }
+
   _combineWithType(navigationLinks, articleLinks) {
     const merged = [];
     if (Array.isArray(navigationLinks)) {
@@ -31,7 +31,8 @@ class NavigationDiscoveryService {
     depth = 0,
     normalizedUrl = null,
     isCountryHubPage = false,
-    totalPrioritisationMode = false
+    totalPrioritisationMode = false,
+    parsedDocument = null
   } = {}) {
     if (!url) {
       throw new Error('NavigationDiscoveryService.discover requires a url');
@@ -40,7 +41,7 @@ class NavigationDiscoveryService {
       throw new Error('NavigationDiscoveryService.discover requires html as a string');
     }
 
-    const $ = cheerio.load(html);
+    const $ = parsedDocument && parsedDocument.html === html ? parsedDocument.$ : cheerio.load(html);
     const linkSummary = this.linkExtractor.extract($, { isCountryHubPage, totalPrioritisationMode }) || {};
     const navigationLinks = Array.isArray(linkSummary.navigation) ? linkSummary.navigation : [];
     const articleLinks = Array.isArray(linkSummary.articles) ? linkSummary.articles : [];
@@ -1,7 +1,7 @@
 const fetch = (...args) => import('node-fetch').then(({
   default: fetch
 }) => fetch(...args));
-const robotsParser = require('robots-parser');
+const { getSharedRobotsRules } = require('./RobotsRules');
 const fs = require('fs').promises;
 const path = require('path');
 const { tof, is_array } = require('lang-tools');
@@ -94,6 +94,7 @@ const {
 } = require('./cli/progressReporter');
 const Crawler = require('./core/Crawler');
 const { wireCrawlerServices } = require('./CrawlerServiceWiring');
+const { WriteBehindBuffer } = require('./WriteBehindBuffer');
 const { buildProgressDetail } = require('./progressDetail');
 
 const log = createCliLogger();
@@ -228,6 +229,7 @@ const crawlerOptionsSchema = {
   useSitemap: { type: 'boolean', default: true },
   sitemapOnly: { type: 'boolean', default: false },
   sitemapMaxUrls: { type: 'number', default: 5000, processor: (val) => Math.max(0, val) },
+  sitemapLastmodSince: { type: 'string', default: null }, // ISO date; older sitemap entries are skipped while streaming
   hubMaxPages: { type: 'number', default: undefined },
   hubMaxDays: { type: 'number', default: undefined },
   intMaxSeeds: { type: 'number', default: 50 },
@@ -251,7 +253,27 @@ const crawlerOptionsSchema = {
   loggingNetwork: { type: 'boolean', default: true },
   loggingFetching: { type: 'boolean', default: true },
   progressJson: { type: 'boolean', default: false },
-  prettyOutput: { type: 'boolean', default: false }
+  prettyOutput: { type: 'boolean', default: false },
+  analysisWorkers: { type: 'number', default: 0, processor: (val) => Math.max(0, Math.floor(val)) },
+  analysisMaxPending: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  frontierSpillDir: { type: 'string', default: null },
+  frontierHotCapacity: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  frontierMaxSpilled: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  connectionPooling: { type: 'boolean', default: true },
+  maxSocketsPerHost: { type: 'number', default: 6, processor: (val) => Math.max(1, Math.floor(val)) },
+  connectionIdleTimeoutMs: { type: 'number', default: 30000, validator: (val) => val > 0 },
+  http2: { type: 'boolean', default: false },
+  streamBody: { type: 'boolean', default: true },
+  capBodyBytes: { type: 'boolean', default: false },
+  maxArticleBodyBytes: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  maxHubBodyBytes: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  writeBehind: { type: 'boolean', default: true },
+  writeBehindIntervalMs: { type: 'number', default: 250, validator: (val) => val > 0 },
+  writeBehindMaxRows: { type: 'number', default: 500, processor: (val) => Math.max(1, Math.floor(val)) },
+  seenUrlFilter: { type: 'string', default: 'off' },
+  seenUrlFilterCapacity: { type: 'number', default: 1000000, processor: (val) => Math.max(1000, Math.floor(val)) },
+  latencyHistograms: { type: 'boolean', default: true },
+  latencyHistogramHosts: { type: 'number', default: undefined, processor: (val) => Math.max(0, Math.floor(val)) }
 };
 
 class NewsCrawler extends Crawler {
@@ -310,6 +332,7 @@ class NewsCrawler extends Crawler {
     this.useSitemap = opts.useSitemap;
     this.sitemapOnly = opts.sitemapOnly;
     this.sitemapMaxUrls = opts.sitemapMaxUrls;
+    this.sitemapLastmodSince = opts.sitemapLastmodSince;
     // Coarse lifecycle phase surfaced to the crawl-status UI so a running
     // crawl is legible ('preparing' -> a startup stage id like 'sitemaps'
     // -> 'crawling'). Updated in _trackStartupStage and _markStartupComplete.
@@ -331,6 +354,7 @@ class NewsCrawler extends Crawler {
     this.startUrlNormalized = null;
     this.isProcessing = false;
     this.dbAdapter = null;
+    this.writeBehind = null;
     this.exitSummary = null;
     if (this.loggingQueue === false) {
       console.log('NewsCrawler: Queue logging disabled');
@@ -738,6 +762,31 @@ class NewsCrawler extends Crawler {
       });
     }
 
+    // Close pooled keep-alive sockets and HTTP/2 sessions
+    if (this.connectionManager) {
+      try {
+        this.connectionManager.destroy();
+      } catch (err) {
+        console.error('Error closing connection pools:', err);
+      }
+    }
+
+    // Flush spilled frontier segments so they survive a restart
+    if (this.queue && typeof this.queue.close === 'function') {
+      try {
+        this.queue.close();
+      } catch (err) {
+        console.error('Error flushing frontier:', err);
+      }
+    }
+
+    // Stop analysis worker threads (fire-and-forget, like Puppeteer above)
+    if (this.analysisPool) {
+      this.analysisPool.shutdown().catch(err => {
+        console.error('Error stopping analysis workers:', err);
+      });
+    }
+
     // Cleanup enhanced features (timers, observers)
     try {
       this._cleanupEnhancedFeatures();
@@ -746,6 +795,38 @@ class NewsCrawler extends Crawler {
     }
   }
 
+  /**
+   * Route per-page fetch/link/article/HTTP-response writes through a
+   * WriteBehindBuffer so they commit in one transaction per batch instead of
+   * one autocommit each. Only applies when the adapter exposes a raw handle
+   * that supports transactions.
+   */
+  _enableWriteBehind() {
+    const opts = this._resolvedOptions || {};
+    if (opts.writeBehind === false || !this.dbAdapter || this.writeBehind) return;
+    const buffer = new WriteBehindBuffer({
+      target: this.dbAdapter,
+      flushIntervalMs: opts.writeBehindIntervalMs,
+      maxRows: opts.writeBehindMaxRows
+    });
+    if (!buffer.transactional) {
+      buffer.close();
+      return;
+    }
+    buffer.on('write-failed', ({ method, url, error }) => {
+      log.warn(`[write-behind] ${method} failed${url ? ` for ${url}` : ''}: ${error?.message || error}`);
+    });
+    this.writeBehind = buffer;
+    this.dbAdapter = buffer.wrap();
+  }
+
+  /**
+   * Commit buffered DB writes now. Use as a CheckpointManager save barrier.
+   */
+  flushPendingWrites(reason = 'barrier') {
+    return this.writeBehind ? this.writeBehind.flush(reason) : { rows: 0, durationMs: 0, failed: 0 };
+  }
+
   async init() {
     await this._trackStartupStage('prepare-data', 'Preparing data directory', async () => {
       await fs.mkdir(this.dataDir, {
@@ -828,6 +909,22 @@ class NewsCrawler extends Crawler {
           });
         }
 
+        this._enableWriteBehind();
+
+        if (this.urlEligibilityService?.seenFilter) {
+          await this._trackStartupStage('seen-filter', 'Warming seen-URL filter', async () => {
+            const added = this.urlEligibilityService.warmSeenFilter({ host: this.domain });
+            const stats = this.urlEligibilityService.getSeenFilterStats();
+            if (stats?.warmTruncated) {
+              return { status: 'skipped', message: `More than ${added} stored URLs; using database lookups` };
+            }
+            if (!stats?.ready) {
+              return { status: 'skipped', message: 'Seen-URL tables unavailable; using database lookups' };
+            }
+            return { status: 'completed', message: `${added} stored URLs (${stats.kind}, ${Math.round(stats.bytes / 1024)} KiB)` };
+          });
+        }
+
         if (this.isGazetteerMode) {
           await this._trackStartupStage('db-gazetteer-schema', 'Ensuring gazetteer schema ready', async () => {
             try {
@@ -955,12 +1052,15 @@ class NewsCrawler extends Crawler {
     let robotsInfo = null;
     try { sitemapInfo = this.robotsCoordinator?.getSitemapInfo?.() || null; } catch (_) { /* best-effort */ }
     try { robotsInfo = this.robotsCoordinator?.getRobotsInfo?.() || null; } catch (_) { /* best-effort */ }
+    let seenFilter = null;
+    try { seenFilter = this.urlEligibilityService?.getSeenFilterStats?.() || null; } catch (_) { /* best-effort */ }
     return buildProgressDetail({
       phase: this._phase,
       sitemapInfo,
       currentDownloads: this.state?.currentDownloads || null,
       domainLimits: this.state?.domainLimits || null,
-      robotsInfo
+      robotsInfo,
+      seenFilter
     });
   }
 
@@ -2192,6 +2292,18 @@ class NewsCrawler extends Crawler {
       adapter.dispose();
     }
 
+    if (this.writeBehind) {
+      try {
+        this.writeBehind.close();
+        const wb = this.writeBehind.getStats();
+        if (wb.flushes > 0) {
+          log.info(`[write-behind] ${wb.rowsFlushed} rows in ${wb.flushes} transactions (avg ${wb.avgRowsPerFlush}/batch, flush avg ${wb.avgFlushMs}ms max ${wb.maxFlushMs}ms, peak queue ${wb.maxQueueDepth}, failed ${wb.failedWrites})`);
+        }
+      } catch (err) {
+        log.warn(`[write-behind] Error flushing pending writes: ${err.message}`);
+      }
+    }
+
     if (this.dbAdapter && this.dbAdapter.isEnabled()) {
       const count = this.dbAdapter.getArticleCount();
       log.stat('Database articles', count);
@@ -2207,6 +2319,57 @@ class NewsCrawler extends Crawler {
       }
     }
 
+    if (this.connectionManager) {
+      try {
+        const t = this.connectionManager.getStats();
+        if (t.requests > 0) {
+          log.info(`[connections] ${t.requests} requests, ${t.handshakes} handshakes, ${t.reusedRequests} reused across ${t.origins} origins`);
+        }
+        this.connectionManager.destroy();
+      } catch (err) {
+        log.warn(`[connections] Error closing pools: ${err.message}`);
+      }
+    }
+
+    if (this.stageHistograms) {
+      try {
+        const { stages } = this.stageHistograms.snapshot({ hosts: false });
+        const parts = Object.entries(stages)
+          .filter(([, summary]) => summary.count > 0)
+          .map(([stage, summary]) => `${stage} p50=${summary.p50}ms p99=${summary.p99}ms`);
+        if (parts.length > 0) {
+          log.info(`[latency] ${parts.join(', ')}`);
+        }
+      } catch (err) {
+        log.warn(`[latency] Error summarising stage histograms: ${err.message}`);
+      }
+    }
+
+    if (this.robotsCoordinator) {
+      try {
+        const stats = getSharedRobotsRules().getStats();
+        if (stats.evaluations > 0) {
+          log.info(`[robots] rules cache hitRate=${(stats.hitRate * 100).toFixed(1)}% entries=${stats.entries} evaluations=${stats.evaluations} avgEval=${stats.avgEvalNs ?? '-'}ns`);
+        }
+      } catch (_) {}
+    }
+
+    if (this.queue && typeof this.queue.close === 'function') {
+      try {
+        this.queue.close();
+      } catch (err) {
+        log.warn(`[frontier] Error flushing spill store: ${err.message}`);
+      }
+    }
+
+    if (this.analysisPool) {
+      try {
+        await this.analysisPool.shutdown();
+      } catch (err) {
+        log.warn(`[analysis] Error stopping workers: ${err.message}`);
+      }
+    }
+
     if (includeCleanup) {
       this._cleanupEnhancedFeatures();
     }
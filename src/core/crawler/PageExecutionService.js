@@ -1,6 +1,8 @@
 const cheerio = require('cheerio');
 const chalk = require('chalk');
 const { isTotalPrioritisationEnabled } = require('../../shared/utils/priorityConfig');
+const { ParsedDocument } = require('../../shared/utils/ParsedDocument');
+const { hostOf } = require('./telemetry/TelemetryRingBuffer');
 const {
   normalizeOutputVerbosity,
   DEFAULT_OUTPUT_VERBOSITY,
@@ -25,6 +27,7 @@ class PageExecutionService {
     normalizeUrl,
     looksLikeArticle,
     noteDepthVisit,
+    noteProcessed,
     emitProgress,
     getDbAdapter,
     computeContentSignals,
@@ -40,7 +43,8 @@ class PageExecutionService {
     paginationPredictorService = null,
     placeHubPatternLearningService = null,
     emitPageEvent = null,
-    getLimiterSnapshot = null
+    getLimiterSnapshot = null,
+    stageHistograms = null
   } = {}) {
     if (!fetchPipeline) {
       throw new Error('PageExecutionService requires a fetch pipeline');
@@ -73,10 +77,12 @@ class PageExecutionService {
     this.adaptiveSeedPlanner = adaptiveSeedPlanner || null;
     this.enqueueRequest = enqueueRequest;
     this.telemetry = telemetry || null;
+    this.stageHistograms = stageHistograms || null;
     this.recordError = typeof recordError === 'function' ? recordError : null;
     this.normalizeUrl = typeof normalizeUrl === 'function' ? normalizeUrl : null;
     this.looksLikeArticle = typeof looksLikeArticle === 'function' ? looksLikeArticle : null;
     this.noteDepthVisit = typeof noteDepthVisit === 'function' ? noteDepthVisit : null;
+    this.noteProcessed = typeof noteProcessed === 'function' ? noteProcessed : null;
     this.emitProgress = typeof emitProgress === 'function' ? emitProgress : null;
     this.getDbAdapter = typeof getDbAdapter === 'function' ? getDbAdapter : () => null;
     this.computeContentSignals = typeof computeContentSignals === 'function' ? computeContentSignals : null;
@@ -307,6 +313,37 @@ class PageExecutionService {
       };
     }
 
+    if (source === 'stream-aborted') {
+      // Fetched but dropped mid-body (binary, duplicate canonical, policy):
+      // mark visited so rediscovered links do not download it again.
+      if (normalizedUrl) {
+        try {
+          this.state.addVisited(normalizedUrl);
+          if (this.noteDepthVisit) this.noteDepthVisit(normalizedUrl, depth);
+        } catch (_) {}
+      }
+      try {
+        if (fetchMeta?.bytesDownloaded != null) {
+          this.state.incrementBytesDownloaded(fetchMeta.bytesDownloaded);
+        }
+      } catch (_) {}
+      this._emitPageLog({
+        url: resolvedUrl,
+        normalizedUrl,
+        source,
+        status: 'skipped',
+        fetchMeta,
+        cacheInfo,
+        depth,
+        error: meta.reason || null
+      });
+      return {
+        status: 'skipped',
+        reason: meta.reason || 'stream-aborted',
+        retriable: false
+      };
+    }
+
     if (source === 'error') {
       const httpStatus = meta?.error?.httpStatus;
       const isNotFound = httpStatus === 404 || httpStatus === 410;
@@ -377,316 +414,343 @@ class PageExecutionService {
     const totalPrioritisationMode = this._isTotalPrioritisationEnabled();
     const sourcePlaceHubMeta = this._buildSourcePlaceHubMeta(resolvedUrl, normalizedUrl);
 
-    let discovery = null;
-    try {
-      discovery = this.navigationDiscoveryService?.discover({
-        url: resolvedUrl,
-        html,
-        depth,
-        normalizedUrl,
-        isCountryHubPage,
-        totalPrioritisationMode
-      }) || null;
-    } catch (error) {
-      if (this.recordError) {
-        this.recordError({
-          url: resolvedUrl,
-          kind: 'navigation-discovery',
-          message: error?.message || String(error)
-        });
-      }
-      if (this.telemetry) {
-        try {
-          this.telemetry.problem({
-            kind: 'navigation-discovery-failed',
-            target: resolvedUrl,
-            message: error?.message || 'Navigation discovery failed'
-          });
-        } catch (_) {}
-      }
-      discovery = null;
-    }
-
-    const dbAdapter = this.getDbAdapter();
-    const dbEnabled = dbAdapter && typeof dbAdapter.isEnabled === 'function' && dbAdapter.isEnabled();
-
-  const shouldAcquireContent = !!this.contentAcquisitionService && !this.structureOnly;
-
-    // P2 diagnostic: log when content acquisition is skipped
-    if (!shouldAcquireContent && !this._structureOnlyWarned) {
-      this._structureOnlyWarned = true;
-      const reason = !this.contentAcquisitionService ? 'no contentAcquisitionService' : 'structureOnly mode';
-      console.log(`[PageExecutionService] Content acquisition SKIPPED (${reason}) — no article content will be stored this run`);
-    }
-    if (shouldAcquireContent && !dbEnabled) {
-      // Log once if DB is not enabled but content acquisition is attempted
-      if (!this._dbDisabledWarned) {
-        this._dbDisabledWarned = true;
-        console.log(`[PageExecutionService] Content acquisition active but DB not enabled — articles found but not persisted. ` +
-          `adapter=${dbAdapter ? 'present' : 'null'}, isEnabled=${typeof dbAdapter?.isEnabled === 'function' ? dbAdapter.isEnabled() : 'N/A'}`);
-      }
-    }
+    // One parse handle for the rest of this page: discovery builds the cheerio
+    // tree, content acquisition reuses it and only builds JSDOM for Readability.
+    const parsedDocument = typeof html === 'string'
+      ? new ParsedDocument({ html, url: resolvedUrl })
+      : null;
 
-    let processorResult = null;
-    if (shouldAcquireContent) {
+    // Disposed on every exit, including thrown errors, so the DOM never leaks
+    try {
+      let discovery = null;
+      // Discovery builds the cheerio tree, so this doubles as the parse stage
+      const parseStart = this.stageHistograms ? process.hrtime.bigint() : null;
       try {
-        processorResult = await this.contentAcquisitionService.acquire({
+        discovery = this.navigationDiscoveryService?.discover({
           url: resolvedUrl,
           html,
-          fetchMeta,
           depth,
           normalizedUrl,
-          referrerUrl: context.referrerUrl || null,
-          discoveredAt: context.discoveredAt || new Date().toISOString(),
-          persistArticle: dbEnabled && !this.structureOnly,
-          insertFetchRecord: dbEnabled,
-          insertLinkRecords: dbEnabled,
-          linkSummary: discovery?.linkSummary || null,
-          cheerioRoot: discovery?.$ || null
-        });
-
-        if (processorResult) {
-          const analysisType = this._analyzePageType(resolvedUrl, processorResult);
-          console.log(chalk.blue(`ANALYSIS: ${resolvedUrl} -> ${analysisType}`));
+          isCountryHubPage,
+          totalPrioritisationMode,
+          parsedDocument
+        }) || null;
+        if (parseStart !== null) {
+          this.stageHistograms.since('parseHtml', hostOf(resolvedUrl), parseStart);
         }
       } catch (error) {
         if (this.recordError) {
           this.recordError({
             url: resolvedUrl,
-            kind: 'content-acquisition',
+            kind: 'navigation-discovery',
             message: error?.message || String(error)
           });
         }
         if (this.telemetry) {
           try {
             this.telemetry.problem({
-              kind: 'content-acquisition-failed',
+              kind: 'navigation-discovery-failed',
               target: resolvedUrl,
-              message: error?.message || 'Content acquisition failed'
+              message: error?.message || 'Navigation discovery failed'
             });
           } catch (_) {}
         }
-        this._emitPageLog({
-          url: resolvedUrl,
-          normalizedUrl,
-          source,
-          status: 'failed',
-          fetchMeta,
-          cacheInfo,
-          depth,
-          error
-        });
-        return {
-          status: 'failed',
-          retriable: false
-        };
+        discovery = null;
       }
-    } else {
-      processorResult = {
-        isArticle: !!(discovery?.looksLikeArticle),
-        metadata: null,
-        navigationLinks: Array.isArray(discovery?.navigationLinks) ? discovery.navigationLinks : [],
-        articleLinks: Array.isArray(discovery?.articleLinks) ? discovery.articleLinks : [],
-        allLinks: Array.isArray(discovery?.allLinks) ? discovery.allLinks : [],
-        statsDelta: { articlesFound: 0, articlesSaved: 0 }
-      };
-    }
 
-    if (processorResult?.statsDelta) {
-      const foundDelta = processorResult.statsDelta.articlesFound || 0;
-      const savedDelta = processorResult.statsDelta.articlesSaved || 0;
-      try {
-        if (foundDelta) this.state.incrementArticlesFound(foundDelta);
-        if (savedDelta) this.state.incrementArticlesSaved(savedDelta);
-      } catch (_) {}
-    }
+      const dbAdapter = this.getDbAdapter();
+      const dbEnabled = dbAdapter && typeof dbAdapter.isEnabled === 'function' && dbAdapter.isEnabled();
 
-    const discoveryNavigationLinks = Array.isArray(discovery?.navigationLinks) ? discovery.navigationLinks : null;
-    const discoveryArticleLinks = Array.isArray(discovery?.articleLinks) ? discovery.articleLinks : null;
-    const discoveryAllLinks = Array.isArray(discovery?.allLinks) ? discovery.allLinks : null;
+      const shouldAcquireContent = !!this.contentAcquisitionService && !this.structureOnly;
 
-    let navigationLinks = processorResult?.navigationLinks || [];
-    if (discoveryNavigationLinks && discoveryNavigationLinks.length > 0) {
-      navigationLinks = discoveryNavigationLinks;
-    }
+      // P2 diagnostic: log when content acquisition is skipped
+      if (!shouldAcquireContent && !this._structureOnlyWarned) {
+        this._structureOnlyWarned = true;
+        const reason = !this.contentAcquisitionService ? 'no contentAcquisitionService' : 'structureOnly mode';
+        console.log(`[PageExecutionService] Content acquisition SKIPPED (${reason}) — no article content will be stored this run`);
+      }
+      if (shouldAcquireContent && !dbEnabled) {
+        // Log once if DB is not enabled but content acquisition is attempted
+        if (!this._dbDisabledWarned) {
+          this._dbDisabledWarned = true;
+          console.log(`[PageExecutionService] Content acquisition active but DB not enabled — articles found but not persisted. ` +
+            `adapter=${dbAdapter ? 'present' : 'null'}, isEnabled=${typeof dbAdapter?.isEnabled === 'function' ? dbAdapter.isEnabled() : 'N/A'}`);
+        }
+      }
 
-    let articleLinks = processorResult?.articleLinks || [];
-    if (discoveryArticleLinks && discoveryArticleLinks.length > 0) {
-      articleLinks = discoveryArticleLinks;
-    }
+      let processorResult = null;
+      if (shouldAcquireContent) {
+        try {
+          processorResult = await this.contentAcquisitionService.acquire({
+            url: resolvedUrl,
+            html,
+            fetchMeta,
+            depth,
+            normalizedUrl,
+            referrerUrl: context.referrerUrl || null,
+            discoveredAt: context.discoveredAt || new Date().toISOString(),
+            // A capped body is a prefix of the page: good for links, not for storage
+            persistArticle: dbEnabled && !this.structureOnly && !fetchMeta?.bodyTruncated,
+            insertFetchRecord: dbEnabled,
+            insertLinkRecords: dbEnabled,
+            linkSummary: discovery?.linkSummary || null,
+            cheerioRoot: discovery?.$ || null,
+            parsedDocument
+          });
 
-    if (this.structureOnly) {
-      try {
-        if (!discovery?.looksLikeArticle) {
-          this.state?.incrementStructureNavPages?.();
+          if (processorResult) {
+            const analysisType = this._analyzePageType(resolvedUrl, processorResult);
+            console.log(chalk.blue(`ANALYSIS: ${resolvedUrl} -> ${analysisType}`));
+          }
+        } catch (error) {
+          if (this.recordError) {
+            this.recordError({
+              url: resolvedUrl,
+              kind: 'content-acquisition',
+              message: error?.message || String(error)
+            });
+          }
+          if (this.telemetry) {
+            try {
+              this.telemetry.problem({
+                kind: 'content-acquisition-failed',
+                target: resolvedUrl,
+                message: error?.message || 'Content acquisition failed'
+              });
+            } catch (_) {}
+          }
+          this._emitPageLog({
+            url: resolvedUrl,
+            normalizedUrl,
+            source,
+            status: 'failed',
+            fetchMeta,
+            cacheInfo,
+            depth,
+            error,
+            parseStats: parsedDocument ? parsedDocument.getStats() : null
+          });
+          return {
+            status: 'failed',
+            retriable: false
+          };
         }
-        if (articleLinks.length > 0) {
-          this.state?.recordStructureArticleLinks?.(articleLinks);
+      } else {
+        processorResult = {
+          isArticle: !!(discovery?.looksLikeArticle),
+          metadata: null,
+          navigationLinks: Array.isArray(discovery?.navigationLinks) ? discovery.navigationLinks : [],
+          articleLinks: Array.isArray(discovery?.articleLinks) ? discovery.articleLinks : [],
+          allLinks: Array.isArray(discovery?.allLinks) ? discovery.allLinks : [],
+          statsDelta: { articlesFound: 0, articlesSaved: 0 }
+        };
+      }
+
+      if (processorResult?.statsDelta) {
+        const foundDelta = processorResult.statsDelta.articlesFound || 0;
+        const savedDelta = processorResult.statsDelta.articlesSaved || 0;
+        try {
+          if (foundDelta) this.state.incrementArticlesFound(foundDelta);
+          if (savedDelta) this.state.incrementArticlesSaved(savedDelta);
+        } catch (_) {}
+        // Stored content makes the URL "processed" for later eligibility checks
+        if ((savedDelta || processorResult.statsDelta.hubsSaved) && this.noteProcessed) {
+          try { this.noteProcessed(normalizedUrl); } catch (_) {}
         }
-      } catch (_) {}
-    }
+      }
 
-    // Suppress noisy per-page link summaries in favor of concise PAGE logs
+      const discoveryNavigationLinks = Array.isArray(discovery?.navigationLinks) ? discovery.navigationLinks : null;
+      const discoveryArticleLinks = Array.isArray(discovery?.articleLinks) ? discovery.articleLinks : null;
+      const discoveryAllLinks = Array.isArray(discovery?.allLinks) ? discovery.allLinks : null;
 
-    if (!this.structureOnly && processorResult?.isArticle && processorResult.metadata) {
-      try {
-        this.adaptiveSeedPlanner?.seedFromArticle({
-          url: resolvedUrl,
-          metadata: processorResult.metadata,
-          depth
-        });
-      } catch (_) {}
-    }
+      let navigationLinks = processorResult?.navigationLinks || [];
+      if (discoveryNavigationLinks && discoveryNavigationLinks.length > 0) {
+        navigationLinks = discoveryNavigationLinks;
+      }
 
-    if (this.milestoneTracker) {
-      this.milestoneTracker.checkAnalysisMilestones({
-        depth,
-        isArticle: !!processorResult?.isArticle
-      });
-    }
+      let articleLinks = processorResult?.articleLinks || [];
+      if (discoveryArticleLinks && discoveryArticleLinks.length > 0) {
+        articleLinks = discoveryArticleLinks;
+      }
 
-    let allLinks = processorResult?.allLinks || [];
-    if (discoveryAllLinks && discoveryAllLinks.length > 0) {
-      allLinks = discoveryAllLinks;
-    }
+      if (this.structureOnly) {
+        try {
+          if (!discovery?.looksLikeArticle) {
+            this.state?.incrementStructureNavPages?.();
+          }
+          if (articleLinks.length > 0) {
+            this.state?.recordStructureArticleLinks?.(articleLinks);
+          }
+        } catch (_) {}
+      }
 
-    // Phase 1: Record page visit for pagination prediction
-    if (this.paginationPredictorService && allLinks.length > 0) {
-      try {
-        const linkUrls = allLinks
-          .filter(l => l && l.url)
-          .map(l => l.url);
-        this.paginationPredictorService.recordVisit(resolvedUrl, {
-          hasContent: !!(processorResult?.isArticle || allLinks.length > 5),
-          links: linkUrls
-        });
-      } catch (_) {}
-    }
+      // Suppress noisy per-page link summaries in favor of concise PAGE logs
 
-    if (this.hubOnlyMode && isCountryHubPage && typeof this.state?.recordCountryHubLinks === 'function') {
-      const summary = this._collectCountryHubLinkSummary(allLinks);
-      if (summary.articleUrls.length > 0 || summary.paginationUrls.length > 0) {
+      if (!this.structureOnly && processorResult?.isArticle && processorResult.metadata) {
         try {
-          this.state.recordCountryHubLinks(normalizedUrl, {
-            ...summary,
-            sourceUrl: resolvedUrl
+          this.adaptiveSeedPlanner?.seedFromArticle({
+            url: resolvedUrl,
+            metadata: processorResult.metadata,
+            depth
           });
         } catch (_) {}
       }
-    }
 
-    const seen = new Set();
-    const runtimeLatestStoryCandidates = [];
-    for (const link of allLinks) {
-      if (!link || !link.url) continue;
-      if (seen.has(link.url)) continue;
-      seen.add(link.url);
-
-      // In country hub exclusive mode, only process links from country hub pages
-      const isCountryHubPage = this._isCountryHubPage(resolvedUrl);
-      if (this.hubOnlyMode && !isCountryHubPage) {
-        continue; // Skip all links from non-country-hub pages
+      if (this.milestoneTracker) {
+        this.milestoneTracker.checkAnalysisMilestones({
+          depth,
+          isArticle: !!processorResult?.isArticle
+        });
       }
 
-      if (this.hubOnlyMode && link.type === 'article') {
-        continue; // Skip article links even from country hubs
+      let allLinks = processorResult?.allLinks || [];
+      if (discoveryAllLinks && discoveryAllLinks.length > 0) {
+        allLinks = discoveryAllLinks;
       }
 
-      try {
-        let linkMeta = isCountryHubPage ? { sourceHub: resolvedUrl, sourceHubType: 'country' } : null;
-        if (sourcePlaceHubMeta && link.type === 'article') {
-          linkMeta = {
-            ...linkMeta,
-            ...sourcePlaceHubMeta,
-            runtimeLatestStoryCandidate: true,
-            latestStoryEvidenceSource: 'runtime-place-hub-link'
-          };
-          runtimeLatestStoryCandidates.push({
-            url: link.url,
-            type: link.type || 'article',
-            sourcePlaceHub: linkMeta.sourcePlaceHub || null,
-            sourcePlaceHubPatternType: linkMeta.sourcePlaceHubPatternType || null,
-            sourcePlaceHubPatternRegex: linkMeta.sourcePlaceHubPatternRegex || null,
-            sourcePlaceHubKind: linkMeta.sourcePlaceHubKind || null,
-            sourcePlaceHubConfidence: linkMeta.sourcePlaceHubConfidence ?? null,
-            latestStoryEvidenceSource: linkMeta.latestStoryEvidenceSource || null
+      // Phase 1: Record page visit for pagination prediction
+      if (this.paginationPredictorService && allLinks.length > 0) {
+        try {
+          const linkUrls = allLinks
+            .filter(l => l && l.url)
+            .map(l => l.url);
+          this.paginationPredictorService.recordVisit(resolvedUrl, {
+            hasContent: !!(processorResult?.isArticle || allLinks.length > 5),
+            links: linkUrls
           });
+        } catch (_) {}
+      }
+
+      if (this.hubOnlyMode && isCountryHubPage && typeof this.state?.recordCountryHubLinks === 'function') {
+        const summary = this._collectCountryHubLinkSummary(allLinks);
+        if (summary.articleUrls.length > 0 || summary.paginationUrls.length > 0) {
+          try {
+            this.state.recordCountryHubLinks(normalizedUrl, {
+              ...summary,
+              sourceUrl: resolvedUrl
+            });
+          } catch (_) {}
         }
+      }
 
-        if (this._isTotalPrioritisationEnabled()) {
-          const targetIsCountryHub = this._isCountryHubPage(link.url || '');
-          if (!targetIsCountryHub) {
-            continue;
-          }
+      const seen = new Set();
+      const runtimeLatestStoryCandidates = [];
+      for (const link of allLinks) {
+        if (!link || !link.url) continue;
+        if (seen.has(link.url)) continue;
+        seen.add(link.url);
+
+        // In country hub exclusive mode, only process links from country hub pages
+        const isCountryHubPage = this._isCountryHubPage(resolvedUrl);
+        if (this.hubOnlyMode && !isCountryHubPage) {
+          continue; // Skip all links from non-country-hub pages
         }
 
-        // Apply maximum priority bonus for country hub articles in total prioritisation mode
-        if (isCountryHubPage && this._isTotalPrioritisationEnabled()) {
-          linkMeta = {
-            ...linkMeta,
-            priorityBonus: 'country-hub-article-total',
-            forcePriority: 90  // Maximum priority for articles from country hubs
-          };
+        if (this.hubOnlyMode && link.type === 'article') {
+          continue; // Skip article links even from country hubs
         }
 
-        // Place hub pattern learning: predict if URL is a place hub
-        if (this.placeHubPatternLearningService && link.url) {
-          try {
-            const prediction = this.placeHubPatternLearningService.predictPlaceHub(link.url, this.domain);
-            if (prediction && prediction.isPlaceHub && prediction.confidence >= 0.4) {
-              linkMeta = {
-                ...linkMeta,
-                predictedPlaceHub: true,
-                placeHubConfidence: prediction.confidence,
-                placeHubKind: prediction.placeKind || null,
-                placeHubReason: prediction.reason
-              };
-              // Boost priority for predicted place hubs
-              if (!linkMeta.forcePriority || linkMeta.forcePriority < 70) {
-                linkMeta.forcePriority = 70 + Math.floor(prediction.confidence * 20);
+        try {
+          let linkMeta = isCountryHubPage ? { sourceHub: resolvedUrl, sourceHubType: 'country' } : null;
+          if (sourcePlaceHubMeta && link.type === 'article') {
+            linkMeta = {
+              ...linkMeta,
+              ...sourcePlaceHubMeta,
+              runtimeLatestStoryCandidate: true,
+              latestStoryEvidenceSource: 'runtime-place-hub-link'
+            };
+            runtimeLatestStoryCandidates.push({
+              url: link.url,
+              type: link.type || 'article',
+              sourcePlaceHub: linkMeta.sourcePlaceHub || null,
+              sourcePlaceHubPatternType: linkMeta.sourcePlaceHubPatternType || null,
+              sourcePlaceHubPatternRegex: linkMeta.sourcePlaceHubPatternRegex || null,
+              sourcePlaceHubKind: linkMeta.sourcePlaceHubKind || null,
+              sourcePlaceHubConfidence: linkMeta.sourcePlaceHubConfidence ?? null,
+              latestStoryEvidenceSource: linkMeta.latestStoryEvidenceSource || null
+            });
+          }
+
+          if (this._isTotalPrioritisationEnabled()) {
+            const targetIsCountryHub = this._isCountryHubPage(link.url || '');
+            if (!targetIsCountryHub) {
+              continue;
+            }
+          }
+
+          // Apply maximum priority bonus for country hub articles in total prioritisation mode
+          if (isCountryHubPage && this._isTotalPrioritisationEnabled()) {
+            linkMeta = {
+              ...linkMeta,
+              priorityBonus: 'country-hub-article-total',
+              forcePriority: 90  // Maximum priority for articles from country hubs
+            };
+          }
+
+          // Place hub pattern learning: predict if URL is a place hub
+          if (this.placeHubPatternLearningService && link.url) {
+            try {
+              const prediction = this.placeHubPatternLearningService.predictPlaceHub(link.url, this.domain);
+              if (prediction && prediction.isPlaceHub && prediction.confidence >= 0.4) {
+                linkMeta = {
+                  ...linkMeta,
+                  predictedPlaceHub: true,
+                  placeHubConfidence: prediction.confidence,
+                  placeHubKind: prediction.placeKind || null,
+                  placeHubReason: prediction.reason
+                };
+                // Boost priority for predicted place hubs
+                if (!linkMeta.forcePriority || linkMeta.forcePriority < 70) {
+                  linkMeta.forcePriority = 70 + Math.floor(prediction.confidence * 20);
+                }
               }
+            } catch (_) {
+              // Silently ignore prediction errors
             }
-          } catch (_) {
-            // Silently ignore prediction errors
           }
-        }
 
-        this.enqueueRequest({
-          url: link.url,
-          depth: depth + 1,
-          type: link.type || 'nav',
-          meta: linkMeta
-        });
-      } catch (_) {}
-    }
+          this.enqueueRequest({
+            url: link.url,
+            depth: depth + 1,
+            type: link.type || 'nav',
+            meta: linkMeta
+          });
+        } catch (_) {}
+      }
 
-    this._updateCountryHubProgress();
+      this._updateCountryHubProgress();
 
-    this._emitPageLog({
-      url: resolvedUrl,
-      normalizedUrl,
-      source,
-      status: 'success',
-      fetchMeta,
-      cacheInfo,
-      depth,
-      runtimeLatestStoryExtraction: sourcePlaceHubMeta
-        ? {
-          evidenceSource: 'runtime-page-log',
-          sourcePlaceHub: sourcePlaceHubMeta.sourcePlaceHub || normalizedUrl || resolvedUrl,
-          sourcePlaceHubPatternType: sourcePlaceHubMeta.sourcePlaceHubPatternType || null,
-          sourcePlaceHubPatternRegex: sourcePlaceHubMeta.sourcePlaceHubPatternRegex || null,
-          sourcePlaceHubKind: sourcePlaceHubMeta.sourcePlaceHubKind || null,
-          sourcePlaceHubConfidence: sourcePlaceHubMeta.sourcePlaceHubConfidence ?? null,
-          candidateCount: runtimeLatestStoryCandidates.length,
-          candidates: runtimeLatestStoryCandidates.slice(0, 25)
-        }
-        : null
-    });
+      const parseStats = parsedDocument ? parsedDocument.getStats() : null;
 
-    return {
-      status: 'success'
-    };
+      this._emitPageLog({
+        url: resolvedUrl,
+        normalizedUrl,
+        source,
+        status: 'success',
+        fetchMeta,
+        cacheInfo,
+        depth,
+        parseStats,
+        runtimeLatestStoryExtraction: sourcePlaceHubMeta
+          ? {
+            evidenceSource: 'runtime-page-log',
+            sourcePlaceHub: sourcePlaceHubMeta.sourcePlaceHub || normalizedUrl || resolvedUrl,
+            sourcePlaceHubPatternType: sourcePlaceHubMeta.sourcePlaceHubPatternType || null,
+            sourcePlaceHubPatternRegex: sourcePlaceHubMeta.sourcePlaceHubPatternRegex || null,
+            sourcePlaceHubKind: sourcePlaceHubMeta.sourcePlaceHubKind || null,
+            sourcePlaceHubConfidence: sourcePlaceHubMeta.sourcePlaceHubConfidence ?? null,
+            candidateCount: runtimeLatestStoryCandidates.length,
+            candidates: runtimeLatestStoryCandidates.slice(0, 25)
+          }
+          : null
+      });
+
+      return {
+        status: 'success'
+      };
+    } finally {
+      parsedDocument?.dispose();
+    }
   }
 
   _buildSourcePlaceHubMeta(resolvedUrl, normalizedUrl) {
@@ -901,7 +965,8 @@ class PageExecutionService {
     cacheInfo,
     depth,
     error,
-    runtimeLatestStoryExtraction = null
+    runtimeLatestStoryExtraction = null,
+    parseStats = null
   }) {
     try {
       const payload = {
@@ -920,6 +985,9 @@ class PageExecutionService {
         limiterSnapshot: this._buildLimiterSnapshot(normalizedUrl || url),
         runtimeLatestStoryExtraction: runtimeLatestStoryExtraction || null
       };
+      if (parseStats) {
+        payload.parse = parseStats;
+      }
       if (error) {
         payload.error = typeof error === 'string' ? error : (error.message || error.kind || null);
       }
@@ -939,7 +1007,8 @@ class PageExecutionService {
             cacheReason: payload.cacheReason,
             freshness: payload.freshness,
             limiterSnapshot: payload.limiterSnapshot,
-            runtimeLatestStoryExtraction: payload.runtimeLatestStoryExtraction
+            runtimeLatestStoryExtraction: payload.runtimeLatestStoryExtraction,
+            parsesAvoided: parseStats ? parseStats.parsesAvoided : null
           };
           this.emitPageEvent(pageEvent);
         } catch (_) {}
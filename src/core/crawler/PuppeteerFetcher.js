@@ -12,10 +12,18 @@
  * - Auto-restart after configurable page count or time
  * - Telemetry tracking for browser launch vs reuse
  * - Graceful degradation on browser failures
+ * - Per-domain warm pages via BrowserPoolManager.acquirePage()
+ * - Images, media, fonts and ad/tracker hosts blocked by default
  */
 
 const puppeteer = require('puppeteer');
 const EventEmitter = require('events');
+const {
+  BrowserPoolManager,
+  DEFAULT_PAGE_POOL_OPTIONS,
+  installResourceBlocking,
+  createBlockingStats
+} = require('./BrowserPoolManager');
 
 /**
  * Default Puppeteer launch options for stealth browsing
@@ -66,6 +74,10 @@ class PuppeteerFetcher extends EventEmitter {
    * @param {number} [opts.healthCheckIntervalMs=30000] - Health check interval
    * @param {boolean} [opts.restartOnError=true] - Auto-restart on consecutive errors
    * @param {number} [opts.maxConsecutiveErrors=3] - Max consecutive errors before restart
+   * @param {Object} [opts.browserPool] - Shared BrowserPoolManager (takes precedence over session reuse)
+   * @param {boolean|Object} [opts.pagePool=false] - Create an owned BrowserPoolManager (options object passed through)
+   * @param {boolean} [opts.blockResources=true] - Abort image/media/font and ad-host requests
+   * @param {string[]} [opts.blockedResourceTypes] - Puppeteer resource types to abort
    * @param {Object} [opts.logger] - Logger instance
    */
   constructor(opts = {}) {
@@ -74,10 +86,6 @@ class PuppeteerFetcher extends EventEmitter {
     this.navigationOptions = { ...DEFAULT_NAVIGATION_OPTIONS, ...opts.navigationOptions };
     this.logger = opts.logger || console;
     
-    // Browser pool support (optional - takes precedence over session reuse)
-    this._browserPool = opts.browserPool || null;
-    this._usePool = !!this._browserPool;
-    
     // Lifecycle options
     const lifecycle = { ...DEFAULT_LIFECYCLE_OPTIONS };
     this.reuseSession = opts.reuseSession !== undefined ? opts.reuseSession : lifecycle.reuseSession;
@@ -88,6 +96,27 @@ class PuppeteerFetcher extends EventEmitter {
     this.healthCheckIntervalMs = opts.healthCheckIntervalMs || lifecycle.healthCheckIntervalMs;
     this.restartOnError = opts.restartOnError !== undefined ? opts.restartOnError : lifecycle.restartOnError;
     this.maxConsecutiveErrors = opts.maxConsecutiveErrors || lifecycle.maxConsecutiveErrors;
+    this.blockResources = opts.blockResources !== undefined ? opts.blockResources : DEFAULT_PAGE_POOL_OPTIONS.blockResources;
+    this.blockedResourceTypes = opts.blockedResourceTypes || DEFAULT_PAGE_POOL_OPTIONS.blockedResourceTypes;
+    
+    // Browser pool support (optional - takes precedence over session reuse)
+    this._browserPool = opts.browserPool || null;
+    this._ownsPool = false;
+    if (!this._browserPool && opts.pagePool) {
+      this._browserPool = new BrowserPoolManager({
+        maxBrowsers: 1,
+        maxPagesPerBrowser: this.maxPagesPerSession,
+        maxConcurrentPagesPerBrowser: this.maxPages,
+        launchOptions: this.launchOptions,
+        healthCheckIntervalMs: this.healthCheckIntervalMs,
+        blockResources: this.blockResources,
+        blockedResourceTypes: this.blockedResourceTypes,
+        logger: this.logger,
+        ...(typeof opts.pagePool === 'object' ? opts.pagePool : {})
+      });
+      this._ownsPool = true;
+    }
+    this._usePool = !!this._browserPool;
     
     // Internal state
     this._browser = null;
@@ -111,6 +140,7 @@ class PuppeteerFetcher extends EventEmitter {
       autoRestarts: 0,
       errorRestarts: 0
     };
+    this._blocking = createBlockingStats();
   }
 
   /**
@@ -126,7 +156,9 @@ class PuppeteerFetcher extends EventEmitter {
         ageMs: this._sessionStartTime ? Date.now() - this._sessionStartTime : 0,
         activePages: this._activePages,
         consecutiveErrors: this._consecutiveErrors
-      }
+      },
+      blocking: { enabled: this.blockResources, ...this._blocking, blockedByType: { ...this._blocking.blockedByType } },
+      pool: this._usePool && typeof this._browserPool.getStats === 'function' ? this._browserPool.getStats() : null
     };
   }
 
@@ -135,6 +167,11 @@ class PuppeteerFetcher extends EventEmitter {
    * @returns {Promise<PuppeteerFetcher>}
    */
   async init() {
+    if (this._ownsPool) {
+      await this._browserPool.init();
+      return this;
+    }
+    if (this._usePool) return this;
     if (!this._browser) {
       await this._launchBrowser();
       this._startHealthCheck();
@@ -358,6 +395,7 @@ class PuppeteerFetcher extends EventEmitter {
     let ownsBrowser = false;
     let browserReused = false;
     let poolRelease = null;
+    let pageLease = null;
     let fetchError = null;
     
     try {
@@ -366,20 +404,33 @@ class PuppeteerFetcher extends EventEmitter {
         await new Promise(r => setTimeout(r, 100));
       }
       
-      // Get browser (reused, pooled, or new)
-      const browserResult = await this._getBrowser();
-      browser = browserResult.browser;
-      ownsBrowser = browserResult.ownsBrowser;
-      poolRelease = browserResult.poolRelease || null;
-      browserReused = !ownsBrowser && this._telemetry.browserReuses > 0;
-
-      page = await browser.newPage();
+      if (this._usePool && typeof this._browserPool.acquirePage === 'function') {
+        // Warm page from the domain's context; viewport and blocking already applied
+        pageLease = await this._browserPool.acquirePage(url);
+        page = pageLease.page;
+        browserReused = true;
+        this._telemetry.browserReuses++;
+      } else {
+        // Get browser (reused, pooled, or new)
+        const browserResult = await this._getBrowser();
+        browser = browserResult.browser;
+        ownsBrowser = browserResult.ownsBrowser;
+        poolRelease = browserResult.poolRelease || null;
+        browserReused = !ownsBrowser && this._telemetry.browserReuses > 0;
+
+        page = await browser.newPage();
+      }
       this._activePages++;
       this._sessionPageCount++;
       this._telemetry.pagesFetched++;
 
-      // Set viewport
-      await page.setViewport({ width: 1920, height: 1080 });
+      if (!pageLease) {
+        // Set viewport
+        await page.setViewport({ width: 1920, height: 1080 });
+        if (this.blockResources) {
+          await installResourceBlocking(page, { resourceTypes: this.blockedResourceTypes, stats: this._blocking });
+        }
+      }
 
       // Navigate
       const response = await page.goto(url, navOptions);
@@ -470,7 +521,11 @@ class PuppeteerFetcher extends EventEmitter {
     } finally {
       if (page) {
         this._activePages--;
-        try { await page.close(); } catch {}
+        if (pageLease) {
+          try { await pageLease.release(fetchError); } catch {}
+        } else {
+          try { await page.close(); } catch {}
+        }
       }
       if (ownsBrowser && browser) {
         try { await browser.close(); } catch {}
@@ -540,10 +595,13 @@ class PuppeteerFetcher extends EventEmitter {
   async destroy() {
     this._stopHealthCheck();
     await this._closeBrowser();
+    if (this._ownsPool) {
+      await this._browserPool.destroy();
+    }
     
     // Log final telemetry
     const t = this._telemetry;
-    this.logger.info(`[puppeteer] Session stats: launches=${t.browserLaunches} reuses=${t.browserReuses} pages=${t.pagesFetched} success=${t.fetchSuccesses} errors=${t.fetchErrors}`, { type: 'PUPPETEER' });
+    this.logger.info(`[puppeteer] Session stats: launches=${t.browserLaunches} reuses=${t.browserReuses} pages=${t.pagesFetched} success=${t.fetchSuccesses} errors=${t.fetchErrors} blocked=${this._blocking.blockedRequests}`, { type: 'PUPPETEER' });
     this.emit('browser:destroyed', { telemetry: this._telemetry });
   }
 }
@@ -2,6 +2,7 @@
 
 const { isTotalPrioritisationEnabled } = require('../../shared/utils/priorityConfig');
 const { safeCall, safeCallAsync } = require('./utils');
+const { HostShardedQueue } = require('./frontier/HostShardedQueue');
 
 function nowMs() { return Date.now(); }
 
@@ -74,6 +75,9 @@ class QueueManager {
     this.computeEnhancedPriority = opts.computeEnhancedPriority || (() => ({ priority: 0, prioritySource: 'base' }));
     this.jobIdProvider = opts.jobIdProvider || (() => null);
     this.onRateLimitDeferred = typeof opts.onRateLimitDeferred === 'function' ? opts.onRateLimitDeferred : null;
+    // Backpressure hook: returns null when pulling may proceed, or a promise
+    // to await first (e.g. the analysis worker pool is saturated).
+    this.pullGate = typeof opts.pullGate === 'function' ? opts.pullGate : null;
 
     this.isTotalPrioritisationEnabledFn = typeof opts.isTotalPrioritisationEnabled === 'function'
       ? opts.isTotalPrioritisationEnabled
@@ -82,10 +86,19 @@ class QueueManager {
     this.discoveryQueueType = 'discovery';
     this.acquisitionQueueType = 'acquisition';
 
+    // Priority mode shards each queue per host behind a ready-time heap so
+    // blocked hosts are skipped without popping their URLs; shardByHost:false
+    // restores the single heap with a bounded deferral scan.
+    this.shardByHost = this.usePriorityQueue && opts.shardByHost !== false;
+
     if (this.usePriorityQueue) {
+      const compare = (a, b) => a.priority - b.priority;
+      const createQueue = () => (this.shardByHost
+        ? new HostShardedQueue({ compare, hostOf: (item) => this.safeHostFromUrl(item.url) })
+        : new MinHeap(compare));
       this.priorityQueues = {
-        [this.discoveryQueueType]: new MinHeap((a, b) => a.priority - b.priority),
-        [this.acquisitionQueueType]: new MinHeap((a, b) => a.priority - b.priority)
+        [this.discoveryQueueType]: createQueue(),
+        [this.acquisitionQueueType]: createQueue()
       };
       this.fifoQueues = null;
     } else {
@@ -104,9 +117,38 @@ class QueueManager {
       [this.acquisitionQueueType]: 0
     };
     this._burstLimit = typeof opts.burstLimit === 'number' && opts.burstLimit > 0 ? Math.floor(opts.burstLimit) : 5;
+
+    // Tiered frontier: with a spill store the in-memory queues become a hot
+    // tier capped at hotQueueCapacity and overflow goes to the cold store in
+    // priority buckets instead of being dropped. maxSpilled bounds the cold tier.
+    this.spillStore = opts.spillStore || null;
+    this.hotQueueCapacity = this.spillStore
+      ? Math.max(1, typeof opts.hotQueueCapacity === 'number' ? opts.hotQueueCapacity : this.maxQueue)
+      : null;
+    this.maxSpilled = typeof opts.maxSpilled === 'number' ? opts.maxSpilled : Infinity;
+    this.spillBucketWidth = typeof opts.spillBucketWidth === 'number' && opts.spillBucketWidth > 0 ? opts.spillBucketWidth : 1;
+    this._refillLowWater = this.spillStore ? Math.max(1, Math.floor(this.hotQueueCapacity / 2)) : 0;
+    this._frontierStats = { spills: 0, refills: 0, refillBatches: 0, recovered: 0, recoveredDropped: 0 };
+
+    // Optional CheckpointJournal: enqueue/dequeue deltas for incremental checkpoints
+    this.journal = opts.journal || null;
+
+    // queuedUrls holds hot keys only; spilled keys live in the store's filter
+    // so dedupe memory does not grow with the cold tier. Stores without has()
+    // fall back to tracking spilled keys here.
+    this._spillTracksKeys = !!this.spillStore && typeof this.spillStore.has === 'function';
+  }
+
+  setJournal(journal) {
+    this.journal = journal || null;
   }
 
   size() {
+    const spilled = this.spillStore ? this.spillStore.count() : 0;
+    return this._hotSize() + spilled;
+  }
+
+  _hotSize() {
     if (this.usePriorityQueue) {
       return this.priorityQueues[this.discoveryQueueType].size() + this.priorityQueues[this.acquisitionQueueType].size();
     }
@@ -125,7 +167,7 @@ class QueueManager {
       type,
       meta,
       queueSize: currentSize,
-      isDuplicate: (queueKey) => queueKey && this.queuedUrls.has(queueKey)
+      isDuplicate: (queueKey) => this._isQueued(queueKey)
     }) || null;
 
     if (!evaluation || evaluation.status !== 'allow') {
@@ -176,7 +218,11 @@ class QueueManager {
         reason: 'max-depth-bypassed'
       });
     }
-    if (currentSize >= this.maxQueue) {
+    const spill = !!this.spillStore && this._hotSize() >= this.hotQueueCapacity;
+    const overflow = this.spillStore
+      ? spill && this.spillStore.count() >= this.maxSpilled
+      : currentSize >= this.maxQueue;
+    if (overflow) {
       this.emitQueueEvent({ action: 'drop', url: normalized, depth, host, reason: 'overflow', queueSize: currentSize });
       return false;
     }
@@ -285,9 +331,16 @@ class QueueManager {
 
     const queueType = this._determineQueueType(item);
     item.queueType = queueType;
-    this._pushItem(item, queueType);
-    if (queueKey) this.queuedUrls.add(queueKey);
+    // Explicit overrides (seeds) always stay hot so "crawl X fetches X" holds
+    if (spill && !(priorityMetadata && priorityMetadata.override)) {
+      this._spillItem(item, queueType);
+      if (queueKey && !this._spillTracksKeys) this.queuedUrls.add(queueKey);
+    } else {
+      this._pushItem(item, queueType);
+      if (queueKey) this.queuedUrls.add(queueKey);
+    }
     if (heatmapInfo) this._applyHeatmapDelta(heatmapInfo, 1);
+    if (this.journal) this.journal.recordEnqueued({ url: normalized, depth, type: kind, priority: item.priority });
 
     const eventPayload = {
       action: 'enqueued',
@@ -317,6 +370,16 @@ class QueueManager {
   }
 
   async pullNext() {
+    if (this.pullGate) {
+      const gate = this.pullGate();
+      if (gate && typeof gate.then === 'function') {
+        await gate;
+      }
+    }
+    if (this.spillStore) {
+      this._refillFromSpill(this.discoveryQueueType);
+      this._refillFromSpill(this.acquisitionQueueType);
+    }
     const now = nowMs();
     let bestWakeAt = null;
     const queueOrder = this._chooseQueueOrder();
@@ -339,6 +402,7 @@ class QueueManager {
       this._releaseQueueKey(item);
       if (item._heatmapInfo) this._applyHeatmapDelta(item._heatmapInfo, -1);
       this._noteQueueServed(queueType);
+      if (this.journal) this.journal.recordDequeued(item.url);
       return { item, context: context || null, wakeAt: bestWakeAt };
     }
 
@@ -365,13 +429,18 @@ class QueueManager {
 
   clear() {
     if (this.usePriorityQueue && this.priorityQueues) {
-      this.priorityQueues[this.discoveryQueueType].data.length = 0;
-      this.priorityQueues[this.acquisitionQueueType].data.length = 0;
+      for (const queue of Object.values(this.priorityQueues)) {
+        if (this.shardByHost) queue.clear();
+        else queue.data.length = 0;
+      }
     }
     if (!this.usePriorityQueue && this.fifoQueues) {
       this.fifoQueues[this.discoveryQueueType].length = 0;
       this.fifoQueues[this.acquisitionQueueType].length = 0;
     }
+    if (this.spillStore) {
+      safeCall(() => this.spillStore.clear());
+    }
     this.queuedUrls.clear();
     this._heatmapState = this._createEmptyHeatmapState();
     this._lastServedQueueType = null;
@@ -379,6 +448,84 @@ class QueueManager {
     this._streaks[this.acquisitionQueueType] = 0;
   }
 
+  /**
+   * Persist buffered cold-tier writes. Call on shutdown so spilled URLs
+   * survive a restart.
+   */
+  close() {
+    if (this.spillStore) {
+      safeCall(() => this.spillStore.close());
+    }
+  }
+
+  _spillBucket(item) {
+    if (!this.usePriorityQueue) return 0;
+    const priority = typeof item.priority === 'number' && Number.isFinite(item.priority) ? item.priority : 0;
+    return Math.floor(priority / this.spillBucketWidth);
+  }
+
+  _spillItem(item, queueType) {
+    this.spillStore.append(queueType, this._spillBucket(item), item);
+    this._frontierStats.spills += 1;
+  }
+
+  /**
+   * Pull one cold segment into the hot tier when the hot queue runs low or
+   * the cold tier holds a better bucket than the current hot head. A refill
+   * may overshoot hotQueueCapacity by at most one segment.
+   */
+  _refillFromSpill(queueType) {
+    const bucket = this.spillStore.lowestBucket(queueType);
+    if (bucket === null || bucket === undefined) return;
+
+    const hotLength = this._queueLength(queueType);
+    let shouldRefill = hotLength < this._refillLowWater;
+    if (!shouldRefill && this.usePriorityQueue) {
+      const head = this._peekFromQueueType(queueType);
+      shouldRefill = !head || this._spillBucket(head) > bucket;
+    }
+    if (!shouldRefill) return;
+
+    const items = safeCall(() => this.spillStore.take(queueType, bucket), []) || [];
+    if (!items.length) return;
+    for (const item of items) {
+      if (item._spillRecovered) {
+        delete item._spillRecovered;
+        // Spilled by a previous process: the URL may have been rediscovered
+        // and fetched since, so it goes back through eligibility first.
+        if (!this._readmitRecovered(item)) {
+          this._frontierStats.recoveredDropped += 1;
+          continue;
+        }
+        if (item._heatmapInfo) this._applyHeatmapDelta(item._heatmapInfo, 1);
+        this._frontierStats.recovered += 1;
+      }
+      if (item.queueKey) this.queuedUrls.add(item.queueKey);
+      this._pushItem(item, queueType);
+    }
+    this._frontierStats.refills += items.length;
+    this._frontierStats.refillBatches += 1;
+  }
+
+  _isQueued(queueKey) {
+    if (!queueKey) return false;
+    if (this.queuedUrls.has(queueKey)) return true;
+    return this._spillTracksKeys && !!safeCall(() => this.spillStore.has(queueKey), false);
+  }
+
+  _readmitRecovered(item) {
+    if (this._isQueued(item.queueKey)) return false;
+    const evaluation = safeCall(() => this.urlEligibilityService.evaluate({
+      url: item.url,
+      depth: item.depth,
+      type: item.type,
+      meta: item.meta || null,
+      queueSize: this.size(),
+      isDuplicate: (queueKey) => this._isQueued(queueKey)
+    }), null);
+    return !!evaluation && evaluation.status === 'allow';
+  }
+
   _determineQueueType(item) {
     const kind = item && (item.type || (item.decision && item.decision.kind));
     if (kind === 'article' || kind === 'refresh' || kind === 'history') return this.acquisitionQueueType;
@@ -414,6 +561,7 @@ class QueueManager {
   _peekFromQueueType(queueType) {
     if (this.usePriorityQueue) {
       const queue = this.priorityQueues?.[queueType];
+      if (queue && this.shardByHost) return queue.peek();
       return queue && queue.data.length ? queue.data[0] : null;
     }
     const queue = this.fifoQueues?.[queueType];
@@ -463,6 +611,10 @@ class QueueManager {
   async _pullFromQueueType(queueType, now) {
     if (this._queueLength(queueType) === 0) return null;
 
+    if (this.shardByHost) {
+      return this._pullFromHostShards(queueType, now);
+    }
+
     if (this.usePriorityQueue) {
       const queue = this.priorityQueues[queueType];
       const deferred = [];
@@ -582,14 +734,88 @@ class QueueManager {
     };
   }
 
+  /**
+   * Sharded pull: only the best ready host is inspected. Hosts that turn out
+   * to be paused or rate-limited are parked until their resume time rather
+   * than having their URLs popped and re-pushed on every pull.
+   */
+  async _pullFromHostShards(queueType, now) {
+    const shards = this.priorityQueues[queueType];
+    let candidate = null;
+    let candidateHost = null;
+    let context = null;
+    let minWake = Infinity;
+
+    for (let host = shards.readyHost(now); host !== null; host = shards.readyHost(now)) {
+      const head = shards.head(host);
+      const resumeAt = this.getHostResumeTime(host);
+      let earliest = head.nextEligibleAt || 0;
+      if (resumeAt) earliest = Math.max(earliest, resumeAt);
+
+      if (this.isHostRateLimited(host)) {
+        // Take before awaiting so a concurrent pull cannot serve it twice
+        const item = shards.take(host);
+        const cached = await this.cache.get(item.url);
+        if (cached) {
+          context = { forceCache: true, cachedPage: cached, rateLimitedHost: host };
+          candidate = item;
+          break;
+        }
+        if (this.onRateLimitDeferred) {
+          safeCall(() => this.onRateLimitDeferred(item, { host }));
+        }
+        const wakeTime = earliest > now ? earliest : now + 1000;
+        item.nextEligibleAt = wakeTime;
+        shards.push(item);
+        shards.park(host, wakeTime);
+        minWake = Math.min(minWake, wakeTime);
+        continue;
+      }
+
+      if (earliest > now) {
+        shards.park(host, earliest);
+        minWake = Math.min(minWake, earliest);
+        continue;
+      }
+
+      candidate = shards.take(host);
+      candidateHost = host;
+      break;
+    }
+
+    if (!candidate) {
+      const nextWake = shards.nextWakeAt();
+      if (nextWake != null) minWake = Math.min(minWake, nextWake);
+    }
+
+    const finalContext = await this._maybeAttachCacheContext(candidate, context, candidateHost);
+    return {
+      item: candidate,
+      context: finalContext,
+      deferred: [],
+      wakeAt: minWake < Infinity ? minWake : null
+    };
+  }
+
   getHeatmapSnapshot() {
     if (!this._heatmapState) return null;
-    return {
+    const snapshot = {
       total: this._heatmapState.total,
       cells: JSON.parse(JSON.stringify(this._heatmapState.cells || {})),
       depthBuckets: { ...this._heatmapState.depthBuckets },
       lastUpdatedAt: this._heatmapState.lastUpdatedAt
     };
+    if (this.spillStore) {
+      const storeStats = safeCall(() => this.spillStore.getStats(), null) || {};
+      snapshot.frontier = {
+        hot: this._hotSize(),
+        hotCapacity: this.hotQueueCapacity,
+        spilled: safeCall(() => this.spillStore.count(), 0),
+        ...this._frontierStats,
+        segments: storeStats.segments ?? null
+      };
+    }
+    return snapshot;
   }
 
   _createEmptyHeatmapState() {
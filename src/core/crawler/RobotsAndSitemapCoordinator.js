@@ -10,6 +10,7 @@ class RobotsAndSitemapCoordinator {
     loadSitemaps,
     useSitemap = true,
     sitemapMaxUrls = 5000,
+    sitemapLastmodSince = null,
     getUrlDecision,
     handlePolicySkip,
     isOnDomain,
@@ -64,6 +65,7 @@ class RobotsAndSitemapCoordinator {
     this.loadSitemaps = loadSitemaps;
     this.useSitemap = useSitemap;
     this.sitemapMaxUrls = sitemapMaxUrls;
+    this.sitemapLastmodSince = sitemapLastmodSince;
     this.getUrlDecision = getUrlDecision;
     this.handlePolicySkip = handlePolicySkip;
     this.isOnDomain = isOnDomain;
@@ -92,6 +94,9 @@ class RobotsAndSitemapCoordinator {
     // populated from the onFetch callback so the crawl-status detail panel can
     // show which sitemaps have been fetched vs are still pending.
     this.sitemapFetches = new Map();
+    // Byte offset reached in each streamed sitemap (url -> offset), so a
+    // re-run after an interruption resumes instead of re-reading from zero.
+    this.sitemapOffsets = new Map();
   }
 
   getRobotsInfo() {
@@ -156,6 +161,12 @@ class RobotsAndSitemapCoordinator {
       sitemapMaxUrls: this.sitemapMaxUrls,
       push: (url, meta) => this._handleSitemapUrl(url, meta),
       onFetch: (info) => this._recordSitemapFetch(info),
+      onBatch: ({ sitemapUrl, offset }) => this.sitemapOffsets.set(sitemapUrl, offset),
+      onSitemapDone: ({ sitemapUrl, complete }) => {
+        if (complete) this.sitemapOffsets.delete(sitemapUrl);
+      },
+      resumeOffsets: this.sitemapOffsets,
+      lastmodSince: this.sitemapLastmodSince,
       cache: this._sitemapCache()
     });
     this.logger.log(`Sitemap enqueue complete: ${pushed} URL(s)`);
@@ -1,5 +1,7 @@
 'use strict';
 
+const { getSharedRobotsRules, parseRobotsTxt, agentCandidates } = require('./RobotsRules');
+
 const DEFAULT_ROBOTS_CACHE_TTL_SECONDS = Number(
   process.env.CRAWLER_ROBOTS_CACHE_TTL_SECONDS || 24 * 60 * 60
 );
@@ -42,15 +44,9 @@ function getHeader(headers, name) {
   return null;
 }
 
-function extractSitemapUrls(robotsTxt, baseUrl) {
-  const text = normalizeText(robotsTxt);
-  if (!text) return [];
+function resolveSitemapUrls(declared, baseUrl) {
   const urls = new Set();
-  for (const line of text.split(/\r?\n/)) {
-    const trimmed = line.trim();
-    if (!/^sitemap\s*:/i.test(trimmed)) continue;
-    const raw = trimmed.replace(/^sitemap\s*:/i, '').trim();
-    if (!raw) continue;
+  for (const raw of declared) {
     try {
       urls.add(new URL(raw, baseUrl).href);
     } catch (_) {
@@ -60,55 +56,24 @@ function extractSitemapUrls(robotsTxt, baseUrl) {
   return [...urls];
 }
 
-function parseCrawlDelays(robotsTxt) {
+function extractSitemapUrls(robotsTxt, baseUrl) {
   const text = normalizeText(robotsTxt);
-  const delays = new Map();
-  if (!text) return delays;
-
-  let agents = [];
-  let sawDirective = false;
-  const startNewGroupIfNeeded = () => {
-    if (sawDirective) {
-      agents = [];
-      sawDirective = false;
-    }
-  };
-
-  for (const rawLine of text.split(/\r?\n/)) {
-    const line = rawLine.replace(/#.*/, '').trim();
-    if (!line) continue;
-    const match = line.match(/^([^:]+):\s*(.*)$/);
-    if (!match) continue;
-    const field = match[1].trim().toLowerCase();
-    const value = match[2].trim();
-
-    if (field === 'user-agent') {
-      startNewGroupIfNeeded();
-      if (value) agents.push(value.toLowerCase());
-      continue;
-    }
-
-    sawDirective = true;
-    if (field !== 'crawl-delay' || agents.length === 0) continue;
-    const seconds = Number(value);
-    if (!Number.isFinite(seconds) || seconds < 0) continue;
-    for (const agent of agents) {
-      if (!delays.has(agent)) delays.set(agent, seconds);
-    }
-  }
+  if (!text) return [];
+  return resolveSitemapUrls(parseRobotsTxt(text).sitemaps, baseUrl);
+}
 
-  return delays;
+function parseCrawlDelays(robotsTxt) {
+  const text = normalizeText(robotsTxt);
+  if (!text) return new Map();
+  return parseRobotsTxt(text).crawlDelays;
 }
 
 function parseCrawlDelay(robotsTxt, userAgent = '*') {
   const delays = parseCrawlDelays(robotsTxt);
-  const normalized = String(userAgent || '*').toLowerCase();
-  if (delays.has(normalized)) return delays.get(normalized);
-  if (normalized.includes('/')) {
-    const shortName = normalized.split('/')[0];
-    if (delays.has(shortName)) return delays.get(shortName);
+  for (const agent of agentCandidates(userAgent)) {
+    if (delays.has(agent)) return delays.get(agent);
   }
-  return delays.has('*') ? delays.get('*') : null;
+  return null;
 }
 
 function normalizeCachedRecord(record, source = 'typed') {
@@ -158,7 +123,15 @@ class RobotsCache {
   }
 
   getCrawlDelay(robotsTxt, userAgent = '*') {
-    return parseCrawlDelay(robotsTxt, userAgent);
+    return this._compiled(robotsTxt).getCrawlDelay(userAgent);
+  }
+
+  /**
+   * Compiled rules from the process-wide cache, so crawl delay, sitemaps and
+   * the coordinator's allow checks all come from one scan of the text.
+   */
+  _compiled(robotsTxt) {
+    return getSharedRobotsRules().compile(this.robotsUrl, normalizeText(robotsTxt));
   }
 
   async load() {
@@ -190,6 +163,7 @@ class RobotsCache {
     }
 
     const robotsTxt = await response.text();
+    const compiled = this._compiled(robotsTxt);
     await this._recordFetchVisibility(response, {
       requestStartedIso,
       fetchedAtIso,
@@ -202,14 +176,16 @@ class RobotsCache {
       httpStatus: response.status || 200,
       etag: getHeader(response.headers, 'etag'),
       lastModified: getHeader(response.headers, 'last-modified'),
-      crawlDelaySeconds: parseCrawlDelay(robotsTxt, '*'),
-      sitemapUrls: extractSitemapUrls(robotsTxt, this.baseUrl)
+      crawlDelaySeconds: compiled.getCrawlDelay('*'),
+      sitemapUrls: resolveSitemapUrls(compiled.sitemaps, this.baseUrl)
     };
     await this._writeCache(db, record);
     return this._result('network', record);
   }
 
   _result(source, record) {
+    const hasSitemaps = Array.isArray(record.sitemapUrls) && record.sitemapUrls.length > 0;
+    const compiled = record.crawlDelaySeconds == null || !hasSitemaps ? this._compiled(record.robotsTxt) : null;
     return {
       loaded: true,
       source,
@@ -219,10 +195,8 @@ class RobotsCache {
       httpStatus: record.httpStatus || 200,
       etag: record.etag || null,
       lastModified: record.lastModified || null,
-      crawlDelaySeconds: record.crawlDelaySeconds ?? parseCrawlDelay(record.robotsTxt, '*'),
-      sitemapUrls: Array.isArray(record.sitemapUrls) && record.sitemapUrls.length
-        ? record.sitemapUrls
-        : extractSitemapUrls(record.robotsTxt, this.baseUrl)
+      crawlDelaySeconds: record.crawlDelaySeconds ?? compiled.getCrawlDelay('*'),
+      sitemapUrls: hasSitemaps ? record.sitemapUrls : resolveSitemapUrls(compiled.sitemaps, this.baseUrl)
     };
   }
 
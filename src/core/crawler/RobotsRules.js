@@ -0,0 +1,478 @@
+'use strict';
+
+/**
+ * RobotsRules — compiled robots.txt matcher with a process-wide LRU
+ *
+ * robots.txt is scanned once into user-agent groups, crawl delays and
+ * sitemap declarations. The rules that apply to a user-agent are compiled
+ * the first time that agent asks, into a table sorted by specificity
+ * (longest pattern first, Allow before Disallow on ties, RFC 9309), so an
+ * allow check is a walk down the table until the first match. `*` wildcards
+ * and `$` end anchors are matched by index over the URL string — no regex,
+ * no substring — so per-URL checks allocate nothing.
+ *
+ * Compiled records live in one LRU per process keyed by host, so every
+ * consumer of the same robots.txt (RobotsCache, RobotsAndSitemapCoordinator
+ * and, through NewsCrawler.isAllowed, UrlEligibilityService) shares a single
+ * compilation. `robotsRulesParser` is a drop-in for the `robots-parser`
+ * factory.
+ *
+ * Matching assumes the URL belongs to the host the rules were compiled for;
+ * callers check on-domain first. Patterns are percent-encoding normalised
+ * (non-ASCII encoded, escapes upper-cased) to match WHATWG-serialised URLs.
+ *
+ * @module RobotsRules
+ * @example
+ * const rules = getSharedRobotsRules().compile('https://example.com/robots.txt', text);
+ * rules.isAllowed('https://example.com/news/1', 'NewsBot/1.0');
+ * getSharedRobotsRules().getStats(); // { hitRate, avgEvalNs, ... }
+ */
+
+const { hostOf } = require('./telemetry/TelemetryRingBuffer');
+
+const DEFAULT_MAX_ENTRIES = 1000;
+const EVAL_SAMPLE_MASK = 63; // time 1 evaluation in 64
+const FLAG_WILDCARD = 1;
+const FLAG_ANCHORED = 2;
+const ROBOTS_PATH = '/robots.txt';
+
+function toText(value) {
+  if (value == null) return '';
+  if (Buffer.isBuffer(value)) return value.toString('utf8');
+  return String(value);
+}
+
+function normalizePattern(value) {
+  let pattern = value
+    .replace(/[^\x00-\x7f]+/g, (chars) => encodeURIComponent(chars))
+    .replace(/%[0-9a-f]{2}/gi, (escape) => escape.toUpperCase())
+    .replace(/\*{2,}/g, '*');
+  if (pattern[0] !== '/' && pattern[0] !== '*') pattern = '/' + pattern;
+  return pattern;
+}
+
+/**
+ * Product token used for group lookup: "NewsBot/1.0 (+url)" -> "newsbot"
+ */
+function agentCandidates(userAgent) {
+  const normalized = String(userAgent || '*').trim().toLowerCase() || '*';
+  const slash = normalized.indexOf('/');
+  if (slash > 0) {
+    const shortName = normalized.slice(0, slash).trim();
+    return [normalized, shortName, '*'];
+  }
+  return normalized === '*' ? ['*'] : [normalized, '*'];
+}
+
+/**
+ * Single scan of robots.txt.
+ * @param {string|Buffer} robotsTxt
+ * @returns {{groups: Array<{agents: string[], rules: Array<{allow: boolean, pattern: string}>}>, crawlDelays: Map<string, number>, sitemaps: string[]}}
+ */
+function parseRobotsTxt(robotsTxt) {
+  const text = toText(robotsTxt);
+  const groups = [];
+  const crawlDelays = new Map();
+  const sitemaps = [];
+  let current = null;
+  let sawDirective = true;
+
+  for (const rawLine of text.split(/\r?\n/)) {
+    const hash = rawLine.indexOf('#');
+    const line = (hash >= 0 ? rawLine.slice(0, hash) : rawLine).trim();
+    if (!line) continue;
+    const colon = line.indexOf(':');
+    if (colon <= 0) continue;
+    const field = line.slice(0, colon).trim().toLowerCase();
+    const value = line.slice(colon + 1).trim();
+
+    if (field === 'user-agent') {
+      if (sawDirective) {
+        current = { agents: [], rules: [] };
+        groups.push(current);
+        sawDirective = false;
+      }
+      if (value) current.agents.push(value.toLowerCase());
+      continue;
+    }
+
+    sawDirective = true;
+    if (field === 'sitemap') {
+      if (value) sitemaps.push(value);
+      continue;
+    }
+    if (!current) continue;
+    if (field === 'allow' || field === 'disallow') {
+      // An empty Disallow allows everything, which is the default anyway
+      if (value) current.rules.push({ allow: field === 'allow', pattern: normalizePattern(value) });
+    } else if (field === 'crawl-delay') {
+      const seconds = Number(value);
+      if (!Number.isFinite(seconds) || seconds < 0) continue;
+      for (const agent of current.agents) {
+        if (!crawlDelays.has(agent)) crawlDelays.set(agent, seconds);
+      }
+    }
+  }
+
+  return { groups, crawlDelays, sitemaps };
+}
+
+/**
+ * Glob match of `pattern` (with `*`) against url[start, end). Without
+ * `anchored` the pattern only has to match a prefix.
+ */
+function globMatch(pattern, url, start, end, anchored) {
+  const length = pattern.length;
+  let pi = 0;
+  let si = start;
+  let star = -1;
+  let mark = start;
+  while (si < end) {
+    if (pi < length) {
+      const ch = pattern.charCodeAt(pi);
+      if (ch === 42) {
+        star = pi++;
+        mark = si;
+        continue;
+      }
+      if (ch === url.charCodeAt(si)) {
+        pi++;
+        si++;
+        continue;
+      }
+    } else if (!anchored) {
+      return true;
+    }
+    if (star < 0) return false;
+    pi = star + 1;
+    si = ++mark;
+  }
+  while (pi < length && pattern.charCodeAt(pi) === 42) pi++;
+  return pi === length;
+}
+
+function pathStartOf(url) {
+  const scheme = url.indexOf('://');
+  if (scheme < 0) return 0;
+  let i = scheme + 3;
+  const length = url.length;
+  while (i < length) {
+    const ch = url.charCodeAt(i);
+    // '/', '?', '#'
+    if (ch === 47 || ch === 63 || ch === 35) break;
+    i++;
+  }
+  return i;
+}
+
+/**
+ * Specificity-sorted rules for one user-agent
+ */
+class RobotsRuleTable {
+  constructor(rules, stats) {
+    const sorted = rules
+      .map((rule) => {
+        const anchored = rule.pattern.length > 1 && rule.pattern.endsWith('$');
+        const pattern = anchored ? rule.pattern.slice(0, -1) : rule.pattern;
+        return { allow: rule.allow, pattern, weight: rule.pattern.length, anchored };
+      })
+      .sort((a, b) => (b.weight - a.weight) || (Number(b.allow) - Number(a.allow)));
+
+    this.size = sorted.length;
+    this.patterns = sorted.map((rule) => rule.pattern);
+    this.allows = Uint8Array.from(sorted, (rule) => (rule.allow ? 1 : 0));
+    this.flags = Uint8Array.from(sorted, (rule) =>
+      (rule.pattern.includes('*') ? FLAG_WILDCARD : 0) | (rule.anchored ? FLAG_ANCHORED : 0));
+    this._stats = stats;
+  }
+
+  /**
+   * @param {string} url - Absolute URL or path
+   * @returns {boolean}
+   */
+  isAllowed(url) {
+    if (typeof url !== 'string') return true;
+    const stats = this._stats;
+    if ((++stats.evaluations & EVAL_SAMPLE_MASK) !== 0) return this._evaluate(url);
+    const started = process.hrtime.bigint();
+    const allowed = this._evaluate(url);
+    stats.evalNs += Number(process.hrtime.bigint() - started);
+    stats.evalSamples += 1;
+    return allowed;
+  }
+
+  _evaluate(url) {
+    if (this.size === 0) return true;
+    let start = pathStartOf(url);
+    let end = url.indexOf('#', start);
+    if (end < 0) end = url.length;
+    if (start === end || url.charCodeAt(start) !== 47) {
+      // "https://host" or "https://host?q" — robots paths always start with "/"
+      url = '/' + url.slice(start, end);
+      start = 0;
+      end = url.length;
+    }
+    if (end - start === ROBOTS_PATH.length && url.startsWith(ROBOTS_PATH, start)) return true;
+
+    const span = end - start;
+    for (let i = 0; i < this.size; i++) {
+      const pattern = this.patterns[i];
+      const flags = this.flags[i];
+      let matched;
+      if (flags & FLAG_WILDCARD) {
+        matched = globMatch(pattern, url, start, end, (flags & FLAG_ANCHORED) !== 0);
+      } else if (flags & FLAG_ANCHORED) {
+        matched = span === pattern.length && url.startsWith(pattern, start);
+      } else {
+        matched = pattern.length <= span && url.startsWith(pattern, start);
+      }
+      if (matched) return this.allows[i] === 1;
+    }
+    return true;
+  }
+}
+
+/**
+ * One host's robots.txt, compiled. API-compatible with robots-parser.
+ */
+class CompiledRobots {
+  /**
+   * @param {string} robotsUrl
+   * @param {string|Buffer} robotsTxt
+   * @param {Object} [stats] - Shared counters (owned by RobotsRulesCache)
+   */
+  constructor(robotsUrl, robotsTxt, stats = createStats()) {
+    this.robotsUrl = robotsUrl || null;
+    this.host = hostOf(robotsUrl);
+    this.text = toText(robotsTxt);
+    const parsed = parseRobotsTxt(this.text);
+    this.crawlDelays = parsed.crawlDelays;
+    this.sitemaps = parsed.sitemaps;
+
+    /** @type {Map<string, Array<{allow: boolean, pattern: string}>>} */
+    this._groups = new Map();
+    for (const group of parsed.groups) {
+      for (const agent of group.agents) {
+        const rules = this._groups.get(agent);
+        if (rules) rules.push(...group.rules);
+        else this._groups.set(agent, group.rules.slice());
+      }
+    }
+
+    /** @type {Map<string, RobotsRuleTable>} */
+    this._tables = new Map();
+    this._stats = stats;
+  }
+
+  /**
+   * Rule table for a user-agent, compiled on first use
+   * @param {string} [userAgent='*']
+   * @returns {RobotsRuleTable}
+   */
+  rulesFor(userAgent = '*') {
+    const cached = this._tables.get(userAgent);
+    if (cached) return cached;
+    let rules = [];
+    for (const agent of agentCandidates(userAgent)) {
+      if (this._groups.has(agent)) {
+        rules = this._groups.get(agent);
+        break;
+      }
+    }
+    const table = new RobotsRuleTable(rules, this._stats);
+    this._tables.set(userAgent, table);
+    return table;
+  }
+
+  isAllowed(url, userAgent = '*') {
+    return this.rulesFor(userAgent).isAllowed(url);
+  }
+
+  isDisallowed(url, userAgent = '*') {
+    return !this.isAllowed(url, userAgent);
+  }
+
+  /**
+   * @param {string} [userAgent='*']
+   * @returns {number|null} Seconds
+   */
+  getCrawlDelay(userAgent = '*') {
+    for (const agent of agentCandidates(userAgent)) {
+      if (this.crawlDelays.has(agent)) return this.crawlDelays.get(agent);
+    }
+    return null;
+  }
+
+  /** @returns {string[]} Sitemap declarations as written */
+  getSitemaps() {
+    return this.sitemaps.slice();
+  }
+
+  getPreferredHost() {
+    return null;
+  }
+}
+
+function createStats() {
+  return {
+    hits: 0,
+    misses: 0,
+    evictions: 0,
+    compilations: 0,
+    compileNs: 0,
+    evaluations: 0,
+    evalSamples: 0,
+    evalNs: 0
+  };
+}
+
+/**
+ * LRU of compiled robots.txt records keyed by host
+ */
+class RobotsRulesCache {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxEntries=1000] - Hosts kept compiled
+   */
+  constructor(options = {}) {
+    this.maxEntries = Math.max(1, Math.trunc(options.maxEntries || DEFAULT_MAX_ENTRIES));
+    /** @type {Map<string, CompiledRobots>} */
+    this._entries = new Map();
+    this._stats = createStats();
+  }
+
+  /**
+   * Compiled rules for `robotsTxt`, reusing the cached record when the host's
+   * text is unchanged.
+   * @param {string} robotsUrl
+   * @param {string|Buffer} robotsTxt
+   * @returns {CompiledRobots}
+   */
+  compile(robotsUrl, robotsTxt) {
+    const key = hostOf(robotsUrl) || String(robotsUrl || '');
+    const text = toText(robotsTxt);
+    const existing = this._entries.get(key);
+    if (existing && existing.text === text) {
+      this._stats.hits += 1;
+      this._touch(key, existing);
+      return existing;
+    }
+    this._stats.misses += 1;
+    const started = process.hrtime.bigint();
+    const compiled = new CompiledRobots(robotsUrl, text, this._stats);
+    this._stats.compileNs += Number(process.hrtime.bigint() - started);
+    this._stats.compilations += 1;
+    this._touch(key, compiled);
+    return compiled;
+  }
+
+  /**
+   * @param {string} hostOrUrl
+   * @returns {CompiledRobots|null}
+   */
+  get(hostOrUrl) {
+    const key = this._keyOf(hostOrUrl);
+    const entry = key ? this._entries.get(key) : null;
+    if (!entry) {
+      this._stats.misses += 1;
+      return null;
+    }
+    this._stats.hits += 1;
+    this._touch(key, entry);
+    return entry;
+  }
+
+  /**
+   * Allow check against whatever rules are cached for the URL's host;
+   * hosts without compiled rules are allowed.
+   * @param {string} url
+   * @param {string} [userAgent='*']
+   * @returns {boolean}
+   */
+  isAllowed(url, userAgent = '*') {
+    const entry = this._entries.get(hostOf(url));
+    return entry ? entry.isAllowed(url, userAgent) : true;
+  }
+
+  delete(hostOrUrl) {
+    return this._entries.delete(this._keyOf(hostOrUrl));
+  }
+
+  clear() {
+    this._entries.clear();
+  }
+
+  get size() {
+    return this._entries.size;
+  }
+
+  getStats() {
+    const s = this._stats;
+    const lookups = s.hits + s.misses;
+    return {
+      entries: this._entries.size,
+      maxEntries: this.maxEntries,
+      hits: s.hits,
+      misses: s.misses,
+      hitRate: lookups > 0 ? s.hits / lookups : 0,
+      evictions: s.evictions,
+      compilations: s.compilations,
+      compileMs: Math.round(s.compileNs / 1000) / 1000,
+      evaluations: s.evaluations,
+      avgEvalNs: s.evalSamples > 0 ? Math.round(s.evalNs / s.evalSamples) : null
+    };
+  }
+
+  resetStats() {
+    Object.assign(this._stats, createStats());
+  }
+
+  _keyOf(hostOrUrl) {
+    if (!hostOrUrl) return null;
+    const value = String(hostOrUrl);
+    return value.includes('//') ? hostOf(value) : value.toLowerCase();
+  }
+
+  _touch(key, entry) {
+    this._entries.delete(key);
+    this._entries.set(key, entry);
+    while (this._entries.size > this.maxEntries) {
+      this._entries.delete(this._entries.keys().next().value);
+      this._stats.evictions += 1;
+    }
+  }
+}
+
+let sharedCache = null;
+
+/**
+ * The process-wide cache. Size comes from CRAWLER_ROBOTS_RULES_CACHE_SIZE on
+ * first use.
+ * @returns {RobotsRulesCache}
+ */
+function getSharedRobotsRules() {
+  if (!sharedCache) {
+    sharedCache = new RobotsRulesCache({ maxEntries: Number(process.env.CRAWLER_ROBOTS_RULES_CACHE_SIZE) || undefined });
+  }
+  return sharedCache;
+}
+
+/**
+ * Drop-in for `require('robots-parser')` backed by the shared cache
+ * @param {string} robotsUrl
+ * @param {string} robotsTxt
+ * @returns {CompiledRobots}
+ */
+function robotsRulesParser(robotsUrl, robotsTxt) {
+  return getSharedRobotsRules().compile(robotsUrl, robotsTxt);
+}
+
+module.exports = {
+  CompiledRobots,
+  RobotsRuleTable,
+  RobotsRulesCache,
+  getSharedRobotsRules,
+  robotsRulesParser,
+  parseRobotsTxt,
+  agentCandidates
+};
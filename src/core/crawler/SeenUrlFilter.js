@@ -0,0 +1,371 @@
+'use strict';
+
+/**
+ * Probabilistic seen-sets for UrlEligibilityService.
+ *
+ * Most links a crawl discovers were already fetched, often seconds earlier
+ * on the previous page's menu. Each one used to cost a SQLite lookup
+ * (isUrlSuccessfullyProcessedWithContent, plus getLatestFetchForUrl when a
+ * freshness window is set). A filter warmed with every URL the database
+ * already holds content for answers "definitely not processed" from memory.
+ * The database is only asked when the filter says "maybe".
+ *
+ * Two variants share one interface (add / has / toJSON):
+ * - BloomFilter: smallest and fastest, but cannot forget.
+ * - CuckooFilter: supports delete(). It is used when a recrawl window can
+ *   make a stored URL stale again, so that URL stops costing a lookup on
+ *   every later sighting.
+ *
+ * Both grow by adding layers when their item count passes capacity, so the
+ * false-positive rate stays near its target without knowing the crawl size
+ * up front. Filters never give false negatives for items added to them.
+ * The one exception is CuckooFilter.delete(), which can also remove a
+ * colliding fingerprint; that costs one redundant fetch at the filter's
+ * false-positive rate.
+ */
+
+const FNV_OFFSET = 0x811c9dc5;
+const FNV_PRIME = 0x01000193;
+
+// 32-bit FNV-1a with a seed, then a murmur3 finalizer for better bit spread
+function hash32(str, seed) {
+  let h = (FNV_OFFSET ^ seed) >>> 0;
+  for (let i = 0; i < str.length; i += 1) {
+    h ^= str.charCodeAt(i);
+    h = Math.imul(h, FNV_PRIME);
+  }
+  h ^= h >>> 16;
+  h = Math.imul(h, 0x85ebca6b);
+  h ^= h >>> 13;
+  h = Math.imul(h, 0xc2b2ae35);
+  h ^= h >>> 16;
+  return h >>> 0;
+}
+
+function toBase64(typed) {
+  return Buffer.from(typed.buffer, typed.byteOffset, typed.byteLength).toString('base64');
+}
+
+function fromBase64(value, Type) {
+  const buf = Buffer.from(value, 'base64');
+  const copy = new Uint8Array(buf.byteLength);
+  copy.set(buf);
+  return new Type(copy.buffer, 0, copy.byteLength / Type.BYTES_PER_ELEMENT);
+}
+
+class BloomLayer {
+  constructor(capacity, fpRate, bits = null) {
+    this.capacity = capacity;
+    this.m = Math.max(64, Math.ceil(-capacity * Math.log(fpRate) / (Math.LN2 * Math.LN2)));
+    this.k = Math.max(1, Math.round((this.m / capacity) * Math.LN2));
+    this.bits = bits || new Uint8Array(Math.ceil(this.m / 8));
+    this.count = 0;
+  }
+
+  add(h1, h2) {
+    for (let i = 0; i < this.k; i += 1) {
+      const bit = (h1 + Math.imul(i, h2)) >>> 0;
+      const idx = bit % this.m;
+      this.bits[idx >>> 3] |= (1 << (idx & 7));
+    }
+  }
+
+  has(h1, h2) {
+    for (let i = 0; i < this.k; i += 1) {
+      const idx = ((h1 + Math.imul(i, h2)) >>> 0) % this.m;
+      if ((this.bits[idx >>> 3] & (1 << (idx & 7))) === 0) return false;
+    }
+    return true;
+  }
+}
+
+class BloomFilter {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.capacity=1000000] - Items per layer before a new one is added
+   * @param {number} [options.fpRate=0.01] - Target false-positive rate
+   */
+  constructor(options = {}) {
+    this.capacity = Math.max(1, Math.floor(options.capacity || 1000000));
+    this.fpRate = Math.min(0.5, Math.max(1e-6, options.fpRate || 0.01));
+    this.layers = [new BloomLayer(this.capacity, this.fpRate)];
+    this.size = 0;
+  }
+
+  get kind() {
+    return 'bloom';
+  }
+
+  add(value) {
+    const key = String(value);
+    const h1 = hash32(key, 0);
+    const h2 = hash32(key, 0x9e3779b9) | 1;
+    for (const layer of this.layers) {
+      if (layer.has(h1, h2)) return false;
+    }
+    let layer = this.layers[this.layers.length - 1];
+    if (layer.count >= layer.capacity) {
+      // Each new layer is twice as large and twice as strict, so the summed
+      // false-positive rate stays bounded by 2 × fpRate
+      layer = new BloomLayer(layer.capacity * 2, this.fpRate / Math.pow(2, this.layers.length));
+      this.layers.push(layer);
+    }
+    layer.add(h1, h2);
+    layer.count += 1;
+    this.size += 1;
+    return true;
+  }
+
+  has(value) {
+    const key = String(value);
+    const h1 = hash32(key, 0);
+    const h2 = hash32(key, 0x9e3779b9) | 1;
+    for (const layer of this.layers) {
+      if (layer.has(h1, h2)) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Expected false-positive rate at the current fill (union over layers).
+   */
+  estimatedFpRate() {
+    let miss = 1;
+    for (const layer of this.layers) {
+      const fill = 1 - Math.exp(-layer.k * layer.count / layer.m);
+      miss *= 1 - Math.pow(fill, layer.k);
+    }
+    return 1 - miss;
+  }
+
+  byteLength() {
+    return this.layers.reduce((sum, layer) => sum + layer.bits.byteLength, 0);
+  }
+
+  toJSON() {
+    return {
+      kind: 'bloom',
+      capacity: this.capacity,
+      fpRate: this.fpRate,
+      size: this.size,
+      layers: this.layers.map((layer) => ({ capacity: layer.capacity, count: layer.count, bits: toBase64(layer.bits) }))
+    };
+  }
+
+  static fromJSON(json) {
+    const filter = new BloomFilter({ capacity: json.capacity, fpRate: json.fpRate });
+    filter.layers = json.layers.map((entry, i) => {
+      const layer = new BloomLayer(entry.capacity, filter.fpRate / Math.pow(2, i), fromBase64(entry.bits, Uint8Array));
+      layer.count = entry.count;
+      return layer;
+    });
+    filter.size = json.size || 0;
+    return filter;
+  }
+}
+
+const BUCKET_SIZE = 4;
+const MAX_KICKS = 500;
+const MAX_LOAD = 0.9;
+
+function nextPow2(n) {
+  let p = 1;
+  while (p < n) p *= 2;
+  return p;
+}
+
+class CuckooLayer {
+  constructor(capacity, slots = null, buckets = null) {
+    this.buckets = buckets || nextPow2(Math.max(1, Math.ceil(capacity / (BUCKET_SIZE * MAX_LOAD))));
+    this.mask = this.buckets - 1;
+    // 16-bit fingerprints, 0 = empty slot
+    this.slots = slots || new Uint16Array(this.buckets * BUCKET_SIZE);
+    this.count = 0;
+    this.stash = [];
+  }
+
+  get full() {
+    return this.count >= this.buckets * BUCKET_SIZE * MAX_LOAD;
+  }
+
+  altIndex(index, fp) {
+    return (index ^ hash32(String(fp), 0x5bd1e995)) & this.mask;
+  }
+
+  _bucketHas(bucket, fp) {
+    const base = bucket * BUCKET_SIZE;
+    for (let i = 0; i < BUCKET_SIZE; i += 1) {
+      if (this.slots[base + i] === fp) return base + i;
+    }
+    return -1;
+  }
+
+  _bucketInsert(bucket, fp) {
+    const base = bucket * BUCKET_SIZE;
+    for (let i = 0; i < BUCKET_SIZE; i += 1) {
+      if (this.slots[base + i] === 0) {
+        this.slots[base + i] = fp;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  has(fp, i1) {
+    const i2 = this.altIndex(i1, fp);
+    if (this._bucketHas(i1, fp) >= 0 || this._bucketHas(i2, fp) >= 0) return true;
+    return this.stash.some((entry) => entry.fp === fp && (entry.index === i1 || entry.index === i2));
+  }
+
+  insert(fp, i1) {
+    const i2 = this.altIndex(i1, fp);
+    this.count += 1;
+    if (this._bucketInsert(i1, fp) || this._bucketInsert(i2, fp)) return;
+    let index = (fp & 1) ? i1 : i2;
+    let current = fp;
+    for (let kick = 0; kick < MAX_KICKS; kick += 1) {
+      const slot = index * BUCKET_SIZE + ((current + kick) % BUCKET_SIZE);
+      const evicted = this.slots[slot];
+      this.slots[slot] = current;
+      current = evicted;
+      index = this.altIndex(index, current);
+      if (this._bucketInsert(index, current)) return;
+    }
+    // Table is saturated around these buckets; keep the homeless fingerprint
+    // so it is never lost (a lost fingerprint would be a false negative)
+    this.stash.push({ fp: current, index });
+  }
+
+  remove(fp, i1) {
+    const i2 = this.altIndex(i1, fp);
+    const slot = this._bucketHas(i1, fp) >= 0 ? this._bucketHas(i1, fp) : this._bucketHas(i2, fp);
+    if (slot >= 0) {
+      this.slots[slot] = 0;
+      this.count -= 1;
+      return true;
+    }
+    const stashIdx = this.stash.findIndex((entry) => entry.fp === fp && (entry.index === i1 || entry.index === i2));
+    if (stashIdx >= 0) {
+      this.stash.splice(stashIdx, 1);
+      this.count -= 1;
+      return true;
+    }
+    return false;
+  }
+}
+
+class CuckooFilter {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.capacity=1000000] - Items per layer before a new one is added
+   */
+  constructor(options = {}) {
+    this.capacity = Math.max(1, Math.floor(options.capacity || 1000000));
+    this.layers = [new CuckooLayer(this.capacity)];
+    this.size = 0;
+  }
+
+  get kind() {
+    return 'cuckoo';
+  }
+
+  _locate(value) {
+    const key = String(value);
+    const h = hash32(key, 0);
+    const fp = ((hash32(key, 0x27d4eb2f) & 0xffff) || 1);
+    return { fp, h };
+  }
+
+  add(value) {
+    const { fp, h } = this._locate(value);
+    for (const layer of this.layers) {
+      if (layer.has(fp, h & layer.mask)) return false;
+    }
+    let layer = this.layers[this.layers.length - 1];
+    if (layer.full) {
+      layer = new CuckooLayer(this.capacity * Math.pow(2, this.layers.length));
+      this.layers.push(layer);
+    }
+    layer.insert(fp, h & layer.mask);
+    this.size += 1;
+    return true;
+  }
+
+  has(value) {
+    const { fp, h } = this._locate(value);
+    for (const layer of this.layers) {
+      if (layer.has(fp, h & layer.mask)) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Remove a value previously added. Deleting a value that was never added
+   * can remove a colliding fingerprint, so callers only delete values the
+   * filter reported and the database confirmed.
+   */
+  delete(value) {
+    const { fp, h } = this._locate(value);
+    for (const layer of this.layers) {
+      if (layer.remove(fp, h & layer.mask)) {
+        this.size -= 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  estimatedFpRate() {
+    // 2 buckets × BUCKET_SIZE slots compared against a 16-bit fingerprint
+    let miss = 1;
+    for (const layer of this.layers) {
+      const load = layer.count / (layer.buckets * BUCKET_SIZE);
+      miss *= 1 - Math.min(1, (2 * BUCKET_SIZE * load) / 65535);
+    }
+    return 1 - miss;
+  }
+
+  byteLength() {
+    return this.layers.reduce((sum, layer) => sum + layer.slots.byteLength, 0);
+  }
+
+  toJSON() {
+    return {
+      kind: 'cuckoo',
+      capacity: this.capacity,
+      size: this.size,
+      layers: this.layers.map((layer) => ({
+        buckets: layer.buckets,
+        count: layer.count,
+        stash: layer.stash,
+        slots: toBase64(layer.slots)
+      }))
+    };
+  }
+
+  static fromJSON(json) {
+    const filter = new CuckooFilter({ capacity: json.capacity });
+    filter.layers = json.layers.map((entry) => {
+      const layer = new CuckooLayer(0, fromBase64(entry.slots, Uint16Array), entry.buckets);
+      layer.count = entry.count;
+      layer.stash = Array.isArray(entry.stash) ? entry.stash : [];
+      return layer;
+    });
+    filter.size = json.size || 0;
+    return filter;
+  }
+}
+
+/**
+ * Restore either variant from its toJSON() form.
+ */
+function seenFilterFromJSON(json) {
+  if (!json || !Array.isArray(json.layers)) {
+    throw new Error('seenFilterFromJSON requires a serialized filter');
+  }
+  if (json.kind === 'cuckoo') return CuckooFilter.fromJSON(json);
+  if (json.kind === 'bloom') return BloomFilter.fromJSON(json);
+  throw new Error(`Unknown seen filter kind: ${json.kind}`);
+}
+
+module.exports = { BloomFilter, CuckooFilter, seenFilterFromJSON, hash32 };
@@ -0,0 +1,327 @@
+'use strict';
+
+const zlib = require('zlib');
+const { Readable, pipeline } = require('stream');
+
+const DEFAULT_MAX_ENTRY_BYTES = 1024 * 1024;
+const PARTIAL_TAG_BYTES = 16;
+const LT = 60; // '<'
+const EMPTY = Buffer.alloc(0);
+
+const KIND_URL = 'url';
+const KIND_SITEMAP = 'sitemap';
+
+const URL_CLOSE = Buffer.from('</url>');
+const SITEMAP_CLOSE = Buffer.from('</sitemap>');
+const FIELDS = {
+  loc: [Buffer.from('<loc>'), Buffer.from('</loc>')],
+  lastmod: [Buffer.from('<lastmod>'), Buffer.from('</lastmod>')],
+  changefreq: [Buffer.from('<changefreq>'), Buffer.from('</changefreq>')],
+  priority: [Buffer.from('<priority>'), Buffer.from('</priority>')],
+  news: [Buffer.from('<news:news>'), Buffer.from('</news:news>')],
+  publicationDate: [Buffer.from('<news:publication_date>'), Buffer.from('</news:publication_date>')],
+  title: [Buffer.from('<news:title>'), Buffer.from('</news:title>')]
+};
+
+const XML_ENTITIES = { amp: '&', lt: '<', gt: '>', quot: '"', apos: "'" };
+
+function decodeXml(text) {
+  const value = text.trim();
+  if (value.startsWith('<![CDATA[') && value.endsWith(']]>')) {
+    return value.slice(9, -3).trim();
+  }
+  if (!value.includes('&')) return value;
+  return value.replace(/&(#x[0-9a-f]+|#\d+|[a-z]+);/gi, (match, entity) => {
+    if (entity[0] === '#') {
+      const code = entity[1] === 'x' || entity[1] === 'X' ? parseInt(entity.slice(2), 16) : parseInt(entity.slice(1), 10);
+      return Number.isFinite(code) ? String.fromCodePoint(code) : match;
+    }
+    return XML_ENTITIES[entity.toLowerCase()] ?? match;
+  });
+}
+
+function isNameEnd(byte) {
+  // '>', '/', space, tab, CR, LF
+  return byte === 62 || byte === 47 || byte === 32 || byte === 9 || byte === 13 || byte === 10;
+}
+
+function matchesName(buf, at, name) {
+  if (at + name.length >= buf.length) return false;
+  for (let i = 0; i < name.length; i++) {
+    if (buf[at + i] !== name.charCodeAt(i)) return false;
+  }
+  return isNameEnd(buf[at + name.length]);
+}
+
+function toSinceMs(value) {
+  if (value == null || value === '') return null;
+  if (value instanceof Date) return value.getTime();
+  const ms = typeof value === 'number' ? value : Date.parse(value);
+  return Number.isFinite(ms) ? ms : null;
+}
+
+/**
+ * SitemapStreamParser — incremental scanner for sitemap and sitemap-index XML
+ *
+ * Works on raw bytes: each write() scans for complete `<url>…</url>` and
+ * `<sitemap>…</sitemap>` blocks, extracts the handful of fields the crawler
+ * uses and keeps only the unfinished tail for the next chunk, so memory is
+ * bounded by the largest single entry (`maxEntryBytes`) rather than the
+ * document. It is deliberately tolerant: anything outside those blocks is
+ * skipped without validation, and a stream can start mid-document (resume).
+ *
+ * `offset` is the absolute byte position just past the last complete entry;
+ * feeding the same document again from that offset continues with the next
+ * entry.
+ */
+class SitemapStreamParser {
+  /**
+   * @param {Object} [options]
+   * @param {Date|string|number} [options.lastmodSince] - Drop entries whose lastmod is older
+   * @param {number} [options.maxEntryBytes=1MB] - Longest entry kept; longer ones are skipped
+   * @param {number} [options.baseOffset=0] - Absolute offset of the first byte written
+   */
+  constructor(options = {}) {
+    this.sinceMs = toSinceMs(options.lastmodSince);
+    this.maxEntryBytes = Math.max(1024, options.maxEntryBytes || DEFAULT_MAX_ENTRY_BYTES);
+    this.offset = Math.max(0, options.baseOffset || 0);
+    this._carry = EMPTY;
+    this._carryStart = this.offset;
+    this._kind = null;
+    this.stats = { urls: 0, sitemaps: 0, filtered: 0, oversized: 0 };
+  }
+
+  /**
+   * @param {Buffer} chunk
+   * @returns {Array<{kind: 'url'|'sitemap', loc: string, lastmod?: string, changefreq?: string, priority?: number, isNews?: boolean, publicationDate?: string, title?: string}>}
+   */
+  write(chunk) {
+    const buf = this._carry.length > 0 ? Buffer.concat([this._carry, chunk]) : chunk;
+    const bufStart = this._carryStart;
+    const entries = [];
+    let pos = 0;
+    let keepFrom = -1;
+
+    while (pos < buf.length) {
+      const open = this._findOpen(buf, pos);
+      if (open === -1) break;
+      if (open < -1) {
+        keepFrom = -open - 2;
+        break;
+      }
+      const kind = this._kind;
+      const close = buf.indexOf(kind === KIND_URL ? URL_CLOSE : SITEMAP_CLOSE, open);
+      if (close === -1) {
+        keepFrom = open;
+        break;
+      }
+      const end = close + (kind === KIND_URL ? URL_CLOSE.length : SITEMAP_CLOSE.length);
+      const entry = this._parseEntry(buf, open, close, kind);
+      if (entry) entries.push(entry);
+      pos = end;
+      this.offset = bufStart + end;
+    }
+
+    if (keepFrom === -1) keepFrom = Math.max(pos, buf.length - PARTIAL_TAG_BYTES);
+    if (buf.length - keepFrom > this.maxEntryBytes) {
+      // One entry bigger than the cap: drop it and resync on the next block
+      this.stats.oversized += 1;
+      keepFrom = buf.length;
+      this.offset = bufStart + buf.length;
+    }
+    this._carry = keepFrom < buf.length ? Buffer.from(buf.subarray(keepFrom)) : EMPTY;
+    this._carryStart = bufStart + keepFrom;
+    return entries;
+  }
+
+  /**
+   * Index of the next `<url>`/`<sitemap>` opening tag (setting this._kind),
+   * -1 when there is none, or -(index + 2) when the buffer ends inside a tag
+   * name that still needs more bytes.
+   */
+  _findOpen(buf, from) {
+    let i = buf.indexOf(LT, from);
+    while (i !== -1) {
+      if (matchesName(buf, i + 1, KIND_URL)) {
+        this._kind = KIND_URL;
+        return i;
+      }
+      if (matchesName(buf, i + 1, KIND_SITEMAP)) {
+        this._kind = KIND_SITEMAP;
+        return i;
+      }
+      if (i + 1 + KIND_SITEMAP.length >= buf.length) return -(i + 2);
+      i = buf.indexOf(LT, i + 1);
+    }
+    return -1;
+  }
+
+  _field(buf, start, end, name) {
+    const [openTag, closeTag] = FIELDS[name];
+    const s = buf.indexOf(openTag, start);
+    if (s === -1 || s >= end) return null;
+    const e = buf.indexOf(closeTag, s + openTag.length);
+    if (e === -1 || e > end) return null;
+    return decodeXml(buf.toString('utf8', s + openTag.length, e));
+  }
+
+  _parseEntry(buf, start, end, kind) {
+    const loc = this._field(buf, start, end, 'loc');
+    if (!loc) return null;
+    const entry = { kind, loc };
+    const lastmod = this._field(buf, start, end, 'lastmod');
+    if (lastmod) {
+      entry.lastmod = lastmod;
+      if (this.sinceMs != null) {
+        const ms = Date.parse(lastmod);
+        if (Number.isFinite(ms) && ms < this.sinceMs) {
+          this.stats.filtered += 1;
+          return null;
+        }
+      }
+    }
+    if (kind === KIND_SITEMAP) {
+      this.stats.sitemaps += 1;
+      return entry;
+    }
+    const changefreq = this._field(buf, start, end, 'changefreq');
+    if (changefreq) entry.changefreq = changefreq;
+    const priority = this._field(buf, start, end, 'priority');
+    if (priority) {
+      const n = Number(priority);
+      entry.priority = Number.isFinite(n) ? n : priority;
+    }
+    const news = buf.indexOf(FIELDS.news[0], start);
+    if (news !== -1 && news < end) {
+      entry.isNews = true;
+      const publicationDate = this._field(buf, start, end, 'publicationDate');
+      if (publicationDate) entry.publicationDate = publicationDate;
+      const title = this._field(buf, start, end, 'title');
+      if (title) entry.title = title;
+    }
+    this.stats.urls += 1;
+    return entry;
+  }
+}
+
+function toBuffer(chunk) {
+  if (Buffer.isBuffer(chunk)) return chunk;
+  if (typeof chunk === 'string') return Buffer.from(chunk, 'utf8');
+  return Buffer.from(chunk.buffer, chunk.byteOffset, chunk.byteLength);
+}
+
+/**
+ * Body chunks of a fetch-like response (web or Node stream), falling back to
+ * text() for doubles and buffered responses.
+ * @returns {AsyncIterable<Buffer>}
+ */
+async function* responseChunks(response) {
+  const body = response && response.body;
+  if (body && typeof body[Symbol.asyncIterator] === 'function') {
+    for await (const chunk of body) yield toBuffer(chunk);
+    return;
+  }
+  const text = typeof response?.text === 'function' ? await response.text() : null;
+  if (text) yield toBuffer(text);
+}
+
+/**
+ * Pass chunks through gunzip when the stream starts with the gzip magic
+ * bytes (.xml.gz files served as application/x-gzip; transfer-encoded gzip
+ * is already decoded by fetch).
+ * @param {AsyncIterable<Buffer>|Iterable<Buffer>} chunks
+ * @returns {AsyncIterable<Buffer>}
+ */
+async function* gunzipIfNeeded(chunks) {
+  const iterator = typeof chunks[Symbol.asyncIterator] === 'function'
+    ? chunks[Symbol.asyncIterator]()
+    : chunks[Symbol.iterator]();
+  const first = await iterator.next();
+  if (first.done) return;
+  const head = toBuffer(first.value);
+  const rest = {
+    [Symbol.asyncIterator]() {
+      return {
+        next: async () => iterator.next(),
+        return: async (value) => (typeof iterator.return === 'function' ? iterator.return(value) : { done: true, value })
+      };
+    }
+  };
+  if (!(head.length >= 2 && head[0] === 0x1f && head[1] === 0x8b)) {
+    yield head;
+    yield* rest;
+    return;
+  }
+  async function* compressed() {
+    yield head;
+    yield* rest;
+  }
+  const gunzip = zlib.createGunzip();
+  pipeline(Readable.from(compressed()), gunzip, () => {});
+  for await (const chunk of gunzip) yield chunk;
+}
+
+/**
+ * Stream a sitemap through SitemapStreamParser.
+ *
+ * `onEntries(entries, offset)` is awaited after every chunk that produced
+ * entries (backpressure for the caller's enqueue); returning false stops
+ * the read. With `resumeOffset`, bytes before it are skipped without being
+ * parsed; with `baseOffset` the stream itself starts there (HTTP 206).
+ *
+ * @param {AsyncIterable<Buffer|Uint8Array|string>|Iterable<Buffer>} chunks
+ * @param {Object} [options]
+ * @param {Function} options.onEntries
+ * @param {Date|string|number} [options.lastmodSince]
+ * @param {number} [options.resumeOffset=0]
+ * @param {number} [options.baseOffset=0]
+ * @param {number} [options.maxEntryBytes]
+ * @param {number} [options.retainBodyBytes=0] - Keep the decoded body when it is at most this big
+ * @returns {Promise<{bytes: number, offset: number, complete: boolean, body: string|null, stats: Object}>}
+ */
+async function readSitemapStream(chunks, options = {}) {
+  const resumeOffset = Math.max(0, options.resumeOffset || 0);
+  const baseOffset = Math.max(0, options.baseOffset || 0);
+  const parser = new SitemapStreamParser({
+    lastmodSince: options.lastmodSince,
+    maxEntryBytes: options.maxEntryBytes,
+    baseOffset: Math.max(baseOffset, resumeOffset)
+  });
+  let retained = options.retainBodyBytes > 0 && resumeOffset === 0 && baseOffset === 0 ? [] : null;
+  let position = baseOffset;
+  let complete = true;
+
+  for await (const decoded of gunzipIfNeeded(chunks)) {
+    let chunk = decoded;
+    const chunkStart = position;
+    position += chunk.length;
+    if (retained) {
+      if (position > options.retainBodyBytes) retained = null;
+      else retained.push(chunk);
+    }
+    if (position <= resumeOffset) continue;
+    if (chunkStart < resumeOffset) chunk = chunk.subarray(resumeOffset - chunkStart);
+
+    const entries = parser.write(chunk);
+    if (entries.length > 0 && (await options.onEntries(entries, parser.offset)) === false) {
+      complete = false;
+      break;
+    }
+  }
+
+  return {
+    bytes: position - baseOffset,
+    offset: parser.offset,
+    complete,
+    body: retained && complete ? Buffer.concat(retained).toString('utf8') : null,
+    stats: parser.stats
+  };
+}
+
+module.exports = {
+  SitemapStreamParser,
+  readSitemapStream,
+  responseChunks,
+  gunzipIfNeeded,
+  decodeXml
+};
@@ -0,0 +1,337 @@
+'use strict';
+
+const zlib = require('zlib');
+const { PassThrough } = require('stream');
+
+const HEAD_SNIFF_LIMIT = 64 * 1024;
+
+const DEFAULT_BYTE_CAPS = Object.freeze({
+  article: 5 * 1024 * 1024,
+  hub: 3 * 1024 * 1024,
+  xml: 10 * 1024 * 1024,
+  other: 2 * 1024 * 1024
+});
+
+const BINARY_CONTENT_TYPE_RE = /^(image|audio|video|font)\/|^application\/(pdf|zip|gzip|x-gzip|x-tar|x-7z-compressed|x-rar-compressed|octet-stream|msword|vnd\.|x-shockwave-flash|wasm)/i;
+const XML_CONTENT_TYPE_RE = /(^|\/|\+)(xml|rss|atom)\b/i;
+const ARTICLE_LD_TYPES = new Set(['article', 'newsarticle', 'reportagenewsarticle', 'analysisnewsarticle', 'opinionnewsarticle', 'blogposting', 'liveblogposting', 'report']);
+
+/**
+ * Streaming response body reader for FetchPipeline.
+ *
+ * Reads a fetch-like response chunk by chunk instead of `await res.text()`:
+ * - the `<head>` is sniffed as soon as it has arrived (canonical, og:type,
+ *   JSON-LD @type) and handed to `onHead`, which may stop the transfer or
+ *   switch the byte cap to the page's real type;
+ * - once `byteCap` bytes have been read the rest of the body is dropped and
+ *   the result is flagged `truncated`. The prefix is enough for link
+ *   discovery, but callers must not store it as the page;
+ * - when `signal` aborts (the request timeout) the body stream is destroyed,
+ *   so a server that trickles bytes cannot hold the fetch open.
+ *
+ * Responses without a readable `body` (test doubles, cached responses) fall
+ * back to `text()` with the same cap and sniffing applied afterwards.
+ *
+ * @param {Object} response - fetch-like response
+ * @param {Object} [options]
+ * @param {number} [options.byteCap] - Max body bytes kept (default: unlimited)
+ * @param {(head: Object) => ({abortReason?: string, byteCap?: number}|null)} [options.onHead]
+ * @param {() => void} [options.abort] - Called when the transfer is cut short
+ * @param {AbortSignal} [options.signal] - Aborts the body read (rejects with an AbortError)
+ * @returns {Promise<{html: string, bytes: number, truncated: boolean, abortReason: string|null, head: Object|null}>}
+ */
+async function readBodyStreaming(response, { byteCap = Infinity, onHead = null, abort = null, signal = null } = {}) {
+  const body = response && response.body;
+  if (!body || typeof body[Symbol.asyncIterator] !== 'function') {
+    return readBufferedBody(response, { byteCap, onHead });
+  }
+  if (signal && signal.aborted) throw createAbortError();
+  const onAbort = () => {
+    if (typeof body.destroy === 'function') body.destroy(createAbortError());
+  };
+  if (signal) signal.addEventListener('abort', onAbort, { once: true });
+  try {
+    return await readBodyChunks(response, body, { byteCap, onHead, abort });
+  } catch (error) {
+    if (signal && signal.aborted) throw createAbortError();
+    throw error;
+  } finally {
+    if (signal) signal.removeEventListener('abort', onAbort);
+  }
+}
+
+function createAbortError() {
+  const error = new Error('Response body read aborted (request timeout)');
+  error.name = 'AbortError';
+  return error;
+}
+
+async function readBodyChunks(response, body, { byteCap, onHead, abort }) {
+
+  const decoder = new TextDecoder('utf-8');
+  const parts = [];
+  let cap = byteCap;
+  let bytes = 0;
+  let truncated = false;
+  let abortReason = null;
+  let head = null;
+  let sniffText = '';
+
+  for await (const chunk of body) {
+    let view = typeof chunk === 'string' ? Buffer.from(chunk) : chunk;
+    if (bytes + view.byteLength > cap) {
+      view = view.subarray(0, Math.max(0, cap - bytes));
+      truncated = true;
+    }
+    bytes += view.byteLength;
+    const text = decoder.decode(view, { stream: !truncated });
+    parts.push(text);
+
+    if (!head && onHead) {
+      sniffText += text;
+      if (headComplete(sniffText) || truncated) {
+        head = sniffHeadMetadata(sniffText);
+        sniffText = '';
+        const verdict = safeVerdict(onHead, head);
+        if (verdict && verdict.abortReason) {
+          abortReason = verdict.abortReason;
+          break;
+        }
+        if (verdict && Number.isFinite(verdict.byteCap) && verdict.byteCap > 0) {
+          cap = verdict.byteCap;
+          if (bytes > cap) {
+            truncated = true;
+          }
+        }
+      }
+    }
+    if (truncated) break;
+  }
+
+  if (abortReason || truncated) {
+    discardBody(response);
+    if (typeof abort === 'function') {
+      try { abort(); } catch (_) { /* already closed */ }
+    }
+  } else {
+    parts.push(decoder.decode());
+  }
+
+  if (!head && onHead && !abortReason) {
+    head = sniffHeadMetadata(parts.join(''));
+    const verdict = safeVerdict(onHead, head);
+    if (verdict && verdict.abortReason) abortReason = verdict.abortReason;
+  }
+
+  let html = abortReason ? '' : parts.join('');
+  if (truncated && html && Buffer.byteLength(html, 'utf8') > cap) {
+    // onHead lowered the cap below what had already been read
+    html = Buffer.from(html, 'utf8').subarray(0, cap).toString('utf8');
+  }
+  return { html, bytes, truncated, abortReason, head };
+}
+
+async function readBufferedBody(response, { byteCap, onHead }) {
+  let html = await response.text();
+  let bytes = Buffer.byteLength(html, 'utf8');
+  let truncated = false;
+  let abortReason = null;
+  let head = null;
+  let cap = byteCap;
+  if (onHead) {
+    head = sniffHeadMetadata(html.length > HEAD_SNIFF_LIMIT ? html.slice(0, HEAD_SNIFF_LIMIT) : html);
+    const verdict = safeVerdict(onHead, head);
+    if (verdict && verdict.abortReason) abortReason = verdict.abortReason;
+    if (verdict && Number.isFinite(verdict.byteCap) && verdict.byteCap > 0) cap = verdict.byteCap;
+  }
+  if (!abortReason && bytes > cap) {
+    html = Buffer.from(html, 'utf8').subarray(0, cap).toString('utf8');
+    bytes = cap;
+    truncated = true;
+  }
+  return { html: abortReason ? '' : html, bytes, truncated, abortReason, head };
+}
+
+function safeVerdict(onHead, head) {
+  try {
+    return onHead(head) || null;
+  } catch (_) {
+    return null;
+  }
+}
+
+function headComplete(text) {
+  if (text.length >= HEAD_SNIFF_LIMIT) return true;
+  return /<\/head\s*>|<body[\s>]/i.test(text);
+}
+
+/**
+ * Extract the metadata FetchPipeline needs to decide about a page from the
+ * start of its HTML. Regex based on purpose: it runs on a partial document.
+ * @param {string} html
+ * @returns {{canonical: string|null, ogType: string|null, jsonLdTypes: string[], looksLikeArticle: boolean}}
+ */
+function sniffHeadMetadata(html) {
+  const text = typeof html === 'string' ? html.slice(0, HEAD_SNIFF_LIMIT) : '';
+  let canonical = null;
+  let ogType = null;
+
+  const linkRe = /<link\b[^>]*>/gi;
+  for (let match = linkRe.exec(text); match; match = linkRe.exec(text)) {
+    const rel = readAttr(match[0], 'rel');
+    if (rel && rel.toLowerCase().split(/\s+/).includes('canonical')) {
+      canonical = readAttr(match[0], 'href');
+      if (canonical) break;
+    }
+  }
+
+  const metaRe = /<meta\b[^>]*>/gi;
+  for (let match = metaRe.exec(text); match; match = metaRe.exec(text)) {
+    const property = readAttr(match[0], 'property') || readAttr(match[0], 'name');
+    if (property && property.toLowerCase() === 'og:type') {
+      ogType = (readAttr(match[0], 'content') || '').trim().toLowerCase() || null;
+      if (ogType) break;
+    }
+  }
+
+  const jsonLdTypes = [];
+  const ldRe = /<script\b[^>]*type\s*=\s*["']?application\/ld\+json["']?[^>]*>([\s\S]*?)(?:<\/script>|$)/gi;
+  for (let match = ldRe.exec(text); match; match = ldRe.exec(text)) {
+    collectLdTypes(match[1], jsonLdTypes);
+  }
+
+  const looksLikeArticle = (ogType === 'article')
+    || jsonLdTypes.some((type) => ARTICLE_LD_TYPES.has(type.toLowerCase()));
+
+  return { canonical, ogType, jsonLdTypes, looksLikeArticle };
+}
+
+function collectLdTypes(raw, out) {
+  let parsed = null;
+  try {
+    parsed = JSON.parse(raw.trim());
+  } catch (_) {
+    // Malformed or cut-off JSON-LD; pick the @type values out directly
+    const typeRe = /"@type"\s*:\s*"([^"]+)"/g;
+    for (let match = typeRe.exec(raw); match; match = typeRe.exec(raw)) pushUnique(out, match[1]);
+    return;
+  }
+  const visit = (node) => {
+    if (!node || typeof node !== 'object') return;
+    if (Array.isArray(node)) {
+      node.forEach(visit);
+      return;
+    }
+    const type = node['@type'];
+    if (Array.isArray(type)) type.forEach((t) => typeof t === 'string' && pushUnique(out, t));
+    else if (typeof type === 'string') pushUnique(out, type);
+    if (node['@graph']) visit(node['@graph']);
+  };
+  visit(parsed);
+}
+
+function pushUnique(list, value) {
+  if (!list.includes(value)) list.push(value);
+}
+
+function readAttr(tag, name) {
+  const re = new RegExp(`\\s${name}\\s*=\\s*(?:"([^"]*)"|'([^']*)'|([^\\s"'>]+))`, 'i');
+  const match = re.exec(tag);
+  if (!match) return null;
+  return decodeEntities(match[1] ?? match[2] ?? match[3] ?? '');
+}
+
+function decodeEntities(value) {
+  return value.replace(/&amp;/g, '&').replace(/&quot;/g, '"').replace(/&#39;/g, "'");
+}
+
+/**
+ * Classify a content type for byte caps: 'binary' (never worth reading),
+ * 'xml', 'html' or 'other'.
+ */
+function classifyContentType(contentType) {
+  const value = String(contentType || '').split(';')[0].trim().toLowerCase();
+  if (!value) return 'html'; // servers that omit it are almost always serving HTML
+  if (value.includes('html')) return 'html';
+  if (BINARY_CONTENT_TYPE_RE.test(value)) return 'binary';
+  if (XML_CONTENT_TYPE_RE.test(value)) return 'xml';
+  return 'other';
+}
+
+/**
+ * Byte cap for a response given its content type and (for HTML) whether it
+ * is believed to be an article. Caps are opt-in: without a caps object the
+ * body is read in full; with one, unset types use DEFAULT_BYTE_CAPS.
+ */
+function resolveByteCap(caps, { contentKind, isArticle }) {
+  if (!caps) return Infinity;
+  const key = contentKind === 'html' ? (isArticle ? 'article' : 'hub') : (contentKind === 'xml' ? 'xml' : 'other');
+  const override = Number(caps[key]);
+  return Number.isFinite(override) && override > 0 ? override : DEFAULT_BYTE_CAPS[key];
+}
+
+/**
+ * Wrap a raw Node response stream in the decoder matching its
+ * Content-Encoding (gzip, deflate, br). Unknown encodings pass through.
+ * @param {import('stream').Readable} stream
+ * @param {string|null} encoding
+ * @returns {import('stream').Readable}
+ */
+function createDecodedStream(stream, encoding) {
+  const value = String(encoding || '').trim().toLowerCase();
+  let decoder = null;
+  if (value === 'gzip' || value === 'x-gzip') decoder = zlib.createGunzip();
+  else if (value === 'deflate') decoder = zlib.createInflate();
+  else if (value === 'br') decoder = zlib.createBrotliDecompress();
+  if (!decoder) return stream;
+  const out = new PassThrough();
+  stream.on('error', (err) => out.destroy(err));
+  decoder.on('error', (err) => out.destroy(err));
+  out.on('close', () => {
+    if (!stream.destroyed) stream.destroy();
+  });
+  return stream.pipe(decoder).pipe(out);
+}
+
+/**
+ * Drop an unread (or partly read) body without letting a late socket error
+ * surface as an unhandled 'error' event.
+ */
+function discardBody(response) {
+  const body = response && response.body;
+  if (!body) return;
+  try {
+    if (typeof body.on === 'function') {
+      body.on('error', () => {});
+      if (typeof body.destroy === 'function') body.destroy();
+    } else if (typeof body.cancel === 'function') {
+      body.cancel().catch(() => {});
+    }
+  } catch (_) {
+    // Already closed
+  }
+}
+
+/**
+ * Collect a Node readable into a UTF-8 string (the `text()` of the
+ * built-in transports).
+ */
+async function readStreamText(stream) {
+  const chunks = [];
+  for await (const chunk of stream) {
+    chunks.push(typeof chunk === 'string' ? Buffer.from(chunk) : chunk);
+  }
+  return Buffer.concat(chunks).toString('utf8');
+}
+
+module.exports = {
+  readBodyStreaming,
+  sniffHeadMetadata,
+  classifyContentType,
+  resolveByteCap,
+  createDecodedStream,
+  readStreamText,
+  discardBody,
+  DEFAULT_BYTE_CAPS,
+  HEAD_SNIFF_LIMIT
+};
@@ -5,6 +5,8 @@ const {
   isUrlSuccessfullyProcessedWithContent,
   getLatestFetchForUrl
 } = require('news-crawler-db');
+const { iterateProcessedUrls } = require('../../data/db/sqlite/queries/processedUrls');
+const { BloomFilter, CuckooFilter, seenFilterFromJSON } = require('./SeenUrlFilter');
 
 const ACQUISITION_KINDS = new Set(['article', 'refresh', 'history']);
 
@@ -21,7 +23,8 @@ class UrlEligibilityService {
       getDbAdapter,
       maxAgeHubMs,
       maxAgeArticleMs,
-      urlDecisionOrchestrator
+      urlDecisionOrchestrator,
+      seenFilter
     } = options;
     if (typeof getUrlDecision !== 'function') {
       throw new Error('UrlEligibilityService requires getUrlDecision function');
@@ -46,6 +49,126 @@ class UrlEligibilityService {
     this.maxAgeHubMs = Number.isFinite(maxAgeHubMs) && maxAgeHubMs >= 0 ? maxAgeHubMs : null;
     this.maxAgeArticleMs = Number.isFinite(maxAgeArticleMs) && maxAgeArticleMs >= 0 ? maxAgeArticleMs : null;
     this.urlDecisionOrchestrator = urlDecisionOrchestrator || null;
+
+    // Seen-set in front of the already-processed lookups. Until it has been
+    // warmed from the database a miss proves nothing, so it is not consulted.
+    this.seenFilter = this._createSeenFilter(seenFilter);
+    const warmLimit = seenFilter && typeof seenFilter === 'object' ? seenFilter.warmLimit : null;
+    this._seenFilterWarmLimit = Number.isFinite(warmLimit) && warmLimit > 0 ? Math.floor(warmLimit) : null;
+    this._seenFilterReady = false;
+    this._seenFilterSince = null;
+    this._seenFilterStats = { warmed: 0, warmMs: null, lookups: 0, skipped: 0, hits: 0, confirmed: 0, falsePositives: 0, expired: 0, truncated: false };
+  }
+
+  _createSeenFilter(spec) {
+    if (!spec || spec === 'off') return null;
+    if (typeof spec === 'object' && typeof spec.has === 'function') return spec;
+    const options = typeof spec === 'object' ? spec : {};
+    const kind = typeof spec === 'string' ? spec : (options.kind || 'auto');
+    // Recrawl windows make stored URLs stale again; only the cuckoo filter can forget them
+    const wantsDeletes = this.maxAgeHubMs != null || this.maxAgeArticleMs != null;
+    if (kind === 'cuckoo' || (kind === 'auto' && wantsDeletes)) {
+      return new CuckooFilter({ capacity: options.capacity });
+    }
+    return new BloomFilter({ capacity: options.capacity, fpRate: options.fpRate });
+  }
+
+  /**
+   * Load every URL the database already holds content for into the seen-set.
+   * Only after this succeeds does a filter miss skip the database lookup.
+   * The scan stops at the warm limit; a truncated warm-up leaves the filter
+   * unready so lookups keep going to the database.
+   * @param {Object} [options]
+   * @param {string} [options.host] - Restrict to one host (the crawl domain)
+   * @param {string} [options.since] - Only rows fetched at/after this ISO time (top-up after a checkpoint restore)
+   * @returns {number} URLs added
+   */
+  warmSeenFilter({ host = null, since = this._seenFilterSince } = {}) {
+    if (!this.seenFilter) return 0;
+    const adapter = this.getDbAdapter ? this.getDbAdapter() : null;
+    if (!adapter || !adapter.isEnabled || !adapter.isEnabled()) return 0;
+    const started = Date.now();
+    let added = 0;
+    this._seenFilterStats.truncated = false;
+    try {
+      const handle = adapter.getDb ? adapter.getDb() : null;
+      const db = handle && typeof handle.prepare !== 'function' && handle.db ? handle.db : handle;
+      if (!db || typeof db.prepare !== 'function') return 0;
+      const limit = this._seenFilterWarmLimit;
+      for (const row of iterateProcessedUrls(db, { host, since, limit: limit ? limit + 1 : null })) {
+        if (limit && added >= limit) {
+          this._seenFilterStats.truncated = true;
+          break;
+        }
+        this.seenFilter.add(row.url);
+        added += 1;
+      }
+      this._seenFilterReady = !this._seenFilterStats.truncated;
+    } catch (_) {
+      // Schema without urls/http_responses: keep consulting the database
+      this._seenFilterReady = false;
+    }
+    this._seenFilterStats.warmed += added;
+    this._seenFilterStats.warmMs = Date.now() - started;
+    return added;
+  }
+
+  /**
+   * Record a URL fetched with stored content during this crawl.
+   */
+  noteProcessed(normalized) {
+    if (this.seenFilter && normalized) this.seenFilter.add(normalized);
+  }
+
+  /**
+   * Serialize the seen-set for a checkpoint.
+   * @param {Iterable<string>} [visitedUrls] - URLs handled this session (folded in so a resumed crawl skips them too)
+   */
+  exportSeenFilter(visitedUrls = null) {
+    if (!this.seenFilter || !this._seenFilterReady) return null;
+    if (visitedUrls && typeof visitedUrls[Symbol.iterator] === 'function') {
+      for (const url of visitedUrls) this.noteProcessed(url);
+    }
+    return { savedAt: new Date().toISOString(), filter: this.seenFilter.toJSON() };
+  }
+
+  /**
+   * Restore a checkpointed seen-set. Rows fetched after the checkpoint are
+   * topped up from the database immediately, or on the next warmSeenFilter().
+   */
+  importSeenFilter(snapshot, { host = null } = {}) {
+    if (!snapshot || !snapshot.filter) return false;
+    try {
+      this.seenFilter = seenFilterFromJSON(snapshot.filter);
+    } catch (_) {
+      return false;
+    }
+    this._seenFilterReady = false;
+    this._seenFilterSince = snapshot.savedAt || null;
+    this.warmSeenFilter({ host, since: this._seenFilterSince });
+    return true;
+  }
+
+  getSeenFilterStats() {
+    if (!this.seenFilter) return null;
+    const stats = this._seenFilterStats;
+    return {
+      kind: this.seenFilter.kind,
+      ready: this._seenFilterReady,
+      items: this.seenFilter.size,
+      bytes: this.seenFilter.byteLength(),
+      warmed: stats.warmed,
+      warmMs: stats.warmMs,
+      warmTruncated: stats.truncated,
+      lookups: stats.lookups,
+      dbLookupsSkipped: stats.skipped,
+      savingsRate: stats.lookups ? Number((stats.skipped / stats.lookups).toFixed(3)) : null,
+      filterHits: stats.hits,
+      falsePositives: stats.falsePositives,
+      observedFpRate: stats.hits ? Number((stats.falsePositives / stats.hits).toFixed(4)) : null,
+      estimatedFpRate: Number(this.seenFilter.estimatedFpRate().toFixed(5)),
+      expired: stats.expired
+    };
   }
 
   evaluate({ url, depth = 0, type, queueSize = 0, isDuplicate }) {
@@ -255,6 +378,18 @@ class UrlEligibilityService {
       return false;
     }
 
+    const filtered = this._seenFilterReady;
+    if (filtered) {
+      const stats = this._seenFilterStats;
+      stats.lookups += 1;
+      if (!this.seenFilter.has(normalized)) {
+        // Definitely never stored: no database round trip
+        stats.skipped += 1;
+        return false;
+      }
+      stats.hits += 1;
+    }
+
     try {
       // Check if URL has successful HTTP response with content storage
       const db = adapter.getDb ? adapter.getDb() : null;
@@ -263,17 +398,35 @@ class UrlEligibilityService {
       if (ageWindowMs != null) {
         const latestRow = this._getLatestFetch(db, normalized);
         if (!this._isFetchFresh(latestRow, ageWindowMs)) {
+          if (filtered) this._onSeenFilterMiss(normalized, latestRow);
           return false;
         }
       }
 
-      return isUrlSuccessfullyProcessedWithContent(db, normalized);
+      const processed = isUrlSuccessfullyProcessedWithContent(db, normalized);
+      if (filtered) {
+        if (processed) this._seenFilterStats.confirmed += 1;
+        else this._onSeenFilterMiss(normalized, null);
+      }
+      return processed;
     } catch (error) {
       // If database check fails, err on the side of processing (don't block potentially valid URLs)
       return false;
     }
   }
 
+  _onSeenFilterMiss(normalized, latestRow) {
+    if (!latestRow) {
+      this._seenFilterStats.falsePositives += 1;
+      return;
+    }
+    // Stored but outside the recrawl window: forget it so later sightings
+    // skip the database (Bloom filters cannot, and keep paying the lookup)
+    if (typeof this.seenFilter.delete === 'function' && this.seenFilter.delete(normalized)) {
+      this._seenFilterStats.expired += 1;
+    }
+  }
+
   _getLatestFetch(db, normalized) {
     if (!db || !normalized) {
       return null;
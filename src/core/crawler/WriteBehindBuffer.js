@@ -0,0 +1,314 @@
+'use strict';
+
+const EventEmitter = require('events');
+
+const DEFAULT_BUFFERED_METHODS = Object.freeze(['insertFetch', 'insertLink', 'insertHttpResponse', 'upsertArticle']);
+// Reads that must observe buffered writes, plus lifecycle calls
+const DEFAULT_FLUSH_BEFORE = Object.freeze(['close', 'getArticleCount', 'getArticleRowByUrl', 'getArticleHeaders']);
+
+/**
+ * WriteBehindBuffer - groups per-page crawl writes into one SQLite
+ * transaction.
+ *
+ * ArticleProcessor, PageExecutionService and FetchPipeline each write their
+ * fetch, link, article and HTTP-response rows with a separate statement, and
+ * a hub page alone can produce hundreds of link rows. Each autocommit
+ * statement takes the SQLite write lock itself, so the lock was the crawl's
+ * throughput ceiling.
+ *
+ * `wrap()` returns a drop-in adapter. Buffered methods are queued and
+ * replayed against the real adapter inside one `db.transaction()`, either
+ * every `flushIntervalMs` or as soon as `maxRows` are pending. Every other
+ * method passes straight through. Reads that must see pending rows
+ * (DEFAULT_FLUSH_BEFORE) and `close()` flush first.
+ *
+ * Buffered calls return `{deferred: true, onSettled(fn)}` instead of the
+ * target's result. `fn(ok, error)` runs once the row has been committed (or
+ * has failed), so callers that count or cache a save do it on commit rather
+ * than on enqueue.
+ *
+ * Durability: rows are only as durable as the last flush. Callers that
+ * record progress elsewhere flush first. CheckpointManager does this through
+ * `addSaveBarrier(() => buffer.flush('checkpoint'))`, so a checkpoint never
+ * references rows that have not been committed.
+ *
+ * Events:
+ * - 'flush'        { rows, durationMs, reason, failed, queueDepth }
+ * - 'write-failed' { method, url, error }
+ *
+ * @extends EventEmitter
+ */
+class WriteBehindBuffer extends EventEmitter {
+  /**
+   * @param {Object} options
+   * @param {Object} options.target - Adapter whose writes are buffered
+   * @param {Object} [options.db] - better-sqlite3 handle (default: derived from target.getDb())
+   * @param {number} [options.flushIntervalMs=250]
+   * @param {number} [options.maxRows=500] - Pending rows that force a flush
+   * @param {string[]} [options.methods] - Adapter methods to buffer
+   * @param {string[]} [options.flushBefore] - Adapter methods that flush before running
+   */
+  constructor(options = {}) {
+    super();
+    if (!options.target) {
+      throw new Error('WriteBehindBuffer requires a target adapter');
+    }
+    this.target = options.target;
+    this.db = options.db || resolveRawDb(this.target);
+    this.flushIntervalMs = Math.max(10, options.flushIntervalMs || 250);
+    this.maxRows = Math.max(1, options.maxRows || 500);
+    this.methods = new Set(options.methods || DEFAULT_BUFFERED_METHODS);
+    this.flushBefore = new Set(options.flushBefore || DEFAULT_FLUSH_BEFORE);
+
+    this._pending = [];
+    this._flushing = false;
+    this._closed = false;
+    this._runBatch = this.db && typeof this.db.transaction === 'function'
+      ? this.db.transaction((ops) => this._applyAll(ops))
+      : null;
+    this._stats = {
+      enqueued: 0,
+      flushes: 0,
+      rowsFlushed: 0,
+      failedWrites: 0,
+      transactionFailures: 0,
+      maxQueueDepth: 0,
+      lastFlushMs: null,
+      maxFlushMs: 0,
+      totalFlushMs: 0,
+      flushReasons: { interval: 0, size: 0, barrier: 0, read: 0, close: 0 }
+    };
+
+    this._timer = setInterval(() => this.flush('interval'), this.flushIntervalMs);
+    if (typeof this._timer.unref === 'function') this._timer.unref();
+  }
+
+  /**
+   * True when writes will actually be grouped into transactions.
+   */
+  get transactional() {
+    return !!this._runBatch;
+  }
+
+  get queueDepth() {
+    return this._pending.length;
+  }
+
+  /**
+   * Queue one adapter write. Falls through to a direct call once closed.
+   * @returns {*} Placeholder result ({deferred: true, onSettled}) for callers that check truthiness
+   */
+  enqueue(method, args) {
+    if (this._closed) {
+      return this.target[method](...args);
+    }
+    const op = { method, args, listeners: null, settled: null };
+    this._pending.push(op);
+    this._stats.enqueued += 1;
+    if (this._pending.length > this._stats.maxQueueDepth) {
+      this._stats.maxQueueDepth = this._pending.length;
+    }
+    if (this._pending.length >= this.maxRows) {
+      this.flush('size');
+    }
+    return {
+      deferred: true,
+      // A size flush above may already have settled the op
+      onSettled: (listener) => {
+        if (typeof listener !== 'function') return;
+        if (op.settled) {
+          listener(op.settled.ok, op.settled.error);
+          return;
+        }
+        (op.listeners || (op.listeners = [])).push(listener);
+      }
+    };
+  }
+
+  /**
+   * Commit everything pending in one transaction. Synchronous, like the
+   * better-sqlite3 calls it groups.
+   * @param {'interval'|'size'|'barrier'|'read'|'close'|string} [reason='barrier']
+   * @returns {{rows: number, durationMs: number, failed: number}}
+   */
+  flush(reason = 'barrier') {
+    if (this._flushing || this._pending.length === 0) {
+      return { rows: 0, durationMs: 0, failed: 0 };
+    }
+    this._flushing = true;
+    const ops = this._pending;
+    this._pending = [];
+    const started = process.hrtime.bigint();
+    let failures = [];
+    try {
+      if (this._runBatch) {
+        try {
+          failures = this._runBatch(ops);
+        } catch (_) {
+          // BEGIN/COMMIT itself failed (e.g. SQLITE_BUSY). Fall back to
+          // autocommit writes so rows are not lost.
+          this._stats.transactionFailures += 1;
+          failures = this._applyAll(ops);
+        }
+      } else {
+        failures = this._applyAll(ops);
+      }
+    } finally {
+      this._flushing = false;
+    }
+
+    const durationMs = Number(process.hrtime.bigint() - started) / 1e6;
+    const stats = this._stats;
+    stats.flushes += 1;
+    stats.rowsFlushed += ops.length;
+    stats.failedWrites += failures.length;
+    stats.lastFlushMs = Number(durationMs.toFixed(3));
+    stats.totalFlushMs += durationMs;
+    if (durationMs > stats.maxFlushMs) stats.maxFlushMs = Number(durationMs.toFixed(3));
+    stats.flushReasons[reason] = (stats.flushReasons[reason] || 0) + 1;
+
+    const failed = new Map();
+    for (const failure of failures) {
+      this._reportFailure(failure);
+      failed.set(failure.op, failure.error);
+    }
+    for (const op of ops) {
+      if (op.async) continue; // settled when its promise does
+      this._settle(op, !failed.has(op), failed.get(op) || null);
+    }
+    const summary = { rows: ops.length, durationMs: stats.lastFlushMs, failed: failures.length };
+    this.emit('flush', { ...summary, reason, queueDepth: this._pending.length });
+    return summary;
+  }
+
+  /**
+   * Drop-in adapter: buffered methods enqueue, flush-before methods flush,
+   * everything else is the target's own member.
+   */
+  wrap() {
+    const buffer = this;
+    const target = this.target;
+    return new Proxy(target, {
+      get(obj, prop) {
+        if (prop === 'getWriteBehindStats') return () => buffer.getStats();
+        if (prop === 'flushWrites') return (reason) => buffer.flush(reason || 'barrier');
+        if (prop === 'writeBehind') return buffer;
+        const value = obj[prop];
+        if (typeof value !== 'function' || typeof prop !== 'string') return value;
+        if (buffer.methods.has(prop)) {
+          return (...args) => buffer.enqueue(prop, args);
+        }
+        if (buffer.flushBefore.has(prop)) {
+          return (...args) => {
+            if (prop === 'close') {
+              buffer.close();
+            } else {
+              buffer.flush('read');
+            }
+            return value.apply(obj, args);
+          };
+        }
+        return value.bind(obj);
+      }
+    });
+  }
+
+  getStats() {
+    const stats = this._stats;
+    return {
+      transactional: this.transactional,
+      queueDepth: this._pending.length,
+      flushIntervalMs: this.flushIntervalMs,
+      maxRows: this.maxRows,
+      enqueued: stats.enqueued,
+      flushes: stats.flushes,
+      rowsFlushed: stats.rowsFlushed,
+      avgRowsPerFlush: stats.flushes ? Math.round(stats.rowsFlushed / stats.flushes) : null,
+      failedWrites: stats.failedWrites,
+      transactionFailures: stats.transactionFailures,
+      maxQueueDepth: stats.maxQueueDepth,
+      lastFlushMs: stats.lastFlushMs,
+      avgFlushMs: stats.flushes ? Number((stats.totalFlushMs / stats.flushes).toFixed(3)) : null,
+      maxFlushMs: stats.maxFlushMs,
+      flushReasons: { ...stats.flushReasons }
+    };
+  }
+
+  /**
+   * Flush and stop the timer; later writes go straight to the target.
+   */
+  close() {
+    if (this._closed) return;
+    clearInterval(this._timer);
+    this.flush('close');
+    this._closed = true;
+  }
+
+  // Runs inside the transaction. A failing statement is caught so the rest
+  // of the batch still commits; failures are reported after the commit.
+  _applyAll(ops) {
+    const failures = [];
+    for (const op of ops) {
+      try {
+        const result = this.target[op.method](...op.args);
+        if (result && typeof result.then === 'function') {
+          op.async = true;
+          result.then(
+            (value) => this._settle(op, op.method !== 'upsertArticle' || !!value, null),
+            (error) => {
+              this._reportFailure({ op, error });
+              this._settle(op, false, error);
+            }
+          );
+        } else if (op.method === 'upsertArticle' && !result) {
+          failures.push({ op, error: new Error('upsertArticle returned no result') });
+        }
+      } catch (error) {
+        failures.push({ op, error });
+      }
+    }
+    return failures;
+  }
+
+  _settle(op, ok, error) {
+    if (op.settled) return;
+    op.settled = { ok, error };
+    const listeners = op.listeners;
+    op.listeners = null;
+    if (!listeners) return;
+    for (const listener of listeners) {
+      try {
+        listener(ok, error);
+      } catch (_) {
+        // A caller's bookkeeping must not break the flush
+      }
+    }
+  }
+
+  _reportFailure({ op, error }) {
+    const payload = op.args && op.args[0];
+    const url = payload && (payload.url || payload.src_url) ? (payload.url || payload.src_url) : null;
+    this.emit('write-failed', { method: op.method, url, error });
+    if (op.method === 'upsertArticle' && url && typeof this.target.insertError === 'function') {
+      try {
+        this.target.insertError({ url, kind: 'save', message: error?.message || String(error) });
+      } catch (_) {
+        // Nothing more we can do; the failure is counted in stats
+      }
+    }
+  }
+}
+
+function resolveRawDb(target) {
+  try {
+    const handle = typeof target.getDb === 'function' ? target.getDb() : (target.db || null);
+    if (!handle) return null;
+    if (typeof handle.transaction === 'function') return handle;
+    if (handle.db && typeof handle.db.transaction === 'function') return handle.db;
+  } catch (_) {
+    // Adapter without a raw handle; writes are still batched, just not in one transaction
+  }
+  return null;
+}
+
+module.exports = { WriteBehindBuffer, DEFAULT_BUFFERED_METHODS };
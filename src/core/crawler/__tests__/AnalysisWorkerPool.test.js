@@ -0,0 +1,131 @@
+'use strict';
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { AnalysisWorkerPool, toTransferable } = require('../pipeline/AnalysisWorkerPool');
+const { analyzePageHtml } = require('../pipeline/pageAnalysis');
+
+// Stand-in worker: echoes the decoded length, simulates a task error for
+// 'bad' and a thread crash for 'boom'.
+const FAKE_WORKER = `
+const { parentPort } = require('worker_threads');
+const decoder = new TextDecoder();
+parentPort.on('message', (msg) => {
+  const html = decoder.decode(new Uint8Array(msg.buffer, msg.byteOffset, msg.byteLength));
+  if (html === 'boom') process.exit(3);
+  setTimeout(() => {
+    if (html === 'bad') {
+      parentPort.postMessage({ type: 'error', taskId: msg.taskId, error: 'bad page' });
+      return;
+    }
+    parentPort.postMessage({ type: 'analyzed', taskId: msg.taskId, result: { length: html.length }, durationMs: 5 });
+  }, 20);
+});
+`;
+
+describe('AnalysisWorkerPool', () => {
+  let tmpDir;
+  let workerPath;
+  let pool;
+
+  beforeAll(() => {
+    tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'analysis-pool-'));
+    workerPath = path.join(tmpDir, 'fakeWorker.js');
+    fs.writeFileSync(workerPath, FAKE_WORKER);
+  });
+
+  afterAll(() => {
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+  });
+
+  afterEach(async () => {
+    if (pool) await pool.shutdown();
+    pool = null;
+  });
+
+  test('analyses html on worker threads and reports per-worker stats', async () => {
+    pool = new AnalysisWorkerPool({ poolSize: 1, workerPath });
+    const results = await Promise.all([
+      pool.analyze({ html: '<p>one</p>' }),
+      pool.analyze({ html: Buffer.from('<p>two!</p>') })
+    ]);
+
+    expect(results.map((r) => r.length)).toEqual([10, 11]);
+    const stats = pool.getStats();
+    expect(stats).toMatchObject({ submitted: 2, completed: 2, failed: 0, pending: 0 });
+    expect(stats.workers).toHaveLength(1);
+    expect(stats.workers[0]).toMatchObject({ busy: false, tasksCompleted: 2, bytesIn: 21 });
+  });
+
+  test('blocks waitForCapacity while maxPending tasks are outstanding', async () => {
+    pool = new AnalysisWorkerPool({ poolSize: 1, maxPending: 1, workerPath });
+    expect(pool.waitForCapacity()).toBeNull();
+
+    const task = pool.analyze({ html: 'slow' });
+    const gate = pool.waitForCapacity();
+    expect(gate).toBeInstanceOf(Promise);
+
+    await task;
+    await gate;
+    expect(pool.hasCapacity()).toBe(true);
+    expect(pool.getStats().backpressureWaits).toBe(1);
+  });
+
+  test('wakes every capacity waiter once a slot frees up', async () => {
+    pool = new AnalysisWorkerPool({ poolSize: 1, maxPending: 1, workerPath });
+    const task = pool.analyze({ html: 'slow' });
+
+    // More pulling workers than maxPending; only one will submit more work
+    const woken = [];
+    const pullers = [0, 1, 2].map(async (id) => {
+      const gate = pool.waitForCapacity();
+      expect(gate).toBeInstanceOf(Promise);
+      await gate;
+      woken.push(id);
+      if (id === 0) await pool.analyze({ html: 'next' });
+    });
+
+    await task;
+    await Promise.all(pullers);
+    expect(woken.sort()).toEqual([0, 1, 2]);
+    expect(pool.pending).toBe(0);
+  });
+
+  test('rejects failed tasks and replaces crashed workers', async () => {
+    pool = new AnalysisWorkerPool({ poolSize: 1, workerPath });
+    const exits = [];
+    pool.on('worker-exit', (evt) => exits.push(evt));
+
+    await expect(pool.analyze({ html: 'bad' })).rejects.toThrow('bad page');
+    await expect(pool.analyze({ html: 'boom' })).rejects.toThrow('exited with code 3');
+    expect(exits).toHaveLength(1);
+
+    const after = await pool.analyze({ html: 'still works' });
+    expect(after.length).toBe(11);
+    expect(pool.getStats().workers).toHaveLength(1);
+  });
+
+  test('toTransferable copies views that share a larger backing store', () => {
+    const backing = new Uint8Array([1, 2, 3, 4]);
+    const view = backing.subarray(1, 3);
+    const transferable = toTransferable(view);
+    expect(transferable).not.toBe(backing.buffer);
+    expect(Array.from(new Uint8Array(transferable))).toEqual([2, 3]);
+    expect(toTransferable('')).toBeNull();
+  });
+});
+
+describe('analyzePageHtml', () => {
+  test('returns readability, schema and gzip size as plain data', () => {
+    const html = `<html lang="en"><head><title>T</title></head><body><article><h1>Headline</h1><p>${'Words in a sentence. '.repeat(60)}</p></article></body></html>`;
+    const result = analyzePageHtml({ html, url: 'https://example.com/news/story' });
+
+    expect(result.readability.htmlSha).toMatch(/^[0-9a-f]{64}$/);
+    expect(result.readability.wordCount).toBeGreaterThan(100);
+    expect(result.readability.language).toBe('en');
+    expect(result.compressedBytes).toBeGreaterThan(0);
+    expect(result.compressedBytes).toBeLessThan(html.length);
+    expect(result.timings).toHaveProperty('readabilityMs');
+  });
+});
@@ -109,6 +109,24 @@ describe('DomainThrottleManager', () => {
       expect(state.rpm).toBeLessThanOrEqual(20);
       expect(state.politenessFloorMs).toBe(3000);
     });
+
+    it('sizes host connection pools from politeness limits', () => {
+      expect(manager.getHostConnectionLimit('unknown.example', 6)).toBe(6);
+
+      const state = manager.getDomainState('example.com');
+      state.rpm = 120;
+      expect(manager.getHostConnectionLimit('example.com', 6)).toBe(4);
+      state.rpm = 600;
+      expect(manager.getHostConnectionLimit('example.com', 6)).toBe(6);
+
+      manager.setRobotsCrawlDelay('example.com', 2, { source: 'robots:network' });
+      expect(manager.getHostConnectionLimit('example.com', 6)).toBe(1);
+
+      const limited = manager.getDomainState('busy.example');
+      limited.rpm = 600;
+      manager.note429('busy.example', 30_000);
+      expect(manager.getHostConnectionLimit('busy.example', 6)).toBe(1);
+    });
   });
 
   describe('with limiterFactory', () => {
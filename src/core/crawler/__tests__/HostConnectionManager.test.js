@@ -0,0 +1,103 @@
+'use strict';
+
+const http = require('http');
+const { HostConnectionManager } = require('../HostConnectionManager');
+const { StageHistograms } = require('../profiler/StageHistograms');
+
+function get(url, agent) {
+  return new Promise((resolve, reject) => {
+    const req = http.get(url, { agent }, (res) => {
+      res.resume();
+      res.on('end', () => resolve(res.statusCode));
+    });
+    req.on('error', reject);
+  });
+}
+
+describe('HostConnectionManager', () => {
+  let server;
+  let baseUrl;
+  let manager;
+
+  beforeAll(async () => {
+    server = http.createServer((req, res) => {
+      res.writeHead(200, { 'content-type': 'text/plain' });
+      res.end('ok');
+    });
+    await new Promise((resolve) => server.listen(0, '127.0.0.1', resolve));
+    baseUrl = `http://127.0.0.1:${server.address().port}`;
+  });
+
+  afterAll(async () => {
+    await new Promise((resolve) => server.close(resolve));
+  });
+
+  afterEach(() => {
+    manager?.destroy();
+    manager = null;
+  });
+
+  test('reuses one keep-alive socket per origin across sequential requests', async () => {
+    manager = new HostConnectionManager();
+    for (let i = 0; i < 3; i += 1) {
+      expect(await get(`${baseUrl}/page/${i}`, manager.agentFor(`${baseUrl}/page/${i}`))).toBe(200);
+    }
+
+    const stats = manager.getStats();
+    expect(stats.requests).toBe(3);
+    expect(stats.handshakes).toBe(1);
+    expect(stats.reusedRequests).toBe(2);
+    expect(stats.reuseRate).toBeCloseTo(0.667, 2);
+    expect(stats.origins).toBe(1);
+    expect(stats.perOrigin[0]).toMatchObject({ origin: baseUrl, protocol: 'http/1.1', requests: 3 });
+  });
+
+  test('times fresh socket setup into the stage histograms', async () => {
+    const stageHistograms = new StageHistograms();
+    manager = new HostConnectionManager({ stageHistograms });
+    for (let i = 0; i < 2; i += 1) {
+      await get(`${baseUrl}/page/${i}`, manager.agentFor(`${baseUrl}/page/${i}`));
+    }
+
+    // One handshake; a literal IP has no DNS lookup
+    expect(stageHistograms.get('tcp', '127.0.0.1').count).toBe(1);
+    expect(stageHistograms.get('dns')).toBeNull();
+  });
+
+  test('caps sockets per host using the politeness limit', () => {
+    const limits = { 'slow.example': 1, 'fast.example': 20 };
+    manager = new HostConnectionManager({
+      maxSocketsPerHost: 4,
+      getHostSocketLimit: (host) => limits[host]
+    });
+
+    expect(manager.agentFor('https://slow.example/a').maxSockets).toBe(1);
+    expect(manager.agentFor('https://fast.example/a').maxSockets).toBe(4);
+    expect(manager.agentFor('https://other.example/a').maxSockets).toBe(4);
+    expect(manager.agentFor('https://slow.example/b')).toBe(manager.agentFor('https://slow.example/c'));
+  });
+
+  test('evicts pools idle longer than the timeout', async () => {
+    manager = new HostConnectionManager({ idleTimeoutMs: 1000 });
+    const agent = manager.agentFor(`${baseUrl}/idle`);
+    await get(`${baseUrl}/idle`, agent);
+    expect(manager.getStats().openSockets).toBe(1);
+
+    expect(manager.evictIdle(Date.now())).toBe(0);
+    expect(manager.evictIdle(Date.now() + 5000)).toBe(1);
+
+    const stats = manager.getStats();
+    expect(stats.evictedPools).toBe(1);
+    expect(stats.openSockets).toBe(0);
+    expect(manager.agentFor(`${baseUrl}/again`)).not.toBe(agent);
+  });
+
+  test('never negotiates HTTP/2 for plain http or when disabled', async () => {
+    manager = new HostConnectionManager({ http2: true });
+    await expect(manager.requestHttp2(`${baseUrl}/x`)).resolves.toBeNull();
+
+    const disabled = new HostConnectionManager();
+    await expect(disabled.requestHttp2('https://example.com/')).resolves.toBeNull();
+    disabled.destroy();
+  });
+});
@@ -0,0 +1,67 @@
+'use strict';
+
+const cheerio = require('cheerio');
+const { LinkClassifier } = require('../LinkClassifier');
+
+describe('LinkClassifier', () => {
+  const html = `
+    <html>
+      <body>
+        <nav>
+          <a href="/news/live">Live</a>
+          <a href="/world">World</a>
+          <a href="https://other.com/x">Elsewhere</a>
+        </nav>
+        <h2><a href="/news/live">Live again</a></h2>
+        <article><a href="/news/uk/story-1">Story 1</a></article>
+        <footer><a href="/world">World</a></footer>
+      </body>
+    </html>
+  `;
+
+  function build() {
+    const normalizeUrl = jest.fn((href) => {
+      try { return new URL(href, 'https://example.com/').href; } catch (_) { return null; }
+    });
+    const classifier = new LinkClassifier({
+      normalizeUrl,
+      isOnDomain: (url) => url.startsWith('https://example.com/'),
+      looksLikeArticle: (url) => url.includes('/news/')
+    });
+    return { classifier, normalizeUrl };
+  }
+
+  it('produces navigation and article sets from one visit per anchor', () => {
+    const { classifier, normalizeUrl } = build();
+    const result = classifier.classify(cheerio.load(html));
+
+    expect(result.navigation).toEqual([
+      { url: 'https://example.com/news/live', anchor: 'Live', rel: null, onDomain: 1 },
+      { url: 'https://example.com/world', anchor: 'World', rel: null, onDomain: 1 }
+    ]);
+    expect(result.articles).toEqual([
+      { url: 'https://example.com/news/live', anchor: 'Live', rel: null, onDomain: 1 },
+      { url: 'https://example.com/news/uk/story-1', anchor: 'Story 1', rel: null, onDomain: 1 }
+    ]);
+    // Four distinct hrefs, each normalized once
+    expect(normalizeUrl).toHaveBeenCalledTimes(4);
+  });
+
+  it('memoizes hrefs across pages of the same crawl', () => {
+    const { classifier, normalizeUrl } = build();
+    classifier.classify(cheerio.load(html));
+    classifier.classify(cheerio.load(html));
+
+    expect(normalizeUrl).toHaveBeenCalledTimes(4);
+    expect(classifier.getStats()).toMatchObject({ resolved: 4, memoSize: 4 });
+    expect(classifier.getStats().memoHitRate).toBeGreaterThan(0.5);
+
+    classifier.reset();
+    classifier.classify(cheerio.load(html));
+    expect(normalizeUrl).toHaveBeenCalledTimes(8);
+  });
+
+  it('throws when dependencies missing', () => {
+    expect(() => new LinkClassifier({})).toThrow('LinkClassifier requires a normalizeUrl function');
+  });
+});
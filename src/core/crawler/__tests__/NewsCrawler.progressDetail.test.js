@@ -106,6 +106,14 @@ describe('buildProgressDetail', () => {
     expect(roundTripped.perHostLimits).toEqual(detail.perHostLimits);
   });
 
+  it('surfaces seen-URL filter savings once the filter is warmed', () => {
+    const seenFilter = { kind: 'bloom', ready: true, items: 1200, dbLookupsSkipped: 900, savingsRate: 0.9, observedFpRate: 0.01, estimatedFpRate: 0.008, bytes: 4096 };
+    expect(buildProgressDetail(sources({ seenFilter })).seenFilter).toEqual({
+      kind: 'bloom', items: 1200, dbLookupsSkipped: 900, savingsRate: 0.9, observedFpRate: 0.01, estimatedFpRate: 0.008
+    });
+    expect(buildProgressDetail(sources({ seenFilter: { ...seenFilter, ready: false } })).seenFilter).toBeUndefined();
+  });
+
   it('computes intervalMs and backoffMs from rate-limit state', () => {
     const detail = buildProgressDetail(sources({
       domainLimits: new Map([['h', { isLimited: true, rpm: 60, backoffUntil: 9000 }]]),
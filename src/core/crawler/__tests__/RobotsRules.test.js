@@ -0,0 +1,91 @@
+const {
+  RobotsRulesCache,
+  CompiledRobots,
+  getSharedRobotsRules,
+  robotsRulesParser
+} = require('../RobotsRules');
+const { RobotsCache } = require('../RobotsCache');
+
+describe('RobotsRules', () => {
+  const robotsTxt = [
+    'User-agent: *',
+    'Disallow: /private',
+    'Allow: /private/press',
+    'Disallow: /*.pdf$',
+    'Disallow: /search?*q=',
+    'Disallow: /tmp/',
+    'Allow: /tmp/',
+    'Crawl-delay: 2',
+    '',
+    'User-agent: NewsBot',
+    'Disallow: /news/drafts # editors only',
+    '',
+    'Sitemap: /sitemap.xml'
+  ].join('\n');
+
+  test('applies the longest matching rule with wildcards and anchors', () => {
+    const rules = new CompiledRobots('https://example.com/robots.txt', robotsTxt);
+
+    expect(rules.isAllowed('https://example.com/')).toBe(true);
+    expect(rules.isAllowed('https://example.com/private/data')).toBe(false);
+    expect(rules.isAllowed('https://example.com/private/press/2024')).toBe(true);
+    expect(rules.isAllowed('https://example.com/files/report.pdf')).toBe(false);
+    expect(rules.isAllowed('https://example.com/files/report.pdf?v=2')).toBe(true);
+    expect(rules.isAllowed('https://example.com/search?lang=en&q=x')).toBe(false);
+    expect(rules.isAllowed('https://example.com/search')).toBe(true);
+    expect(rules.isAllowed('https://example.com/tmp/a')).toBe(true);
+    expect(rules.isAllowed('https://example.com/private#frag')).toBe(false);
+    expect(rules.isAllowed('https://example.com/robots.txt')).toBe(true);
+    expect(rules.isAllowed('/private/x')).toBe(false);
+  });
+
+  test('selects the group for the user-agent product token', () => {
+    const rules = new CompiledRobots('https://example.com/robots.txt', robotsTxt);
+
+    expect(rules.isAllowed('https://example.com/news/drafts/1', 'NewsBot/2.1')).toBe(false);
+    expect(rules.isAllowed('https://example.com/private/data', 'NewsBot/2.1')).toBe(true);
+    expect(rules.isAllowed('https://example.com/news/drafts/1', 'OtherBot')).toBe(true);
+    expect(rules.rulesFor('NewsBot/2.1')).toBe(rules.rulesFor('NewsBot/2.1'));
+    expect(rules.getCrawlDelay('*')).toBe(2);
+    expect(rules.getSitemaps()).toEqual(['/sitemap.xml']);
+  });
+
+  test('caches one compilation per host and evicts least recently used', () => {
+    const cache = new RobotsRulesCache({ maxEntries: 2 });
+    const a = cache.compile('https://a.example/robots.txt', robotsTxt);
+    expect(cache.compile('https://a.example/robots.txt', robotsTxt)).toBe(a);
+    cache.compile('https://b.example/robots.txt', 'User-agent: *\nDisallow: /');
+    cache.get('a.example');
+    cache.compile('https://c.example/robots.txt', 'User-agent: *\nDisallow:');
+
+    expect(cache.get('https://b.example/page')).toBeNull();
+    expect(cache.get('a.example')).toBe(a);
+    expect(cache.compile('https://a.example/robots.txt', 'User-agent: *\nDisallow: /')).not.toBe(a);
+
+    for (let i = 0; i < 128; i++) cache.isAllowed(`https://c.example/${i}`);
+    expect(cache.isAllowed('https://unknown.example/x')).toBe(true);
+    const stats = cache.getStats();
+    expect(stats).toMatchObject({ entries: 2, evictions: 1, compilations: 4, hits: 3, misses: 5 });
+    expect(stats.hitRate).toBeCloseTo(3 / 8, 5);
+    expect(stats.evaluations).toBe(128);
+    expect(stats.avgEvalNs).toBeGreaterThanOrEqual(0);
+  });
+
+  test('RobotsCache and the parser factory share the compiled record', async () => {
+    const shared = getSharedRobotsRules();
+    shared.clear();
+    const cache = new RobotsCache({
+      baseUrl: 'https://shared.example',
+      domain: 'shared.example',
+      fetchImpl: jest.fn(async () => ({ ok: true, status: 200, headers: {}, text: async () => robotsTxt })),
+      logger: { log: jest.fn() }
+    });
+
+    const result = await cache.load();
+    expect(result).toMatchObject({ crawlDelaySeconds: 2, sitemapUrls: ['https://shared.example/sitemap.xml'] });
+    const before = shared.getStats().compilations;
+    const rules = robotsRulesParser(result.robotsUrl, result.robotsTxt);
+    expect(shared.getStats().compilations).toBe(before);
+    expect(rules.isAllowed('https://shared.example/private/x', '*')).toBe(false);
+  });
+});
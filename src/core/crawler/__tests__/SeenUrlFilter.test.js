@@ -0,0 +1,45 @@
+'use strict';
+
+const { BloomFilter, CuckooFilter, seenFilterFromJSON } = require('../SeenUrlFilter');
+
+const urls = (prefix, n) => Array.from({ length: n }, (_v, i) => `https://example.com/${prefix}/${i}`);
+
+describe.each([
+  ['bloom', () => new BloomFilter({ capacity: 2000, fpRate: 0.01 })],
+  ['cuckoo', () => new CuckooFilter({ capacity: 2000 })]
+])('%s seen filter', (kind, create) => {
+  it('has no false negatives and a bounded false-positive rate, including past capacity', () => {
+    const filter = create();
+    const added = urls('seen', 5000);
+    added.forEach((url) => filter.add(url));
+
+    expect(filter.layers.length).toBeGreaterThan(1);
+    expect(added.every((url) => filter.has(url))).toBe(true);
+    const fp = urls('unseen', 5000).filter((url) => filter.has(url)).length / 5000;
+    expect(fp).toBeLessThan(0.03);
+    expect(filter.estimatedFpRate()).toBeLessThan(0.03);
+  });
+
+  it('survives a JSON round trip', () => {
+    const filter = create();
+    urls('seen', 3000).forEach((url) => filter.add(url));
+    const restored = seenFilterFromJSON(JSON.parse(JSON.stringify(filter)));
+
+    expect(restored.kind).toBe(kind);
+    expect(restored.size).toBe(filter.size);
+    expect(urls('seen', 3000).every((url) => restored.has(url))).toBe(true);
+  });
+});
+
+describe('CuckooFilter.delete', () => {
+  it('forgets deleted URLs and keeps the rest', () => {
+    const filter = new CuckooFilter({ capacity: 1000 });
+    const all = urls('seen', 500);
+    all.forEach((url) => filter.add(url));
+    all.slice(0, 250).forEach((url) => filter.delete(url));
+
+    expect(all.slice(0, 250).filter((url) => filter.has(url)).length).toBeLessThan(3);
+    expect(all.slice(250).every((url) => filter.has(url))).toBe(true);
+    expect(filter.size).toBe(250);
+  });
+});
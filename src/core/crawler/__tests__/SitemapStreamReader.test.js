@@ -0,0 +1,139 @@
+const zlib = require('zlib');
+const { SitemapStreamParser, readSitemapStream } = require('../SitemapStreamReader');
+const { loadSitemaps } = require('../sitemap');
+
+function urlset(entries) {
+  return [
+    '<?xml version="1.0" encoding="UTF-8"?>',
+    '<urlset xmlns="http://www.sitemaps.org/schemas/sitemap/0.9" xmlns:news="http://www.google.com/schemas/sitemap-news/0.9">',
+    ...entries.map(([loc, lastmod, extra = '']) =>
+      `  <url><loc>${loc}</loc>${lastmod ? `<lastmod>${lastmod}</lastmod>` : ''}${extra}</url>`),
+    '</urlset>'
+  ].join('\n');
+}
+
+function chunksOf(buffer, size) {
+  const chunks = [];
+  for (let i = 0; i < buffer.length; i += size) chunks.push(buffer.subarray(i, i + size));
+  return chunks;
+}
+
+function makeRes(body, status = 200) {
+  const buffer = Buffer.isBuffer(body) ? body : Buffer.from(body);
+  return {
+    ok: status >= 200 && status < 300,
+    status,
+    headers: { get: () => null },
+    body: (async function* stream() { yield* chunksOf(buffer, 64); })()
+  };
+}
+
+describe('SitemapStreamParser', () => {
+  const xml = urlset([
+    ['https://example.com/a?x=1&amp;y=2', '2026-01-02', '<priority>0.8</priority>'],
+    ['https://example.com/b', '2024-05-01'],
+    ['<![CDATA[https://example.com/c]]>', null,
+      '<news:news><news:publication_date>2026-03-01</news:publication_date><news:title>Caf&#233; opens</news:title></news:news>']
+  ]);
+
+  test('extracts entries regardless of chunk boundaries', () => {
+    for (const size of [1, 7, 4096]) {
+      const parser = new SitemapStreamParser();
+      const entries = chunksOf(Buffer.from(xml), size).flatMap((chunk) => parser.write(chunk));
+      expect(entries).toEqual([
+        { kind: 'url', loc: 'https://example.com/a?x=1&y=2', lastmod: '2026-01-02', priority: 0.8 },
+        { kind: 'url', loc: 'https://example.com/b', lastmod: '2024-05-01' },
+        { kind: 'url', loc: 'https://example.com/c', isNews: true, publicationDate: '2026-03-01', title: 'Café opens' }
+      ]);
+      expect(parser.offset).toBe(xml.lastIndexOf('</url>') + '</url>'.length);
+    }
+  });
+
+  test('filters by lastmod while streaming and resumes from an offset', async () => {
+    const seen = [];
+    const first = await readSitemapStream(chunksOf(Buffer.from(xml), 16), {
+      lastmodSince: '2025-01-01',
+      onEntries: (entries) => {
+        seen.push(...entries.map((e) => e.loc));
+        return false;
+      }
+    });
+    expect(seen).toEqual(['https://example.com/a?x=1&y=2']);
+    expect(first.complete).toBe(false);
+    expect(first.stats.filtered).toBe(0);
+
+    const resumed = [];
+    const second = await readSitemapStream(chunksOf(Buffer.from(xml), 16), {
+      lastmodSince: '2025-01-01',
+      resumeOffset: first.offset,
+      onEntries: (entries) => { resumed.push(...entries.map((e) => e.loc)); }
+    });
+    expect(resumed).toEqual(['https://example.com/c']);
+    expect(second).toMatchObject({ complete: true, stats: { filtered: 1 } });
+  });
+
+  test('keeps memory bounded by dropping oversized entries', () => {
+    const parser = new SitemapStreamParser({ maxEntryBytes: 1024 });
+    const huge = `<url><loc>https://example.com/big</loc>${'x'.repeat(4096)}</url><url><loc>https://example.com/ok</loc></url>`;
+    const entries = chunksOf(Buffer.from(huge), 512).flatMap((chunk) => parser.write(chunk));
+    expect(entries.map((e) => e.loc)).toEqual(['https://example.com/ok']);
+    expect(parser.stats.oversized).toBeGreaterThan(0);
+  });
+});
+
+describe('loadSitemaps streaming', () => {
+  test('gunzips child sitemaps of an index on the fly and pushes in batches', async () => {
+    const index = [
+      '<sitemapindex xmlns="http://www.sitemaps.org/schemas/sitemap/0.9">',
+      '<sitemap><loc>https://example.com/news.xml.gz</loc><lastmod>2026-05-01</lastmod></sitemap>',
+      '<sitemap><loc>https://example.com/archive-2019.xml.gz</loc><lastmod>2019-12-31</lastmod></sitemap>',
+      '</sitemapindex>'
+    ].join('');
+    const news = zlib.gzipSync(urlset(Array.from({ length: 25 }, (_, i) => [`https://example.com/story-${i}`, '2026-05-01'])));
+    const requested = [];
+    const fetchImpl = async (url) => {
+      requested.push(url);
+      if (url.endsWith('/sitemap_index.xml')) return makeRes(index);
+      if (url.endsWith('/news.xml.gz')) return makeRes(news);
+      return makeRes('', 404);
+    };
+
+    const pushed = [];
+    const batches = [];
+    const done = [];
+    const n = await loadSitemaps('https://example.com', 'example.com', ['https://example.com/sitemap_index.xml'], {
+      fetchImpl,
+      batchSize: 10,
+      lastmodSince: new Date('2026-01-01'),
+      push: (url, meta) => pushed.push([url, meta.lastmod]),
+      onBatch: (batch) => batches.push(batch),
+      onSitemapDone: (info) => done.push(info)
+    });
+
+    expect(n).toBe(25);
+    expect(requested).toEqual(['https://example.com/sitemap_index.xml', 'https://example.com/news.xml.gz']);
+    expect(pushed[0]).toEqual(['https://example.com/story-0', '2026-05-01']);
+    expect(batches.every((batch) => batch.urls <= 10 && batch.sitemapUrl.endsWith('news.xml.gz'))).toBe(true);
+    expect(batches.reduce((sum, batch) => sum + batch.urls, 0)).toBe(25);
+    expect(done.map((info) => info.complete)).toEqual([true, true]);
+    expect(done[0].stats.filtered).toBe(1);
+  });
+
+  test('resumes a plain sitemap with a Range request', async () => {
+    const xml = urlset([['https://example.com/a'], ['https://example.com/b']]);
+    const offset = xml.indexOf('</url>') + '</url>'.length;
+    let rangeHeader = null;
+    const fetchImpl = async (url, options) => {
+      rangeHeader = options.headers.Range;
+      return makeRes(xml.slice(offset), 206);
+    };
+    const pushed = [];
+    await loadSitemaps('https://example.com', 'example.com', ['https://example.com/sitemap.xml'], {
+      fetchImpl,
+      resumeOffsets: new Map([['https://example.com/sitemap.xml', offset]]),
+      push: (url) => pushed.push(url)
+    });
+    expect(rangeHeader).toBe(`bytes=${offset}-`);
+    expect(pushed).toEqual(['https://example.com/b']);
+  });
+});
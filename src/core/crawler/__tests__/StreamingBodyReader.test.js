@@ -0,0 +1,116 @@
+'use strict';
+
+const { Readable } = require('stream');
+const zlib = require('zlib');
+const {
+  readBodyStreaming,
+  sniffHeadMetadata,
+  classifyContentType,
+  resolveByteCap,
+  createDecodedStream,
+  readStreamText,
+  DEFAULT_BYTE_CAPS
+} = require('../StreamingBodyReader');
+
+const HEAD = [
+  '<html><head>',
+  '<link href="https://example.com/news/story" rel="canonical">',
+  '<meta content="article" property="og:type">',
+  '<script type="application/ld+json">{"@context":"https://schema.org","@graph":[{"@type":"NewsArticle"},{"@type":"WebPage"}]}</script>',
+  '</head>'
+].join('');
+
+// Lazy async iterable so the test can see how much of the body was pulled
+function streamingResponse(chunks) {
+  let pulled = 0;
+  const body = {
+    async* [Symbol.asyncIterator]() {
+      while (pulled < chunks.length) {
+        yield Buffer.from(chunks[pulled++]);
+      }
+    }
+  };
+  return { response: { body, text: async () => chunks.join('') }, pulls: () => pulled };
+}
+
+describe('StreamingBodyReader', () => {
+  test('sniffs canonical, og:type and JSON-LD types from a partial head', () => {
+    const head = sniffHeadMetadata(HEAD + '<body><p>partial');
+    expect(head).toEqual({
+      canonical: 'https://example.com/news/story',
+      ogType: 'article',
+      jsonLdTypes: ['NewsArticle', 'WebPage'],
+      looksLikeArticle: true
+    });
+    expect(sniffHeadMetadata('<head><script type="application/ld+json">{"@type": "CollectionPage", "name": "cut off').jsonLdTypes)
+      .toEqual(['CollectionPage']);
+  });
+
+  test('stops reading once onHead rejects the page', async () => {
+    const { response, pulls } = streamingResponse([HEAD, '<body>', 'x'.repeat(1000), 'y'.repeat(1000)]);
+    const abort = jest.fn();
+    const result = await readBodyStreaming(response, {
+      onHead: (head) => (head.canonical ? { abortReason: 'canonical-already-visited' } : null),
+      abort
+    });
+
+    expect(result.abortReason).toBe('canonical-already-visited');
+    expect(result.html).toBe('');
+    expect(result.bytes).toBe(Buffer.byteLength(HEAD));
+    expect(abort).toHaveBeenCalledTimes(1);
+    expect(pulls()).toBe(1);
+  });
+
+  test('truncates at the byte cap and lets onHead raise it for articles', async () => {
+    const capped = streamingResponse(['<html><head></head><body>', 'a'.repeat(500), 'b'.repeat(500)]);
+    const small = await readBodyStreaming(capped.response, { byteCap: 100 });
+    expect(small.truncated).toBe(true);
+    expect(small.bytes).toBe(100);
+    expect(small.html).toHaveLength(100);
+
+    const raised = streamingResponse([HEAD, 'a'.repeat(500)]);
+    const full = await readBodyStreaming(raised.response, {
+      byteCap: 300,
+      onHead: (head) => (head.looksLikeArticle ? { byteCap: 10_000 } : null)
+    });
+    expect(full.truncated).toBe(false);
+    expect(full.html).toBe(HEAD + 'a'.repeat(500));
+  });
+
+  test('rejects with an AbortError when the signal fires mid-body', async () => {
+    const body = new Readable({ read() {} });
+    body.push('<html><head></head><body>partial');
+    const controller = new AbortController();
+    const reading = readBodyStreaming({ body }, { signal: controller.signal });
+    setTimeout(() => controller.abort(), 10);
+
+    await expect(reading).rejects.toThrow('aborted');
+    expect(body.destroyed).toBe(true);
+  });
+
+  test('falls back to text() for responses without a stream body', async () => {
+    const result = await readBodyStreaming({ text: async () => 'hello world' }, { byteCap: 5 });
+    expect(result).toMatchObject({ html: 'hello', bytes: 5, truncated: true, abortReason: null });
+  });
+
+  test('classifies content types and resolves per-type caps', () => {
+    expect(classifyContentType('text/html; charset=utf-8')).toBe('html');
+    expect(classifyContentType(null)).toBe('html');
+    expect(classifyContentType('application/pdf')).toBe('binary');
+    expect(classifyContentType('image/jpeg')).toBe('binary');
+    expect(classifyContentType('application/rss+xml')).toBe('xml');
+    expect(classifyContentType('application/json')).toBe('other');
+
+    expect(resolveByteCap(null, { contentKind: 'html', isArticle: true })).toBe(Infinity);
+    expect(resolveByteCap({}, { contentKind: 'html', isArticle: true })).toBe(DEFAULT_BYTE_CAPS.article);
+    expect(resolveByteCap({ hub: 1234, article: undefined }, { contentKind: 'html', isArticle: false })).toBe(1234);
+    expect(resolveByteCap({ hub: 1234, article: undefined }, { contentKind: 'html', isArticle: true })).toBe(DEFAULT_BYTE_CAPS.article);
+  });
+
+  test('decodes gzip and brotli bodies as a stream', async () => {
+    const gz = createDecodedStream(Readable.from([zlib.gzipSync('gzip body')]), 'gzip');
+    await expect(readStreamText(gz)).resolves.toBe('gzip body');
+    const br = createDecodedStream(Readable.from([zlib.brotliCompressSync('brotli body')]), 'br');
+    await expect(readStreamText(br)).resolves.toBe('brotli body');
+  });
+});
@@ -24,7 +24,8 @@ describe('UrlEligibilityService', () => {
       getDbAdapter: overrides.getDbAdapter || (() => adapter),
       maxAgeHubMs: overrides.maxAgeHubMs,
       maxAgeArticleMs: overrides.maxAgeArticleMs,
-      urlDecisionOrchestrator: overrides.urlDecisionOrchestrator || null
+      urlDecisionOrchestrator: overrides.urlDecisionOrchestrator || null,
+      seenFilter: overrides.seenFilter
     });
   };
 
@@ -321,4 +322,94 @@ describe('UrlEligibilityService', () => {
       expect(result.status).toBe('allow');
     });
   });
+
+  describe('seen-URL filter', () => {
+    // Stored URLs with the fetched_at of their latest response
+    const buildDb = (stored) => ({
+      prepare: jest.fn((sql) => {
+        if (sql.includes('SELECT DISTINCT u.url')) {
+          return { iterate: jest.fn(() => Object.keys(stored).map((url) => ({ url }))[Symbol.iterator]()) };
+        }
+        if (sql.includes('content_storage')) {
+          return { get: jest.fn((url) => (stored[url] ? { ok: 1 } : undefined)) };
+        }
+        if (sql.includes('ORDER BY hr.fetched_at DESC')) {
+          return { get: jest.fn((url) => (stored[url] ? { fetched_at: stored[url] } : undefined)) };
+        }
+        throw new Error(`Unexpected SQL: ${sql}`);
+      })
+    });
+
+    const evaluate = (service, url) => service.evaluate({ url, depth: 1, type: 'article', queueSize: 0, isDuplicate: () => false });
+
+    it('skips the database for URLs the warmed filter has never seen', () => {
+      const db = buildDb({ 'https://example.com/news/old': new Date().toISOString() });
+      const adapter = { isEnabled: () => true, getDb: () => db };
+      const service = createService({ adapter, seenFilter: 'bloom' });
+
+      expect(service.warmSeenFilter({ host: 'example.com' })).toBe(1);
+      const lookupsAfterWarm = db.prepare.mock.calls.length;
+
+      expect(evaluate(service, 'https://example.com/news/new-1').status).toBe('allow');
+      expect(evaluate(service, 'https://example.com/news/new-2').status).toBe('allow');
+      expect(db.prepare.mock.calls.length).toBe(lookupsAfterWarm);
+
+      expect(evaluate(service, 'https://example.com/news/old').reason).toBe('already-processed');
+      expect(service.getSeenFilterStats()).toMatchObject({ kind: 'bloom', ready: true, lookups: 3, dbLookupsSkipped: 2, filterHits: 1, falsePositives: 0 });
+    });
+
+    it('consults the database on every lookup until warmed', () => {
+      const db = buildDb({});
+      const service = createService({ adapter: { isEnabled: () => true, getDb: () => db }, seenFilter: 'bloom' });
+      evaluate(service, 'https://example.com/news/a');
+      expect(db.prepare).toHaveBeenCalled();
+      expect(service.getSeenFilterStats().ready).toBe(false);
+    });
+
+    it('forgets URLs that fell out of the recrawl window (cuckoo variant)', () => {
+      const stale = new Date(Date.now() - 2 * 60 * 60 * 1000).toISOString();
+      const db = buildDb({ 'https://example.com/news/stale': stale });
+      const service = createService({ adapter: { isEnabled: () => true, getDb: () => db }, maxAgeArticleMs: 60 * 60 * 1000, seenFilter: 'auto' });
+      service.warmSeenFilter();
+      expect(service.seenFilter.kind).toBe('cuckoo');
+
+      expect(evaluate(service, 'https://example.com/news/stale').status).toBe('allow');
+      const calls = db.prepare.mock.calls.length;
+      expect(evaluate(service, 'https://example.com/news/stale').status).toBe('allow');
+      expect(db.prepare.mock.calls.length).toBe(calls);
+      expect(service.getSeenFilterStats().expired).toBe(1);
+    });
+
+    it('stays on database lookups when the warm-up exceeds its limit', () => {
+      const db = buildDb({ 'https://example.com/news/a': null, 'https://example.com/news/b': null });
+      const adapter = { isEnabled: () => true, getDb: () => db };
+      const service = createService({ adapter, seenFilter: { kind: 'bloom', warmLimit: 1 } });
+
+      expect(service.warmSeenFilter()).toBe(1);
+      expect(service.getSeenFilterStats()).toEqual(expect.objectContaining({ ready: false, warmTruncated: true }));
+      const calls = db.prepare.mock.calls.length;
+      evaluate(service, 'https://example.com/news/never-seen');
+      expect(db.prepare.mock.calls.length).toBeGreaterThan(calls);
+    });
+
+    it('adds URLs noted as processed during the crawl', () => {
+      const service = createService({ seenFilter: 'bloom' });
+      service.noteProcessed('https://example.com/news/saved');
+      expect(service.seenFilter.has('https://example.com/news/saved')).toBe(true);
+    });
+
+    it('round-trips through a checkpoint snapshot and tops up from the database', () => {
+      const db = buildDb({ 'https://example.com/news/a': new Date().toISOString() });
+      const adapter = { isEnabled: () => true, getDb: () => db };
+      const first = createService({ adapter, seenFilter: 'bloom' });
+      first.warmSeenFilter();
+      const snapshot = JSON.parse(JSON.stringify(first.exportSeenFilter(['https://example.com/news/visited'])));
+
+      const resumed = createService({ adapter, seenFilter: 'bloom' });
+      expect(resumed.importSeenFilter(snapshot)).toBe(true);
+      expect(resumed.getSeenFilterStats().ready).toBe(true);
+      expect(resumed.seenFilter.has('https://example.com/news/visited')).toBe(true);
+      expect(resumed.seenFilter.has('https://example.com/news/a')).toBe(true);
+    });
+  });
 });
@@ -0,0 +1,202 @@
+'use strict';
+
+const { WriteBehindBuffer } = require('../WriteBehindBuffer');
+const CheckpointManager = require('../checkpoint/CheckpointManager');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+// better-sqlite3-shaped handle that records transaction boundaries
+function fakeAdapter() {
+  const log = [];
+  const db = {
+    transaction: (fn) => (...args) => {
+      log.push('BEGIN');
+      const result = fn(...args);
+      log.push('COMMIT');
+      return result;
+    }
+  };
+  const adapter = {
+    log,
+    getDb: () => ({ db }),
+    insertFetch: jest.fn((row) => log.push(`fetch:${row.url}`)),
+    insertLink: jest.fn((row) => log.push(`link:${row.dst_url}`)),
+    insertHttpResponse: jest.fn(async () => { log.push('http'); }),
+    upsertArticle: jest.fn((row) => {
+      if (row.url.includes('broken')) throw new Error('constraint failed');
+      log.push(`article:${row.url}`);
+      return { changes: 1 };
+    }),
+    insertError: jest.fn((row) => log.push(`error:${row.url}`)),
+    getArticleCount: jest.fn(() => log.filter((entry) => entry.startsWith('article:')).length),
+    close: jest.fn(() => log.push('close')),
+    isEnabled: () => true
+  };
+  return adapter;
+}
+
+describe('WriteBehindBuffer', () => {
+  let buffer;
+
+  afterEach(() => {
+    buffer?.close();
+    buffer = null;
+  });
+
+  test('defers buffered writes and commits them in one transaction', () => {
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+
+    const placeholder = adapter.upsertArticle({ url: 'https://a.test/story' });
+    expect(placeholder).toMatchObject({ deferred: true });
+    expect(typeof placeholder.onSettled).toBe('function');
+    adapter.insertFetch({ url: 'https://a.test/story' });
+    adapter.insertLink({ dst_url: 'https://a.test/next' });
+    adapter.insertHttpResponse({ url: 'https://a.test/story' });
+    expect(target.log).toEqual([]);
+    expect(adapter.isEnabled()).toBe(true);
+
+    expect(buffer.flush()).toMatchObject({ rows: 4, failed: 0 });
+    expect(target.log).toEqual(['BEGIN', 'article:https://a.test/story', 'fetch:https://a.test/story', 'link:https://a.test/next', 'http', 'COMMIT']);
+  });
+
+  test('flushes when maxRows are pending and before reads and close', () => {
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, maxRows: 2, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+
+    adapter.insertLink({ dst_url: '/1' });
+    expect(target.insertLink).not.toHaveBeenCalled();
+    adapter.insertLink({ dst_url: '/2' });
+    expect(target.insertLink).toHaveBeenCalledTimes(2);
+
+    adapter.upsertArticle({ url: 'https://a.test/x' });
+    expect(adapter.getArticleCount()).toBe(1);
+
+    adapter.insertFetch({ url: 'https://a.test/x' });
+    adapter.close();
+    expect(target.log.slice(-3)).toEqual(['fetch:https://a.test/x', 'COMMIT', 'close']);
+
+    const stats = buffer.getStats();
+    expect(stats).toMatchObject({ queueDepth: 0, flushes: 3, rowsFlushed: 4, maxQueueDepth: 2 });
+    expect(stats.flushReasons).toMatchObject({ size: 1, read: 1, close: 1 });
+    expect(stats.avgFlushMs).toBeGreaterThanOrEqual(0);
+  });
+
+  test('a failing write does not roll back the batch and is recorded as an error', () => {
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+    const failed = [];
+    buffer.on('write-failed', (event) => failed.push(event));
+
+    adapter.upsertArticle({ url: 'https://a.test/broken' });
+    adapter.upsertArticle({ url: 'https://a.test/fine' });
+    expect(buffer.flush()).toMatchObject({ rows: 2, failed: 1 });
+
+    expect(target.log).toEqual(['BEGIN', 'article:https://a.test/fine', 'COMMIT', 'error:https://a.test/broken']);
+    expect(failed).toHaveLength(1);
+    expect(failed[0]).toMatchObject({ method: 'upsertArticle', url: 'https://a.test/broken' });
+    expect(buffer.getStats().failedWrites).toBe(1);
+  });
+
+  test('settles deferred writes only when their flush commits or fails', () => {
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+    const outcomes = [];
+
+    adapter.upsertArticle({ url: 'https://a.test/fine' }).onSettled((ok) => outcomes.push(['fine', ok]));
+    adapter.upsertArticle({ url: 'https://a.test/broken' }).onSettled((ok, error) => outcomes.push(['broken', ok, error.message]));
+    expect(outcomes).toEqual([]);
+
+    buffer.flush();
+    expect(outcomes).toEqual([['fine', true], ['broken', false, 'constraint failed']]);
+
+    // Registered after a size flush already committed the row: runs inline
+    const sized = new WriteBehindBuffer({ target, maxRows: 1, flushIntervalMs: 60_000 });
+    let late = null;
+    sized.wrap().upsertArticle({ url: 'https://a.test/sized' }).onSettled((ok) => { late = ok; });
+    expect(late).toBe(true);
+    sized.close();
+  });
+
+  test('ArticleProcessor counts and caches write-behind saves on commit', async () => {
+    const { ArticleProcessor } = require('../ArticleProcessor');
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+    const knownArticlesCache = new Map();
+    const committed = [];
+    const processor = new ArticleProcessor({
+      linkExtractor: { extract: () => ({ navigation: [], articles: [], all: [] }) },
+      normalizeUrl: (url) => url,
+      looksLikeArticle: () => true,
+      computeUrlSignals: () => ({}),
+      computeContentSignals: () => ({}),
+      combineSignals: () => ({}),
+      dbAdapter: () => adapter,
+      knownArticlesCache,
+      logger: { log: () => {}, warn: () => {}, error: () => {} },
+      onSaveCommitted: (event) => committed.push(event)
+    });
+    const html = '<html><body><h1>Story</h1><p>Some words.</p></body></html>';
+
+    const fine = await processor.process({ url: 'https://a.test/fine', html, insertFetchRecord: false, insertLinkRecords: false });
+    const broken = await processor.process({ url: 'https://a.test/broken', html, insertFetchRecord: false, insertLinkRecords: false });
+    expect(fine.statsDelta).toMatchObject({ articlesSaved: 0, articlesDeferred: 1 });
+    expect(broken.statsDelta).toMatchObject({ articlesSaved: 0, articlesDeferred: 1 });
+    expect(knownArticlesCache.size).toBe(0);
+
+    buffer.flush();
+    expect(committed).toEqual([{ kind: 'article', url: 'https://a.test/fine' }]);
+    expect(knownArticlesCache.has('https://a.test/fine')).toBe(true);
+    expect(knownArticlesCache.has('https://a.test/broken')).toBe(false);
+  });
+
+  test('checkpoint save barriers commit pending rows before the checkpoint is written', () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'write-behind-cp-'));
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+    const manager = new CheckpointManager({ checkpointDir: dir, beforeSave: () => buffer.flush('checkpoint') });
+
+    adapter.insertFetch({ url: 'https://a.test/cp' });
+    manager.save({ version: 1, jobId: 'job', timestamp: new Date().toISOString() });
+    expect(target.insertFetch).toHaveBeenCalledTimes(1);
+    expect(buffer.getStats().flushReasons.checkpoint).toBe(1);
+
+    manager.on('error', () => {});
+    manager.addSaveBarrier(() => { throw new Error('disk full'); });
+    expect(() => manager.save({ version: 1, jobId: 'job2', timestamp: new Date().toISOString() })).toThrow('disk full');
+    expect(manager.list('job2')).toHaveLength(0);
+
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  test('forOrchestrator flushes the crawler buffer on every checkpoint save', () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'write-behind-orch-'));
+    const target = fakeAdapter();
+    buffer = new WriteBehindBuffer({ target, flushIntervalMs: 60_000 });
+    const adapter = buffer.wrap();
+    let onCheckpoint = null;
+    const orchestrator = {
+      context: { jobId: 'orch' },
+      crawler: { flushPendingWrites: (reason) => buffer.flush(reason) },
+      on: (event, handler) => { if (event === 'checkpoint') onCheckpoint = handler; },
+      emit: jest.fn()
+    };
+    const manager = CheckpointManager.forOrchestrator(orchestrator, { checkpointDir: dir });
+
+    adapter.upsertArticle({ url: 'https://a.test/acked' });
+    onCheckpoint({ version: '1.0', jobId: 'orch', timestamp: new Date().toISOString(), context: {}, plan: {} });
+
+    expect(target.log).toEqual(['BEGIN', 'article:https://a.test/acked', 'COMMIT']);
+    expect(buffer.getStats().flushReasons.checkpoint).toBe(1);
+    expect(manager.list('orch')).toHaveLength(1);
+
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+});
@@ -166,6 +166,85 @@ describe('PageExecutionService', () => {
     });
   });
 
+  test('shares one parsed document between discovery and content acquisition', async () => {
+    const deps = baseDeps();
+    const pageEvents = [];
+    deps.emitPageEvent = (event) => pageEvents.push(event);
+    deps.fetchPipeline.fetch.mockResolvedValue({
+      source: 'network',
+      meta: { url: 'https://example.com/article', fetchMeta: {} },
+      html: '<html><body><p>hello</p></body></html>'
+    });
+    deps.contentAcquisitionService.acquire.mockResolvedValue({ statsDelta: {} });
+
+    const service = new PageExecutionService(deps);
+    await service.processPage({ url: 'https://example.com/article', depth: 0, context: {} });
+
+    const discoverArgs = deps.navigationDiscoveryService.discover.mock.calls[0][0];
+    const acquireArgs = deps.contentAcquisitionService.acquire.mock.calls[0][0];
+    expect(discoverArgs.parsedDocument).toBeDefined();
+    expect(acquireArgs.parsedDocument).toBe(discoverArgs.parsedDocument);
+    expect(pageEvents[pageEvents.length - 1].parsesAvoided).toBe(0);
+  });
+
+  test('disposes the parsed document when processing throws', async () => {
+    const deps = baseDeps();
+    deps.fetchPipeline.fetch.mockResolvedValue({
+      source: 'network',
+      meta: { url: 'https://example.com/article', fetchMeta: {} },
+      html: '<html><body><p>hello</p></body></html>'
+    });
+    deps.contentAcquisitionService.acquire.mockResolvedValue({ statsDelta: {} });
+    deps.milestoneTracker.checkAnalysisMilestones.mockImplementation(() => {
+      throw new Error('milestone failure');
+    });
+
+    const service = new PageExecutionService(deps);
+    await expect(service.processPage({ url: 'https://example.com/article', depth: 0, context: {} }))
+      .rejects.toThrow('milestone failure');
+
+    const { parsedDocument } = deps.navigationDiscoveryService.discover.mock.calls[0][0];
+    expect(parsedDocument._disposed).toBe(true);
+  });
+
+  test('does not persist truncated bodies', async () => {
+    const deps = baseDeps();
+    deps.getDbAdapter = () => ({ isEnabled: () => true });
+    deps.fetchPipeline.fetch.mockResolvedValue({
+      source: 'network',
+      meta: { url: 'https://example.com/article', fetchMeta: { bodyTruncated: true } },
+      html: '<html><body><p>partial'
+    });
+    deps.contentAcquisitionService.acquire.mockResolvedValue({ statsDelta: {} });
+
+    const service = new PageExecutionService(deps);
+    await service.processPage({ url: 'https://example.com/article', depth: 0, context: {} });
+
+    const acquireArgs = deps.contentAcquisitionService.acquire.mock.calls[0][0];
+    expect(acquireArgs.persistArticle).toBe(false);
+    expect(acquireArgs.insertLinkRecords).toBe(true);
+  });
+
+  test('marks saved pages as processed for the seen-URL filter', async () => {
+    const deps = baseDeps();
+    deps.noteProcessed = jest.fn();
+    deps.fetchPipeline.fetch.mockResolvedValue({
+      source: 'network',
+      meta: { url: 'https://example.com/article', fetchMeta: {} },
+      html: '<html></html>'
+    });
+    deps.contentAcquisitionService.acquire
+      .mockResolvedValueOnce({ statsDelta: { articlesFound: 1, articlesSaved: 1 } })
+      .mockResolvedValueOnce({ statsDelta: { articlesFound: 1, articlesSaved: 0 } });
+
+    const service = new PageExecutionService(deps);
+    await service.processPage({ url: 'https://example.com/article', depth: 1, context: {} });
+    await service.processPage({ url: 'https://example.com/unsaved', depth: 1, context: {} });
+
+    expect(deps.noteProcessed).toHaveBeenCalledTimes(1);
+    expect(deps.noteProcessed).toHaveBeenCalledWith('https://example.com/article');
+  });
+
   test('marks seeded country hubs as visited and emits milestone', async () => {
     const deps = baseDeps();
     deps.telemetry = {
@@ -27,6 +27,25 @@ describe('QueueManager basic', () => {
     expect(third).toBeNull();
   });
 
+  test('records enqueue and dequeue deltas in a checkpoint journal', async () => {
+    const urlEligibilityService = {
+      evaluate: ({ url }) => ({ status: 'allow', normalized: url, kind: 'hub', queueKey: url })
+    };
+    const journal = { recordEnqueued: jest.fn(), recordDequeued: jest.fn() };
+    const qm = new QueueManager({
+      urlEligibilityService,
+      usePriorityQueue: false,
+      isTotalPrioritisationEnabled: () => false
+    });
+    qm.setJournal(journal);
+
+    qm.enqueue({ url: 'http://example.com/hub', depth: 0, type: 'hub' });
+    await qm.pullNext();
+
+    expect(journal.recordEnqueued).toHaveBeenCalledWith(expect.objectContaining({ url: 'http://example.com/hub', depth: 0, type: 'hub' }));
+    expect(journal.recordDequeued).toHaveBeenCalledWith('http://example.com/hub');
+  });
+
   test('priority queue pops higher priority item first', async () => {
     const urlEligibilityService = {
       evaluate: ({ url }) => ({ status: 'allow', normalized: url, kind: 'article', queueKey: url })
@@ -453,4 +472,30 @@ describe('QueueManager basic', () => {
     const second = await qm.pullNext();
     expect(second).toBeNull();
   });
+
+  test('pullNext waits on pull gate before serving', async () => {
+    const urlEligibilityService = {
+      evaluate: ({ url }) => ({ status: 'allow', normalized: url, kind: 'article', queueKey: url })
+    };
+    let release;
+    let gate = new Promise((resolve) => { release = resolve; });
+    const qm = new QueueManager({
+      urlEligibilityService,
+      usePriorityQueue: false,
+      isTotalPrioritisationEnabled: () => false,
+      pullGate: () => gate
+    });
+
+    qm.enqueue({ url: 'http://example.com/article/1', depth: 1, type: 'article' });
+
+    let served = null;
+    const pending = qm.pullNext().then((res) => { served = res; });
+    await Promise.resolve();
+    expect(served).toBeNull();
+
+    gate = null;
+    release();
+    await pending;
+    expect(served.item.url).toBe('http://example.com/article/1');
+  });
 });
@@ -0,0 +1,407 @@
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const readline = require('readline');
+const EventEmitter = require('events');
+
+/**
+ * CheckpointJournal - append-only delta log of crawl progress.
+ *
+ * Instead of re-serializing the whole frontier and seen-set on each
+ * checkpoint, queue and visit changes are appended as NDJSON records and a
+ * checkpoint only writes what changed since the previous one:
+ *
+ *   {"t":"e","u":url,"d":depth,"k":type,"p":priority}   enqueued
+ *   {"t":"x","u":url}                                   dequeued
+ *   {"t":"v","u":url}                                   visited
+ *   {"t":"c","s":seq,"at":iso,"m":meta}                 commit (small checkpoint state)
+ *
+ * Files, for a journal named <name>:
+ *
+ *   <dir>/<name>.base.ndjson         compacted snapshot (same record format)
+ *   <dir>/<name>.delta.<n>.ndjson    sealed segments waiting for compaction
+ *   <dir>/<name>.delta.ndjson        live segment
+ *
+ * Compaction seals the live segment (a rename, so appends continue into a
+ * fresh file), streams base + sealed segments into a new base written to a
+ * temp file and renamed into place, then deletes the sealed segments. Every
+ * record is a last-writer-wins fact about one URL, so replaying a sealed
+ * segment that a crash left behind after its base was replaced is harmless.
+ *
+ * Deltas reach the live segment every writeBatchSize records, ahead of their
+ * commit. Replay therefore applies a delta only once the commit record after
+ * it has been read; records past the last commit belong to a checkpoint that
+ * never happened. Compaction carries such a tail over after the new base's
+ * commit record, so a later commit in the live segment still covers it.
+ *
+ * restore() is a streaming replay (base, sealed, live); a torn last line
+ * from a crash mid-append is skipped and counted. When it finds a torn line
+ * or an uncommitted tail, it rewrites the journal as a base snapshot of the
+ * committed state, so appends from the resumed crawl cannot revive them.
+ *
+ * File writes go through `io` (CheckpointManager.journalFileIo by default),
+ * which keeps checkpoint files to the one writer the persistence guards
+ * track.
+ *
+ * @extends EventEmitter
+ */
+class CheckpointJournal extends EventEmitter {
+  /**
+   * @param {Object} options
+   * @param {string} options.dir - Directory for journal files (created if missing)
+   * @param {string} [options.name='checkpoint'] - File name stem
+   * @param {number} [options.writeBatchSize=512] - Buffered records before a disk append
+   * @param {number} [options.compactAfterRecords=100000] - Delta records that trigger compaction on commit (0 disables)
+   * @param {boolean} [options.fsync=false] - fsync the live segment on every commit
+   * @param {{append: Function, fsync: Function, writeLines: Function}} [options.io] - File writes
+   */
+  constructor(options = {}) {
+    super();
+    if (!options.dir || typeof options.dir !== 'string') {
+      throw new Error('CheckpointJournal requires a dir');
+    }
+    this.dir = options.dir;
+    this.name = options.name || 'checkpoint';
+    this.writeBatchSize = Math.max(1, options.writeBatchSize || 512);
+    this.compactAfterRecords = options.compactAfterRecords ?? 100000;
+    this.fsync = options.fsync === true;
+    // Lazy: CheckpointManager requires this module
+    this._io = options.io || require('./CheckpointManager').journalFileIo;
+
+    this.basePath = path.join(this.dir, `${this.name}.base.ndjson`);
+    this.livePath = path.join(this.dir, `${this.name}.delta.ndjson`);
+
+    this._buffer = [];
+    this._seq = 0;
+    this._recordsSinceCommit = 0;
+    this._recordsSinceCompact = 0;
+    this._compacting = null;
+    this._stats = {
+      records: 0,
+      commits: 0,
+      bytesWritten: 0,
+      lastCommitBytes: 0,
+      compactions: 0,
+      lastCompactMs: null
+    };
+
+    fs.mkdirSync(this.dir, { recursive: true });
+    this._nextSealed = this._sealedSegments().reduce((max, segment) => Math.max(max, segment.n), 0) + 1;
+  }
+
+  recordEnqueued({ url, depth = null, type = null, priority = null } = {}) {
+    if (!url) return;
+    this._append({ t: 'e', u: url, d: depth, k: type, p: priority });
+  }
+
+  recordDequeued(url) {
+    if (!url) return;
+    this._append({ t: 'x', u: url });
+  }
+
+  recordVisited(url) {
+    if (!url) return;
+    this._append({ t: 'v', u: url });
+  }
+
+  _append(record) {
+    this._buffer.push(JSON.stringify(record));
+    this._recordsSinceCommit += 1;
+    this._recordsSinceCompact += 1;
+    this._stats.records += 1;
+    if (this._buffer.length >= this.writeBatchSize) {
+      this.flush();
+    }
+  }
+
+  /**
+   * Append buffered records to the live segment.
+   * @returns {number} Bytes written
+   */
+  flush() {
+    if (this._buffer.length === 0) return 0;
+    const payload = this._buffer.join('\n') + '\n';
+    this._buffer = [];
+    this._io.append(this.livePath, payload);
+    const bytes = Buffer.byteLength(payload);
+    this._stats.bytesWritten += bytes;
+    return bytes;
+  }
+
+  /**
+   * Mark a checkpoint: flush pending deltas plus a commit record carrying
+   * `meta`. Cost is proportional to the records since the last commit.
+   * Starts a background compaction once enough deltas have piled up.
+   *
+   * @param {Object} [meta] - Small checkpoint state (counters, plan, budget)
+   * @returns {{seq: number, records: number, bytes: number, path: string}}
+   */
+  commit(meta = null) {
+    this._seq += 1;
+    const records = this._recordsSinceCommit;
+    this._buffer.push(JSON.stringify({ t: 'c', s: this._seq, at: new Date().toISOString(), m: meta }));
+    const bytes = this.flush();
+    if (this.fsync) {
+      this._io.fsync(this.livePath);
+    }
+    this._recordsSinceCommit = 0;
+    this._stats.commits += 1;
+    this._stats.lastCommitBytes = bytes;
+
+    if (this.compactAfterRecords > 0 && this._recordsSinceCompact >= this.compactAfterRecords && !this._compacting) {
+      this.compact().catch((error) => this.emit('error', { operation: 'compact', error }));
+    }
+    return { seq: this._seq, records, bytes, path: this.livePath };
+  }
+
+  /**
+   * Fold the sealed deltas into a new base snapshot. Appends keep going to
+   * the live segment while this runs; concurrent calls share one run.
+   * @returns {Promise<{frontier: number, visited: number, durationMs: number}>}
+   */
+  compact() {
+    if (this._compacting) return this._compacting;
+    this._compacting = this._compact().finally(() => {
+      this._compacting = null;
+    });
+    return this._compacting;
+  }
+
+  async _compact() {
+    const started = Date.now();
+    this.flush();
+    if (fs.existsSync(this.livePath)) {
+      fs.renameSync(this.livePath, this._sealedPath(this._nextSealed++));
+    }
+    this._recordsSinceCompact = 0;
+
+    const sealed = this._sealedSegments();
+    const state = createState();
+    for (const file of [this.basePath, ...sealed.map((segment) => segment.path)]) {
+      await replayFile(file, (record) => applyRecord(state, record), state);
+    }
+
+    await this._writeBase(state, { keepTail: true });
+    for (const segment of sealed) {
+      try { fs.unlinkSync(segment.path); } catch (_) { /* already gone */ }
+    }
+
+    const result = { frontier: state.frontier.size, visited: state.visited.size, durationMs: Date.now() - started };
+    this._stats.compactions += 1;
+    this._stats.lastCompactMs = result.durationMs;
+    this.emit('compacted', result);
+    return result;
+  }
+
+  /**
+   * @private
+   */
+  async _writeBase(state, { keepTail }) {
+    const tempPath = this.basePath + '.tmp';
+    await this._io.writeLines(tempPath, baseLines(state, keepTail));
+    fs.renameSync(tempPath, this.basePath);
+  }
+
+  /**
+   * Stream every record (base, sealed, live) to `onRecord` in order,
+   * committed or not.
+   * @param {(record: Object) => void} onRecord
+   * @returns {Promise<{records: number, corruptLines: number}>}
+   */
+  async replay(onRecord) {
+    if (this._compacting) await this._compacting;
+    this.flush();
+    const counters = { records: 0, corruptLines: 0 };
+    const files = [this.basePath, ...this._sealedSegments().map((segment) => segment.path), this.livePath];
+    for (const file of files) {
+      await replayFile(file, (record) => {
+        counters.records += 1;
+        onRecord(record);
+      }, counters);
+    }
+    return counters;
+  }
+
+  /**
+   * Rebuild the committed crawl state by streaming replay. Call it before
+   * recording into a journal a previous run left behind.
+   * @returns {Promise<{meta: Object|null, seq: number, frontier: Object[], visited: Set<string>, records: number, corruptLines: number, discarded: number}|null>}
+   *   null when nothing was committed
+   */
+  async restore() {
+    const state = createState();
+    const { records, corruptLines } = await this.replay((record) => applyRecord(state, record));
+    if (records === 0) return null;
+    if (!state.committed) {
+      // Only a torn or uncommitted first checkpoint
+      this.clear();
+      return null;
+    }
+    const discarded = state.pending.length;
+    if (discarded > 0 || corruptLines > 0) {
+      const sealed = this._sealedSegments();
+      await this._writeBase(state, { keepTail: false });
+      for (const file of [this.livePath, ...sealed.map((segment) => segment.path)]) {
+        try { fs.unlinkSync(file); } catch (_) { /* not there */ }
+      }
+      this._recordsSinceCompact = 0;
+    }
+    this._seq = Math.max(this._seq, state.seq);
+    return {
+      meta: state.meta,
+      seq: state.seq,
+      frontier: [...state.frontier.values()],
+      visited: state.visited,
+      records,
+      corruptLines,
+      discarded
+    };
+  }
+
+  /** @returns {boolean} */
+  exists() {
+    return fs.existsSync(this.basePath) || fs.existsSync(this.livePath) || this._sealedSegments().length > 0;
+  }
+
+  /**
+   * Delete every journal file.
+   * @returns {number} Files removed
+   */
+  clear() {
+    this._buffer = [];
+    let removed = 0;
+    for (const file of [this.basePath, this.livePath, ...this._sealedSegments().map((segment) => segment.path)]) {
+      try {
+        fs.unlinkSync(file);
+        removed++;
+      } catch (_) { /* not there */ }
+    }
+    this._recordsSinceCommit = 0;
+    this._recordsSinceCompact = 0;
+    return removed;
+  }
+
+  close() {
+    this.flush();
+  }
+
+  getStats() {
+    return {
+      ...this._stats,
+      seq: this._seq,
+      buffered: this._buffer.length,
+      pendingRecords: this._recordsSinceCommit,
+      recordsSinceCompact: this._recordsSinceCompact,
+      sealedSegments: this._sealedSegments().length,
+      compacting: !!this._compacting
+    };
+  }
+
+  _sealedPath(n) {
+    return path.join(this.dir, `${this.name}.delta.${n}.ndjson`);
+  }
+
+  _sealedSegments() {
+    const prefix = `${this.name}.delta.`;
+    let files;
+    try {
+      files = fs.readdirSync(this.dir);
+    } catch (_) {
+      return [];
+    }
+    return files
+      .filter((file) => file.startsWith(prefix) && file.endsWith('.ndjson'))
+      .map((file) => ({ n: Number(file.slice(prefix.length, -'.ndjson'.length)), path: path.join(this.dir, file) }))
+      .filter((segment) => Number.isInteger(segment.n) && segment.n > 0)
+      .sort((a, b) => a.n - b.n);
+  }
+}
+
+function createState() {
+  return { meta: null, seq: 0, committed: false, frontier: new Map(), visited: new Set(), pending: [], corruptLines: 0 };
+}
+
+/**
+ * Stage a delta, or apply the staged deltas on a commit record
+ */
+function applyRecord(state, record) {
+  if (record.t !== 'c') {
+    state.pending.push(record);
+    return;
+  }
+  for (const delta of state.pending) {
+    applyDelta(state, delta);
+  }
+  state.pending = [];
+  state.committed = true;
+  state.meta = record.m ?? null;
+  state.seq = Math.max(state.seq, record.s || 0);
+}
+
+function applyDelta(state, record) {
+  switch (record.t) {
+    case 'e':
+      // Re-enqueue moves the URL to the back, matching the latest priority
+      state.frontier.delete(record.u);
+      state.frontier.set(record.u, { url: record.u, depth: record.d ?? null, type: record.k ?? null, priority: record.p ?? null });
+      break;
+    case 'x':
+      state.frontier.delete(record.u);
+      break;
+    case 'v':
+      state.visited.add(record.u);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Committed state as deltas followed by their commit record, then (with
+ * keepTail) the uncommitted records still waiting for a commit
+ */
+function* baseLines(state, keepTail) {
+  for (const url of state.visited) {
+    yield JSON.stringify({ t: 'v', u: url });
+  }
+  for (const item of state.frontier.values()) {
+    yield JSON.stringify({ t: 'e', u: item.url, d: item.depth, k: item.type, p: item.priority });
+  }
+  if (state.committed) {
+    yield JSON.stringify({ t: 'c', s: state.seq, at: new Date().toISOString(), m: state.meta });
+  }
+  if (keepTail) {
+    for (const record of state.pending) {
+      yield JSON.stringify(record);
+    }
+  }
+}
+
+async function replayFile(file, onRecord, counters) {
+  let stream;
+  try {
+    stream = fs.createReadStream(file, { encoding: 'utf8' });
+    await new Promise((resolve, reject) => {
+      stream.once('open', resolve);
+      stream.once('error', reject);
+    });
+  } catch (error) {
+    if (error.code === 'ENOENT') return;
+    throw error;
+  }
+  const lines = readline.createInterface({ input: stream, crlfDelay: Infinity });
+  for await (const line of lines) {
+    if (!line) continue;
+    let record;
+    try {
+      record = JSON.parse(line);
+    } catch (_) {
+      counters.corruptLines += 1;
+      continue;
+    }
+    if (record && typeof record.t === 'string') onRecord(record);
+  }
+}
+
+module.exports = CheckpointJournal;
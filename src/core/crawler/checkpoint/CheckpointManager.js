@@ -3,6 +3,7 @@
 const fs = require('fs');
 const path = require('path');
 const EventEmitter = require('events');
+const CheckpointJournal = require('./CheckpointJournal');
 
 /**
  * CheckpointManager - Handles persistence of crawl checkpoints.
@@ -12,6 +13,12 @@ const EventEmitter = require('events');
  * - Rotation of checkpoint files
  * - Automatic cleanup of old checkpoints
  * - Validation on load
+ * - Save barriers: callbacks run before every save, so buffered state that a
+ *   checkpoint refers to (e.g. write-behind DB rows) is committed first
+ * - Delta mode (`journal`): save() commits to a per-job CheckpointJournal
+ *   instead of rewriting a full JSON snapshot, so its cost follows the
+ *   frontier/visited changes since the last save; restore() replays it and
+ *   CrawlOrchestrator.resume() loads the result into the crawler
  *
  * @extends EventEmitter
  */
@@ -22,6 +29,10 @@ class CheckpointManager extends EventEmitter {
    * @param {string} options.prefix - Filename prefix (default: 'checkpoint')
    * @param {number} options.maxCheckpoints - Max checkpoints to keep (default: 5)
    * @param {boolean} options.compress - Whether to gzip checkpoints (default: false)
+   * @param {Function|Function[]} options.beforeSave - Save barrier(s), see addSaveBarrier()
+   * @param {boolean|Object} options.journal - Delta mode; an object is passed to CheckpointJournal
+   * @param {string[]} options.journalOmit - Checkpoint fields left out of journal commits
+   *   (default ['seenUrls']: the seen set is rebuilt from visited records)
    */
   constructor(options = {}) {
     super();
@@ -30,6 +41,13 @@ class CheckpointManager extends EventEmitter {
     this.prefix = options.prefix || 'checkpoint';
     this.maxCheckpoints = options.maxCheckpoints || 5;
     this.compress = options.compress || false;
+    this.journalOptions = options.journal ? (typeof options.journal === 'object' ? options.journal : {}) : null;
+    this.journalOmit = options.journalOmit || ['seenUrls'];
+    this._journals = new Map(); // jobId -> CheckpointJournal
+    this._saveBarriers = [];
+    for (const fn of [].concat(options.beforeSave || [])) {
+      this.addSaveBarrier(fn);
+    }
 
     this._ensureDir();
   }
@@ -44,6 +62,22 @@ class CheckpointManager extends EventEmitter {
     }
   }
 
+  /**
+   * Register a synchronous callback that runs before every save(). If it
+   * throws, the checkpoint is not written.
+   * @param {Function} fn
+   * @returns {Function} Unregister function
+   */
+  addSaveBarrier(fn) {
+    if (typeof fn !== 'function') {
+      throw new Error('addSaveBarrier requires a function');
+    }
+    this._saveBarriers.push(fn);
+    return () => {
+      this._saveBarriers = this._saveBarriers.filter((barrier) => barrier !== fn);
+    };
+  }
+
   /**
    * Generate checkpoint filename.
    * @private
@@ -64,8 +98,26 @@ class CheckpointManager extends EventEmitter {
       throw new Error('Checkpoint data is required');
     }
 
+    // A checkpoint must never reference state that is not yet durable
+    for (const barrier of this._saveBarriers) {
+      try {
+        barrier(checkpoint);
+      } catch (error) {
+        this.emit('error', { operation: 'barrier', error });
+        throw error;
+      }
+    }
+
+    if (this.journalOptions) {
+      return this._commitToJournal(checkpoint);
+    }
+
     const filename = this._generateFilename(checkpoint.jobId);
-    const filepath = path.join(this.checkpointDir, filename);
+    let filepath = path.join(this.checkpointDir, filename);
+    // Two saves within one millisecond would otherwise overwrite each other
+    for (let n = 1; fs.existsSync(filepath); n++) {
+      filepath = path.join(this.checkpointDir, filename.replace(/\.json$/, `-${n}.json`));
+    }
     const tempPath = filepath + '.tmp';
 
     // Serialize with pretty print for debuggability
@@ -92,6 +144,110 @@ class CheckpointManager extends EventEmitter {
     }
   }
 
+  /**
+   * Save the orchestrator's checkpoints through this manager. In journal mode
+   * the crawler's queue and state record their deltas into the job journal
+   * from here on, so attach after any restored state has been loaded.
+   * @param {CrawlOrchestrator} orchestrator
+   * @returns {CheckpointManager}
+   */
+  attach(orchestrator) {
+    const crawler = orchestrator.crawler;
+    // Commit the crawler's write-behind buffer before every save so a
+    // checkpoint never records progress the DB does not have yet
+    if (crawler && typeof crawler.flushPendingWrites === 'function') {
+      this.addSaveBarrier(() => crawler.flushPendingWrites('checkpoint'));
+    }
+
+    if (this.journalOptions) {
+      const journal = this.journalFor(orchestrator.context?.jobId || null);
+      crawler?.queue?.setJournal?.(journal);
+      crawler?.state?.setJournal?.(journal);
+      // Visited records replace the bulky seen-filter export
+      orchestrator._checkpointSeenUrls = false;
+    }
+
+    // Wire up checkpoint event from orchestrator
+    orchestrator.on('checkpoint', (checkpoint) => {
+      try {
+        const path = this.save(checkpoint);
+        orchestrator.emit('checkpoint:saved', { path });
+      } catch (error) {
+        orchestrator.emit('checkpoint:error', { error });
+      }
+    });
+
+    return this;
+  }
+
+  /**
+   * Journal for a job (delta mode). Callers record enqueue/dequeue/visit
+   * deltas on it between saves.
+   * @param {string} [jobId]
+   * @returns {CheckpointJournal}
+   */
+  journalFor(jobId = null) {
+    const key = jobId || '';
+    let journal = this._journals.get(key);
+    if (!journal) {
+      journal = new CheckpointJournal({
+        ...(this.journalOptions || {}),
+        dir: this.checkpointDir,
+        name: jobId ? `${this.prefix}-${jobId}` : this.prefix
+      });
+      journal.on('error', (event) => this.emit('error', { ...event, jobId }));
+      journal.on('compacted', (event) => this.emit('compacted', { ...event, jobId }));
+      this._journals.set(key, journal);
+    }
+    return journal;
+  }
+
+  /**
+   * @private
+   */
+  _commitToJournal(checkpoint) {
+    const meta = { ...checkpoint };
+    for (const field of this.journalOmit) {
+      delete meta[field];
+    }
+    try {
+      const result = this.journalFor(checkpoint.jobId).commit(meta);
+      this.emit('saved', { path: result.path, size: result.bytes, delta: true, records: result.records, seq: result.seq });
+      return result.path;
+    } catch (error) {
+      this.emit('error', { operation: 'save', error });
+      throw error;
+    }
+  }
+
+  /**
+   * Restore a job from its journal by streaming replay.
+   * @param {string} [jobId]
+   * @returns {Promise<{checkpoint: Object, frontier: Object[], visited: Set<string>, records: number, corruptLines: number}|null>}
+   */
+  async restore(jobId = null) {
+    const journal = this.journalFor(jobId);
+    if (!journal.exists()) return null;
+    try {
+      const state = await journal.restore();
+      if (!state) return null;
+      if (!this._validate(state.meta)) {
+        throw new Error('Invalid checkpoint journal');
+      }
+      this.emit('loaded', { path: journal.livePath, jobId: state.meta.jobId, delta: true });
+      return {
+        checkpoint: state.meta,
+        frontier: state.frontier,
+        visited: state.visited,
+        records: state.records,
+        corruptLines: state.corruptLines
+      };
+    } catch (error) {
+      this.emit('error', { operation: 'load', path: journal.livePath, error });
+      throw error;
+    }
+  }
+
   /**
    * Load the most recent checkpoint.
    * @param {string} jobId - Optional job ID to filter by
@@ -211,7 +367,7 @@ class CheckpointManager extends EventEmitter {
    */
   deleteForJob(jobId) {
     const checkpoints = this.list(jobId);
-    let deleted = 0;
+    let deleted = this.journalOptions ? this.journalFor(jobId).clear() : 0;
 
     for (const cp of checkpoints) {
       try {
@@ -256,20 +412,43 @@ CheckpointManager.forOrchestrator = function(orchestrator, options = {}) {
     checkpointDir: options.checkpointDir,
     prefix: options.prefix || orchestrator.context?.jobId || 'checkpoint',
     maxCheckpoints: options.maxCheckpoints,
-    compress: options.compress
-  });
-
-  // Wire up checkpoint event from orchestrator
-  orchestrator.on('checkpoint', (checkpoint) => {
-    try {
-      const path = manager.save(checkpoint);
-      orchestrator.emit('checkpoint:saved', { path });
-    } catch (error) {
-      orchestrator.emit('checkpoint:error', { error });
-    }
+    compress: options.compress,
+    beforeSave: options.beforeSave,
+    journal: options.journal,
+    journalOmit: options.journalOmit
   });
-
+  manager.attach(orchestrator);
   return manager;
 };
 
+/**
+ * File writes for CheckpointJournal. They live here so checkpoint files keep
+ * a single writer for the DB-only persistence guards.
+ */
+CheckpointManager.journalFileIo = Object.freeze({
+  append(file, text) {
+    fs.appendFileSync(file, text);
+  },
+
+  fsync(file) {
+    const fd = fs.openSync(file, 'r+');
+    try { fs.fsyncSync(fd); } finally { fs.closeSync(fd); }
+  },
+
+  async writeLines(file, lines) {
+    const out = fs.createWriteStream(file, { encoding: 'utf8' });
+    const done = new Promise((resolve, reject) => {
+      out.once('finish', resolve);
+      out.once('error', reject);
+    });
+    for (const line of lines) {
+      if (!out.write(line + '\n')) {
+        await new Promise((resolve) => out.once('drain', resolve));
+      }
+    }
+    out.end();
+    await done;
+  }
+});
+
 module.exports = CheckpointManager;
@@ -1,7 +1,9 @@
 'use strict';
 
 const CheckpointManager = require('./CheckpointManager');
+const CheckpointJournal = require('./CheckpointJournal');
 
 module.exports = {
-  CheckpointManager
+  CheckpointManager,
+  CheckpointJournal
 };
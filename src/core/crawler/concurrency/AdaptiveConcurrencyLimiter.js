@@ -0,0 +1,423 @@
+'use strict';
+
+const EventEmitter = require('events');
+const v8 = require('v8');
+const { monitorEventLoopDelay } = require('perf_hooks');
+const { LatencyHistogram } = require('../profiler/LatencyHistogram');
+
+/**
+ * AdaptiveConcurrencyLimiter - Latency-driven AIMD concurrency limits.
+ *
+ * Sizes concurrency globally and per host from live signals instead of
+ * queue depth:
+ * - p99 fetch latency against a slowly-tracked no-load baseline (gradient)
+ * - 429s (recorded directly or via a RateLimitTracker's 'rateLimit' events)
+ * - event-loop lag
+ * - heap pressure
+ *
+ * Every windowMs the limiter either adds `increaseStep` (no congestion
+ * signal and the limit was actually used) or multiplies by a decrease
+ * factor (congestion). 429s cut harder than latency so the crawler backs
+ * off before servers start throttling in earnest.
+ *
+ * Decisions are emitted as 'decision' events ({ scope, host, from, to,
+ * reason, signals }) and, when a telemetry bridge is supplied, through
+ * emitWorkerScaled. ConcurrencyController({ limiter }) caps its worker
+ * count at the global limit; per-host limits are enforced by callers via
+ * tryAcquire()/release().
+ *
+ * @extends EventEmitter
+ */
+
+const DEFAULT_OPTIONS = {
+  minLimit: 1,
+  maxLimit: 32,
+  initialLimit: 4,
+  minHostLimit: 1,
+  maxHostLimit: 4,
+  initialHostLimit: 2,
+  windowMs: 2000,
+  minSamples: 10,
+  latencyTolerance: 2.0,          // p99 above baseline * tolerance is congestion
+  baselineDecay: 0.05,            // How fast the baseline drifts up toward the observed p99
+  increaseStep: 1,
+  latencyDecrease: 0.75,
+  rateLimitDecrease: 0.5,
+  maxEventLoopLagMs: 100,
+  maxHeapRatio: 0.85,
+  utilizationThreshold: 0.8       // Only grow a limit that was at least 80% used
+};
+
+class AdaptiveConcurrencyLimiter extends EventEmitter {
+  /**
+   * @param {Object} options - See DEFAULT_OPTIONS for tuning knobs
+   * @param {Object} [options.rateLimitTracker] - RateLimitTracker; its 'rateLimit' events count as 429s
+   * @param {Object} [options.telemetry] - CrawlTelemetryBridge (or anything with emitWorkerScaled)
+   * @param {Function} [options.lagProvider] - () => event-loop lag ms (default: perf_hooks p99)
+   * @param {Function} [options.heapProvider] - () => used/limit heap ratio
+   * @param {Function} [options.now] - Clock (tests)
+   */
+  constructor(options = {}) {
+    super();
+    const opts = { ...DEFAULT_OPTIONS, ...options };
+    this.minLimit = opts.minLimit;
+    this.maxLimit = opts.maxLimit;
+    this.minHostLimit = opts.minHostLimit;
+    this.maxHostLimit = opts.maxHostLimit;
+    this.initialHostLimit = Math.min(Math.max(opts.initialHostLimit, this.minHostLimit), this.maxHostLimit);
+    this.windowMs = opts.windowMs;
+    this.minSamples = opts.minSamples;
+    this.latencyTolerance = opts.latencyTolerance;
+    this.baselineDecay = opts.baselineDecay;
+    this.increaseStep = opts.increaseStep;
+    this.latencyDecrease = opts.latencyDecrease;
+    this.rateLimitDecrease = opts.rateLimitDecrease;
+    this.maxEventLoopLagMs = opts.maxEventLoopLagMs;
+    this.maxHeapRatio = opts.maxHeapRatio;
+    this.utilizationThreshold = opts.utilizationThreshold;
+    this.telemetry = opts.telemetry || null;
+    this.now = opts.now || Date.now;
+    this.lagProvider = opts.lagProvider || null;
+    this.heapProvider = opts.heapProvider || defaultHeapRatio;
+
+    this.limit = Math.min(Math.max(opts.initialLimit, this.minLimit), this.maxLimit);
+    this.inFlight = 0;
+
+    this._global = createWindow();
+    this._hosts = new Map();     // host -> { limit, inFlight, window, baselineMs }
+    this._baselineMs = null;
+    this._lastEvaluatedAt = this.now();
+    this._timer = null;
+    this._lagMonitor = null;
+
+    this._metrics = {
+      decisions: 0,
+      increases: 0,
+      decreases: 0,
+      rateLimits: 0,
+      rejected: 0
+    };
+
+    this.rateLimitTracker = opts.rateLimitTracker || null;
+    if (this.rateLimitTracker && typeof this.rateLimitTracker.on === 'function') {
+      this._onRateLimit = ({ domain }) => this.recordRateLimit(domain);
+      this.rateLimitTracker.on('rateLimit', this._onRateLimit);
+    }
+  }
+
+  /**
+   * Start periodic evaluation and event-loop lag sampling.
+   * @returns {AdaptiveConcurrencyLimiter}
+   */
+  start() {
+    if (this._timer) return this;
+    if (!this.lagProvider && typeof monitorEventLoopDelay === 'function') {
+      this._lagMonitor = monitorEventLoopDelay({ resolution: 20 });
+      this._lagMonitor.enable();
+    }
+    this._timer = setInterval(() => this.evaluate(), this.windowMs);
+    this._timer.unref?.();
+    return this;
+  }
+
+  /**
+   * Stop evaluation and detach from the rate limit tracker.
+   */
+  stop() {
+    if (this._timer) {
+      clearInterval(this._timer);
+      this._timer = null;
+    }
+    if (this._lagMonitor) {
+      this._lagMonitor.disable();
+      this._lagMonitor = null;
+    }
+    if (this.rateLimitTracker && this._onRateLimit) {
+      this.rateLimitTracker.off('rateLimit', this._onRateLimit);
+      this._onRateLimit = null;
+    }
+  }
+
+  /**
+   * Current limit for a host (or the global limit when host is omitted).
+   * @param {string} [host]
+   * @returns {number}
+   */
+  getLimit(host) {
+    if (!host) return this.limit;
+    return this._host(host).limit;
+  }
+
+  /**
+   * Claim a slot for a request to `host`. Returns false when the global or
+   * the host limit is reached; callers should pick other work or wait.
+   * @param {string} host
+   * @returns {boolean}
+   */
+  tryAcquire(host) {
+    const state = this._host(host);
+    if (this.inFlight >= this.limit || state.inFlight >= state.limit) {
+      this._metrics.rejected++;
+      return false;
+    }
+    this.inFlight++;
+    state.inFlight++;
+    state.window.peakInFlight = Math.max(state.window.peakInFlight, state.inFlight);
+    this._global.peakInFlight = Math.max(this._global.peakInFlight, this.inFlight);
+    return true;
+  }
+
+  /**
+   * Release a slot and record the outcome.
+   * @param {string} host
+   * @param {Object} [result]
+   * @param {number} [result.latencyMs] - Fetch latency
+   * @param {number} [result.status] - HTTP status (429 counts as a rate limit)
+   */
+  release(host, result = {}) {
+    const state = this._host(host);
+    this.inFlight = Math.max(0, this.inFlight - 1);
+    state.inFlight = Math.max(0, state.inFlight - 1);
+    if (Number.isFinite(result.latencyMs)) {
+      this.recordLatency(host, result.latencyMs);
+    }
+    if (result.status === 429) {
+      this.recordRateLimit(host);
+    }
+  }
+
+  /**
+   * Record a fetch latency sample.
+   * @param {string} host
+   * @param {number} latencyMs
+   */
+  recordLatency(host, latencyMs) {
+    this._global.latency.recordMs(latencyMs);
+    if (host) this._host(host).window.latency.recordMs(latencyMs);
+  }
+
+  /**
+   * Record a 429 / throttling response for a host.
+   * @param {string} host
+   */
+  recordRateLimit(host) {
+    this._metrics.rateLimits++;
+    this._global.rateLimits++;
+    if (host) this._host(host).window.rateLimits++;
+  }
+
+  /**
+   * Close the current window and adjust limits. Called on the timer; can be
+   * called directly (tests, or callers that drive their own loop).
+   * @returns {Object[]} Decisions made this window
+   */
+  evaluate() {
+    const now = this.now();
+    const elapsedMs = now - this._lastEvaluatedAt;
+    this._lastEvaluatedAt = now;
+    const decisions = [];
+
+    const signals = this._readSignals();
+    const globalDecision = this._adjust({
+      scope: 'global',
+      host: null,
+      current: this.limit,
+      min: this.minLimit,
+      max: this.maxLimit,
+      window: this._global,
+      baselineMs: this._baselineMs,
+      signals
+    });
+    if (globalDecision.baselineMs !== undefined) this._baselineMs = globalDecision.baselineMs;
+    if (globalDecision.to !== undefined) {
+      this.limit = globalDecision.to;
+      decisions.push(globalDecision);
+    }
+    resetWindow(this._global, this.inFlight);
+
+    for (const [host, state] of this._hosts) {
+      const hostDecision = this._adjust({
+        scope: 'host',
+        host,
+        current: state.limit,
+        min: this.minHostLimit,
+        max: this.maxHostLimit,
+        window: state.window,
+        baselineMs: state.baselineMs,
+        signals: null
+      });
+      if (hostDecision.baselineMs !== undefined) state.baselineMs = hostDecision.baselineMs;
+      if (hostDecision.to !== undefined) {
+        state.limit = hostDecision.to;
+        decisions.push(hostDecision);
+      }
+      // Forget hosts that went quiet at their starting limit
+      if (state.inFlight === 0 && state.window.latency.count === 0 && state.window.rateLimits === 0 && state.limit === this.initialHostLimit) {
+        this._hosts.delete(host);
+      } else {
+        resetWindow(state.window, state.inFlight);
+      }
+    }
+
+    for (const decision of decisions) {
+      decision.windowMs = elapsedMs;
+      this._metrics.decisions++;
+      if (decision.to > decision.from) this._metrics.increases++;
+      else this._metrics.decreases++;
+      this.emit('decision', decision);
+      if (this.telemetry && typeof this.telemetry.emitWorkerScaled === 'function') {
+        try {
+          this.telemetry.emitWorkerScaled({
+            from: decision.from,
+            to: decision.to,
+            reason: decision.host ? `${decision.host}: ${decision.reason}` : decision.reason
+          });
+        } catch (_) { /* telemetry is best-effort */ }
+      }
+    }
+    return decisions;
+  }
+
+  /**
+   * Snapshot of limits and signals for dashboards.
+   * @returns {Object}
+   */
+  getStats() {
+    const hosts = {};
+    for (const [host, state] of this._hosts) {
+      hosts[host] = { limit: state.limit, inFlight: state.inFlight, baselineMs: round(state.baselineMs) };
+    }
+    return {
+      limit: this.limit,
+      inFlight: this.inFlight,
+      baselineMs: round(this._baselineMs),
+      hosts,
+      metrics: { ...this._metrics }
+    };
+  }
+
+  /**
+   * One AIMD step. Returns { to, reason, ... } when the limit changes and
+   * always returns the updated baseline.
+   * @private
+   */
+  _adjust({ scope, host, current, min, max, window, baselineMs, signals }) {
+    const result = {};
+    const samples = window.latency.count;
+    const p99 = samples > 0 ? window.latency.percentile(99) : null;
+    const p50 = samples > 0 ? window.latency.percentile(50) : null;
+
+    // Baseline = best p99 seen at low load; creeps up slowly so a permanently
+    // slower host does not look congested forever
+    if (p99 !== null && samples >= this.minSamples) {
+      if (baselineMs === null || baselineMs === undefined || p99 < baselineMs) {
+        result.baselineMs = p99;
+      } else {
+        result.baselineMs = baselineMs + (p99 - baselineMs) * this.baselineDecay;
+      }
+    }
+    const baseline = result.baselineMs ?? baselineMs ?? null;
+
+    let factor = null;
+    let reason = null;
+    if (window.rateLimits > 0) {
+      factor = this.rateLimitDecrease;
+      reason = `429 x${window.rateLimits}`;
+    } else if (signals && signals.lagMs !== null && signals.lagMs > this.maxEventLoopLagMs) {
+      factor = this.latencyDecrease;
+      reason = `event-loop lag ${Math.round(signals.lagMs)}ms > ${this.maxEventLoopLagMs}ms`;
+    } else if (signals && signals.heapRatio !== null && signals.heapRatio > this.maxHeapRatio) {
+      factor = this.latencyDecrease;
+      reason = `heap ${Math.round(signals.heapRatio * 100)}% > ${Math.round(this.maxHeapRatio * 100)}%`;
+    } else if (baseline && samples >= this.minSamples && p99 > baseline * this.latencyTolerance) {
+      factor = this.latencyDecrease;
+      reason = `p99 ${Math.round(p99)}ms > ${this.latencyTolerance}x baseline ${Math.round(baseline)}ms`;
+    }
+
+    let next = current;
+    if (factor !== null) {
+      next = Math.max(min, Math.floor(current * factor));
+    } else if (samples >= this.minSamples && window.peakInFlight >= current * this.utilizationThreshold) {
+      next = Math.min(max, current + this.increaseStep);
+      reason = `healthy p99 ${Math.round(p99)}ms at ${window.peakInFlight}/${current} in flight`;
+    }
+
+    if (next !== current) {
+      Object.assign(result, {
+        scope,
+        host,
+        from: current,
+        to: next,
+        reason,
+        signals: {
+          p50Ms: round(p50),
+          p99Ms: round(p99),
+          baselineMs: round(baseline),
+          samples,
+          rateLimits: window.rateLimits,
+          peakInFlight: window.peakInFlight,
+          lagMs: signals ? round(signals.lagMs) : null,
+          heapRatio: signals && signals.heapRatio !== null ? Math.round(signals.heapRatio * 1000) / 1000 : null
+        }
+      });
+    }
+    return result;
+  }
+
+  /** @private */
+  _readSignals() {
+    let lagMs = null;
+    try {
+      if (this.lagProvider) {
+        lagMs = this.lagProvider();
+      } else if (this._lagMonitor) {
+        lagMs = this._lagMonitor.percentile(99) / 1e6;
+        this._lagMonitor.reset();
+      }
+    } catch (_) {
+      lagMs = null;
+    }
+    let heapRatio = null;
+    try {
+      heapRatio = this.heapProvider();
+    } catch (_) {
+      heapRatio = null;
+    }
+    return {
+      lagMs: Number.isFinite(lagMs) ? lagMs : null,
+      heapRatio: Number.isFinite(heapRatio) ? heapRatio : null
+    };
+  }
+
+  /** @private */
+  _host(host) {
+    const key = host || '';
+    let state = this._hosts.get(key);
+    if (!state) {
+      state = { limit: this.initialHostLimit, inFlight: 0, window: createWindow(), baselineMs: null };
+      this._hosts.set(key, state);
+    }
+    return state;
+  }
+}
+
+function createWindow() {
+  return { latency: new LatencyHistogram({ precisionBits: 4 }), rateLimits: 0, peakInFlight: 0 };
+}
+
+function resetWindow(window, inFlight) {
+  window.latency.reset();
+  window.rateLimits = 0;
+  window.peakInFlight = inFlight;
+}
+
+function defaultHeapRatio() {
+  const { heap_size_limit: limit } = v8.getHeapStatistics();
+  return limit > 0 ? process.memoryUsage().heapUsed / limit : null;
+}
+
+function round(value) {
+  return value === null || value === undefined ? null : Math.round(value * 10) / 10;
+}
+
+module.exports = { AdaptiveConcurrencyLimiter, DEFAULT_OPTIONS };
@@ -8,6 +8,7 @@ const EventEmitter = require('events');
  * Features:
  * - Spawn workers up to max limit
  * - Dynamic scaling based on queue depth and rate limits
+ * - Optional latency-driven cap from an AdaptiveConcurrencyLimiter
  * - Backpressure detection and worker reduction
  * - Graceful shutdown with drain
  *
@@ -23,6 +24,8 @@ class ConcurrencyController extends EventEmitter {
    * @param {number} options.scaleDownThreshold - Queue depth ratio to trigger scale down (default: 0.5)
    * @param {number} options.cooldownMs - Cooldown between scaling decisions (default: 5000)
    * @param {number} options.drainTimeoutMs - Max time to wait for workers to drain (default: 30000)
+   * @param {Object} options.limiter - AdaptiveConcurrencyLimiter; its global limit caps the worker count
+   * @param {Object} options.telemetry - CrawlTelemetryBridge; worker count changes go to emitWorkerScaled
    */
   constructor(options = {}) {
     super();
@@ -34,6 +37,8 @@ class ConcurrencyController extends EventEmitter {
     this.scaleDownThreshold = options.scaleDownThreshold ?? 0.5;
     this.cooldownMs = options.cooldownMs ?? 5000;
     this.drainTimeoutMs = options.drainTimeoutMs ?? 30000;
+    this.limiter = options.limiter || null;
+    this.telemetry = options.telemetry || null;
 
     // Worker state
     this._workers = new Map(); // workerId -> WorkerState
@@ -55,8 +60,21 @@ class ConcurrencyController extends EventEmitter {
       totalCompleted: 0,
       totalFailed: 0,
       scaleUpEvents: 0,
-      scaleDownEvents: 0
+      scaleDownEvents: 0,
+      limiterScaleDowns: 0
     };
+
+    if (this.limiter) {
+      // Shed workers as soon as the limiter backs off instead of waiting for the next autoScale tick
+      this._onLimiterDecision = (decision) => {
+        if (decision.scope !== 'global' || this._draining || this._shutdown) return;
+        if (decision.to < this._workers.size) {
+          this._metrics.limiterScaleDowns++;
+          this.scaleTo(decision.to, null, `adaptive: ${decision.reason}`);
+        }
+      };
+      this.limiter.on('decision', this._onLimiterDecision);
+    }
   }
 
   /**
@@ -235,8 +253,9 @@ class ConcurrencyController extends EventEmitter {
    * Scale to a specific number of workers.
    * @param {number} target - Target worker count
    * @param {Function} workerFn - Worker function for new workers
+   * @param {string} [reason] - Reported with the telemetry event
    */
-  scaleTo(target, workerFn) {
+  scaleTo(target, workerFn, reason = null) {
     const clamped = Math.min(Math.max(target, this.minWorkers), this.maxWorkers);
     const current = this._workers.size;
 
@@ -276,6 +295,12 @@ class ConcurrencyController extends EventEmitter {
       this.emit('scaled:down', { from: current, to: clamped });
     }
 
+    if (clamped !== current && this.telemetry && typeof this.telemetry.emitWorkerScaled === 'function') {
+      try {
+        this.telemetry.emitWorkerScaled({ from: current, to: clamped, reason });
+      } catch (_) { /* telemetry is best-effort */ }
+    }
+
     this._targetWorkerCount = clamped;
     this._lastScaleTime = Date.now();
 
@@ -283,7 +308,9 @@ class ConcurrencyController extends EventEmitter {
   }
 
   /**
-   * Auto-scale based on queue depth.
+   * Auto-scale based on queue depth, capped by the adaptive limiter when set
+   * (queue depth says how many workers could be used; the limiter says how
+   * many the hosts and this process can take right now).
    * @param {number} queueDepth - Current queue depth
    * @param {Function} workerFn - Worker function for new workers
    */
@@ -302,17 +329,28 @@ class ConcurrencyController extends EventEmitter {
     const targetDepth = this.targetQueueDepth;
 
     let newTarget = currentWorkers;
+    let reason = null;
 
     if (depthPerWorker > targetDepth * this.scaleUpThreshold) {
       // Too much work, scale up
       newTarget = Math.ceil(queueDepth / targetDepth);
+      reason = `queue depth ${queueDepth}`;
     } else if (depthPerWorker < targetDepth * this.scaleDownThreshold) {
       // Too little work, scale down
       newTarget = Math.max(1, Math.floor(queueDepth / targetDepth));
+      reason = `queue depth ${queueDepth}`;
+    }
+
+    if (this.limiter) {
+      const limit = this.limiter.getLimit();
+      if (newTarget > limit) {
+        newTarget = limit;
+        reason = `adaptive limit ${limit}`;
+      }
     }
 
     if (newTarget !== currentWorkers) {
-      return this.scaleTo(newTarget, workerFn);
+      return this.scaleTo(newTarget, workerFn, reason);
     }
 
     return currentWorkers;
@@ -368,6 +406,10 @@ class ConcurrencyController extends EventEmitter {
   shutdown() {
     this._shutdown = true;
     this._draining = true;
+    if (this.limiter && this._onLimiterDecision) {
+      this.limiter.off('decision', this._onLimiterDecision);
+      this._onLimiterDecision = null;
+    }
 
     for (const worker of this._workers.values()) {
       worker.abortController.abort();
@@ -399,7 +441,8 @@ class ConcurrencyController extends EventEmitter {
       currentWorkers: this._workers.size,
       activeWorkers: this._activeCount,
       idleWorkers: this.idleCount,
-      targetWorkers: this._targetWorkerCount
+      targetWorkers: this._targetWorkerCount,
+      adaptive: this.limiter ? this.limiter.getStats() : null
     };
   }
 
@@ -1,7 +1,9 @@
 'use strict';
 
 const ConcurrencyController = require('./ConcurrencyController');
+const { AdaptiveConcurrencyLimiter } = require('./AdaptiveConcurrencyLimiter');
 
 module.exports = {
-  ConcurrencyController
+  ConcurrencyController,
+  AdaptiveConcurrencyLimiter
 };
@@ -112,6 +112,7 @@ const crawlerOptionsSchema = {
   useSitemap: { type: 'boolean', default: true },
   sitemapOnly: { type: 'boolean', default: false },
   sitemapMaxUrls: { type: 'number', default: 5000, processor: (val) => Math.max(0, val) },
+  sitemapLastmodSince: { type: 'string', default: null }, // ISO date; older sitemap entries are skipped while streaming
   hubMaxPages: { type: 'number', default: undefined },
   hubMaxDays: { type: 'number', default: undefined },
   intMaxSeeds: { type: 'number', default: 50 },
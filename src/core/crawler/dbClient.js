@@ -4,6 +4,7 @@ const NewsWebsiteService = require('../../services/NewsWebsiteService');
 const { safeCall } = require('./utils');
 const { getDb } = require('../../db');
 const { updateUrlStatus: updateUrlStatusInDb } = require('news-crawler-db');
+const { startDeferredIndexing, stopDeferredIndexing } = require('../../search/SearchIndexer');
 
 let NewsDatabase = null;
 
@@ -58,6 +59,11 @@ class CrawlerDb {
     return safeCall(() => this.db[methodName](...args), fallback);
   }
 
+  _rawDb() {
+    if (!this.db) return null;
+    return typeof this.db.getDb === 'function' ? this.db.getDb() : this.db.db || null;
+  }
+
   _callNewsService(methodName, fallback = null, ...args) {
     if (!this.newsWebsiteService || typeof this.newsWebsiteService[methodName] !== 'function') {
       return fallback;
@@ -107,6 +113,10 @@ class CrawlerDb {
       if (this.cache && typeof this.cache.setDb === 'function') {
         safeCall(() => this.cache.setDb(this.db));
       }
+
+      // Article upserts go through the search index queue and are indexed in
+      // batches rather than by a trigger per row
+      safeCall(() => startDeferredIndexing(this._rawDb(), { logger: this.logger }));
       if (this.fastStart) {
         // this._log(`SQLite DB initialized at: ${this.dbPath} (fast-start)`); // Already logged above or irrelevant
       } else {
@@ -229,7 +239,7 @@ class CrawlerDb {
       if (typeof this.db.updateUrlStatus === 'function') {
         return this.db.updateUrlStatus(url, status);
       }
-      const rawDb = typeof this.db.getDb === 'function' ? this.db.getDb() : this.db.db || null;
+      const rawDb = this._rawDb();
       if (rawDb) {
         return updateUrlStatusInDb(rawDb, url, status);
       }
@@ -260,6 +270,7 @@ class CrawlerDb {
 
   close() {
     if (!this.db) return;
+    safeCall(() => stopDeferredIndexing(this._rawDb()));
     safeCall(() => this.db.close());
     this.db = null;
   }
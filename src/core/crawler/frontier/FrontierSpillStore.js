@@ -0,0 +1,391 @@
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const { CuckooFilter, seenFilterFromJSON } = require('../SeenUrlFilter');
+
+// <queueType>__<bucket>__<seq>[.<count>].ndjson; the count is added when a
+// segment is sealed so recovery can size it without reading it.
+const SEGMENT_RE = /^([a-z0-9-]+)__(n?\d+)__(\d+)(?:\.(\d+))?\.ndjson$/;
+const KEY_INDEX_FILE = 'frontier-keys.json';
+
+/**
+ * FrontierSpillStore - cold tier for QueueManager's tiered frontier.
+ *
+ * Queue items that do not fit in the in-memory hot heap are appended, as
+ * NDJSON, to priority-bucketed segment files:
+ *
+ *   <dir>/<queueType>__<bucket>__<seq>.ndjson
+ *
+ * Writes are buffered per bucket and flushed in batches with appendFileSync,
+ * so `QueueManager.enqueue()` stays synchronous. Refill reads one whole
+ * segment (oldest first within the requested bucket) and deletes it, which
+ * keeps memory bounded by `segmentMaxItems` no matter how large the cold tier
+ * grows.
+ *
+ * Membership of spilled queue keys is answered by a CuckooFilter rather than
+ * an exact set, so the dedupe state costs ~2 bytes per spilled URL. A false
+ * positive drops a new URL as a duplicate at the filter's rate (well under
+ * 0.1% at normal load). Keys are deleted from the filter when their segment
+ * is taken.
+ *
+ * Recovery is lazy: on open only file names are listed. Sealed segments carry
+ * their item count in the name; only an unsealed tail (from a crash) is read
+ * to count its lines. close() persists the key filter next to the segments,
+ * so a clean restart dedupes against spilled URLs before they refill. Items
+ * read from recovered segments are tagged `_spillRecovered` so the queue can
+ * re-admit them.
+ *
+ * Store interface used by QueueManager (any backend implementing it works):
+ *   append(queueType, bucket, item)
+ *   has(queueKey) -> boolean (optional)
+ *   lowestBucket(queueType) -> number|null
+ *   take(queueType, bucket) -> item[]
+ *   count(queueType?) -> number
+ *   flush(), clear(), close(), getStats()
+ */
+class FrontierSpillStore {
+  /**
+   * @param {Object} options
+   * @param {string} options.dir - Directory for segment files (created if missing)
+   * @param {number} [options.segmentMaxItems=1000] - Items per segment (refill granularity)
+   * @param {number} [options.writeBatchSize=256] - Buffered items per bucket before a disk append
+   * @param {boolean} [options.recover=true] - Load segments left by a previous run
+   * @param {number} [options.keyFilterCapacity=100000] - Keys per filter layer before it grows
+   */
+  constructor(options = {}) {
+    if (!options.dir || typeof options.dir !== 'string') {
+      throw new Error('FrontierSpillStore requires a dir');
+    }
+    this.dir = options.dir;
+    this.segmentMaxItems = Math.max(1, options.segmentMaxItems || 1000);
+    this.writeBatchSize = Math.max(1, Math.min(options.writeBatchSize || 256, this.segmentMaxItems));
+
+    this._buckets = new Map(); // key -> { queueType, bucket, segments, writeSegment, buffer, count }
+    this._nextSeq = 1;
+    this._keyFilterCapacity = Math.max(1, options.keyFilterCapacity || 100000);
+    this._keys = new CuckooFilter({ capacity: this._keyFilterCapacity });
+    this._stats = {
+      appended: 0,
+      taken: 0,
+      segmentsWritten: 0,
+      segmentsRead: 0,
+      bytesWritten: 0,
+      recoveredItems: 0,
+      corruptLines: 0
+    };
+
+    fs.mkdirSync(this.dir, { recursive: true });
+    if (options.recover !== false) {
+      this._recover();
+    }
+  }
+
+  append(queueType, bucket, item) {
+    const state = this._bucketState(queueType, bucket);
+    if (item && item.queueKey) this._keys.add(item.queueKey);
+    state.buffer.push(item);
+    state.count += 1;
+    this._stats.appended += 1;
+    if (state.buffer.length >= this.writeBatchSize) {
+      this._flushState(state);
+    }
+  }
+
+  /**
+   * Whether a queue key is (probably) spilled. No false negatives for keys
+   * appended by this process or indexed by a clean close().
+   */
+  has(queueKey) {
+    return !!queueKey && this._keys.has(queueKey);
+  }
+
+  /**
+   * Lowest (best) bucket holding items for a queue type.
+   * @returns {number|null}
+   */
+  lowestBucket(queueType) {
+    let lowest = null;
+    for (const state of this._buckets.values()) {
+      if (state.queueType !== queueType || state.count === 0) continue;
+      if (lowest === null || state.bucket < lowest) lowest = state.bucket;
+    }
+    return lowest;
+  }
+
+  /**
+   * Remove and return the oldest segment's worth of items from a bucket.
+   * @returns {Object[]}
+   */
+  take(queueType, bucket) {
+    const state = this._buckets.get(bucketKey(queueType, bucket));
+    if (!state || state.count === 0) return [];
+
+    if (!state.segments.length && !state.writeSegment) {
+      // Everything still sits in the write buffer; hand it over directly.
+      const items = state.buffer.splice(0, this.segmentMaxItems);
+      this._forgetKeys(items);
+      state.count -= items.length;
+      this._stats.taken += items.length;
+      this._dropIfEmpty(state);
+      return items;
+    }
+
+    this._flushState(state);
+    if (!state.segments.length && state.writeSegment) {
+      state.segments.push(state.writeSegment);
+      state.writeSegment = null;
+    }
+    const segment = state.segments.shift();
+    const items = this._readSegment(segment);
+    if (segment.keyed) this._forgetKeys(items);
+    try {
+      fs.unlinkSync(segment.path);
+    } catch (_) {
+      // Already gone; the items are in memory either way
+    }
+    state.count = Math.max(0, state.count - segment.count);
+    this._stats.taken += items.length;
+    this._stats.segmentsRead += 1;
+    this._dropIfEmpty(state);
+    return items;
+  }
+
+  count(queueType = null) {
+    let total = 0;
+    for (const state of this._buckets.values()) {
+      if (queueType && state.queueType !== queueType) continue;
+      total += state.count;
+    }
+    return total;
+  }
+
+  /**
+   * Write all buffered items to disk (call before shutdown/checkpoint).
+   */
+  flush() {
+    for (const state of this._buckets.values()) {
+      this._flushState(state);
+    }
+  }
+
+  clear() {
+    for (const state of this._buckets.values()) {
+      const segments = state.writeSegment ? [...state.segments, state.writeSegment] : state.segments;
+      for (const segment of segments) {
+        try { fs.unlinkSync(segment.path); } catch (_) { /* ignore */ }
+      }
+    }
+    this._buckets.clear();
+    this._keys = new CuckooFilter({ capacity: this._keyFilterCapacity });
+    try { fs.unlinkSync(path.join(this.dir, KEY_INDEX_FILE)); } catch (_) { /* ignore */ }
+  }
+
+  /**
+   * Flush, seal every segment and persist the key filter so the next open
+   * can dedupe against spilled URLs without reading any segment.
+   */
+  close() {
+    this.flush();
+    const names = [];
+    for (const state of this._buckets.values()) {
+      if (state.writeSegment) {
+        state.segments.push(state.writeSegment);
+        state.writeSegment = null;
+      }
+      for (const segment of state.segments) {
+        this._sealSegment(segment);
+        if (segment.keyed) names.push(path.basename(segment.path));
+      }
+    }
+    if (!names.length) return;
+    const index = { segments: names, filter: this._keys.toJSON() };
+    fs.writeFileSync(path.join(this.dir, KEY_INDEX_FILE), JSON.stringify(index));
+  }
+
+  getStats() {
+    let segments = 0;
+    let buffered = 0;
+    for (const state of this._buckets.values()) {
+      segments += state.segments.length + (state.writeSegment ? 1 : 0);
+      buffered += state.buffer.length;
+    }
+    return {
+      ...this._stats,
+      items: this.count(),
+      keyFilterBytes: this._keys.byteLength(),
+      buckets: this._buckets.size,
+      segments,
+      buffered
+    };
+  }
+
+  _bucketState(queueType, bucket) {
+    const key = bucketKey(queueType, bucket);
+    let state = this._buckets.get(key);
+    if (!state) {
+      state = { key, queueType, bucket, segments: [], writeSegment: null, buffer: [], count: 0 };
+      this._buckets.set(key, state);
+    }
+    return state;
+  }
+
+  _flushState(state) {
+    while (state.buffer.length) {
+      if (!state.writeSegment || state.writeSegment.count >= this.segmentMaxItems) {
+        if (state.writeSegment) {
+          this._sealSegment(state.writeSegment);
+          state.segments.push(state.writeSegment);
+        }
+        const seq = this._nextSeq++;
+        state.writeSegment = {
+          path: path.join(this.dir, `${state.key}__${seq}.ndjson`),
+          count: 0,
+          recovered: false,
+          keyed: true,
+          sealed: false
+        };
+        this._stats.segmentsWritten += 1;
+      }
+      const room = this.segmentMaxItems - state.writeSegment.count;
+      const batch = state.buffer.splice(0, room);
+      const payload = batch.map((item) => JSON.stringify(item)).join('\n') + '\n';
+      fs.appendFileSync(state.writeSegment.path, payload);
+      state.writeSegment.count += batch.length;
+      this._stats.bytesWritten += Buffer.byteLength(payload);
+    }
+  }
+
+  _readSegment(segment) {
+    let raw = '';
+    try {
+      raw = fs.readFileSync(segment.path, 'utf8');
+    } catch (_) {
+      return [];
+    }
+    const items = [];
+    for (const line of raw.split('\n')) {
+      if (!line) continue;
+      try {
+        const item = JSON.parse(line);
+        if (segment.recovered) item._spillRecovered = true;
+        items.push(item);
+      } catch (_) {
+        // Torn write from a crash mid-append; skip the partial line
+        this._stats.corruptLines += 1;
+      }
+    }
+    return items;
+  }
+
+  /**
+   * Rename a finished segment to carry its item count.
+   */
+  _sealSegment(segment) {
+    if (segment.sealed) return;
+    const sealedPath = segment.path.replace(/\.ndjson$/, `.${segment.count}.ndjson`);
+    try {
+      fs.renameSync(segment.path, sealedPath);
+      segment.path = sealedPath;
+      segment.sealed = true;
+    } catch (_) {
+      // Unsealed segments are still recovered, just by counting their lines
+    }
+  }
+
+  _forgetKeys(items) {
+    for (const item of items) {
+      if (item && item.queueKey) this._keys.delete(item.queueKey);
+    }
+  }
+
+  /**
+   * Load the key filter written by the last clean close(). The file is
+   * removed straight away: after this point the live filter is the only
+   * truth, and a stale copy must not survive a later crash.
+   * @returns {Set<string>} Segment names the filter covers
+   */
+  _loadKeyIndex() {
+    const indexPath = path.join(this.dir, KEY_INDEX_FILE);
+    let covered = new Set();
+    try {
+      const index = JSON.parse(fs.readFileSync(indexPath, 'utf8'));
+      this._keys = seenFilterFromJSON(index.filter);
+      covered = new Set(index.segments || []);
+    } catch (_) {
+      // Missing or torn: recovered segments are simply treated as unindexed
+    }
+    try { fs.unlinkSync(indexPath); } catch (_) { /* ignore */ }
+    return covered;
+  }
+
+  _dropIfEmpty(state) {
+    if (state.count === 0 && !state.segments.length && !state.writeSegment && !state.buffer.length) {
+      this._buckets.delete(state.key);
+    }
+  }
+
+  _recover() {
+    let entries = [];
+    try {
+      entries = fs.readdirSync(this.dir);
+    } catch (_) {
+      return;
+    }
+    const covered = this._loadKeyIndex();
+    const found = [];
+    for (const name of entries) {
+      const match = SEGMENT_RE.exec(name);
+      if (!match) continue;
+      found.push({
+        name,
+        queueType: match[1],
+        bucket: decodeBucket(match[2]),
+        seq: Number(match[3]),
+        count: match[4] !== undefined ? Number(match[4]) : null
+      });
+    }
+    found.sort((a, b) => a.seq - b.seq);
+
+    for (const entry of found) {
+      const filePath = path.join(this.dir, entry.name);
+      const sealed = entry.count !== null;
+      const count = sealed ? entry.count : countLines(filePath);
+      if (!count) {
+        try { fs.unlinkSync(filePath); } catch (_) { /* ignore */ }
+        continue;
+      }
+      const state = this._bucketState(entry.queueType, entry.bucket);
+      state.segments.push({ path: filePath, count, recovered: true, keyed: covered.has(entry.name), sealed });
+      state.count += count;
+      this._stats.recoveredItems += count;
+      this._nextSeq = Math.max(this._nextSeq, entry.seq + 1);
+    }
+  }
+}
+
+// Only unsealed segments (at most one per bucket, left by a crash) get here,
+// so the read is bounded by segmentMaxItems.
+function countLines(filePath) {
+  let raw = '';
+  try {
+    raw = fs.readFileSync(filePath, 'utf8');
+  } catch (_) {
+    return 0;
+  }
+  let count = 0;
+  for (const line of raw.split('\n')) {
+    if (line) count += 1;
+  }
+  return count;
+}
+
+function bucketKey(queueType, bucket) {
+  return `${queueType}__${bucket < 0 ? `n${-bucket}` : bucket}`;
+}
+
+function decodeBucket(token) {
+  return token.startsWith('n') ? -Number(token.slice(1)) : Number(token);
+}
+
+module.exports = { FrontierSpillStore };
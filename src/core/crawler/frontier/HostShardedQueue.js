@@ -0,0 +1,195 @@
+'use strict';
+
+const { MinHeap } = require('../utils');
+
+/**
+ * HostShardedQueue - priority frontier sharded per host with a ready-time heap.
+ *
+ * Each host owns a small priority heap of its queued items. Hosts are in one
+ * of two states:
+ *  - ready:   eligible now; indexed in `_ready` by the priority of their head
+ *  - waiting: parked until a resume time; indexed in `_waiting` by that time
+ *
+ * A pull only ever looks at the best ready host, so rate-limited or paused
+ * hosts cost nothing until their resume time comes due (O(log hosts) per
+ * pull, instead of popping and re-pushing every blocked URL).
+ *
+ * Both heaps use lazy deletion: each shard carries a version that is bumped
+ * whenever its head or state changes, and heap entries with an out-of-date
+ * version are discarded when they surface.
+ *
+ * Readiness itself is decided by the caller (QueueManager), which inspects
+ * `readyHost()` / `head()` and either `take()`s the head or `park()`s the host.
+ */
+class HostShardedQueue {
+  /**
+   * @param {Object} options
+   * @param {Function} options.compare - Item comparator (lower sorts first)
+   * @param {Function} options.hostOf - (item) => host key
+   */
+  constructor({ compare, hostOf } = {}) {
+    if (typeof compare !== 'function' || typeof hostOf !== 'function') {
+      throw new Error('HostShardedQueue requires compare and hostOf functions');
+    }
+    this.compare = compare;
+    this.hostOf = hostOf;
+    this.clear();
+  }
+
+  clear() {
+    this._shards = new Map(); // host -> { host, heap, state, readyAt, version }
+    this._ready = new MinHeap((a, b) => this.compare(a.item, b.item));
+    this._waiting = new MinHeap((a, b) => a.at - b.at);
+    this._size = 0;
+    this._clock = 0; // global so a recreated shard never matches old entries
+  }
+
+  size() {
+    return this._size;
+  }
+
+  push(item) {
+    const host = this.hostOf(item) || '';
+    let shard = this._shards.get(host);
+    if (!shard) {
+      shard = { host, heap: new MinHeap(this.compare), state: 'ready', readyAt: 0, version: 0 };
+      this._shards.set(host, shard);
+    }
+    const previousHead = shard.heap.size() ? shard.heap.data[0] : null;
+    shard.heap.push(item);
+    this._size += 1;
+    if (shard.state === 'ready' && shard.heap.data[0] !== previousHead) {
+      this._indexReady(shard);
+    }
+  }
+
+  /**
+   * Move hosts whose resume time has passed back into the ready heap, then
+   * return the best ready host (or null).
+   * @param {number} now
+   * @returns {string|null}
+   */
+  readyHost(now) {
+    this._promote(now);
+    const top = this._topReady();
+    return top ? top.host : null;
+  }
+
+  head(host) {
+    const shard = this._shards.get(host);
+    return shard && shard.heap.size() ? shard.heap.data[0] : null;
+  }
+
+  /**
+   * Remove and return the head item of a host.
+   */
+  take(host) {
+    const shard = this._shards.get(host);
+    if (!shard || !shard.heap.size()) return null;
+    const item = shard.heap.pop();
+    this._size -= 1;
+    if (!shard.heap.size()) {
+      this._shards.delete(host);
+    } else if (shard.state === 'ready') {
+      this._indexReady(shard);
+    }
+    return item;
+  }
+
+  /**
+   * Park a host until `until` (ms epoch). Its items are untouched.
+   */
+  park(host, until) {
+    const shard = this._shards.get(host);
+    if (!shard) return;
+    shard.state = 'waiting';
+    shard.readyAt = until;
+    shard.version = ++this._clock;
+    this._waiting.push({ host, at: until, version: shard.version });
+  }
+
+  /**
+   * Earliest resume time among waiting hosts, or null.
+   */
+  nextWakeAt() {
+    const top = this._topWaiting();
+    return top ? top.at : null;
+  }
+
+  /**
+   * Best item among ready hosts (falls back to the earliest waiting host).
+   */
+  peek() {
+    const ready = this._topReady();
+    if (ready) return this.head(ready.host);
+    const waiting = this._topWaiting();
+    return waiting ? this.head(waiting.host) : null;
+  }
+
+  getStats() {
+    let waitingHosts = 0;
+    for (const shard of this._shards.values()) {
+      if (shard.state === 'waiting') waitingHosts += 1;
+    }
+    return {
+      hosts: this._shards.size,
+      readyHosts: this._shards.size - waitingHosts,
+      waitingHosts,
+      items: this._size
+    };
+  }
+
+  _indexReady(shard) {
+    shard.version = ++this._clock;
+    this._ready.push({ host: shard.host, item: shard.heap.data[0], version: shard.version });
+    this._compactIfBloated();
+  }
+
+  _promote(now) {
+    for (let top = this._topWaiting(); top && top.at <= now; top = this._topWaiting()) {
+      this._waiting.pop();
+      const shard = this._shards.get(top.host);
+      shard.state = 'ready';
+      shard.readyAt = 0;
+      this._indexReady(shard);
+    }
+  }
+
+  _topReady() {
+    while (this._ready.size()) {
+      const entry = this._ready.data[0];
+      const shard = this._shards.get(entry.host);
+      if (shard && shard.state === 'ready' && shard.version === entry.version) return entry;
+      this._ready.pop();
+    }
+    return null;
+  }
+
+  _topWaiting() {
+    while (this._waiting.size()) {
+      const entry = this._waiting.data[0];
+      const shard = this._shards.get(entry.host);
+      if (shard && shard.state === 'waiting' && shard.version === entry.version) return entry;
+      this._waiting.pop();
+    }
+    return null;
+  }
+
+  // Stale entries are normally discarded as they surface; rebuild when they
+  // dominate so heap depth tracks the live host count.
+  _compactIfBloated() {
+    if (this._ready.size() + this._waiting.size() <= this._shards.size * 4 + 64) return;
+    this._ready = new MinHeap((a, b) => this.compare(a.item, b.item));
+    this._waiting = new MinHeap((a, b) => a.at - b.at);
+    for (const shard of this._shards.values()) {
+      shard.version = ++this._clock;
+      if (shard.state === 'ready') {
+        this._ready.push({ host: shard.host, item: shard.heap.data[0], version: shard.version });
+      } else {
+        this._waiting.push({ host: shard.host, at: shard.readyAt, version: shard.version });
+      }
+    }
+  }
+}
+
+module.exports = { HostShardedQueue };
@@ -0,0 +1,169 @@
+'use strict';
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { FrontierSpillStore } = require('../FrontierSpillStore');
+const QueueManager = require('../../QueueManager');
+
+function makeDir() {
+  return fs.mkdtempSync(path.join(os.tmpdir(), 'frontier-spill-'));
+}
+
+describe('FrontierSpillStore', () => {
+  let dir;
+
+  beforeEach(() => { dir = makeDir(); });
+  afterEach(() => { fs.rmSync(dir, { recursive: true, force: true }); });
+
+  test('returns the lowest bucket first and whole segments per take', () => {
+    const store = new FrontierSpillStore({ dir, segmentMaxItems: 3, writeBatchSize: 2 });
+    for (let i = 0; i < 5; i += 1) store.append('discovery', 12, { url: `https://example.com/b12/${i}` });
+    store.append('discovery', -4, { url: 'https://example.com/neg' });
+
+    expect(store.count('discovery')).toBe(6);
+    expect(store.lowestBucket('discovery')).toBe(-4);
+    expect(store.take('discovery', -4).map((i) => i.url)).toEqual(['https://example.com/neg']);
+
+    const first = store.take('discovery', 12);
+    expect(first.map((i) => i.url)).toEqual([0, 1, 2].map((i) => `https://example.com/b12/${i}`));
+    const second = store.take('discovery', 12);
+    expect(second).toHaveLength(2);
+    expect(store.count()).toBe(0);
+    expect(store.lowestBucket('discovery')).toBeNull();
+  });
+
+  test('recovers flushed segments after a restart', () => {
+    const store = new FrontierSpillStore({ dir, segmentMaxItems: 10 });
+    store.append('acquisition', 3, { url: 'https://example.com/a' });
+    store.append('acquisition', 3, { url: 'https://example.com/b' });
+    store.close();
+
+    const reopened = new FrontierSpillStore({ dir, segmentMaxItems: 10 });
+    expect(reopened.count('acquisition')).toBe(2);
+    const items = reopened.take('acquisition', 3);
+    expect(items.map((i) => i.url)).toEqual(['https://example.com/a', 'https://example.com/b']);
+    expect(items.every((i) => i._spillRecovered)).toBe(true);
+    expect(fs.readdirSync(dir)).toHaveLength(0);
+  });
+  test('sizes sealed segments from their names without reading them', () => {
+    const store = new FrontierSpillStore({ dir, segmentMaxItems: 2, writeBatchSize: 1 });
+    for (let i = 0; i < 5; i += 1) store.append('discovery', 1, { url: `https://example.com/${i}`, queueKey: `k${i}` });
+    expect(store.has('k3')).toBe(true);
+    store.close();
+
+    const names = fs.readdirSync(dir).filter((n) => n.endsWith('.ndjson')).sort();
+    expect(names.every((n) => /__\d+\.\d+\.ndjson$/.test(n))).toBe(true);
+
+    const readSpy = jest.spyOn(fs, 'readFileSync');
+    const reopened = new FrontierSpillStore({ dir, segmentMaxItems: 2 });
+    const segmentReads = readSpy.mock.calls.filter(([p]) => String(p).endsWith('.ndjson'));
+    readSpy.mockRestore();
+
+    expect(segmentReads).toHaveLength(0);
+    expect(reopened.count('discovery')).toBe(5);
+    expect(reopened.has('k3')).toBe(true);
+    reopened.take('discovery', 1);
+    expect(reopened.has('k0')).toBe(false);
+    expect(reopened.has('k3')).toBe(true);
+  });
+});
+
+describe('QueueManager tiered frontier', () => {
+  let dir;
+
+  beforeEach(() => { dir = makeDir(); });
+  afterEach(() => { fs.rmSync(dir, { recursive: true, force: true }); });
+
+  function buildQueue(spillStore, hotQueueCapacity) {
+    return new QueueManager({
+      urlEligibilityService: {
+        evaluate: ({ url, isDuplicate }) => (isDuplicate(url)
+          ? { status: 'drop', reason: 'duplicate' }
+          : { status: 'allow', normalized: url, kind: 'article', queueKey: url })
+      },
+      usePriorityQueue: true,
+      isTotalPrioritisationEnabled: () => false,
+      computeEnhancedPriority: ({ url }) => ({ priority: Number(new URL(url).searchParams.get('p')), prioritySource: 'base' }),
+      spillStore,
+      hotQueueCapacity,
+      maxQueue: 1000
+    });
+  }
+
+  test('spills past the hot capacity and serves in priority order', async () => {
+    const store = new FrontierSpillStore({ dir, segmentMaxItems: 2, writeBatchSize: 1 });
+    const qm = buildQueue(store, 2);
+    const priorities = [5, 9, 1, 7, 3];
+    for (const p of priorities) {
+      expect(qm.enqueue({ url: `https://example.com/a?p=${p}`, depth: 1, type: 'article' })).toBe(true);
+    }
+
+    expect(qm.size()).toBe(5);
+    const snapshot = qm.getHeatmapSnapshot();
+    expect(snapshot.total).toBe(5);
+    expect(snapshot.frontier).toMatchObject({ hot: 2, spilled: 3, spills: 3, hotCapacity: 2 });
+
+    const served = [];
+    for (let next = await qm.pullNext(); next && next.item; next = await qm.pullNext()) {
+      served.push(next.item.priority);
+    }
+    expect(served).toEqual([1, 3, 5, 7, 9]);
+    expect(qm.getHeatmapSnapshot().frontier).toMatchObject({ spilled: 0, refills: 3 });
+  });
+
+  test('spilled items survive a restart', async () => {
+    const qm = buildQueue(new FrontierSpillStore({ dir }), 1);
+    qm.enqueue({ url: 'https://example.com/a?p=1', depth: 1, type: 'article' });
+    qm.enqueue({ url: 'https://example.com/a?p=2', depth: 1, type: 'article' });
+    qm.close();
+
+    const restarted = buildQueue(new FrontierSpillStore({ dir }), 1);
+    expect(restarted.size()).toBe(1);
+    const next = await restarted.pullNext();
+    expect(next.item.url).toBe('https://example.com/a?p=2');
+    expect(restarted.getHeatmapSnapshot().frontier.recovered).toBe(1);
+  });
+
+  test('recovered URLs dedupe before their segment is refilled', () => {
+    const qm = buildQueue(new FrontierSpillStore({ dir }), 1);
+    qm.enqueue({ url: 'https://example.com/a?p=1', depth: 1, type: 'article' });
+    qm.enqueue({ url: 'https://example.com/a?p=2', depth: 1, type: 'article' });
+    qm.close();
+
+    const restarted = buildQueue(new FrontierSpillStore({ dir }), 1);
+    expect(restarted.getHeatmapSnapshot().frontier).toMatchObject({ refills: 0 });
+    expect(restarted.enqueue({ url: 'https://example.com/a?p=2', depth: 1, type: 'article' })).toBe(false);
+    expect(restarted.size()).toBe(1);
+  });
+
+  test('keeps spilled keys out of the in-memory dedupe set', () => {
+    const qm = buildQueue(new FrontierSpillStore({ dir, segmentMaxItems: 50 }), 2);
+    for (let i = 0; i < 200; i += 1) {
+      expect(qm.enqueue({ url: `https://example.com/a?p=${i}&i=${i}`, depth: 1, type: 'article' })).toBe(true);
+    }
+
+    expect(qm.queuedUrls.size).toBe(2);
+    expect(qm.size()).toBe(200);
+    expect(qm.enqueue({ url: 'https://example.com/a?p=150&i=150', depth: 1, type: 'article' })).toBe(false);
+  });
+
+  test('re-admits crash-recovered items through eligibility on refill', async () => {
+    const store = new FrontierSpillStore({ dir });
+    const qm = buildQueue(store, 1);
+    qm.enqueue({ url: 'https://example.com/a?p=1', depth: 1, type: 'article' });
+    qm.enqueue({ url: 'https://example.com/a?p=2', depth: 1, type: 'article' });
+    store.flush(); // crash: no close(), so no key index is written
+
+    const restarted = buildQueue(new FrontierSpillStore({ dir }), 5);
+    expect(restarted.enqueue({ url: 'https://example.com/a?p=2', depth: 1, type: 'article' })).toBe(true);
+    expect(restarted.size()).toBe(2);
+
+    const served = [];
+    for (let next = await restarted.pullNext(); next && next.item; next = await restarted.pullNext()) {
+      served.push(next.item.url);
+    }
+    expect(served).toEqual(['https://example.com/a?p=2']);
+    expect(restarted.getHeatmapSnapshot().frontier).toMatchObject({ recovered: 0, recoveredDropped: 1 });
+  });
+});
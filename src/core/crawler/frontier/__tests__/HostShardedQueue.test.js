@@ -0,0 +1,73 @@
+'use strict';
+
+const { HostShardedQueue } = require('../HostShardedQueue');
+const QueueManager = require('../../QueueManager');
+
+function createShards() {
+  return new HostShardedQueue({
+    compare: (a, b) => a.priority - b.priority,
+    hostOf: (item) => item.host
+  });
+}
+
+describe('HostShardedQueue', () => {
+  test('serves the best head across ready hosts', () => {
+    const shards = createShards();
+    shards.push({ host: 'a', priority: 5 });
+    shards.push({ host: 'b', priority: 2 });
+    shards.push({ host: 'a', priority: 1 });
+
+    expect(shards.readyHost(0)).toBe('a');
+    expect(shards.take('a').priority).toBe(1);
+    expect(shards.readyHost(0)).toBe('b');
+    expect(shards.size()).toBe(2);
+  });
+
+  test('parked hosts are skipped until their resume time', () => {
+    const shards = createShards();
+    shards.push({ host: 'slow', priority: 0 });
+    shards.push({ host: 'fast', priority: 9 });
+
+    shards.park('slow', 100);
+    expect(shards.readyHost(50)).toBe('fast');
+    shards.take('fast');
+    expect(shards.readyHost(50)).toBeNull();
+    expect(shards.nextWakeAt()).toBe(100);
+    expect(shards.readyHost(100)).toBe('slow');
+    expect(shards.getStats()).toMatchObject({ hosts: 1, waitingHosts: 0, items: 1 });
+  });
+});
+
+describe('QueueManager host sharding', () => {
+  test('blocked hosts do not starve ready ones', async () => {
+    const blocked = 'blocked.example.com';
+    const isHostRateLimited = jest.fn((host) => host === blocked);
+    const qm = new QueueManager({
+      urlEligibilityService: {
+        evaluate: ({ url }) => ({ status: 'allow', normalized: url, kind: 'article', queueKey: url })
+      },
+      usePriorityQueue: true,
+      isTotalPrioritisationEnabled: () => false,
+      safeHostFromUrl: (url) => new URL(url).host,
+      computeEnhancedPriority: ({ url }) => ({ priority: url.includes(blocked) ? 0 : 10, prioritySource: 'base' }),
+      isHostRateLimited,
+      getHostResumeTime: (host) => (host === blocked ? Date.now() + 60000 : null)
+    });
+
+    for (let i = 0; i < 100; i += 1) {
+      qm.enqueue({ url: `https://${blocked}/story/${i}`, depth: 1, type: 'article' });
+    }
+    qm.enqueue({ url: 'https://open.example.com/story', depth: 1, type: 'article' });
+
+    const first = await qm.pullNext();
+    expect(first.item.url).toBe('https://open.example.com/story');
+
+    isHostRateLimited.mockClear();
+    const second = await qm.pullNext();
+    expect(second.item).toBeUndefined();
+    expect(second.wakeAt).toBeGreaterThan(Date.now());
+    // The parked host is not re-inspected until it is due
+    expect(isHostRateLimited).not.toHaveBeenCalled();
+    expect(qm.size()).toBe(100);
+  });
+});
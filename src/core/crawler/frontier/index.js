@@ -0,0 +1,9 @@
+'use strict';
+
+const { FrontierSpillStore } = require('./FrontierSpillStore');
+const { HostShardedQueue } = require('./HostShardedQueue');
+
+module.exports = {
+  FrontierSpillStore,
+  HostShardedQueue
+};
@@ -70,6 +70,8 @@ class CrawlOrchestrator extends EventEmitter {
     this._checkpointInterval = null;
     this._checkpointFrequencyMs = this._config.checkpointFrequencyMs || 30000;
     this._lastCheckpoint = null;
+    // Delta checkpoints (CheckpointManager journal mode) turn this off
+    this._checkpointSeenUrls = this._config.checkpointSeenUrls !== false;
 
     // Wire up event listeners
     this._wireEvents();
@@ -740,15 +742,36 @@ class CrawlOrchestrator extends EventEmitter {
       resumeHints: {
         activeWorkers: this._activeWorkers,
         allGoalsSatisfied: this._allGoalsSatisfied || false
-      }
+      },
+
+      // Seen-URL filter, so a resumed crawl does not re-warm it from scratch
+      seenUrls: this._checkpointSeenUrls ? this._exportSeenUrls() : null
     };
   }
 
+  /**
+   * @private
+   */
+  _exportSeenUrls() {
+    const service = this.crawler?.urlEligibilityService;
+    if (!service || typeof service.exportSeenFilter !== 'function') return null;
+    try {
+      return service.exportSeenFilter(this.crawler.state?.visited || null);
+    } catch (_) {
+      return null;
+    }
+  }
+
   /**
    * Restore from checkpoint.
    * @param {Object} checkpoint - Checkpoint data
+   * @param {Object} [options] - Constructor options, plus:
+   * @param {Object[]} [options.frontier] - Journal frontier to re-enqueue on options.crawler
+   * @param {Iterable<string>} [options.visited] - Journal visited set to load into options.crawler
    */
   static fromCheckpoint(checkpoint, options = {}) {
+    const { frontier = null, visited = null, ...orchestratorOptions } = options;
+
     // Restore context
     const context = new CrawlContext(checkpoint.context || {});
 
@@ -771,7 +794,7 @@ class CrawlOrchestrator extends EventEmitter {
     }
 
     const orchestrator = new CrawlOrchestrator({
-      ...options,
+      ...orchestratorOptions,
       context,
       plan,
       budget
@@ -782,9 +805,66 @@ class CrawlOrchestrator extends EventEmitter {
       orchestrator._allGoalsSatisfied = checkpoint.resumeHints.allGoalsSatisfied || false;
     }
 
+    const service = orchestrator.crawler?.urlEligibilityService;
+    if (checkpoint.seenUrls && service && typeof service.importSeenFilter === 'function') {
+      service.importSeenFilter(checkpoint.seenUrls, { host: orchestrator.crawler.domain || null });
+    }
+
+    if (frontier || visited) {
+      orchestrator._restoreCrawlState({ frontier: frontier || [], visited: visited || [] });
+    }
+
     return orchestrator;
   }
 
+  /**
+   * Resume a job from a CheckpointManager: the journal in delta mode (falling
+   * back to the latest JSON snapshot), with the journal's frontier and
+   * visited set loaded into options.crawler before the manager is attached.
+   *
+   * @param {CheckpointManager} manager
+   * @param {string} jobId
+   * @param {Object} [options] - Constructor options (crawler, config)
+   * @returns {Promise<CrawlOrchestrator|null>} null when the job has no checkpoint
+   */
+  static async resume(manager, jobId, options = {}) {
+    const restored = manager.journalOptions ? await manager.restore(jobId) : null;
+    const checkpoint = restored ? restored.checkpoint : manager.loadLatest(jobId);
+    if (!checkpoint) return null;
+
+    const orchestrator = CrawlOrchestrator.fromCheckpoint(checkpoint, {
+      ...options,
+      frontier: restored ? restored.frontier : null,
+      visited: restored ? restored.visited : null
+    });
+    manager.attach(orchestrator);
+    return orchestrator;
+  }
+
+  /**
+   * Load a replayed frontier and visited set into the crawler.
+   * Visited URLs go in first so eligibility checks see them; frontier items
+   * are re-enqueued so the queue recomputes their priority.
+   * @private
+   */
+  _restoreCrawlState({ frontier, visited }) {
+    const crawler = this.crawler;
+    if (!crawler) return { visited: 0, requeued: 0 };
+    const service = crawler.urlEligibilityService;
+    let visitedCount = 0;
+    for (const url of visited) {
+      crawler.state?.addVisited?.(url);
+      service?.noteProcessed?.(url);
+      visitedCount += 1;
+    }
+    let requeued = 0;
+    for (const item of frontier) {
+      const added = crawler.queue?.enqueue?.({ url: item.url, depth: item.depth ?? 0, type: item.type || undefined });
+      if (added) requeued += 1;
+    }
+    return { visited: visitedCount, requeued };
+  }
+
   // ============================================================
   // INTEGRATION WITH EXISTING CRAWLER
   // ============================================================
@@ -0,0 +1,349 @@
+'use strict';
+
+const os = require('os');
+const path = require('path');
+const { EventEmitter } = require('events');
+const { Worker } = require('worker_threads');
+
+/**
+ * AnalysisWorkerPool - runs CPU-bound page analysis (Readability, schema
+ * signals, gzip sizing) on worker threads so the crawl event loop stays free
+ * for fetch I/O.
+ *
+ * HTML is handed over as a transferable ArrayBuffer; the worker decodes it,
+ * so no JS string crosses the thread boundary. The pool is bounded: at most
+ * `maxPending` tasks (running + queued) are accepted before
+ * `waitForCapacity()` starts blocking, which QueueManager uses as a pull gate
+ * so workers stop pulling URLs while analysis is backed up.
+ *
+ * Events:
+ * - 'task-completed' { taskId, workerId, durationMs, bytes }
+ * - 'task-failed'    { taskId, workerId, error }
+ * - 'worker-exit'    { workerId, code }
+ *
+ * @extends EventEmitter
+ */
+class AnalysisWorkerPool extends EventEmitter {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.poolSize] - Worker threads (default: min(4, cpus - 1))
+   * @param {number} [options.maxPending] - Max running + queued tasks before backpressure (default: poolSize * 4)
+   * @param {string} [options.workerPath] - Worker script (default: ./analysisWorker.js)
+   * @param {*} [options.workerData] - Passed to every worker thread as `workerData` (e.g. a SharedArrayBuffer)
+   */
+  constructor(options = {}) {
+    super();
+    const cpuCount = Math.max(1, os.cpus()?.length || 1);
+    const defaultSize = Math.max(1, Math.min(4, cpuCount - 1));
+    this.poolSize = Math.max(1, Math.min(options.poolSize || defaultSize, cpuCount));
+    this.maxPending = Math.max(this.poolSize, options.maxPending || this.poolSize * 4);
+    this.workerPath = options.workerPath || path.join(__dirname, 'analysisWorker.js');
+    this.workerData = options.workerData;
+
+    this.workers = [];
+    this.availableWorkers = [];
+    this.taskQueue = [];
+    this.activeTasks = new Map(); // taskId -> { resolve, reject, worker, start, bytes }
+    this.capacityWaiters = [];
+    this.initialized = false;
+    this._shuttingDown = false;
+    this._nextWorkerId = 0;
+    this._nextTaskId = 0;
+
+    this._totals = {
+      submitted: 0,
+      completed: 0,
+      failed: 0,
+      bytesTransferred: 0,
+      backpressureWaits: 0
+    };
+  }
+
+  initialize() {
+    if (this.initialized) return;
+    this._shuttingDown = false;
+    for (let i = 0; i < this.poolSize; i += 1) {
+      this._spawnWorker();
+    }
+    this.initialized = true;
+    this.emit('initialized', { poolSize: this.poolSize });
+  }
+
+  /**
+   * Tasks accepted but not yet resolved (running + queued).
+   */
+  get pending() {
+    return this.activeTasks.size + this.taskQueue.length;
+  }
+
+  hasCapacity() {
+    return this.pending < this.maxPending;
+  }
+
+  /**
+   * Resolve once the pool can accept another task. Returns `null` (not a
+   * promise) when capacity is already available so hot callers can skip the
+   * await entirely.
+   * @returns {Promise<void>|null}
+   */
+  waitForCapacity() {
+    if (this._shuttingDown || this.hasCapacity()) return null;
+    this._totals.backpressureWaits += 1;
+    return new Promise((resolve) => this.capacityWaiters.push(resolve));
+  }
+
+  /**
+   * Analyse one page off-thread.
+   * @param {Object} params
+   * @param {string|Buffer|ArrayBuffer|Uint8Array} params.html - Page HTML. Binary
+   *   inputs are transferred, so the caller must not reuse them afterwards.
+   * @param {string} [params.url]
+   * @param {Object} [params.payload] - Extra structured-clonable fields for custom workers
+   * @returns {Promise<{readability: Object, schemaSignals: Object|null, compressedBytes: number, timings: Object}>}
+   */
+  analyze({ html, url = null, payload = null } = {}) {
+    if (this._shuttingDown) {
+      return Promise.reject(new Error('Analysis worker pool is shutting down'));
+    }
+    if (!this.initialized) {
+      this.initialize();
+    }
+
+    const transferable = toTransferable(html);
+    if (!transferable) {
+      return Promise.reject(new Error('AnalysisWorkerPool.analyze requires html'));
+    }
+
+    return new Promise((resolve, reject) => {
+      const task = {
+        taskId: `analyze-${++this._nextTaskId}`,
+        url,
+        payload,
+        resolve,
+        reject,
+        buffer: transferable,
+        bytes: transferable.byteLength,
+        enqueuedAt: Date.now()
+      };
+      this._totals.submitted += 1;
+      this._totals.bytesTransferred += task.bytes;
+
+      const worker = this.availableWorkers.shift();
+      if (worker) {
+        this._assignTask(worker, task);
+      } else {
+        this.taskQueue.push(task);
+      }
+    });
+  }
+
+  /**
+   * Snapshot for telemetry: pool totals plus one entry per worker thread.
+   */
+  getStats() {
+    return {
+      poolSize: this.poolSize,
+      maxPending: this.maxPending,
+      pending: this.pending,
+      queued: this.taskQueue.length,
+      active: this.activeTasks.size,
+      ...this._totals,
+      workers: this.workers.map((worker) => {
+        const info = worker.__poolInfo;
+        return {
+          workerId: info.workerId,
+          threadId: worker.threadId,
+          busy: info.busy,
+          tasksCompleted: info.tasksCompleted,
+          tasksFailed: info.tasksFailed,
+          busyMs: info.busyMs,
+          avgTaskMs: info.tasksCompleted > 0 ? Math.round(info.busyMs / info.tasksCompleted) : null,
+          lastTaskMs: info.lastTaskMs,
+          bytesIn: info.bytesIn
+        };
+      })
+    };
+  }
+
+  async shutdown() {
+    this._shuttingDown = true;
+    const queueError = new Error('Analysis worker pool shutting down');
+    while (this.taskQueue.length) {
+      this.taskQueue.shift().reject(queueError);
+    }
+    for (const task of this.activeTasks.values()) {
+      task.reject(queueError);
+    }
+    this.activeTasks.clear();
+    this._releaseCapacityWaiters(true);
+
+    const terminations = this.workers.map((worker) => worker.terminate());
+    await Promise.allSettled(terminations);
+
+    this.workers = [];
+    this.availableWorkers = [];
+    this.initialized = false;
+    this.emit('shutdown');
+  }
+
+  _spawnWorker() {
+    const worker = this.workerData === undefined
+      ? new Worker(this.workerPath)
+      : new Worker(this.workerPath, { workerData: this.workerData });
+    worker.__poolInfo = {
+      workerId: this._nextWorkerId++,
+      busy: false,
+      tasksCompleted: 0,
+      tasksFailed: 0,
+      busyMs: 0,
+      lastTaskMs: null,
+      bytesIn: 0
+    };
+    worker.on('message', (msg) => this._handleWorkerMessage(worker, msg));
+    worker.on('error', (error) => this._handleWorkerError(worker, error));
+    worker.on('exit', (code) => this._handleWorkerExit(worker, code));
+    // Idle analysis threads must not keep a finished crawl alive; busy ones
+    // are ref'd in _assignTask so pending analysis holds the process open.
+    worker.unref();
+    this.workers.push(worker);
+    this.availableWorkers.push(worker);
+    return worker;
+  }
+
+  _assignTask(worker, task) {
+    const info = worker.__poolInfo;
+    info.busy = true;
+    info.bytesIn += task.bytes;
+    worker.ref();
+    this.activeTasks.set(task.taskId, {
+      worker,
+      resolve: task.resolve,
+      reject: task.reject,
+      start: Date.now(),
+      bytes: task.bytes
+    });
+
+    worker.postMessage({
+      type: 'analyze',
+      taskId: task.taskId,
+      url: task.url,
+      payload: task.payload,
+      buffer: task.buffer,
+      byteOffset: 0,
+      byteLength: task.bytes
+    }, [task.buffer]);
+  }
+
+  _handleWorkerMessage(worker, msg) {
+    if (!msg || !msg.type) return;
+    const task = this.activeTasks.get(msg.taskId);
+    const info = worker.__poolInfo;
+    info.busy = false;
+
+    if (task) {
+      this.activeTasks.delete(msg.taskId);
+      const durationMs = msg.durationMs != null ? msg.durationMs : (Date.now() - task.start);
+      info.busyMs += durationMs;
+      info.lastTaskMs = durationMs;
+
+      if (msg.type === 'analyzed') {
+        info.tasksCompleted += 1;
+        this._totals.completed += 1;
+        task.resolve(msg.result);
+        this.emit('task-completed', { taskId: msg.taskId, workerId: info.workerId, durationMs, bytes: task.bytes });
+      } else {
+        info.tasksFailed += 1;
+        this._totals.failed += 1;
+        task.reject(new Error(msg.error || 'Analysis worker error'));
+        this.emit('task-failed', { taskId: msg.taskId, workerId: info.workerId, error: msg.error || 'unknown error' });
+      }
+    }
+
+    this._release(worker);
+  }
+
+  _handleWorkerError(worker, error) {
+    this.emit('worker-error', error);
+    this._failWorkerTasks(worker, error);
+    const idx = this.availableWorkers.indexOf(worker);
+    if (idx >= 0) {
+      this.availableWorkers.splice(idx, 1);
+    }
+  }
+
+  _failWorkerTasks(worker, error) {
+    for (const [taskId, task] of this.activeTasks.entries()) {
+      if (task.worker === worker) {
+        this.activeTasks.delete(taskId);
+        worker.__poolInfo.tasksFailed += 1;
+        this._totals.failed += 1;
+        task.reject(error);
+      }
+    }
+    this._releaseCapacityWaiters(false);
+  }
+
+  _handleWorkerExit(worker, code) {
+    this._failWorkerTasks(worker, new Error(`Analysis worker exited with code ${code}`));
+    const idx = this.workers.indexOf(worker);
+    if (idx >= 0) this.workers.splice(idx, 1);
+    const availableIdx = this.availableWorkers.indexOf(worker);
+    if (availableIdx >= 0) this.availableWorkers.splice(availableIdx, 1);
+
+    if (this._shuttingDown) return;
+    this.emit('worker-exit', { workerId: worker.__poolInfo.workerId, code });
+
+    // Replace crashed threads so a single bad page cannot shrink the pool.
+    const replacement = this._spawnWorker();
+    this.availableWorkers.pop();
+    this._release(replacement);
+  }
+
+  _release(worker) {
+    if (this.taskQueue.length > 0 && !this._shuttingDown) {
+      this._assignTask(worker, this.taskQueue.shift());
+    } else if (this.workers.includes(worker) && !this.availableWorkers.includes(worker)) {
+      worker.unref();
+      this.availableWorkers.push(worker);
+    }
+    this._releaseCapacityWaiters(false);
+  }
+
+  // Waking every waiter is deliberate: a woken caller may never submit a task
+  // (fetch error, non-article page), and nothing else would wake the rest
+  // once pending drains. Over-subscription is bounded by the number of callers.
+  _releaseCapacityWaiters(all) {
+    while (this.capacityWaiters.length && (all || this.hasCapacity())) {
+      this.capacityWaiters.shift()();
+    }
+  }
+}
+
+/**
+ * Produce an ArrayBuffer that can be transferred without detaching memory
+ * anyone else is using. Node's small Buffers share a slab, so those (and any
+ * view that does not span its whole backing store) are copied once.
+ */
+function toTransferable(html) {
+  if (typeof html === 'string') {
+    if (!html) return null;
+    const encoded = Buffer.from(html, 'utf8');
+    return ownedArrayBuffer(encoded);
+  }
+  if (html instanceof ArrayBuffer) {
+    return html.byteLength ? html : null;
+  }
+  if (ArrayBuffer.isView(html)) {
+    return html.byteLength ? ownedArrayBuffer(html) : null;
+  }
+  return null;
+}
+
+function ownedArrayBuffer(view) {
+  if (view.byteOffset === 0 && view.byteLength === view.buffer.byteLength && !(view.buffer instanceof SharedArrayBuffer)) {
+    return view.buffer;
+  }
+  return view.buffer.slice(view.byteOffset, view.byteOffset + view.byteLength);
+}
+
+module.exports = { AnalysisWorkerPool, toTransferable };
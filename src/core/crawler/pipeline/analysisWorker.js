@@ -0,0 +1,40 @@
+'use strict';
+
+const { parentPort, threadId } = require('worker_threads');
+const { analyzePageHtml } = require('./pageAnalysis');
+
+if (!parentPort) {
+  throw new Error('Analysis worker must be run as a worker thread');
+}
+
+const decoder = new TextDecoder('utf-8');
+
+parentPort.on('message', (msg) => {
+  if (!msg || msg.type !== 'analyze' || !msg.taskId) {
+    return;
+  }
+
+  try {
+    const start = Date.now();
+    // The HTML arrives as a transferred ArrayBuffer; decode once here so the
+    // crawler thread never pays for the string copy.
+    const bytes = new Uint8Array(msg.buffer, msg.byteOffset || 0, msg.byteLength);
+    const html = decoder.decode(bytes);
+    const result = analyzePageHtml({ html, url: msg.url || null });
+
+    parentPort.postMessage({
+      type: 'analyzed',
+      taskId: msg.taskId,
+      threadId,
+      result,
+      durationMs: Date.now() - start
+    });
+  } catch (error) {
+    parentPort.postMessage({
+      type: 'error',
+      taskId: msg.taskId,
+      threadId,
+      error: error?.message || String(error)
+    });
+  }
+});
@@ -49,6 +49,7 @@
  * - tryCache
  * - acquireRateToken, acquireDomainToken, fetch
  * - parseHtml, extractLinks, detectArticle, saveArticle, enqueueLinks
+ * - offloadAnalysis (page pipeline; needs deps.analysisPool)
  * - recordMetrics
  * 
  * @module src/crawler/pipeline
@@ -64,6 +65,7 @@ const {
   createFetchStep,
   createParseHtmlStep,
   createDetectArticleStep,
+  createOffloadAnalysisStep,
   createExtractLinksStep,
   createEnqueueLinksStep,
   createProcessArticleStep,
@@ -91,6 +93,7 @@ module.exports = {
   createFetchStep,
   createParseHtmlStep,
   createDetectArticleStep,
+  createOffloadAnalysisStep,
   createExtractLinksStep,
   createEnqueueLinksStep,
   createProcessArticleStep,
@@ -0,0 +1,195 @@
+'use strict';
+
+/**
+ * pageAnalysis - CPU-bound per-page analysis that has no crawler state.
+ *
+ * Everything here is safe to run inside a worker thread: it takes raw HTML
+ * and a URL and returns plain, structured-clone-friendly data. The crawler's
+ * ArticleProcessor runs the same code in-process when no analysis pool is
+ * configured, so both paths produce identical results.
+ *
+ * @module src/core/crawler/pipeline/pageAnalysis
+ */
+
+const crypto = require('crypto');
+const zlib = require('zlib');
+const { ParsedDocument } = require('../../../shared/utils/ParsedDocument');
+const { countWords } = require('../../../shared/utils/textMetrics');
+const { extractSchemaSignals } = require('../schemaSignals');
+
+/**
+ * Locate the DOM node that best matches the Readability output and return its
+ * XPath. Scores candidate containers by text length, paragraph count and link
+ * density.
+ * @param {Document} document - Document Readability ran against
+ * @param {Object} readabilityArticle - Readability parse result
+ * @returns {string|null}
+ */
+function findArticleXPath(document, readabilityArticle) {
+  try {
+    const text = readabilityArticle?.textContent || '';
+    if (!text) return null;
+    const targetLen = text.length;
+    const normalize = (s) => (s || '').trim();
+
+    const tmp = document.createElement('div');
+    tmp.innerHTML = readabilityArticle.content || '';
+    const rbParas = Array.from(tmp.querySelectorAll('p'))
+      .map((p) => normalize(p.textContent))
+      .filter(Boolean);
+    const rbTotal = rbParas.length;
+
+    const selectors = [
+      'article', '[role="article"]', '[itemprop="articleBody"]',
+      'main article', 'main [itemprop="articleBody"]',
+      '.article-body', '.content__article-body', '.story-body', '.entry-content', '.post-content', '.rich-text', '.ArticleBody', '.article__body',
+      'main', 'section', 'div[class*="article"]', 'div[id*="article"]'
+    ];
+    const candidates = new Set();
+    for (const sel of selectors) {
+      for (const el of document.querySelectorAll(sel)) {
+        candidates.add(el);
+        if (candidates.size > 200) break;
+      }
+      if (candidates.size > 200) break;
+    }
+    if (candidates.size === 0) {
+      for (const el of document.body.querySelectorAll('p, article, main, section')) {
+        candidates.add(el);
+      }
+    }
+
+    const navClassRe = /(nav|menu|footer|sidebar|comment|promo|related|share|social)/i;
+    const scoreOf = (el) => {
+      const t = normalize(el.textContent);
+      const len = t.length;
+      if (len === 0) return Number.POSITIVE_INFINITY;
+      const paras = el.querySelectorAll('p').length;
+      let linkText = 0;
+      for (const a of el.querySelectorAll('a')) {
+        linkText += normalize(a.textContent).length;
+      }
+      const density = len > 0 ? linkText / len : 0;
+      let score = Math.abs(len - targetLen);
+      score += Math.abs(paras - rbTotal) * 50;
+      if (density > 0.3) score += 10000;
+      const idcl = `${el.id || ''} ${el.className || ''}`;
+      if (navClassRe.test(idcl)) score += 5000;
+      let depth = 0;
+      for (let n = el; n && n.parentNode; n = n.parentNode) depth++;
+      score -= Math.min(depth, 20) * 5;
+      return score;
+    };
+
+    let best = null;
+    let bestScore = Number.POSITIVE_INFINITY;
+    for (const el of candidates) {
+      const s = scoreOf(el);
+      const len = normalize(el.textContent).length;
+      if (len < targetLen * 0.5) continue;
+      if (s < bestScore) {
+        best = el;
+        bestScore = s;
+      }
+    }
+    const node = best || document.body;
+
+    const getXPath = (el) => {
+      if (!el || el.nodeType !== 1) return '';
+      if (el === document.documentElement) return '/html';
+      const segs = [];
+      for (let n = el; n && n.nodeType === 1; n = n.parentNode) {
+        const name = n.localName;
+        if (!name) break;
+        if (n.parentNode) {
+          const siblings = Array.from(n.parentNode.children).filter((c) => c.localName === name);
+          if (siblings.length > 1) {
+            segs.unshift(`${name}[${siblings.indexOf(n) + 1}]`);
+          } else {
+            segs.unshift(name);
+          }
+        } else {
+          segs.unshift(name);
+        }
+        if (n === document.documentElement) break;
+      }
+      if (segs[0] !== 'html') segs.unshift('html');
+      return '/' + segs.join('/');
+    };
+    return getXPath(node);
+  } catch (_) {
+    return null;
+  }
+}
+
+/**
+ * Readability-derived fields stored with each article.
+ * @param {ParsedDocument} parsedDocument
+ * @returns {{htmlSha: string|null, text: string|null, wordCount: number|null, language: string|null, articleXPath: string|null}}
+ */
+function runReadability(parsedDocument) {
+  let htmlSha = null;
+  let text = null;
+  let wordCount = null;
+  let language = null;
+  let articleXPath = null;
+
+  try {
+    htmlSha = crypto.createHash('sha256').update(parsedDocument.html).digest('hex');
+  } catch (_) { /* ignore hash errors */ }
+
+  const { article, document } = parsedDocument.getReadability();
+  if (article && article.textContent) {
+    text = article.textContent.trim();
+    wordCount = countWords(text);
+    language = document.documentElement.getAttribute('lang') || null;
+    articleXPath = findArticleXPath(document, article);
+  }
+
+  return { htmlSha, text, wordCount, language, articleXPath };
+}
+
+/**
+ * Full offloadable analysis for one page: Readability, schema.org signals and
+ * the gzip size used for bytes-saved accounting.
+ *
+ * @param {Object} params
+ * @param {string} params.html
+ * @param {string} [params.url]
+ * @returns {{readability: Object, schemaSignals: Object|null, compressedBytes: number, timings: Object}}
+ */
+function analyzePageHtml({ html, url = null }) {
+  const parsedDocument = new ParsedDocument({ html, url });
+  const timings = {};
+  try {
+    let started = Date.now();
+    const readability = runReadability(parsedDocument);
+    timings.readabilityMs = Date.now() - started;
+
+    started = Date.now();
+    let schemaSignals = null;
+    try {
+      schemaSignals = extractSchemaSignals({ $: parsedDocument.$, html });
+    } catch (_) {
+      schemaSignals = null;
+    }
+    timings.schemaMs = Date.now() - started;
+
+    started = Date.now();
+    let compressedBytes = 0;
+    try {
+      compressedBytes = zlib.gzipSync(html).length;
+    } catch (_) { /* ignore */ }
+    timings.gzipMs = Date.now() - started;
+
+    return { readability, schemaSignals, compressedBytes, timings };
+  } finally {
+    parsedDocument.dispose();
+  }
+}
+
+module.exports = {
+  analyzePageHtml,
+  runReadability,
+  findArticleXPath
+};
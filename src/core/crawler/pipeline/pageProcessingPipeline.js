@@ -12,6 +12,7 @@ const { runPipeline, createStep } = require('./runPipeline');
  * @property {Object} [parseResult] - Parse result with cheerio $
  * @property {Object[]} [links] - Extracted links
  * @property {Object} [articleResult] - Article processing result
+ * @property {Promise<Object|null>} [analysisPromise] - Off-thread analysis in flight
  */
 
 /**
@@ -25,6 +26,8 @@ const { runPipeline, createStep } = require('./runPipeline');
  * @property {Object} [telemetry] - Telemetry service
  * @property {Function} [looksLikeArticle] - Article detection function
  * @property {number} [maxDepth] - Maximum crawl depth
+ * @property {Object} [analysisPool] - AnalysisWorkerPool for off-thread Readability
+ * @property {Object} [stageHistograms] - StageHistograms that times every step per host
  */
 
 /**
@@ -145,6 +148,25 @@ function createDetectArticleStep(deps) {
   }, { optional: true });
 }
 
+/**
+ * Create a page processing pipeline step that hands article HTML to the
+ * analysis worker pool. The promise is stored on the context rather than
+ * awaited so link extraction and enqueueing overlap with the worker.
+ * @param {PageDeps} deps - Dependencies
+ * @returns {import('./runPipeline').Step}
+ */
+function createOffloadAnalysisStep(deps) {
+  return createStep('offloadAnalysis', async (ctx) => {
+    if (!ctx.isArticle || !ctx.html || !deps.analysisPool) {
+      return { ok: true, value: ctx };
+    }
+    const analysisPromise = deps.analysisPool
+      .analyze({ html: ctx.html, url: ctx.resolvedUrl || ctx.url })
+      .catch(() => null);
+    return { ok: true, value: { ...ctx, analysisPromise } };
+  }, { optional: true });
+}
+
 /**
  * Create a page processing pipeline step that extracts links.
  * @param {PageDeps} deps - Dependencies
@@ -213,7 +235,8 @@ function createProcessArticleStep(deps) {
         url: ctx.resolvedUrl || ctx.url,
         html: ctx.html,
         $: ctx.$,
-        depth: ctx.depth
+        depth: ctx.depth,
+        analysis: ctx.analysisPromise || null
       });
       return { ok: true, value: { ...ctx, articleResult: result } };
     } catch (err) {
@@ -283,6 +306,7 @@ function buildPageProcessingSteps(deps) {
     createFetchStep(deps),
     createParseHtmlStep(deps),
     createDetectArticleStep(deps),
+    createOffloadAnalysisStep(deps),
     createExtractLinksStep(deps),
     createEnqueueLinksStep(deps),
     createProcessArticleStep(deps),
@@ -353,6 +377,7 @@ module.exports = {
   createFetchStep,
   createParseHtmlStep,
   createDetectArticleStep,
+  createOffloadAnalysisStep,
   createExtractLinksStep,
   createEnqueueLinksStep,
   createProcessArticleStep,
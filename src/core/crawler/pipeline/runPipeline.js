@@ -30,6 +30,7 @@
  * @property {Object} [metrics] - Metrics/telemetry instance
  * @property {Object} [dbAdapter] - Database adapter
  * @property {Object} [cache] - Cache instance
+ * @property {Object} [stageHistograms] - StageHistograms; each executed step is timed into it per host
  */
 
 /**
@@ -58,6 +59,8 @@
  * @property {Error|string} [err] - Error that caused abort
  */
 
+const { hostOf } = require('../telemetry/TelemetryRingBuffer');
+
 const DEFAULT_LOGGER = {
   info: (...args) => console.log('[pipeline]', ...args),
   warn: (...args) => console.warn('[pipeline]', ...args),
@@ -65,6 +68,15 @@ const DEFAULT_LOGGER = {
   debug: () => {} // silent by default
 };
 
+/**
+ * Host for per-host stage histograms
+ * @param {PipelineContext} ctx
+ * @returns {string|null}
+ */
+function contextHost(ctx) {
+  return ctx.host || hostOf(ctx.resolvedUrl || ctx.url);
+}
+
 /**
  * Execute a pipeline of steps sequentially
  * 
@@ -90,6 +102,7 @@ async function runPipeline(steps, ctx, deps = {}, options = {}) {
 
   const logger = deps.logger || DEFAULT_LOGGER;
   const metrics = deps.metrics || null;
+  const stageHistograms = collectMetrics ? deps.stageHistograms || null : null;
   
   const pipelineStart = Date.now();
   const stepResults = [];
@@ -152,6 +165,7 @@ async function runPipeline(steps, ctx, deps = {}, options = {}) {
       }
 
       const stepStart = Date.now();
+      const stepStartNs = stageHistograms ? process.hrtime.bigint() : null;
       logger.debug?.(`Executing step: ${stepLabel}`);
 
       try {
@@ -238,6 +252,12 @@ async function runPipeline(steps, ctx, deps = {}, options = {}) {
         } else {
           logger.warn(`Step ${stepLabel} threw (continuing): ${errorMessage}`);
         }
+      } finally {
+        if (stageHistograms) {
+          try {
+            stageHistograms.since(stepId, contextHost(runCtx), stepStartNs);
+          } catch (_) {}
+        }
       }
     }
   } finally {
@@ -0,0 +1,188 @@
+'use strict';
+
+/**
+ * LatencyHistogram — Fixed-memory log-linear latency histogram
+ *
+ * HDR-style bucketing: values (microseconds) below 2^(precisionBits+1) get
+ * one bucket each; above that every power of two is split into
+ * 2^precisionBits equal sub-buckets, so any recorded value is reported within
+ * 1/2^precisionBits of its true value (~3% at the default of 5). The bucket
+ * array is allocated once; recording is a handful of integer operations and
+ * never allocates, which keeps it cheap enough to leave on for every page.
+ *
+ * Values above ~35 minutes (2^31 µs) are clamped into the top bucket.
+ *
+ * @module LatencyHistogram
+ * @example
+ * const hist = new LatencyHistogram();
+ * const t0 = process.hrtime.bigint();
+ * await work();
+ * hist.recordNs(process.hrtime.bigint() - t0);
+ * hist.percentile(99); // ms
+ */
+
+const MAX_VALUE_US = 0x7fffffff;
+const DEFAULT_PRECISION_BITS = 5;
+
+class LatencyHistogram {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.precisionBits=5] - Sub-bucket bits per power of two (1-10)
+   */
+  constructor(options = {}) {
+    const precisionBits = Math.trunc(options.precisionBits ?? DEFAULT_PRECISION_BITS);
+    if (!(precisionBits >= 1 && precisionBits <= 10)) {
+      throw new Error('LatencyHistogram requires precisionBits between 1 and 10');
+    }
+    this.precisionBits = precisionBits;
+    this._linearBits = precisionBits + 1;
+    this._linearCount = 1 << this._linearBits;
+    this._halfCount = this._linearCount >>> 1;
+    this.bucketCount = this._linearCount + (31 - this._linearBits) * this._halfCount;
+    this._counts = new Uint32Array(this.bucketCount);
+    this.reset();
+  }
+
+  reset() {
+    this._counts.fill(0);
+    this.count = 0;
+    this._sumUs = 0;
+    this._minUs = MAX_VALUE_US;
+    this._maxUs = 0;
+  }
+
+  /**
+   * Record a duration in nanoseconds (e.g. a process.hrtime.bigint() delta)
+   * @param {bigint|number} ns
+   */
+  recordNs(ns) {
+    this._recordUs(typeof ns === 'bigint' ? Number(ns / 1000n) : Math.floor(ns / 1000));
+  }
+
+  /**
+   * Record a duration in milliseconds
+   * @param {number} ms
+   */
+  recordMs(ms) {
+    if (typeof ms !== 'number' || !Number.isFinite(ms)) return;
+    this._recordUs(Math.round(ms * 1000));
+  }
+
+  _recordUs(us) {
+    let value = us > 0 ? us : 0;
+    if (value > MAX_VALUE_US) value = MAX_VALUE_US;
+    this._counts[this._indexOf(value)] += 1;
+    this.count += 1;
+    this._sumUs += value;
+    if (value < this._minUs) this._minUs = value;
+    if (value > this._maxUs) this._maxUs = value;
+  }
+
+  _indexOf(value) {
+    if (value < this._linearCount) return value;
+    const shift = 31 - Math.clz32(value) - this._linearBits + 1;
+    return this._linearCount + (shift - 1) * this._halfCount + ((value >>> shift) - this._halfCount);
+  }
+
+  /** Highest value (µs) that maps to a bucket */
+  _upperBoundOf(index) {
+    if (index < this._linearCount) return index;
+    const offset = index - this._linearCount;
+    const shift = Math.floor(offset / this._halfCount) + 1;
+    const sub = (offset % this._halfCount) + this._halfCount;
+    return (sub + 1) * 2 ** shift - 1;
+  }
+
+  /**
+   * Value at a percentile, in milliseconds
+   * @param {number} p - 0-100
+   * @returns {number|null} null when empty
+   */
+  percentile(p) {
+    if (this.count === 0) return null;
+    const rank = Math.max(1, Math.ceil((Math.min(100, Math.max(0, p)) / 100) * this.count));
+    let seen = 0;
+    for (let i = 0; i < this.bucketCount; i++) {
+      seen += this._counts[i];
+      if (seen >= rank) {
+        const us = Math.min(this._maxUs, Math.max(this._minUs, this._upperBoundOf(i)));
+        return us / 1000;
+      }
+    }
+    return this._maxUs / 1000;
+  }
+
+  /**
+   * Add another histogram's counts into this one
+   * @param {LatencyHistogram} other
+   * @returns {LatencyHistogram} this
+   */
+  merge(other) {
+    if (!other || other.bucketCount !== this.bucketCount) {
+      throw new Error('LatencyHistogram.merge requires a histogram with the same precision');
+    }
+    if (other.count === 0) return this;
+    for (let i = 0; i < this.bucketCount; i++) {
+      this._counts[i] += other._counts[i];
+    }
+    this.count += other.count;
+    this._sumUs += other._sumUs;
+    this._minUs = Math.min(this._minUs, other._minUs);
+    this._maxUs = Math.max(this._maxUs, other._maxUs);
+    return this;
+  }
+
+  /**
+   * Percentile summary in milliseconds
+   * @returns {{count: number, minMs: number|null, meanMs: number|null, p50: number|null, p90: number|null, p99: number|null, p999: number|null, maxMs: number|null}}
+   */
+  summary() {
+    const empty = this.count === 0;
+    return {
+      count: this.count,
+      minMs: empty ? null : this._minUs / 1000,
+      meanMs: empty ? null : Math.round(this._sumUs / this.count) / 1000,
+      p50: this.percentile(50),
+      p90: this.percentile(90),
+      p99: this.percentile(99),
+      p999: this.percentile(99.9),
+      maxMs: empty ? null : this._maxUs / 1000
+    };
+  }
+
+  /**
+   * Serialize with sparse buckets so a run can be stored and compared later
+   */
+  toJSON() {
+    const buckets = [];
+    for (let i = 0; i < this.bucketCount; i++) {
+      if (this._counts[i] > 0) buckets.push([i, this._counts[i]]);
+    }
+    return {
+      precisionBits: this.precisionBits,
+      count: this.count,
+      sumUs: this._sumUs,
+      minUs: this.count ? this._minUs : null,
+      maxUs: this._maxUs,
+      buckets
+    };
+  }
+
+  /**
+   * @param {Object} data - Output of toJSON()
+   * @returns {LatencyHistogram}
+   */
+  static fromJSON(data) {
+    const hist = new LatencyHistogram({ precisionBits: data?.precisionBits ?? DEFAULT_PRECISION_BITS });
+    for (const [index, n] of data?.buckets || []) {
+      if (index >= 0 && index < hist.bucketCount) hist._counts[index] += n;
+    }
+    hist.count = data?.count || 0;
+    hist._sumUs = data?.sumUs || 0;
+    hist._minUs = data?.minUs ?? MAX_VALUE_US;
+    hist._maxUs = data?.maxUs || 0;
+    return hist;
+  }
+}
+
+module.exports = { LatencyHistogram };
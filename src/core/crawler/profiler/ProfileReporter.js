@@ -9,6 +9,10 @@
  * @module ProfileReporter
  */
 
+const { StageHistograms } = require('./StageHistograms');
+
+const DIFF_PERCENTILES = ['p50', 'p99', 'p999'];
+
 /**
  * @typedef {Object} ReportOptions
  * @property {'ascii'|'json'|'markdown'} [format='ascii'] - Output format
@@ -408,6 +412,118 @@ class ProfileReporter {
     
     return lines.join('\n');
   }
+
+  /**
+   * Compare stage latency percentiles between two runs
+   *
+   * Either side may be a StageHistograms instance, its toJSON() output (e.g.
+   * loaded from a saved run) or a snapshot().
+   *
+   * @param {StageHistograms|Object} baseline
+   * @param {StageHistograms|Object} current
+   * @param {Object} [options]
+   * @param {boolean} [options.hosts=false] - Include per-host rows
+   * @returns {{stages: Array<{stage: string, host: string|null, baseline: Object|null, current: Object|null, change: Object<string, number|null>}>}}
+   */
+  diffHistograms(baseline, current, options = {}) {
+    const base = toHistogramSnapshot(baseline).stages;
+    const curr = toHistogramSnapshot(current).stages;
+    const rows = [];
+
+    const pushRow = (stage, host, before, after) => {
+      const change = {};
+      for (const key of DIFF_PERCENTILES) {
+        const from = before?.[key];
+        const to = after?.[key];
+        change[key] = from > 0 && to != null ? Number((((to - from) / from) * 100).toFixed(1)) : null;
+      }
+      rows.push({
+        stage,
+        host,
+        baseline: before ? pickPercentiles(before) : null,
+        current: after ? pickPercentiles(after) : null,
+        change
+      });
+    };
+
+    for (const stage of new Set([...Object.keys(base), ...Object.keys(curr)])) {
+      pushRow(stage, null, base[stage], curr[stage]);
+      if (options.hosts) {
+        const hosts = new Set([...Object.keys(base[stage]?.hosts || {}), ...Object.keys(curr[stage]?.hosts || {})]);
+        for (const host of [...hosts].sort()) {
+          pushRow(stage, host, base[stage]?.hosts?.[host], curr[stage]?.hosts?.[host]);
+        }
+      }
+    }
+
+    return { stages: rows };
+  }
+
+  /**
+   * Render diffHistograms() as a report
+   *
+   * @param {StageHistograms|Object} baseline
+   * @param {StageHistograms|Object} current
+   * @param {ReportOptions & {hosts?: boolean}} [options]
+   * @returns {string}
+   */
+  reportHistogramDiff(baseline, current, options = {}) {
+    const diff = this.diffHistograms(baseline, current, options);
+    const format = options.format || 'ascii';
+    if (format === 'json') {
+      return JSON.stringify(diff, null, 2);
+    }
+
+    const label = (row) => (row.host ? `  ${row.host}` : row.stage);
+    const cell = (row, key) => {
+      const from = row.baseline?.[key];
+      const to = row.current?.[key];
+      const pct = row.change[key];
+      const pctStr = pct == null ? '' : ` (${pct > 0 ? '+' : ''}${pct}%)`;
+      return `${formatMs(from)} → ${formatMs(to)}${pctStr}`;
+    };
+
+    if (format === 'markdown') {
+      const lines = ['## Stage Latency Comparison', ''];
+      lines.push('| Stage | Samples | ' + DIFF_PERCENTILES.join(' | ') + ' |');
+      lines.push('|-------|---------|' + DIFF_PERCENTILES.map(() => '------').join('|') + '|');
+      for (const row of diff.stages) {
+        const samples = `${row.baseline?.count ?? 0} → ${row.current?.count ?? 0}`;
+        lines.push(`| ${row.host ? `↳ ${row.host}` : row.stage} | ${samples} | ${DIFF_PERCENTILES.map((key) => cell(row, key)).join(' | ')} |`);
+      }
+      return lines.join('\n');
+    }
+
+    const nameWidth = Math.max(12, ...diff.stages.map((row) => label(row).length + 1));
+    const lines = ['STAGE LATENCY COMPARISON', '═'.repeat(50), ''];
+    lines.push('Stage'.padEnd(nameWidth) + DIFF_PERCENTILES.map((key) => key.padStart(30)).join(''));
+    lines.push('─'.repeat(nameWidth + 30 * DIFF_PERCENTILES.length));
+    for (const row of diff.stages) {
+      lines.push(label(row).padEnd(nameWidth) + DIFF_PERCENTILES.map((key) => cell(row, key).padStart(30)).join(''));
+    }
+    return lines.join('\n');
+  }
+}
+
+function toHistogramSnapshot(source) {
+  if (!source) return { stages: {} };
+  if (typeof source.snapshot === 'function') return source.snapshot();
+  const stages = Object.values(source.stages || {});
+  if (stages.length > 0 && stages[0] && stages[0].all) {
+    return StageHistograms.fromJSON(source).snapshot();
+  }
+  return { stages: source.stages || {} };
+}
+
+function pickPercentiles(summary) {
+  const picked = { count: summary.count || 0 };
+  for (const key of DIFF_PERCENTILES) picked[key] = summary[key] ?? null;
+  return picked;
+}
+
+function formatMs(value) {
+  if (value == null) return '-';
+  return value >= 100 ? `${Math.round(value)}ms` : `${Number(value.toFixed(2))}ms`;
 }
 
 module.exports = { ProfileReporter };
@@ -0,0 +1,205 @@
+'use strict';
+
+/**
+ * StageHistograms — Always-on latency histograms per pipeline stage and host
+ *
+ * One LatencyHistogram per stage plus one per (stage, host). Memory is
+ * bounded: the first `maxHosts` hosts seen get their own histograms and every
+ * later host shares the OTHER_HOST bucket, so a crawl that fans out over
+ * thousands of domains costs the same as one over a few dozen.
+ *
+ * Stage names are whatever the callers use: pipeline step ids (fetch,
+ * parseHtml, processArticle, ...), the network phases shared with
+ * CrawlProfiler (dns, tcp, tls, firstByte, download) and the ArticleProcessor
+ * stages (readability, persist).
+ *
+ * @module StageHistograms
+ * @example
+ * const stages = new StageHistograms();
+ * const t0 = StageHistograms.now();
+ * const $ = cheerio.load(html);
+ * stages.since('parseHtml', host, t0);
+ * stages.snapshot().stages.parseHtml.hosts[host].p99;
+ */
+
+const { LatencyHistogram } = require('./LatencyHistogram');
+
+const OTHER_HOST = '(other)';
+const DEFAULT_MAX_HOSTS = 32;
+
+class StageHistograms {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxHosts=32] - Hosts tracked individually
+   * @param {number} [options.precisionBits=5] - Passed to each LatencyHistogram
+   */
+  constructor(options = {}) {
+    this.maxHosts = Math.max(0, Math.trunc(options.maxHosts ?? DEFAULT_MAX_HOSTS));
+    this.precisionBits = options.precisionBits;
+    this.startedAt = Date.now();
+
+    /** @type {Map<string, {all: LatencyHistogram, hosts: Map<string, LatencyHistogram>}>} */
+    this._stages = new Map();
+
+    /** @type {Set<string>} */
+    this._hosts = new Set();
+  }
+
+  /**
+   * Current high-resolution time, for use with since()
+   * @returns {bigint}
+   */
+  static now() {
+    return process.hrtime.bigint();
+  }
+
+  /**
+   * Record a duration in nanoseconds
+   * @param {string} stage
+   * @param {string|null} host
+   * @param {bigint|number} ns
+   */
+  record(stage, host, ns) {
+    const entry = this._stage(stage);
+    entry.all.recordNs(ns);
+    const hostHist = this._hostHistogram(entry, host);
+    if (hostHist) hostHist.recordNs(ns);
+  }
+
+  /**
+   * Record a duration in milliseconds (for timings that only exist as ms)
+   * @param {string} stage
+   * @param {string|null} host
+   * @param {number} ms
+   */
+  recordMs(stage, host, ms) {
+    if (typeof ms !== 'number' || !Number.isFinite(ms)) return;
+    const entry = this._stage(stage);
+    entry.all.recordMs(ms);
+    const hostHist = this._hostHistogram(entry, host);
+    if (hostHist) hostHist.recordMs(ms);
+  }
+
+  /**
+   * Record the time elapsed since `startNs` (from StageHistograms.now())
+   * @returns {bigint} Elapsed nanoseconds
+   */
+  since(stage, host, startNs) {
+    const elapsed = process.hrtime.bigint() - startNs;
+    this.record(stage, host, elapsed);
+    return elapsed;
+  }
+
+  _stage(stage) {
+    let entry = this._stages.get(stage);
+    if (!entry) {
+      entry = { all: this._create(), hosts: new Map() };
+      this._stages.set(stage, entry);
+    }
+    return entry;
+  }
+
+  _hostHistogram(entry, host) {
+    if (!host) return null;
+    let key = host;
+    if (!this._hosts.has(host)) {
+      if (this._hosts.size < this.maxHosts) {
+        this._hosts.add(host);
+      } else {
+        key = OTHER_HOST;
+      }
+    }
+    let hist = entry.hosts.get(key);
+    if (!hist) {
+      hist = this._create();
+      entry.hosts.set(key, hist);
+    }
+    return hist;
+  }
+
+  _create() {
+    return new LatencyHistogram({ precisionBits: this.precisionBits });
+  }
+
+  /**
+   * @param {string} stage
+   * @param {string} [host] - Omit for the all-hosts histogram
+   * @returns {LatencyHistogram|null}
+   */
+  get(stage, host) {
+    const entry = this._stages.get(stage);
+    if (!entry) return null;
+    if (!host) return entry.all;
+    return entry.hosts.get(this._hosts.has(host) ? host : OTHER_HOST) || null;
+  }
+
+  /** @returns {string[]} */
+  getStages() {
+    return [...this._stages.keys()];
+  }
+
+  /**
+   * Percentile summaries per stage (and per host)
+   *
+   * @param {Object} [options]
+   * @param {boolean} [options.hosts=true] - Include per-host summaries
+   * @returns {{startedAt: number, capturedAt: number, stages: Object<string, Object>}}
+   */
+  snapshot(options = {}) {
+    const includeHosts = options.hosts !== false;
+    const stages = {};
+    for (const [stage, entry] of this._stages) {
+      const summary = entry.all.summary();
+      if (includeHosts) {
+        summary.hosts = {};
+        for (const [host, hist] of entry.hosts) {
+          summary.hosts[host] = hist.summary();
+        }
+      }
+      stages[stage] = summary;
+    }
+    return { startedAt: this.startedAt, capturedAt: Date.now(), stages };
+  }
+
+  /**
+   * Full serialization (bucket counts included) so a run can be saved and
+   * reloaded with fromJSON() for later comparison
+   */
+  toJSON() {
+    const stages = {};
+    for (const [stage, entry] of this._stages) {
+      const hosts = {};
+      for (const [host, hist] of entry.hosts) {
+        hosts[host] = hist.toJSON();
+      }
+      stages[stage] = { all: entry.all.toJSON(), hosts };
+    }
+    return { maxHosts: this.maxHosts, precisionBits: this.precisionBits ?? null, startedAt: this.startedAt, stages };
+  }
+
+  /**
+   * @param {Object} data - Output of toJSON()
+   * @returns {StageHistograms}
+   */
+  static fromJSON(data) {
+    const result = new StageHistograms({ maxHosts: data?.maxHosts, precisionBits: data?.precisionBits ?? undefined });
+    if (data?.startedAt) result.startedAt = data.startedAt;
+    for (const [stage, stored] of Object.entries(data?.stages || {})) {
+      const entry = { all: LatencyHistogram.fromJSON(stored.all), hosts: new Map() };
+      for (const [host, hist] of Object.entries(stored.hosts || {})) {
+        entry.hosts.set(host, LatencyHistogram.fromJSON(hist));
+        if (host !== OTHER_HOST) result._hosts.add(host);
+      }
+      result._stages.set(stage, entry);
+    }
+    return result;
+  }
+
+  reset() {
+    this._stages.clear();
+    this._hosts.clear();
+    this.startedAt = Date.now();
+  }
+}
+
+module.exports = { StageHistograms, OTHER_HOST };
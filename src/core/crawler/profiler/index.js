@@ -4,7 +4,9 @@
  * Crawl Profiler Module
  * 
  * High-resolution timing instrumentation for crawl phases with
- * bottleneck detection and report generation.
+ * bottleneck detection and report generation. StageHistograms keeps
+ * fixed-memory per-stage/per-host latency histograms that stay on in
+ * production.
  * 
  * @module crawler/profiler
  */
@@ -12,11 +14,16 @@
 const { CrawlProfiler, VALID_PHASES } = require('./CrawlProfiler');
 const { BottleneckDetector, DEFAULT_THRESHOLDS, RECOMMENDATIONS } = require('./BottleneckDetector');
 const { ProfileReporter } = require('./ProfileReporter');
+const { LatencyHistogram } = require('./LatencyHistogram');
+const { StageHistograms, OTHER_HOST } = require('./StageHistograms');
 
 module.exports = {
   CrawlProfiler,
   BottleneckDetector,
   ProfileReporter,
+  LatencyHistogram,
+  StageHistograms,
+  OTHER_HOST,
   VALID_PHASES,
   DEFAULT_THRESHOLDS,
   RECOMMENDATIONS
@@ -3,9 +3,10 @@
 /**
  * Pure builder for the normally-hidden per-crawl detail surfaced on the crawler
  * 'progress' event — the coarse phase, which sitemap files were harvested, the
- * pages currently downloading, per-host rate limits, and robots policy. The
- * crawl-status UI reads this off job.progress to drive the phase badge and the
- * expandable job-detail panel.
+ * pages currently downloading, per-host rate limits, robots policy, and how
+ * many database lookups the seen-URL filter is saving. The crawl-status UI
+ * reads this off job.progress to drive the phase badge and the expandable
+ * job-detail panel.
  *
  * Kept standalone and pure (no crawler `this`, no I/O) so it is unit-testable
  * without constructing a full NewsCrawler, which transitively loads jsdom.
@@ -37,6 +38,7 @@ function buildProgressDetail({
   currentDownloads = null,
   domainLimits = null,
   robotsInfo = null,
+  seenFilter = null,
   now = Date.now()
 } = {}) {
   const detail = { phase: phase || null };
@@ -108,6 +110,19 @@ function buildProgressDetail({
     }
   } catch (_) { /* robots detail is best-effort */ }
 
+  try {
+    if (seenFilter && seenFilter.ready) {
+      detail.seenFilter = {
+        kind: seenFilter.kind || null,
+        items: seenFilter.items ?? 0,
+        dbLookupsSkipped: seenFilter.dbLookupsSkipped ?? 0,
+        savingsRate: seenFilter.savingsRate ?? null,
+        observedFpRate: seenFilter.observedFpRate ?? null,
+        estimatedFpRate: seenFilter.estimatedFpRate ?? null
+      };
+    }
+  } catch (_) { /* seen-filter detail is best-effort */ }
+
   return detail;
 }
 
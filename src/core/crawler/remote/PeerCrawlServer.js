@@ -6,11 +6,15 @@ const { RemoteCrawlerAdapter } = require('./RemoteCrawlerAdapter');
 const {
   generateNodeId,
   createAnnouncement,
+  createShardStealRequest,
+  createShardTransfer,
   validateMessage,
   MessageTypes,
   PROTOCOL_VERSION,
 } = require('./PeerProtocol');
 
+const MAX_PENDING_SEEDS = 5000;
+
 /**
  * PeerCrawlServer — Express API for hosting NewsCrawler peers.
  *
@@ -22,6 +26,11 @@ const {
  * `deploy/remote-crawler-v2/multi-domain-server.js` with a unified
  * server backed by the full NewsCrawler engine.
  *
+ * Each domain worker is a host shard. Peers that run out of work pull
+ * whole shards that a loaded peer has not started yet (`/api/shards/steal`),
+ * so one host is only ever crawled by one peer and its politeness limits
+ * stay global.
+ *
  * @example
  * const { createPeerServer } = require('./PeerCrawlServer');
  * const server = createPeerServer({
@@ -41,6 +50,7 @@ const {
  * @param {Function} options.crawlerFactory - `(domain, options) => NewsCrawler`
  * @param {Object[]} [options.domains=[]] - Initial domain configs
  * @param {number} [options.maxConcurrent=5] - Max concurrent crawling domains
+ * @param {string} [options.baseUrl] - This peer's public URL (sent with shard steal requests)
  * @returns {{ app: express.Application, orchestrator: Object }}
  */
 function createPeerApp(options = {}) {
@@ -64,6 +74,14 @@ function createPeerApp(options = {}) {
   /** @type {Map<string, { nodeId: string, baseUrl: string, domains: string[], lastSeen: string }>} */
   const peers = new Map();
 
+  const stealStats = {
+    stealAttempts: 0,
+    steals: 0,
+    shardsStolen: 0,
+    shardsGiven: 0,
+    stealRequestsServed: 0,
+  };
+
   // Initialize workers for configured domains
   for (const domainConfig of initialDomains) {
     const domain = typeof domainConfig === 'string' ? domainConfig : domainConfig.domain;
@@ -102,6 +120,8 @@ function createPeerApp(options = {}) {
       crawler,
       config: { domain, ...config },
       state: 'idle',
+      // Seeds kept while idle so an unstarted shard can move to another peer
+      pendingSeeds: Array.isArray(config.seedUrls) ? config.seedUrls.slice(0, MAX_PENDING_SEEDS) : [],
     };
     workers.set(domain, entry);
     return entry;
@@ -119,6 +139,107 @@ function createPeerApp(options = {}) {
     return count;
   }
 
+  function _getQueuedShards() {
+    const queued = [];
+    for (const [domain, entry] of workers) {
+      if (entry.state === 'idle') queued.push(domain);
+    }
+    return queued;
+  }
+
+  /**
+   * Hand up to half of this peer's unstarted shards to a thief. Running
+   * shards never move, so a host is never crawled from two peers at once.
+   */
+  function _takeShards(maxShards = 2) {
+    const queued = _getQueuedShards();
+    const count = Math.min(maxShards, Math.floor(queued.length / 2));
+    const shards = [];
+    for (const domain of queued.slice(queued.length - count)) {
+      const entry = workers.get(domain);
+      workers.delete(domain);
+      shards.push({
+        domain,
+        maxPages: entry.config.maxPages || entry.config.maxDownloads,
+        crawlType: entry.config.crawlType,
+        seedUrls: entry.pendingSeeds,
+      });
+      if (typeof entry.crawler.dispose === 'function') {
+        Promise.resolve(entry.crawler.dispose()).catch(() => {});
+      }
+    }
+    stealStats.shardsGiven += shards.length;
+    return shards;
+  }
+
+  /**
+   * Adopt transferred shards; start as many as concurrency allows.
+   */
+  function _acceptShards(shards = []) {
+    const accepted = [];
+    for (const shard of shards) {
+      if (!shard || !shard.domain || workers.has(shard.domain)) continue;
+      const entry = _createWorker(shard.domain, {
+        maxPages: shard.maxPages,
+        crawlType: shard.crawlType,
+        seedUrls: shard.seedUrls,
+      });
+      if (_getRunningCount() < maxConcurrent) {
+        const startResult = entry.adapter.start({ maxDownloads: shard.maxPages });
+        if (startResult.started) entry.state = 'running';
+      }
+      accepted.push({ domain: shard.domain, state: entry.state });
+    }
+    return accepted;
+  }
+
+  /**
+   * Pull shards from known peers until one hands over work.
+   *
+   * @param {Object} [opts]
+   * @param {number} [opts.maxShards=2]
+   * @param {Function} [opts.fetchImpl=fetch]
+   * @returns {Promise<{stolen: number, fromNodeId: string|null, accepted: Object[]}>}
+   */
+  async function _stealFromPeers({ maxShards = 2, fetchImpl = globalThis.fetch } = {}) {
+    stealStats.stealAttempts++;
+    const candidates = Array.from(peers.values()).filter(p => p.baseUrl);
+    for (const peer of candidates) {
+      try {
+        const res = await fetchImpl(`${peer.baseUrl.replace(/\/$/, '')}/api/shards/steal`, {
+          method: 'POST',
+          headers: { 'Content-Type': 'application/json' },
+          body: JSON.stringify(createShardStealRequest({ nodeId, baseUrl: options.baseUrl || null, maxShards })),
+        });
+        if (!res.ok) continue;
+        const transfer = await res.json();
+        if (!transfer || !Array.isArray(transfer.shards) || transfer.shards.length === 0) continue;
+        const accepted = _acceptShards(transfer.shards);
+        stealStats.steals++;
+        stealStats.shardsStolen += accepted.length;
+        return { stolen: accepted.length, fromNodeId: transfer.nodeId, accepted };
+      } catch (_) {
+        // Unreachable peer; try the next one
+      }
+    }
+    return { stolen: 0, fromNodeId: null, accepted: [] };
+  }
+
+  function _getWorkStealingStats() {
+    let pagesDownloaded = 0;
+    for (const [, entry] of workers) {
+      pagesDownloaded += entry.adapter.getStatus().stats?.pagesDownloaded || 0;
+    }
+    const uptimeMin = Math.max((Date.now() - startedAt.getTime()) / 60000, 1 / 60);
+    return {
+      queuedShards: _getQueuedShards().length,
+      runningShards: _getRunningCount(),
+      pagesDownloaded,
+      throughputPerMin: Math.round((pagesDownloaded / uptimeMin) * 10) / 10,
+      ...stealStats,
+    };
+  }
+
   // ── Express App ─────────────────────────────────────────────
   const app = express();
   app.disable('x-powered-by');
@@ -159,6 +280,7 @@ function createPeerApp(options = {}) {
       running: _getRunningCount(),
       domains: domainStatuses,
       peers: Array.from(peers.values()),
+      workStealing: _getWorkStealingStats(),
     });
   });
 
@@ -253,6 +375,9 @@ function createPeerApp(options = {}) {
     }
 
     const result = entry.adapter.seedUrls(urls);
+    if (entry.state === 'idle') {
+      entry.pendingSeeds.push(...urls.slice(0, Math.max(0, MAX_PENDING_SEEDS - entry.pendingSeeds.length)));
+    }
     res.json({ domain, ...result });
   });
 
@@ -376,6 +501,42 @@ function createPeerApp(options = {}) {
     });
   });
 
+  // ── Work Stealing ─────────────────────────────────────────
+
+  app.post('/api/shards/steal', (req, res) => {
+    const msg = req.body;
+    const validation = validateMessage(msg);
+    if (!validation.valid) {
+      return res.status(400).json({ error: validation.error });
+    }
+    if (msg.type !== MessageTypes.SHARD_STEAL) {
+      return res.status(400).json({ error: `Expected shard-steal message, got: ${msg.type}` });
+    }
+
+    stealStats.stealRequestsServed++;
+    const shards = _takeShards(Math.max(1, parseInt(msg.maxShards, 10) || 2));
+    res.json(createShardTransfer({ nodeId, targetNodeId: msg.nodeId, shards }));
+  });
+
+  app.post('/api/shards/accept', (req, res) => {
+    const msg = req.body;
+    const validation = validateMessage(msg);
+    if (!validation.valid) {
+      return res.status(400).json({ error: validation.error });
+    }
+    if (msg.type !== MessageTypes.SHARD_TRANSFER) {
+      return res.status(400).json({ error: `Expected shard-transfer message, got: ${msg.type}` });
+    }
+
+    const accepted = _acceptShards(msg.shards || []);
+    stealStats.shardsStolen += accepted.length;
+    res.json({ nodeId, accepted });
+  });
+
+  app.get('/api/shards/stats', (_req, res) => {
+    res.json({ nodeId, ...(_getWorkStealingStats()) });
+  });
+
   // ── Config ────────────────────────────────────────────────
 
   app.get('/api/config', (_req, res) => {
@@ -426,6 +587,11 @@ function createPeerApp(options = {}) {
       getWorker: _getWorker,
       createWorker: _createWorker,
       getRunningCount: _getRunningCount,
+      getQueuedShards: _getQueuedShards,
+      takeShards: _takeShards,
+      acceptShards: _acceptShards,
+      stealFromPeers: _stealFromPeers,
+      getWorkStealingStats: _getWorkStealingStats,
     },
   };
 }
@@ -433,13 +599,15 @@ function createPeerApp(options = {}) {
 /**
  * Create and start a full peer server.
  *
- * @param {Object} options - Same as createPeerApp + { port, host }
+ * @param {Object} options - Same as createPeerApp + { port, host, stealIntervalMs }
+ * @param {number} [options.stealIntervalMs=0] - When > 0, an idle peer polls known peers for shards
  * @returns {{ app, orchestrator, start: Function, stop: Function }}
  */
 function createPeerServer(options = {}) {
-  const { port = 0, host = '0.0.0.0' } = options;
+  const { port = 0, host = '0.0.0.0', stealIntervalMs = 0 } = options;
   const { app, orchestrator } = createPeerApp(options);
   let server = null;
+  let stealTimer = null;
 
   return {
     app,
@@ -454,6 +622,16 @@ function createPeerServer(options = {}) {
             const addr = server.address();
             console.log(`[PeerCrawlServer] Node ${orchestrator.nodeId} listening on http://${host}:${addr.port}`);
             console.log(`[PeerCrawlServer] Domains: ${orchestrator.workers.size}`);
+            if (stealIntervalMs > 0) {
+              stealTimer = setInterval(() => {
+                const idle = orchestrator.getQueuedShards().length === 0 &&
+                  orchestrator.getRunningCount() < (options.maxConcurrent || 5);
+                if (idle && orchestrator.peers.size > 0) {
+                  orchestrator.stealFromPeers().catch(() => {});
+                }
+              }, stealIntervalMs);
+              stealTimer.unref?.();
+            }
             resolve({ host, port: addr.port, nodeId: orchestrator.nodeId });
           })
           .on('error', reject);
@@ -461,6 +639,10 @@ function createPeerServer(options = {}) {
     },
 
     async stop() {
+      if (stealTimer) {
+        clearInterval(stealTimer);
+        stealTimer = null;
+      }
       // Stop all crawlers
       for (const [, entry] of orchestrator.workers) {
         if (entry.state === 'running') {
@@ -38,6 +38,10 @@ const MessageTypes = Object.freeze({
   STATUS_REQUEST: 'status-request',
   /** Status response */
   STATUS_RESPONSE: 'status-response',
+  /** Idle peer asks a loaded peer for whole host shards */
+  SHARD_STEAL: 'shard-steal',
+  /** Loaded peer hands host shards (config + pending seeds) to the thief */
+  SHARD_TRANSFER: 'shard-transfer',
 });
 
 // ── Node ID generation ──────────────────────────────────────
@@ -184,6 +188,53 @@ function createHeartbeat({ nodeId, summary = {} }) {
   };
 }
 
+/**
+ * Create a shard steal request (sent by an idle peer to a loaded one).
+ *
+ * @param {Object} params
+ * @param {string} params.nodeId - Requesting (idle) peer
+ * @param {string} [params.baseUrl] - Requesting peer's base URL
+ * @param {number} [params.maxShards=2] - Max host shards to take
+ * @returns {Object} Shard steal message
+ */
+function createShardStealRequest({ nodeId, baseUrl = null, maxShards = 2 }) {
+  return {
+    type: MessageTypes.SHARD_STEAL,
+    version: PROTOCOL_VERSION,
+    nodeId,
+    baseUrl,
+    timestamp: new Date().toISOString(),
+    maxShards,
+  };
+}
+
+/**
+ * Create a shard transfer message. Each shard is one host with everything
+ * needed to resume it elsewhere; the sender drops the shard once sent.
+ *
+ * @param {Object} params
+ * @param {string} params.nodeId - Sending (victim) peer
+ * @param {string} params.targetNodeId - Receiving (thief) peer
+ * @param {Object[]} params.shards - Array of { domain, maxPages, crawlType, seedUrls }
+ * @returns {Object} Shard transfer message
+ */
+function createShardTransfer({ nodeId, targetNodeId, shards = [] }) {
+  return {
+    type: MessageTypes.SHARD_TRANSFER,
+    version: PROTOCOL_VERSION,
+    nodeId,
+    targetNodeId,
+    timestamp: new Date().toISOString(),
+    transferId: `st-${Date.now().toString(36)}-${crypto.randomBytes(2).toString('hex')}`,
+    shards: shards.map(s => ({
+      domain: s.domain,
+      maxPages: s.maxPages || 200,
+      crawlType: s.crawlType || 'basic',
+      seedUrls: Array.isArray(s.seedUrls) ? s.seedUrls : [],
+    })),
+  };
+}
+
 // ── Validation ──────────────────────────────────────────────
 
 /**
@@ -217,5 +268,7 @@ module.exports = {
   createResultSync,
   createIntelligenceShare,
   createHeartbeat,
+  createShardStealRequest,
+  createShardTransfer,
   validateMessage,
 };
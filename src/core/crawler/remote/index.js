@@ -20,6 +20,8 @@ const {
   createResultSync,
   createIntelligenceShare,
   createHeartbeat,
+  createShardStealRequest,
+  createShardTransfer,
   validateMessage,
 } = require('./PeerProtocol');
 
@@ -40,5 +42,7 @@ module.exports = {
   createResultSync,
   createIntelligenceShare,
   createHeartbeat,
+  createShardStealRequest,
+  createShardTransfer,
   validateMessage,
 };
@@ -1,4 +1,4 @@
-const robotsParser = require('robots-parser');
+const { robotsRulesParser } = require('./RobotsRules');
 const { compact } = require('../../shared/utils/pipelines');
 
 const DEFAULT_ROBOTS_FETCH_TIMEOUT_MS = Number(process.env.CRAWLER_ROBOTS_FETCH_TIMEOUT_MS || 15000);
@@ -24,7 +24,7 @@ async function loadRobots(baseUrl) {
     const res = await timeoutFetch(robotsUrl);
     if (res.ok) {
       const txt = await res.text();
-      rules = robotsParser(robotsUrl, txt);
+      rules = robotsRulesParser(robotsUrl, txt);
       loaded = true;
       // Extract sitemaps
       let sm = [];
@@ -1,10 +1,14 @@
-const { XMLParser } = require('fast-xml-parser');
+const { readSitemapStream, responseChunks } = require('./SitemapStreamReader');
 
 const DEFAULT_SITEMAP_FETCH_TIMEOUT_MS = Number(process.env.CRAWLER_SITEMAP_FETCH_TIMEOUT_MS || 15000);
 // TTL for skipping the network entirely (RobotsCache pattern). Default 0 =
 // always revalidate: news sitemaps change constantly, so a conditional GET
 // (304 = ~200 bytes instead of ~580KB) is the safe default.
 const DEFAULT_SITEMAP_CACHE_TTL_SECONDS = Number(process.env.CRAWLER_SITEMAP_CACHE_TTL_SECONDS || 0);
+// Bodies above this are streamed without being kept for the cache.
+const DEFAULT_SITEMAP_CACHE_MAX_BODY_BYTES = 5 * 1024 * 1024;
+const DEFAULT_SITEMAP_BATCH_SIZE = 500;
+const SITEMAP_SEEN_LIMIT = 250000;
 
 async function timeoutFetch(url, options = {}, fetchOverride = null) {
   const fetchImpl = typeof fetchOverride === 'function'
@@ -22,30 +26,47 @@ async function timeoutFetch(url, options = {}, fetchOverride = null) {
   }
 }
 
-async function parseXmlMaybe(xml) {
-  try {
-    const parser = new XMLParser({
-      ignoreAttributes: false,
-      attributeNamePrefix: "@_"
-    });
-    return parser.parse(xml);
-  } catch (err) {
-    // Fallback to regex if XML parsing fails
-    const locs = [];
-    const re = /<loc>\s*([^<]+?)\s*<\/loc>/gi;
-    let m;
-    while ((m = re.exec(xml)) !== null) {
-      locs.push(m[1]);
-    }
-    return { __locs: locs };
-  }
-}
-
+/**
+ * Discover URLs from sitemaps and sitemap indexes.
+ *
+ * Sitemaps are streamed (SitemapStreamReader): bodies are gunzipped on the
+ * fly, `<url>` entries are pushed in batches as they are parsed and child
+ * sitemaps of an index are queued as they appear, so a multi-GB index never
+ * sits in memory. Only bodies up to `cacheMaxBodyBytes` are kept for the
+ * conditional-fetch cache.
+ *
+ * @param {string} baseUrl
+ * @param {string} domain
+ * @param {string[]} sitemapUrls - Starting sitemaps (default: <baseUrl>/sitemap.xml)
+ * @param {Object} [opts]
+ * @param {number} [opts.sitemapMaxUrls=5000] - Stop after this many URLs (0 = unlimited)
+ * @param {(url: string, meta: Object) => void} [opts.push] - Called per discovered URL
+ * @param {(batch: {sitemapUrl: string, urls: number, offset: number}) => (void|Promise<void>)} [opts.onBatch]
+ *   Awaited after each pushed batch; `offset` is the resume point for that sitemap
+ * @param {number} [opts.batchSize=500]
+ * @param {Date|string|number} [opts.lastmodSince] - Skip URLs and child sitemaps with an older lastmod
+ * @param {Map<string, number>|Object<string, number>} [opts.resumeOffsets] - Byte offset to resume each sitemap from
+ * @param {(info: {sitemapUrl: string, complete: boolean, bytes: number, offset: number, stats: Object}) => void} [opts.onSitemapDone]
+ *   Called once a sitemap has been streamed; `complete` is false when the URL cap cut it short
+ * @param {number} [opts.cacheMaxBodyBytes=5MB]
+ * @returns {Promise<number>} URLs pushed
+ */
 async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
   const list = Array.isArray(sitemapUrls) && sitemapUrls.length ? sitemapUrls.slice() : [ `${baseUrl}/sitemap.xml` ];
+  const listed = new Set(list);
   const seen = new Set();
   let enqueued = 0;
   const maxUrls = Math.max(0, opts?.sitemapMaxUrls || 5000);
+  const batchSize = Math.max(1, opts?.batchSize || DEFAULT_SITEMAP_BATCH_SIZE);
+  const cacheMaxBodyBytes = Number.isFinite(opts?.cacheMaxBodyBytes)
+    ? opts.cacheMaxBodyBytes
+    : DEFAULT_SITEMAP_CACHE_MAX_BODY_BYTES;
+  const resumeOffsets = opts?.resumeOffsets || null;
+  const resumeOffsetOf = (u) => {
+    if (!resumeOffsets) return 0;
+    const offset = typeof resumeOffsets.get === 'function' ? resumeOffsets.get(u) : resumeOffsets[u];
+    return Number.isFinite(offset) && offset > 0 ? offset : 0;
+  };
 
   // Conditional-fetch cache, injected (DB-backed via news-crawler-db's
   // sitemap_cache accessors — see RobotsAndSitemapCoordinator). Shape:
@@ -76,7 +97,85 @@ async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
     } catch { /* visibility is best-effort */ }
   };
 
-  const fetchText = async (u) => {
+  const pushUrl = (u, meta = {}) => {
+    if (maxUrls && enqueued >= maxUrls) return;
+    try {
+      const abs = new URL(u, baseUrl).href;
+      if (new URL(abs).hostname !== domain) return;
+      if (seen.has(abs)) return;
+      // Bounded dedupe for unlimited runs; the queue's own seen filter
+      // catches anything that slips past after a reset.
+      if (seen.size >= SITEMAP_SEEN_LIMIT) seen.clear();
+      seen.add(abs);
+      if (typeof opts?.push === 'function') {
+        opts.push(abs, meta);
+      }
+      enqueued++;
+    } catch {}
+  };
+
+  // One chunk's entries, pushed in `batchSize` slices. A slice that ends
+  // mid-chunk reports the previous chunk's offset: resuming from there
+  // re-reads a few entries (deduped downstream) but never skips one.
+  const onEntries = (u) => {
+    let safeOffset = resumeOffsetOf(u);
+    return async (entries, offset) => {
+      for (let start = 0; start < entries.length; start += batchSize) {
+        const before = enqueued;
+        const end = Math.min(entries.length, start + batchSize);
+        for (let i = start; i < end; i++) {
+          const e = entries[i];
+          if (e.kind === 'sitemap') {
+            if (!listed.has(e.loc)) {
+              listed.add(e.loc);
+              list.push(e.loc);
+            }
+            continue;
+          }
+          const meta = {};
+          if (e.lastmod) meta.lastmod = e.lastmod;
+          if (e.changefreq) meta.changefreq = e.changefreq;
+          if (e.priority != null) meta.priority = e.priority;
+          if (e.isNews) {
+            meta.isNews = true;
+            if (e.publicationDate) meta.publicationDate = e.publicationDate;
+            if (e.title) meta.title = e.title;
+          }
+          pushUrl(e.loc, meta);
+        }
+        const pushed = enqueued - before;
+        if (pushed > 0 && typeof opts?.onBatch === 'function') {
+          try {
+            await opts.onBatch({ sitemapUrl: u, urls: pushed, offset: end === entries.length ? offset : safeOffset });
+          } catch { /* progress reporting is best-effort */ }
+        }
+        if (maxUrls && enqueued >= maxUrls) return false;
+      }
+      safeOffset = offset;
+      return true;
+    };
+  };
+
+  const streamOptions = (u, extra = {}) => ({
+    onEntries: onEntries(u),
+    lastmodSince: opts?.lastmodSince,
+    maxEntryBytes: opts?.maxEntryBytes,
+    ...extra
+  });
+
+  const finish = (u, result) => {
+    if (typeof opts?.onSitemapDone !== 'function') return result;
+    try {
+      opts.onSitemapDone({ sitemapUrl: u, complete: result.complete, bytes: result.bytes, offset: result.offset, stats: result.stats });
+    } catch { /* progress reporting is best-effort */ }
+    return result;
+  };
+
+  const readBody = async (u, body) => finish(u, await readSitemapStream([Buffer.from(body, 'utf8')], streamOptions(u, {
+    resumeOffset: resumeOffsetOf(u)
+  })));
+
+  const processSitemap = async (u) => {
     const requestStartedIso = new Date().toISOString();
     try {
       let cached = null;
@@ -89,12 +188,20 @@ async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
       // network round-trip (no synthetic ledger row — no request happened).
       if (cached && cacheTtlSeconds > 0 && cached.fetchedAt
         && (Date.now() - Date.parse(cached.fetchedAt)) < cacheTtlSeconds * 1000) {
-        return cached.body;
+        await readBody(u, cached.body);
+        return;
       }
 
+      const resumeOffset = resumeOffsetOf(u);
       const headers = { 'User-Agent': 'Mozilla/5.0 (compatible; NewsBot/1.0)' };
-      if (cached?.etag) headers['If-None-Match'] = cached.etag;
-      if (cached?.lastModified) headers['If-Modified-Since'] = cached.lastModified;
+      if (resumeOffset > 0 && !/\.gz(\?|$)/i.test(u)) {
+        // Plain XML can resume server-side; gzip offsets are in decoded
+        // bytes, so those re-download and skip.
+        headers.Range = `bytes=${resumeOffset}-`;
+      } else {
+        if (cached?.etag) headers['If-None-Match'] = cached.etag;
+        if (cached?.lastModified) headers['If-Modified-Since'] = cached.lastModified;
+      }
 
       const res = await timeoutFetch(u, { headers }, opts?.fetchImpl);
 
@@ -107,15 +214,26 @@ async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
         emitFetch(u, res, 0, requestStartedIso, {
           etag: cached.etag, lastModified: cached.lastModified, contentType: cached.contentType
         });
-        return cached.body;
+        await readBody(u, cached.body);
+        return;
+      }
+
+      if (!res.ok) {
+        emitFetch(u, res, 0, requestStartedIso);
+        return;
       }
 
-      const text = res.ok ? await res.text() : null;
-      if (text && cache) {
+      const ranged = res.status === 206 && resumeOffset > 0;
+      const result = finish(u, await readSitemapStream(responseChunks(res), streamOptions(u, {
+        baseOffset: ranged ? resumeOffset : 0,
+        resumeOffset: ranged ? 0 : resumeOffset,
+        retainBodyBytes: cache ? cacheMaxBodyBytes : 0
+      })));
+      if (result.body && cache) {
         try {
           await cache.set(u, {
             url: u,
-            body: text,
+            body: result.body,
             etag: res.headers?.get?.('etag') || null,
             lastModified: res.headers?.get?.('last-modified') || null,
             contentType: res.headers?.get?.('content-type') || null,
@@ -123,68 +241,8 @@ async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
           });
         } catch { /* best-effort */ }
       }
-      emitFetch(u, res, text ? Buffer.byteLength(text, 'utf8') : 0, requestStartedIso);
-      return text;
-    } catch { return null; }
-  };
-
-  const pushUrl = (u, meta = {}) => {
-    if (maxUrls && enqueued >= maxUrls) return;
-    try {
-      const abs = new URL(u, baseUrl).href;
-      if (new URL(abs).hostname !== domain) return;
-      if (seen.has(abs)) return;
-      seen.add(abs);
-      if (typeof opts?.push === 'function') {
-        opts.push(abs, meta);
-      }
-      enqueued++;
-    } catch {}
-  };
-
-  const handleDoc = (doc) => {
-    if (!doc) return;
-
-    // Regex fallback result
-    if (doc.__locs) {
-      for (const u of doc.__locs) pushUrl(u);
-      return;
-    }
-
-    // Handle <urlset> (standard sitemap)
-    if (doc.urlset && doc.urlset.url) {
-      const arr = Array.isArray(doc.urlset.url) ? doc.urlset.url : [doc.urlset.url];
-      for (const e of arr) {
-        const loc = e.loc || e['#text'] || null;
-        if (loc) {
-          const meta = {};
-          if (e.lastmod) meta.lastmod = e.lastmod;
-          if (e.changefreq) meta.changefreq = e.changefreq;
-          if (e.priority) meta.priority = e.priority;
-          // Handle news extension
-          if (e['news:news']) {
-             meta.isNews = true;
-             if (e['news:news']['news:publication_date']) {
-               meta.publicationDate = e['news:news']['news:publication_date'];
-             }
-             if (e['news:news']['news:title']) {
-               meta.title = e['news:news']['news:title'];
-             }
-          }
-          pushUrl(String(loc), meta);
-        }
-      }
-      return;
-    }
-
-    // Handle <sitemapindex> (nested sitemaps)
-    if (doc.sitemapindex && doc.sitemapindex.sitemap) {
-      const arr = Array.isArray(doc.sitemapindex.sitemap) ? doc.sitemapindex.sitemap : [doc.sitemapindex.sitemap];
-      for (const e of arr) {
-        const loc = e.loc || e['#text'] || null;
-        if (loc) list.push(String(loc));
-      }
-    }
+      emitFetch(u, res, result.bytes, requestStartedIso);
+    } catch { /* a broken sitemap must not stop the others */ }
   };
 
   for (let i = 0; i < list.length; i++) {
@@ -194,13 +252,7 @@ async function loadSitemaps(baseUrl, domain, sitemapUrls, opts) {
       if (new URL(u, baseUrl).hostname !== domain) continue;
     } catch { continue; }
 
-    const xml = await fetchText(u);
-    if (!xml) continue;
-
-    try {
-      const doc = await parseXmlMaybe(xml);
-      handleDoc(doc);
-    } catch {}
+    await processSitemap(u);
 
     if (maxUrls && enqueued >= maxUrls) break;
   }
@@ -8,6 +8,9 @@
  * 
  * - Normalizes events to the standard schema
  * - Batches high-frequency events to prevent flooding
+ * - Records per-URL outcomes in a preallocated ring buffer and broadcasts
+ *   periodic rate/latency summaries instead of raw URL events
+ * - Samples raw events per type (sampleRates)
  * - Maintains event history for late-joining clients
  * - Provides a consistent interface regardless of broadcast implementation
  * 
@@ -33,10 +36,13 @@ const {
   createGoalSatisfiedEvent,
   createBudgetEvent,
   createWorkerScaledEvent,
+  createAnalysisWorkersEvent,
   createUrlVisitedEvent,
   createUrlErrorEvent,
+  createUrlSummaryEvent,
   isValidTelemetryEvent
 } = require('./CrawlTelemetrySchema');
+const { TelemetryRingBuffer, RECORD_KINDS } = require('./TelemetryRingBuffer');
 
 const { observable } = require('fnl');
 
@@ -56,8 +62,24 @@ const DEFAULT_OPTIONS = {
   // Maximum URL events to batch before flush
   urlEventBatchSize: 50,
   
+  // Analysis worker pool snapshot interval (ms)
+  analysisStatsInterval: 1000,
+  
   // Whether to include URL-level events in broadcast (can be noisy)
   broadcastUrlEvents: false,
+
+  // Per-URL records kept in the telemetry ring buffer
+  urlTelemetryCapacity: 4096,
+
+  // URL summary broadcast interval (ms); 0 disables summary events
+  urlSummaryInterval: 1000,
+
+  // Window covered by each URL summary (ms)
+  urlSummaryWindow: 10000,
+
+  // Fraction of raw events kept per event type, e.g. { 'crawl:url:visited': 0.05 }.
+  // Types not listed are kept. Ring-buffer counters always see every URL.
+  sampleRates: null,
   
   // Default job ID if not specified
   defaultJobId: null,
@@ -75,7 +97,12 @@ class CrawlTelemetryBridge {
    * @param {number} [options.progressBatchInterval=500] - Progress batch interval in ms
    * @param {number} [options.urlEventBatchInterval=200] - URL event batch interval in ms
    * @param {number} [options.urlEventBatchSize=50] - Max URL events per batch
+   * @param {number} [options.analysisStatsInterval=1000] - Analysis pool snapshot interval in ms
    * @param {boolean} [options.broadcastUrlEvents=false] - Include URL-level events
+   * @param {number} [options.urlTelemetryCapacity=4096] - Ring buffer size for per-URL records
+   * @param {number} [options.urlSummaryInterval=1000] - URL summary broadcast interval in ms (0 disables)
+   * @param {number} [options.urlSummaryWindow=10000] - Window covered by each URL summary in ms
+   * @param {Object<string, number>} [options.sampleRates] - Fraction (0-1) of raw events kept per event type
    * @param {string} [options.defaultJobId] - Default job ID
    * @param {string} [options.defaultCrawlType='standard'] - Default crawl type
    */
@@ -96,13 +123,31 @@ class CrawlTelemetryBridge {
     this._progressBatchInterval = opts.progressBatchInterval;
     this._urlEventBatchInterval = opts.urlEventBatchInterval;
     this._urlEventBatchSize = opts.urlEventBatchSize;
+    this._analysisStatsInterval = opts.analysisStatsInterval;
     this._broadcastUrlEvents = opts.broadcastUrlEvents;
+    this._urlSummaryInterval = opts.urlSummaryInterval;
+    this._urlSummaryWindow = opts.urlSummaryWindow;
     this._defaultJobId = opts.defaultJobId;
     this._defaultCrawlType = opts.defaultCrawlType;
     
     // Event history for late-joining clients
     this._history = [];
 
+    // Compact per-URL records and counters; summaries are built from these
+    this._urlTelemetry = new TelemetryRingBuffer({ capacity: opts.urlTelemetryCapacity });
+    this._urlSummaryTimer = null;
+    this._urlSummaryWritten = 0;
+    this._latestUrlSummary = null;
+
+    // Per-type sampling: a credit accumulator keeps exactly `rate` of events
+    // without Math.random, and dropped counts are reported in summaries.
+    this._sampleRates = new Map();
+    this._sampleCredit = new Map();
+    this._sampleDropped = new Map();
+    for (const [type, rate] of Object.entries(opts.sampleRates || {})) {
+      this.setSampleRate(type, rate);
+    }
+
     // In-process observable stream of telemetry events.
     // This allows the crawler to expose telemetry as an observable while
     // keeping transport (SSE/stdout/etc) separate.
@@ -116,6 +161,7 @@ class CrawlTelemetryBridge {
       progress: null,
       budget: null,
       workers: null,
+      analysisWorkers: null,
       startedAt: null,
       lastUpdatedAt: null
     };
@@ -125,6 +171,7 @@ class CrawlTelemetryBridge {
     this._progressTimer = null;
     this._pendingUrlEvents = [];
     this._urlEventTimer = null;
+    this._analysisStatsTimer = null;
     
     // Connected crawlers (for cleanup)
     this._connectedCrawlers = new Map();
@@ -282,7 +329,48 @@ class CrawlTelemetryBridge {
    * @returns {Object} Current state snapshot
    */
   getState() {
-    return { ...this._currentState };
+    return { ...this._currentState, urlSummary: this._latestUrlSummary };
+  }
+
+  /**
+   * Set the fraction of raw events of one type that are kept.
+   * @param {string} type - Event type (e.g. CRAWL_EVENT_TYPES.URL_VISITED)
+   * @param {number} rate - 0 drops all, 1 keeps all
+   */
+  setSampleRate(type, rate) {
+    const numeric = Number(rate);
+    if (!Number.isFinite(numeric)) {
+      throw new Error(`Sample rate for ${type} must be a number between 0 and 1`);
+    }
+    const clamped = Math.min(1, Math.max(0, numeric));
+    if (clamped === 1) {
+      this._sampleRates.delete(type);
+    } else {
+      this._sampleRates.set(type, clamped);
+    }
+    this._sampleCredit.set(type, 0);
+  }
+
+  /**
+   * Rates, latency and status mix for recent URLs, computed from the ring
+   * buffer. Cheap enough to call per request.
+   * @param {Object} [options]
+   * @param {number} [options.windowMs] - Defaults to urlSummaryWindow
+   * @returns {Object}
+   */
+  getUrlSummary(options = {}) {
+    const summary = this._urlTelemetry.summary({ windowMs: options.windowMs || this._urlSummaryWindow });
+    summary.sampling = this._samplingStats();
+    return summary;
+  }
+
+  /**
+   * Most recent per-URL records (compact form), oldest first.
+   * @param {number} [limit]
+   * @returns {Array<Object>}
+   */
+  getUrlRecords(limit) {
+    return this._urlTelemetry.toArray(limit);
   }
 
   /**
@@ -370,6 +458,11 @@ class CrawlTelemetryBridge {
     // Store for cleanup
     const crawlerId = Symbol('crawler');
     this._connectedCrawlers.set(crawlerId, { crawler, handlers });
+
+    // NewsCrawler exposes its analysis worker pool directly
+    const disconnectPool = crawler.analysisPool && typeof crawler.analysisPool.on === 'function'
+      ? this.connectAnalysisPool(crawler.analysisPool, eventOpts)
+      : null;
     
     // Return disconnect function
     return () => {
@@ -380,6 +473,62 @@ class CrawlTelemetryBridge {
         }
         this._connectedCrawlers.delete(crawlerId);
       }
+      if (disconnectPool) disconnectPool();
+    };
+  }
+
+  /**
+   * Connect an AnalysisWorkerPool. Task and worker lifecycle events are
+   * coalesced into at most one pool snapshot per analysisStatsInterval so a
+   * busy pool does not flood the broadcast channel.
+   * 
+   * @param {EventEmitter} pool - AnalysisWorkerPool instance
+   * @param {Object} [options] - Event options (jobId, crawlType)
+   * @returns {Function} Disconnect function
+   */
+  connectAnalysisPool(pool, options = {}) {
+    if (!pool || typeof pool.on !== 'function' || typeof pool.getStats !== 'function') {
+      throw new Error('connectAnalysisPool requires an AnalysisWorkerPool');
+    }
+
+    const schedule = () => {
+      if (this._analysisStatsTimer) return;
+      this._analysisStatsTimer = setTimeout(() => {
+        this._analysisStatsTimer = null;
+        try {
+          this.emitAnalysisWorkers(pool.getStats(), options);
+        } catch (_) {
+          // Pool may be shutting down; skip this snapshot
+        }
+      }, this._analysisStatsInterval);
+
+      try {
+        this._analysisStatsTimer.unref?.();
+      } catch (_) {
+        // ignore
+      }
+    };
+
+    const handlers = new Map([
+      ['task-completed', schedule],
+      ['task-failed', schedule],
+      ['worker-exit', schedule]
+    ]);
+    for (const [event, handler] of handlers) {
+      pool.on(event, handler);
+    }
+
+    const poolId = Symbol('analysisPool');
+    this._connectedCrawlers.set(poolId, { crawler: pool, handlers });
+
+    return () => {
+      const connection = this._connectedCrawlers.get(poolId);
+      if (connection) {
+        for (const [event, handler] of connection.handlers) {
+          connection.crawler.off(event, handler);
+        }
+        this._connectedCrawlers.delete(poolId);
+      }
     };
   }
 
@@ -609,7 +758,9 @@ class CrawlTelemetryBridge {
    * Emit a URL visited event (batched, optional broadcast).
    */
   emitUrlVisited(urlInfo, options = {}) {
-    if (!this._broadcastUrlEvents) return;
+    if (!urlInfo) return;
+    this._recordUrl(RECORD_KINDS.VISITED, urlInfo);
+    if (!this._broadcastUrlEvents || !this._sampled(CRAWL_EVENT_TYPES.URL_VISITED)) return;
     
     const event = createUrlVisitedEvent(urlInfo, {
       jobId: options.jobId || this._currentState.jobId,
@@ -623,12 +774,16 @@ class CrawlTelemetryBridge {
    * Emit a URL error event.
    */
   emitUrlError(errorInfo, options = {}) {
+    if (!errorInfo) return;
+    this._recordUrl(RECORD_KINDS.ERROR, errorInfo);
+    if (!this._sampled(CRAWL_EVENT_TYPES.URL_ERROR)) return;
+
     const event = createUrlErrorEvent(errorInfo, {
       jobId: options.jobId || this._currentState.jobId,
       crawlType: options.crawlType || this._currentState.crawlType
     });
     
-    // Errors are always broadcast immediately
+    // Sampled-in errors are broadcast immediately
     this._recordAndBroadcast(event);
   }
 
@@ -696,12 +851,110 @@ class CrawlTelemetryBridge {
     this._recordAndBroadcast(event);
   }
 
+  /**
+   * Emit an analysis worker pool snapshot (per-thread utilisation).
+   */
+  emitAnalysisWorkers(stats, options = {}) {
+    if (!stats) return;
+    this._currentState.analysisWorkers = {
+      poolSize: stats.poolSize ?? null,
+      pending: stats.pending ?? 0,
+      completed: stats.completed ?? 0,
+      failed: stats.failed ?? 0
+    };
+    this._currentState.lastUpdatedAt = Date.now();
+
+    const event = createAnalysisWorkersEvent(stats, {
+      jobId: options.jobId || this._currentState.jobId,
+      crawlType: options.crawlType || this._currentState.crawlType
+    });
+
+    this._recordAndBroadcast(event);
+  }
+
   /**
    * Flush all pending batched events.
    */
   _flushBatches() {
     this._flushProgress();
     this._flushUrlEvents();
+    this._flushUrlSummary();
+  }
+
+  /**
+   * Write one URL outcome to the ring buffer and schedule a summary.
+   */
+  _recordUrl(kind, info) {
+    this._urlTelemetry.record(kind, {
+      url: info.url,
+      httpStatus: info.httpStatus,
+      durationMs: info.durationMs,
+      bytes: info.contentLength ?? info.bytesDownloaded,
+      cached: info.cached,
+      retryable: info.retryable
+    });
+
+    if (this._urlSummaryInterval > 0 && !this._urlSummaryTimer) {
+      this._urlSummaryTimer = setTimeout(() => {
+        this._urlSummaryTimer = null;
+        this._flushUrlSummary();
+      }, this._urlSummaryInterval);
+
+      try {
+        this._urlSummaryTimer.unref?.();
+      } catch (_) {
+        // ignore
+      }
+    }
+  }
+
+  /**
+   * Broadcast a URL summary if records arrived since the last one.
+   * Summaries skip history: the latest one is exposed through getState().
+   */
+  _flushUrlSummary() {
+    if (this._urlSummaryTimer) {
+      clearTimeout(this._urlSummaryTimer);
+      this._urlSummaryTimer = null;
+    }
+    if (this._urlSummaryInterval <= 0 || this._urlTelemetry.written === this._urlSummaryWritten) return;
+    this._urlSummaryWritten = this._urlTelemetry.written;
+
+    const event = createUrlSummaryEvent(this.getUrlSummary(), {
+      jobId: this._currentState.jobId,
+      crawlType: this._currentState.crawlType
+    });
+    this._latestUrlSummary = event.data;
+    this._recordAndBroadcast(event, { history: false });
+  }
+
+  /**
+   * Decide whether to keep one raw event of this type.
+   */
+  _sampled(type) {
+    const rate = this._sampleRates.get(type);
+    if (rate === undefined) return true;
+    const credit = (this._sampleCredit.get(type) || 0) + rate;
+    // Epsilon absorbs float drift (ten additions of 0.1 fall just short of 1)
+    if (credit >= 1 - 1e-9) {
+      this._sampleCredit.set(type, credit - 1);
+      return true;
+    }
+    this._sampleCredit.set(type, credit);
+    this._sampleDropped.set(type, (this._sampleDropped.get(type) || 0) + 1);
+    return false;
+  }
+
+  _samplingStats() {
+    if (this._sampleRates.size === 0 && this._sampleDropped.size === 0) return null;
+    const stats = {};
+    for (const [type, rate] of this._sampleRates) {
+      stats[type] = { rate, dropped: this._sampleDropped.get(type) || 0 };
+    }
+    for (const [type, dropped] of this._sampleDropped) {
+      if (!stats[type]) stats[type] = { rate: 1, dropped };
+    }
+    return stats;
   }
 
   /**
@@ -771,14 +1024,19 @@ class CrawlTelemetryBridge {
 
   /**
    * Record event to history and broadcast.
+   * @param {Object} event
+   * @param {Object} [options]
+   * @param {boolean} [options.history=true] - Append to history
    */
-  _recordAndBroadcast(event) {
+  _recordAndBroadcast(event, options = {}) {
     if (!isValidTelemetryEvent(event)) return;
     
     // Add to history
-    this._history.push(event);
-    if (this._history.length > this._historyLimit) {
-      this._history.shift();
+    if (options.history !== false) {
+      this._history.push(event);
+      if (this._history.length > this._historyLimit) {
+        this._history.shift();
+      }
     }
 
     // Notify in-process subscribers.
@@ -807,6 +1065,7 @@ class CrawlTelemetryBridge {
   destroy() {
     // Flush any pending URL events before cleanup (critical for small/fast crawls)
     this._flushUrlEvents();
+    this._flushUrlSummary();
     
     // Complete observable stream first so subscribers can detach.
     try {
@@ -832,9 +1091,17 @@ class CrawlTelemetryBridge {
       clearTimeout(this._urlEventTimer);
       this._urlEventTimer = null;
     }
+    if (this._analysisStatsTimer) {
+      clearTimeout(this._analysisStatsTimer);
+      this._analysisStatsTimer = null;
+    }
     
     // Reset state
     this._history = [];
+    this._urlTelemetry.reset();
+    this._urlSummaryWritten = 0;
+    this._latestUrlSummary = null;
+    this._sampleDropped.clear();
     this._pendingProgress = null;
     this._pendingUrlEvents = [];
     this._currentState = {
@@ -844,6 +1111,7 @@ class CrawlTelemetryBridge {
       progress: null,
       budget: null,
       workers: null,
+      analysisWorkers: null,
       startedAt: null,
       lastUpdatedAt: null
     };
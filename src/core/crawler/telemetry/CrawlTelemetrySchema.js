@@ -56,6 +56,7 @@ const CRAWL_EVENT_TYPES = Object.freeze({
   URL_QUEUED: 'crawl:url:queued',
   URL_ERROR: 'crawl:url:error',
   URL_SKIPPED: 'crawl:url:skipped',
+  URL_SUMMARY: 'crawl:url:summary',
 
   // Goal/budget events
   GOAL_SATISFIED: 'crawl:goal:satisfied',
@@ -67,6 +68,7 @@ const CRAWL_EVENT_TYPES = Object.freeze({
   WORKER_SPAWNED: 'crawl:worker:spawned',
   WORKER_STOPPED: 'crawl:worker:stopped',
   WORKER_SCALED: 'crawl:worker:scaled',
+  ANALYSIS_WORKERS: 'crawl:worker:analysis',
 
   // Standardized nested progress (tree)
   // Use these when progress is naturally hierarchical (e.g. countries → cities).
@@ -367,6 +369,40 @@ function createWorkerScaledEvent(scaling, options = {}) {
   });
 }
 
+/**
+ * Create an analysis worker pool snapshot event.
+ * 
+ * @param {Object} stats - AnalysisWorkerPool.getStats() output
+ * @param {Object} [options] - Event options
+ * @returns {Object} Analysis workers event payload
+ */
+function createAnalysisWorkersEvent(stats, options = {}) {
+  const workers = Array.isArray(stats.workers) ? stats.workers : [];
+  const busy = workers.filter((w) => w.busy).length;
+  return createTelemetryEvent(CRAWL_EVENT_TYPES.ANALYSIS_WORKERS, {
+    poolSize: stats.poolSize ?? workers.length,
+    busy,
+    pending: stats.pending ?? 0,
+    maxPending: stats.maxPending ?? null,
+    completed: stats.completed ?? 0,
+    failed: stats.failed ?? 0,
+    backpressureWaits: stats.backpressureWaits ?? 0,
+    workers: workers.map((w) => ({
+      workerId: w.workerId,
+      threadId: w.threadId ?? null,
+      busy: !!w.busy,
+      tasksCompleted: w.tasksCompleted ?? 0,
+      tasksFailed: w.tasksFailed ?? 0,
+      avgTaskMs: w.avgTaskMs ?? null,
+      lastTaskMs: w.lastTaskMs ?? null
+    }))
+  }, {
+    ...options,
+    severity: SEVERITY_LEVELS.DEBUG,
+    message: `Analysis workers: ${busy}/${stats.poolSize ?? workers.length} busy, ${stats.pending ?? 0} pending`
+  });
+}
+
 /**
  * Create a URL visited event.
  * 
@@ -416,6 +452,29 @@ function createUrlErrorEvent(errorInfo, options = {}) {
   });
 }
 
+/**
+ * Create a URL telemetry summary event (rates, latency, status mix).
+ * Stands in for raw per-URL events on the broadcast channel.
+ * 
+ * @param {Object} summary - TelemetryRingBuffer.summary() output
+ * @param {Object} [options] - Event options
+ * @returns {Object} URL summary event payload
+ */
+function createUrlSummaryEvent(summary, options = {}) {
+  const window = summary.window || {};
+  return createTelemetryEvent(CRAWL_EVENT_TYPES.URL_SUMMARY, {
+    windowMs: summary.windowMs ?? null,
+    window,
+    totals: summary.totals || null,
+    sampling: summary.sampling || null,
+    buffer: summary.buffer || null
+  }, {
+    ...options,
+    severity: SEVERITY_LEVELS.DEBUG,
+    message: `URLs: ${window.visitedPerSec ?? 0}/s, errors ${window.errorsPerSec ?? 0}/s, p95 ${window.latencyMs?.p95 ?? '-'}ms`
+  });
+}
+
 /**
  * Format a phase name for display.
  * @param {string} phase - Phase constant
@@ -452,8 +511,10 @@ module.exports = {
   createBudgetEvent,
   createProgressTreeEvent,
   createWorkerScaledEvent,
+  createAnalysisWorkersEvent,
   createUrlVisitedEvent,
   createUrlErrorEvent,
+  createUrlSummaryEvent,
   
   // Utilities
   formatPhaseName,
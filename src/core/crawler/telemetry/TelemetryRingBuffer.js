@@ -0,0 +1,376 @@
+'use strict';
+
+/**
+ * TelemetryRingBuffer - Fixed-size columnar store for per-URL telemetry.
+ *
+ * Each URL outcome is one record: timestamp, kind, HTTP status, duration,
+ * bytes, host id and flags. Records are written into preallocated typed-array
+ * columns, so recording one allocates nothing. The oldest record is
+ * overwritten once the buffer is full. Hosts are interned to small integer ids.
+ *
+ * Running totals (per kind, per status class, bytes, latency) and one-second
+ * rate slots are updated as records arrive. summary() then reads those
+ * counters plus a scan of the window, instead of walking event objects.
+ *
+ * Usage:
+ *   const ring = new TelemetryRingBuffer({ capacity: 4096 });
+ *   ring.record(RECORD_KINDS.VISITED, { host: 'example.com', httpStatus: 200, durationMs: 120, bytes: 5120 });
+ *   ring.summary({ windowMs: 10000 });
+ *
+ * @module src/crawler/telemetry/TelemetryRingBuffer
+ */
+
+const RECORD_KINDS = Object.freeze({
+  VISITED: 1,
+  ERROR: 2,
+  SKIPPED: 3
+});
+
+const KIND_NAMES = ['unknown', 'visited', 'error', 'skipped'];
+
+const RECORD_FLAGS = Object.freeze({
+  CACHED: 1,
+  RETRYABLE: 2
+});
+
+// Host ids are Uint16; hosts beyond this share OTHER_HOST_ID
+const MAX_HOSTS = 65535;
+const OTHER_HOST_ID = 0;
+
+// One-second rate slots kept for rate()
+const RATE_SLOTS = 120;
+
+/**
+ * Hostname of an absolute URL without constructing a URL object.
+ * @param {string} url
+ * @returns {string|null}
+ */
+function hostOf(url) {
+  if (typeof url !== 'string') return null;
+  const schemeEnd = url.indexOf('//');
+  if (schemeEnd === -1) return null;
+  const start = schemeEnd + 2;
+  let end = start;
+  while (end < url.length) {
+    const ch = url.charCodeAt(end);
+    // '/', '?', '#', ':'
+    if (ch === 47 || ch === 63 || ch === 35 || ch === 58) break;
+    end++;
+  }
+  const at = url.lastIndexOf('@', end);
+  const host = url.slice(at >= start ? at + 1 : start, end);
+  return host ? host.toLowerCase() : null;
+}
+
+class TelemetryRingBuffer {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.capacity=4096] - Records kept
+   * @param {Function} [options.now=Date.now] - Clock (ms)
+   */
+  constructor(options = {}) {
+    const capacity = Math.max(16, Math.trunc(options.capacity || 4096));
+    this.capacity = capacity;
+    this._now = typeof options.now === 'function' ? options.now : Date.now;
+
+    this._timestamps = new Float64Array(capacity);
+    this._durations = new Float32Array(capacity);
+    this._bytes = new Float64Array(capacity);
+    this._statuses = new Uint16Array(capacity);
+    this._hostIds = new Uint16Array(capacity);
+    this._kinds = new Uint8Array(capacity);
+    this._flags = new Uint8Array(capacity);
+
+    this._hostIdsByName = new Map();
+    this._hostNames = ['(other)'];
+
+    this._rateSlotSecond = new Float64Array(RATE_SLOTS);
+    this._rateVisited = new Uint32Array(RATE_SLOTS);
+    this._rateErrors = new Uint32Array(RATE_SLOTS);
+    this._rateBytes = new Float64Array(RATE_SLOTS);
+
+    this.reset();
+  }
+
+  /**
+   * Clear records and counters. Interned hosts are kept.
+   */
+  reset() {
+    this._next = 0;
+    this._size = 0;
+    this._written = 0;
+    this._kinds.fill(0);
+    this._rateSlotSecond.fill(-1);
+    this._totals = {
+      visited: 0,
+      errors: 0,
+      skipped: 0,
+      cached: 0,
+      bytes: 0,
+      status: { '1xx': 0, '2xx': 0, '3xx': 0, '4xx': 0, '5xx': 0, none: 0 },
+      latencyCount: 0,
+      latencySumMs: 0,
+      latencyMaxMs: 0
+    };
+  }
+
+  /**
+   * Records written since the last reset (including overwritten ones).
+   * @returns {number}
+   */
+  get written() {
+    return this._written;
+  }
+
+  /**
+   * Records currently held.
+   * @returns {number}
+   */
+  get size() {
+    return this._size;
+  }
+
+  /**
+   * Append one record.
+   *
+   * @param {number} kind - RECORD_KINDS value
+   * @param {Object} fields
+   * @param {string} [fields.host] - Hostname (or pass fields.url)
+   * @param {string} [fields.url] - Used for the host when fields.host is absent
+   * @param {number} [fields.httpStatus]
+   * @param {number} [fields.durationMs]
+   * @param {number} [fields.bytes]
+   * @param {boolean} [fields.cached]
+   * @param {boolean} [fields.retryable]
+   * @param {number} [fields.timestamp] - Defaults to now
+   */
+  record(kind, fields = {}) {
+    const index = this._next;
+    const timestamp = Number.isFinite(fields.timestamp) ? fields.timestamp : this._now();
+    const status = Number.isFinite(fields.httpStatus) ? fields.httpStatus : 0;
+    const duration = Number.isFinite(fields.durationMs) && fields.durationMs >= 0 ? fields.durationMs : -1;
+    const bytes = Number.isFinite(fields.bytes) && fields.bytes > 0 ? fields.bytes : 0;
+    const flags = (fields.cached ? RECORD_FLAGS.CACHED : 0) | (fields.retryable ? RECORD_FLAGS.RETRYABLE : 0);
+
+    this._timestamps[index] = timestamp;
+    this._kinds[index] = kind;
+    this._statuses[index] = status;
+    this._durations[index] = duration;
+    this._bytes[index] = bytes;
+    this._hostIds[index] = this._internHost(fields.host ?? hostOf(fields.url));
+    this._flags[index] = flags;
+
+    this._next = index + 1 === this.capacity ? 0 : index + 1;
+    if (this._size < this.capacity) this._size++;
+    this._written++;
+
+    this._count(kind, timestamp, status, duration, bytes, flags);
+  }
+
+  /**
+   * Pre-aggregated counters since the last reset.
+   * @returns {Object}
+   */
+  getTotals() {
+    const t = this._totals;
+    return {
+      visited: t.visited,
+      errors: t.errors,
+      skipped: t.skipped,
+      cached: t.cached,
+      bytes: t.bytes,
+      status: { ...t.status },
+      latency: {
+        count: t.latencyCount,
+        avgMs: t.latencyCount > 0 ? round(t.latencySumMs / t.latencyCount) : null,
+        maxMs: t.latencyCount > 0 ? round(t.latencyMaxMs) : null
+      }
+    };
+  }
+
+  /**
+   * Per-second rates over the last `windowSeconds` from the rate slots.
+   * @param {number} [windowSeconds=10]
+   * @returns {{visitedPerSec: number, errorsPerSec: number, bytesPerSec: number}}
+   */
+  rate(windowSeconds = 10) {
+    const seconds = Math.max(1, Math.min(RATE_SLOTS - 1, Math.trunc(windowSeconds)));
+    const nowSecond = Math.floor(this._now() / 1000);
+    let visited = 0;
+    let errors = 0;
+    let bytes = 0;
+    // The current second is still filling; use the completed ones
+    for (let s = nowSecond - seconds; s < nowSecond; s++) {
+      const slot = s % RATE_SLOTS;
+      if (this._rateSlotSecond[slot] !== s) continue;
+      visited += this._rateVisited[slot];
+      errors += this._rateErrors[slot];
+      bytes += this._rateBytes[slot];
+    }
+    return {
+      visitedPerSec: round(visited / seconds),
+      errorsPerSec: round(errors / seconds),
+      bytesPerSec: round(bytes / seconds)
+    };
+  }
+
+  /**
+   * Rates, latency percentiles, status mix and top hosts for recent records.
+   *
+   * @param {Object} [options]
+   * @param {number} [options.windowMs=10000]
+   * @param {number} [options.topHosts=5]
+   * @returns {Object}
+   */
+  summary(options = {}) {
+    const windowMs = Math.max(1000, options.windowMs || 10000);
+    const topHostCount = Math.max(0, options.topHosts ?? 5);
+    const since = this._now() - windowMs;
+
+    const durations = new Float32Array(this._size);
+    let durationCount = 0;
+    const hostCounts = new Map();
+    const window = { visited: 0, errors: 0, skipped: 0, cached: 0, bytes: 0 };
+
+    this._forEachSince(since, (index) => {
+      const kind = this._kinds[index];
+      if (kind === RECORD_KINDS.VISITED) window.visited++;
+      else if (kind === RECORD_KINDS.ERROR) window.errors++;
+      else if (kind === RECORD_KINDS.SKIPPED) window.skipped++;
+      if (this._flags[index] & RECORD_FLAGS.CACHED) window.cached++;
+      window.bytes += this._bytes[index];
+      if (this._durations[index] >= 0) durations[durationCount++] = this._durations[index];
+      const hostId = this._hostIds[index];
+      hostCounts.set(hostId, (hostCounts.get(hostId) || 0) + 1);
+    });
+
+    const sorted = durations.subarray(0, durationCount).sort();
+    const seconds = windowMs / 1000;
+    const topHosts = Array.from(hostCounts, ([hostId, count]) => ({ host: this._hostNames[hostId], count }))
+      .sort((a, b) => b.count - a.count || (a.host < b.host ? -1 : 1))
+      .slice(0, topHostCount);
+
+    return {
+      windowMs,
+      window: {
+        ...window,
+        visitedPerSec: round(window.visited / seconds),
+        errorsPerSec: round(window.errors / seconds),
+        bytesPerSec: round(window.bytes / seconds),
+        latencyMs: {
+          count: durationCount,
+          p50: percentile(sorted, 0.5),
+          p95: percentile(sorted, 0.95),
+          p99: percentile(sorted, 0.99),
+          max: durationCount > 0 ? round(sorted[durationCount - 1]) : null
+        },
+        topHosts
+      },
+      totals: this.getTotals(),
+      buffer: { capacity: this.capacity, size: this._size, written: this._written }
+    };
+  }
+
+  /**
+   * Decode the most recent records (oldest first).
+   * @param {number} [limit] - Defaults to every record held
+   * @returns {Array<Object>}
+   */
+  toArray(limit) {
+    const count = Math.min(this._size, limit ?? this._size);
+    const out = new Array(count);
+    let index = (this._next - count + this.capacity) % this.capacity;
+    for (let i = 0; i < count; i++) {
+      out[i] = this._decode(index);
+      index = index + 1 === this.capacity ? 0 : index + 1;
+    }
+    return out;
+  }
+
+  // --- Private ---
+
+  _internHost(host) {
+    if (!host) return OTHER_HOST_ID;
+    let id = this._hostIdsByName.get(host);
+    if (id === undefined) {
+      if (this._hostNames.length > MAX_HOSTS) return OTHER_HOST_ID;
+      id = this._hostNames.length;
+      this._hostNames.push(host);
+      this._hostIdsByName.set(host, id);
+    }
+    return id;
+  }
+
+  _count(kind, timestamp, status, duration, bytes, flags) {
+    const t = this._totals;
+    if (kind === RECORD_KINDS.VISITED) t.visited++;
+    else if (kind === RECORD_KINDS.ERROR) t.errors++;
+    else if (kind === RECORD_KINDS.SKIPPED) t.skipped++;
+    if (flags & RECORD_FLAGS.CACHED) t.cached++;
+    t.bytes += bytes;
+    const statusClass = status >= 100 && status < 600 ? `${Math.floor(status / 100)}xx` : 'none';
+    t.status[statusClass]++;
+    if (duration >= 0) {
+      t.latencyCount++;
+      t.latencySumMs += duration;
+      if (duration > t.latencyMaxMs) t.latencyMaxMs = duration;
+    }
+
+    const second = Math.floor(timestamp / 1000);
+    const slot = ((second % RATE_SLOTS) + RATE_SLOTS) % RATE_SLOTS;
+    if (this._rateSlotSecond[slot] !== second) {
+      this._rateSlotSecond[slot] = second;
+      this._rateVisited[slot] = 0;
+      this._rateErrors[slot] = 0;
+      this._rateBytes[slot] = 0;
+    }
+    if (kind === RECORD_KINDS.VISITED) this._rateVisited[slot]++;
+    else if (kind === RECORD_KINDS.ERROR) this._rateErrors[slot]++;
+    this._rateBytes[slot] += bytes;
+  }
+
+  /**
+   * Visit records newer than `since`, newest first, stopping at the first
+   * older one (records are appended in time order).
+   */
+  _forEachSince(since, visit) {
+    let index = this._next;
+    for (let i = 0; i < this._size; i++) {
+      index = index === 0 ? this.capacity - 1 : index - 1;
+      if (this._timestamps[index] < since) break;
+      visit(index);
+    }
+  }
+
+  _decode(index) {
+    const duration = this._durations[index];
+    const flags = this._flags[index];
+    return {
+      timestamp: this._timestamps[index],
+      kind: KIND_NAMES[this._kinds[index]] || 'unknown',
+      host: this._hostNames[this._hostIds[index]],
+      httpStatus: this._statuses[index] || null,
+      durationMs: duration >= 0 ? round(duration) : null,
+      bytes: this._bytes[index],
+      cached: (flags & RECORD_FLAGS.CACHED) !== 0,
+      retryable: (flags & RECORD_FLAGS.RETRYABLE) !== 0
+    };
+  }
+}
+
+function round(value) {
+  return Math.round(value * 100) / 100;
+}
+
+function percentile(sorted, q) {
+  if (sorted.length === 0) return null;
+  const rank = Math.min(sorted.length - 1, Math.ceil(q * sorted.length) - 1);
+  return round(sorted[Math.max(0, rank)]);
+}
+
+module.exports = {
+  TelemetryRingBuffer,
+  RECORD_KINDS,
+  RECORD_FLAGS,
+  hostOf
+};
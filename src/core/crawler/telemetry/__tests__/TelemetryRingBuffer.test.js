@@ -0,0 +1,117 @@
+'use strict';
+
+/**
+ * Per-URL telemetry goes into TelemetryRingBuffer; the bridge broadcasts
+ * summaries built from it and samples raw URL events per type.
+ */
+
+const { TelemetryRingBuffer, RECORD_KINDS, hostOf } = require('../TelemetryRingBuffer');
+const { CrawlTelemetryBridge } = require('../CrawlTelemetryBridge');
+const { CRAWL_EVENT_TYPES } = require('../CrawlTelemetrySchema');
+
+describe('TelemetryRingBuffer', () => {
+  it('overwrites the oldest records and keeps running totals for all of them', () => {
+    let now = 1_000_000;
+    const ring = new TelemetryRingBuffer({ capacity: 16, now: () => now });
+    for (let i = 0; i < 40; i++) {
+      now += 10;
+      ring.record(i % 10 === 0 ? RECORD_KINDS.ERROR : RECORD_KINDS.VISITED, {
+        url: `https://host${i % 3}.example/page/${i}`,
+        httpStatus: i % 10 === 0 ? 503 : 200,
+        durationMs: i,
+        bytes: 100
+      });
+    }
+
+    expect(ring.size).toBe(16);
+    expect(ring.written).toBe(40);
+    const records = ring.toArray();
+    expect(records).toHaveLength(16);
+    expect(records[0]).toMatchObject({ durationMs: 24, host: 'host0.example', kind: 'visited' });
+    expect(records[15]).toMatchObject({ durationMs: 39, httpStatus: 200 });
+
+    expect(ring.getTotals()).toMatchObject({
+      visited: 36,
+      errors: 4,
+      bytes: 4000,
+      status: { '2xx': 36, '5xx': 4 },
+      latency: { count: 40, maxMs: 39 }
+    });
+  });
+
+  it('summarises the recent window with rates, percentiles and top hosts', () => {
+    let now = 5_000_000;
+    const ring = new TelemetryRingBuffer({ capacity: 256, now: () => now });
+    ring.record(RECORD_KINDS.VISITED, { host: 'old.example', durationMs: 9999, timestamp: now - 60_000 });
+    for (let i = 1; i <= 100; i++) {
+      ring.record(RECORD_KINDS.VISITED, { host: i <= 70 ? 'a.example' : 'b.example', durationMs: i, bytes: 1000, timestamp: now - 10 * (100 - i) });
+    }
+
+    const { window, totals } = ring.summary({ windowMs: 10_000, topHosts: 1 });
+    expect(window.visited).toBe(100);
+    expect(window.visitedPerSec).toBe(10);
+    expect(window.latencyMs).toMatchObject({ count: 100, p50: 50, p95: 95, max: 100 });
+    expect(window.topHosts).toEqual([{ host: 'a.example', count: 70 }]);
+    expect(totals.visited).toBe(101);
+
+    now += 1000;
+    expect(ring.rate(10).visitedPerSec).toBe(10);
+  });
+
+  it('extracts hosts without building URL objects', () => {
+    expect(hostOf('https://User@News.Example.com:8443/a?b#c')).toBe('news.example.com');
+    expect(hostOf('not a url')).toBeNull();
+  });
+});
+
+describe('CrawlTelemetryBridge URL telemetry', () => {
+  let bridge;
+  let events;
+
+  beforeEach(() => {
+    events = [];
+    bridge = new CrawlTelemetryBridge({
+      broadcast: (event) => events.push(event),
+      broadcastUrlEvents: true,
+      urlEventBatchSize: 1000,
+      urlSummaryInterval: 20,
+      sampleRates: { [CRAWL_EVENT_TYPES.URL_VISITED]: 0.1 }
+    });
+  });
+
+  afterEach(() => {
+    bridge.destroy();
+  });
+
+  it('samples raw URL events but counts every URL in the summary', async () => {
+    for (let i = 0; i < 50; i++) {
+      bridge.emitUrlVisited({ url: `https://example.com/${i}`, httpStatus: 200, durationMs: 5 });
+    }
+    bridge.emitUrlError({ url: 'https://example.com/x', error: 'ETIMEDOUT' });
+
+    await new Promise((resolve) => setTimeout(resolve, 60));
+    bridge._flushUrlEvents();
+
+    const batch = events.find((event) => event.type === 'crawl:url:batch');
+    expect(batch.data.count).toBe(5);
+    expect(events.filter((event) => event.type === CRAWL_EVENT_TYPES.URL_ERROR)).toHaveLength(1);
+
+    const summaries = events.filter((event) => event.type === CRAWL_EVENT_TYPES.URL_SUMMARY);
+    expect(summaries).toHaveLength(1);
+    expect(summaries[0].data.window).toMatchObject({ visited: 50, errors: 1 });
+    expect(summaries[0].data.sampling[CRAWL_EVENT_TYPES.URL_VISITED]).toEqual({ rate: 0.1, dropped: 45 });
+    expect(bridge.getState().urlSummary.window.visited).toBe(50);
+    expect(bridge.getHistory().some((event) => event.type === CRAWL_EVENT_TYPES.URL_SUMMARY)).toBe(false);
+  });
+
+  it('records URL outcomes when raw URL events are not broadcast', () => {
+    const quiet = new CrawlTelemetryBridge({ broadcast: () => {}, urlSummaryInterval: 0 });
+    try {
+      quiet.emitUrlVisited({ url: 'https://example.com/a', httpStatus: 404, contentLength: 512 });
+      expect(quiet.getUrlSummary().totals).toMatchObject({ visited: 1, bytes: 512, status: { '4xx': 1 } });
+      expect(quiet.getUrlRecords()).toEqual([expect.objectContaining({ host: 'example.com', httpStatus: 404 })]);
+    } finally {
+      quiet.destroy();
+    }
+  });
+});
@@ -100,14 +100,17 @@ const {
   createGoalSatisfiedEvent,
   createBudgetEvent,
   createWorkerScaledEvent,
+  createAnalysisWorkersEvent,
   createUrlVisitedEvent,
   createUrlErrorEvent,
+  createUrlSummaryEvent,
   formatPhaseName,
   isValidTelemetryEvent
 } = require('./CrawlTelemetrySchema');
 
 const { CrawlTelemetryBridge } = require('./CrawlTelemetryBridge');
 const { TelemetryIntegration } = require('./TelemetryIntegration');
+const { TelemetryRingBuffer, RECORD_KINDS } = require('./TelemetryRingBuffer');
 
 module.exports = {
   // Schema
@@ -123,8 +126,10 @@ module.exports = {
   createGoalSatisfiedEvent,
   createBudgetEvent,
   createWorkerScaledEvent,
+  createAnalysisWorkersEvent,
   createUrlVisitedEvent,
   createUrlErrorEvent,
+  createUrlSummaryEvent,
   
   // Utilities
   formatPhaseName,
@@ -132,6 +137,8 @@ module.exports = {
   
   // Bridge
   CrawlTelemetryBridge,
+  TelemetryRingBuffer,
+  RECORD_KINDS,
   
   // Server integration
   TelemetryIntegration
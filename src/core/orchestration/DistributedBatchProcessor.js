@@ -22,6 +22,8 @@ class DistributedBatchProcessor {
    * @param {number} [options.getTimeoutMs=15000] - GET request timeout
    * @param {number} [options.batchSize=50] - Max URLs per batch
    * @param {number} [options.concurrency=10] - Concurrent batch limit
+   * @param {Object} [options.scheduler] - HostShardScheduler; spreads URLs across nodes by host with work stealing
+   * @param {Map<string, Object>} [options.nodeAdapters] - nodeId -> DistributedFetchAdapter (required with scheduler)
    */
   constructor(options = {}) {
     this.adapter = options.distributedAdapter;
@@ -32,6 +34,8 @@ class DistributedBatchProcessor {
     this.getTimeoutMs = options.getTimeoutMs || 15000;
     this.batchSize = options.batchSize || 50;
     this.concurrency = options.concurrency || 10;
+    this.scheduler = options.scheduler || null;
+    this.nodeAdapters = options.nodeAdapters || null;
   }
 
   /**
@@ -41,12 +45,13 @@ class DistributedBatchProcessor {
    * @returns {Promise<Map<string, HeadResult>>} Map of URL -> result
    */
   async batchHeadCheck(urls, context = {}) {
-    if (!this.adapter || urls.length === 0) {
+    if ((!this.adapter && !this._useScheduler()) || urls.length === 0) {
       return new Map();
     }
 
     const results = new Map();
-    const batches = this._chunkArray(urls, this.batchSize);
+    // With a scheduler the whole set is one logical batch; nodes pull host shards from it
+    const batches = this._useScheduler() ? [urls] : this._chunkArray(urls, this.batchSize);
     
     // Check if domain needs Puppeteer (pass db for persistent learning)
     const domain = context.domain || '';
@@ -75,7 +80,7 @@ class DistributedBatchProcessor {
       }));
 
       try {
-        const batchResults = await this.adapter.fetchBatch(requests, {
+        const batchResults = await this._fetchBatch(requests, {
           timeoutMs: this.headTimeoutMs * 2,
           compress: false // HEAD requests don't need compression
         });
@@ -169,12 +174,13 @@ class DistributedBatchProcessor {
    * @returns {Promise<Map<string, GetResult>>} Map of URL -> result with body
    */
   async batchGetFetch(urls, context = {}) {
-    if (!this.adapter || urls.length === 0) {
+    if ((!this.adapter && !this._useScheduler()) || urls.length === 0) {
       return new Map();
     }
 
     const results = new Map();
-    const batches = this._chunkArray(urls, this.batchSize);
+    // With a scheduler the whole set is one logical batch; nodes pull host shards from it
+    const batches = this._useScheduler() ? [urls] : this._chunkArray(urls, this.batchSize);
     
     // Check if domain needs Puppeteer (pass db for persistent learning)
     const domain = context.domain || '';
@@ -201,7 +207,7 @@ class DistributedBatchProcessor {
       }));
 
       try {
-        const batchResults = await this.adapter.fetchBatch(requests, {
+        const batchResults = await this._fetchBatch(requests, {
           timeoutMs: this.getTimeoutMs * 2,
           compress: true, // GET responses benefit from compression
           includeBody: true // Need body for validation
@@ -416,9 +422,17 @@ class DistributedBatchProcessor {
    * Check if distributed processing is available
    */
   isAvailable() {
+    if (this._useScheduler()) return true;
     return this.adapter && typeof this.adapter.fetchBatch === 'function';
   }
 
+  /**
+   * Per-node throughput and steal counts (null without a scheduler)
+   */
+  getSchedulerStats() {
+    return this.scheduler ? this.scheduler.getStats() : null;
+  }
+
   /**
    * Get adapter health status
    */
@@ -437,6 +451,34 @@ class DistributedBatchProcessor {
 
   // --- Private helpers ---
 
+  _useScheduler() {
+    return !!(this.scheduler && this.nodeAdapters && this.nodeAdapters.size > 0);
+  }
+
+  /**
+   * Send requests through the single adapter, or through every node's
+   * adapter via the scheduler (host-affine, work-stealing, globally polite).
+   */
+  async _fetchBatch(requests, options) {
+    if (!this._useScheduler()) {
+      return this.adapter.fetchBatch(requests, options);
+    }
+    return this.scheduler.dispatch(requests, async (nodeId, batch) => {
+      const adapter = this.nodeAdapters.get(nodeId);
+      if (!adapter) {
+        throw new Error(`No adapter for node ${nodeId}`);
+      }
+      const byUrl = new Map();
+      for (const result of await adapter.fetchBatch(batch, options)) {
+        byUrl.set(result.url, result);
+      }
+      return batch.map(request => byUrl.get(request.url) || { url: request.url, ok: false, error: 'missing result' });
+    }, {
+      batchSize: this.batchSize,
+      isOk: result => !!(result && result.ok)
+    });
+  }
+
   _chunkArray(array, size) {
     const chunks = [];
     for (let i = 0; i < array.length; i += size) {
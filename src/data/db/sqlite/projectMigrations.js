@@ -0,0 +1,57 @@
+'use strict';
+
+/**
+ * Project-owned schema migrations
+ *
+ * Schema for features that live in this repo rather than in news-crawler-db.
+ * ensureDatabase applies them after the news-crawler-db schema ensure, so
+ * runtime code only checks that a column or table exists and never alters
+ * the schema itself. Each entry is idempotent ({MIGRATION_NAME, up, down,
+ * isApplied}); tools/migrations/project-migrations.js runs them by hand.
+ */
+
+const PROJECT_MIGRATIONS = Object.freeze([
+  require('./v1/migrations/add_compression_dictionary_columns'),
+  require('./v1/migrations/add_bucket_frame_index_column'),
+  require('./v1/migrations/add_search_index_queue_tables')
+]);
+
+function unwrapHandle(handle) {
+  // Adapters wrap the better-sqlite3 Database as .db
+  return handle && typeof handle.exec !== 'function' && handle.db ? handle.db : handle;
+}
+
+/**
+ * Apply every project migration that is not applied yet
+ * @param {import('better-sqlite3').Database} handle
+ * @returns {string[]} Names of the migrations that ran
+ */
+function applyProjectMigrations(handle) {
+  const db = unwrapHandle(handle);
+  const applied = [];
+  for (const migration of PROJECT_MIGRATIONS) {
+    if (!migration.isApplied(db)) {
+      migration.up(db);
+      applied.push(migration.MIGRATION_NAME);
+    }
+  }
+  return applied;
+}
+
+/**
+ * @param {import('better-sqlite3').Database} handle
+ * @returns {Array<{name: string, applied: boolean}>}
+ */
+function getProjectMigrationStatus(handle) {
+  const db = unwrapHandle(handle);
+  return PROJECT_MIGRATIONS.map((migration) => ({
+    name: migration.MIGRATION_NAME,
+    applied: migration.isApplied(db)
+  }));
+}
+
+module.exports = {
+  PROJECT_MIGRATIONS,
+  applyProjectMigrations,
+  getProjectMigrationStatus
+};
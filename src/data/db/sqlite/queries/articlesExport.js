@@ -0,0 +1,62 @@
+/**
+ * Articles Export Queries
+ *
+ * Database access layer for streaming article exports. Rows are read in
+ * keyset pages on content_analysis.id, so every page is an index range scan
+ * from the last id returned: the cost of a page does not grow with how deep
+ * the export is, and no statement stays open between pages (body reads can
+ * share the connection).
+ */
+
+const DEFAULT_PAGE_SIZE = 500;
+
+/**
+ * Build an export cursor over analysed article rows
+ * @param {import('better-sqlite3').Database} db
+ * @param {Object} [options]
+ * @param {number} [options.pageSize=500] - Rows per keyset page
+ * @returns {(filters?: {since?: string, until?: string, host?: string, limit?: number}) => Generator<Object>}
+ *   Rows carry id, url, host, title, published_at, fetched_at, word_count,
+ *   category, classification, http_status and content_id (for body reads)
+ */
+function createArticlesExportCursor(db, options = {}) {
+  const pageSize = Math.max(1, options.pageSize || DEFAULT_PAGE_SIZE);
+  const statement = db.prepare(`
+    SELECT ca.id, u.url, u.host, ca.title, ca.date AS published_at, hr.fetched_at,
+           ca.word_count, ca.section AS category, ca.classification, hr.http_status,
+           ca.content_id
+    FROM content_analysis ca
+    JOIN content_storage cs ON cs.id = ca.content_id
+    JOIN http_responses hr ON hr.id = cs.http_response_id
+    JOIN urls u ON u.id = hr.url_id
+    WHERE ca.id > @afterId
+      AND (@since IS NULL OR hr.fetched_at >= @since)
+      AND (@until IS NULL OR hr.fetched_at <= @until)
+      AND (@host IS NULL OR u.host = @host)
+    ORDER BY ca.id
+    LIMIT @pageSize
+  `);
+
+  return function* iterateArticlesForExport(filters = {}) {
+    const params = {
+      since: filters.since || null,
+      until: filters.until || null,
+      host: filters.host || null
+    };
+    let remaining = Number.isFinite(filters.limit) ? Math.max(0, filters.limit) : Infinity;
+    let afterId = 0;
+    while (remaining > 0) {
+      const page = statement.all({ ...params, afterId, pageSize: Math.min(pageSize, remaining) });
+      for (const row of page) {
+        yield row;
+      }
+      if (page.length < pageSize) return;
+      afterId = page[page.length - 1].id;
+      remaining -= page.length;
+    }
+  };
+}
+
+module.exports = {
+  createArticlesExportCursor
+};
@@ -0,0 +1,126 @@
+/**
+ * Compression Dictionary Queries
+ *
+ * Database access layer for per-domain compression dictionaries: the
+ * dictionary columns of compression_types (added by the
+ * add_compression_dictionary_columns migration) and the stored pages they
+ * are trained from.
+ */
+
+const DICTIONARY_COLUMNS = Object.freeze([
+  ['dictionary_blob', 'BLOB'],
+  ['dictionary_domain', 'TEXT'],
+  ['dictionary_sample_count', 'INTEGER'],
+  ['dictionary_trained_at', 'TEXT']
+]);
+
+const DICTIONARY_TYPE_COLUMNS = `
+  id, name, algorithm, level, description,
+  dictionary_blob, dictionary_domain, dictionary_sample_count, dictionary_trained_at
+`;
+
+/**
+ * Dictionary columns compression_types does not have yet
+ * @param {import('better-sqlite3').Database} db
+ * @returns {Array<[string, string]>} [name, type] pairs
+ */
+function missingDictionaryColumns(db) {
+  const present = new Set(db.prepare('PRAGMA table_info(compression_types)').all().map((column) => column.name));
+  return DICTIONARY_COLUMNS.filter(([name]) => !present.has(name));
+}
+
+/**
+ * Highest generation stored for a `<algorithm>_dict_<domain>` prefix
+ * @param {import('better-sqlite3').Database} db
+ * @param {string} prefix
+ * @returns {number} 0 when there is none
+ */
+function getLatestDictionaryGeneration(db, prefix) {
+  return db.prepare('SELECT name FROM compression_types WHERE substr(name, 1, ?) = ?')
+    .all(prefix.length + 1, `${prefix}_`)
+    .reduce((max, row) => Math.max(max, Number(row.name.slice(prefix.length + 1)) || 0), 0);
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ * @param {Object} type
+ * @returns {Object} The inserted compression_types row
+ */
+function insertDictionaryType(db, type) {
+  return db.prepare(`
+    INSERT INTO compression_types (
+      name, algorithm, level, description,
+      dictionary_blob, dictionary_domain, dictionary_sample_count, dictionary_trained_at
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    RETURNING ${DICTIONARY_TYPE_COLUMNS}
+  `).get(
+    type.name,
+    type.algorithm,
+    type.level,
+    type.description,
+    type.dictionary,
+    type.domain,
+    type.sampleCount ?? null,
+    type.trainedAt
+  );
+}
+
+/**
+ * Newest dictionary type for a domain. Uses the table scan it always did;
+ * compression_types holds a few dozen rows.
+ * @param {import('better-sqlite3').Database} db
+ * @param {string} domain - Lower-cased host
+ * @returns {Object|null}
+ */
+function getLatestDomainDictionaryType(db, domain) {
+  return db.prepare(`
+    SELECT ${DICTIONARY_TYPE_COLUMNS}
+    FROM compression_types
+    WHERE dictionary_domain = ? AND dictionary_blob IS NOT NULL
+    ORDER BY id DESC
+    LIMIT 1
+  `).get(domain) || null;
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ * @param {number} typeId
+ * @returns {Buffer|null}
+ */
+function getDictionaryBlob(db, typeId) {
+  const row = db.prepare('SELECT dictionary_blob FROM compression_types WHERE id = ?').get(typeId);
+  return row && row.dictionary_blob ? Buffer.from(row.dictionary_blob) : null;
+}
+
+/**
+ * Most recent inline-stored pages for a host, still compressed
+ * @param {import('better-sqlite3').Database} db
+ * @param {string} host - Lower-cased urls.host
+ * @param {number} limit
+ * @returns {Array<{id: number, content_blob: Buffer, compression_type_id: number|null, algorithm: string|null}>}
+ */
+function listDomainContentSamples(db, host, limit) {
+  return db.prepare(`
+    SELECT cs.id, cs.content_blob, cs.compression_type_id, ct.algorithm
+    FROM content_storage cs
+    INNER JOIN http_responses hr ON cs.http_response_id = hr.id
+    INNER JOIN urls u ON hr.url_id = u.id
+    LEFT JOIN compression_types ct ON cs.compression_type_id = ct.id
+    WHERE u.host = ?
+      AND cs.storage_type IN ('db_inline', 'db_compressed')
+      AND cs.content_blob IS NOT NULL
+      AND LENGTH(cs.content_blob) > 0
+    ORDER BY cs.id DESC
+    LIMIT ?
+  `).all(host, limit);
+}
+
+module.exports = {
+  DICTIONARY_COLUMNS,
+  missingDictionaryColumns,
+  getLatestDictionaryGeneration,
+  insertDictionaryType,
+  getLatestDomainDictionaryType,
+  getDictionaryBlob,
+  listDomainContentSamples
+};
@@ -0,0 +1,30 @@
+/**
+ * Export Content Queries
+ *
+ * Database access layer for locating stored article bodies during exports.
+ */
+
+/**
+ * Build a lookup for the latest stored response body reference of a URL.
+ * The statement is prepared once and reused for every row.
+ * @param {import('better-sqlite3').Database} db
+ * @returns {(url: string) => Object|null} Content row (content_id, content_blob, compression columns) or null
+ */
+function createLatestContentRowLookup(db) {
+  const statement = db.prepare(`
+    SELECT cs.id AS content_id, cs.content_blob, cs.compression_type_id,
+           ct.algorithm AS compression_algorithm, cs.compression_bucket_id, cs.bucket_entry_key
+    FROM urls u
+    JOIN http_responses hr ON hr.url_id = u.id
+    JOIN content_storage cs ON cs.http_response_id = hr.id
+    LEFT JOIN compression_types ct ON ct.id = cs.compression_type_id
+    WHERE u.url = ?
+    ORDER BY hr.fetched_at DESC, hr.id DESC
+    LIMIT 1
+  `);
+  return (url) => statement.get(url) || null;
+}
+
+module.exports = {
+  createLatestContentRowLookup
+};
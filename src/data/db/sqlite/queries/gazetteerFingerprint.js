@@ -0,0 +1,65 @@
+/**
+ * Gazetteer Fingerprint Queries
+ *
+ * Database access layer for the summary that decides whether a cached
+ * gazetteer matcher artifact still matches the place tables.
+ */
+
+const ROW_HASH_FN = 'gazetteer_row_hash';
+const registeredDbs = new WeakSet();
+
+// FNV-1a over the column values, so a rename or kind/country edit changes
+// the row's hash even when counts and ids do not move
+function rowHash(...values) {
+  let hash = 0x811c9dc5;
+  for (const value of values) {
+    const text = value === null || value === undefined ? '\u0000' : String(value);
+    for (let i = 0; i < text.length; i++) {
+      hash ^= text.charCodeAt(i);
+      hash = Math.imul(hash, 0x01000193);
+    }
+    hash ^= 0x1f;
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return hash >>> 0;
+}
+
+function ensureRowHash(db) {
+  if (registeredDbs.has(db)) return true;
+  if (typeof db.function !== 'function') return false;
+  db.function(ROW_HASH_FN, { deterministic: true, varargs: true }, rowHash);
+  registeredDbs.add(db);
+  return true;
+}
+
+/**
+ * Row count, highest id and summed row-content hash for each gazetteer table
+ * the place matchers are built from
+ * @param {import('better-sqlite3').Database} db
+ * @returns {{places: Object, names: Object, hierarchy: Object}|null} Null when the handle cannot register SQL functions
+ */
+function getGazetteerFingerprintRows(handle) {
+  // Adapters wrap the better-sqlite3 Database as .db
+  const db = handle && typeof handle.function !== 'function' && handle.db ? handle.db : handle;
+  if (!db || typeof db.prepare !== 'function' || !ensureRowHash(db)) return null;
+  return {
+    places: db.prepare(`
+      SELECT COUNT(*) AS c, MAX(id) AS m,
+        SUM(${ROW_HASH_FN}(id, kind, country_code, population, canonical_name_id)) AS h
+      FROM places
+    `).get(),
+    names: db.prepare(`
+      SELECT COUNT(*) AS c, MAX(id) AS m,
+        SUM(${ROW_HASH_FN}(id, place_id, name, normalized)) AS h
+      FROM place_names
+    `).get(),
+    hierarchy: db.prepare(`
+      SELECT COUNT(*) AS c, SUM(${ROW_HASH_FN}(parent_id, child_id)) AS h
+      FROM place_hierarchy
+    `).get()
+  };
+}
+
+module.exports = {
+  getGazetteerFingerprintRows
+};
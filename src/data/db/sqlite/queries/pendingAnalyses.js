@@ -0,0 +1,42 @@
+/**
+ * Pending Analyses Queries
+ *
+ * Database access layer for the page analysis backlog (analyse-pages).
+ */
+
+/**
+ * Build a keyset reader over content_analysis rows below an analysis
+ * version. Each call is an index range scan from `afterId`, so the cost of a
+ * batch does not grow with the number of rows already processed or skipped.
+ * Rows carry the same columns as getPendingAnalyses.
+ * @param {import('better-sqlite3').Database} db
+ * @returns {(analysisVersion: number, afterId: number|null, limit: number) => Object[]}
+ */
+function createPendingAnalysesAfterQuery(db) {
+  const statement = db.prepare(`
+    SELECT ca.id AS analysis_id, ca.content_id, ca.analysis_version, ca.classification,
+           ca.title, ca.section, ca.word_count, ca.article_xpath,
+           ca.nav_links_count, ca.article_links_count,
+           u.url, hr.http_status,
+           cs.content_blob, cs.compression_type_id, ct.algorithm AS compression_algorithm,
+           cs.compression_bucket_id, cs.bucket_entry_key
+    FROM content_analysis ca
+    JOIN content_storage cs ON cs.id = ca.content_id
+    JOIN http_responses hr ON hr.id = cs.http_response_id
+    JOIN urls u ON u.id = hr.url_id
+    LEFT JOIN compression_types ct ON ct.id = cs.compression_type_id
+    WHERE ca.id > ?
+      AND (ca.analysis_version IS NULL OR ca.analysis_version < ?)
+    ORDER BY ca.id
+    LIMIT ?
+  `);
+  return (analysisVersion, afterId, limit) => statement.all(
+    Number.isFinite(afterId) ? afterId : 0,
+    analysisVersion,
+    Math.max(0, Math.floor(limit))
+  );
+}
+
+module.exports = {
+  createPendingAnalysesAfterQuery
+};
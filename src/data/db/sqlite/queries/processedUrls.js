@@ -0,0 +1,46 @@
+/**
+ * Processed URL Queries
+ *
+ * Database access layer for the crawler's seen-URL filter warm-up.
+ */
+
+/**
+ * URLs with a successful response and stored content, the same test as
+ * isUrlSuccessfullyProcessedWithContent but over the whole table.
+ * @param {import('better-sqlite3').Database} db
+ * @param {Object} [options]
+ * @param {string} [options.host] - Restrict to one host
+ * @param {string} [options.since] - Only rows fetched at/after this ISO time
+ * @param {number} [options.limit] - Stop after this many rows
+ * @returns {IterableIterator<{url: string}>}
+ */
+function iterateProcessedUrls(db, { host = null, since = null, limit = null } = {}) {
+  const where = ['hr.http_status >= 200', 'hr.http_status < 300'];
+  const params = [];
+  if (host) {
+    where.push('u.host = ?');
+    params.push(host);
+  }
+  if (since) {
+    // datetime() on both sides: fetched_at may be stored as ISO or SQLite text
+    where.push('datetime(hr.fetched_at) >= datetime(?)');
+    params.push(since);
+  }
+  let limitClause = '';
+  if (Number.isFinite(limit) && limit > 0) {
+    limitClause = 'LIMIT ?';
+    params.push(Math.floor(limit));
+  }
+  return db.prepare(`
+    SELECT DISTINCT u.url AS url
+    FROM urls u
+    JOIN http_responses hr ON hr.url_id = u.id
+    JOIN content_storage cs ON cs.http_response_id = hr.id
+    WHERE ${where.join(' AND ')}
+    ${limitClause}
+  `).iterate(...params);
+}
+
+module.exports = {
+  iterateProcessedUrls
+};
@@ -0,0 +1,325 @@
+/**
+ * Search Index Queries
+ *
+ * Database access layer for articles_fts upkeep (sync and queue triggers,
+ * the deferred-update queue, the generation counter, FTS5 merge commands)
+ * and the single-pass search + facets statement.
+ */
+
+const INDEXED_COLUMNS = ['title', 'body_text', 'byline', 'authors'];
+
+const SYNC_TRIGGERS_SQL = `
+  CREATE TRIGGER articles_fts_insert AFTER INSERT ON content_analysis
+  BEGIN
+    INSERT INTO articles_fts(rowid, title, body_text, byline, authors)
+    VALUES (NEW.id, NEW.title, NEW.body_text, NEW.byline, NEW.authors);
+  END;
+  CREATE TRIGGER articles_fts_update AFTER UPDATE ON content_analysis
+  BEGIN
+    INSERT INTO articles_fts(articles_fts, rowid, title, body_text, byline, authors)
+    VALUES ('delete', OLD.id, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+    INSERT INTO articles_fts(rowid, title, body_text, byline, authors)
+    VALUES (NEW.id, NEW.title, NEW.body_text, NEW.byline, NEW.authors);
+  END;
+  CREATE TRIGGER articles_fts_delete AFTER DELETE ON content_analysis
+  BEGIN
+    INSERT INTO articles_fts(articles_fts, rowid, title, body_text, byline, authors)
+    VALUES ('delete', OLD.id, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+  END;
+`;
+
+// INSERT OR IGNORE keeps the first OLD values queued for a row, which are the
+// values articles_fts still holds until the next flush.
+const QUEUE_TRIGGERS_SQL = `
+  CREATE TRIGGER articles_fts_insert AFTER INSERT ON content_analysis
+  BEGIN
+    INSERT OR IGNORE INTO search_index_queue(analysis_id, indexed) VALUES (NEW.id, 0);
+  END;
+  CREATE TRIGGER articles_fts_update AFTER UPDATE OF id, ${INDEXED_COLUMNS.join(', ')} ON content_analysis
+  BEGIN
+    INSERT OR IGNORE INTO search_index_queue(analysis_id, indexed, old_title, old_body_text, old_byline, old_authors)
+    VALUES (OLD.id, 1, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+    INSERT OR IGNORE INTO search_index_queue(analysis_id, indexed)
+    SELECT NEW.id, 0 WHERE NEW.id <> OLD.id;
+  END;
+  CREATE TRIGGER articles_fts_delete AFTER DELETE ON content_analysis
+  BEGIN
+    INSERT OR IGNORE INTO search_index_queue(analysis_id, indexed, old_title, old_body_text, old_byline, old_authors)
+    VALUES (OLD.id, 1, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+  END;
+`;
+
+const DROP_TRIGGERS_SQL = `
+  DROP TRIGGER IF EXISTS articles_fts_insert;
+  DROP TRIGGER IF EXISTS articles_fts_update;
+  DROP TRIGGER IF EXISTS articles_fts_delete;
+`;
+
+const QUEUE_COLUMNS = 'analysis_id, indexed, old_title, old_body_text, old_byline, old_authors';
+
+/**
+ * True when the deferred-indexing tables exist (add_search_index_queue_tables)
+ * @param {import('better-sqlite3').Database} db
+ * @returns {boolean}
+ */
+function hasDeferredIndexTables(db) {
+  const row = db.prepare(
+    "SELECT COUNT(*) AS n FROM sqlite_master WHERE type = 'table' AND name IN ('search_index_queue', 'search_index_state')"
+  ).get();
+  return row.n === 2;
+}
+
+/**
+ * True when content_analysis feeds search_index_queue rather than articles_fts
+ * @param {import('better-sqlite3').Database} db
+ * @returns {boolean}
+ */
+function hasDeferredIndexTriggers(db) {
+  const row = db.prepare("SELECT sql FROM sqlite_master WHERE type = 'trigger' AND name = 'articles_fts_insert'").get();
+  return Boolean(row && row.sql && row.sql.includes('search_index_queue'));
+}
+
+/**
+ * True when articles_fts exists, so there is an index to maintain
+ * @param {import('better-sqlite3').Database} db
+ * @returns {boolean}
+ */
+function hasArticlesFts(db) {
+  return Boolean(db.prepare("SELECT 1 AS present FROM sqlite_master WHERE name = 'articles_fts'").get());
+}
+
+/**
+ * Swap the per-row FTS triggers for queue triggers. The queue/state tables
+ * come from the add_search_index_queue_tables migration.
+ * @param {import('better-sqlite3').Database} db
+ * @param {number} initialGeneration - Stored generation if none is recorded yet
+ */
+function installDeferredIndexTriggers(db, initialGeneration) {
+  if (!hasDeferredIndexTables(db)) {
+    throw new Error('search_index_queue/search_index_state are missing; run node tools/migrations/project-migrations.js');
+  }
+  db.transaction(() => {
+    db.exec(`
+      ${DROP_TRIGGERS_SQL}
+      ${QUEUE_TRIGGERS_SQL}
+    `);
+    db.prepare("INSERT OR IGNORE INTO search_index_state(key, value) VALUES ('generation', ?)").run(initialGeneration);
+  })();
+}
+
+/**
+ * Restore the per-row FTS triggers. The queue is emptied and the stored
+ * generation dropped, so the next enable starts from the caller's generation.
+ * @param {import('better-sqlite3').Database} db
+ */
+function restoreSyncIndexTriggers(db) {
+  db.transaction(() => {
+    db.exec(`
+      ${DROP_TRIGGERS_SQL}
+      ${SYNC_TRIGGERS_SQL}
+    `);
+    if (hasDeferredIndexTables(db)) {
+      db.prepare('DELETE FROM search_index_queue').run();
+      db.prepare("DELETE FROM search_index_state WHERE key = 'generation'").run();
+    }
+  })();
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ * @returns {number} Rows waiting in search_index_queue
+ */
+function countQueuedIndexUpdates(db) {
+  return db.prepare('SELECT COUNT(*) AS n FROM search_index_queue').get().n;
+}
+
+/**
+ * Apply up to `limit` queued rows to articles_fts in one transaction. The
+ * stored generation is bumped in the same transaction when anything was applied.
+ * @param {import('better-sqlite3').Database} db
+ * @param {number} limit
+ * @returns {{indexed: number, removed: number, dequeued: number}}
+ */
+function applyQueuedIndexUpdates(db, limit) {
+  const selectBatch = db.prepare(`SELECT ${QUEUE_COLUMNS} FROM search_index_queue ORDER BY analysis_id LIMIT ?`);
+  const selectCurrent = db.prepare(`SELECT ${INDEXED_COLUMNS.join(', ')} FROM content_analysis WHERE id = ?`);
+  const removeOld = db.prepare(`
+    INSERT INTO articles_fts(articles_fts, rowid, title, body_text, byline, authors)
+    VALUES ('delete', ?, ?, ?, ?, ?)
+  `);
+  const insertNew = db.prepare(`
+    INSERT INTO articles_fts(rowid, title, body_text, byline, authors) VALUES (?, ?, ?, ?, ?)
+  `);
+  const dequeue = db.prepare('DELETE FROM search_index_queue WHERE analysis_id = ?');
+
+  const counts = { indexed: 0, removed: 0, dequeued: 0 };
+  db.transaction(() => {
+    const batch = selectBatch.all(limit);
+    for (const entry of batch) {
+      if (entry.indexed) {
+        removeOld.run(entry.analysis_id, entry.old_title, entry.old_body_text, entry.old_byline, entry.old_authors);
+        counts.removed += 1;
+      }
+      const current = selectCurrent.get(entry.analysis_id);
+      if (current) {
+        insertNew.run(entry.analysis_id, current.title, current.body_text, current.byline, current.authors);
+        counts.indexed += 1;
+      }
+      dequeue.run(entry.analysis_id);
+    }
+    counts.dequeued = batch.length;
+    if (batch.length > 0) bumpIndexGeneration(db);
+  })();
+  return counts;
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ */
+function clearIndexQueue(db) {
+  db.prepare('DELETE FROM search_index_queue').run();
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ * @returns {number|null} Stored generation, or null if none is recorded
+ */
+function readIndexGeneration(db) {
+  const row = db.prepare("SELECT value FROM search_index_state WHERE key = 'generation'").get();
+  return row ? row.value : null;
+}
+
+/**
+ * @param {import('better-sqlite3').Database} db
+ */
+function bumpIndexGeneration(db) {
+  db.prepare("UPDATE search_index_state SET value = value + 1 WHERE key = 'generation'").run();
+}
+
+/**
+ * Set one FTS5 configuration option (automerge, crisismerge, usermerge)
+ * @param {import('better-sqlite3').Database} db
+ * @param {string} name
+ * @param {number} value
+ */
+function setFtsMergeOption(db, name, value) {
+  if (!['automerge', 'crisismerge', 'usermerge'].includes(name)) {
+    throw new Error(`Unknown FTS5 merge option: ${name}`);
+  }
+  // FTS5 reads special commands from the statement text, so they are not bound
+  db.prepare(`INSERT INTO articles_fts(articles_fts, rank) VALUES ('${name}', ${Math.floor(Number(value))})`).run();
+}
+
+/**
+ * Run one FTS5 'merge' command
+ * @param {import('better-sqlite3').Database} db
+ * @param {number} pages - Pages to write in this step
+ * @returns {boolean} True when the step did work and more may remain
+ */
+function runFtsMergeStep(db, pages) {
+  const totalChanges = db.prepare('SELECT total_changes() AS n');
+  const before = totalChanges.get().n;
+  db.prepare(`INSERT INTO articles_fts(articles_fts, rank) VALUES ('merge', ${Math.floor(Number(pages))})`).run();
+  // FTS5 documents a total_changes() delta below 2 as "nothing left to merge"
+  return totalChanges.get().n - before >= 2;
+}
+
+const MATCHED_COLUMNS = 'id, rank, content_id, title, body_text, byline, authors, date, section, word_count, url, host, fetched_at';
+
+/**
+ * bm25() weight arguments in articles_fts column order
+ * @returns {string} e.g. ", 10, 1, 2, 2" or ""
+ */
+function bm25WeightArgs(weights) {
+  const values = Array.isArray(weights)
+    ? weights
+    : (weights && typeof weights === 'object' ? INDEXED_COLUMNS.map((column) => weights[column] ?? 1) : []);
+  const numbers = values.map(Number);
+  return numbers.length > 0 && numbers.every(Number.isFinite) ? `, ${numbers.join(', ')}` : '';
+}
+
+/**
+ * One statement that evaluates the MATCH once and returns the hit page, the
+ * filtered total and the facets as tagged rows (kind, value, n, payload).
+ * Facets cover every match; domain/date filters apply to the hits only, as
+ * with the adapter's getFacets().
+ */
+function buildSinglePassSql({ withHits, weights }) {
+  const hitMembers = withHits ? `
+    SELECT 'hit' AS kind, NULL AS value, n, payload FROM (
+      SELECT row_number() OVER (ORDER BY rank) AS n,
+             json_object('id', id, 'content_id', content_id, 'title', title, 'body_text', body_text,
+                         'byline', byline, 'authors', authors, 'date', date, 'section', section,
+                         'word_count', word_count, 'url', url, 'host', host, 'fetched_at', fetched_at,
+                         'rank', rank) AS payload
+      FROM filtered ORDER BY rank LIMIT @limit OFFSET @offset
+    )
+    UNION ALL
+    SELECT 'total', NULL, COUNT(*), NULL FROM filtered
+    UNION ALL` : '';
+
+  return `
+    WITH hits AS MATERIALIZED (
+      SELECT articles_fts.rowid AS id, bm25(articles_fts${bm25WeightArgs(weights)}) AS rank
+      FROM articles_fts WHERE articles_fts MATCH @match
+    ),
+    matched AS MATERIALIZED (
+      SELECT h.id, h.rank, ca.content_id, ca.title, ca.body_text, ca.byline, ca.authors, ca.date,
+             ca.section, ca.word_count, u.url, u.host, hr.fetched_at
+      FROM hits h
+      JOIN content_analysis ca ON ca.id = h.id
+      LEFT JOIN content_storage cs ON cs.id = ca.content_id
+      LEFT JOIN http_responses hr ON hr.id = cs.http_response_id
+      LEFT JOIN urls u ON u.id = hr.url_id
+    )${withHits ? `,
+    filtered AS (
+      SELECT ${MATCHED_COLUMNS} FROM matched
+      WHERE (@domain IS NULL OR host = @domain)
+        AND (@startDate IS NULL OR date >= @startDate)
+        AND (@endDate IS NULL OR date <= @endDate)
+    )` : ''}
+    ${hitMembers}
+    SELECT kind, value, n, payload FROM (
+      SELECT 'domain' AS kind, host AS value, COUNT(*) AS n, NULL AS payload FROM matched WHERE host IS NOT NULL
+      GROUP BY host ORDER BY COUNT(*) DESC, host LIMIT @facetLimit
+    )
+    UNION ALL
+    SELECT kind, value, n, payload FROM (
+      SELECT 'author' AS kind, author.value AS value, COUNT(*) AS n, NULL AS payload
+      FROM matched, json_each(CASE WHEN json_valid(matched.authors) THEN matched.authors ELSE '[]' END) AS author
+      GROUP BY author.value ORDER BY COUNT(*) DESC, author.value LIMIT @facetLimit
+    )
+    UNION ALL
+    SELECT 'dates', MIN(date), COUNT(date), MAX(date) FROM matched
+  `;
+}
+
+/**
+ * Hits, total and facets for one FTS match as tagged rows
+ * @param {import('better-sqlite3').Database} db
+ * @param {Object} params - match, facetLimit, and with hits: limit, offset, domain, startDate, endDate
+ * @param {Object} options
+ * @param {boolean} options.withHits - False for facets only
+ * @param {Array|Object} [options.weights] - bm25() column weights
+ * @returns {Array<{kind: string, value: *, n: number, payload: *}>}
+ */
+function runSinglePassSearch(db, params, { withHits, weights } = {}) {
+  return db.prepare(buildSinglePassSql({ withHits, weights })).all(params);
+}
+
+module.exports = {
+  INDEXED_COLUMNS,
+  hasDeferredIndexTables,
+  hasDeferredIndexTriggers,
+  hasArticlesFts,
+  installDeferredIndexTriggers,
+  restoreSyncIndexTriggers,
+  countQueuedIndexUpdates,
+  applyQueuedIndexUpdates,
+  clearIndexQueue,
+  readIndexGeneration,
+  bumpIndexGeneration,
+  setFtsMergeOption,
+  runFtsMergeStep,
+  runSinglePassSearch
+};
@@ -0,0 +1,48 @@
+'use strict';
+
+/**
+ * Adds compression_buckets.frame_index_json, the frame table of seekable
+ * buckets (see src/shared/utils/seekableBucket.js). Existing buckets keep a
+ * NULL frame index and stay tar buckets; migrateBucketsToSeekable converts
+ * them. Safe to run more than once.
+ */
+
+const MIGRATION_NAME = 'add_bucket_frame_index_column';
+
+function bucketColumns(db) {
+  return new Set(db.prepare('PRAGMA table_info(compression_buckets)').all().map((column) => column.name));
+}
+
+function up(db) {
+  if (bucketColumns(db).has('frame_index_json')) {
+    return { alreadyApplied: true, addedColumns: [] };
+  }
+  db.exec('ALTER TABLE compression_buckets ADD COLUMN frame_index_json TEXT');
+  return { alreadyApplied: false, addedColumns: ['frame_index_json'] };
+}
+
+function down(db) {
+  if (!bucketColumns(db).has('frame_index_json')) {
+    return { droppedColumns: [] };
+  }
+  // Seekable blobs are unreadable without their frame table
+  const seekable = db.prepare('SELECT COUNT(*) AS n FROM compression_buckets WHERE frame_index_json IS NOT NULL').get();
+  if (seekable.n > 0) {
+    throw new Error(`${seekable.n} seekable buckets still depend on frame_index_json`);
+  }
+  db.exec('ALTER TABLE compression_buckets DROP COLUMN frame_index_json');
+  return { droppedColumns: ['frame_index_json'] };
+}
+
+function isApplied(db) {
+  const columns = bucketColumns(db);
+  // No compression_buckets table yet: the schema ensure that creates it runs first
+  return columns.size === 0 || columns.has('frame_index_json');
+}
+
+module.exports = {
+  MIGRATION_NAME,
+  up,
+  down,
+  isApplied
+};
@@ -0,0 +1,45 @@
+'use strict';
+
+/**
+ * Adds the per-domain dictionary columns to compression_types
+ * (see src/shared/utils/compressionDictionaries.js). Safe to run more than once.
+ */
+
+const { missingDictionaryColumns, DICTIONARY_COLUMNS } = require('../../queries/compressionDictionaries');
+
+const MIGRATION_NAME = 'add_compression_dictionary_columns';
+
+function up(db) {
+  const added = [];
+  db.transaction(() => {
+    for (const [name, type] of missingDictionaryColumns(db)) {
+      db.exec(`ALTER TABLE compression_types ADD COLUMN ${name} ${type}`);
+      added.push(name);
+    }
+  })();
+  return { alreadyApplied: added.length === 0, addedColumns: added };
+}
+
+function down(db) {
+  const present = new Set(DICTIONARY_COLUMNS.map(([name]) => name));
+  for (const [name] of missingDictionaryColumns(db)) present.delete(name);
+  db.transaction(() => {
+    for (const name of present) {
+      db.exec(`ALTER TABLE compression_types DROP COLUMN ${name}`);
+    }
+  })();
+  return { droppedColumns: Array.from(present) };
+}
+
+function isApplied(db) {
+  // No compression_types table yet: the schema ensure that creates it runs first
+  const hasTable = db.prepare("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'compression_types'").get();
+  return !hasTable || missingDictionaryColumns(db).length === 0;
+}
+
+module.exports = {
+  MIGRATION_NAME,
+  up,
+  down,
+  isApplied
+};
@@ -0,0 +1,56 @@
+'use strict';
+
+/**
+ * Adds search_index_queue and search_index_state, the deferred articles_fts
+ * upkeep tables (see src/search/SearchIndexer.js). The tables are inert until
+ * SearchIndexer.enableDeferredIndexing() swaps the FTS triggers for queue
+ * triggers. Safe to run more than once.
+ */
+
+const { hasDeferredIndexTables, hasDeferredIndexTriggers } = require('../../queries/searchIndex');
+
+const MIGRATION_NAME = 'add_search_index_queue_tables';
+
+function up(db) {
+  if (hasDeferredIndexTables(db)) {
+    return { alreadyApplied: true, createdTables: [] };
+  }
+  db.exec(`
+    CREATE TABLE IF NOT EXISTS search_index_queue (
+      analysis_id INTEGER PRIMARY KEY,
+      indexed INTEGER NOT NULL,
+      old_title TEXT,
+      old_body_text TEXT,
+      old_byline TEXT,
+      old_authors TEXT
+    );
+    CREATE TABLE IF NOT EXISTS search_index_state (
+      key TEXT PRIMARY KEY,
+      value INTEGER NOT NULL
+    );
+  `);
+  return { alreadyApplied: false, createdTables: ['search_index_queue', 'search_index_state'] };
+}
+
+function down(db) {
+  // The queue triggers write into search_index_queue
+  if (hasDeferredIndexTriggers(db)) {
+    throw new Error('Deferred search indexing is still enabled; run SearchIndexer.disableDeferredIndexing() first');
+  }
+  db.exec(`
+    DROP TABLE IF EXISTS search_index_queue;
+    DROP TABLE IF EXISTS search_index_state;
+  `);
+  return { droppedTables: ['search_index_queue', 'search_index_state'] };
+}
+
+function isApplied(db) {
+  return hasDeferredIndexTables(db);
+}
+
+module.exports = {
+  MIGRATION_NAME,
+  up,
+  down,
+  isApplied
+};
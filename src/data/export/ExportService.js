@@ -11,7 +11,9 @@
  * - Atom 1.0: Atom syndication format
  * 
  * Features:
- * - Streaming support for large datasets
+ * - Streaming support for large datasets (constant memory: rows are pulled
+ *   from a cursor or in batches only as fast as the consumer drains them)
+ * - Optional article bodies, decompressed on the fly during streaming
  * - Filtering by date, host, limit
  * - Backpressure handling
  * 
@@ -23,12 +25,19 @@ const { JsonFormatter, JsonlFormatter, createJsonlStream } = require('./formatte
 const { CsvFormatter, createCsvStream } = require('./formatters/CsvFormatter');
 const { RssFormatter } = require('./formatters/RssFormatter');
 const { AtomFormatter } = require('./formatters/AtomFormatter');
+const { StoredContentReader, describeContentSource } = require('../../shared/utils/storedContentReader');
+const { BucketCache } = require('../../shared/utils/bucketCache');
+const { createLatestContentRowLookup } = require('../db/sqlite/queries/exportContent');
+const { createArticlesExportCursor } = require('../db/sqlite/queries/articlesExport');
 
 /**
  * Default batch size for streaming queries
  */
 const DEFAULT_BATCH_SIZE = 1000;
 
+// Content reference carried alongside a streamed row while its body is read
+const SOURCE_ROW = Symbol('sourceRow');
+
 /**
  * ExportService class
  */
@@ -41,9 +50,16 @@ class ExportService {
    * @param {Object} [options.analyticsAdapter] - Analytics database adapter
    * @param {Object} [options.logger] - Logger instance
    * @param {Object} [options.config] - Export configuration
+   * @param {Database} [options.contentDb] - better-sqlite3 handle used to read article bodies
+   *   (includeBody). When the articles adapter has no iterateArticlesForExport, streaming
+   *   exports also read rows from it by keyset (queries/articlesExport.js). An adapter's own
+   *   cursor must not be open on this connection: better-sqlite3 refuses other statements on
+   *   a connection while it is iterating.
    */
   constructor(options = {}) {
     this.articlesAdapter = options.articlesAdapter;
+    this.contentDb = options.contentDb || null;
+    if (this.contentDb && typeof this.contentDb.getHandle === 'function') this.contentDb = this.contentDb.getHandle();
     this.domainsAdapter = options.domainsAdapter || options.articlesAdapter;
     this.analyticsAdapter = options.analyticsAdapter;
     this.logger = options.logger || console;
@@ -196,89 +212,174 @@ class ExportService {
 
   /**
    * Create a readable stream for streaming export
+   * 
+   * Article rows come from the adapter's iterateArticlesForExport cursor when
+   * it has one, then from a keyset cursor on contentDb, and only otherwise
+   * from exportArticlesBatch (OFFSET) pages. Either way nothing is read ahead
+   * of what the consumer has drained, so memory stays flat however large the
+   * export is.
+   * 
    * @param {string} dataType - Type of data (articles, domains)
    * @param {string} format - Output format (jsonl, csv)
    * @param {Object} options - Export options
+   * @param {number} [options.limit] - Maximum rows (default: unlimited)
+   * @param {number} [options.batchSize] - Rows per page when paging
+   * @param {boolean} [options.includeBody] - Add each article's decompressed HTML as `html` (articles only)
+   * @param {number} [options.bodyConcurrency=4] - Body reads in flight
    * @returns {Readable} Readable stream of formatted data
    */
   createExportStream(dataType, format, options = {}) {
     if (format !== 'jsonl' && format !== 'csv') {
       throw new Error('Streaming only supported for JSONL and CSV formats');
     }
+    if (dataType !== 'articles' && dataType !== 'domains') {
+      throw new Error(`Unknown data type: ${dataType}`);
+    }
+    if (options.includeBody && dataType !== 'articles') {
+      throw new Error('includeBody is only supported for articles');
+    }
 
-    const batchSize = options.batchSize || DEFAULT_BATCH_SIZE;
-    const self = this;
-    let offset = 0;
-    let totalExported = 0;
+    let rows = this._iterateRows(dataType, options);
+    if (options.includeBody) {
+      rows = this._withBodies(rows, options);
+    }
+    return Readable.from(this._formatRows(rows, format, options), { objectMode: false });
+  }
+
+  /**
+   * Rows for a streaming export, one at a time
+   * @private
+   */
+  async *_iterateRows(dataType, options) {
     const limit = options.limit || Infinity;
-    let headerEmitted = false;
+    let exported = 0;
+
+    const iterateArticles = dataType === 'articles' ? this._articleCursor() : null;
+    if (iterateArticles) {
+      const { since, until, host } = options;
+      const cursor = iterateArticles({
+        since,
+        until,
+        host,
+        limit: Number.isFinite(limit) ? limit : undefined
+      });
+      for await (const row of cursor) {
+        if (exported >= limit) break;
+        exported++;
+        yield row;
+      }
+      return;
+    }
 
-    // Create custom readable stream
-    const stream = new Readable({
-      objectMode: false,
-      read() {
-        // Check if we've hit the limit
-        if (totalExported >= limit) {
-          this.push(null);
-          return;
-        }
-
-        const queryLimit = Math.min(batchSize, limit - totalExported);
-
-        try {
-          let batch;
-          if (dataType === 'articles') {
-            batch = self._queryArticlesBatch({
-              ...options,
-              limit: queryLimit,
-              offset
-            });
-          } else if (dataType === 'domains') {
-            batch = self._queryDomainsBatch({
-              ...options,
-              limit: queryLimit,
-              offset
-            });
-          } else {
-            throw new Error(`Unknown data type: ${dataType}`);
-          }
-
-          if (!batch || batch.length === 0) {
-            this.push(null);
-            return;
-          }
-
-          // Format each row
-          for (const item of batch) {
-            let formatted;
-            if (format === 'jsonl') {
-              formatted = JSON.stringify(item) + '\n';
-            } else if (format === 'csv') {
-              if (!headerEmitted) {
-                const fields = options.fields || Object.keys(item);
-                formatted = self.formatters.csv.formatHeader(fields) + '\n';
-                this.push(formatted);
-                headerEmitted = true;
-              }
-              formatted = self.formatters.csv.formatRow(item, options.fields) + '\n';
-            }
-            this.push(formatted);
-          }
-
-          offset += batch.length;
-          totalExported += batch.length;
-
-          // If batch is smaller than requested, we've reached the end
-          if (batch.length < queryLimit) {
-            this.push(null);
-          }
-        } catch (err) {
-          this.destroy(err);
-        }
+    const batchSize = options.batchSize || DEFAULT_BATCH_SIZE;
+    let offset = 0;
+    while (exported < limit) {
+      const queryLimit = Math.min(batchSize, limit - exported);
+      const query = { ...options, limit: queryLimit, offset };
+      const batch = dataType === 'articles'
+        ? this._queryArticlesBatch(query)
+        : this._queryDomainsBatch(query);
+
+      if (!batch || batch.length === 0) return;
+      for (const row of batch) {
+        yield row;
       }
+      offset += batch.length;
+      exported += batch.length;
+
+      // If batch is smaller than requested, we've reached the end
+      if (batch.length < queryLimit) return;
+    }
+  }
+
+  /**
+   * True when streamed article exports read by cursor rather than OFFSET pages,
+   * so deep exports cost the same per row as shallow ones
+   * @returns {boolean}
+   */
+  hasArticleCursor() {
+    return this._articleCursor() !== null;
+  }
+
+  /**
+   * @private
+   * @returns {Function|null} iterateArticlesForExport(filters)
+   */
+  _articleCursor() {
+    if (typeof this.articlesAdapter?.iterateArticlesForExport === 'function') {
+      return (filters) => this.articlesAdapter.iterateArticlesForExport(filters);
+    }
+    if (!this.contentDb || typeof this.contentDb.prepare !== 'function') return null;
+    if (!this._iterateStoredArticles) {
+      this._iterateStoredArticles = createArticlesExportCursor(this.contentDb);
+    }
+    return this._iterateStoredArticles;
+  }
+
+  /**
+   * Attach decompressed bodies to article rows, preserving order
+   * @private
+   */
+  async *_withBodies(rows, options) {
+    if (!this.contentDb) {
+      throw new Error('includeBody requires a content database (contentDb)');
+    }
+    const reader = new StoredContentReader({
+      db: this.contentDb,
+      // Private cache: a bulk export should not flush the shared one
+      bucketCache: new BucketCache({ maxSize: 4, maxMemoryMB: 128 }),
+      concurrency: options.bodyConcurrency || 4
     });
 
-    return stream;
+    const self = this;
+    async function* withSources() {
+      for await (const row of rows) {
+        const source = describeContentSource(row) ? row : self._lookupContentRow(row);
+        yield { ...(source || {}), [SOURCE_ROW]: row };
+      }
+    }
+
+    for await (const { row: ref, content, error } of reader.readAll(withSources())) {
+      const row = { ...ref[SOURCE_ROW] };
+      delete row.content_blob;
+      row.html = content ? content.toString('utf8') : null;
+      if (error) {
+        row.body_error = error.message;
+      }
+      yield row;
+    }
+  }
+
+  /**
+   * Latest stored response body reference for an article URL
+   * @private
+   */
+  _lookupContentRow(row) {
+    if (!row || !row.url) return null;
+    if (!this._lookupLatestContent) {
+      this._lookupLatestContent = createLatestContentRowLookup(this.contentDb);
+    }
+    return this._lookupLatestContent(row.url);
+  }
+
+  /**
+   * Serialize rows for a stream
+   * @private
+   */
+  async *_formatRows(rows, format, options) {
+    let headerEmitted = false;
+    for await (const item of rows) {
+      if (format === 'jsonl') {
+        yield JSON.stringify(item) + '\n';
+        continue;
+      }
+      if (!headerEmitted) {
+        const fields = options.fields || Object.keys(item);
+        yield this.formatters.csv.formatHeader(fields) + '\n';
+        headerEmitted = true;
+      }
+      yield this.formatters.csv.formatRow(item, options.fields) + '\n';
+    }
   }
 
   /**
@@ -17,6 +17,7 @@ const fs = require('fs');
 const { findProjectRoot } = require('../shared/utils/project-root');
 const { readBootstrapJson } = require('../shared/utils/bootstrapGuard');
 const ncdb = require('news-crawler-db');
+const { applyProjectMigrations } = require('../data/db/sqlite/projectMigrations');
 
 const NewsDatabase = ncdb.NewsDatabase || ncdb.SQLiteNewsDatabase;
 
@@ -37,10 +38,15 @@ function openDatabase(dbPath, options = {}) {
 
 function ensureDatabase(dbPath, options = {}) {
   const wantsSchema = !options.skipSchema && !options.readonly;
-  return ncdb.ensureSqliteNewsDatabase(dbPath, {
+  const db = ncdb.ensureSqliteNewsDatabase(dbPath, {
     ...options,
     bootstrapData: wantsSchema ? loadBootstrapData(options.logger) : undefined
   });
+  if (wantsSchema) {
+    // Schema owned by this repo rather than news-crawler-db
+    applyProjectMigrations(db);
+  }
+  return db;
 }
 
 function ensureDb(dbFilePath, options = {}) {
@@ -0,0 +1,391 @@
+'use strict';
+
+/**
+ * HostShardScheduler - Host-affinity frontier partitioning with work stealing
+ *
+ * Every host is a shard owned by exactly one node (rendezvous hashing over
+ * the live node set, so adding or removing a node only moves that node's
+ * hosts). Nodes pull work from their own shards; a node that runs dry steals
+ * whole host shards from the most loaded peer, and ownership moves with the
+ * shard so later URLs for that host follow it.
+ *
+ * Politeness is enforced here, not per node: a host's in-flight limit and
+ * minimum dispatch interval apply no matter which node holds the shard.
+ */
+
+const crypto = require('crypto');
+const EventEmitter = require('events');
+
+const DEFAULT_OPTIONS = {
+    maxInFlightPerHost: 2,
+    minHostDelayMs: 0,
+    batchSize: 50,
+    stealThreshold: 2,       // Victim must hold at least this many URLs more than the thief
+    maxStealShards: 8,
+    throughputWindowMs: 60000,
+};
+
+function hostOf(url) {
+    try {
+        return new URL(url).hostname.toLowerCase();
+    } catch (_) {
+        return '';
+    }
+}
+
+function rendezvousScore(nodeId, host) {
+    return crypto.createHash('md5').update(`${nodeId}\u0000${host}`).digest().readUInt32BE(0);
+}
+
+class HostShardScheduler extends EventEmitter {
+    /**
+     * @param {Object} options
+     * @param {Object} [options.registry] - NodeRegistry; healthy/enabled nodes join, removed/unhealthy nodes leave
+     * @param {string[]} [options.nodes] - Explicit node IDs (used instead of the registry's node list)
+     * @param {number} [options.maxInFlightPerHost=2] - Global per-host concurrency across all nodes
+     * @param {number} [options.minHostDelayMs=0] - Global minimum gap between dispatches to one host
+     * @param {number} [options.batchSize=50] - Max items handed to a node per take()
+     * @param {number} [options.stealThreshold=2] - Minimum load gap before a node steals
+     * @param {number} [options.maxStealShards=8] - Max shards moved per steal
+     * @param {Function} [options.now] - Clock (tests)
+     */
+    constructor(options = {}) {
+        super();
+        this.maxInFlightPerHost = options.maxInFlightPerHost || DEFAULT_OPTIONS.maxInFlightPerHost;
+        this.minHostDelayMs = options.minHostDelayMs ?? DEFAULT_OPTIONS.minHostDelayMs;
+        this.batchSize = options.batchSize || DEFAULT_OPTIONS.batchSize;
+        this.stealThreshold = options.stealThreshold ?? DEFAULT_OPTIONS.stealThreshold;
+        this.maxStealShards = options.maxStealShards || DEFAULT_OPTIONS.maxStealShards;
+        this.throughputWindowMs = options.throughputWindowMs || DEFAULT_OPTIONS.throughputWindowMs;
+        this.now = options.now || Date.now;
+        this.registry = options.registry || null;
+
+        /** @type {Map<string, {id: string, shards: Map<string, Object>, pending: number, inFlight: number, stats: Object}>} */
+        this.nodes = new Map();
+        /** @type {Map<string, string>} host -> owning node (stolen shards) */
+        this._affinity = new Map();
+        /** @type {Map<string, {inFlight: number, lastDispatchAt: number}>} */
+        this._hosts = new Map();
+
+        const initial = options.nodes || (this.registry ? this.registry.listEnabledNodes().map(n => n.id) : []);
+        initial.forEach(id => this.addNode(id));
+
+        if (this.registry) {
+            this._onNodeAdded = (node) => { if (node.enabled !== false) this.addNode(node.id); };
+            this._onNodeRemoved = (node) => this.removeNode(node.id);
+            this._onHealth = ({ id, healthy }) => {
+                if (healthy === false) this.removeNode(id);
+                else if (healthy && this.registry.getNode(id)?.enabled) this.addNode(id);
+            };
+            this.registry.on('node:added', this._onNodeAdded);
+            this.registry.on('node:removed', this._onNodeRemoved);
+            this.registry.on('health:updated', this._onHealth);
+        }
+    }
+
+    /**
+     * Stop following registry events
+     */
+    detach() {
+        if (!this.registry) return;
+        this.registry.off('node:added', this._onNodeAdded);
+        this.registry.off('node:removed', this._onNodeRemoved);
+        this.registry.off('health:updated', this._onHealth);
+    }
+
+    addNode(id) {
+        if (this.nodes.has(id)) return false;
+        this.nodes.set(id, {
+            id,
+            shards: new Map(),
+            pending: 0,
+            inFlight: 0,
+            stats: { dispatched: 0, completed: 0, failed: 0, steals: 0, shardsStolen: 0, shardsLost: 0, recent: [] },
+        });
+        this.emit('node:joined', { id });
+        return true;
+    }
+
+    /**
+     * Remove a node and re-home its queued shards to the remaining nodes
+     */
+    removeNode(id) {
+        const node = this.nodes.get(id);
+        if (!node) return false;
+        this.nodes.delete(id);
+        for (const [host, owner] of this._affinity) {
+            if (owner === id) this._affinity.delete(host);
+        }
+        for (const shard of node.shards.values()) {
+            for (const item of shard.items) this.enqueue(item);
+        }
+        this.emit('node:left', { id, shards: node.shards.size });
+        return true;
+    }
+
+    /**
+     * Node that owns a host's shard
+     * @param {string} host
+     * @returns {string|null}
+     */
+    ownerFor(host) {
+        const pinned = this._affinity.get(host);
+        if (pinned && this.nodes.has(pinned)) return pinned;
+        let best = null;
+        let bestScore = -1;
+        for (const id of this.nodes.keys()) {
+            const score = rendezvousScore(id, host);
+            if (score > bestScore) {
+                best = id;
+                bestScore = score;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Add work to the owning node's host shard
+     * @param {string|Object|Array<string|Object>} items - URLs or request objects with a `url`
+     * @returns {number} Items queued
+     */
+    enqueue(items) {
+        const list = Array.isArray(items) ? items : [items];
+        let queued = 0;
+        for (const raw of list) {
+            const item = typeof raw === 'string' ? { url: raw } : raw;
+            const host = hostOf(item && item.url);
+            const ownerId = host ? this.ownerFor(host) : null;
+            if (!ownerId) continue;
+            const node = this.nodes.get(ownerId);
+            let shard = node.shards.get(host);
+            if (!shard) {
+                shard = { host, items: [] };
+                node.shards.set(host, shard);
+            }
+            shard.items.push(item);
+            node.pending++;
+            queued++;
+        }
+        return queued;
+    }
+
+    /**
+     * Take up to `limit` items for a node, honouring global host politeness.
+     * Steals from a loaded peer when the node has nothing queued.
+     *
+     * @param {string} nodeId
+     * @param {number} [limit=batchSize]
+     * @returns {Object[]} Items (each leased until complete())
+     */
+    take(nodeId, limit = this.batchSize) {
+        const node = this.nodes.get(nodeId);
+        if (!node) return [];
+        if (node.pending === 0) this.steal(nodeId);
+
+        const now = this.now();
+        const taken = [];
+        let progressed = true;
+        // Round-robin across hosts so one deep shard does not starve the rest
+        while (taken.length < limit && progressed) {
+            progressed = false;
+            for (const [host, shard] of node.shards) {
+                if (taken.length >= limit) break;
+                if (shard.items.length === 0) {
+                    node.shards.delete(host);
+                    continue;
+                }
+                const gate = this._gate(host);
+                if (gate.inFlight >= this.maxInFlightPerHost) continue;
+                if (this.minHostDelayMs > 0 && now - gate.lastDispatchAt < this.minHostDelayMs) continue;
+
+                const item = shard.items.shift();
+                gate.inFlight++;
+                gate.lastDispatchAt = now;
+                node.pending--;
+                node.inFlight++;
+                node.stats.dispatched++;
+                taken.push(item);
+                progressed = true;
+                if (shard.items.length === 0) node.shards.delete(host);
+            }
+        }
+        return taken;
+    }
+
+    /**
+     * Release an item's host slot and record the outcome
+     * @param {string} nodeId
+     * @param {Object|string} item
+     * @param {{ok?: boolean}} [result]
+     */
+    complete(nodeId, item, result = {}) {
+        const host = hostOf(typeof item === 'string' ? item : item && item.url);
+        const gate = this._hosts.get(host);
+        if (gate && gate.inFlight > 0) gate.inFlight--;
+        if (gate && gate.inFlight === 0 && this.minHostDelayMs === 0) this._hosts.delete(host);
+        const node = this.nodes.get(nodeId);
+        if (!node) return;
+        node.inFlight = Math.max(0, node.inFlight - 1);
+        if (result.ok === false) node.stats.failed++;
+        else node.stats.completed++;
+        const now = this.now();
+        node.stats.recent.push(now);
+        const cutoff = now - this.throughputWindowMs;
+        while (node.stats.recent.length > 0 && node.stats.recent[0] < cutoff) node.stats.recent.shift();
+    }
+
+    /**
+     * Move whole host shards from the most loaded peer to an idle node
+     * @param {string} thiefId
+     * @returns {string[]} Hosts moved
+     */
+    steal(thiefId) {
+        const thief = this.nodes.get(thiefId);
+        if (!thief) return [];
+        let victim = null;
+        for (const node of this.nodes.values()) {
+            if (node.id === thiefId || node.shards.size < 2) continue;
+            if (!victim || node.pending > victim.pending) victim = node;
+        }
+        if (!victim || victim.pending - thief.pending < this.stealThreshold) return [];
+
+        // Largest shards first, until the thief holds about half the victim's backlog
+        const shards = Array.from(victim.shards.values())
+            .filter(shard => shard.items.length > 0)
+            .sort((a, b) => b.items.length - a.items.length);
+        const target = Math.floor(victim.pending / 2);
+        const moved = [];
+        let movedItems = 0;
+        for (const shard of shards) {
+            if (moved.length >= this.maxStealShards || movedItems >= target) break;
+            if (victim.shards.size - moved.length <= 1) break;   // victim keeps at least one shard
+            moved.push(shard.host);
+            movedItems += shard.items.length;
+        }
+        if (moved.length === 0) return [];
+
+        for (const host of moved) {
+            const shard = victim.shards.get(host);
+            victim.shards.delete(host);
+            victim.pending -= shard.items.length;
+            const existing = thief.shards.get(host);
+            if (existing) existing.items.push(...shard.items);
+            else thief.shards.set(host, shard);
+            thief.pending += shard.items.length;
+            this._affinity.set(host, thiefId);
+        }
+        thief.stats.steals++;
+        thief.stats.shardsStolen += moved.length;
+        victim.stats.shardsLost += moved.length;
+        this.emit('shards:stolen', { thief: thiefId, victim: victim.id, hosts: moved, items: movedItems });
+        return moved;
+    }
+
+    /**
+     * Run a set of requests to completion across all nodes. Each node loops
+     * take() -> fetchForNode() -> complete(); idle nodes steal shards.
+     *
+     * @param {Object[]} requests - Request objects with a `url`
+     * @param {(nodeId: string, batch: Object[]) => Promise<Object[]>} fetchForNode - Returns one result per request
+     * @param {Object} [options]
+     * @param {number} [options.batchSize=batchSize]
+     * @param {(result: Object) => boolean} [options.isOk] - Result success predicate for throughput stats
+     * @returns {Promise<Object[]>} Results in completion order
+     */
+    async dispatch(requests, fetchForNode, options = {}) {
+        if (this.nodes.size === 0) {
+            throw new Error('HostShardScheduler.dispatch requires at least one node');
+        }
+        const batchSize = options.batchSize || this.batchSize;
+        const isOk = options.isOk || (result => !result || result.ok !== false);
+        const results = [];
+        let outstanding = this.enqueue(requests);
+
+        const runNode = async (nodeId) => {
+            while (outstanding > 0 && this.nodes.has(nodeId)) {
+                const batch = this.take(nodeId, batchSize);
+                if (batch.length === 0) {
+                    // Nothing ready for this node: host gates are busy or all work is leased elsewhere
+                    if (this._totalPending() === 0) return;
+                    await new Promise(resolve => setTimeout(resolve, Math.max(10, Math.min(this.minHostDelayMs || 10, 250))));
+                    continue;
+                }
+                let batchResults;
+                try {
+                    batchResults = await fetchForNode(nodeId, batch);
+                } catch (err) {
+                    batchResults = batch.map(item => ({ url: item.url, ok: false, error: err.message }));
+                }
+                batch.forEach((item, i) => {
+                    const result = batchResults && batchResults[i];
+                    this.complete(nodeId, item, { ok: isOk(result) });
+                    results.push(result || { url: item.url, ok: false, error: 'missing result' });
+                    outstanding--;
+                });
+            }
+        };
+
+        await Promise.all(Array.from(this.nodes.keys()).map(runNode));
+        return results;
+    }
+
+    /**
+     * Per-node queue depth, throughput and steal counts
+     * @returns {Object}
+     */
+    getStats() {
+        const now = this.now();
+        const cutoff = now - this.throughputWindowMs;
+        const nodes = [];
+        let pending = 0;
+        let steals = 0;
+        for (const node of this.nodes.values()) {
+            const recent = node.stats.recent.filter(t => t >= cutoff).length;
+            pending += node.pending;
+            steals += node.stats.steals;
+            nodes.push({
+                nodeId: node.id,
+                shards: node.shards.size,
+                pending: node.pending,
+                inFlight: node.inFlight,
+                dispatched: node.stats.dispatched,
+                completed: node.stats.completed,
+                failed: node.stats.failed,
+                throughputPerMin: Math.round(recent * (60000 / this.throughputWindowMs) * 10) / 10,
+                steals: node.stats.steals,
+                shardsStolen: node.stats.shardsStolen,
+                shardsLost: node.stats.shardsLost,
+            });
+        }
+        return {
+            nodes,
+            totals: {
+                nodes: this.nodes.size,
+                pending,
+                steals,
+                pinnedHosts: this._affinity.size,
+                busyHosts: Array.from(this._hosts.values()).filter(g => g.inFlight > 0).length,
+            },
+        };
+    }
+
+    _gate(host) {
+        let gate = this._hosts.get(host);
+        if (!gate) {
+            gate = { inFlight: 0, lastDispatchAt: 0 };
+            this._hosts.set(host, gate);
+        }
+        return gate;
+    }
+
+    _totalPending() {
+        let total = 0;
+        for (const node of this.nodes.values()) total += node.pending;
+        return total;
+    }
+}
+
+module.exports = {
+    HostShardScheduler,
+    DEFAULT_OPTIONS,
+};
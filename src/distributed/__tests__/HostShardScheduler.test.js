@@ -0,0 +1,116 @@
+'use strict';
+
+const EventEmitter = require('events');
+const { HostShardScheduler } = require('../HostShardScheduler');
+
+function urlsFor(host, count) {
+    return Array.from({ length: count }, (_, i) => `https://${host}/a/${i}`);
+}
+
+describe('HostShardScheduler', () => {
+    test('keeps every URL of a host on one node', () => {
+        const scheduler = new HostShardScheduler({ nodes: ['n1', 'n2', 'n3'] });
+        const hosts = Array.from({ length: 30 }, (_, i) => `site${i}.example`);
+        hosts.forEach(host => scheduler.enqueue(urlsFor(host, 3)));
+
+        for (const host of hosts) {
+            const holders = Array.from(scheduler.nodes.values()).filter(n => n.shards.has(host));
+            expect(holders).toHaveLength(1);
+            expect(holders[0].id).toBe(scheduler.ownerFor(host));
+        }
+        expect(scheduler.getStats().totals.pending).toBe(90);
+        expect(scheduler.getStats().nodes.every(n => n.shards > 0)).toBe(true);
+    });
+
+    test('idle node steals whole host shards and takes ownership', () => {
+        const scheduler = new HostShardScheduler({ nodes: ['busy', 'idle'] });
+        // Pin four hosts to the busy node
+        const hosts = ['a.example', 'b.example', 'c.example', 'd.example'];
+        hosts.forEach(host => scheduler._affinity.set(host, 'busy'));
+        hosts.forEach((host, i) => scheduler.enqueue(urlsFor(host, 2 + i)));
+
+        const batch = scheduler.take('idle', 100);
+        const idleHosts = new Set(batch.map(item => new URL(item.url).hostname));
+        expect(idleHosts.size).toBeGreaterThan(0);
+        for (const host of idleHosts) {
+            expect(scheduler.nodes.get('busy').shards.has(host)).toBe(false);
+            expect(scheduler.ownerFor(host)).toBe('idle');
+        }
+
+        const stats = scheduler.getStats();
+        const idle = stats.nodes.find(n => n.nodeId === 'idle');
+        const busy = stats.nodes.find(n => n.nodeId === 'busy');
+        expect(idle).toMatchObject({ steals: 1 });
+        expect(busy.shardsLost).toBe(idle.shardsStolen);
+        expect(busy.shards).toBeGreaterThan(0);
+
+        // New URLs for a stolen host follow the shard
+        const [stolenHost] = idleHosts;
+        scheduler.enqueue(`https://${stolenHost}/late`);
+        expect(scheduler.nodes.get('idle').shards.has(stolenHost)).toBe(true);
+    });
+
+    test('host politeness is global across nodes', () => {
+        let now = 1000;
+        const scheduler = new HostShardScheduler({
+            nodes: ['n1', 'n2'],
+            maxInFlightPerHost: 1,
+            minHostDelayMs: 500,
+            stealThreshold: 0,
+            now: () => now
+        });
+        scheduler._affinity.set('slow.example', 'n1');
+        scheduler._affinity.set('other.example', 'n1');
+        scheduler.enqueue([...urlsFor('slow.example', 3), ...urlsFor('other.example', 1)]);
+
+        const first = scheduler.take('n1', 10);
+        expect(first.map(item => new URL(item.url).hostname).sort()).toEqual(['other.example', 'slow.example']);
+        // n2 may steal the shard, but the host is still busy/in its delay window
+        const stolen = scheduler.take('n2', 10);
+        expect(stolen).toHaveLength(0);
+
+        scheduler.complete('n1', first[0], { ok: true });
+        scheduler.complete('n1', first[1], { ok: true });
+        expect(scheduler.take('n2', 10)).toHaveLength(0);
+        now += 500;
+        const next = [...scheduler.take('n1', 10), ...scheduler.take('n2', 10)];
+        expect(next).toHaveLength(1);
+    });
+
+    test('dispatch finishes all work and reports per-node throughput', async () => {
+        const scheduler = new HostShardScheduler({ nodes: ['fast', 'slow'] });
+        const requests = [];
+        for (let i = 0; i < 8; i++) {
+            urlsFor(`host${i}.example`, 4).forEach(url => requests.push({ url, method: 'GET' }));
+        }
+        const results = await scheduler.dispatch(requests, async (nodeId, batch) => {
+            await new Promise(resolve => setTimeout(resolve, nodeId === 'slow' ? 15 : 1));
+            return batch.map(req => ({ url: req.url, ok: true, node: nodeId }));
+        }, { batchSize: 4 });
+
+        expect(results).toHaveLength(32);
+        expect(new Set(results.map(r => r.url)).size).toBe(32);
+        const stats = scheduler.getStats();
+        expect(stats.totals.pending).toBe(0);
+        expect(stats.nodes.reduce((sum, n) => sum + n.completed, 0)).toBe(32);
+        expect(stats.nodes.every(n => n.throughputPerMin >= 0)).toBe(true);
+    });
+
+    test('follows registry membership', () => {
+        const registry = Object.assign(new EventEmitter(), {
+            listEnabledNodes: () => [{ id: 'n1', enabled: true }, { id: 'n2', enabled: true }],
+            getNode: (id) => ({ id, enabled: true })
+        });
+        const scheduler = new HostShardScheduler({ registry });
+        scheduler.enqueue(Array.from({ length: 20 }, (_, i) => `https://h${i}.example/`));
+
+        registry.emit('health:updated', { id: 'n2', healthy: false });
+        expect(scheduler.nodes.has('n2')).toBe(false);
+        expect(scheduler.getStats().totals).toMatchObject({ nodes: 1, pending: 20 });
+
+        registry.emit('health:updated', { id: 'n2', healthy: true });
+        expect(scheduler.nodes.has('n2')).toBe(true);
+        scheduler.detach();
+        expect(registry.listenerCount('health:updated')).toBe(0);
+    });
+});
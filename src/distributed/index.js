@@ -7,6 +7,7 @@
  */
 
 const { NodeRegistry, getNodeRegistry, createNodeRegistry } = require('./NodeRegistry');
+const { HostShardScheduler } = require('./HostShardScheduler');
 const { config, isDistributedEnabled, getConfig, parseBoolean } = require('./config');
 
 module.exports = {
@@ -15,6 +16,9 @@ module.exports = {
     getNodeRegistry,
     createNodeRegistry,
 
+    // Host-affinity scheduling with work stealing
+    HostShardScheduler,
+
     // Configuration
     config,
     isDistributedEnabled,
@@ -0,0 +1,643 @@
+'use strict';
+
+/**
+ * GazetteerArtifact - Read-only binary image of gazetteer matchers
+ *
+ * buildGazetteerMatchers() gives every process its own nameMap, slugMap,
+ * placeIndex and hierarchy Maps, with one JS object per place and per edge.
+ * An artifact holds the same data as flat columns in one (Shared)ArrayBuffer:
+ * - a string table (offsets + UTF-8 bytes) for every name, slug, kind and code;
+ * - place columns sorted by id (binary search replaces the placeIndex Map),
+ *   with list ranges for names, slugs, synonyms and nameOrder;
+ * - nameMap and slugMap as open-addressing hash tables over FNV-1a key hashes,
+ *   with CSR postings holding place ordinals;
+ * - parent and child edges per place in CSR form;
+ * - topic tokens and the serialized name automaton.
+ *
+ * Reading goes straight to the columns. A place record is decoded the first
+ * time it is returned and cached, so a process only pays heap for the places
+ * its texts mention. The buffer is never written after build, so a
+ * SharedArrayBuffer copy can be handed to any number of worker threads.
+ *
+ * Layout (little endian, every section 8-byte aligned):
+ *   header   64 bytes: magic "GAZMATC1", u32 version, u32 placeCount,
+ *            u32 stringCount, u32 sectionCount, u32 fingerprintBytes,
+ *            u32 reserved, f64 createdAt
+ *   fingerprint  UTF-8, padded to 8 bytes
+ *   sections sectionCount x (f64 offset, f64 byteLength)
+ *   data     see SECTIONS
+ *
+ * @module GazetteerArtifact
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { serializeAutomaton, deserializeAutomaton } = require('./gazetteer-serialization');
+
+const MAGIC = 'GAZMATC1';
+const VERSION = 1;
+const HEADER_BYTES = 64;
+const SECTION_ENTRY_BYTES = 16;
+const NONE = 0xFFFFFFFF;
+// Per-place string columns and list columns, in storage order
+const PLACE_STRINGS = ['kind', 'country_code', 'name', 'canonicalSlug'];
+const PLACE_LISTS = ['names', 'slugs', 'synonyms', 'nameOrder'];
+
+const SECTIONS = [
+  'stringOffsets', 'stringBytes',
+  'placeIds', 'placePopulation', 'placeStrings', 'listOffsets', 'listValues',
+  'nameSlots', 'nameHashes', 'nameKeys', 'nameOffsets', 'namePostings',
+  'slugSlots', 'slugHashes', 'slugKeys', 'slugOffsets', 'slugPostings',
+  'parentOffsets', 'parentOrdinals', 'parentRelations', 'parentDepths',
+  'childOffsets', 'childOrdinals', 'childRelations', 'childDepths',
+  'topicTokens', 'automaton'
+];
+
+function align8(n) {
+  return Math.ceil(n / 8) * 8;
+}
+
+/**
+ * FNV-1a over UTF-16 code units
+ * @param {string} value
+ * @returns {number} u32
+ */
+function hashKey(value) {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < value.length; i++) {
+    hash ^= value.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return hash >>> 0;
+}
+
+function toBytes(array) {
+  return Buffer.from(array.buffer, array.byteOffset, array.byteLength);
+}
+
+/**
+ * Hash table + CSR postings for a key -> records Map
+ */
+function encodeRecordMap(map, intern, ordinals) {
+  const keys = Array.from(map.keys()).filter((key) => map.get(key) && map.get(key).length);
+  let capacity = 8;
+  while (capacity < keys.length * 2) capacity *= 2;
+  const slots = new Uint32Array(capacity);
+  const hashes = new Uint32Array(keys.length);
+  const keyStrings = new Uint32Array(keys.length);
+  const offsets = new Uint32Array(keys.length + 1);
+  const postings = [];
+  keys.forEach((key, entry) => {
+    const hash = hashKey(key);
+    hashes[entry] = hash;
+    keyStrings[entry] = intern(key);
+    for (const record of map.get(key)) postings.push(ordinals.get(record.id));
+    offsets[entry + 1] = postings.length;
+    let slot = hash & (capacity - 1);
+    while (slots[slot] !== 0) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = entry + 1;
+  });
+  return [slots, hashes, keyStrings, offsets, Uint32Array.from(postings)];
+}
+
+function encodeEdges(edgeMap, placeIds, ordinals, intern, idField) {
+  const offsets = new Uint32Array(placeIds.length + 1);
+  const targets = [];
+  const relations = [];
+  const depths = [];
+  placeIds.forEach((id, ordinal) => {
+    for (const edge of (edgeMap && edgeMap.get(id)) || []) {
+      const target = ordinals.get(edge[idField]);
+      if (target === undefined) continue;
+      targets.push(target);
+      relations.push(edge.relation ? intern(edge.relation) : NONE);
+      depths.push(edge.depth === null || edge.depth === undefined ? NaN : edge.depth);
+    }
+    offsets[ordinal + 1] = targets.length;
+  });
+  return [offsets, Uint32Array.from(targets), Uint32Array.from(relations), Float64Array.from(depths)];
+}
+
+class GazetteerArtifact {
+  /**
+   * @private Use GazetteerArtifact.fromBuffer
+   */
+  constructor(fields) {
+    Object.assign(this, fields);
+    this._records = new Array(this.placeCount);
+    this._strings = new Array(this.stringCount);
+  }
+
+  /**
+   * Serialize gazetteer matchers
+   *
+   * @param {Object} matchers - Result of buildGazetteerMatchers
+   * @param {Object} [options]
+   * @param {string} [options.fingerprint=''] - Identifies the gazetteer DB state the matchers were built from
+   * @returns {Buffer}
+   */
+  static build(matchers, options = {}) {
+    const fingerprint = Buffer.from(String(options.fingerprint || ''), 'utf8');
+    const records = Array.from(matchers.placeIndex.values()).sort((a, b) => a.id - b.id);
+    const placeIds = records.map((record) => record.id);
+    const ordinals = new Map(placeIds.map((id, ordinal) => [id, ordinal]));
+
+    const strings = [];
+    const stringIds = new Map();
+    const intern = (value) => {
+      const key = String(value);
+      let id = stringIds.get(key);
+      if (id === undefined) {
+        id = strings.length;
+        stringIds.set(key, id);
+        strings.push(key);
+      }
+      return id;
+    };
+
+    const placeStrings = new Uint32Array(records.length * PLACE_STRINGS.length);
+    const listOffsets = new Uint32Array(records.length * PLACE_LISTS.length + 1);
+    const listValues = [];
+    records.forEach((record, ordinal) => {
+      PLACE_STRINGS.forEach((field, column) => {
+        const value = record[field];
+        placeStrings[ordinal * PLACE_STRINGS.length + column] = value === null || value === undefined ? NONE : intern(value);
+      });
+      PLACE_LISTS.forEach((field, column) => {
+        for (const value of record[field] || []) listValues.push(intern(value));
+        listOffsets[ordinal * PLACE_LISTS.length + column + 1] = listValues.length;
+      });
+    });
+
+    const hierarchy = matchers.hierarchy || {};
+    const columns = {
+      placeIds: Float64Array.from(placeIds),
+      placePopulation: Float64Array.from(records, (record) => Number(record.population) || 0),
+      placeStrings,
+      listOffsets,
+      listValues: Uint32Array.from(listValues)
+    };
+    [columns.nameSlots, columns.nameHashes, columns.nameKeys, columns.nameOffsets, columns.namePostings] =
+      encodeRecordMap(matchers.nameMap, intern, ordinals);
+    [columns.slugSlots, columns.slugHashes, columns.slugKeys, columns.slugOffsets, columns.slugPostings] =
+      encodeRecordMap(matchers.slugMap, intern, ordinals);
+    [columns.parentOffsets, columns.parentOrdinals, columns.parentRelations, columns.parentDepths] =
+      encodeEdges(hierarchy.parents, placeIds, ordinals, intern, 'parentId');
+    [columns.childOffsets, columns.childOrdinals, columns.childRelations, columns.childDepths] =
+      encodeEdges(hierarchy.children, placeIds, ordinals, intern, 'childId');
+    columns.topicTokens = Uint32Array.from(matchers.topicTokens || [], intern);
+    columns.automaton = matchers.automaton ? serializeAutomaton(matchers.automaton) : Buffer.alloc(0);
+
+    // String table last: everything above may have interned more strings
+    const encoded = strings.map((value) => Buffer.from(value, 'utf8'));
+    columns.stringOffsets = new Uint32Array(encoded.length + 1);
+    encoded.forEach((bytes, i) => {
+      columns.stringOffsets[i + 1] = columns.stringOffsets[i] + bytes.length;
+    });
+    columns.stringBytes = Buffer.concat(encoded);
+
+    const sectionTableAt = HEADER_BYTES + align8(fingerprint.length);
+    let offset = align8(sectionTableAt + SECTIONS.length * SECTION_ENTRY_BYTES);
+    const placements = SECTIONS.map((name) => {
+      const bytes = toBytes(columns[name]);
+      const placement = { bytes, offset };
+      offset = align8(offset + bytes.length);
+      return placement;
+    });
+
+    const buffer = Buffer.alloc(offset);
+    buffer.write(MAGIC, 0, 'latin1');
+    buffer.writeUInt32LE(VERSION, 8);
+    buffer.writeUInt32LE(records.length, 12);
+    buffer.writeUInt32LE(strings.length, 16);
+    buffer.writeUInt32LE(SECTIONS.length, 20);
+    buffer.writeUInt32LE(fingerprint.length, 24);
+    buffer.writeDoubleLE(Date.now(), 32);
+    fingerprint.copy(buffer, HEADER_BYTES);
+    placements.forEach((placement, i) => {
+      buffer.writeDoubleLE(placement.offset, sectionTableAt + i * SECTION_ENTRY_BYTES);
+      buffer.writeDoubleLE(placement.bytes.length, sectionTableAt + i * SECTION_ENTRY_BYTES + 8);
+      placement.bytes.copy(buffer, placement.offset);
+    });
+    return buffer;
+  }
+
+  /**
+   * Header fields without touching the sections
+   * @param {Buffer} buffer - At least the header and fingerprint
+   * @returns {{version: number, placeCount: number, fingerprint: string, createdAt: number, headerBytes: number}}
+   */
+  static readHeader(buffer) {
+    if (!buffer || buffer.length < HEADER_BYTES || buffer.toString('latin1', 0, 8) !== MAGIC) {
+      throw new Error('Not a gazetteer artifact');
+    }
+    const version = buffer.readUInt32LE(8);
+    if (version !== VERSION) {
+      throw new Error(`Unsupported gazetteer artifact version ${version}`);
+    }
+    const fingerprintBytes = buffer.readUInt32LE(24);
+    if (buffer.length < HEADER_BYTES + fingerprintBytes) {
+      throw new Error('Gazetteer artifact is truncated');
+    }
+    return {
+      version,
+      placeCount: buffer.readUInt32LE(12),
+      stringCount: buffer.readUInt32LE(16),
+      sectionCount: buffer.readUInt32LE(20),
+      fingerprint: buffer.toString('utf8', HEADER_BYTES, HEADER_BYTES + fingerprintBytes),
+      createdAt: buffer.readDoubleLE(32),
+      headerBytes: HEADER_BYTES + align8(fingerprintBytes)
+    };
+  }
+
+  /**
+   * Wrap serialized bytes. Columns are views of the buffer, not copies.
+   * @param {Buffer|ArrayBuffer|SharedArrayBuffer} source
+   * @returns {GazetteerArtifact}
+   */
+  static fromBuffer(source) {
+    let buffer = Buffer.isBuffer(source) ? source : Buffer.from(source);
+    const header = GazetteerArtifact.readHeader(buffer);
+    if (header.sectionCount !== SECTIONS.length) {
+      throw new Error('Gazetteer artifact section table does not match this version');
+    }
+    // Typed array views need aligned offsets; copy once if handed a misaligned slice
+    if (buffer.byteOffset % 8 !== 0) buffer = Buffer.from(buffer);
+
+    const fields = { ...header, buffer };
+    const types = {
+      stringBytes: Uint8Array,
+      placeIds: Float64Array,
+      placePopulation: Float64Array,
+      parentDepths: Float64Array,
+      childDepths: Float64Array,
+      automaton: null
+    };
+    SECTIONS.forEach((name, i) => {
+      const at = header.headerBytes + i * SECTION_ENTRY_BYTES;
+      const offset = buffer.readDoubleLE(at);
+      const byteLength = buffer.readDoubleLE(at + 8);
+      if (offset + byteLength > buffer.length) {
+        throw new Error('Gazetteer artifact is truncated');
+      }
+      const Type = name in types ? types[name] : Uint32Array;
+      fields[name] = Type
+        ? new Type(buffer.buffer, buffer.byteOffset + offset, byteLength / Type.BYTES_PER_ELEMENT)
+        : buffer.subarray(offset, offset + byteLength);
+    });
+    return new GazetteerArtifact(fields);
+  }
+
+  /**
+   * Read an artifact file in one read, into a SharedArrayBuffer by default so
+   * `artifact.buffer.buffer` can be posted to worker threads without copying
+   *
+   * @param {string} filePath
+   * @param {Object} [options]
+   * @param {boolean} [options.shared=true]
+   * @returns {GazetteerArtifact}
+   */
+  static load(filePath, options = {}) {
+    const fd = fs.openSync(filePath, 'r');
+    try {
+      const size = fs.fstatSync(fd).size;
+      const bytes = options.shared === false
+        ? Buffer.allocUnsafe(size)
+        : Buffer.from(new SharedArrayBuffer(size));
+      let read = 0;
+      while (read < size) {
+        const n = fs.readSync(fd, bytes, read, size - read, read);
+        if (n === 0) break;
+        read += n;
+      }
+      return GazetteerArtifact.fromBuffer(bytes.subarray(0, read));
+    } finally {
+      fs.closeSync(fd);
+    }
+  }
+
+  /**
+   * Header of an artifact file (reads only the first few hundred bytes)
+   * @param {string} filePath
+   * @returns {Object|null} readHeader() fields, or null if missing or unreadable
+   */
+  static readFileHeader(filePath) {
+    let fd;
+    try {
+      fd = fs.openSync(filePath, 'r');
+      const head = Buffer.alloc(HEADER_BYTES);
+      if (fs.readSync(fd, head, 0, HEADER_BYTES, 0) < HEADER_BYTES) return null;
+      const fingerprintBytes = head.readUInt32LE(24);
+      const full = Buffer.alloc(HEADER_BYTES + fingerprintBytes);
+      fs.readSync(fd, full, 0, full.length, 0);
+      return GazetteerArtifact.readHeader(full);
+    } catch (_) {
+      return null;
+    } finally {
+      if (fd !== undefined) fs.closeSync(fd);
+    }
+  }
+
+  /**
+   * Write artifact bytes atomically (temp file + rename)
+   * @param {string} filePath
+   * @param {Buffer} bytes
+   */
+  static save(filePath, bytes) {
+    fs.mkdirSync(path.dirname(filePath), { recursive: true });
+    const tmpPath = `${filePath}.${process.pid}.tmp`;
+    fs.writeFileSync(tmpPath, bytes);
+    fs.renameSync(tmpPath, filePath);
+  }
+
+  /**
+   * @param {number} index
+   * @returns {string|null}
+   */
+  string(index) {
+    if (index === NONE) return null;
+    let value = this._strings[index];
+    if (value === undefined) {
+      const start = this.stringOffsets[index];
+      const end = this.stringOffsets[index + 1];
+      value = Buffer.from(this.stringBytes.buffer, this.stringBytes.byteOffset + start, end - start).toString('utf8');
+      this._strings[index] = value;
+    }
+    return value;
+  }
+
+  /**
+   * @param {number} id - Place id
+   * @returns {number} Ordinal, or -1
+   */
+  ordinalOf(id) {
+    let lo = 0;
+    let hi = this.placeCount - 1;
+    while (lo <= hi) {
+      const mid = (lo + hi) >>> 1;
+      const value = this.placeIds[mid];
+      if (value === id) return mid;
+      if (value < id) lo = mid + 1;
+      else hi = mid - 1;
+    }
+    return -1;
+  }
+
+  /**
+   * Place record in the shape buildGazetteerMatchers produces (decoded once, then cached)
+   * @param {number} ordinal
+   * @returns {Object}
+   */
+  record(ordinal) {
+    let record = this._records[ordinal];
+    if (record) return record;
+
+    const strings = PLACE_STRINGS.map((_, column) => this.string(this.placeStrings[ordinal * PLACE_STRINGS.length + column]));
+    const lists = PLACE_LISTS.map((_, column) => {
+      const at = ordinal * PLACE_LISTS.length + column;
+      const values = [];
+      for (let i = this.listOffsets[at]; i < this.listOffsets[at + 1]; i++) {
+        values.push(this.string(this.listValues[i]));
+      }
+      return values;
+    });
+    const id = this.placeIds[ordinal];
+    const [kind, countryCode, name, canonicalSlug] = strings;
+    const [names, slugs, synonyms, nameOrder] = lists;
+    record = {
+      id,
+      place_id: id,
+      kind,
+      country_code: countryCode,
+      countryCode,
+      population: this.placePopulation[ordinal],
+      names: new Set(names),
+      slugs: new Set(slugs),
+      synonyms,
+      nameOrder,
+      canonicalSlug,
+      name
+    };
+    this._records[ordinal] = record;
+    return record;
+  }
+
+  /**
+   * Records stored under a nameMap / slugMap key
+   * @param {'name'|'slug'} table
+   * @param {string} key
+   * @returns {Object[]|undefined}
+   */
+  lookup(table, key) {
+    const entry = this._findEntry(table, key);
+    if (entry === -1) return undefined;
+    const offsets = this[`${table}Offsets`];
+    const postings = this[`${table}Postings`];
+    const records = [];
+    for (let i = offsets[entry]; i < offsets[entry + 1]; i++) {
+      records.push(this.record(postings[i]));
+    }
+    return records;
+  }
+
+  /**
+   * @param {'name'|'slug'} table
+   * @returns {number} Distinct keys
+   */
+  keyCount(table) {
+    return this[`${table}Keys`].length;
+  }
+
+  /**
+   * @param {'name'|'slug'} table
+   * @param {number} entry
+   * @returns {string}
+   */
+  keyAt(table, entry) {
+    return this.string(this[`${table}Keys`][entry]);
+  }
+
+  /**
+   * Parent or child edges of a place, shaped like buildHierarchyIndex entries
+   * @param {'parent'|'child'} direction
+   * @param {number} id - Place id
+   * @returns {Object[]|undefined}
+   */
+  edges(direction, id) {
+    const ordinal = this.ordinalOf(id);
+    if (ordinal === -1) return undefined;
+    const offsets = this[`${direction}Offsets`];
+    const start = offsets[ordinal];
+    const end = offsets[ordinal + 1];
+    if (start === end) return undefined;
+    const targets = this[`${direction}Ordinals`];
+    const relations = this[`${direction}Relations`];
+    const depths = this[`${direction}Depths`];
+    const idField = direction === 'parent' ? 'parentId' : 'childId';
+    const result = [];
+    for (let i = start; i < end; i++) {
+      result.push({
+        [idField]: this.placeIds[targets[i]],
+        relation: this.string(relations[i]),
+        depth: Number.isNaN(depths[i]) ? null : depths[i]
+      });
+    }
+    return result;
+  }
+
+  /**
+   * @returns {Set<string>}
+   */
+  topicTokenSet() {
+    return new Set(Array.from(this.topicTokens, (index) => this.string(index)));
+  }
+
+  /**
+   * @returns {import('./GazetteerAutomaton').GazetteerAutomaton|null}
+   */
+  nameAutomaton() {
+    return this.automaton.length ? deserializeAutomaton(this.automaton) : null;
+  }
+
+  /**
+   * Map-like views in the shape buildGazetteerMatchers uses
+   * @returns {{nameMap: RecordMapView, slugMap: RecordMapView, placeIndex: PlaceIndexView, parents: EdgeMapView, children: EdgeMapView}}
+   */
+  views() {
+    return {
+      nameMap: new RecordMapView(this, 'name'),
+      slugMap: new RecordMapView(this, 'slug'),
+      placeIndex: new PlaceIndexView(this),
+      parents: new EdgeMapView(this, 'parent'),
+      children: new EdgeMapView(this, 'child')
+    };
+  }
+
+  /** @private */
+  _findEntry(table, key) {
+    if (typeof key !== 'string') return -1;
+    const slots = this[`${table}Slots`];
+    const hashes = this[`${table}Hashes`];
+    const mask = slots.length - 1;
+    const hash = hashKey(key);
+    let slot = hash & mask;
+    while (slots[slot] !== 0) {
+      const entry = slots[slot] - 1;
+      if (hashes[entry] === hash && this.keyAt(table, entry) === key) return entry;
+      slot = (slot + 1) & mask;
+    }
+    return -1;
+  }
+}
+
+/**
+ * Read-only Map view of the artifact's nameMap or slugMap
+ */
+class RecordMapView {
+  constructor(artifact, table) {
+    this.artifact = artifact;
+    this.table = table;
+  }
+
+  get size() {
+    return this.artifact.keyCount(this.table);
+  }
+
+  get(key) {
+    return this.artifact.lookup(this.table, key);
+  }
+
+  has(key) {
+    return this.artifact._findEntry(this.table, key) !== -1;
+  }
+
+  *keys() {
+    for (let entry = 0; entry < this.size; entry++) yield this.artifact.keyAt(this.table, entry);
+  }
+
+  *values() {
+    for (const key of this.keys()) yield this.get(key);
+  }
+
+  *entries() {
+    for (const key of this.keys()) yield [key, this.get(key)];
+  }
+
+  [Symbol.iterator]() {
+    return this.entries();
+  }
+
+  forEach(fn, thisArg) {
+    for (const [key, value] of this.entries()) fn.call(thisArg, value, key, this);
+  }
+}
+
+/**
+ * Read-only Map view of placeIndex (id -> record)
+ */
+class PlaceIndexView {
+  constructor(artifact) {
+    this.artifact = artifact;
+  }
+
+  get size() {
+    return this.artifact.placeCount;
+  }
+
+  get(id) {
+    const ordinal = this.artifact.ordinalOf(id);
+    return ordinal === -1 ? undefined : this.artifact.record(ordinal);
+  }
+
+  has(id) {
+    return this.artifact.ordinalOf(id) !== -1;
+  }
+
+  *keys() {
+    for (let ordinal = 0; ordinal < this.size; ordinal++) yield this.artifact.placeIds[ordinal];
+  }
+
+  *values() {
+    for (let ordinal = 0; ordinal < this.size; ordinal++) yield this.artifact.record(ordinal);
+  }
+
+  *entries() {
+    for (let ordinal = 0; ordinal < this.size; ordinal++) {
+      yield [this.artifact.placeIds[ordinal], this.artifact.record(ordinal)];
+    }
+  }
+
+  [Symbol.iterator]() {
+    return this.entries();
+  }
+
+  forEach(fn, thisArg) {
+    for (const [key, value] of this.entries()) fn.call(thisArg, value, key, this);
+  }
+}
+
+/**
+ * Read-only Map view of hierarchy parents / children (id -> edges)
+ */
+class EdgeMapView {
+  constructor(artifact, direction) {
+    this.artifact = artifact;
+    this.direction = direction;
+  }
+
+  get(id) {
+    return this.artifact.edges(this.direction, id);
+  }
+
+  has(id) {
+    return this.get(id) !== undefined;
+  }
+}
+
+module.exports = {
+  GazetteerArtifact,
+  RecordMapView,
+  PlaceIndexView,
+  EdgeMapView,
+  hashKey
+};
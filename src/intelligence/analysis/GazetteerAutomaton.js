@@ -0,0 +1,288 @@
+'use strict';
+
+/**
+ * GazetteerAutomaton - Aho–Corasick matcher over gazetteer place names
+ *
+ * extractGazetteerPlacesFromText used to probe nameMap with every 1..4 token
+ * window of the text: four string concatenations and Map lookups per token.
+ * This automaton runs over the same token stream instead. Its alphabet is
+ * the set of words occurring in place names. Its patterns are the nameMap
+ * keys that a token window can produce: at most MAX_NAME_TOKENS words, each
+ * shaped like a token. One pass over the tokens reports every name that
+ * ends at each position.
+ *
+ * The trie is stored in CSR form (per-node sorted edge ranges) with fail and
+ * dictionary-suffix links, so it can be serialized as flat typed arrays (see
+ * gazetteer-serialization.js) and scanned without per-node objects.
+ *
+ * @module GazetteerAutomaton
+ */
+
+// Same window the n-gram probe used
+const MAX_NAME_TOKENS = 4;
+// normName() of a text token always has this shape; other keys can never match
+const TOKEN_SHAPE = /^[a-z][a-z'\-]*$/;
+const TOKEN_REGEX = /[A-Za-z][A-Za-z'\-]*/g;
+
+const ROOT = 0;
+
+class GazetteerAutomaton {
+  /**
+   * @private Use GazetteerAutomaton.fromNameMap / gazetteer-serialization
+   * @param {Object} fields
+   * @param {string[]} fields.vocab - Word id -> word
+   * @param {string[]} fields.keys - Pattern id -> nameMap key
+   * @param {Uint32Array} fields.edgeOffsets - Node -> first edge (nodeCount + 1)
+   * @param {Uint32Array} fields.edgeWords - Edge word ids, sorted within each node
+   * @param {Uint32Array} fields.edgeTargets - Edge target nodes
+   * @param {Uint32Array} fields.fail - Fail link per node
+   * @param {Int32Array} fields.output - Next pattern node on the fail chain, or -1
+   * @param {Uint8Array} fields.depth - Words from the root per node
+   * @param {Int32Array} fields.keyIndex - Pattern id ending at the node, or -1
+   */
+  constructor(fields) {
+    Object.assign(this, fields);
+    this.nodeCount = this.depth.length;
+    this.wordIds = new Map();
+    for (let i = 0; i < this.vocab.length; i++) {
+      this.wordIds.set(this.vocab[i], i);
+    }
+  }
+
+  /**
+   * Build the automaton from a nameMap (normalized name -> place records)
+   * @param {Map<string, Array>|Iterable<string>} nameMap - Map, or an iterable of keys
+   * @returns {GazetteerAutomaton}
+   */
+  static fromNameMap(nameMap) {
+    const names = nameMap instanceof Map ? nameMap.keys() : nameMap;
+    const wordIds = new Map();
+    const vocab = [];
+    const keys = [];
+    // Build-time trie: one Map of word id -> child per node
+    const children = [new Map()];
+    const depth = [0];
+    const keyIndex = [-1];
+
+    for (const key of names) {
+      const words = key ? key.split(' ') : [];
+      if (!words.length || words.length > MAX_NAME_TOKENS) continue;
+      if (!words.every((word) => TOKEN_SHAPE.test(word))) continue;
+
+      let node = ROOT;
+      for (const word of words) {
+        let id = wordIds.get(word);
+        if (id === undefined) {
+          id = vocab.length;
+          wordIds.set(word, id);
+          vocab.push(word);
+        }
+        let next = children[node].get(id);
+        if (next === undefined) {
+          next = children.length;
+          children.push(new Map());
+          depth.push(depth[node] + 1);
+          keyIndex.push(-1);
+          children[node].set(id, next);
+        }
+        node = next;
+      }
+      if (keyIndex[node] === -1) {
+        keyIndex[node] = keys.length;
+        keys.push(key);
+      }
+    }
+
+    const nodeCount = children.length;
+    const edgeOffsets = new Uint32Array(nodeCount + 1);
+    for (let node = 0; node < nodeCount; node++) {
+      edgeOffsets[node + 1] = edgeOffsets[node] + children[node].size;
+    }
+    const edgeWords = new Uint32Array(edgeOffsets[nodeCount]);
+    const edgeTargets = new Uint32Array(edgeOffsets[nodeCount]);
+    for (let node = 0; node < nodeCount; node++) {
+      const sorted = Array.from(children[node]).sort((a, b) => a[0] - b[0]);
+      let edge = edgeOffsets[node];
+      for (const [word, target] of sorted) {
+        edgeWords[edge] = word;
+        edgeTargets[edge] = target;
+        edge++;
+      }
+    }
+
+    const automaton = new GazetteerAutomaton({
+      vocab,
+      keys,
+      edgeOffsets,
+      edgeWords,
+      edgeTargets,
+      fail: new Uint32Array(nodeCount),
+      output: new Int32Array(nodeCount).fill(-1),
+      depth: Uint8Array.from(depth),
+      keyIndex: Int32Array.from(keyIndex)
+    });
+    automaton._linkFailures();
+    return automaton;
+  }
+
+  get keyCount() {
+    return this.keys.length;
+  }
+
+  /**
+   * Child of `node` over word id `word`
+   * @param {number} node
+   * @param {number} word
+   * @returns {number} Child node, or -1
+   */
+  next(node, word) {
+    let lo = this.edgeOffsets[node];
+    let hi = this.edgeOffsets[node + 1] - 1;
+    const words = this.edgeWords;
+    while (lo <= hi) {
+      const mid = (lo + hi) >>> 1;
+      const value = words[mid];
+      if (value === word) return this.edgeTargets[mid];
+      if (value < word) lo = mid + 1;
+      else hi = mid - 1;
+    }
+    return -1;
+  }
+
+  /**
+   * Longest name starting at each token
+   *
+   * @param {string[]} normalizedTokens - normName()'d text tokens
+   * @returns {{lengths: Uint8Array, keys: Int32Array}} Per start token: name length in tokens (0 = none) and pattern id
+   */
+  longestAt(normalizedTokens) {
+    const count = normalizedTokens.length;
+    const lengths = new Uint8Array(count);
+    const keys = new Int32Array(count).fill(-1);
+    let state = ROOT;
+
+    for (let i = 0; i < count; i++) {
+      const word = this.wordIds.get(normalizedTokens[i]);
+      if (word === undefined) {
+        state = ROOT;
+        continue;
+      }
+      let next = this.next(state, word);
+      while (next === -1 && state !== ROOT) {
+        state = this.fail[state];
+        next = this.next(state, word);
+      }
+      state = next === -1 ? ROOT : next;
+
+      let hit = this.keyIndex[state] !== -1 ? state : this.output[state];
+      while (hit !== -1) {
+        const length = this.depth[hit];
+        const start = i - length + 1;
+        if (length > lengths[start]) {
+          lengths[start] = length;
+          keys[start] = this.keyIndex[hit];
+        }
+        hit = this.output[hit];
+      }
+    }
+
+    return { lengths, keys };
+  }
+
+  /**
+   * Tokenize text and report non-overlapping names, leftmost first and longest
+   * at each start (the order the n-gram probe produced them in)
+   *
+   * @param {string} text
+   * @param {function(string): string} normalize - normName
+   * @returns {Array<{key: string, start: number, end: number}>}
+   */
+  scan(text, normalize) {
+    const results = [];
+    if (!text) return results;
+
+    const tokens = [];
+    const normalizedTokens = [];
+    TOKEN_REGEX.lastIndex = 0;
+    let match;
+    while ((match = TOKEN_REGEX.exec(text)) !== null) {
+      const normalized = normalize(match[0]);
+      if (!normalized) continue;
+      tokens.push(match.index, match.index + match[0].length);
+      normalizedTokens.push(normalized);
+    }
+
+    const { lengths, keys } = this.longestAt(normalizedTokens);
+    for (let i = 0; i < lengths.length; i++) {
+      const length = lengths[i];
+      if (!length) continue;
+      results.push({
+        key: this.keys[keys[i]],
+        start: tokens[i * 2],
+        end: tokens[(i + length - 1) * 2 + 1]
+      });
+      i += length - 1;
+    }
+    return results;
+  }
+
+  /**
+   * True if the automaton holds exactly the eligible keys of `nameMap`
+   * (used to decide whether a deserialized automaton can be reused)
+   * @param {Map<string, Array>} nameMap
+   * @returns {boolean}
+   */
+  matchesNameMap(nameMap) {
+    let eligible = 0;
+    for (const key of nameMap.keys()) {
+      const words = key ? key.split(' ') : [];
+      if (words.length && words.length <= MAX_NAME_TOKENS && words.every((word) => TOKEN_SHAPE.test(word))) {
+        eligible++;
+      }
+    }
+    return eligible === this.keys.length && this.keys.every((key) => nameMap.has(key));
+  }
+
+  getStats() {
+    return {
+      keys: this.keys.length,
+      words: this.vocab.length,
+      nodes: this.nodeCount,
+      edges: this.edgeWords.length
+    };
+  }
+
+  /** @private BFS over the trie filling fail and dictionary-suffix links */
+  _linkFailures() {
+    const queue = new Uint32Array(this.nodeCount);
+    let head = 0;
+    let tail = 0;
+    for (let edge = this.edgeOffsets[ROOT]; edge < this.edgeOffsets[ROOT + 1]; edge++) {
+      const child = this.edgeTargets[edge];
+      this.fail[child] = ROOT;
+      queue[tail++] = child;
+    }
+    while (head < tail) {
+      const node = queue[head++];
+      for (let edge = this.edgeOffsets[node]; edge < this.edgeOffsets[node + 1]; edge++) {
+        const word = this.edgeWords[edge];
+        const child = this.edgeTargets[edge];
+        let state = this.fail[node];
+        let target = this.next(state, word);
+        while (target === -1 && state !== ROOT) {
+          state = this.fail[state];
+          target = this.next(state, word);
+        }
+        const fail = target === -1 ? ROOT : target;
+        this.fail[child] = fail;
+        this.output[child] = this.keyIndex[fail] !== -1 ? fail : this.output[fail];
+        queue[tail++] = child;
+      }
+    }
+  }
+}
+
+module.exports = {
+  GazetteerAutomaton,
+  MAX_NAME_TOKENS
+};
@@ -0,0 +1,135 @@
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { Worker } = require('worker_threads');
+const { GazetteerArtifact } = require('../GazetteerArtifact');
+const { GazetteerAutomaton } = require('../GazetteerAutomaton');
+const {
+  gazetteerMatchersFromArtifact,
+  extractGazetteerPlacesFromText,
+  resolveUrlPlaces
+} = require('../place-extraction');
+
+function record(id, name, kind, countryCode, population, slugs) {
+  return {
+    id,
+    place_id: id,
+    kind,
+    country_code: countryCode,
+    countryCode,
+    population,
+    names: new Set([name]),
+    slugs: new Set(slugs),
+    synonyms: slugs.slice(),
+    nameOrder: [name],
+    canonicalSlug: slugs[0],
+    name
+  };
+}
+
+function createMatchers() {
+  const us = record(1, 'United States', 'country', 'US', 331000000, ['united-states', 'us', 'usa']);
+  const california = record(2, 'California', 'region', 'US', 39510000, ['california']);
+  const paris = record(3, 'Paris', 'city', 'FR', 2100000, ['paris']);
+  const parisTx = record(4, 'Paris', 'city', 'US', 25000, ['paris']);
+  const saoPaulo = record(5, 'São Paulo', 'city', 'BR', 12000000, ['sao-paulo']);
+  saoPaulo.names.add('Sao Paulo');
+  saoPaulo.nameOrder.push('Sao Paulo');
+  const places = [us, california, paris, parisTx, saoPaulo];
+
+  const nameMap = new Map();
+  const slugMap = new Map();
+  const add = (map, key, value) => (map.get(key) || map.set(key, []).get(key)).push(value);
+  add(nameMap, 'united states', us);
+  add(nameMap, 'california', california);
+  add(nameMap, 'paris', paris);
+  add(nameMap, 'paris', parisTx);
+  add(nameMap, 'sao paulo', saoPaulo);
+  for (const place of places) {
+    for (const slug of place.synonyms) add(slugMap, slug, place);
+  }
+
+  const parents = new Map([
+    [2, [{ parentId: 1, relation: 'admin_parent', depth: 1 }]],
+    [4, [{ parentId: 2, relation: null, depth: null }]]
+  ]);
+  const children = new Map([
+    [1, [{ childId: 2, relation: 'admin_parent', depth: 1 }]],
+    [2, [{ childId: 4, relation: null, depth: null }]]
+  ]);
+  return {
+    nameMap,
+    slugMap,
+    placeIndex: new Map(places.map((place) => [place.id, place])),
+    topicTokens: new Set(['news', 'business']),
+    automaton: GazetteerAutomaton.fromNameMap(nameMap),
+    hierarchy: {
+      parents,
+      children,
+      isAncestor: (a, d) => (a === 1 && (d === 2 || d === 4)) || (a === 2 && d === 4)
+    }
+  };
+}
+
+describe('GazetteerArtifact', () => {
+  test('artifact-backed matchers behave like the matchers they were built from', () => {
+    const built = createMatchers();
+    const loaded = gazetteerMatchersFromArtifact(GazetteerArtifact.build(built, { fingerprint: 'test' }));
+
+    expect(loaded.placeIndex.size).toBe(5);
+    for (const [id, place] of built.placeIndex) {
+      expect(loaded.placeIndex.get(id)).toEqual(place);
+    }
+    expect(loaded.placeIndex.get(99)).toBeUndefined();
+    expect(new Set(loaded.nameMap.keys())).toEqual(new Set(built.nameMap.keys()));
+    expect(loaded.slugMap.get('usa')).toEqual(built.slugMap.get('usa'));
+    expect(loaded.slugMap.get('usa')[0]).toBe(loaded.placeIndex.get(1));
+    expect(loaded.nameMap.get('nowhere')).toBeUndefined();
+    expect(loaded.hierarchy.parents.get(4)).toEqual(built.hierarchy.parents.get(4));
+    expect(loaded.hierarchy.children.get(1)).toEqual(built.hierarchy.children.get(1));
+    expect(loaded.topicTokens).toEqual(built.topicTokens);
+    for (const [a, d] of [[1, 2], [1, 4], [2, 4], [4, 1], [3, 1]]) {
+      expect(loaded.hierarchy.isAncestor(a, d)).toBe(built.hierarchy.isAncestor(a, d));
+    }
+
+    const text = 'From Paris to Sao Paulo, then California and the United States.';
+    const ctx = { domain_cc: 'US' };
+    expect(extractGazetteerPlacesFromText(text, loaded, ctx, false)).toEqual(extractGazetteerPlacesFromText(text, built, ctx, false));
+    const url = 'https://example.com/us/california/news';
+    expect(resolveUrlPlaces(url, loaded).bestChain.places.map((entry) => entry.place.name))
+      .toEqual(resolveUrlPlaces(url, built).bestChain.places.map((entry) => entry.place.name));
+  });
+
+  test('loads from disk into a SharedArrayBuffer that worker threads can use', async () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gazetteer-artifact-'));
+    try {
+      const file = path.join(dir, 'cache', 'gazetteer-matchers.bin');
+      GazetteerArtifact.save(file, GazetteerArtifact.build(createMatchers(), { fingerprint: 'places=5:5' }));
+      expect(GazetteerArtifact.readFileHeader(file)).toMatchObject({ fingerprint: 'places=5:5', placeCount: 5 });
+      expect(GazetteerArtifact.readFileHeader(path.join(dir, 'missing.bin'))).toBeNull();
+
+      const matchers = gazetteerMatchersFromArtifact(GazetteerArtifact.load(file));
+      expect(matchers.sharedBuffer).toBeInstanceOf(SharedArrayBuffer);
+
+      const modulePath = require.resolve('../place-extraction');
+      const worker = new Worker(`
+        const { parentPort, workerData } = require('worker_threads');
+        const { gazetteerMatchersFromArtifact, extractGazetteerPlacesFromText } = require(${JSON.stringify(modulePath)});
+        const matchers = gazetteerMatchersFromArtifact(workerData);
+        parentPort.postMessage(extractGazetteerPlacesFromText('Rain in Paris', matchers, { domain_cc: 'FR' }, false));
+      `, { eval: true, workerData: matchers.sharedBuffer });
+      const places = await new Promise((resolve, reject) => {
+        worker.once('message', resolve);
+        worker.once('error', reject);
+      });
+      await worker.terminate();
+      expect(places).toEqual([{ name: 'Paris', kind: 'city', country_code: 'FR', place_id: 3, start: 8, end: 13 }]);
+    } finally {
+      fs.rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test('rejects files that are not artifacts', () => {
+    expect(() => GazetteerArtifact.fromBuffer(Buffer.from('not a gazetteer artifact at all, nope, not one bit of it'))).toThrow('Not a gazetteer artifact');
+  });
+});
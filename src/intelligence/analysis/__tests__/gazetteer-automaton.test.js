@@ -0,0 +1,85 @@
+const { GazetteerAutomaton } = require('../GazetteerAutomaton');
+const { serializeAutomaton, deserializeAutomaton } = require('../gazetteer-serialization');
+const { extractGazetteerPlacesFromText } = require('../place-extraction');
+
+function place(id, name, countryCode, population) {
+  return { id, place_id: id, name, kind: 'city', country_code: countryCode, population };
+}
+
+function createMatchers() {
+  const nameMap = new Map([
+    ['york', [place(1, 'York', 'GB', 200000)]],
+    ['new york', [place(2, 'New York', 'US', 8000000)]],
+    ['new york city', [place(3, 'New York City', 'US', 8400000)]],
+    ['city', [place(4, 'City', 'GB', 9000)]],
+    ['paris', [place(5, 'Paris', 'FR', 2100000), place(6, 'Paris', 'US', 25000)]],
+    ['sao paulo', [place(7, 'São Paulo', 'BR', 12000000)]],
+    ['guinea', [place(8, 'Guinea', 'GN', 13000000)]],
+    ['papua new guinea', [place(9, 'Papua New Guinea', 'PG', 9000000)]],
+    ['new', [place(10, 'New', 'XX', 10)]],
+    ["o'hare", [place(11, "O'Hare", 'US', 0)]],
+    ['st. louis', [place(12, 'St. Louis', 'US', 300000)]],
+    ['a b c d e', [place(13, 'Too Long', 'XX', 0)]]
+  ]);
+  return { nameMap, slugMap: new Map(), placeIndex: new Map(), topicTokens: new Set() };
+}
+
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+describe('GazetteerAutomaton', () => {
+  const words = ['New', 'York', 'City', 'Paris', 'Sao', 'Paulo', 'Papua', 'Guinea', "O'Hare", 'St.', 'Louis', 'the', 'in', 'a', 'b', 'c', 'd', 'e', 'SÃO'];
+  const seps = [' ', ' ', ', ', '. ', ' - ', '\n'];
+
+  test('finds the same places as the n-gram probe', () => {
+    const legacy = createMatchers();
+    const indexed = { ...createMatchers(), automaton: null };
+    indexed.automaton = GazetteerAutomaton.fromNameMap(indexed.nameMap);
+    const rand = mulberry32(7);
+    const ctx = { domain_cc: 'US' };
+
+    for (let round = 0; round < 300; round++) {
+      let text = '';
+      const length = 1 + (rand() % 30);
+      for (let i = 0; i < length; i++) {
+        text += words[rand() % words.length] + seps[rand() % seps.length];
+      }
+      const isTitle = round % 2 === 0;
+      expect(extractGazetteerPlacesFromText(text, indexed, ctx, isTitle))
+        .toEqual(extractGazetteerPlacesFromText(text, legacy, ctx, isTitle));
+    }
+
+    const places = extractGazetteerPlacesFromText('Flights from New York City to Papua New Guinea via Paris', indexed, ctx, false);
+    expect(places.map((p) => [p.place_id, p.start, p.end])).toEqual([[3, 13, 26], [9, 30, 46], [6, 51, 56]]);
+  });
+
+  test('skips names no token window can produce', () => {
+    const automaton = GazetteerAutomaton.fromNameMap(createMatchers().nameMap);
+    expect(automaton.keys).not.toContain('st. louis');
+    expect(automaton.keys).not.toContain('a b c d e');
+    expect(automaton.getStats()).toMatchObject({ keys: 10 });
+  });
+
+  test('round-trips through gazetteer-serialization', () => {
+    const matchers = createMatchers();
+    const automaton = GazetteerAutomaton.fromNameMap(matchers.nameMap);
+    const bytes = serializeAutomaton(automaton);
+    // Misaligned copy exercises the re-alignment path
+    const shifted = Buffer.alloc(bytes.length + 1);
+    bytes.copy(shifted, 1);
+    const loaded = deserializeAutomaton(shifted.subarray(1));
+
+    const text = "New York, York City and Sao Paulo; O'Hare, new guinea";
+    expect(loaded.scan(text, (w) => w.toLowerCase())).toEqual(automaton.scan(text, (w) => w.toLowerCase()));
+    expect(loaded.matchesNameMap(matchers.nameMap)).toBe(true);
+    matchers.nameMap.set('lyon', []);
+    expect(loaded.matchesNameMap(matchers.nameMap)).toBe(false);
+    expect(() => deserializeAutomaton(Buffer.from('definitely not an automaton file'))).toThrow('Not a gazetteer automaton file');
+  });
+});
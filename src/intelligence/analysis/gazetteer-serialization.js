@@ -0,0 +1,155 @@
+'use strict';
+
+/**
+ * Binary (de)serialization of the gazetteer name automaton
+ *
+ * Building the automaton walks every nameMap key. Tools that build gazetteer
+ * matchers repeatedly (or in many worker processes) can instead save it once
+ * and hand the bytes back to buildGazetteerMatchers({ automaton }).
+ *
+ * Layout (little endian, every section 8-byte aligned):
+ *   header   32 bytes: magic "GAZAUTO1", u32 version, u32 nodeCount,
+ *            u32 edgeCount, u32 vocabCount, u32 keyCount, u32 stringBytes
+ *   data     edgeOffsets u32[nodeCount + 1], edgeWords u32[edgeCount],
+ *            edgeTargets u32[edgeCount], fail u32[nodeCount],
+ *            output i32[nodeCount], keyIndex i32[nodeCount],
+ *            depth u8[nodeCount], strings (vocab then keys, UTF-8, '\n'-separated)
+ *
+ * @module gazetteer-serialization
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { GazetteerAutomaton } = require('./GazetteerAutomaton');
+
+const MAGIC = 'GAZAUTO1';
+const VERSION = 1;
+const HEADER_BYTES = 32;
+
+function align8(n) {
+  return Math.ceil(n / 8) * 8;
+}
+
+function sectionLayout(nodeCount, edgeCount, stringBytes) {
+  const sizes = [
+    ['edgeOffsets', (nodeCount + 1) * 4],
+    ['edgeWords', edgeCount * 4],
+    ['edgeTargets', edgeCount * 4],
+    ['fail', nodeCount * 4],
+    ['output', nodeCount * 4],
+    ['keyIndex', nodeCount * 4],
+    ['depth', nodeCount],
+    ['strings', stringBytes]
+  ];
+  const layout = {};
+  let offset = HEADER_BYTES;
+  for (const [name, bytes] of sizes) {
+    layout[name] = { offset, bytes };
+    offset = align8(offset + bytes);
+  }
+  layout.total = offset;
+  return layout;
+}
+
+/**
+ * @param {GazetteerAutomaton} automaton
+ * @returns {Buffer}
+ */
+function serializeAutomaton(automaton) {
+  const strings = Buffer.from(automaton.vocab.concat(automaton.keys).join('\n'), 'utf8');
+  const nodeCount = automaton.nodeCount;
+  const edgeCount = automaton.edgeWords.length;
+  const layout = sectionLayout(nodeCount, edgeCount, strings.length);
+  const buffer = Buffer.alloc(layout.total);
+
+  buffer.write(MAGIC, 0, 'latin1');
+  buffer.writeUInt32LE(VERSION, 8);
+  buffer.writeUInt32LE(nodeCount, 12);
+  buffer.writeUInt32LE(edgeCount, 16);
+  buffer.writeUInt32LE(automaton.vocab.length, 20);
+  buffer.writeUInt32LE(automaton.keys.length, 24);
+  buffer.writeUInt32LE(strings.length, 28);
+
+  for (const name of ['edgeOffsets', 'edgeWords', 'edgeTargets', 'fail', 'output', 'keyIndex', 'depth']) {
+    const array = automaton[name];
+    Buffer.from(array.buffer, array.byteOffset, array.byteLength).copy(buffer, layout[name].offset);
+  }
+  strings.copy(buffer, layout.strings.offset);
+  return buffer;
+}
+
+/**
+ * @param {Buffer} buffer - Bytes written by serializeAutomaton
+ * @returns {GazetteerAutomaton}
+ */
+function deserializeAutomaton(buffer) {
+  if (!Buffer.isBuffer(buffer) || buffer.length < HEADER_BYTES || buffer.toString('latin1', 0, 8) !== MAGIC) {
+    throw new Error('Not a gazetteer automaton file');
+  }
+  const version = buffer.readUInt32LE(8);
+  if (version !== VERSION) {
+    throw new Error(`Unsupported gazetteer automaton version ${version}`);
+  }
+  const nodeCount = buffer.readUInt32LE(12);
+  const edgeCount = buffer.readUInt32LE(16);
+  const vocabCount = buffer.readUInt32LE(20);
+  const keyCount = buffer.readUInt32LE(24);
+  const stringBytes = buffer.readUInt32LE(28);
+  const layout = sectionLayout(nodeCount, edgeCount, stringBytes);
+  if (buffer.length < layout.total) {
+    throw new Error('Gazetteer automaton file is truncated');
+  }
+
+  // Typed array views need aligned offsets; copy once if the Buffer is a misaligned slice
+  const source = buffer.byteOffset % 8 === 0 ? buffer : Buffer.from(buffer);
+  const view = (Type, name) => new Type(
+    source.buffer,
+    source.byteOffset + layout[name].offset,
+    layout[name].bytes / Type.BYTES_PER_ELEMENT
+  );
+
+  const strings = stringBytes
+    ? source.toString('utf8', layout.strings.offset, layout.strings.offset + stringBytes).split('\n')
+    : [];
+  if (strings.length !== vocabCount + keyCount) {
+    throw new Error('Gazetteer automaton string table does not match its header');
+  }
+
+  return new GazetteerAutomaton({
+    vocab: strings.slice(0, vocabCount),
+    keys: strings.slice(vocabCount),
+    edgeOffsets: view(Uint32Array, 'edgeOffsets'),
+    edgeWords: view(Uint32Array, 'edgeWords'),
+    edgeTargets: view(Uint32Array, 'edgeTargets'),
+    fail: view(Uint32Array, 'fail'),
+    output: view(Int32Array, 'output'),
+    keyIndex: view(Int32Array, 'keyIndex'),
+    depth: view(Uint8Array, 'depth')
+  });
+}
+
+/**
+ * @param {string} filePath
+ * @param {GazetteerAutomaton} automaton
+ */
+function saveAutomaton(filePath, automaton) {
+  fs.mkdirSync(path.dirname(filePath), { recursive: true });
+  const tmpPath = `${filePath}.tmp`;
+  fs.writeFileSync(tmpPath, serializeAutomaton(automaton));
+  fs.renameSync(tmpPath, filePath);
+}
+
+/**
+ * @param {string} filePath
+ * @returns {GazetteerAutomaton}
+ */
+function loadAutomaton(filePath) {
+  return deserializeAutomaton(fs.readFileSync(filePath));
+}
+
+module.exports = {
+  serializeAutomaton,
+  deserializeAutomaton,
+  saveAutomaton,
+  loadAutomaton
+};
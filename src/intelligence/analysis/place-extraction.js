@@ -1,4 +1,8 @@
 const { URL } = require('url');
+const { GazetteerAutomaton } = require('./GazetteerAutomaton');
+const { deserializeAutomaton } = require('./gazetteer-serialization');
+const { GazetteerArtifact, hashKey } = require('./GazetteerArtifact');
+const { getGazetteerFingerprintRows } = require('../../data/db/sqlite/queries/gazetteerFingerprint');
 
 let PLACE_EXTRACTION_DB_QUERIES = null;
 
@@ -199,9 +203,18 @@ function buildHierarchyIndex(db, placeIndex) {
     });
   }
 
+  return {
+    parents,
+    children,
+    isAncestor: createAncestorCheck(parents)
+  };
+}
+
+// parents: anything with get(childId) -> [{ parentId }] (a Map, or an artifact view)
+function createAncestorCheck(parents) {
   const memo = new Map();
 
-  const isAncestor = (ancestorId, descendantId, maxDepth = MAX_HIERARCHY_DEPTH) => {
+  return (ancestorId, descendantId, maxDepth = MAX_HIERARCHY_DEPTH) => {
     if (ancestorId === descendantId) return false;
     const key = `${ancestorId}->${descendantId}`;
     if (memo.has(key)) return memo.get(key);
@@ -229,12 +242,6 @@ function buildHierarchyIndex(db, placeIndex) {
     memo.set(key, found);
     return found;
   };
-
-  return {
-    parents,
-    children,
-    isAncestor
-  };
 }
 
 function buildGazetteerMatchers(db, options = {}) {
@@ -250,8 +257,7 @@ function buildGazetteerMatchers(db, options = {}) {
     topicTokens: options.topicTokens instanceof Set ? options.topicTokens : getDefaultTopicTokens(db)
   };
 
-  const TEST_FAST = process.env.TEST_FAST === '1' || process.env.TEST_FAST === 'true';
-  const CITY_LIMIT = TEST_FAST ? 500 : 5000;
+  const CITY_LIMIT = gazetteerCityLimit();
 
   const countryRows = dbQueries.listPlaceExtractionCountryMatcherRows(db);
 
@@ -281,6 +287,7 @@ function buildGazetteerMatchers(db, options = {}) {
   }
 
   finalizePlaceRecords(matchers);
+  matchers.automaton = resolveNameAutomaton(options.automaton, matchers.nameMap);
 
   const dbHandle = db; // better-sqlite3 handle
   matchers.hierarchy = buildHierarchyIndex(dbHandle, matchers.placeIndex);
@@ -288,6 +295,141 @@ function buildGazetteerMatchers(db, options = {}) {
   return matchers;
 }
 
+function gazetteerCityLimit() {
+  const TEST_FAST = process.env.TEST_FAST === '1' || process.env.TEST_FAST === 'true';
+  return TEST_FAST ? 500 : 5000;
+}
+
+// Summary of the gazetteer tables buildGazetteerMatchers reads: counts, max
+// ids and a checksum over row contents, so inserts, deletes and in-place edits
+// (renames, kind or country changes) all alter it. Returns null when the
+// tables cannot be read (the artifact is then never trusted).
+function computeGazetteerFingerprint(db, options = {}) {
+  let tables = null;
+  try {
+    tables = getGazetteerFingerprintRows(db);
+  } catch (_) {
+    return null;
+  }
+  if (!tables) return null;
+  const parts = ['artifact=2', `cities=${gazetteerCityLimit()}`];
+  for (const name of ['places', 'names', 'hierarchy']) {
+    const row = tables[name] || {};
+    parts.push(`${name}=${[row.c, row.m, row.h].filter((v) => v !== undefined).join(':')}`);
+  }
+  if (options.topicTokens instanceof Set) {
+    parts.push(`topics=${hashKey(Array.from(options.topicTokens).sort().join('\n'))}`);
+  }
+  return parts.join('|');
+}
+
+/**
+ * Matchers backed by a GazetteerArtifact: same shape as buildGazetteerMatchers,
+ * but records are decoded on first use and the columns stay in the artifact buffer.
+ *
+ * @param {GazetteerArtifact|Buffer|ArrayBuffer|SharedArrayBuffer} source
+ * @returns {Object} Matchers (plus `artifact` and, when shared, `sharedBuffer`)
+ */
+function gazetteerMatchersFromArtifact(source) {
+  const artifact = source instanceof GazetteerArtifact ? source : GazetteerArtifact.fromBuffer(source);
+  const views = artifact.views();
+  const topicTokens = artifact.topicTokenSet();
+  if (!DEFAULT_TOPIC_TOKENS) {
+    DEFAULT_TOPIC_TOKENS = topicTokens;
+  }
+  const backing = artifact.buffer.buffer;
+  return {
+    nameMap: views.nameMap,
+    slugMap: views.slugMap,
+    placeIndex: views.placeIndex,
+    topicTokens,
+    automaton: artifact.nameAutomaton(),
+    hierarchy: {
+      parents: views.parents,
+      children: views.children,
+      isAncestor: createAncestorCheck(views.parents)
+    },
+    artifact,
+    sharedBuffer: typeof SharedArrayBuffer !== 'undefined' && backing instanceof SharedArrayBuffer ? backing : null
+  };
+}
+
+const SHARED_GAZETTEERS = new Map(); // artifactPath -> { fingerprint, matchers }
+
+/**
+ * buildGazetteerMatchers with an on-disk artifact in front of it.
+ *
+ * The artifact is reused while the DB fingerprint it was written with still
+ * matches, and rebuilt (build + write) otherwise. Calls in one process share a
+ * single instance per path. `matchers.sharedBuffer` can be posted to worker
+ * threads, which call gazetteerMatchersFromArtifact(sharedBuffer).
+ *
+ * @param {Object} db - better-sqlite3 handle
+ * @param {Object} [options] - buildGazetteerMatchers options, plus:
+ * @param {string} [options.artifactPath] - Without one this is buildGazetteerMatchers
+ * @param {boolean} [options.rebuild=false] - Ignore an existing artifact
+ * @param {Object} [options.logger=console]
+ * @returns {Object} Matchers
+ */
+function loadGazetteerMatchers(db, options = {}) {
+  const artifactPath = options.artifactPath;
+  const logger = options.logger && typeof options.logger.warn === 'function' ? options.logger : console;
+  const fingerprint = artifactPath ? computeGazetteerFingerprint(db, options) : null;
+  if (!fingerprint) {
+    return buildGazetteerMatchers(db, options);
+  }
+
+  const cached = SHARED_GAZETTEERS.get(artifactPath);
+  if (cached && cached.fingerprint === fingerprint && !options.rebuild) {
+    return cached.matchers;
+  }
+
+  let matchers = null;
+  if (!options.rebuild) {
+    const header = GazetteerArtifact.readFileHeader(artifactPath);
+    if (header && header.fingerprint === fingerprint) {
+      try {
+        matchers = gazetteerMatchersFromArtifact(GazetteerArtifact.load(artifactPath));
+      } catch (error) {
+        logger.warn(`[place-extraction] Ignoring unreadable gazetteer artifact ${artifactPath}: ${error.message}`);
+      }
+    }
+  }
+
+  if (!matchers) {
+    const built = buildGazetteerMatchers(db, options);
+    const bytes = GazetteerArtifact.build(built, { fingerprint });
+    try {
+      GazetteerArtifact.save(artifactPath, bytes);
+    } catch (error) {
+      logger.warn(`[place-extraction] Failed to write gazetteer artifact ${artifactPath}: ${error.message}`);
+    }
+    const shared = Buffer.from(new SharedArrayBuffer(bytes.length));
+    bytes.copy(shared);
+    matchers = gazetteerMatchersFromArtifact(shared);
+  }
+
+  SHARED_GAZETTEERS.set(artifactPath, { fingerprint, matchers });
+  return matchers;
+}
+
+// options.automaton: false disables it, a GazetteerAutomaton or serialized Buffer
+// is reused when it still covers exactly this nameMap, otherwise it is rebuilt.
+function resolveNameAutomaton(provided, nameMap) {
+  if (provided === false) return null;
+  if (provided) {
+    try {
+      const automaton = Buffer.isBuffer(provided) ? deserializeAutomaton(provided) : provided;
+      if (automaton instanceof GazetteerAutomaton && automaton.matchesNameMap(nameMap)) {
+        return automaton;
+      }
+    } catch (_) {
+      // stale or foreign bytes: rebuild below
+    }
+  }
+  return GazetteerAutomaton.fromNameMap(nameMap);
+}
+
 function pickBestCandidate(candidates, ctx, isTitle) {
   if (!candidates || candidates.length === 0) return null;
   if (candidates.length === 1) return candidates[0];
@@ -320,9 +462,22 @@ function pickBestCandidate(candidates, ctx, isTitle) {
   return best;
 }
 
-function extractGazetteerPlacesFromText(text, matchers, ctx, isTitle) {
-  const results = [];
-  if (!text || !matchers) return results;
+// Non-overlapping nameMap hits in text: leftmost first, longest window at each start.
+// Uses the name automaton (one pass) when the matchers have one, else probes
+// every 1..4 token window.
+function findNameMentions(text, matchers) {
+  const mentions = [];
+  if (!text || !matchers) return mentions;
+
+  if (matchers.automaton) {
+    for (const hit of matchers.automaton.scan(text, normName)) {
+      const candidates = matchers.nameMap.get(hit.key);
+      if (candidates && candidates.length) {
+        mentions.push({ candidates, start: hit.start, end: hit.end });
+      }
+    }
+    return mentions;
+  }
 
   const tokenRegex = /[A-Za-z][A-Za-z'\-]*/g;
   const tokens = [];
@@ -361,31 +516,38 @@ function extractGazetteerPlacesFromText(text, matchers, ctx, isTitle) {
 
       const candidates = matchers.nameMap.get(phraseNormalized);
       if (candidates && candidates.length) {
-        const record = pickBestCandidate(candidates, ctx, isTitle);
-        if (record) {
-          bestMatch = {
-            record,
-            windowSize,
-            start: tokens[i].start,
-            end: tokens[tokenIndex].end
-          };
-        }
+        bestMatch = {
+          candidates,
+          windowSize,
+          start: tokens[i].start,
+          end: tokens[tokenIndex].end
+        };
       }
     }
 
     if (bestMatch) {
-      results.push({
-        name: bestMatch.record.name,
-        kind: bestMatch.record.kind,
-        country_code: bestMatch.record.country_code,
-        place_id: bestMatch.record.place_id,
-        start: bestMatch.start,
-        end: bestMatch.end
-      });
+      mentions.push({ candidates: bestMatch.candidates, start: bestMatch.start, end: bestMatch.end });
       i += bestMatch.windowSize - 1;
     }
   }
 
+  return mentions;
+}
+
+function extractGazetteerPlacesFromText(text, matchers, ctx, isTitle) {
+  const results = [];
+  for (const mention of findNameMentions(text, matchers)) {
+    const record = pickBestCandidate(mention.candidates, ctx, isTitle);
+    if (!record) continue;
+    results.push({
+      name: record.name,
+      kind: record.kind,
+      country_code: record.country_code,
+      place_id: record.place_id,
+      start: mention.start,
+      end: mention.end
+    });
+  }
   return results;
 }
 
@@ -1073,72 +1235,22 @@ function createEnhancedPlaceExtractor(db, options = {}) {
      */
     extractWithPrior(text, ctx = {}, isTitle = false, host = null) {
       const results = [];
-      if (!text || !matchers) return results;
-
-      const tokenRegex = /[A-Za-z][A-Za-z'\-]*/g;
-      const tokens = [];
-      const normalizedTokens = [];
-      let match;
-
-      while ((match = tokenRegex.exec(text)) !== null) {
-        const word = match[0];
-        const normalized = normName(word);
-        if (!normalized) continue;
-        tokens.push({ word, start: match.index, end: match.index + word.length });
-        normalizedTokens.push(normalized);
-      }
-
-      const maxWindow = 4;
-      for (let i = 0; i < tokens.length; i++) {
-        let bestMatch = null;
-        let phraseNormalized = '';
-
-        for (
-          let windowSize = 1;
-          windowSize <= maxWindow && i + windowSize <= tokens.length;
-          windowSize += 1
-        ) {
-          const tokenIndex = i + windowSize - 1;
-          const normalizedToken = normalizedTokens[tokenIndex];
-          if (!normalizedToken) {
-            phraseNormalized = '';
-            continue;
-          }
-          phraseNormalized = windowSize === 1
-            ? normalizedToken
-            : `${phraseNormalized} ${normalizedToken}`;
-
-          const candidates = matchers.nameMap.get(phraseNormalized);
-          if (candidates && candidates.length) {
-            const record = pickBestCandidateEnhanced(candidates, ctx, isTitle, {
-              db,
-              host,
-              priorWeight: options.priorWeight || 2.0
-            });
-            if (record) {
-              bestMatch = {
-                record,
-                windowSize,
-                start: tokens[i].start,
-                end: tokens[tokenIndex].end
-              };
-            }
-          }
-        }
-
-        if (bestMatch) {
-          results.push({
-            name: bestMatch.record.name,
-            kind: bestMatch.record.kind,
-            country_code: bestMatch.record.country_code,
-            place_id: bestMatch.record.place_id,
-            start: bestMatch.start,
-            end: bestMatch.end
-          });
-          i += bestMatch.windowSize - 1;
-        }
+      for (const mention of findNameMentions(text, matchers)) {
+        const record = pickBestCandidateEnhanced(mention.candidates, ctx, isTitle, {
+          db,
+          host,
+          priorWeight: options.priorWeight || 2.0
+        });
+        if (!record) continue;
+        results.push({
+          name: record.name,
+          kind: record.kind,
+          country_code: record.country_code,
+          place_id: record.place_id,
+          start: mention.start,
+          end: mention.end
+        });
       }
-
       return results;
     },
     
@@ -1236,6 +1348,9 @@ module.exports = {
   normName,
   slugify,
   buildGazetteerMatchers,
+  loadGazetteerMatchers,
+  gazetteerMatchersFromArtifact,
+  computeGazetteerFingerprint,
   pickBestCandidate,
   pickBestCandidateEnhanced,
   extractGazetteerPlacesFromText,
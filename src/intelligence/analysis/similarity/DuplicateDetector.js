@@ -12,6 +12,7 @@
  * - Duplicate detection using SimHash
  * - Batch processing for initial indexing
  * - Database persistence via similarityAdapter
+ * - Optional binary index snapshot (snapshotPath) so startup skips the DB rebuild
  * 
  * @module DuplicateDetector
  */
@@ -19,6 +20,7 @@
 const SimHasher = require('./SimHasher');
 const MinHasher = require('./MinHasher');
 const { SimilarityIndex } = require('./SimilarityIndex');
+const { SimilarityIndexStore } = require('./SimilarityIndexStore');
 
 // Minimum word count to compute fingerprints (short text produces noise)
 const MIN_WORD_COUNT = 50;
@@ -37,6 +39,8 @@ class DuplicateDetector {
    * @param {number} [options.minWordCount=50] - Minimum words for fingerprinting
    * @param {number} [options.simhashThreshold=3] - Max Hamming distance for near-duplicate
    * @param {number} [options.minSimilarity=0.5] - Min Jaccard for similar articles
+   * @param {string} [options.snapshotPath] - Index snapshot file; loaded instead of the DB when present
+   * @param {number} [options.snapshotCompactEvery=10000] - Appended fingerprints that trigger a snapshot rewrite
    */
   constructor(options = {}) {
     this.similarityAdapter = options.similarityAdapter;
@@ -52,6 +56,15 @@ class DuplicateDetector {
       simhashThreshold: this.simhashThreshold
     });
     
+    this.store = options.snapshotPath
+      ? new SimilarityIndexStore({
+        path: options.snapshotPath,
+        index: this.index,
+        compactEvery: options.snapshotCompactEvery,
+        logger: this.logger
+      })
+      : null;
+    
     this._initialized = false;
   }
   
@@ -68,6 +81,27 @@ class DuplicateDetector {
       return this.index.size;
     }
     
+    if (this.store) {
+      try {
+        const result = this.store.load();
+        const stale = result.loaded ? this._staleSnapshotReason(result.source) : null;
+        if (result.loaded && !stale) {
+          this._initialized = true;
+          this.logger.log(`[DuplicateDetector] Loaded ${this.index.size} fingerprints from snapshot in ${result.durationMs}ms (${result.replayed} from log)`);
+          return this.index.size;
+        }
+        if (stale) {
+          // Fingerprints were written or deleted behind the snapshot's back
+          this.logger.warn(`[DuplicateDetector] Snapshot is stale (${stale}), rebuilding from database`);
+          this.index.clear();
+        }
+      } catch (err) {
+        // Unreadable snapshot: rebuild from the DB, which rewrites it below
+        this.logger.error('[DuplicateDetector] Snapshot load failed, rebuilding from database:', err);
+        this.index.clear();
+      }
+    }
+    
     if (!this.similarityAdapter) {
       this._initialized = true;
       return 0;
@@ -77,6 +111,7 @@ class DuplicateDetector {
     const startTime = Date.now();
     
     try {
+      const source = this._readSourceWatermark();
       const fingerprints = this.similarityAdapter.getAllFingerprints({ limit });
       
       for (const fp of fingerprints) {
@@ -88,6 +123,10 @@ class DuplicateDetector {
       
       this.logger.log(`[DuplicateDetector] Loaded ${fingerprints.length} fingerprints in ${duration}ms`);
       
+      if (this.store && (fingerprints.length > 0 || this.store.exists())) {
+        this.saveSnapshot(source);
+      }
+      
       return fingerprints.length;
     } catch (err) {
       this.logger.error('[DuplicateDetector] Error initializing:', err);
@@ -142,6 +181,7 @@ class DuplicateDetector {
     
     // Add to index
     this.index.add(contentId, fingerprints.simhash, fingerprints.minhash);
+    this._appendToSnapshot(contentId, fingerprints.simhash, fingerprints.minhash);
     
     // Persist to database
     if (persist && this.similarityAdapter) {
@@ -186,6 +226,7 @@ class DuplicateDetector {
         fp = { simhash: dbFp.simhash, minhash: dbFp.minhash };
         // Add to index for future queries
         this.index.add(contentId, fp.simhash, fp.minhash);
+        this._appendToSnapshot(contentId, fp.simhash, fp.minhash);
       }
     }
     
@@ -333,6 +374,85 @@ class DuplicateDetector {
     };
   }
   
+  /**
+   * Write the current index to the snapshot file (no-op without snapshotPath)
+   * 
+   * @param {{rows: number, maxContentId: number|null}} [source] - DB watermark the index was loaded from
+   * @returns {{items: number, bytes: number, durationMs: number}|null} Compaction result
+   */
+  saveSnapshot(source = null) {
+    if (!this.store) return null;
+    try {
+      return this.store.compact(source
+        ? { rows: source.rows, maxContentId: source.maxContentId ?? undefined }
+        : undefined);
+    } catch (err) {
+      // The DB still has every fingerprint; the next start rebuilds from it
+      this.logger.error('[DuplicateDetector] Failed to write index snapshot:', err);
+      return null;
+    }
+  }
+  
+  /**
+   * DB fingerprint count and highest content id, or null if the adapter
+   * cannot report them (the snapshot is then trusted as-is)
+   * @private
+   */
+  _readSourceWatermark() {
+    if (!this.similarityAdapter || typeof this.similarityAdapter.getStats !== 'function') return null;
+    try {
+      const stats = this.similarityAdapter.getStats();
+      if (!stats || !Number.isFinite(stats.totalFingerprints)) return null;
+      return {
+        rows: stats.totalFingerprints,
+        maxContentId: Number.isFinite(stats.maxContentId) ? stats.maxContentId : null
+      };
+    } catch (err) {
+      this.logger.error('[DuplicateDetector] Could not read fingerprint stats:', err);
+      return null;
+    }
+  }
+
+  /**
+   * Compare a loaded snapshot's watermark with the DB
+   * @private
+   * @returns {string|null} Why the snapshot is stale, or null if it matches
+   */
+  _staleSnapshotReason(snapshotSource) {
+    const db = this._readSourceWatermark();
+    if (!db || !snapshotSource) return null;
+    if (db.rows !== snapshotSource.rows) {
+      return `${snapshotSource.rows} rows in snapshot, ${db.rows} in database`;
+    }
+    if (db.maxContentId !== null && db.maxContentId !== snapshotSource.maxContentId) {
+      return `max content id ${snapshotSource.maxContentId} in snapshot, ${db.maxContentId} in database`;
+    }
+    return null;
+  }
+
+  /**
+   * Record an indexed fingerprint in the snapshot log
+   * @private
+   */
+  _appendToSnapshot(contentId, simhash, minhash) {
+    if (!this.store) return;
+    try {
+      this.store.append(contentId, simhash, minhash);
+    } catch (err) {
+      // Snapshot persistence is best effort; the DB stays authoritative
+      this.logger.error('[DuplicateDetector] Failed to append to index snapshot log:', err);
+    }
+  }
+  
+  /**
+   * Release the snapshot log handle
+   */
+  close() {
+    if (this.store) {
+      this.store.close();
+    }
+  }
+  
   /**
    * Get statistics about the detector
    * 
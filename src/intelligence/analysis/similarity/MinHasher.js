@@ -241,6 +241,17 @@ function extractBand(signature, bandIndex, numBands = 16, rowsPerBand = 8) {
  * @returns {string} Bucket identifier (hex string)
  */
 function hashBand(band) {
+  return hashBandValue(band).toString(16).padStart(8, '0');
+}
+
+/**
+ * Hash a band to a 32-bit bucket number (the value behind hashBand's hex
+ * string), for typed-array bucket tables
+ * 
+ * @param {Buffer} band - Band data
+ * @returns {number} Unsigned 32-bit FNV-1a hash
+ */
+function hashBandValue(band) {
   // Use FNV-1a hash on the band bytes
   let hash = 2166136261;
 
@@ -249,7 +260,7 @@ function hashBand(band) {
     hash = Math.imul(hash, 16777619) >>> 0;
   }
 
-  return hash.toString(16).padStart(8, '0');
+  return hash;
 }
 
 /**
@@ -298,6 +309,7 @@ module.exports = {
   // LSH support
   extractBand,
   hashBand,
+  hashBandValue,
 
   // Conversions
   signatureToArray,
@@ -0,0 +1,340 @@
+'use strict';
+
+/**
+ * SimHashIndex - Multi-index hashing over packed 64-bit SimHash fingerprints
+ *
+ * A linear scan computes the Hamming distance against every stored
+ * fingerprint, which takes seconds once the index holds millions of articles.
+ * Multi-index hashing (Norouzi et al.; the "permuted tables" scheme of
+ * Manku et al.) avoids that:
+ * - The 64 bits are split into `maxRadius + 1` disjoint blocks, and each
+ *   block gets an exact-match table of block value -> slots.
+ * - By pigeonhole, two fingerprints within distance `maxRadius` agree
+ *   exactly on at least one block. A query only probes one bucket per table
+ *   and verifies those candidates.
+ *
+ * With the default radius of 3 there are four 16-bit tables, so about
+ * 4 * N / 65536 candidates are verified per query (~600 at 10M entries)
+ * instead of N.
+ *
+ * Storage is columnar: each fingerprint is two 32-bit halves in Uint32Arrays
+ * and the content id is in a Float64Array, all indexed by slot. Removed
+ * slots are reused. Verification is a 32-bit popcount on the halves, with no
+ * Buffer or BigInt per entry.
+ *
+ * @module SimHashIndex
+ */
+
+const DEFAULT_MAX_RADIUS = 3;
+const INITIAL_CAPACITY = 1024;
+
+/**
+ * Count set bits in a 32-bit integer
+ * @param {number} v
+ * @returns {number}
+ */
+function popcount32(v) {
+  v = v - ((v >>> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >>> 2) & 0x33333333);
+  return (((v + (v >>> 4)) & 0x0F0F0F0F) * 0x01010101) >>> 24;
+}
+
+/**
+ * Split an 8-byte SimHash Buffer (little endian, as SimHasher writes it)
+ * into 32-bit halves
+ * @param {Buffer} simhash
+ * @returns {{lo: number, hi: number}}
+ */
+function splitSimhash(simhash) {
+  return { lo: simhash.readUInt32LE(0), hi: simhash.readUInt32LE(4) };
+}
+
+/**
+ * Read `width` bits (<= 32) starting at bit `start` of the 64-bit value hi:lo
+ */
+function extractBits(hi, lo, start, width) {
+  const mask = width >= 32 ? 0xFFFFFFFF : ((1 << width) >>> 0) - 1;
+  if (start >= 32) {
+    return ((hi >>> (start - 32)) & mask) >>> 0;
+  }
+  if (start + width <= 32) {
+    return ((lo >>> start) & mask) >>> 0;
+  }
+  const lowBits = 32 - start;
+  return (((lo >>> start) | (hi << lowBits)) & mask) >>> 0;
+}
+
+/**
+ * Disjoint bit ranges covering all 64 bits, one per table; widths differ by
+ * at most one. Shared with SimilaritySnapshot so on-disk tables line up.
+ * @param {number} maxRadius
+ * @returns {Array<{start: number, width: number}>}
+ */
+function blockLayout(maxRadius) {
+  const blockCount = maxRadius + 1;
+  const blocks = [];
+  let start = 0;
+  for (let b = 0; b < blockCount; b++) {
+    const width = Math.floor(64 / blockCount) + (b < 64 % blockCount ? 1 : 0);
+    blocks.push({ start, width });
+    start += width;
+  }
+  return blocks;
+}
+
+class SimHashIndex {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxRadius=3] - Largest Hamming radius answered from the tables; wider queries scan the columns
+   * @param {number} [options.initialCapacity=1024] - Slots allocated up front
+   */
+  constructor(options = {}) {
+    this.maxRadius = Math.max(0, Math.min(31, Math.floor(options.maxRadius ?? DEFAULT_MAX_RADIUS)));
+
+    this.blocks = blockLayout(this.maxRadius);
+
+    this._allocate(Math.max(16, options.initialCapacity || INITIAL_CAPACITY));
+    this.tables = this.blocks.map(() => new Map()); // block value -> slot[]
+    this.slotById = new Map();
+    this.freeSlots = [];
+    this.highWater = 0; // Slots [0, highWater) have been used at least once
+    this._epoch = 0;
+  }
+
+  /**
+   * Number of stored fingerprints
+   * @returns {number}
+   */
+  get size() {
+    return this.slotById.size;
+  }
+
+  /**
+   * Insert or replace the fingerprint for a content ID
+   * @param {number} contentId
+   * @param {Buffer} simhash - 8-byte SimHash fingerprint
+   */
+  add(contentId, simhash) {
+    const { lo, hi } = splitSimhash(simhash);
+    this.remove(contentId);
+
+    let slot;
+    if (this.freeSlots.length > 0) {
+      slot = this.freeSlots.pop();
+    } else {
+      if (this.highWater === this.capacity) {
+        this._allocate(this.capacity * 2);
+      }
+      slot = this.highWater++;
+    }
+
+    this.lo[slot] = lo;
+    this.hi[slot] = hi;
+    this.ids[slot] = contentId;
+    this.live[slot] = 1;
+    this.slotById.set(contentId, slot);
+
+    for (let b = 0; b < this.blocks.length; b++) {
+      const { start, width } = this.blocks[b];
+      const key = extractBits(hi, lo, start, width);
+      const bucket = this.tables[b].get(key);
+      if (bucket) {
+        bucket.push(slot);
+      } else {
+        this.tables[b].set(key, [slot]);
+      }
+    }
+  }
+
+  /**
+   * @param {number} contentId
+   * @returns {boolean} True if a fingerprint was removed
+   */
+  remove(contentId) {
+    const slot = this.slotById.get(contentId);
+    if (slot === undefined) return false;
+
+    const lo = this.lo[slot];
+    const hi = this.hi[slot];
+    for (let b = 0; b < this.blocks.length; b++) {
+      const { start, width } = this.blocks[b];
+      const key = extractBits(hi, lo, start, width);
+      const bucket = this.tables[b].get(key);
+      if (!bucket) continue;
+      const pos = bucket.indexOf(slot);
+      if (pos !== -1) {
+        // Order within a bucket does not matter
+        bucket[pos] = bucket[bucket.length - 1];
+        bucket.pop();
+      }
+      if (bucket.length === 0) {
+        this.tables[b].delete(key);
+      }
+    }
+
+    this.live[slot] = 0;
+    this.slotById.delete(contentId);
+    this.freeSlots.push(slot);
+    return true;
+  }
+
+  /**
+   * @param {number} contentId
+   * @returns {boolean}
+   */
+  has(contentId) {
+    return this.slotById.has(contentId);
+  }
+
+  /**
+   * Stored fingerprint as an 8-byte Buffer
+   * @param {number} contentId
+   * @returns {Buffer|null}
+   */
+  get(contentId) {
+    const slot = this.slotById.get(contentId);
+    if (slot === undefined) return null;
+    const buffer = Buffer.alloc(8);
+    buffer.writeUInt32LE(this.lo[slot], 0);
+    buffer.writeUInt32LE(this.hi[slot], 4);
+    return buffer;
+  }
+
+  /**
+   * Hamming distance between a stored fingerprint and a query
+   * @param {number} contentId
+   * @param {Buffer} simhash
+   * @returns {number|null} Distance, or null if the ID is not stored
+   */
+  distance(contentId, simhash) {
+    const slot = this.slotById.get(contentId);
+    if (slot === undefined) return null;
+    const { lo, hi } = splitSimhash(simhash);
+    return popcount32(this.lo[slot] ^ lo) + popcount32(this.hi[slot] ^ hi);
+  }
+
+  /**
+   * Find fingerprints within a Hamming radius
+   *
+   * @param {Buffer} simhash - Query fingerprint
+   * @param {Object} [options]
+   * @param {number} [options.threshold=maxRadius] - Maximum Hamming distance
+   * @param {number} [options.excludeId] - Content ID to skip
+   * @returns {Array<{contentId: number, distance: number}>} Unsorted matches
+   */
+  search(simhash, options = {}) {
+    const threshold = options.threshold ?? this.maxRadius;
+    const excludeId = options.excludeId ?? null;
+    const { lo, hi } = splitSimhash(simhash);
+    const results = [];
+
+    if (threshold > this.maxRadius) {
+      // Beyond the pigeonhole guarantee: scan the packed columns
+      for (let slot = 0; slot < this.highWater; slot++) {
+        if (!this.live[slot]) continue;
+        const distance = popcount32(this.lo[slot] ^ lo) + popcount32(this.hi[slot] ^ hi);
+        if (distance <= threshold && this.ids[slot] !== excludeId) {
+          results.push({ contentId: this.ids[slot], distance });
+        }
+      }
+      return results;
+    }
+
+    // A slot can sit in the probed bucket of several tables; stamp visited slots
+    const epoch = this._nextEpoch();
+    for (let b = 0; b < this.blocks.length; b++) {
+      const { start, width } = this.blocks[b];
+      const bucket = this.tables[b].get(extractBits(hi, lo, start, width));
+      if (!bucket) continue;
+      for (let i = 0; i < bucket.length; i++) {
+        const slot = bucket[i];
+        if (this.visited[slot] === epoch) continue;
+        this.visited[slot] = epoch;
+        const distance = popcount32(this.lo[slot] ^ lo) + popcount32(this.hi[slot] ^ hi);
+        if (distance <= threshold && this.ids[slot] !== excludeId) {
+          results.push({ contentId: this.ids[slot], distance });
+        }
+      }
+    }
+    return results;
+  }
+
+  /**
+   * Iterate stored entries as [contentId, lo, hi]
+   */
+  *entries() {
+    for (let slot = 0; slot < this.highWater; slot++) {
+      if (this.live[slot]) {
+        yield [this.ids[slot], this.lo[slot], this.hi[slot]];
+      }
+    }
+  }
+
+  clear() {
+    this.tables = this.blocks.map(() => new Map());
+    this.slotById.clear();
+    this.freeSlots = [];
+    this.highWater = 0;
+    this.live.fill(0);
+  }
+
+  /**
+   * @returns {Object} Table occupancy and memory figures
+   */
+  getStats() {
+    let maxBucketSize = 0;
+    let buckets = 0;
+    for (const table of this.tables) {
+      buckets += table.size;
+      for (const bucket of table.values()) {
+        if (bucket.length > maxBucketSize) maxBucketSize = bucket.length;
+      }
+    }
+    return {
+      size: this.size,
+      capacity: this.capacity,
+      maxRadius: this.maxRadius,
+      tables: this.blocks.length,
+      blockBits: this.blocks.map(block => block.width),
+      buckets,
+      maxBucketSize,
+      // Fingerprint, id, live and visited columns
+      columnBytes: this.capacity * (4 + 4 + 8 + 1 + 4)
+    };
+  }
+
+  /** @private */
+  _allocate(capacity) {
+    const grow = (Type, old) => {
+      const next = new Type(capacity);
+      if (old) next.set(old);
+      return next;
+    };
+    this.lo = grow(Uint32Array, this.lo);
+    this.hi = grow(Uint32Array, this.hi);
+    this.ids = grow(Float64Array, this.ids);
+    this.live = grow(Uint8Array, this.live);
+    this.visited = grow(Uint32Array, this.visited);
+    this.capacity = capacity;
+  }
+
+  /** @private */
+  _nextEpoch() {
+    this._epoch = (this._epoch + 1) >>> 0;
+    if (this._epoch === 0) {
+      // Wrapped after 2^32 queries: reset stamps so stale ones cannot match
+      this.visited.fill(0);
+      this._epoch = 1;
+    }
+    return this._epoch;
+  }
+}
+
+module.exports = {
+  SimHashIndex,
+  popcount32,
+  splitSimhash,
+  extractBits,
+  blockLayout,
+  DEFAULT_MAX_RADIUS
+};
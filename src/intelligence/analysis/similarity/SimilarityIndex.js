@@ -13,11 +13,23 @@
  * - At J=0.5: ~47% chance of at least one band collision
  * - At J=0.8: ~99% chance of at least one band collision
  * 
+ * SimHash fingerprints live in a SimHashIndex (packed columns plus
+ * multi-index hash tables), so findDuplicates probes a few buckets instead
+ * of computing the distance to every stored fingerprint.
+ * 
+ * An index can also sit on top of a read-only SimilaritySnapshot (see
+ * loadSnapshot). Items in the snapshot are answered from its typed arrays.
+ * Items added later go into the in-memory structures above. Removing a
+ * snapshot item tombstones it, and compact() folds both into a fresh
+ * snapshot.
+ * 
  * @module SimilarityIndex
  */
 
 const MinHasher = require('./MinHasher');
 const SimHasher = require('./SimHasher');
+const { SimHashIndex } = require('./SimHashIndex');
+const { SimilaritySnapshot } = require('./SimilaritySnapshot');
 
 // Default LSH configuration
 const DEFAULT_NUM_BANDS = 16;
@@ -46,8 +58,16 @@ class SimilarityIndex {
       this.bandBuckets.set(i, new Map());
     }
     
-    // Store fingerprints for verification: Map<contentId, {simhash, minhash}>
-    this.fingerprints = new Map();
+    // SimHash fingerprints in packed columns with multi-index tables
+    this.simhashes = new SimHashIndex({ maxRadius: Math.max(3, this.simhashThreshold) });
+    
+    // MinHash signatures for verification: Map<contentId, Buffer>
+    this.minhashes = new Map();
+    
+    // Read-only base layer loaded from disk, with tombstones over its ordinals
+    this.snapshot = null;
+    this._snapshotRemoved = null;
+    this._snapshotRemovedCount = 0;
   }
   
   /**
@@ -55,7 +75,16 @@ class SimilarityIndex {
    * @returns {number} Number of items in index
    */
   get size() {
-    return this.fingerprints.size;
+    const fromSnapshot = this.snapshot ? this.snapshot.count - this._snapshotRemovedCount : 0;
+    return this.simhashes.size + fromSnapshot;
+  }
+  
+  /**
+   * Items added since the snapshot was loaded
+   * @returns {number}
+   */
+  get pendingSize() {
+    return this.simhashes.size;
   }
   
   /**
@@ -77,7 +106,10 @@ class SimilarityIndex {
     this.remove(contentId);
     
     // Store fingerprints
-    this.fingerprints.set(contentId, { simhash, minhash });
+    this.simhashes.add(contentId, simhash);
+    if (minhash) {
+      this.minhashes.set(contentId, minhash);
+    }
     
     // Index MinHash bands if signature provided
     if (minhash) {
@@ -101,13 +133,19 @@ class SimilarityIndex {
    * @returns {boolean} True if item was removed
    */
   remove(contentId) {
-    const fp = this.fingerprints.get(contentId);
-    if (!fp) return false;
+    if (!this.simhashes.has(contentId)) {
+      const ordinal = this._snapshotOrdinal(contentId);
+      if (ordinal === -1) return false;
+      this._snapshotRemoved[ordinal] = 1;
+      this._snapshotRemovedCount++;
+      return true;
+    }
     
     // Remove from band buckets
-    if (fp.minhash) {
+    const minhash = this.minhashes.get(contentId);
+    if (minhash) {
       for (let b = 0; b < this.numBands; b++) {
-        const band = MinHasher.extractBand(fp.minhash, b, this.numBands, this.rowsPerBand);
+        const band = MinHasher.extractBand(minhash, b, this.numBands, this.rowsPerBand);
         const bucketHash = MinHasher.hashBand(band);
         
         const buckets = this.bandBuckets.get(b);
@@ -121,7 +159,8 @@ class SimilarityIndex {
       }
     }
     
-    this.fingerprints.delete(contentId);
+    this.simhashes.remove(contentId);
+    this.minhashes.delete(contentId);
     return true;
   }
   
@@ -163,18 +202,25 @@ class SimilarityIndex {
             }
           }
         }
+        
+        if (this.snapshot) {
+          const postings = this.snapshot.bandPostings(b, MinHasher.hashBandValue(band));
+          for (let p = 0; p < postings.length; p++) {
+            const ordinal = postings[p];
+            const id = this.snapshot.ids[ordinal];
+            if (!this._snapshotRemoved[ordinal] && id !== excludeId) {
+              candidates.add(id);
+            }
+          }
+        }
       }
     }
     
     // If no LSH candidates, fall back to SimHash screening (slower)
     if (candidates.size === 0) {
-      for (const [id, fp] of this.fingerprints) {
-        if (id !== excludeId) {
-          const distance = SimHasher.hammingDistance(simhash, fp.simhash);
-          if (distance <= this.simhashThreshold * 2) {
-            candidates.add(id);
-          }
-        }
+      const matches = this._searchSimhash(simhash, this.simhashThreshold * 2, excludeId);
+      for (const match of matches) {
+        candidates.add(match.contentId);
       }
     }
     
@@ -182,17 +228,21 @@ class SimilarityIndex {
     const results = [];
     
     for (const candidateId of candidates) {
-      const fp = this.fingerprints.get(candidateId);
-      if (!fp) continue;
-      
       // Calculate SimHash distance
-      const simhashDistance = SimHasher.hammingDistance(simhash, fp.simhash);
+      let simhashDistance = this.simhashes.distance(candidateId, simhash);
+      let candidateMinhash = this.minhashes.get(candidateId);
+      if (simhashDistance === null) {
+        const ordinal = this._snapshotOrdinal(candidateId);
+        if (ordinal === -1) continue;
+        simhashDistance = this.snapshot.distanceAt(ordinal, simhash);
+        candidateMinhash = this.snapshot.minhashAt(ordinal);
+      }
       const matchType = SimHasher.getMatchType(simhashDistance);
       
       // Calculate MinHash similarity if both have signatures
       let similarity;
-      if (minhash && fp.minhash) {
-        similarity = MinHasher.jaccardSimilarity(minhash, fp.minhash);
+      if (minhash && candidateMinhash) {
+        similarity = MinHasher.jaccardSimilarity(minhash, candidateMinhash);
       } else {
         // Fall back to SimHash-based similarity estimate
         similarity = SimHasher.distanceToSimilarity(simhashDistance);
@@ -231,19 +281,10 @@ class SimilarityIndex {
       throw new Error('simhash must be an 8-byte Buffer');
     }
     
-    const results = [];
-    
-    for (const [id, fp] of this.fingerprints) {
-      if (id === excludeId) continue;
-      
-      const distance = SimHasher.hammingDistance(simhash, fp.simhash);
-      if (distance <= threshold) {
-        results.push({
-          contentId: id,
-          distance,
-          matchType: SimHasher.getMatchType(distance)
-        });
-      }
+    // Radius <= simhashes.maxRadius probes the multi-index tables; wider radii scan the packed columns
+    const results = this._searchSimhash(simhash, threshold, excludeId);
+    for (const result of results) {
+      result.matchType = SimHasher.getMatchType(result.distance);
     }
     
     // Sort by distance ascending (closest first)
@@ -259,7 +300,13 @@ class SimilarityIndex {
    * @returns {{simhash: Buffer, minhash: Buffer} | null} Fingerprints or null
    */
   get(contentId) {
-    return this.fingerprints.get(contentId) || null;
+    const simhash = this.simhashes.get(contentId);
+    if (!simhash) {
+      const ordinal = this._snapshotOrdinal(contentId);
+      if (ordinal === -1) return null;
+      return { simhash: this.snapshot.simhashAt(ordinal), minhash: this.snapshot.minhashAt(ordinal) };
+    }
+    return { simhash, minhash: this.minhashes.get(contentId) || null };
   }
   
   /**
@@ -269,7 +316,7 @@ class SimilarityIndex {
    * @returns {boolean} True if exists
    */
   has(contentId) {
-    return this.fingerprints.has(contentId);
+    return this.simhashes.has(contentId) || this._snapshotOrdinal(contentId) !== -1;
   }
   
   /**
@@ -279,7 +326,108 @@ class SimilarityIndex {
     for (let i = 0; i < this.numBands; i++) {
       this.bandBuckets.set(i, new Map());
     }
-    this.fingerprints.clear();
+    this.simhashes.clear();
+    this.minhashes.clear();
+    this.snapshot = null;
+    this._snapshotRemoved = null;
+    this._snapshotRemovedCount = 0;
+  }
+  
+  /**
+   * Use a snapshot as the index contents, replacing whatever was indexed
+   * 
+   * @param {SimilaritySnapshot|Buffer} snapshot - Snapshot or its serialized bytes
+   * @returns {number} Number of items loaded
+   */
+  loadSnapshot(snapshot) {
+    const base = Buffer.isBuffer(snapshot) ? SimilaritySnapshot.fromBuffer(snapshot) : snapshot;
+    if (base.numBands !== this.numBands || base.rowsPerBand !== this.rowsPerBand) {
+      throw new Error(`Snapshot band layout ${base.numBands}x${base.rowsPerBand} does not match index ${this.numBands}x${this.rowsPerBand}`);
+    }
+    if (base.maxRadius !== this.simhashes.maxRadius) {
+      throw new Error(`Snapshot SimHash radius ${base.maxRadius} does not match index ${this.simhashes.maxRadius}`);
+    }
+    this.clear();
+    this.snapshot = base;
+    this._snapshotRemoved = new Uint8Array(base.count);
+    return base.count;
+  }
+  
+  /**
+   * Serialize every live item (snapshot and in-memory) to snapshot bytes
+   * 
+   * @param {{rows: number, maxContentId: number}} [source] - DB watermark for the header
+   * @returns {Buffer} Buffer for SimilaritySnapshot.fromBuffer / loadSnapshot
+   */
+  toSnapshot(source) {
+    return SimilaritySnapshot.build(this._liveEntries(), {
+      numBands: this.numBands,
+      rowsPerBand: this.rowsPerBand,
+      maxRadius: this.simhashes.maxRadius,
+      source
+    });
+  }
+  
+  /**
+   * Fold in-memory items and tombstones into a new snapshot and switch to it
+   * 
+   * @param {{rows: number, maxContentId: number}} [source] - DB watermark for the header
+   * @returns {Buffer} The new snapshot bytes (for persisting)
+   */
+  compact(source) {
+    const bytes = this.toSnapshot(source);
+    this.loadSnapshot(SimilaritySnapshot.fromBuffer(bytes));
+    return bytes;
+  }
+  
+  /**
+   * @private
+   * @returns {number} Live snapshot ordinal for a content ID, or -1
+   */
+  _snapshotOrdinal(contentId) {
+    if (!this.snapshot) return -1;
+    const ordinal = this.snapshot.ordinalOf(contentId);
+    return ordinal !== -1 && !this._snapshotRemoved[ordinal] ? ordinal : -1;
+  }
+  
+  /**
+   * SimHash radius search across the snapshot and in-memory items
+   * @private
+   */
+  _searchSimhash(simhash, threshold, excludeId) {
+    const results = this.simhashes.search(simhash, { threshold, excludeId });
+    if (this.snapshot) {
+      const { ids } = this.snapshot;
+      this.snapshot.searchSimhash(simhash, threshold, (ordinal, distance) => {
+        if (!this._snapshotRemoved[ordinal] && ids[ordinal] !== excludeId) {
+          results.push({ contentId: ids[ordinal], distance });
+        }
+      });
+    }
+    return results;
+  }
+  
+  /**
+   * @private
+   */
+  *_liveEntries() {
+    if (this.snapshot) {
+      for (let ordinal = 0; ordinal < this.snapshot.count; ordinal++) {
+        if (this._snapshotRemoved[ordinal]) continue;
+        yield {
+          contentId: this.snapshot.ids[ordinal],
+          simhash: this.snapshot.simhashAt(ordinal),
+          minhash: this.snapshot.minhashAt(ordinal)
+        };
+      }
+    }
+    for (const [contentId] of this.simhashes.entries()) {
+      yield {
+        contentId,
+        simhash: this.simhashes.get(contentId),
+        minhash: this.minhashes.get(contentId) || null
+      };
+    }
   }
   
   /**
@@ -308,13 +456,21 @@ class SimilarityIndex {
     if (minBucketSize === Infinity) minBucketSize = 0;
     
     return {
-      itemCount: this.fingerprints.size,
+      itemCount: this.size,
       numBands: this.numBands,
       rowsPerBand: this.rowsPerBand,
       totalBuckets,
       avgBucketSize: totalBuckets > 0 ? totalBucketItems / totalBuckets : 0,
       maxBucketSize,
-      minBucketSize
+      minBucketSize,
+      simhash: this.simhashes.getStats(),
+      snapshot: this.snapshot ? {
+        itemCount: this.snapshot.count,
+        removed: this._snapshotRemovedCount,
+        pending: this.simhashes.size,
+        bytes: this.snapshot.byteLength,
+        createdAt: new Date(this.snapshot.createdAt).toISOString()
+      } : null
     };
   }
   
@@ -0,0 +1,215 @@
+'use strict';
+
+/**
+ * SimilarityIndexStore - On-disk persistence for a SimilarityIndex
+ *
+ * Two files:
+ * - `<path>`: a SimilaritySnapshot, loaded in one read at startup;
+ * - `<path>.log`: fixed-size records for every add/remove since that
+ *   snapshot, replayed into the index's in-memory layer on load.
+ *
+ * Appends are a single write each. Once the log holds `compactEvery`
+ * records, the index is compacted. A new snapshot is written to a temp file
+ * and renamed into place, and then the log is truncated. A torn record at the end of the
+ * log (crash mid-write) is ignored.
+ *
+ * The snapshot header carries the DB watermark (fingerprint rows and highest
+ * content id) it was cut from. watermark() moves it forward with the log so a
+ * caller can compare it against the DB and rebuild a stale index.
+ *
+ * @module SimilarityIndexStore
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { SimilaritySnapshot } = require('./SimilaritySnapshot');
+
+const OP_ADD = 1;
+const OP_REMOVE = 2;
+
+class SimilarityIndexStore {
+  /**
+   * @param {Object} options
+   * @param {string} options.path - Snapshot file path
+   * @param {import('./SimilarityIndex').SimilarityIndex} options.index - Index to load into and persist
+   * @param {number} [options.compactEvery=10000] - Log records that trigger compaction
+   * @param {Object} [options.logger=console]
+   */
+  constructor(options = {}) {
+    if (!options.path) {
+      throw new Error('SimilarityIndexStore requires a path');
+    }
+    if (!options.index) {
+      throw new Error('SimilarityIndexStore requires an index');
+    }
+    this.path = options.path;
+    this.logPath = `${options.path}.log`;
+    this.index = options.index;
+    this.compactEvery = Math.max(1, options.compactEvery || 10000);
+    this.logger = options.logger || console;
+
+    this.signatureBytes = this.index.numBands * this.index.rowsPerBand * 4;
+    // op(1) + contentId(f64) + simhash(8) + hasMinhash(1) + signature
+    this.recordBytes = 1 + 8 + 8 + 1 + this.signatureBytes;
+    this.logRecords = 0;
+    this._fd = null;
+    this._source = { rows: 0, maxContentId: 0 };
+    this._baseSize = 0;
+    this._maxAdded = 0;
+  }
+
+  /**
+   * @returns {boolean} True if a snapshot exists on disk
+   */
+  exists() {
+    return fs.existsSync(this.path);
+  }
+
+  /**
+   * Load the snapshot and replay the log into the index
+   * @returns {{loaded: boolean, snapshotItems: number, replayed: number, source: {rows: number, maxContentId: number}|null, durationMs: number}}
+   */
+  load() {
+    const started = Date.now();
+    if (!this.exists()) {
+      return { loaded: false, snapshotItems: 0, replayed: 0, source: null, durationMs: 0 };
+    }
+    const snapshot = SimilaritySnapshot.load(this.path);
+    const snapshotItems = this.index.loadSnapshot(snapshot);
+    this._resetWatermark(snapshot);
+    const replayed = this._replayLog();
+    return { loaded: true, snapshotItems, replayed, source: this.watermark(), durationMs: Date.now() - started };
+  }
+
+  /**
+   * DB fingerprint rows and highest content id the index should mirror:
+   * the snapshot header plus everything appended since
+   * @returns {{rows: number, maxContentId: number}}
+   */
+  watermark() {
+    return {
+      rows: this._source.rows + (this.index.size - this._baseSize),
+      maxContentId: Math.max(this._source.maxContentId, this._maxAdded)
+    };
+  }
+
+  /**
+   * Record an add (call after index.add)
+   * @param {number} contentId
+   * @param {Buffer} simhash
+   * @param {Buffer|null} minhash
+   */
+  append(contentId, simhash, minhash) {
+    if (contentId > this._maxAdded) this._maxAdded = contentId;
+    const record = Buffer.alloc(this.recordBytes);
+    record[0] = OP_ADD;
+    record.writeDoubleLE(contentId, 1);
+    simhash.copy(record, 9);
+    if (minhash) {
+      record[17] = 1;
+      minhash.copy(record, 18);
+    }
+    this._write(record);
+  }
+
+  /**
+   * Record a removal (call after index.remove)
+   * @param {number} contentId
+   */
+  appendRemove(contentId) {
+    const record = Buffer.alloc(this.recordBytes);
+    record[0] = OP_REMOVE;
+    record.writeDoubleLE(contentId, 1);
+    this._write(record);
+  }
+
+  /**
+   * @returns {boolean} True if the log is large enough to compact
+   */
+  shouldCompact() {
+    return this.logRecords >= this.compactEvery;
+  }
+
+  /**
+   * Compact if the log has reached compactEvery records
+   * @returns {boolean} True if compaction ran
+   */
+  maybeCompact() {
+    if (!this.shouldCompact()) return false;
+    this.compact();
+    return true;
+  }
+
+  /**
+   * Write the whole index as a new snapshot and truncate the log
+   * @param {{rows: number, maxContentId?: number}} [source] - DB watermark (defaults to watermark())
+   * @returns {{items: number, bytes: number, durationMs: number}}
+   */
+  compact(source = this.watermark()) {
+    const started = Date.now();
+    const bytes = this.index.compact(source);
+    this._resetWatermark(this.index.snapshot);
+    fs.mkdirSync(path.dirname(this.path), { recursive: true });
+    const tmpPath = `${this.path}.tmp`;
+    fs.writeFileSync(tmpPath, bytes);
+    fs.renameSync(tmpPath, this.path);
+
+    this.close();
+    fs.rmSync(this.logPath, { force: true });
+    this.logRecords = 0;
+    return { items: this.index.size, bytes: bytes.length, durationMs: Date.now() - started };
+  }
+
+  close() {
+    if (this._fd !== null) {
+      fs.closeSync(this._fd);
+      this._fd = null;
+    }
+  }
+
+  /** @private */
+  _resetWatermark(snapshot) {
+    this._source = { rows: snapshot.sourceRows, maxContentId: snapshot.sourceMaxId };
+    this._baseSize = this.index.size;
+    this._maxAdded = 0;
+  }
+
+  /** @private */
+  _write(record) {
+    if (this._fd === null) {
+      fs.mkdirSync(path.dirname(this.logPath), { recursive: true });
+      this._fd = fs.openSync(this.logPath, 'a');
+    }
+    fs.writeSync(this._fd, record);
+    this.logRecords++;
+    this.maybeCompact();
+  }
+
+  /** @private */
+  _replayLog() {
+    if (!fs.existsSync(this.logPath)) return 0;
+    const log = fs.readFileSync(this.logPath);
+    const complete = Math.floor(log.length / this.recordBytes);
+    if (complete * this.recordBytes !== log.length) {
+      this.logger.warn(`[SimilarityIndexStore] Ignoring torn record at end of ${this.logPath}`);
+      // Drop the partial tail so later appends stay record-aligned
+      fs.truncateSync(this.logPath, complete * this.recordBytes);
+    }
+    for (let i = 0; i < complete; i++) {
+      const offset = i * this.recordBytes;
+      const contentId = log.readDoubleLE(offset + 1);
+      if (log[offset] === OP_REMOVE) {
+        this.index.remove(contentId);
+      } else if (log[offset] === OP_ADD) {
+        const simhash = Buffer.from(log.subarray(offset + 9, offset + 17));
+        const minhash = log[offset + 17] ? Buffer.from(log.subarray(offset + 18, offset + this.recordBytes)) : null;
+        this.index.add(contentId, simhash, minhash);
+        if (contentId > this._maxAdded) this._maxAdded = contentId;
+      }
+    }
+    this.logRecords = complete;
+    return complete;
+  }
+}
+
+module.exports = { SimilarityIndexStore };
@@ -0,0 +1,407 @@
+'use strict';
+
+/**
+ * SimilaritySnapshot - Read-only binary image of a SimilarityIndex
+ *
+ * Rebuilding the LSH bands from the database means one Map-of-Map-of-Set
+ * entry per (article, band) and minutes of startup at millions of articles.
+ * A snapshot keeps the same information in flat typed arrays:
+ * - id, SimHash-lo and SimHash-hi columns, sorted by content id (binary
+ *   search replaces the id Map);
+ * - MinHash signatures packed back to back in one Buffer;
+ * - one CSR table per LSH band and per SimHash block: sorted distinct bucket
+ *   keys, offsets into a postings array, and postings holding item ordinals.
+ *
+ * Loading is a single file read, after which every column is a zero-copy view
+ * of that Buffer. Nothing is rebuilt and almost nothing sits on the JS heap.
+ * The file must fit in one Buffer (buffer.constants.MAX_LENGTH).
+ *
+ * Layout (little endian, every section 8-byte aligned):
+ *   header   64 bytes: magic "SIMSNAP1", u32 version, u32 count,
+ *            u32 numBands, u32 rowsPerBand, u32 maxRadius,
+ *            u32 sectionCount, f64 createdAt,
+ *            f64 sourceRows, f64 sourceMaxId (DB fingerprint count and
+ *            highest content id the snapshot was cut from)
+ *   sections sectionCount x (f64 offset, f64 byteLength)
+ *   data     ids, lo, hi, minhashFlags, minhashes,
+ *            then (keys, offsets, postings) per band and per SimHash block
+ *
+ * @module SimilaritySnapshot
+ */
+
+const fs = require('fs');
+const MinHasher = require('./MinHasher');
+const { popcount32, splitSimhash, extractBits, blockLayout } = require('./SimHashIndex');
+
+const MAGIC = 'SIMSNAP1';
+const VERSION = 1;
+const HEADER_BYTES = 64;
+const SECTION_ENTRY_BYTES = 16;
+
+function align8(n) {
+  return Math.ceil(n / 8) * 8;
+}
+
+/**
+ * Stable sort of (key, value) pairs by 32-bit key: two 16-bit LSD radix passes
+ * @param {Uint32Array} keys
+ * @param {Uint32Array} values
+ * @returns {{keys: Uint32Array, values: Uint32Array}}
+ */
+function radixSortPairs(keys, values) {
+  const n = keys.length;
+  let srcK = keys;
+  let srcV = values;
+  let dstK = new Uint32Array(n);
+  let dstV = new Uint32Array(n);
+  const counts = new Uint32Array(65537);
+  for (const shift of [0, 16]) {
+    counts.fill(0);
+    for (let i = 0; i < n; i++) counts[((srcK[i] >>> shift) & 0xFFFF) + 1]++;
+    for (let i = 1; i < counts.length; i++) counts[i] += counts[i - 1];
+    for (let i = 0; i < n; i++) {
+      const pos = counts[(srcK[i] >>> shift) & 0xFFFF]++;
+      dstK[pos] = srcK[i];
+      dstV[pos] = srcV[i];
+    }
+    [srcK, dstK] = [dstK, srcK];
+    [srcV, dstV] = [dstV, srcV];
+  }
+  return { keys: srcK, values: srcV };
+}
+
+/**
+ * Group sorted (key, ordinal) pairs into a CSR table
+ */
+function buildTable(keys, ordinals) {
+  const sorted = radixSortPairs(keys, ordinals);
+  let distinct = 0;
+  for (let i = 0; i < sorted.keys.length; i++) {
+    if (i === 0 || sorted.keys[i] !== sorted.keys[i - 1]) distinct++;
+  }
+  const tableKeys = new Uint32Array(distinct);
+  const offsets = new Uint32Array(distinct + 1);
+  let k = -1;
+  for (let i = 0; i < sorted.keys.length; i++) {
+    if (i === 0 || sorted.keys[i] !== sorted.keys[i - 1]) {
+      k++;
+      tableKeys[k] = sorted.keys[i];
+      offsets[k] = i;
+    }
+  }
+  offsets[distinct] = sorted.keys.length;
+  return { keys: tableKeys, offsets, postings: sorted.values };
+}
+
+/**
+ * Binary search for `key` in a sorted typed array
+ * @returns {number} Index, or -1
+ */
+function lowerBound(array, key) {
+  let lo = 0;
+  let hi = array.length - 1;
+  while (lo <= hi) {
+    const mid = (lo + hi) >>> 1;
+    const value = array[mid];
+    if (value === key) return mid;
+    if (value < key) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return -1;
+}
+
+class SimilaritySnapshot {
+  /**
+   * @private Use SimilaritySnapshot.fromBuffer / load
+   */
+  constructor(fields) {
+    Object.assign(this, fields);
+    this._visited = null;
+    this._epoch = 0;
+  }
+
+  /**
+   * Serialize fingerprints into a snapshot Buffer
+   *
+   * @param {Iterable<{contentId: number, simhash: Buffer, minhash: Buffer|null}>} entries - Unique content IDs, any order
+   * @param {Object} [options]
+   * @param {number} [options.numBands=16]
+   * @param {number} [options.rowsPerBand=8]
+   * @param {number} [options.maxRadius=3] - SimHash block tables, as in SimHashIndex
+   * @param {{rows: number, maxContentId: number}} [options.source] - DB watermark (defaults to the entries themselves)
+   * @returns {Buffer}
+   */
+  static build(entries, options = {}) {
+    const numBands = options.numBands || 16;
+    const rowsPerBand = options.rowsPerBand || 8;
+    const maxRadius = options.maxRadius ?? 3;
+    const signatureBytes = numBands * rowsPerBand * 4;
+    const blocks = blockLayout(maxRadius);
+
+    const list = Array.from(entries).sort((a, b) => a.contentId - b.contentId);
+    const count = list.length;
+
+    const ids = new Float64Array(count);
+    const lo = new Uint32Array(count);
+    const hi = new Uint32Array(count);
+    const minhashFlags = new Uint8Array(count);
+    const minhashes = Buffer.alloc(count * signatureBytes);
+    let withMinhash = 0;
+
+    for (let i = 0; i < count; i++) {
+      const entry = list[i];
+      ids[i] = entry.contentId;
+      const halves = splitSimhash(entry.simhash);
+      lo[i] = halves.lo;
+      hi[i] = halves.hi;
+      if (entry.minhash) {
+        if (entry.minhash.length !== signatureBytes) {
+          throw new Error(`minhash must be a ${signatureBytes}-byte Buffer`);
+        }
+        minhashFlags[i] = 1;
+        entry.minhash.copy(minhashes, i * signatureBytes);
+        withMinhash++;
+      }
+    }
+
+    const tables = [];
+    for (let b = 0; b < numBands; b++) {
+      const keys = new Uint32Array(withMinhash);
+      const ordinals = new Uint32Array(withMinhash);
+      let n = 0;
+      for (let i = 0; i < count; i++) {
+        if (!minhashFlags[i]) continue;
+        const signature = minhashes.subarray(i * signatureBytes, (i + 1) * signatureBytes);
+        keys[n] = MinHasher.hashBandValue(MinHasher.extractBand(signature, b, numBands, rowsPerBand));
+        ordinals[n] = i;
+        n++;
+      }
+      tables.push(buildTable(keys, ordinals));
+    }
+    for (const { start, width } of blocks) {
+      const keys = new Uint32Array(count);
+      const ordinals = new Uint32Array(count);
+      for (let i = 0; i < count; i++) {
+        keys[i] = extractBits(hi[i], lo[i], start, width);
+        ordinals[i] = i;
+      }
+      tables.push(buildTable(keys, ordinals));
+    }
+
+    const sections = [ids, lo, hi, minhashFlags, minhashes];
+    for (const table of tables) {
+      sections.push(table.keys, table.offsets, table.postings);
+    }
+
+    let offset = align8(HEADER_BYTES + sections.length * SECTION_ENTRY_BYTES);
+    const layout = sections.map((section) => {
+      const entry = { offset, byteLength: section.byteLength };
+      offset = align8(offset + section.byteLength);
+      return entry;
+    });
+
+    const out = Buffer.alloc(offset);
+    out.write(MAGIC, 0, 'latin1');
+    out.writeUInt32LE(VERSION, 8);
+    out.writeUInt32LE(count, 12);
+    out.writeUInt32LE(numBands, 16);
+    out.writeUInt32LE(rowsPerBand, 20);
+    out.writeUInt32LE(maxRadius, 24);
+    out.writeUInt32LE(sections.length, 28);
+    out.writeDoubleLE(Date.now(), 32);
+    const source = options.source || {};
+    out.writeDoubleLE(Number.isFinite(source.rows) ? source.rows : count, 40);
+    out.writeDoubleLE(Number.isFinite(source.maxContentId) ? source.maxContentId : (count ? ids[count - 1] : 0), 48);
+    sections.forEach((section, i) => {
+      const pos = HEADER_BYTES + i * SECTION_ENTRY_BYTES;
+      out.writeDoubleLE(layout[i].offset, pos);
+      out.writeDoubleLE(layout[i].byteLength, pos + 8);
+      Buffer.from(section.buffer, section.byteOffset, section.byteLength).copy(out, layout[i].offset);
+    });
+    return out;
+  }
+
+  /**
+   * Wrap a snapshot Buffer without copying its columns
+   * @param {Buffer} buffer
+   * @returns {SimilaritySnapshot}
+   */
+  static fromBuffer(buffer) {
+    if (!Buffer.isBuffer(buffer) || buffer.length < HEADER_BYTES || buffer.toString('latin1', 0, 8) !== MAGIC) {
+      throw new Error('Not a similarity index snapshot');
+    }
+    const version = buffer.readUInt32LE(8);
+    if (version !== VERSION) {
+      throw new Error(`Unsupported similarity snapshot version: ${version}`);
+    }
+    if (buffer.byteOffset % 8 !== 0) {
+      // Typed-array views need aligned offsets (pooled or sliced Buffers may not be)
+      const copy = Buffer.alloc(buffer.length);
+      buffer.copy(copy);
+      buffer = copy;
+    }
+
+    const count = buffer.readUInt32LE(12);
+    const numBands = buffer.readUInt32LE(16);
+    const rowsPerBand = buffer.readUInt32LE(20);
+    const maxRadius = buffer.readUInt32LE(24);
+    const sectionCount = buffer.readUInt32LE(28);
+    const blocks = blockLayout(maxRadius);
+    if (sectionCount !== 5 + 3 * (numBands + blocks.length)) {
+      throw new Error('Corrupt similarity snapshot: section table does not match header');
+    }
+
+    let next = 0;
+    const view = (Type) => {
+      const pos = HEADER_BYTES + next * SECTION_ENTRY_BYTES;
+      next++;
+      const offset = buffer.readDoubleLE(pos);
+      const byteLength = buffer.readDoubleLE(pos + 8);
+      if (offset + byteLength > buffer.length) {
+        throw new Error('Corrupt similarity snapshot: section out of range');
+      }
+      if (Type === Buffer) return buffer.subarray(offset, offset + byteLength);
+      return new Type(buffer.buffer, buffer.byteOffset + offset, byteLength / Type.BYTES_PER_ELEMENT);
+    };
+    const readTable = () => ({ keys: view(Uint32Array), offsets: view(Uint32Array), postings: view(Uint32Array) });
+
+    const fields = {
+      buffer,
+      count,
+      numBands,
+      rowsPerBand,
+      maxRadius,
+      blocks,
+      signatureBytes: numBands * rowsPerBand * 4,
+      createdAt: buffer.readDoubleLE(32),
+      sourceRows: buffer.readDoubleLE(40),
+      sourceMaxId: buffer.readDoubleLE(48),
+      ids: view(Float64Array),
+      lo: view(Uint32Array),
+      hi: view(Uint32Array),
+      minhashFlags: view(Uint8Array),
+      minhashes: view(Buffer)
+    };
+    fields.bandTables = Array.from({ length: numBands }, readTable);
+    fields.blockTables = blocks.map(readTable);
+    return new SimilaritySnapshot(fields);
+  }
+
+  /**
+   * Read a snapshot file in one read
+   * @param {string} filePath
+   * @returns {SimilaritySnapshot}
+   */
+  static load(filePath) {
+    const fd = fs.openSync(filePath, 'r');
+    try {
+      const { size } = fs.fstatSync(fd);
+      // Not readFileSync: it caps at 2 GB, a single Buffer can hold more
+      const buffer = Buffer.alloc(size);
+      let read = 0;
+      while (read < size) {
+        const n = fs.readSync(fd, buffer, read, Math.min(size - read, 0x40000000), read);
+        if (n === 0) break;
+        read += n;
+      }
+      return SimilaritySnapshot.fromBuffer(buffer.subarray(0, read));
+    } finally {
+      fs.closeSync(fd);
+    }
+  }
+
+  get byteLength() {
+    return this.buffer.length;
+  }
+
+  /**
+   * @param {number} contentId
+   * @returns {number} Ordinal, or -1
+   */
+  ordinalOf(contentId) {
+    return lowerBound(this.ids, contentId);
+  }
+
+  /**
+   * SimHash of an ordinal as an 8-byte Buffer
+   */
+  simhashAt(ordinal) {
+    const buffer = Buffer.alloc(8);
+    buffer.writeUInt32LE(this.lo[ordinal], 0);
+    buffer.writeUInt32LE(this.hi[ordinal], 4);
+    return buffer;
+  }
+
+  /**
+   * MinHash signature of an ordinal (a view into the snapshot), or null
+   */
+  minhashAt(ordinal) {
+    if (!this.minhashFlags[ordinal]) return null;
+    return this.minhashes.subarray(ordinal * this.signatureBytes, (ordinal + 1) * this.signatureBytes);
+  }
+
+  distanceAt(ordinal, simhash) {
+    const { lo, hi } = splitSimhash(simhash);
+    return popcount32(this.lo[ordinal] ^ lo) + popcount32(this.hi[ordinal] ^ hi);
+  }
+
+  /**
+   * Ordinals sharing a band bucket with a MinHash signature
+   * @param {number} band
+   * @param {number} bucketValue - MinHasher.hashBandValue of the band
+   * @returns {Uint32Array}
+   */
+  bandPostings(band, bucketValue) {
+    return postingsFor(this.bandTables[band], bucketValue);
+  }
+
+  /**
+   * Ordinals within a Hamming radius of a SimHash
+   * @param {Buffer} simhash
+   * @param {number} threshold
+   * @param {(ordinal: number, distance: number) => void} visit
+   */
+  searchSimhash(simhash, threshold, visit) {
+    const { lo, hi } = splitSimhash(simhash);
+    if (threshold > this.maxRadius) {
+      for (let i = 0; i < this.count; i++) {
+        const distance = popcount32(this.lo[i] ^ lo) + popcount32(this.hi[i] ^ hi);
+        if (distance <= threshold) visit(i, distance);
+      }
+      return;
+    }
+
+    if (!this._visited) this._visited = new Uint32Array(this.count);
+    this._epoch = (this._epoch + 1) >>> 0;
+    if (this._epoch === 0) {
+      this._visited.fill(0);
+      this._epoch = 1;
+    }
+    for (let b = 0; b < this.blocks.length; b++) {
+      const { start, width } = this.blocks[b];
+      const postings = postingsFor(this.blockTables[b], extractBits(hi, lo, start, width));
+      for (let p = 0; p < postings.length; p++) {
+        const i = postings[p];
+        if (this._visited[i] === this._epoch) continue;
+        this._visited[i] = this._epoch;
+        const distance = popcount32(this.lo[i] ^ lo) + popcount32(this.hi[i] ^ hi);
+        if (distance <= threshold) visit(i, distance);
+      }
+    }
+  }
+}
+
+const EMPTY_POSTINGS = new Uint32Array(0);
+
+function postingsFor(table, key) {
+  const k = lowerBound(table.keys, key);
+  if (k === -1) return EMPTY_POSTINGS;
+  return table.postings.subarray(table.offsets[k], table.offsets[k + 1]);
+}
+
+module.exports = {
+  SimilaritySnapshot,
+  radixSortPairs,
+  SNAPSHOT_MAGIC: MAGIC,
+  SNAPSHOT_VERSION: VERSION
+};
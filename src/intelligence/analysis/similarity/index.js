@@ -7,6 +7,7 @@
  * - SimHash: 64-bit fingerprints for near-duplicate detection
  * - MinHash: 128-hash signatures for Jaccard similarity estimation
  * - LSH: Locality-Sensitive Hashing for fast similarity search
+ * - Snapshots: binary index images for fast startup
  * 
  * @module analysis/similarity
  */
@@ -14,6 +15,9 @@
 const SimHasher = require('./SimHasher');
 const MinHasher = require('./MinHasher');
 const { SimilarityIndex, createIndex } = require('./SimilarityIndex');
+const { SimHashIndex } = require('./SimHashIndex');
+const { SimilaritySnapshot } = require('./SimilaritySnapshot');
+const { SimilarityIndexStore } = require('./SimilarityIndexStore');
 const { DuplicateDetector, createDuplicateDetector, MIN_WORD_COUNT } = require('./DuplicateDetector');
 
 module.exports = {
@@ -26,6 +30,11 @@ module.exports = {
   // LSH Index
   SimilarityIndex,
   createIndex,
+  SimHashIndex,
+  
+  // Persistence
+  SimilaritySnapshot,
+  SimilarityIndexStore,
   
   // Main Service
   DuplicateDetector,
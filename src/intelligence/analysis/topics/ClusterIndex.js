@@ -0,0 +1,291 @@
+'use strict';
+
+/**
+ * ClusterIndex - In-memory candidate retrieval for StoryClustering
+ *
+ * Matching a new article against story clusters needs, per cluster, the
+ * SimHashes and entities of its first articles (up to REPRESENTATIVES_PER_CLUSTER).
+ * This index keeps exactly that, so matching needs no DB reads:
+ * - representative SimHashes are registered in a SimilarityIndex, so
+ *   findDuplicates(radius) returns only clusters with a representative
+ *   within the Hamming radius (multi-index block probes, no scan);
+ * - an entity -> cluster inverted index holds occurrence counts, so entity
+ *   overlap for a candidate is a few Map lookups;
+ * - clusters are bucketed by the hour of their last update, so clusters past
+ *   the active window can be pruned without walking them all.
+ *
+ * @module ClusterIndex
+ */
+
+const { SimilarityIndex } = require('../similarity/SimilarityIndex');
+
+// Same cap StoryClustering has always used when reading cluster fingerprints/entities
+const REPRESENTATIVES_PER_CLUSTER = 10;
+const HOUR_MS = 60 * 60 * 1000;
+
+/**
+ * Normalize entity text the way calculateEntityOverlap does
+ * @param {{text?: string, entity_text?: string}} entity
+ * @returns {string|null}
+ */
+function normalizeEntity(entity) {
+  const text = entity && (entity.text || entity.entity_text);
+  return typeof text === 'string' ? text.toLowerCase().trim() : null;
+}
+
+function toSimhashBuffer(simhash) {
+  if (!simhash) return null;
+  const buffer = Buffer.isBuffer(simhash) ? simhash : Buffer.from(simhash, 'hex');
+  return buffer.length === 8 ? buffer : null;
+}
+
+class ClusterIndex {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxHammingDistance=3] - Radius the SimHash tables are built for
+   * @param {number} [options.representatives=10] - Articles per cluster used for matching
+   */
+  constructor(options = {}) {
+    this.maxHammingDistance = options.maxHammingDistance || 3;
+    this.representatives = options.representatives || REPRESENTATIVES_PER_CLUSTER;
+
+    this.simhashes = new SimilarityIndex({ simhashThreshold: this.maxHammingDistance });
+    this.repCluster = new Map(); // representative key -> clusterId
+    this.entityClusters = new Map(); // normalized entity -> Map<clusterId, occurrences>
+    this.hourBuckets = new Map(); // hour number -> Set<clusterId>
+    this.clusters = new Map(); // clusterId -> entry
+    this._nextRepKey = 1;
+  }
+
+  get size() {
+    return this.clusters.size;
+  }
+
+  /**
+   * @param {number} clusterId
+   * @returns {Object|undefined} Cluster entry ({id, headline, articleIds, lastUpdated, ...})
+   */
+  get(clusterId) {
+    return this.clusters.get(clusterId);
+  }
+
+  /**
+   * Register (or re-register) a cluster
+   * @param {Object} cluster
+   * @param {number} cluster.id
+   * @param {string} [cluster.headline]
+   * @param {Iterable<number>} cluster.articleIds - In stored order; the first ones become representatives
+   * @param {Date} [cluster.lastUpdated]
+   */
+  upsertCluster(cluster) {
+    this.removeCluster(cluster.id);
+    const entry = {
+      id: cluster.id,
+      headline: cluster.headline,
+      articleIds: new Set(cluster.articleIds),
+      lastUpdated: cluster.lastUpdated instanceof Date ? cluster.lastUpdated : new Date(cluster.lastUpdated || Date.now()),
+      isActive: cluster.isActive !== false,
+      repKeys: [],
+      representativeIds: new Set(),
+      entityCounts: new Map(),
+      hour: null
+    };
+    this.clusters.set(entry.id, entry);
+    this._placeInBucket(entry);
+    return entry;
+  }
+
+  /**
+   * Feed an article's fingerprint and entities into its cluster. Only the
+   * first `representatives` articles of a cluster are used for matching.
+   * @param {number} clusterId
+   * @param {number} articleId
+   * @param {{simhash?: Buffer|string, entities?: Array}} data
+   * @returns {boolean} True if the article became a representative
+   */
+  addRepresentative(clusterId, articleId, data = {}) {
+    const entry = this.clusters.get(clusterId);
+    if (!entry) return false;
+    entry.articleIds.add(articleId);
+    if (entry.representativeIds.has(articleId) || entry.representativeIds.size >= this.representatives) {
+      return false;
+    }
+    entry.representativeIds.add(articleId);
+
+    const simhash = toSimhashBuffer(data.simhash);
+    if (simhash) {
+      const key = this._nextRepKey++;
+      this.simhashes.add(key, simhash, null);
+      this.repCluster.set(key, clusterId);
+      entry.repKeys.push(key);
+    }
+
+    for (const entity of data.entities || []) {
+      const text = normalizeEntity(entity);
+      if (!text) continue;
+      entry.entityCounts.set(text, (entry.entityCounts.get(text) || 0) + 1);
+      let clusters = this.entityClusters.get(text);
+      if (!clusters) {
+        clusters = new Map();
+        this.entityClusters.set(text, clusters);
+      }
+      clusters.set(clusterId, (clusters.get(clusterId) || 0) + 1);
+    }
+    return true;
+  }
+
+  /**
+   * Record that a cluster gained an article
+   * @param {number} clusterId
+   * @param {number} articleId
+   * @param {Date} [when=new Date()]
+   */
+  touch(clusterId, articleId, when = new Date()) {
+    const entry = this.clusters.get(clusterId);
+    if (!entry) return;
+    entry.articleIds.add(articleId);
+    entry.lastUpdated = when;
+    this._placeInBucket(entry);
+  }
+
+  /**
+   * @param {number} clusterId
+   * @returns {boolean}
+   */
+  removeCluster(clusterId) {
+    const entry = this.clusters.get(clusterId);
+    if (!entry) return false;
+    for (const key of entry.repKeys) {
+      this.simhashes.remove(key);
+      this.repCluster.delete(key);
+    }
+    for (const text of entry.entityCounts.keys()) {
+      const clusters = this.entityClusters.get(text);
+      if (!clusters) continue;
+      clusters.delete(clusterId);
+      if (clusters.size === 0) this.entityClusters.delete(text);
+    }
+    if (entry.hour !== null) {
+      const bucket = this.hourBuckets.get(entry.hour);
+      if (bucket) {
+        bucket.delete(clusterId);
+        if (bucket.size === 0) this.hourBuckets.delete(entry.hour);
+      }
+    }
+    this.clusters.delete(clusterId);
+    return true;
+  }
+
+  /**
+   * Clusters with a representative within `radius` of a SimHash
+   * @param {Buffer|string} simhash
+   * @param {number} [radius=maxHammingDistance]
+   * @returns {Map<number, number>} clusterId -> minimum distance
+   */
+  candidatesBySimhash(simhash, radius = this.maxHammingDistance) {
+    const result = new Map();
+    const query = toSimhashBuffer(simhash);
+    if (!query) return result;
+    for (const { contentId: key, distance } of this.simhashes.findDuplicates(query, { threshold: radius })) {
+      const clusterId = this.repCluster.get(key);
+      const current = result.get(clusterId);
+      if (current === undefined || distance < current) {
+        result.set(clusterId, distance);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Entity overlap between an article and each cluster sharing an entity.
+   * Counts match calculateEntityOverlap(articleEntities, clusterEntities).
+   * @param {Array} entities - Article entities
+   * @returns {Map<number, {count: number, shared: string[]}>}
+   */
+  entityOverlaps(entities) {
+    const result = new Map();
+    const distinct = new Set();
+    for (const entity of entities || []) {
+      const text = normalizeEntity(entity);
+      if (text) distinct.add(text);
+    }
+    for (const text of distinct) {
+      const clusters = this.entityClusters.get(text);
+      if (!clusters) continue;
+      for (const [clusterId, occurrences] of clusters) {
+        let overlap = result.get(clusterId);
+        if (!overlap) {
+          overlap = { count: 0, shared: [] };
+          result.set(clusterId, overlap);
+        }
+        overlap.count += occurrences;
+        overlap.shared.push(text);
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Drop clusters last updated before `cutoff`
+   * @param {Date} cutoff
+   * @returns {number} Clusters removed
+   */
+  pruneBefore(cutoff) {
+    const cutoffHour = Math.floor(cutoff.getTime() / HOUR_MS);
+    let removed = 0;
+    for (const [hour, bucket] of [...this.hourBuckets]) {
+      if (hour > cutoffHour) continue;
+      for (const clusterId of [...bucket]) {
+        const entry = this.clusters.get(clusterId);
+        if (entry && entry.lastUpdated < cutoff) {
+          this.removeCluster(clusterId);
+          removed++;
+        }
+      }
+    }
+    return removed;
+  }
+
+  clear() {
+    this.simhashes.clear();
+    this.repCluster.clear();
+    this.entityClusters.clear();
+    this.hourBuckets.clear();
+    this.clusters.clear();
+  }
+
+  getStats() {
+    return {
+      clusters: this.clusters.size,
+      representatives: this.repCluster.size,
+      entities: this.entityClusters.size,
+      hourBuckets: this.hourBuckets.size
+    };
+  }
+
+  /** @private */
+  _placeInBucket(entry) {
+    const hour = Math.floor(entry.lastUpdated.getTime() / HOUR_MS);
+    if (!Number.isFinite(hour) || hour === entry.hour) return;
+    if (entry.hour !== null) {
+      const old = this.hourBuckets.get(entry.hour);
+      if (old) {
+        old.delete(entry.id);
+        if (old.size === 0) this.hourBuckets.delete(entry.hour);
+      }
+    }
+    let bucket = this.hourBuckets.get(hour);
+    if (!bucket) {
+      bucket = new Set();
+      this.hourBuckets.set(hour, bucket);
+    }
+    bucket.add(entry.id);
+    entry.hour = hour;
+  }
+}
+
+module.exports = {
+  ClusterIndex,
+  normalizeEntity,
+  REPRESENTATIVES_PER_CLUSTER
+};
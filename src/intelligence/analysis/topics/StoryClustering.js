@@ -14,10 +14,16 @@
  * - Track cluster evolution over time
  * - Generate cluster headlines from articles
  * 
+ * Matching runs against a ClusterIndex held in memory. Only clusters with a
+ * representative SimHash within range are scored, and their entity overlap
+ * comes from an inverted index, so a new article costs no per-cluster DB
+ * reads.
+ * 
  * @module StoryClustering
  */
 
 const SimHasher = require('../similarity/SimHasher');
+const { ClusterIndex, REPRESENTATIVES_PER_CLUSTER } = require('./ClusterIndex');
 
 // Maximum Hamming distance for articles to be in same story
 const MAX_HAMMING_DISTANCE = 3;
@@ -119,9 +125,10 @@ class StoryClustering {
     this.minSharedEntities = options.minSharedEntities || MIN_SHARED_ENTITIES;
     this.maxTimeDiffHours = options.maxTimeDiffHours || MAX_TIME_DIFF_HOURS;
     
-    // In-memory cluster index for fast lookup
-    // Map<clusterId, {articleIds: Set, fingerprints: [], entities: Set, lastUpdated: Date}>
-    this._clusterIndex = new Map();
+    // In-memory cluster index for candidate retrieval
+    this.clusterIndex = new ClusterIndex({ maxHammingDistance: this.maxHammingDistance });
+    // Map<clusterId, {id, headline, articleIds: Set, lastUpdated: Date, isActive}>
+    this._clusterIndex = this.clusterIndex.clusters;
     this._initialized = false;
   }
   
@@ -144,15 +151,7 @@ class StoryClustering {
       const clusters = this.topicAdapter.getStoryClusters({ activeOnly: true });
       
       for (const cluster of clusters) {
-        const articleIds = JSON.parse(cluster.article_ids || cluster.articleIds || '[]');
-        
-        this._clusterIndex.set(cluster.id, {
-          id: cluster.id,
-          headline: cluster.headline,
-          articleIds: new Set(articleIds),
-          lastUpdated: new Date(cluster.last_updated || cluster.lastUpdated),
-          isActive: cluster.is_active !== 0
-        });
+        this._indexCluster(cluster);
       }
       
       this._initialized = true;
@@ -183,47 +182,32 @@ class StoryClustering {
     
     const { id: contentId, simhash, entities, publishedAt } = article;
     
-    // Get active clusters ordered by recency
-    const clusters = this.topicAdapter.getStoryClusters({
-      activeOnly: true,
-      limit: 100,
-      orderBy: 'last_updated DESC'
-    });
+    if (!this._initialized) {
+      await this.initialize();
+    }
+    
+    // Candidates: clusters with a representative SimHash within range
+    const candidates = this.clusterIndex.candidatesBySimhash(simhash, this.maxHammingDistance);
+    if (candidates.size === 0) {
+      return null;
+    }
+    const overlaps = this.clusterIndex.entityOverlaps(entities || []);
     
     let bestMatch = null;
     let bestScore = 0;
     
-    for (const cluster of clusters) {
-      const articleIds = JSON.parse(cluster.article_ids || '[]');
-      
-      if (articleIds.length === 0) continue;
-      if (articleIds.includes(contentId)) continue; // Already in cluster
+    for (const [clusterId, minDistance] of candidates) {
+      const cluster = this.clusterIndex.get(clusterId);
+      if (!cluster || cluster.articleIds.size === 0) continue;
+      if (cluster.articleIds.has(contentId)) continue; // Already in cluster
       
       // Check time proximity
-      const clusterTime = cluster.last_updated || cluster.first_seen;
-      if (publishedAt && timeDiffHours(publishedAt, clusterTime) > this.maxTimeDiffHours) {
+      if (publishedAt && timeDiffHours(publishedAt, cluster.lastUpdated) > this.maxTimeDiffHours) {
         continue;
       }
       
-      // Get fingerprints for cluster articles
-      const clusterFingerprints = this._getClusterFingerprints(articleIds);
-      
-      // Check SimHash similarity with any cluster article
-      let minDistance = 64;
-      for (const fp of clusterFingerprints) {
-        if (fp && simhash) {
-          const dist = hammingDistance(simhash, fp);
-          minDistance = Math.min(minDistance, dist);
-        }
-      }
-      
-      if (minDistance > this.maxHammingDistance) {
-        continue; // Not similar enough
-      }
-      
       // Check entity overlap
-      const clusterEntities = this._getClusterEntities(articleIds);
-      const overlap = calculateEntityOverlap(entities || [], clusterEntities);
+      const overlap = overlaps.get(clusterId) || { count: 0, shared: [] };
       
       if (overlap.count < this.minSharedEntities) {
         continue; // Not enough shared entities
@@ -248,6 +232,39 @@ class StoryClustering {
     return bestMatch;
   }
   
+  /**
+   * Register a cluster row and its representative articles in the index
+   * @private
+   */
+  _indexCluster(cluster) {
+    const rawIds = cluster.article_ids || cluster.articleIds || '[]';
+    const articleIds = Array.isArray(rawIds) ? rawIds : JSON.parse(rawIds);
+    const entry = this.clusterIndex.upsertCluster({
+      id: cluster.id,
+      headline: cluster.headline,
+      articleIds,
+      lastUpdated: new Date(cluster.last_updated || cluster.lastUpdated || cluster.first_seen || Date.now()),
+      isActive: cluster.is_active !== 0
+    });
+    this._indexRepresentatives(cluster.id, articleIds);
+    return entry;
+  }
+  
+  /**
+   * Feed fingerprints and entities of a cluster's first articles into the index
+   * @private
+   */
+  _indexRepresentatives(clusterId, articleIds) {
+    for (const id of articleIds.slice(0, REPRESENTATIVES_PER_CLUSTER)) {
+      const fp = this.similarityAdapter ? this.similarityAdapter.getFingerprint(id) : null;
+      const entities = this.tagAdapter ? this.tagAdapter.getEntities(id) : null;
+      this.clusterIndex.addRepresentative(clusterId, id, {
+        simhash: fp ? fp.simhash : null,
+        entities: entities || []
+      });
+    }
+  }
+  
   /**
    * Get fingerprints for cluster articles
    * @private
@@ -319,10 +336,16 @@ class StoryClustering {
     this.topicAdapter.updateStoryCluster(clusterId, updates);
     
     // Update in-memory index
-    if (this._clusterIndex.has(clusterId)) {
-      const cached = this._clusterIndex.get(clusterId);
-      cached.articleIds.add(contentId);
-      cached.lastUpdated = new Date();
+    const cached = this.clusterIndex.get(clusterId);
+    if (cached) {
+      if (!cached.articleIds.has(contentId)) {
+        this._indexRepresentatives(clusterId, [contentId]);
+      }
+      this.clusterIndex.touch(clusterId, contentId, new Date(updates.lastUpdated));
+      if (headline) cached.headline = headline;
+    } else {
+      // Cluster created elsewhere: index it now that we have its row
+      this._indexCluster({ ...cluster, article_ids: articleIds, headline: headline || cluster.headline, last_updated: updates.lastUpdated });
     }
     
     return { clusterId, articleIds, articleCount: articleIds.length };
@@ -359,13 +382,14 @@ class StoryClustering {
     });
     
     // Add to in-memory index
-    this._clusterIndex.set(cluster.id, {
+    this.clusterIndex.upsertCluster({
       id: cluster.id,
       headline,
-      articleIds: new Set(articleIds),
+      articleIds,
       lastUpdated: new Date(),
       isActive: true
     });
+    this._indexRepresentatives(cluster.id, articleIds);
     
     return cluster;
   }
@@ -497,12 +521,8 @@ class StoryClustering {
     
     const count = this.topicAdapter.deactivateOldClusters(cutoffDate.toISOString());
     
-    // Update in-memory index
-    for (const [id, cluster] of this._clusterIndex) {
-      if (cluster.lastUpdated < cutoffDate) {
-        cluster.isActive = false;
-      }
-    }
+    // Deactivated clusters no longer match; drop them from the index
+    this.clusterIndex.pruneBefore(cutoffDate);
     
     return count;
   }
@@ -518,7 +538,8 @@ class StoryClustering {
       activeClusters: this._clusterIndex.size,
       maxHammingDistance: this.maxHammingDistance,
       minSharedEntities: this.minSharedEntities,
-      maxTimeDiffHours: this.maxTimeDiffHours
+      maxTimeDiffHours: this.maxTimeDiffHours,
+      index: this.clusterIndex.getStats()
     };
   }
 }
@@ -0,0 +1,325 @@
+'use strict';
+
+/**
+ * SearchIndexer - Incremental maintenance for the articles_fts index
+ *
+ * The stock schema keeps articles_fts current with row triggers on
+ * content_analysis. Every UPDATE re-indexes the row, even when the change only
+ * touches analysis_json. Index upkeep on that path means full 'rebuild' and
+ * 'optimize' runs over the whole table.
+ *
+ * Deferred mode (enableDeferredIndexing) swaps those triggers for queue
+ * triggers. They fire only when an indexed column (title, body_text, byline,
+ * authors) changes, and they record the values currently in the index in
+ * search_index_queue. flush() then applies the queue in batches, one
+ * transaction per batch. The queue tables come from the
+ * add_search_index_queue_tables project migration. The crawler's article
+ * writes and the API gateway turn the mode on through
+ * startDeferredIndexing(), which also starts the background flush.
+ *
+ * Merges run in small steps ('merge' with a page budget) from an unref'd
+ * timer, so the b-tree stays compact without a blocking 'optimize'.
+ *
+ * Every change to the indexed corpus bumps an index generation. SearchService
+ * keys its result cache on that generation. In deferred mode the generation is
+ * stored in search_index_state, so other processes see it as well.
+ */
+
+const {
+  INDEXED_COLUMNS,
+  hasDeferredIndexTriggers,
+  hasArticlesFts,
+  installDeferredIndexTriggers,
+  restoreSyncIndexTriggers,
+  countQueuedIndexUpdates,
+  applyQueuedIndexUpdates,
+  clearIndexQueue,
+  readIndexGeneration,
+  bumpIndexGeneration,
+  setFtsMergeOption,
+  runFtsMergeStep
+} = require('../data/db/sqlite/queries/searchIndex');
+
+const MAX_MERGE_STEPS = 1000;
+
+const indexers = new WeakMap(); // db -> SearchIndexer
+
+class SearchIndexer {
+  /**
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {Object} [options]
+   * @param {number} [options.batchSize=500] - Queue rows applied per flush transaction
+   * @param {number} [options.mergePages=16] - Pages per incremental 'merge' step
+   * @param {Object} [options.logger=console]
+   */
+  constructor(db, options = {}) {
+    if (!db || typeof db.prepare !== 'function') {
+      throw new Error('SearchIndexer requires a better-sqlite3 database handle');
+    }
+    this._db = db;
+    this.batchSize = Math.max(1, options.batchSize || 500);
+    this.mergePages = Math.max(2, options.mergePages || 16);
+    this.logger = options.logger || console;
+    this._localGeneration = 0;
+    this._timer = null;
+    this._deferred = null;
+  }
+
+  /**
+   * True when content_analysis feeds search_index_queue instead of articles_fts
+   * @returns {boolean}
+   */
+  isDeferred() {
+    if (this._deferred === null) {
+      this._deferred = hasDeferredIndexTriggers(this._db);
+    }
+    return this._deferred;
+  }
+
+  /**
+   * Replace the per-row FTS triggers with queue triggers. The index is left as
+   * it is; rows written from now on are indexed by flush(). A no-op when
+   * another process already switched the database over.
+   */
+  enableDeferredIndexing() {
+    this._deferred = null;
+    if (this.isDeferred()) return;
+    installDeferredIndexTriggers(this._db, this._localGeneration + 1);
+    this._deferred = true;
+  }
+
+  /**
+   * Apply everything still queued, then restore the per-row FTS triggers
+   * @returns {{indexed: number, removed: number}}
+   */
+  disableDeferredIndexing() {
+    if (!this.isDeferred()) return { indexed: 0, removed: 0 };
+    const totals = this.flushAll();
+    const generation = this.generation();
+    restoreSyncIndexTriggers(this._db);
+    this._deferred = false;
+    this._localGeneration = generation + 1;
+    return totals;
+  }
+
+  /**
+   * Rows waiting for flush()
+   * @returns {number}
+   */
+  pendingCount() {
+    if (!this.isDeferred()) return 0;
+    return countQueuedIndexUpdates(this._db);
+  }
+
+  /**
+   * Apply one batch of the queue to articles_fts in one transaction
+   *
+   * @param {Object} [options]
+   * @param {number} [options.limit] - Queue rows to apply (default: batchSize)
+   * @returns {{indexed: number, removed: number, pending: number}}
+   */
+  flush(options = {}) {
+    if (!this.isDeferred()) return { indexed: 0, removed: 0, pending: 0 };
+    const limit = Math.max(1, options.limit || this.batchSize);
+    const { indexed, removed, dequeued } = applyQueuedIndexUpdates(this._db, limit);
+    // The stored generation was bumped inside the batch transaction
+    if (dequeued > 0) this._localGeneration += 1;
+    return { indexed, removed, pending: this.pendingCount() };
+  }
+
+  /**
+   * flush() until the queue is empty
+   * @returns {{indexed: number, removed: number, batches: number}}
+   */
+  flushAll() {
+    const totals = { indexed: 0, removed: 0, batches: 0 };
+    for (;;) {
+      const { indexed, removed, pending } = this.flush();
+      if (indexed === 0 && removed === 0 && pending === 0) break;
+      totals.indexed += indexed;
+      totals.removed += removed;
+      totals.batches += 1;
+      if (pending === 0) break;
+    }
+    return totals;
+  }
+
+  /**
+   * Drop queued work that a full rebuild has already covered
+   */
+  clearQueue() {
+    if (this.isDeferred()) {
+      clearIndexQueue(this._db);
+    }
+  }
+
+  /**
+   * Set the FTS5 merge tuning options
+   *
+   * @param {Object} [options]
+   * @param {number} [options.automerge=4] - Segments per level before an automatic merge (0 disables)
+   * @param {number} [options.crisismerge=16] - Segments per level that force a merge during writes
+   * @param {number} [options.usermerge=4] - Segments per level merged by each 'merge' step
+   */
+  configureMerge(options = {}) {
+    const settings = {
+      automerge: options.automerge ?? 4,
+      crisismerge: options.crisismerge ?? 16,
+      usermerge: options.usermerge ?? 4
+    };
+    for (const [name, value] of Object.entries(settings)) {
+      setFtsMergeOption(this._db, name, value);
+    }
+    return settings;
+  }
+
+  /**
+   * Run one incremental merge step
+   *
+   * @param {number} [pages] - Pages to write in this step (default: mergePages)
+   * @returns {boolean} True when the step did work and more may remain
+   */
+  mergeStep(pages = this.mergePages) {
+    return runFtsMergeStep(this._db, pages);
+  }
+
+  /**
+   * Merge in steps until the index is compact or the time budget runs out
+   *
+   * @param {Object} [options]
+   * @param {number} [options.budgetMs=50]
+   * @param {number} [options.pages] - Pages per step
+   * @returns {{steps: number, complete: boolean, durationMs: number}}
+   */
+  merge(options = {}) {
+    const budgetMs = options.budgetMs ?? 50;
+    const startTime = Date.now();
+    let steps = 0;
+    let complete = false;
+    while (steps < MAX_MERGE_STEPS) {
+      steps += 1;
+      if (!this.mergeStep(options.pages)) {
+        complete = true;
+        break;
+      }
+      if (Date.now() - startTime >= budgetMs) break;
+    }
+    return { steps, complete, durationMs: Date.now() - startTime };
+  }
+
+  /**
+   * Flush a batch and run a bounded merge on a timer. The timer is unref'd,
+   * so it never keeps the process alive.
+   *
+   * @param {Object} [options]
+   * @param {number} [options.intervalMs=5000]
+   * @param {number} [options.budgetMs=50] - Merge time per tick
+   */
+  startBackground(options = {}) {
+    if (this._timer) return;
+    const intervalMs = Math.max(10, options.intervalMs || 5000);
+    const budgetMs = options.budgetMs ?? 50;
+    this._timer = setInterval(() => {
+      try {
+        this.flush();
+        this.merge({ budgetMs });
+      } catch (error) {
+        this.logger.warn(`[SearchIndexer] Background maintenance failed: ${error.message}`);
+      }
+    }, intervalMs);
+    if (typeof this._timer.unref === 'function') this._timer.unref();
+  }
+
+  stopBackground() {
+    if (this._timer) {
+      clearInterval(this._timer);
+      this._timer = null;
+    }
+  }
+
+  /**
+   * Current index generation. Changes whenever the indexed corpus changes
+   * through this indexer, rebuildIndex() or flush().
+   * @returns {number}
+   */
+  generation() {
+    if (!this.isDeferred()) return this._localGeneration;
+    const stored = readIndexGeneration(this._db);
+    return stored === null ? this._localGeneration : stored;
+  }
+
+  /**
+   * Record an index change made outside flush() (rebuild, optimize, bulk load)
+   */
+  noteChange() {
+    this._bump();
+  }
+
+  _bump() {
+    this._localGeneration += 1;
+    if (this.isDeferred()) {
+      bumpIndexGeneration(this._db);
+    }
+  }
+}
+
+/**
+ * Shared SearchIndexer for a database handle. SearchService is created per
+ * request, so the generation and timer must live with the handle.
+ *
+ * @param {Database} db
+ * @param {Object} [options] - Used only when the indexer is first created
+ * @returns {SearchIndexer}
+ */
+function getSearchIndexer(db, options) {
+  let indexer = indexers.get(db);
+  if (!indexer) {
+    indexer = new SearchIndexer(db, options);
+    indexers.set(db, indexer);
+  }
+  return indexer;
+}
+
+/**
+ * Turn on deferred indexing for a handle that writes or serves articles, and
+ * start the background flush/merge timer. Databases without articles_fts or
+ * without the queue tables keep their current triggers.
+ *
+ * @param {Database} db
+ * @param {Object} [options]
+ * @param {number} [options.intervalMs] - Background flush interval
+ * @param {Object} [options.logger=console]
+ * @returns {SearchIndexer|null} The shared indexer, or null when left in sync mode
+ */
+function startDeferredIndexing(db, options = {}) {
+  const logger = options.logger || console;
+  if (!db || typeof db.prepare !== 'function' || !hasArticlesFts(db)) return null;
+  const indexer = getSearchIndexer(db, { logger });
+  try {
+    indexer.enableDeferredIndexing();
+  } catch (error) {
+    logger.warn(`[SearchIndexer] Deferred indexing not enabled: ${error.message}`);
+    return null;
+  }
+  indexer.startBackground({ intervalMs: options.intervalMs });
+  return indexer;
+}
+
+/**
+ * Stop the background timer and apply what is still queued, e.g. on shutdown
+ * @param {Database} db
+ */
+function stopDeferredIndexing(db) {
+  const indexer = db ? indexers.get(db) : null;
+  if (!indexer) return;
+  indexer.stopBackground();
+  if (indexer.isDeferred()) indexer.flushAll();
+}
+
+module.exports = {
+  SearchIndexer,
+  getSearchIndexer,
+  startDeferredIndexing,
+  stopDeferredIndexing,
+  INDEXED_COLUMNS
+};
@@ -0,0 +1,113 @@
+'use strict';
+
+/**
+ * SearchResultCache - LRU of search and facet responses
+ *
+ * Keys come from the normalized _parseQuery() output plus the options that
+ * shape a response. Each entry records the index generation it was computed
+ * at and is dropped once SearchIndexer reports a different generation.
+ *
+ * In sync-trigger mode, writes to content_analysis do not bump the generation,
+ * so SearchService only uses a cache there when one is passed in explicitly;
+ * the TTL then bounds how stale a cached hit list can be.
+ *
+ * Cached responses are shared between callers; treat them as read-only.
+ */
+
+const caches = new WeakMap(); // db -> SearchResultCache
+
+class SearchResultCache {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxEntries=500]
+   * @param {number} [options.ttlMs=60000] - 0 disables expiry
+   */
+  constructor(options = {}) {
+    this.maxEntries = Math.max(1, options.maxEntries || 500);
+    this.ttlMs = options.ttlMs ?? 60000;
+    this._entries = new Map(); // key -> { value, generation, storedAt }
+    this.stats = { hits: 0, misses: 0, stale: 0, evictions: 0 };
+  }
+
+  /**
+   * Build a cache key
+   *
+   * @param {string} kind - 'search' | 'facets'
+   * @param {Object} parsedQuery - _parseQuery() output with a normalized ftsQuery
+   * @param {Object} [shape] - Options that change the response
+   * @returns {string}
+   */
+  static key(kind, parsedQuery, shape = {}) {
+    const fields = Object.keys(shape).sort().map((name) => [name, shape[name] ?? null]);
+    return JSON.stringify([kind, parsedQuery.ftsQuery, parsedQuery.domain || null, parsedQuery.author || null, fields]);
+  }
+
+  /**
+   * @param {string} key
+   * @param {number} generation - Current index generation
+   * @returns {Object|null}
+   */
+  get(key, generation) {
+    const entry = this._entries.get(key);
+    if (!entry) {
+      this.stats.misses += 1;
+      return null;
+    }
+    const expired = this.ttlMs > 0 && Date.now() - entry.storedAt > this.ttlMs;
+    if (expired || entry.generation !== generation) {
+      this._entries.delete(key);
+      this.stats.stale += 1;
+      this.stats.misses += 1;
+      return null;
+    }
+    // Re-insert to mark as most recently used
+    this._entries.delete(key);
+    this._entries.set(key, entry);
+    this.stats.hits += 1;
+    return entry.value;
+  }
+
+  set(key, generation, value) {
+    this._entries.delete(key);
+    this._entries.set(key, { value, generation, storedAt: Date.now() });
+    while (this._entries.size > this.maxEntries) {
+      this._entries.delete(this._entries.keys().next().value);
+      this.stats.evictions += 1;
+    }
+  }
+
+  clear() {
+    this._entries.clear();
+  }
+
+  getStats() {
+    const lookups = this.stats.hits + this.stats.misses;
+    return {
+      ...this.stats,
+      size: this._entries.size,
+      maxEntries: this.maxEntries,
+      hitRate: lookups > 0 ? Number((this.stats.hits / lookups).toFixed(3)) : 0
+    };
+  }
+}
+
+/**
+ * Shared cache for a database handle
+ *
+ * @param {Database} db
+ * @param {Object} [options] - Used only when the cache is first created
+ * @returns {SearchResultCache}
+ */
+function getSearchResultCache(db, options) {
+  let cache = caches.get(db);
+  if (!cache) {
+    cache = new SearchResultCache(options);
+    caches.set(db, cache);
+  }
+  return cache;
+}
+
+module.exports = {
+  SearchResultCache,
+  getSearchResultCache
+};
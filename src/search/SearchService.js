@@ -11,14 +11,21 @@
  *   - Faceted filtering (domain, date range, author)
  *   - Result highlighting with <mark> tags
  *   - Performance metrics
+ *   - Result/facet cache invalidated by index generation (SearchResultCache)
+ *   - Hits and facets from one FTS pass when facets are requested
+ *   - Incremental index maintenance (SearchIndexer)
  */
 
 // (direct from news-crawler-db; aliases preserve the retired searchAdapter
 // shim's historical renames)
 const {
   createSqliteArticleSearchAdapter: createSearchAdapter,
-  SQLITE_ARTICLE_SEARCH_BM25_WEIGHTS: BM25_WEIGHTS
+  SQLITE_ARTICLE_SEARCH_BM25_WEIGHTS: BM25_WEIGHTS,
+  sanitizeSqliteArticleSearchQuery: sanitizeFtsQuery
 } = require('news-crawler-db');
+const { getSearchIndexer } = require('./SearchIndexer');
+const { runSinglePassSearch } = require('../data/db/sqlite/queries/searchIndex');
+const { SearchResultCache, getSearchResultCache } = require('./SearchResultCache');
 
 class SearchService {
   /**
@@ -38,8 +45,20 @@ class SearchService {
       maxLimit: options.maxLimit || 100,
       highlightTag: options.highlightTag || 'mark',
       snippetLength: options.snippetLength || 64,
+      facetLimit: options.facetLimit || 20,
       ...options
     };
+    this._indexer = options.indexer || getSearchIndexer(db);
+    // The shared cache is on by default only with deferred indexing: sync
+    // triggers re-index writes without bumping the generation, so cached hits
+    // would lag the index until their TTL ran out
+    if (options.cache === false) {
+      this._cache = null;
+    } else if (options.cache) {
+      this._cache = options.cache;
+    } else {
+      this._cache = this._indexer.isDeferred() ? getSearchResultCache(db, options.cacheOptions) : null;
+    }
   }
 
   /**
@@ -71,15 +90,43 @@ class SearchService {
     try {
       // Parse query for any special syntax
       const parsedQuery = this._parseQuery(query);
+      const domain = options.domain || parsedQuery.domain;
 
-      // Perform the search
-      const searchResult = this._adapter.search(parsedQuery.ftsQuery, {
+      const cacheKey = this._cache && SearchResultCache.key('search', parsedQuery, {
         limit,
         offset,
-        domain: options.domain || parsedQuery.domain,
+        domain,
         startDate: options.startDate,
-        endDate: options.endDate
+        endDate: options.endDate,
+        includeHighlights,
+        includeFacets
       });
+      const generation = this._cache ? this._indexer.generation() : null;
+      const cached = this._cache && this._cache.get(cacheKey, generation);
+      if (cached) {
+        return {
+          ...cached,
+          query,
+          metrics: { durationMs: Date.now() - startTime, resultsReturned: cached.results.length, cached: true }
+        };
+      }
+
+      const searchOptions = {
+        limit,
+        offset,
+        domain,
+        startDate: options.startDate,
+        endDate: options.endDate
+      };
+
+      // With facets, hits and facets come from one MATCH evaluation
+      let searchResult;
+      let facets = null;
+      if (includeFacets) {
+        ({ searchResult, facets } = this._searchWithFacets(parsedQuery.ftsQuery, searchOptions));
+      } else {
+        searchResult = this._adapter.search(parsedQuery.ftsQuery, searchOptions);
+      }
 
       // Add highlights if requested
       if (includeHighlights && searchResult.results.length > 0) {
@@ -96,15 +143,9 @@ class SearchService {
         }
       }
 
-      // Add facets if requested
-      let facets = null;
-      if (includeFacets) {
-        facets = this._adapter.getFacets(parsedQuery.ftsQuery);
-      }
-
       const duration = Date.now() - startTime;
 
-      return {
+      const response = {
         success: true,
         query: query,
         parsedQuery: parsedQuery.ftsQuery,
@@ -123,6 +164,8 @@ class SearchService {
           resultsReturned: searchResult.results.length
         }
       };
+      if (this._cache) this._cache.set(cacheKey, generation, response);
+      return response;
     } catch (err) {
       const duration = Date.now() - startTime;
       return {
@@ -236,7 +279,19 @@ class SearchService {
 
     try {
       const parsedQuery = this._parseQuery(query);
-      return this._adapter.getFacets(parsedQuery.ftsQuery, options);
+      const cacheKey = this._cache && SearchResultCache.key('facets', parsedQuery, options);
+      const generation = this._cache ? this._indexer.generation() : null;
+      const cached = this._cache && this._cache.get(cacheKey, generation);
+      if (cached) return cached;
+
+      let facets;
+      try {
+        facets = this._runSinglePass(parsedQuery.ftsQuery, null).facets;
+      } catch (_) {
+        facets = this._adapter.getFacets(parsedQuery.ftsQuery, options);
+      }
+      if (this._cache) this._cache.set(cacheKey, generation, facets);
+      return facets;
     } catch (_) {
       return { domains: [], authors: [], dateRange: { min_date: null, max_date: null, count: 0 } };
     }
@@ -259,6 +314,9 @@ class SearchService {
   rebuildIndex() {
     const startTime = Date.now();
     this._adapter.rebuildIndex();
+    // 'rebuild' reads content_analysis directly, so anything queued is covered
+    this._indexer.clearQueue();
+    this._indexer.noteChange();
     return {
       success: true,
       operation: 'rebuild',
@@ -267,7 +325,8 @@ class SearchService {
   }
 
   /**
-   * Optimize the search index
+   * Optimize the search index (full merge of every segment).
+   * Prefer maintainIndex() on a live database.
    * @returns {Object} Result with timing
    */
   optimizeIndex() {
@@ -280,6 +339,28 @@ class SearchService {
     };
   }
 
+  /**
+   * Apply queued index updates and run a bounded incremental merge
+   *
+   * @param {Object} options
+   * @param {number} options.budgetMs - Merge time budget (default: 50)
+   * @returns {Object} Result with timing, rows indexed and merge progress
+   */
+  maintainIndex(options = {}) {
+    const startTime = Date.now();
+    const flushed = this._indexer.flushAll();
+    const merge = this._indexer.merge({ budgetMs: options.budgetMs });
+    return {
+      success: true,
+      operation: 'merge',
+      indexed: flushed.indexed,
+      removed: flushed.removed,
+      mergeSteps: merge.steps,
+      mergeComplete: merge.complete,
+      durationMs: Date.now() - startTime
+    };
+  }
+
   /**
    * Get index statistics
    * @returns {Object} Index config and stats
@@ -290,12 +371,93 @@ class SearchService {
     return {
       config,
       needsBackfill: needsBackfill.length > 0,
-      weights: BM25_WEIGHTS
+      weights: BM25_WEIGHTS,
+      deferredIndexing: this._indexer.isDeferred(),
+      pendingUpdates: this._indexer.pendingCount(),
+      generation: this._indexer.generation(),
+      cache: this._cache ? this._cache.getStats() : null
     };
   }
 
   // --- Private methods ---
 
+  /**
+   * Hits and facets from one statement, falling back to the adapter's
+   * separate search and facet queries if the statement cannot run here
+   * (older SQLite, different schema).
+   */
+  _searchWithFacets(ftsQuery, searchOptions) {
+    if (ftsQuery !== '*') {
+      try {
+        return this._runSinglePass(ftsQuery, searchOptions);
+      } catch (_) {
+        // fall through to the adapter
+      }
+    }
+    return {
+      searchResult: this._adapter.search(ftsQuery, searchOptions),
+      facets: this._adapter.getFacets(ftsQuery)
+    };
+  }
+
+  /**
+   * @param {string} ftsQuery
+   * @param {Object|null} searchOptions - null for facets only
+   * @returns {{searchResult: Object|null, facets: Object}}
+   */
+  _runSinglePass(ftsQuery, searchOptions) {
+    const withHits = Boolean(searchOptions);
+    const params = { match: sanitizeFtsQuery(ftsQuery), facetLimit: this._options.facetLimit };
+    if (withHits) {
+      Object.assign(params, {
+        limit: searchOptions.limit,
+        offset: searchOptions.offset,
+        domain: searchOptions.domain || null,
+        startDate: searchOptions.startDate || null,
+        endDate: searchOptions.endDate || null
+      });
+    }
+
+    const rows = runSinglePassSearch(this._db, params, { withHits, weights: BM25_WEIGHTS });
+    const hits = [];
+    const facets = { domains: [], authors: [], dateRange: { min_date: null, max_date: null, count: 0 } };
+    let total = 0;
+    for (const row of rows) {
+      switch (row.kind) {
+        case 'hit':
+          hits.push(row);
+          break;
+        case 'total':
+          total = row.n;
+          break;
+        case 'domain':
+          facets.domains.push({ domain: row.value, count: row.n });
+          break;
+        case 'author':
+          facets.authors.push({ author: row.value, count: row.n });
+          break;
+        case 'dates':
+          facets.dateRange = { min_date: row.value, max_date: row.payload, count: row.n };
+          break;
+        default:
+          break;
+      }
+    }
+
+    let searchResult = null;
+    if (withHits) {
+      const results = hits.sort((a, b) => a.n - b.n).map((hit) => JSON.parse(hit.payload));
+      searchResult = {
+        results,
+        total,
+        limit: searchOptions.limit,
+        offset: searchOptions.offset,
+        hasMore: searchOptions.offset + results.length < total
+      };
+    }
+    return { searchResult, facets };
+  }
+
   /**
    * Parse a user query into FTS5 query syntax
    * @param {string} query - User query
@@ -6,9 +6,13 @@
  * Exports:
  *   - SearchService: High-level search API
  *   - createSearchAdapter: Low-level database adapter
+ *   - SearchIndexer: Deferred/batched index updates and incremental merges
+ *   - SearchResultCache: Generation-keyed result/facet cache
  */
 
 const { SearchService } = require('./SearchService');
+const { SearchIndexer, getSearchIndexer } = require('./SearchIndexer');
+const { SearchResultCache, getSearchResultCache } = require('./SearchResultCache');
 // (direct from news-crawler-db; aliases preserve the retired searchAdapter
 // shim's historical renames)
 const {
@@ -19,6 +23,10 @@ const {
 
 module.exports = {
   SearchService,
+  SearchIndexer,
+  getSearchIndexer,
+  SearchResultCache,
+  getSearchResultCache,
   createSearchAdapter,
   BM25_WEIGHTS,
   sanitizeFtsQuery
@@ -69,7 +69,27 @@ const crawlerOptionsSchema = {
   cachedSeedUrls: { type: 'array', default: () => [] },
   loggingQueue: { type: 'boolean', default: true },
   loggingNetwork: { type: 'boolean', default: true },
-  loggingFetching: { type: 'boolean', default: true }
+  loggingFetching: { type: 'boolean', default: true },
+  analysisWorkers: { type: 'number', default: 0, processor: (val) => Math.max(0, Math.floor(val)) },
+  analysisMaxPending: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  frontierSpillDir: { type: 'string', default: null },
+  frontierHotCapacity: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  frontierMaxSpilled: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  connectionPooling: { type: 'boolean', default: true },
+  maxSocketsPerHost: { type: 'number', default: 6, processor: (val) => Math.max(1, Math.floor(val)) },
+  connectionIdleTimeoutMs: { type: 'number', default: 30000, validator: (val) => val > 0 },
+  http2: { type: 'boolean', default: false },
+  streamBody: { type: 'boolean', default: true },
+  capBodyBytes: { type: 'boolean', default: false },
+  maxArticleBodyBytes: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  maxHubBodyBytes: { type: 'number', default: undefined, validator: (val) => val > 0 },
+  writeBehind: { type: 'boolean', default: true },
+  writeBehindIntervalMs: { type: 'number', default: 250, validator: (val) => val > 0 },
+  writeBehindMaxRows: { type: 'number', default: 500, processor: (val) => Math.max(1, Math.floor(val)) },
+  seenUrlFilter: { type: 'string', default: 'off' },
+  seenUrlFilterCapacity: { type: 'number', default: 1000000, processor: (val) => Math.max(1000, Math.floor(val)) },
+  latencyHistograms: { type: 'boolean', default: true },
+  latencyHistogramHosts: { type: 'number', default: undefined, processor: (val) => Math.max(0, Math.floor(val)) }
 };
 
 module.exports = {
@@ -5,8 +5,16 @@
  * Tracks compression performance, effectiveness, and system health.
  */
 
+const { performance } = require('perf_hooks');
 const { ensureDatabase } = require('../../db/ensureNewsDb');
 const { compressionConfig } = require('../../shared/config/compression');
+const { compress, decompress } = require('./CompressionFacade');
+const {
+  trainDictionary,
+  getDomainDictionaryType,
+  sampleDomainContent,
+  dictionaryAlgorithm
+} = require('./compressionDictionaries');
 
 class CompressionAnalytics {
   constructor(options = {}) {
@@ -345,6 +353,143 @@ class CompressionAnalytics {
     }
   }
 
+  /**
+   * Comparison mode: per-domain dictionary compression vs today's options.
+   *
+   * The sampled pages are split in two. Even positions train the dictionary
+   * (unless a stored one is used) and odd positions are measured. Each page is
+   * measured three ways:
+   * - individual: one page per blob with the default preset
+   * - dictionary: one page per blob with the domain dictionary
+   * - bucket: all measured pages in a single blob with the bucket preset. A
+   *   bucket read has to decompress the whole blob, so its per-page decode
+   *   cost is the full decode.
+   *
+   * Ratios are compressed / uncompressed, as elsewhere in this class.
+   *
+   * @param {Object} options
+   * @param {string} options.domain - urls.host
+   * @param {number} [options.sampleLimit=200]
+   * @param {Array<Buffer|string>} [options.samples] - Use these pages instead of sampling the DB
+   * @param {boolean} [options.useStoredDictionary=true] - Measure the stored dictionary if there is one
+   * @param {string} [options.individualPreset] - Default: compressionConfig.defaults.newContentCompression
+   * @param {string} [options.bucketPreset='brotli_11']
+   * @param {number} [options.decodeRepeats=3]
+   * @returns {Promise<Object|null>}
+   */
+  async compareDictionaryCompression(options = {}) {
+    const {
+      domain,
+      sampleLimit = 200,
+      useStoredDictionary = true,
+      individualPreset = compressionConfig.defaults.newContentCompression,
+      bucketPreset = 'brotli_11',
+      decodeRepeats = 3
+    } = options;
+
+    try {
+      let handle = null;
+      if (!options.samples || (useStoredDictionary && (this.db || this.dbPath))) {
+        const db = this._getDb();
+        handle = db && typeof db.getHandle === 'function' ? db.getHandle() : db;
+        if (!handle || typeof handle.prepare !== 'function') {
+          throw new Error('Dictionary comparison requires a SQLite database');
+        }
+      }
+
+      const pages = (options.samples || sampleDomainContent(handle, domain, { limit: sampleLimit }).map((s) => s.content))
+        .map((page) => (Buffer.isBuffer(page) ? page : Buffer.from(String(page), 'utf8')))
+        .filter((page) => page.length > 0);
+      const trainPages = pages.filter((_, i) => i % 2 === 0);
+      const evalPages = pages.filter((_, i) => i % 2 === 1);
+      if (evalPages.length === 0) {
+        throw new Error(`Not enough pages to compare for ${domain}`);
+      }
+
+      const storedType = useStoredDictionary && handle ? getDomainDictionaryType(handle, domain) : null;
+      const dictionary = storedType
+        ? Buffer.from(storedType.dictionary_blob)
+        : trainDictionary(trainPages.length ? trainPages : evalPages);
+      const dictionaryOptions = storedType
+        ? { algorithm: storedType.algorithm, level: storedType.level, dictionary }
+        : { algorithm: dictionaryAlgorithm(), level: dictionaryAlgorithm() === 'zstd' ? 19 : 9, dictionary };
+
+      const uncompressedBytes = evalPages.reduce((sum, page) => sum + page.length, 0);
+      const timeDecode = (run) => {
+        let best = Infinity;
+        for (let i = 0; i < Math.max(1, decodeRepeats); i++) {
+          const start = performance.now();
+          run();
+          best = Math.min(best, performance.now() - start);
+        }
+        return best * 1000;
+      };
+      const measurePerPage = (compressOptions) => {
+        const blobs = evalPages.map((page) => compress(page, compressOptions));
+        const decodeUs = timeDecode(() => {
+          for (const blob of blobs) decompress(blob.compressed, blob.algorithm, { dictionary: compressOptions.dictionary });
+        });
+        const compressedBytes = blobs.reduce((sum, blob) => sum + blob.compressedSize, 0);
+        return {
+          algorithm: blobs[0].algorithm,
+          compressedBytes,
+          ratio: compressedBytes / uncompressedBytes,
+          decodeUsPerPage: Math.round((decodeUs / blobs.length) * 10) / 10
+        };
+      };
+
+      const individual = { preset: individualPreset, ...measurePerPage({ preset: individualPreset }) };
+      const withDictionary = {
+        compressionType: storedType ? storedType.name : null,
+        dictionaryBytes: dictionary.length,
+        ...measurePerPage(dictionaryOptions)
+      };
+      const bucketBlob = compress(Buffer.concat(evalPages), { preset: bucketPreset });
+      const bucketDecodeUs = timeDecode(() => decompress(bucketBlob.compressed, bucketBlob.algorithm));
+      const bucket = {
+        preset: bucketPreset,
+        algorithm: bucketBlob.algorithm,
+        compressedBytes: bucketBlob.compressedSize,
+        ratio: bucketBlob.compressedSize / uncompressedBytes,
+        decodeUsPerPage: Math.round(bucketDecodeUs * 10) / 10,
+        pagesPerBucket: evalPages.length
+      };
+
+      let storedBuckets = null;
+      if (handle) {
+        try {
+          storedBuckets = handle.prepare(`
+            SELECT COUNT(*) AS bucket_count, SUM(content_count) AS content_count,
+                   SUM(compressed_size) * 1.0 / NULLIF(SUM(uncompressed_size), 0) AS ratio
+            FROM compression_buckets
+            WHERE domain_pattern = ?
+          `).get(domain) || null;
+        } catch (_) {
+          storedBuckets = null;
+        }
+      }
+
+      return {
+        domain,
+        samples: { train: storedType ? 0 : trainPages.length, measured: evalPages.length, uncompressedBytes },
+        dictionarySource: storedType ? 'stored' : 'trained',
+        modes: { individual, dictionary: withDictionary, bucket },
+        storedBuckets,
+        dictionaryVsBucket: {
+          // >1: dictionary pages are that many times larger than the bucket share
+          sizeFactor: Math.round((withDictionary.ratio / bucket.ratio) * 100) / 100,
+          // >1: reading one page is that many times faster than a bucket read
+          decodeSpeedup: withDictionary.decodeUsPerPage > 0
+            ? Math.round((bucket.decodeUsPerPage / withDictionary.decodeUsPerPage) * 10) / 10
+            : null
+        }
+      };
+    } catch (error) {
+      this.logger.warn('[CompressionAnalytics] Failed to compare dictionary compression:', error.message);
+      return null;
+    }
+  }
+
   /**
    * Convert time range to SQL datetime filter
    */
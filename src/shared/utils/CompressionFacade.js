@@ -28,6 +28,7 @@ const ALGORITHM_RANGES = Object.freeze({
   none: Object.freeze({ min: 0, max: 0, default: 0 }),
   gzip: Object.freeze({ min: 1, max: 9, default: 6 }),
   brotli: Object.freeze({ min: 0, max: 11, default: 6 }),
+  deflate: Object.freeze({ min: 1, max: 9, default: 9 }),
   zstd: Object.freeze({ min: 1, max: 22, default: 3 })
 });
 
@@ -35,6 +36,7 @@ const DEFAULT_LEVELS = Object.freeze({
   none: ALGORITHM_RANGES.none.default,
   gzip: ALGORITHM_RANGES.gzip.default,
   brotli: ALGORITHM_RANGES.brotli.default,
+  deflate: ALGORITHM_RANGES.deflate.default,
   zstd: ALGORITHM_RANGES.zstd.default
 });
 
@@ -120,6 +122,10 @@ function normalizeCompressionOptions(options = {}) {
     normalized.sizeHint = options.sizeHint;
   }
 
+  if (options.dictionary && (algorithm === 'deflate' || algorithm === 'zstd')) {
+    normalized.dictionary = options.dictionary;
+  }
+
   return normalized;
 }
 
@@ -183,13 +189,22 @@ function compressWithPreset(content, preset, options = {}) {
   return compress(content, { ...options, preset });
 }
 
-function decompress(compressedBuffer, algorithmOrOptions = 'gzip') {
+function decompress(compressedBuffer, algorithmOrOptions = 'gzip', options = {}) {
+  if (typeof algorithmOrOptions === 'object' && algorithmOrOptions !== null) {
+    const normalized = normalizeCompressionOptions(algorithmOrOptions);
+    return coreCompression.decompress(compressedBuffer, normalized.algorithm, { dictionary: normalized.dictionary });
+  }
+
+  return coreCompression.decompress(compressedBuffer, algorithmOrOptions, options);
+}
+
+function decompressAsync(compressedBuffer, algorithmOrOptions = 'gzip', options = {}) {
   if (typeof algorithmOrOptions === 'object' && algorithmOrOptions !== null) {
     const normalized = normalizeCompressionOptions(algorithmOrOptions);
-    return coreCompression.decompress(compressedBuffer, normalized.algorithm);
+    return coreCompression.decompressAsync(compressedBuffer, normalized.algorithm, { dictionary: normalized.dictionary });
   }
 
-  return coreCompression.decompress(compressedBuffer, algorithmOrOptions);
+  return coreCompression.decompressAsync(compressedBuffer, algorithmOrOptions, options);
 }
 
 function getCompressionType(db, typeName) {
@@ -248,10 +263,18 @@ function retrieveAndDecompress(db, contentId) {
   return coreCompression.retrieveAndDecompress(db, contentId);
 }
 
+function retrieveAndDecompressAsync(db, contentId) {
+  return coreCompression.retrieveAndDecompressAsync(db, contentId);
+}
+
 function selectCompressionType(db, contentSize, useCase = 'balanced') {
   return coreCompression.selectCompressionType(db, contentSize, useCase);
 }
 
+function getTypeDictionary(db, typeId, algorithm = null) {
+  return coreCompression.getTypeDictionary(db, typeId, algorithm);
+}
+
 module.exports = {
   PRESETS,
   PRESET_DEFINITIONS,
@@ -263,6 +286,7 @@ module.exports = {
   compress,
   compressWithPreset,
   decompress,
+  decompressAsync,
   getCompressionType,
   getCompressionConfigPreset,
   createStatsObject,
@@ -271,6 +295,8 @@ module.exports = {
   selectCompressionType,
   compressAndStore,
   retrieveAndDecompress,
+  retrieveAndDecompressAsync,
+  getTypeDictionary,
   resolvePresetName,
   getPreset
 };
@@ -29,9 +29,13 @@ class HtmlArticleExtractor {
    *
    * @param {string} html - Raw HTML content
    * @param {string} url - Source URL (for context)
+   * @param {Object} [options]
+   * @param {ParsedDocument} [options.parsedDocument] - Shared parse handle for
+   *   this HTML; when given, the Readability pass already run by the crawler
+   *   is reused instead of building another JSDOM.
    * @returns {Object} Extraction result
    */
-  extract(html, url = null) {
+  extract(html, url = null, { parsedDocument = null } = {}) {
     if (!html || typeof html !== 'string') {
       return {
         success: false,
@@ -42,22 +46,28 @@ class HtmlArticleExtractor {
     }
 
     try {
-      // Create DOM from HTML
-      const dom = new JSDOM(html, {
-        url: url || 'https://example.com',
-        virtualConsole: this._createVirtualConsole()
-      });
+      let article = null;
+      if (this._canReuse(parsedDocument, html)) {
+        // Same Readability settings as below (they are Readability's defaults)
+        ({ article } = parsedDocument.getReadability());
+      } else {
+        // Create DOM from HTML
+        const dom = new JSDOM(html, {
+          url: url || 'https://example.com',
+          virtualConsole: this._createVirtualConsole()
+        });
 
-      // Run Readability extraction
-      const reader = new Readability(dom.window.document, {
-        debug: false,
-        maxElemsToParse: 0, // No limit
-        nbTopCandidates: 5,
-        charThreshold: 500,
-        classesToPreserve: []
-      });
+        // Run Readability extraction
+        const reader = new Readability(dom.window.document, {
+          debug: false,
+          maxElemsToParse: 0, // No limit
+          nbTopCandidates: 5,
+          charThreshold: 500,
+          classesToPreserve: []
+        });
 
-      const article = reader.parse();
+        article = reader.parse();
+      }
 
       if (!article || !article.textContent) {
         return {
@@ -119,7 +129,7 @@ class HtmlArticleExtractor {
    * @returns {string} Clean text suitable for place matching
    */
   extractForPlaceMatching(html, url = null, options = {}) {
-    const result = this.extract(html, url);
+    const result = this.extract(html, url, { parsedDocument: options.parsedDocument || null });
 
     if (!result.success) {
       // Fallback to basic HTML stripping if Readability fails
@@ -409,9 +419,12 @@ class HtmlArticleExtractor {
    *
    * @param {string} html - Raw HTML content
    * @param {string} url - Source URL (for context)
+   * @param {Object} [options]
+   * @param {ParsedDocument} [options.parsedDocument] - Shared parse handle; the
+   *   pristine document is taken from it so its lifetime follows the page.
    * @returns {Object} Extended extraction result
    */
-  extractPlus(html, url = null) {
+  extractPlus(html, url = null, { parsedDocument = null } = {}) {
     if (!html || typeof html !== 'string') {
       return {
         success: false,
@@ -423,20 +436,22 @@ class HtmlArticleExtractor {
     }
 
     try {
-      // Create DOM from HTML
-      const dom = new JSDOM(html, {
-        url: url || 'https://example.com',
-        virtualConsole: this._createVirtualConsole()
-      });
+      // nav stripping mutates the tree, so this always needs its own document
+      const document = this._canReuse(parsedDocument, html)
+        ? parsedDocument.takePristineDocument()
+        : new JSDOM(html, {
+          url: url || 'https://example.com',
+          virtualConsole: this._createVirtualConsole()
+        }).window.document;
 
       // Extract additional metadata from HTML BEFORE removing navigation elements
-      const extendedMetadata = this._extractExtendedMetadata(dom.window.document, null);
+      const extendedMetadata = this._extractExtendedMetadata(document, null);
 
       // Remove navigation elements before processing
-      this._removeNavigationElements(dom.window.document);
+      this._removeNavigationElements(document);
 
       // Run Readability extraction
-      const reader = new Readability(dom.window.document, {
+      const reader = new Readability(document, {
         debug: false,
         maxElemsToParse: 0, // No limit
         nbTopCandidates: 5,
@@ -805,6 +820,10 @@ class HtmlArticleExtractor {
     return socialLinks;
   }
 
+  _canReuse(parsedDocument, html) {
+    return !!parsedDocument && typeof parsedDocument.getReadability === 'function' && parsedDocument.html === html;
+  }
+
   /**
    * Create a virtual console to suppress JSDOM warnings
    */
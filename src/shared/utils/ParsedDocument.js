@@ -0,0 +1,174 @@
+'use strict';
+
+/**
+ * ParsedDocument
+ *
+ * One parse handle per fetched page. Link extraction, signal computation,
+ * metadata extraction and Readability all used to parse the same HTML
+ * independently (three cheerio trees plus a JSDOM per article). A
+ * ParsedDocument builds the cheerio tree on first use and the JSDOM only when
+ * Readability (or another DOM consumer) actually asks for it, then hands the
+ * same instances to every later caller.
+ *
+ * Readability mutates the DOM it runs on, so JSDOM access goes through two
+ * entry points:
+ *  - `getReadability()` runs Readability once and memoises the article along
+ *    with the (now mutated) document it ran against. Every later consumer that
+ *    only needs the Readability output shares that single parse.
+ *  - `takePristineDocument()` returns an untouched document for consumers that
+ *    must mutate the tree themselves (e.g. nav stripping before a custom
+ *    Readability pass). Each call is a real parse.
+ *
+ * `getStats()` reports how many parses were performed and how many were
+ * avoided by reuse, so callers can surface the saving per page.
+ */
+
+const cheerio = require('cheerio');
+const { Readability } = require('@mozilla/readability');
+const { createJsdom } = require('./jsdomUtils');
+
+class ParsedDocument {
+  /**
+   * @param {Object} options
+   * @param {string} options.html - Raw HTML (required, may be empty)
+   * @param {string|null} [options.url] - Page URL for relative resolution
+   */
+  constructor({ html, url = null } = {}) {
+    if (typeof html !== 'string') {
+      throw new Error('ParsedDocument requires html as a string');
+    }
+    this.html = html;
+    this.url = url || null;
+
+    this._cheerio = null;
+    this._doms = [];
+    this._readability = null;
+    this._disposed = false;
+
+    this._stats = {
+      cheerioParses: 0,
+      cheerioReuses: 0,
+      jsdomParses: 0,
+      readabilityRuns: 0,
+      readabilityReuses: 0
+    };
+  }
+
+  /**
+   * Cheerio root for this page, parsed on first access.
+   * @returns {import('cheerio').CheerioAPI}
+   */
+  get $() {
+    return this.getCheerio();
+  }
+
+  getCheerio() {
+    if (this._cheerio) {
+      this._stats.cheerioReuses++;
+      return this._cheerio;
+    }
+    this._cheerio = cheerio.load(this.html);
+    this._stats.cheerioParses++;
+    return this._cheerio;
+  }
+
+  /**
+   * True once the cheerio tree has been built (useful for callers that only
+   * want to reuse an existing parse, never trigger one).
+   */
+  hasCheerio() {
+    return !!this._cheerio;
+  }
+
+  hasJsdom() {
+    return this._doms.length > 0;
+  }
+
+  /**
+   * Run Readability against the lazily-built JSDOM exactly once.
+   *
+   * @returns {{ article: Object|null, document: Document|null }}
+   *   `document` is the tree Readability ran against (mutated); callers that
+   *   derive positional data from it (article XPath) see the same state they
+   *   did when each built its own JSDOM.
+   */
+  getReadability() {
+    if (this._readability) {
+      this._stats.readabilityReuses++;
+      return this._readability;
+    }
+    const document = this._claimDocument();
+    const article = new Readability(document).parse();
+    this._stats.readabilityRuns++;
+    this._readability = { article: article || null, document };
+    return this._readability;
+  }
+
+  /**
+   * Return a document nobody has mutated yet. The caller owns (and may mutate)
+   * the returned tree; its lifetime is still tied to `dispose()`.
+   * @returns {Document}
+   */
+  takePristineDocument() {
+    return this._claimDocument();
+  }
+
+  /**
+   * @returns {{cheerioParses:number, jsdomParses:number, readabilityRuns:number, parsesAvoided:number}}
+   */
+  getStats() {
+    const s = this._stats;
+    return {
+      cheerioParses: s.cheerioParses,
+      jsdomParses: s.jsdomParses,
+      readabilityRuns: s.readabilityRuns,
+      parsesAvoided: s.cheerioReuses + s.readabilityReuses
+    };
+  }
+
+  /**
+   * Release JSDOM windows. Safe to call repeatedly.
+   */
+  dispose() {
+    if (this._disposed) return;
+    this._disposed = true;
+    for (const dom of this._doms) {
+      try { dom.window.close(); } catch (_) { /* ignore */ }
+    }
+    this._doms = [];
+    this._readability = null;
+    this._cheerio = null;
+  }
+
+  /**
+   * Each JSDOM is handed to exactly one mutating consumer. The first claim
+   * builds it lazily; later claims (Readability already ran, or a pristine
+   * copy was taken) pay for a fresh parse.
+   */
+  _claimDocument() {
+    if (this._disposed) {
+      throw new Error('ParsedDocument has been disposed');
+    }
+    const { dom } = createJsdom(this.html, this.url ? { url: this.url } : {});
+    this._stats.jsdomParses++;
+    this._doms.push(dom);
+    return dom.window.document;
+  }
+}
+
+/**
+ * Reuse a caller-supplied handle when it wraps the same HTML, otherwise build
+ * a new one. Returns `{ parsedDocument, owned }` so callers know whether they
+ * are responsible for disposing it.
+ */
+function resolveParsedDocument(parsedDocument, html, url = null) {
+  if (parsedDocument instanceof ParsedDocument && parsedDocument.html === html && !parsedDocument._disposed) {
+    return { parsedDocument, owned: false };
+  }
+  return { parsedDocument: new ParsedDocument({ html, url }), owned: true };
+}
+
+module.exports = {
+  ParsedDocument,
+  resolveParsedDocument
+};
@@ -5,17 +5,29 @@
  * in the urls table, supporting both individual and batch operations.
  */
 
+const { UrlIdCache } = require('./UrlIdCache');
+
+// pg has no bind-variable limit for array parameters; chunks bound the
+// size of each statement and of the lock footprint inside the transaction.
+const DEFAULT_CHUNK_SIZE = 5000;
+
 class PostgresUrlResolver {
   /**
    * Create a new URL resolver instance
    * @param {Pool} pool - Postgres connection pool
+   * @param {Object} [options]
+   * @param {number} [options.cacheSize=50000] - url -> url_id entries kept in the LRU (0 disables)
+   * @param {number} [options.chunkSize=5000] - URLs per UNNEST statement
    */
-  constructor(pool) {
+  constructor(pool, options = {}) {
     this.pool = pool;
+    this.cache = new UrlIdCache({ maxSize: options.cacheSize });
+    this.chunkSize = Math.max(1, Math.floor(options.chunkSize) || DEFAULT_CHUNK_SIZE);
   }
 
   /**
-   * Ensure a URL exists in the urls table and return its ID
+   * Ensure a URL exists in the urls table and return its ID.
+   * Cached URLs skip the database, so last_seen_at is only bumped on a miss.
    * @param {string} url - The URL to resolve
    * @returns {Promise<number>} The url_id for the URL
    */
@@ -24,6 +36,11 @@ class PostgresUrlResolver {
       throw new Error('URL must be a non-empty string');
     }
 
+    const cached = this.cache.get(url);
+    if (cached !== undefined) {
+      return cached;
+    }
+
     const client = await this.pool.connect();
     try {
       // Try to insert and return ID
@@ -34,25 +51,35 @@ class PostgresUrlResolver {
         RETURNING id
       `, [url]);
 
+      let id;
       if (insertRes.rows.length > 0) {
-        return insertRes.rows[0].id;
+        id = insertRes.rows[0].id;
+      } else {
+        // If insert didn't return (e.g. race condition or DO NOTHING behavior if I used that), fetch it
+        const fetchRes = await client.query('SELECT id FROM urls WHERE url = $1', [url]);
+        if (fetchRes.rows.length === 0) {
+          throw new Error(`Failed to resolve URL ID for: ${url}`);
+        }
+        id = fetchRes.rows[0].id;
       }
 
-      // If insert didn't return (e.g. race condition or DO NOTHING behavior if I used that), fetch it
-      const fetchRes = await client.query('SELECT id FROM urls WHERE url = $1', [url]);
-      if (fetchRes.rows.length === 0) {
-        throw new Error(`Failed to resolve URL ID for: ${url}`);
-      }
-      return fetchRes.rows[0].id;
+      this.cache.set(url, id);
+      return id;
     } finally {
       client.release();
     }
   }
 
   /**
-   * Batch resolve multiple URLs to their IDs
+   * Batch resolve multiple URLs to their IDs.
+   *
+   * Same contract as UrlResolver.batchResolve: cached URLs are answered from
+   * the LRU, the rest are upserted chunk by chunk in one transaction, new
+   * rows return their ids through RETURNING and only pre-existing URLs are
+   * selected back.
+   *
    * @param {string[]} urls - Array of URLs to resolve
-   * @returns {Promise<Map<string, number>>} Map of URL -> url_id
+   * @returns {Promise<Map<string, number>>} Map of URL -> url_id, in first-seen order
    */
   async batchResolve(urls) {
     if (!Array.isArray(urls)) {
@@ -64,40 +91,99 @@ class PostgresUrlResolver {
       return new Map();
     }
 
-    const client = await this.pool.connect();
-    try {
-      // Postgres doesn't have a hard limit on params like SQLite, but let's be safe and chunk if huge
-      // For now, assuming reasonable batch sizes or relying on pg's handling.
-      // Actually, let's use UNNEST for bulk insert which is very efficient in PG.
+    const known = new Map();
+    const pending = [];
+    for (const url of uniqueUrls) {
+      const id = this.cache.get(url);
+      if (id === undefined) {
+        pending.push(url);
+      } else {
+        known.set(url, id);
+      }
+    }
 
-      await client.query(`
-        INSERT INTO urls (url, created_at)
-        SELECT u, NOW()
-        FROM UNNEST($1::text[]) AS u
-        ON CONFLICT (url) DO NOTHING
-      `, [uniqueUrls]);
-
-      // Now select them all back
-      const res = await client.query(`
-        SELECT id, url FROM urls WHERE url = ANY($1::text[])
-      `, [uniqueUrls]);
-
-      const result = new Map();
-      for (const row of res.rows) {
-        result.set(row.url, row.id);
+    if (pending.length > 0) {
+      const resolved = await this._resolvePending(pending);
+      // Cache only after COMMIT so a rollback cannot leave phantom ids
+      for (const [url, id] of resolved) {
+        known.set(url, id);
+        this.cache.set(url, id);
       }
+    }
 
-      const missingUrls = uniqueUrls.filter(url => !result.has(url));
-      if (missingUrls.length > 0) {
-        console.warn(`Failed to resolve IDs for ${missingUrls.length} URLs:`, missingUrls.slice(0, 5));
+    const result = new Map();
+    const missingUrls = [];
+    for (const url of uniqueUrls) {
+      const id = known.get(url);
+      if (id === undefined) {
+        missingUrls.push(url);
+      } else {
+        result.set(url, id);
       }
+    }
 
-      return result;
+    if (missingUrls.length > 0) {
+      console.warn(`Failed to resolve IDs for ${missingUrls.length} URLs:`, missingUrls.slice(0, 5));
+    }
+
+    return result;
+  }
+
+  /**
+   * @private
+   * @param {string[]} pending - Uncached URLs
+   * @returns {Promise<Map<string, number>>}
+   */
+  async _resolvePending(pending) {
+    const resolved = new Map();
+    const client = await this.pool.connect();
+    try {
+      await client.query('BEGIN');
+      for (let offset = 0; offset < pending.length; offset += this.chunkSize) {
+        const chunk = pending.slice(offset, offset + this.chunkSize);
+        const inserted = await client.query(`
+          INSERT INTO urls (url, created_at)
+          SELECT u, NOW()
+          FROM UNNEST($1::text[]) AS u
+          ON CONFLICT (url) DO NOTHING
+          RETURNING id, url
+        `, [chunk]);
+        for (const row of inserted.rows) {
+          resolved.set(row.url, row.id);
+        }
+
+        const existing = chunk.filter(url => !resolved.has(url));
+        if (existing.length > 0) {
+          const res = await client.query(`
+            SELECT id, url FROM urls WHERE url = ANY($1::text[])
+          `, [existing]);
+          for (const row of res.rows) {
+            resolved.set(row.url, row.id);
+          }
+        }
+      }
+      await client.query('COMMIT');
+      return resolved;
+    } catch (error) {
+      await client.query('ROLLBACK').catch(() => {});
+      throw error;
     } finally {
       client.release();
     }
   }
 
+  /**
+   * Forget cached ids, e.g. after deleting rows from the urls table
+   * @param {string} [url] - Single URL to forget (default: all)
+   */
+  invalidate(url) {
+    if (url === undefined) {
+      this.cache.clear();
+    } else {
+      this.cache.delete(url);
+    }
+  }
+
   /**
    * Get URL string by ID
    * @param {number} urlId - The URL ID to resolve
@@ -152,7 +238,8 @@ class PostgresUrlResolver {
     return {
       totalUrls: parseInt(totalRes.rows[0].count, 10),
       recentUrls: parseInt(recentRes.rows[0].count, 10),
-      urlsTableExists: true
+      urlsTableExists: true,
+      cache: this.cache.getStats()
     };
   }
 }
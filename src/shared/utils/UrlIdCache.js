@@ -0,0 +1,82 @@
+/**
+ * URL ID Cache
+ *
+ * Bounded LRU of url -> url_id shared by UrlResolver and PostgresUrlResolver.
+ * Hub and section URLs are resolved on almost every page, so keeping their
+ * ids in memory means they never touch the database after the first lookup.
+ *
+ * Ids are immutable once assigned, so entries never go stale unless a row is
+ * deleted from `urls`; callers that delete URLs should call `delete()` or
+ * `clear()`.
+ */
+
+class UrlIdCache {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.maxSize=50000] - Entries kept before the least recently used is evicted (0 disables)
+   */
+  constructor(options = {}) {
+    const maxSize = options.maxSize === undefined ? 50000 : options.maxSize;
+    this.maxSize = Math.max(0, Math.floor(maxSize) || 0);
+    this.map = new Map(); // Insertion order doubles as recency order
+    this.stats = { hits: 0, misses: 0, evictions: 0 };
+  }
+
+  /**
+   * @param {string} url
+   * @returns {number|undefined}
+   */
+  get(url) {
+    const id = this.map.get(url);
+    if (id === undefined) {
+      this.stats.misses++;
+      return undefined;
+    }
+    // Move to the most recently used end
+    this.map.delete(url);
+    this.map.set(url, id);
+    this.stats.hits++;
+    return id;
+  }
+
+  /**
+   * @param {string} url
+   * @param {number} id
+   */
+  set(url, id) {
+    if (this.maxSize === 0) return;
+    if (this.map.has(url)) {
+      this.map.delete(url);
+    } else if (this.map.size >= this.maxSize) {
+      this.map.delete(this.map.keys().next().value);
+      this.stats.evictions++;
+    }
+    this.map.set(url, id);
+  }
+
+  delete(url) {
+    return this.map.delete(url);
+  }
+
+  clear() {
+    this.map.clear();
+  }
+
+  get size() {
+    return this.map.size;
+  }
+
+  getStats() {
+    const lookups = this.stats.hits + this.stats.misses;
+    return {
+      size: this.map.size,
+      maxSize: this.maxSize,
+      hits: this.stats.hits,
+      misses: this.stats.misses,
+      evictions: this.stats.evictions,
+      hitRate: lookups ? Number((this.stats.hits / lookups).toFixed(3)) : null
+    };
+  }
+}
+
+module.exports = { UrlIdCache };
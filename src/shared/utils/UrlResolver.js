@@ -9,17 +9,46 @@
  */
 
 const { ensureDb } = require('../../data/db/sqlite/ensureDb');
+const { UrlIdCache } = require('./UrlIdCache');
+
+// SQLITE_MAX_VARIABLE_NUMBER defaults: 999 before 3.32.0, 32766 since
+const LEGACY_VARIABLE_LIMIT = 999;
+const MODERN_VARIABLE_LIMIT = 32766;
 
 class UrlResolver {
   /**
    * Create a new URL resolver instance
    * @param {Database} db - SQLite database connection
+   * @param {Object} [options]
+   * @param {number} [options.cacheSize=50000] - url -> url_id entries kept in the LRU (0 disables)
+   * @param {number} [options.chunkSize] - URLs per multi-row statement (default and maximum: SQLite's variable limit)
    */
-  constructor(db) {
+  constructor(db, options = {}) {
     this.db = db;
+    this.cache = new UrlIdCache({ maxSize: options.cacheSize });
+    this._detectCapabilities();
+    this.chunkSize = Math.max(1, Math.min(this.variableLimit, Math.floor(options.chunkSize) || this.variableLimit));
     this._initStatements();
   }
 
+  /**
+   * Read the SQLite version to size chunks and decide whether RETURNING
+   * (3.35.0+) can hand back ids from the insert itself.
+   * @private
+   */
+  _detectCapabilities() {
+    let version = [0, 0, 0];
+    try {
+      const row = this.db.prepare('SELECT sqlite_version() AS version').get();
+      version = String(row.version).split('.').map(Number);
+    } catch (_) {
+      // Unknown build: assume the conservative limits
+    }
+    const atLeast = (major, minor) => version[0] > major || (version[0] === major && version[1] >= minor);
+    this.variableLimit = atLeast(3, 32) ? MODERN_VARIABLE_LIMIT : LEGACY_VARIABLE_LIMIT;
+    this.supportsReturning = atLeast(3, 35);
+  }
+
   /**
    * Initialize prepared statements for performance
    * @private
@@ -34,11 +63,13 @@ class UrlResolver {
     // Get URL ID by URL string
     this.getUrlIdStmt = this.db.prepare('SELECT id FROM urls WHERE url = ?');
 
-    // Batch insert URLs
-    this.batchInsertStmt = null; // Created dynamically for each batch
+    // Multi-row statements for batchResolve, keyed by kind and row count.
+    // Full-size chunks reuse one statement; the trailing partial chunk is prepared per call.
+    this._chunkStatements = new Map();
 
-    // Get multiple URL IDs
-    this.batchGetStmt = null; // Created dynamically for each batch
+    this._resolveChunks = typeof this.db.transaction === 'function'
+      ? this.db.transaction((pending) => this._resolvePending(pending))
+      : (pending) => this._resolvePending(pending);
   }
 
   /**
@@ -51,6 +82,11 @@ class UrlResolver {
       throw new Error('URL must be a non-empty string');
     }
 
+    const cached = this.cache.get(url);
+    if (cached !== undefined) {
+      return cached;
+    }
+
     // Insert if not exists (INSERT OR IGNORE)
     this.ensureUrlStmt.run(url);
 
@@ -60,13 +96,19 @@ class UrlResolver {
       throw new Error(`Failed to resolve URL ID for: ${url}`);
     }
 
+    this.cache.set(url, row.id);
     return row.id;
   }
 
   /**
-   * Batch resolve multiple URLs to their IDs
+   * Batch resolve multiple URLs to their IDs.
+   *
+   * Cached URLs are answered from the LRU. The rest are upserted in chunks of
+   * `chunkSize` inside one transaction: new rows return their ids through
+   * RETURNING, and only URLs that already existed are selected back.
+   *
    * @param {string[]} urls - Array of URLs to resolve
-   * @returns {Map<string, number>} Map of URL -> url_id
+   * @returns {Map<string, number>} Map of URL -> url_id, in first-seen order
    */
   batchResolve(urls) {
     if (!Array.isArray(urls)) {
@@ -78,42 +120,38 @@ class UrlResolver {
       return new Map();
     }
 
-    // Batch insert all URLs
-    const placeholders = uniqueUrls.map(() => '(?, datetime(\'now\'))').join(', ');
-    const insertSql = `INSERT OR IGNORE INTO urls (url, created_at) VALUES ${placeholders}`;
-
-    try {
-      this.db.prepare(insertSql).run(...uniqueUrls);
-    } catch (error) {
-      // If batch insert fails due to SQL parameter limits, fall back to individual inserts
-      if (error.message.includes('too many SQL variables') || uniqueUrls.length > 500) {
-        console.warn('Batch insert failed, falling back to individual inserts');
-        for (const url of uniqueUrls) {
-          try {
-            this.ensureUrlStmt.run(url);
-          } catch (insertError) {
-            console.warn(`Failed to insert URL: ${url}`, insertError.message);
-          }
-        }
+    const known = new Map();
+    const pending = [];
+    for (const url of uniqueUrls) {
+      const id = this.cache.get(url);
+      if (id === undefined) {
+        pending.push(url);
       } else {
-        throw error;
+        known.set(url, id);
       }
     }
 
-    // Batch select all IDs
-    const selectPlaceholders = uniqueUrls.map(() => '?').join(', ');
-    const selectSql = `SELECT id, url FROM urls WHERE url IN (${selectPlaceholders})`;
-
-    const rows = this.db.prepare(selectSql).all(...uniqueUrls);
+    if (pending.length > 0) {
+      // Cache only after the transaction commits so a rollback cannot leave phantom ids
+      const resolved = this._resolveChunks(pending);
+      for (const [url, id] of resolved) {
+        known.set(url, id);
+        this.cache.set(url, id);
+      }
+    }
 
     // Build result map
     const result = new Map();
-    for (const row of rows) {
-      result.set(row.url, row.id);
+    const missingUrls = [];
+    for (const url of uniqueUrls) {
+      const id = known.get(url);
+      if (id === undefined) {
+        missingUrls.push(url);
+      } else {
+        result.set(url, id);
+      }
     }
 
-    // Check for any missing URLs
-    const missingUrls = uniqueUrls.filter(url => !result.has(url));
     if (missingUrls.length > 0) {
       console.warn(`Failed to resolve IDs for ${missingUrls.length} URLs:`, missingUrls.slice(0, 5));
     }
@@ -121,6 +159,77 @@ class UrlResolver {
     return result;
   }
 
+  /**
+   * Insert and look up uncached URLs chunk by chunk. Runs inside the
+   * batchResolve transaction.
+   * @private
+   * @param {string[]} pending
+   * @returns {Map<string, number>}
+   */
+  _resolvePending(pending) {
+    const resolved = new Map();
+    for (const chunk of chunkArray(pending, this.chunkSize)) {
+      let existing = chunk;
+      if (this.supportsReturning) {
+        for (const row of this._chunkStatement('insertReturning', chunk.length).all(...chunk)) {
+          resolved.set(row.url, row.id);
+        }
+        existing = chunk.filter(url => !resolved.has(url));
+      } else {
+        this._chunkStatement('insert', chunk.length).run(...chunk);
+      }
+
+      if (existing.length > 0) {
+        for (const row of this._chunkStatement('select', existing.length).all(...existing)) {
+          resolved.set(row.url, row.id);
+        }
+      }
+    }
+    return resolved;
+  }
+
+  /**
+   * @private
+   * @param {'insert'|'insertReturning'|'select'} kind
+   * @param {number} count - Number of URLs bound to the statement
+   */
+  _chunkStatement(kind, count) {
+    const key = `${kind}:${count}`;
+    const cached = this._chunkStatements.get(key);
+    if (cached) {
+      return cached;
+    }
+
+    let sql;
+    if (kind === 'select') {
+      sql = `SELECT id, url FROM urls WHERE url IN (${new Array(count).fill('?').join(', ')})`;
+    } else {
+      const values = new Array(count).fill('(?, datetime(\'now\'))').join(', ');
+      sql = `INSERT OR IGNORE INTO urls (url, created_at) VALUES ${values}`;
+      if (kind === 'insertReturning') {
+        sql += ' RETURNING id, url';
+      }
+    }
+
+    const stmt = this.db.prepare(sql);
+    if (count === this.chunkSize) {
+      this._chunkStatements.set(key, stmt);
+    }
+    return stmt;
+  }
+
+  /**
+   * Forget cached ids, e.g. after deleting rows from the urls table
+   * @param {string} [url] - Single URL to forget (default: all)
+   */
+  invalidate(url) {
+    if (url === undefined) {
+      this.cache.clear();
+    } else {
+      this.cache.delete(url);
+    }
+  }
+
   /**
    * Get URL string by ID
    * @param {number} urlId - The URL ID to resolve
@@ -176,7 +285,8 @@ class UrlResolver {
     return {
       totalUrls,
       recentUrls,
-      urlsTableExists: true
+      urlsTableExists: true,
+      cache: this.cache.getStats()
     };
   }
 }
@@ -184,11 +294,12 @@ class UrlResolver {
 /**
  * Create a URL resolver with a new database connection
  * @param {string} dbPath - Path to the database file
+ * @param {Object} [options] - UrlResolver options (cacheSize, chunkSize)
  * @returns {UrlResolver} New URL resolver instance
  */
-function createUrlResolver(dbPath) {
+function createUrlResolver(dbPath, options) {
   const db = ensureDb(dbPath);
-  return new UrlResolver(db);
+  return new UrlResolver(db, options);
 }
 
 /**
@@ -0,0 +1,81 @@
+'use strict';
+
+const { ParsedDocument, resolveParsedDocument } = require('../ParsedDocument');
+
+describe('ParsedDocument', () => {
+  const html = `
+    <html lang="en">
+      <head><title>Story</title><link rel="canonical" href="https://example.com/news/story"></head>
+      <body>
+        <article>
+          <h1>Story headline</h1>
+          <p>${'Lorem ipsum dolor sit amet, consectetur adipiscing elit. '.repeat(20)}</p>
+          <p>${'Sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. '.repeat(20)}</p>
+        </article>
+      </body>
+    </html>
+  `;
+
+  it('parses cheerio once and counts reuses as avoided parses', () => {
+    const doc = new ParsedDocument({ html, url: 'https://example.com/news/story' });
+    const first = doc.$;
+    const second = doc.getCheerio();
+
+    expect(second).toBe(first);
+    expect(first('title').text()).toBe('Story');
+    expect(doc.getStats()).toMatchObject({ cheerioParses: 1, jsdomParses: 0, parsesAvoided: 1 });
+    doc.dispose();
+  });
+
+  it('does not build JSDOM until Readability is requested', () => {
+    const doc = new ParsedDocument({ html });
+    doc.getCheerio();
+    expect(doc.hasJsdom()).toBe(false);
+
+    const { article, document } = doc.getReadability();
+    expect(article).not.toBeNull();
+    expect(document.documentElement.getAttribute('lang')).toBe('en');
+    expect(doc.hasJsdom()).toBe(true);
+
+    const again = doc.getReadability();
+    expect(again.article).toBe(article);
+    expect(doc.getStats()).toMatchObject({ jsdomParses: 1, readabilityRuns: 1, parsesAvoided: 1 });
+    doc.dispose();
+  });
+
+  it('hands out a fresh pristine document once Readability has run', () => {
+    const doc = new ParsedDocument({ html });
+    const { document: readabilityDoc } = doc.getReadability();
+    const pristine = doc.takePristineDocument();
+
+    expect(pristine).not.toBe(readabilityDoc);
+    expect(pristine.querySelector('h1').textContent).toBe('Story headline');
+    expect(doc.getStats().jsdomParses).toBe(2);
+    doc.dispose();
+  });
+
+  it('refuses DOM access after dispose', () => {
+    const doc = new ParsedDocument({ html });
+    doc.dispose();
+    doc.dispose();
+    expect(() => doc.getReadability()).toThrow('disposed');
+  });
+
+  it('resolveParsedDocument reuses a matching handle and owns new ones', () => {
+    const shared = new ParsedDocument({ html });
+    expect(resolveParsedDocument(shared, html)).toEqual({ parsedDocument: shared, owned: false });
+
+    const other = resolveParsedDocument(shared, '<html></html>');
+    expect(other.owned).toBe(true);
+    expect(other.parsedDocument).not.toBe(shared);
+
+    const fresh = resolveParsedDocument(null, html, 'https://example.com/');
+    expect(fresh.owned).toBe(true);
+    expect(fresh.parsedDocument.url).toBe('https://example.com/');
+    shared.dispose();
+  });
+
+  it('rejects non-string html', () => {
+    expect(() => new ParsedDocument({ html: null })).toThrow('html as a string');
+  });
+});
@@ -0,0 +1,164 @@
+/**
+ * Tests for chunked URL resolution and the url -> id LRU
+ */
+
+const { UrlResolver } = require('../UrlResolver');
+const { PostgresUrlResolver } = require('../PostgresUrlResolver');
+const { UrlIdCache } = require('../UrlIdCache');
+
+// better-sqlite3-shaped handle over an in-memory urls table; records every
+// statement so tests can assert on chunking and transaction boundaries.
+function fakeSqlite(version = '3.45.1') {
+  const rows = new Map(); // url -> id
+  const log = [];
+  let nextId = 1;
+  const insert = (url) => {
+    if (rows.has(url)) return false;
+    rows.set(url, nextId++);
+    return true;
+  };
+  const db = {
+    rows,
+    log,
+    transaction: (fn) => (...args) => {
+      log.push('BEGIN');
+      const result = fn(...args);
+      log.push('COMMIT');
+      return result;
+    },
+    prepare(sql) {
+      const text = sql.replace(/\s+/g, ' ').trim();
+      if (text.startsWith('SELECT sqlite_version()')) {
+        return { get: () => ({ version }) };
+      }
+      if (text === 'SELECT id FROM urls WHERE url = ?') {
+        return { get: (url) => (rows.has(url) ? { id: rows.get(url) } : undefined) };
+      }
+      if (text.startsWith('INSERT OR IGNORE INTO urls')) {
+        const returning = text.endsWith('RETURNING id, url');
+        return {
+          run: (...urls) => {
+            log.push(`insert:${urls.length}`);
+            urls.forEach(insert);
+          },
+          all: (...urls) => {
+            if (!returning) throw new Error('not a RETURNING statement');
+            log.push(`insertReturning:${urls.length}`);
+            return urls.filter(insert).map(url => ({ id: rows.get(url), url }));
+          }
+        };
+      }
+      if (text.startsWith('SELECT id, url FROM urls WHERE url IN')) {
+        return {
+          all: (...urls) => {
+            log.push(`select:${urls.length}`);
+            return urls.filter(url => rows.has(url)).map(url => ({ id: rows.get(url), url }));
+          }
+        };
+      }
+      throw new Error(`Unexpected SQL: ${text}`);
+    }
+  };
+  return db;
+}
+
+describe('UrlIdCache', () => {
+  test('evicts the least recently used entry', () => {
+    const cache = new UrlIdCache({ maxSize: 2 });
+    cache.set('a', 1);
+    cache.set('b', 2);
+    expect(cache.get('a')).toBe(1);
+    cache.set('c', 3);
+
+    expect(cache.get('b')).toBeUndefined();
+    expect(cache.get('a')).toBe(1);
+    expect(cache.getStats()).toMatchObject({ size: 2, evictions: 1, hits: 2, misses: 1 });
+  });
+});
+
+describe('UrlResolver', () => {
+  test('upserts in variable-limit chunks inside one transaction', () => {
+    const db = fakeSqlite();
+    const resolver = new UrlResolver(db, { chunkSize: 2 });
+    db.rows.set('https://a.test/existing', 100);
+
+    const urls = ['https://a.test/1', 'https://a.test/existing', 'https://a.test/2', 'https://a.test/1', '', 'https://a.test/3'];
+    const result = resolver.batchResolve(urls);
+
+    expect([...result.keys()]).toEqual(['https://a.test/1', 'https://a.test/existing', 'https://a.test/2', 'https://a.test/3']);
+    expect(result.get('https://a.test/existing')).toBe(100);
+    // Only the pre-existing URL is selected back; new ids come from RETURNING
+    expect(db.log).toEqual(['BEGIN', 'insertReturning:2', 'select:1', 'insertReturning:2', 'COMMIT']);
+  });
+
+  test('serves hot URLs from the LRU without touching the database', () => {
+    const db = fakeSqlite();
+    const resolver = new UrlResolver(db);
+    const first = resolver.batchResolve(['https://a.test/hub', 'https://a.test/story']);
+    db.log.length = 0;
+
+    const again = resolver.batchResolve(['https://a.test/story', 'https://a.test/hub']);
+    expect(again.get('https://a.test/hub')).toBe(first.get('https://a.test/hub'));
+    expect(resolver.ensureUrlId('https://a.test/story')).toBe(first.get('https://a.test/story'));
+    expect(db.log).toEqual([]);
+    expect(resolver.cache.getStats()).toMatchObject({ size: 2, hits: 3 });
+  });
+
+  test('falls back to insert-then-select on SQLite builds without RETURNING', () => {
+    const db = fakeSqlite('3.31.1');
+    const resolver = new UrlResolver(db);
+    expect(resolver.chunkSize).toBe(999);
+
+    const urls = Array.from({ length: 1500 }, (_, i) => `https://a.test/${i}`);
+    const result = resolver.batchResolve(urls);
+
+    expect(result.size).toBe(1500);
+    expect(db.log).toEqual(['BEGIN', 'insert:999', 'select:999', 'insert:501', 'select:501', 'COMMIT']);
+  });
+});
+
+describe('PostgresUrlResolver', () => {
+  function fakePool() {
+    const rows = new Map();
+    const log = [];
+    let nextId = 1;
+    const client = {
+      query: async (sql, params = []) => {
+        const text = sql.replace(/\s+/g, ' ').trim();
+        if (['BEGIN', 'COMMIT', 'ROLLBACK'].includes(text)) {
+          log.push(text);
+          return { rows: [] };
+        }
+        const urls = params[0];
+        if (text.startsWith('INSERT INTO urls') && text.includes('UNNEST')) {
+          log.push(`insert:${urls.length}`);
+          const inserted = urls.filter(url => !rows.has(url));
+          inserted.forEach(url => rows.set(url, nextId++));
+          return { rows: inserted.map(url => ({ id: rows.get(url), url })) };
+        }
+        if (text.startsWith('SELECT id, url FROM urls WHERE url = ANY')) {
+          log.push(`select:${urls.length}`);
+          return { rows: urls.filter(url => rows.has(url)).map(url => ({ id: rows.get(url), url })) };
+        }
+        throw new Error(`Unexpected SQL: ${text}`);
+      },
+      release: () => {}
+    };
+    return { rows, log, connect: async () => client };
+  }
+
+  test('shares the chunked, cached batch contract', async () => {
+    const pool = fakePool();
+    pool.rows.set('https://a.test/existing', 7);
+    const resolver = new PostgresUrlResolver(pool, { chunkSize: 2 });
+
+    const result = await resolver.batchResolve(['https://a.test/existing', 'https://a.test/1', 'https://a.test/2']);
+    expect([...result.entries()]).toEqual([['https://a.test/existing', 7], ['https://a.test/1', 1], ['https://a.test/2', 2]]);
+    expect(pool.log).toEqual(['BEGIN', 'insert:2', 'select:1', 'insert:1', 'COMMIT']);
+
+    pool.log.length = 0;
+    expect(await resolver.ensureUrlId('https://a.test/2')).toBe(2);
+    await resolver.batchResolve(['https://a.test/1']);
+    expect(pool.log).toEqual([]);
+  });
+});
@@ -5,6 +5,7 @@ const { openNewsCrawlerDb } = require('../../../db/openNewsCrawlerDb');
 
 const { BucketCache, getGlobalCache, resetGlobalCache } = require('../bucketCache');
 const { createBucket } = require('../compressionBuckets');
+const frameIndexMigration = require('../../../data/db/sqlite/v1/migrations/add_bucket_frame_index_column');
 const fs = require('fs');
 const path = require('path');
 
@@ -18,6 +19,7 @@ describe('bucketCache', () => {
     // Create schema
     const { initCompressionTables } = require('../../../data/db/sqlite/schema');
     initCompressionTables(db, { verbose: false, logger: console });
+    frameIndexMigration.up(db);
   });
   
   afterEach(() => {
@@ -402,4 +404,59 @@ describe('bucketCache', () => {
       expect(entries[1].accessCount).toBe(1);
     });
   });
+  
+  describe('async reads', () => {
+    test('should coalesce concurrent misses for the same bucket', async () => {
+      const { bucketId } = await createBucket(db, {
+        bucketType: 'test',
+        compressionType: 'brotli_11',
+        items: [{ key: 'a', content: 'Content A'.repeat(200) }, { key: 'b', content: 'Content B'.repeat(200) }]
+      });
+      
+      const cache = new BucketCache();
+      const [first, second, entry] = await Promise.all([
+        cache.getAsync(db, bucketId),
+        cache.getAsync(db, bucketId),
+        cache.getEntryAsync(db, bucketId, 'b')
+      ]);
+      
+      expect(first.fromCache).toBe(false);
+      expect(second).toMatchObject({ fromCache: true, coalesced: true });
+      expect(second.tarBuffer).toBe(first.tarBuffer);
+      expect(entry.content.toString('utf8')).toBe('Content B'.repeat(200));
+      expect(cache.getStats()).toMatchObject({ misses: 1, coalesced: 2, inflight: 0 });
+      expect((await cache.getAsync(db, bucketId)).fromCache).toBe(true);
+    });
+    
+    test('should prefetch upcoming buckets and seekable frames', async () => {
+      const tarBucket = await createBucket(db, {
+        bucketType: 'test',
+        compressionType: 'gzip_6',
+        items: [{ key: 't1', content: 'Tar content' }]
+      });
+      const seekable = await createBucket(db, {
+        bucketType: 'test',
+        compressionType: 'gzip_6',
+        format: 'seekable',
+        frameBytes: 1000,
+        items: [{ key: 's1', content: 'x'.repeat(900) }, { key: 's2', content: 'y'.repeat(900) }]
+      });
+      
+      const cache = new BucketCache();
+      const started = cache.prefetch(db, [tarBucket.bucketId, { bucketId: seekable.bucketId, entryKey: 's2' }, 99999]);
+      expect(started).toBe(2);
+      expect(cache.prefetch(db, [tarBucket.bucketId])).toBe(0);  // already loading
+      
+      const entry = await cache.getEntryAsync(db, seekable.bucketId, 's2');
+      expect(entry).toMatchObject({ fromCache: true });
+      expect(entry.content.toString('utf8')).toBe('y'.repeat(900));
+      expect((await cache.getAsync(db, tarBucket.bucketId)).fromCache).toBe(true);
+      expect(cache.has(seekable.bucketId)).toBe(true);
+      expect(cache.getEntries().map((e) => e.frame).filter((f) => f !== null)).toEqual([1]);
+      
+      const warmed = await new BucketCache().prewarmAsync(db, [tarBucket.bucketId, seekable.bucketId, 99999]);
+      expect(warmed.loaded).toBe(2);
+      expect(warmed.errors).toHaveLength(1);
+    });
+  });
 });
@@ -0,0 +1,153 @@
+const { openNewsCrawlerDb } = require('../../../db/openNewsCrawlerDb');
+/**
+ * Tests for per-domain compression dictionaries
+ */
+
+const {
+  trainDictionary,
+  saveDomainDictionary,
+  getDomainDictionaryType,
+  compressWithDictionary
+} = require('../compressionDictionaries');
+const {
+  compress,
+  decompress,
+  compressAndStore,
+  retrieveAndDecompress
+} = require('../CompressionFacade');
+const { CompressionAnalytics } = require('../CompressionAnalytics');
+const { DecompressionWorkerPool } = require('../../../background/workers/DecompressionWorkerPool');
+const dictionaryColumnsMigration = require('../../../data/db/sqlite/v1/migrations/add_compression_dictionary_columns');
+
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+// Site pages: shared chrome around a body of varied words
+function samplePages(count, seed = 1) {
+  const rand = mulberry32(seed);
+  const words = ['council', 'river', 'election', 'market', 'weather', 'school', 'bridge', 'festival', 'budget', 'harbour', 'rail', 'museum'];
+  const pages = [];
+  for (let i = 0; i < count; i++) {
+    let body = '';
+    const sentences = 20 + (rand() % 20);
+    for (let s = 0; s < sentences; s++) {
+      const length = 6 + (rand() % 10);
+      const sentence = [];
+      for (let w = 0; w < length; w++) sentence.push(words[rand() % words.length]);
+      body += `<p>${sentence.join(' ')} ${rand().toString(36)}.</p>\n`;
+    }
+    pages.push(`<!DOCTYPE html><html lang="en"><head><meta charset="utf-8"><title>Story ${i} | Example Gazette</title>
+<link rel="stylesheet" href="/static/css/site.min.css"><script src="/static/js/analytics.js" async></script></head>
+<body class="article-page"><header class="masthead"><a href="/" class="logo">Example Gazette</a>
+<nav><ul><li><a href="/news">News</a></li><li><a href="/sport">Sport</a></li><li><a href="/business">Business</a></li><li><a href="/opinion">Opinion</a></li></ul></nav></header>
+<main><article><h1>Headline ${i}</h1>${body}</article></main>
+<footer class="site-footer"><p>&copy; Example Gazette Media Ltd. All rights reserved.</p><a href="/privacy">Privacy policy</a> <a href="/terms">Terms of use</a></footer></body></html>`);
+  }
+  return pages;
+}
+
+describe('compressionDictionaries', () => {
+  test('dictionary-compressed pages decompress on their own and beat per-page compression', () => {
+    const pages = samplePages(40);
+    const dictionary = trainDictionary(pages.slice(0, 20), { maxBytes: 16 * 1024 });
+    expect(dictionary.length).toBeGreaterThan(0);
+    expect(dictionary.length).toBeLessThanOrEqual(16 * 1024);
+
+    let plain = 0;
+    let withDictionary = 0;
+    for (const page of pages.slice(20)) {
+      plain += compress(page, { algorithm: 'deflate', level: 9 }).compressedSize;
+      const result = compress(page, { algorithm: 'deflate', level: 9, dictionary });
+      withDictionary += result.compressedSize;
+      expect(decompress(result.compressed, 'deflate', { dictionary }).toString('utf8')).toBe(page);
+    }
+    expect(withDictionary).toBeLessThan(plain * 0.8);
+  });
+
+  test('decompression workers receive each dictionary once', async () => {
+    const pages = samplePages(6, 2);
+    const dictionary = trainDictionary(pages.slice(0, 4));
+    const pool = new DecompressionWorkerPool({ poolSize: 1 });
+    try {
+      for (const page of pages.slice(4)) {
+        const { compressed } = compress(page, { algorithm: 'deflate', dictionary });
+        const result = await pool.decompress(compressed, 'deflate', null, { dictionary, dictionaryId: 42 });
+        expect(result.buffer.toString('utf8')).toBe(page);
+      }
+      expect(Array.from(pool.workers[0].__dictionaries)).toEqual(['42']);
+    } finally {
+      await pool.shutdown();
+    }
+  });
+
+  test('CompressionAnalytics compares dictionary, per-page and bucket compression', async () => {
+    const analytics = new CompressionAnalytics({ logger: { warn() {}, info() {} } });
+    const report = await analytics.compareDictionaryCompression({
+      domain: 'example.com',
+      samples: samplePages(30, 3),
+      useStoredDictionary: false,
+      decodeRepeats: 1
+    });
+
+    expect(report.samples).toMatchObject({ train: 15, measured: 15 });
+    expect(report.dictionarySource).toBe('trained');
+    const { individual, dictionary, bucket } = report.modes;
+    expect(dictionary.ratio).toBeLessThan(individual.ratio);
+    expect(bucket.ratio).toBeLessThan(individual.ratio);
+    expect(bucket.pagesPerBucket).toBe(15);
+    for (const mode of [individual, dictionary, bucket]) {
+      expect(mode.decodeUsPerPage).toBeGreaterThanOrEqual(0);
+    }
+    expect(report.dictionaryVsBucket.sizeFactor).toBeGreaterThan(0);
+  });
+
+  describe('stored dictionaries', () => {
+    let db;
+
+    beforeEach(() => {
+      db = openNewsCrawlerDb(':memory:');
+      const { initializeSchema } = require('../../../data/db/sqlite/schema');
+      initializeSchema(db, { verbose: false, logger: console });
+      dictionaryColumnsMigration.up(db);
+    });
+
+    afterEach(() => {
+      db.close();
+    });
+
+    test('dictionary columns come from the migration, not from first use', () => {
+      dictionaryColumnsMigration.down(db);
+      expect(dictionaryColumnsMigration.isApplied(db)).toBe(false);
+      const dictionary = trainDictionary(samplePages(4, 5));
+      expect(() => saveDomainDictionary(db, 'example.com', dictionary)).toThrow(/project-migrations/);
+      expect(getDomainDictionaryType(db, 'example.com')).toBeNull();
+      expect(dictionaryColumnsMigration.isApplied(db)).toBe(false);
+
+      expect(dictionaryColumnsMigration.up(db).addedColumns).toHaveLength(4);
+      expect(dictionaryColumnsMigration.up(db).alreadyApplied).toBe(true);
+      expect(saveDomainDictionary(db, 'example.com', dictionary).dictionary_domain).toBe('example.com');
+    });
+
+    test('content stored with a dictionary type round-trips through retrieveAndDecompress', () => {
+      const pages = samplePages(12, 4);
+      const type = saveDomainDictionary(db, 'example.com', trainDictionary(pages.slice(0, 10)), { sampleCount: 10 });
+      expect(type.name).toMatch(/_dict_example_com_1$/);
+      expect(getDomainDictionaryType(db, 'Example.com').id).toBe(type.id);
+
+      const stored = compressAndStore(db, pages[11], { compressionType: type.name });
+      expect(retrieveAndDecompress(db, stored.contentId).toString('utf8')).toBe(pages[11]);
+      expect(compressWithDictionary(pages[11], type).compressedSize).toBe(stored.compressedSize);
+
+      const retrained = saveDomainDictionary(db, 'example.com', trainDictionary(pages.slice(2, 12)));
+      expect(retrained.name).toMatch(/_dict_example_com_2$/);
+      expect(getDomainDictionaryType(db, 'example.com').id).toBe(retrained.id);
+      expect(retrieveAndDecompress(db, stored.contentId).toString('utf8')).toBe(pages[11]);
+    });
+  });
+});
@@ -0,0 +1,189 @@
+const { openNewsCrawlerDb } = require('../../../db/openNewsCrawlerDb');
+/**
+ * Tests for the seekable (framed) bucket format
+ */
+
+const { buildFrames, readBucketLayout, readTarEntries, writeTarEntries } = require('../seekableBucket');
+const { createBucket, retrieveFromBucket, finalizeBucket, migrateBucketsToSeekable } = require('../compressionBuckets');
+const { BucketCache } = require('../bucketCache');
+const { decompress } = require('../CompressionFacade');
+const frameIndexMigration = require('../../../data/db/sqlite/v1/migrations/add_bucket_frame_index_column');
+
+function pages(count, size = 4000) {
+  const items = [];
+  for (let i = 0; i < count; i++) {
+    const body = `<p>story ${i} paragraph</p>`.repeat(Math.ceil(size / 24)).slice(0, size);
+    items.push({ key: `https://example.com/story/${i}?ref=${'x'.repeat(i % 3 ? 0 : 120)}`, content: `<html>${body}</html>`, metadata: { i } });
+  }
+  return items;
+}
+
+describe('seekableBucket', () => {
+  test('buildFrames keeps entries whole and frames independently decodable', () => {
+    const entries = pages(10, 3000).map(({ key, content }) => ({ key, buffer: Buffer.from(content) }));
+    const { blob, frames, placements } = buildFrames(entries, { algorithm: 'gzip', level: 6 }, { frameBytes: 8000 });
+
+    expect(frames.length).toBeGreaterThan(1);
+    expect(frames[frames.length - 1][0] + frames[frames.length - 1][1]).toBe(blob.length);
+    for (const { key, buffer } of entries) {
+      const { frame, offset } = placements.get(key);
+      const [start, length, size] = frames[frame];
+      const raw = decompress(blob.subarray(start, start + length), 'gzip');
+      expect(raw.length).toBe(size);
+      expect(raw.subarray(offset, offset + buffer.length).equals(buffer)).toBe(true);
+    }
+  });
+
+  test('an entry larger than the frame target gets a frame of its own', () => {
+    const entries = [
+      { key: 'a', buffer: Buffer.alloc(100, 'a') },
+      { key: 'big', buffer: Buffer.alloc(5000, 'b') },
+      { key: 'c', buffer: Buffer.alloc(100, 'c') }
+    ];
+    const { frames, placements } = buildFrames(entries, { algorithm: 'gzip' }, { frameBytes: 1000 });
+    expect(frames.map((frame) => frame[2])).toEqual([100, 5000, 100]);
+    expect(placements.get('big')).toEqual({ frame: 1, offset: 0 });
+  });
+
+  test('writeTarEntries round-trips through readTarEntries, long names included', () => {
+    const entries = [
+      { name: 'short.html', content: Buffer.from('<p>a</p>') },
+      { name: `${'n'.repeat(140)}.html`, content: Buffer.alloc(1300, 'b') },
+      { name: 'empty.html', content: Buffer.alloc(0) }
+    ];
+    const tarBuffer = writeTarEntries(entries);
+    expect(tarBuffer.length % 512).toBe(0);
+    expect(readTarEntries(tarBuffer)).toEqual(entries);
+  });
+
+  describe('with a database', () => {
+    let db;
+
+    beforeEach(() => {
+      db = openNewsCrawlerDb(':memory:');
+      const { initializeSchema } = require('../../../data/db/sqlite/schema');
+      initializeSchema(db, { verbose: false, logger: console });
+      frameIndexMigration.up(db);
+    });
+
+    afterEach(() => {
+      db.close();
+    });
+
+    test('seekable buckets read one entry from one frame', async () => {
+      const items = pages(12);
+      const result = await createBucket(db, {
+        bucketType: 'article_content',
+        compressionType: 'brotli_6',
+        format: 'seekable',
+        frameBytes: 10000,
+        items
+      });
+      expect(result).toMatchObject({ format: 'seekable', itemCount: 12, tarArchiveSize: null });
+      expect(result.frameCount).toBeGreaterThan(1);
+
+      for (const item of items) {
+        const { content, metadata } = await retrieveFromBucket(db, result.bucketId, item.key);
+        expect(content.toString('utf8')).toBe(item.content);
+        expect(metadata).toEqual(item.metadata);
+      }
+    });
+
+    test('seekable buckets need the frame index migration', async () => {
+      frameIndexMigration.down(db);
+      expect(frameIndexMigration.isApplied(db)).toBe(false);
+      await expect(createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', format: 'seekable', items: pages(2) }))
+        .rejects.toThrow('project-migrations');
+      const { bucketId } = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', items: pages(2) });
+      expect(readBucketLayout(db, bucketId).frames).toBeNull();
+      expect(frameIndexMigration.isApplied(db)).toBe(false);
+    });
+
+    test('finalizeBucket keeps the tar format unless asked to convert', async () => {
+      const { bucketId } = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', items: pages(3) });
+      expect(finalizeBucket(db, bucketId)).toMatchObject({ converted: false, frameCount: null });
+      expect(readBucketLayout(db, bucketId).frames).toBeNull();
+    });
+
+    test('finalizeBucket converts a legacy tar bucket in place', async () => {
+      const items = pages(8);
+      const { bucketId } = await createBucket(db, { bucketType: 'article_content', compressionType: 'gzip_6', items });
+      expect(readBucketLayout(db, bucketId).frames).toBeNull();
+
+      const outcome = finalizeBucket(db, bucketId, { seekable: true, frameBytes: 12000 });
+      expect(outcome).toMatchObject({ bucketId, converted: true });
+      expect(outcome.frameCount).toBeGreaterThan(1);
+
+      const layout = readBucketLayout(db, bucketId);
+      expect(layout.frames).toHaveLength(outcome.frameCount);
+      for (const item of items) {
+        expect(layout.index[item.key].filename).toEqual(expect.any(String));
+        const { content } = await retrieveFromBucket(db, bucketId, item.key);
+        expect(content.toString('utf8')).toBe(item.content);
+      }
+      expect(() => finalizeBucket(db, bucketId)).toThrow('already finalized');
+    });
+
+    test('migrateBucketsToSeekable picks up buckets finalized as tar', async () => {
+      const items = pages(3);
+      const { bucketId } = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', items });
+      finalizeBucket(db, bucketId, { seekable: false });
+
+      expect(migrateBucketsToSeekable(db)).toEqual({ converted: 1, failed: [] });
+      expect(migrateBucketsToSeekable(db)).toEqual({ converted: 0, failed: [] });
+      const { content } = await retrieveFromBucket(db, bucketId, items[2].key);
+      expect(content.toString('utf8')).toBe(items[2].content);
+    });
+
+    test('BucketCache caches frames for seekable buckets and tars for legacy ones', async () => {
+      const items = pages(12);
+      const seekable = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', format: 'seekable', frameBytes: 10000, items });
+      const legacy = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', items: items.slice(0, 2) });
+      const cache = new BucketCache({ maxSize: 2, maxFrames: 2 });
+
+      const first = await cache.getEntry(db, seekable.bucketId, items[0].key);
+      const again = await cache.getEntry(db, seekable.bucketId, items[1].key);
+      expect(first.fromCache).toBe(false);
+      expect(again.fromCache).toBe(true);
+      expect(again.content.toString('utf8')).toBe(items[1].content);
+      expect(cache.getEntries()).toEqual([expect.objectContaining({ bucketId: seekable.bucketId, frame: 0 })]);
+
+      await cache.getEntry(db, seekable.bucketId, items[11].key);
+      await cache.getEntry(db, seekable.bucketId, items[6].key);
+      expect(cache.getEntries()).toHaveLength(2);
+      expect(cache.getStats().evictions).toBe(1);
+
+      const tarEntry = await cache.getEntry(db, legacy.bucketId, items[1].key);
+      expect(tarEntry.content.toString('utf8')).toBe(items[1].content);
+      expect(cache.get(db, legacy.bucketId).fromCache).toBe(true);
+
+      // get() on a seekable bucket is a full read returning the tar payload
+      const whole = cache.get(db, seekable.bucketId);
+      expect(whole.fromCache).toBe(false);
+      expect(readTarEntries(whole.tarBuffer).map((file) => file.content.toString('utf8')))
+        .toEqual(items.map((item) => item.content));
+      expect((await cache.getAsync(db, seekable.bucketId)).tarBuffer).toBe(whole.tarBuffer);
+
+      expect(cache.evict(seekable.bucketId)).toBe(true);
+      expect(cache.has(seekable.bucketId)).toBe(false);
+      expect(cache.has(legacy.bucketId)).toBe(true);
+    });
+
+    test('a layout cached while the bucket was a tar is replaced after conversion', async () => {
+      const items = pages(8);
+      const { bucketId } = await createBucket(db, { bucketType: 'test', compressionType: 'brotli_6', items });
+      const cache = new BucketCache({ maxSize: 2 });
+      await cache.getEntry(db, bucketId, items[0].key);
+      expect(cache.layouts.get(bucketId).frames).toBeNull();
+
+      finalizeBucket(db, bucketId, { seekable: true, frameBytes: 12000 });
+      cache.cache.delete(bucketId); // the tar buffer aged out, the layout did not
+
+      const { content } = await cache.getEntry(db, bucketId, items[5].key);
+      expect(content.toString('utf8')).toBe(items[5].content);
+      expect(cache.layouts.get(bucketId).frames.length).toBeGreaterThan(1);
+      const asyncRead = await cache.getEntryAsync(db, bucketId, items[7].key);
+      expect(asyncRead.content.toString('utf8')).toBe(items[7].content);
+    });
+  });
+});
@@ -0,0 +1,62 @@
+const { openNewsCrawlerDb } = require('../../../db/openNewsCrawlerDb');
+/**
+ * Tests for the async stored content reader
+ */
+
+const { StoredContentReader, describeContentSource } = require('../storedContentReader');
+const { BucketCache } = require('../bucketCache');
+const { createBucket } = require('../compressionBuckets');
+const { compress } = require('../CompressionFacade');
+
+describe('storedContentReader', () => {
+  test('describeContentSource recognises bucket, inline, stored and text rows', () => {
+    expect(describeContentSource({ compression_bucket_id: 3, bucket_entry_key: 'k' })).toEqual({ kind: 'bucket', bucketId: 3, entryKey: 'k' });
+    expect(describeContentSource({ compression_bucket_id: 3, compression_bucket_key: 'k' }).kind).toBe('bucket');
+    expect(describeContentSource({ content_blob: Buffer.from('x'), compression_algorithm: 'GZIP' })).toMatchObject({ kind: 'inline', algorithm: 'gzip' });
+    expect(describeContentSource({ content_id: 7 })).toEqual({ kind: 'stored', contentId: 7 });
+    expect(describeContentSource({ html: '<p>' })).toEqual({ kind: 'text', text: '<p>' });
+    expect(describeContentSource({ url: 'https://example.com' })).toBeNull();
+  });
+
+  describe('with a database', () => {
+    let db;
+
+    beforeEach(() => {
+      db = openNewsCrawlerDb(':memory:');
+      const { initializeSchema } = require('../../../data/db/sqlite/schema');
+      initializeSchema(db, { verbose: false, logger: console });
+    });
+
+    afterEach(() => {
+      db.close();
+    });
+
+    test('readAll yields rows in order, decompressing each bucket once', async () => {
+      const items = [];
+      for (let i = 0; i < 6; i++) items.push({ key: `page-${i}`, content: `<html>page ${i} ${'body '.repeat(50)}</html>` });
+      const first = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', items: items.slice(0, 3) });
+      const second = await createBucket(db, { bucketType: 'test', compressionType: 'gzip_6', format: 'seekable', items: items.slice(3) });
+      const inline = { content_blob: compress('<html>inline</html>', { algorithm: 'brotli', level: 5 }).compressed, compression_algorithm: 'brotli' };
+
+      const rows = [
+        ...items.slice(0, 3).map((item) => ({ compression_bucket_id: first.bucketId, bucket_entry_key: item.key })),
+        inline,
+        { compression_bucket_id: first.bucketId, bucket_entry_key: 'missing' },
+        ...items.slice(3).map((item) => ({ compression_bucket_id: second.bucketId, bucket_entry_key: item.key }))
+      ];
+      const bucketCache = new BucketCache();
+      const reader = new StoredContentReader({ db, bucketCache, concurrency: 2, prefetchBuckets: 1 });
+
+      const results = [];
+      for await (const result of reader.readAll(rows)) results.push(result);
+
+      expect(results.map((result) => result.row)).toEqual(rows);
+      expect(results.map((result) => result.content && result.content.toString('utf8'))).toEqual([
+        items[0].content, items[1].content, items[2].content, '<html>inline</html>', null,
+        items[3].content, items[4].content, items[5].content
+      ]);
+      expect(results[4].error.message).toMatch('Entry not found');
+      expect(bucketCache.getStats().misses).toBe(2);
+    });
+  });
+});
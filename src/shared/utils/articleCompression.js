@@ -10,7 +10,7 @@
 
 const {
   compress,
-  decompress,
+  decompressAsync,
   getCompressionType,
   getCompressionConfigPreset,
   resolvePresetName,
@@ -50,15 +50,9 @@ async function decompressArticleHtml(db, articleId, options = {}) {
     
     // If stored in compression bucket
     if (article.compression_bucket_id && article.compression_bucket_key) {
-      const cache = useCache ? getGlobalCache() : null;
-      const cachedTarBuffer = cache ? cache.get(db, article.compression_bucket_id).tarBuffer : null;
-      
-      const result = await retrieveFromBucket(
-        db,
-        article.compression_bucket_id,
-        article.compression_bucket_key,
-        cachedTarBuffer
-      );
+      const result = useCache
+        ? await getGlobalCache().getEntryAsync(db, article.compression_bucket_id, article.compression_bucket_key)
+        : await retrieveFromBucket(db, article.compression_bucket_id, article.compression_bucket_key);
       
       return result.content.toString('utf8');
     }
@@ -73,7 +67,7 @@ async function decompressArticleHtml(db, articleId, options = {}) {
         throw new Error(`Compression type not found: ${article.compression_type_id}`);
       }
       
-      const decompressed = decompress(article.compressed_html, compressionType.algorithm);
+      const decompressed = await decompressAsync(article.compressed_html, compressionType.algorithm);
       return decompressed.toString('utf8');
     }
     
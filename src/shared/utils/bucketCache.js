@@ -3,9 +3,27 @@
  * 
  * LRU cache for decompressed tar buckets to improve retrieval performance.
  * First access: ~150ms (decompress + extract), Cached: <1ms (memory lookup + extract)
+ *
+ * Seekable buckets (seekableBucket.js) are cached per frame instead, so a hot
+ * entry keeps only its own frame resident. Use getEntry() to read either kind;
+ * get() on a seekable bucket falls back to decompressing every frame and
+ * returns the same tar payload a legacy bucket would.
+ *
+ * The *Async methods decompress on the libuv threadpool so request handlers
+ * are not blocked. Concurrent misses for the same bucket/frame share one
+ * decompression, and prefetch() warms upcoming buckets during bulk reads.
  */
 
-const { decompress } = require('./CompressionFacade');
+const { decompress, decompressAsync } = require('./CompressionFacade');
+const {
+  hasFrameColumn,
+  readBucketLayout,
+  readFrame,
+  readFrameAsync,
+  sliceEntry,
+  splitFrames,
+  framesToTar
+} = require('./seekableBucket');
 
 /**
  * LRU Cache for compression buckets
@@ -18,15 +36,21 @@ class BucketCache {
    * @param {Object} options - Cache options
    * @param {number} [options.maxSize] - Maximum number of buckets to cache (default: 10)
    * @param {number} [options.maxMemoryMB] - Maximum memory usage in MB (default: 500)
+   * @param {number} [options.maxFrames] - Maximum number of seekable-bucket frames to cache (default: maxSize * 16)
    */
   constructor(options = {}) {
     this.maxSize = Math.max(1, options.maxSize || 10);  // Minimum 1
     this.maxMemoryMB = Math.max(1, options.maxMemoryMB || 500);  // Minimum 1MB
-    this.cache = new Map();  // bucketId -> { tarBuffer, compressedSize, decompressedSize, accessTime, accessCount }
+    this.maxFrames = Math.max(1, options.maxFrames || this.maxSize * 16);
+    this.cache = new Map();  // bucketId | 'bucketId:frame' -> { tarBuffer, frame, compressedSize, decompressedSize, accessTime, accessCount }
+    this.layouts = new Map();  // bucketId -> { index, frames, algorithm } (frames null for tar buckets)
+    this.inflight = new Map();  // cache key -> Promise of an async load in progress
     this.stats = {
       hits: 0,
       misses: 0,
       evictions: 0,
+      coalesced: 0,
+      prefetched: 0,
       totalDecompressTimeMs: 0
     };
   }
@@ -56,64 +80,306 @@ class BucketCache {
     // Cache miss - fetch and decompress
     this.stats.misses++;
     
-    const bucket = db.prepare(`
-      SELECT cb.bucket_blob, cb.compressed_size, ct.algorithm
-      FROM compression_buckets cb
-      JOIN compression_types ct ON cb.compression_type_id = ct.id
-      WHERE cb.id = ?
-    `).get(bucketId);
+    const bucket = this._readBucketBlob(db, bucketId);
     
-    if (!bucket) {
-      throw new Error(`Bucket not found: ${bucketId}`);
+    // Decompress (every frame, for a seekable bucket)
+    const startTime = Date.now();
+    const tarBuffer = bucket.layout
+      ? framesToTar(bucket.layout, splitFrames(bucket.bucket_blob, bucket.layout).map((frame) => decompress(frame, bucket.algorithm)))
+      : decompress(bucket.bucket_blob, bucket.algorithm);
+    const decompressTime = Date.now() - startTime;
+    
+    this._cacheTar(bucketId, tarBuffer, bucket.compressed_size, decompressTime);
+    
+    return {
+      tarBuffer,
+      fromCache: false,
+      decompressedSize: tarBuffer.length,
+      decompressTime
+    };
+  }
+  
+  /**
+   * Get one decompressed frame of a seekable bucket from cache or decompress and cache
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {number} bucketId - Bucket ID
+   * @param {number} frame - Frame number
+   * @returns {Object} { frameBuffer, fromCache, decompressedSize }
+   */
+  getFrame(db, bucketId, frame) {
+    const cacheKey = `${bucketId}:${frame}`;
+    if (this.cache.has(cacheKey)) {
+      const entry = this.cache.get(cacheKey);
+      entry.accessTime = Date.now();
+      entry.accessCount++;
+      this.stats.hits++;
+      
+      return {
+        frameBuffer: entry.tarBuffer,
+        fromCache: true,
+        decompressedSize: entry.decompressedSize
+      };
+    }
+    
+    this.stats.misses++;
+    
+    const layout = this._getLayout(db, bucketId);
+    if (!layout.frames) {
+      throw new Error(`Bucket ${bucketId} is not seekable`);
     }
     
-    // Decompress
     const startTime = Date.now();
-    const tarBuffer = decompress(bucket.bucket_blob, bucket.algorithm);
+    const frameBuffer = readFrame(db, bucketId, layout, frame);
     const decompressTime = Date.now() - startTime;
     this.stats.totalDecompressTimeMs += decompressTime;
     
-    const decompressedSize = tarBuffer.length;
-    
-    // Add to cache
-    this.cache.set(bucketId, {
-      tarBuffer,
-      compressedSize: bucket.compressed_size,
-      decompressedSize,
+    this.cache.set(cacheKey, {
+      bucketId,
+      frame,
+      tarBuffer: frameBuffer,
+      compressedSize: layout.frames[frame][1],
+      decompressedSize: frameBuffer.length,
       accessTime: Date.now(),
       accessCount: 1,
       decompressTime
     });
     
-    // Evict if needed
     this._evictIfNeeded();
     
     return {
-      tarBuffer,
+      frameBuffer,
       fromCache: false,
-      decompressedSize,
+      decompressedSize: frameBuffer.length,
       decompressTime
     };
   }
   
   /**
-   * Check if bucket is cached
+   * Read one entry from a bucket of either format, caching what had to be decompressed
+   * (the frame for seekable buckets, the whole tar otherwise)
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {number} bucketId - Bucket ID
+   * @param {string} entryKey - Entry key
+   * @returns {Promise<Object>} { content: Buffer, metadata: Object, fromCache }
+   */
+  async getEntry(db, bucketId, entryKey) {
+    const layout = this._getLayout(db, bucketId);
+    const entry = layout.index[entryKey];
+    if (!entry) {
+      throw new Error(`Entry not found in bucket: ${entryKey}`);
+    }
+    
+    if (layout.frames) {
+      const { frameBuffer, fromCache } = this.getFrame(db, bucketId, entry.frame);
+      return { content: Buffer.from(sliceEntry(frameBuffer, entry)), metadata: entry.metadata, fromCache };
+    }
+    
+    // Lazy require: compressionBuckets depends on seekableBucket as well
+    const { retrieveFromBucket } = require('./compressionBuckets');
+    const { tarBuffer, fromCache } = this.get(db, bucketId);
+    const { content, metadata } = await retrieveFromBucket(db, bucketId, entryKey, tarBuffer);
+    return { content, metadata, fromCache };
+  }
+  
+  /**
+   * Async get(): the tar is decompressed off the event loop
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {number} bucketId - Bucket ID
+   * @returns {Promise<Object>} { tarBuffer, fromCache, decompressedSize, coalesced }
+   */
+  getAsync(db, bucketId) {
+    if (this.cache.has(bucketId)) {
+      return Promise.resolve(this.get(db, bucketId));
+    }
+    
+    return this._coalesce(bucketId, async () => {
+      this.stats.misses++;
+      const bucket = this._readBucketBlob(db, bucketId);
+      
+      const startTime = Date.now();
+      const tarBuffer = bucket.layout
+        ? framesToTar(bucket.layout, await Promise.all(
+          splitFrames(bucket.bucket_blob, bucket.layout).map((frame) => decompressAsync(frame, bucket.algorithm))
+        ))
+        : await decompressAsync(bucket.bucket_blob, bucket.algorithm);
+      const decompressTime = Date.now() - startTime;
+      
+      this._cacheTar(bucketId, tarBuffer, bucket.compressed_size, decompressTime);
+      
+      return { tarBuffer, fromCache: false, decompressedSize: tarBuffer.length, decompressTime };
+    });
+  }
+  
+  /**
+   * Async getFrame(): the frame is decompressed off the event loop
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {number} bucketId - Bucket ID
+   * @param {number} frame - Frame number
+   * @returns {Promise<Object>} { frameBuffer, fromCache, decompressedSize, coalesced }
+   */
+  getFrameAsync(db, bucketId, frame) {
+    const cacheKey = `${bucketId}:${frame}`;
+    if (this.cache.has(cacheKey)) {
+      return Promise.resolve(this.getFrame(db, bucketId, frame));
+    }
+    
+    return this._coalesce(cacheKey, async () => {
+      const layout = this._getLayout(db, bucketId);
+      if (!layout.frames) {
+        throw new Error(`Bucket ${bucketId} is not seekable`);
+      }
+      
+      this.stats.misses++;
+      const startTime = Date.now();
+      const frameBuffer = await readFrameAsync(db, bucketId, layout, frame);
+      const decompressTime = Date.now() - startTime;
+      this.stats.totalDecompressTimeMs += decompressTime;
+      
+      this.cache.set(cacheKey, {
+        bucketId,
+        frame,
+        tarBuffer: frameBuffer,
+        compressedSize: layout.frames[frame][1],
+        decompressedSize: frameBuffer.length,
+        accessTime: Date.now(),
+        accessCount: 1,
+        decompressTime
+      });
+      this._evictIfNeeded();
+      
+      return { frameBuffer, fromCache: false, decompressedSize: frameBuffer.length, decompressTime };
+    });
+  }
+  
+  /**
+   * Async getEntry(): reads one entry from a bucket of either format without
+   * blocking the event loop
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {number} bucketId - Bucket ID
+   * @param {string} entryKey - Entry key
+   * @returns {Promise<Object>} { content: Buffer, metadata: Object, fromCache }
+   */
+  async getEntryAsync(db, bucketId, entryKey) {
+    const layout = this._getLayout(db, bucketId);
+    const entry = layout.index[entryKey];
+    if (!entry) {
+      throw new Error(`Entry not found in bucket: ${entryKey}`);
+    }
+    
+    if (layout.frames) {
+      const { frameBuffer, fromCache } = await this.getFrameAsync(db, bucketId, entry.frame);
+      return { content: Buffer.from(sliceEntry(frameBuffer, entry)), metadata: entry.metadata, fromCache };
+    }
+    
+    const { retrieveFromBucket } = require('./compressionBuckets');
+    const { tarBuffer, fromCache } = await this.getAsync(db, bucketId);
+    const { content, metadata } = await retrieveFromBucket(db, bucketId, entryKey, tarBuffer);
+    return { content, metadata, fromCache };
+  }
+  
+  /**
+   * Start loading buckets (or, for seekable buckets, the frames holding the
+   * given entries) without waiting for them. Already cached or loading units
+   * are skipped; load errors are left for the real read to report.
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {Array<number|{bucketId: number, entryKey: string}>} refs - Upcoming reads
+   * @returns {number} Loads started
+   */
+  prefetch(db, refs) {
+    let started = 0;
+    for (const ref of refs) {
+      const bucketId = typeof ref === 'object' && ref !== null ? ref.bucketId : ref;
+      const entryKey = typeof ref === 'object' && ref !== null ? ref.entryKey : null;
+      try {
+        const layout = this._getLayout(db, bucketId);
+        if (layout.frames) {
+          const frames = entryKey != null
+            ? [layout.index[entryKey] ? layout.index[entryKey].frame : null]
+            : layout.frames.map((_, frame) => frame);
+          for (const frame of frames) {
+            const key = `${bucketId}:${frame}`;
+            if (frame == null || this.cache.has(key) || this.inflight.has(key)) continue;
+            this.getFrameAsync(db, bucketId, frame).catch(() => {});
+            started++;
+          }
+        } else if (!this.cache.has(bucketId) && !this.inflight.has(bucketId)) {
+          this.getAsync(db, bucketId).catch(() => {});
+          started++;
+        }
+      } catch (_) {
+        // Unknown bucket: the real read reports it
+      }
+    }
+    this.stats.prefetched += started;
+    return started;
+  }
+  
+  /**
+   * Async prewarm(): loads buckets one after another off the event loop
+   * 
+   * @param {Database} db - better-sqlite3 database instance
+   * @param {Array<number>} bucketIds - Array of bucket IDs to prewarm
+   * @returns {Promise<Object>} { loaded: number, errors: Array }
+   */
+  async prewarmAsync(db, bucketIds) {
+    const errors = [];
+    let loaded = 0;
+    
+    for (const bucketId of bucketIds) {
+      try {
+        const { frames } = this._getLayout(db, bucketId);
+        if (frames) {
+          for (let frame = 0; frame < frames.length; frame++) {
+            await this.getFrameAsync(db, bucketId, frame);
+          }
+        } else {
+          await this.getAsync(db, bucketId);
+        }
+        loaded++;
+      } catch (error) {
+        errors.push({ bucketId, error: error.message });
+      }
+    }
+    
+    return { loaded, errors };
+  }
+  
+  /**
+   * Check if bucket (or any of its frames) is cached
    * 
    * @param {number} bucketId - Bucket ID
    * @returns {boolean}
    */
   has(bucketId) {
-    return this.cache.has(bucketId);
+    if (this.cache.has(bucketId)) return true;
+    for (const entry of this.cache.values()) {
+      if (entry.bucketId === bucketId) return true;
+    }
+    return false;
   }
   
   /**
-   * Remove bucket from cache
+   * Remove bucket (and any of its frames) from cache
    * 
    * @param {number} bucketId - Bucket ID
    * @returns {boolean} True if removed
    */
   evict(bucketId) {
-    return this.cache.delete(bucketId);
+    this.layouts.delete(bucketId);
+    let removed = this.cache.delete(bucketId);
+    for (const [key, entry] of this.cache.entries()) {
+      if (entry.bucketId === bucketId) {
+        this.cache.delete(key);
+        removed = true;
+      }
+    }
+    return removed;
   }
   
   /**
@@ -121,10 +387,14 @@ class BucketCache {
    */
   clear() {
     this.cache.clear();
+    this.layouts.clear();
+    this.inflight.clear();
     this.stats = {
       hits: 0,
       misses: 0,
       evictions: 0,
+      coalesced: 0,
+      prefetched: 0,
       totalDecompressTimeMs: 0
     };
   }
@@ -151,6 +421,9 @@ class BucketCache {
       hits: this.stats.hits,
       misses: this.stats.misses,
       evictions: this.stats.evictions,
+      coalesced: this.stats.coalesced,
+      prefetched: this.stats.prefetched,
+      inflight: this.inflight.size,
       hitRate: hitRate.toFixed(3),
       avgDecompressTimeMs: avgDecompressTime.toFixed(1),
       totalDecompressTimeMs: this.stats.totalDecompressTimeMs
@@ -165,7 +438,8 @@ class BucketCache {
   getEntries() {
     return Array.from(this.cache.entries())
       .map(([bucketId, entry]) => ({
-        bucketId,
+        bucketId: entry.bucketId ?? bucketId,
+        frame: entry.frame ?? null,
         decompressedSize: entry.decompressedSize,
         compressedSize: entry.compressedSize,
         compressionRatio: (entry.compressedSize / entry.decompressedSize).toFixed(3),
@@ -183,9 +457,19 @@ class BucketCache {
    * @private
    */
   _evictIfNeeded() {
-    // Check size limit
-    while (this.cache.size > this.maxSize) {
-      this._evictLRU();
+    // Check size limits (tar buckets and frames are counted separately)
+    let buckets = 0;
+    let frames = 0;
+    for (const entry of this.cache.values()) {
+      if (entry.frame == null) buckets++; else frames++;
+    }
+    while (buckets > this.maxSize) {
+      this._evictLRU((entry) => entry.frame == null);
+      buckets--;
+    }
+    while (frames > this.maxFrames) {
+      this._evictLRU((entry) => entry.frame != null);
+      frames--;
     }
     
     // Check memory limit
@@ -198,8 +482,9 @@ class BucketCache {
    * Evict least recently used entry
    * 
    * @private
+   * @param {Function} [filter] - Only consider entries matching this predicate
    */
-  _evictLRU() {
+  _evictLRU(filter = null) {
     if (this.cache.size === 0) return;
     
     // Find entry with oldest accessTime
@@ -207,6 +492,7 @@ class BucketCache {
     let oldestAccessTime = Infinity;
     
     for (const [bucketId, entry] of this.cache.entries()) {
+      if (filter && !filter(entry)) continue;
       if (entry.accessTime < oldestAccessTime) {
         oldestAccessTime = entry.accessTime;
         oldestBucketId = bucketId;
@@ -219,6 +505,93 @@ class BucketCache {
     }
   }
   
+  /**
+   * Share one in-flight load between concurrent callers of the same key
+   * 
+   * @private
+   */
+  _coalesce(key, load) {
+    const pending = this.inflight.get(key);
+    if (pending) {
+      this.stats.coalesced++;
+      return pending.then((result) => ({ ...result, fromCache: true, coalesced: true }));
+    }
+    const promise = load().finally(() => {
+      this.inflight.delete(key);
+    });
+    this.inflight.set(key, promise);
+    return promise;
+  }
+  
+  /**
+   * Whole bucket_blob plus, for a seekable bucket, its current layout. The
+   * frame index is read with the blob, so a layout cached before the bucket
+   * was converted from tar is replaced rather than trusted.
+   * 
+   * @private
+   */
+  _readBucketBlob(db, bucketId) {
+    const bucket = db.prepare(`
+      SELECT cb.bucket_blob, cb.compressed_size, ct.algorithm,
+             ${hasFrameColumn(db) ? 'cb.frame_index_json' : 'NULL'} AS frame_index_json
+      FROM compression_buckets cb
+      JOIN compression_types ct ON cb.compression_type_id = ct.id
+      WHERE cb.id = ?
+    `).get(bucketId);
+    
+    if (!bucket) {
+      throw new Error(`Bucket not found: ${bucketId}`);
+    }
+    
+    bucket.layout = null;
+    const cached = this.layouts.get(bucketId);
+    if (bucket.frame_index_json) {
+      bucket.layout = cached && cached.frames ? cached : readBucketLayout(db, bucketId);
+      this.layouts.set(bucketId, bucket.layout);
+    } else if (cached && cached.frames) {
+      this.layouts.delete(bucketId);
+    }
+    return bucket;
+  }
+  
+  /**
+   * @private
+   */
+  _cacheTar(bucketId, tarBuffer, compressedSize, decompressTime) {
+    this.stats.totalDecompressTimeMs += decompressTime;
+    this.cache.set(bucketId, {
+      bucketId,
+      frame: null,
+      tarBuffer,
+      compressedSize,
+      decompressedSize: tarBuffer.length,
+      accessTime: Date.now(),
+      accessCount: 1,
+      decompressTime
+    });
+    this._evictIfNeeded();
+  }
+  
+  /**
+   * Bucket index and frame table, cached separately from the buffers
+   * 
+   * @private
+   */
+  _getLayout(db, bucketId) {
+    let layout = this.layouts.get(bucketId);
+    if (!layout) {
+      layout = readBucketLayout(db, bucketId);
+      if (!layout) {
+        throw new Error(`Bucket not found: ${bucketId}`);
+      }
+      this.layouts.set(bucketId, layout);
+      if (this.layouts.size > this.maxSize * 4) {
+        this.layouts.delete(this.layouts.keys().next().value);
+      }
+    }
+    return layout;
+  }
+  
   /**
    * Calculate total memory usage of cached buffers
    * 
@@ -249,7 +622,12 @@ class BucketCache {
     
     for (const bucketId of bucketIds) {
       try {
-        this.get(db, bucketId);
+        const { frames } = this._getLayout(db, bucketId);
+        if (frames) {
+          frames.forEach((_, frame) => this.getFrame(db, bucketId, frame));
+        } else {
+          this.get(db, bucketId);
+        }
         loaded++;
       } catch (error) {
         errors.push({ bucketId, error: error.message });
@@ -278,6 +656,18 @@ function getGlobalCache(options) {
   return globalCache;
 }
 
+/**
+ * Drop a bucket from the global cache, if one exists. Called when a bucket's
+ * layout changes (tar to seekable conversion).
+ * 
+ * @param {number} bucketId - Bucket ID
+ */
+function evictFromGlobalCache(bucketId) {
+  if (globalCache) {
+    globalCache.evict(bucketId);
+  }
+}
+
 /**
  * Reset global cache instance
  */
@@ -291,5 +681,6 @@ function resetGlobalCache() {
 module.exports = {
   BucketCache,
   getGlobalCache,
+  evictFromGlobalCache,
   resetGlobalCache
 };
@@ -3,24 +3,41 @@
  * 
  * Provides compression and decompression using gzip and brotli at all quality levels.
  * Supports both individual file compression and bucket compression.
+ *
+ * 'deflate' (raw deflate) and native zstd accept a preset dictionary, which is
+ * how per-domain dictionaries (compressionDictionaries.js) are applied.
  */
 
 const zlib = require('zlib');
 const crypto = require('crypto');
+const { promisify } = require('util');
+const { getDictionaryBlob } = require('../../data/db/sqlite/queries/compressionDictionaries');
+
+// Node >= 24.6 / 22.19 ships zstd in zlib with dictionary support
+const NATIVE_ZSTD = typeof zlib.zstdCompressSync === 'function' && typeof zlib.zstdDecompressSync === 'function';
+
+// Callback forms run on the libuv threadpool instead of the calling thread
+const gunzipAsync = promisify(zlib.gunzip);
+const brotliDecompressAsync = promisify(zlib.brotliDecompress);
+const inflateRawAsync = promisify(zlib.inflateRaw);
+const zstdDecompressAsync = NATIVE_ZSTD && typeof zlib.zstdDecompress === 'function'
+  ? promisify(zlib.zstdDecompress)
+  : null;
 
 /**
  * Compress content using specified algorithm and level
  * 
  * @param {Buffer|string} content - Content to compress
  * @param {Object} options - Compression options
- * @param {string} options.algorithm - 'gzip' | 'brotli' | 'zstd' | 'none'
+ * @param {string} options.algorithm - 'gzip' | 'brotli' | 'deflate' | 'zstd' | 'none'
  * @param {number} options.level - Compression level
  * @param {number} [options.windowBits] - Brotli window size (10-24, default 22)
  * @param {number} [options.blockBits] - Brotli block size (16-24, default auto)
+ * @param {Buffer} [options.dictionary] - Preset dictionary (deflate, native zstd)
  * @returns {Object} { compressed: Buffer, uncompressedSize: number, compressedSize: number, ratio: number, sha256: string }
  */
 function compress(content, options = {}) {
-  const { algorithm = 'gzip', level = 6, windowBits, blockBits } = options;
+  const { algorithm = 'gzip', level = 6, windowBits, blockBits, dictionary } = options;
   
   // Handle empty content
   if (content == null || (typeof content === 'string' && content.length === 0) || 
@@ -85,7 +102,27 @@ function compress(content, options = {}) {
       });
       break;
       
+    case 'deflate':
+      compressedBuffer = zlib.deflateRawSync(uncompressedBuffer, {
+        level: Math.max(1, Math.min(9, level)),
+        ...(dictionary ? { dictionary } : {})
+      });
+      break;
+
     case 'zstd':
+      if (NATIVE_ZSTD) {
+        compressedBuffer = zlib.zstdCompressSync(uncompressedBuffer, {
+          params: {
+            [zlib.constants.ZSTD_c_compressionLevel]: Math.max(1, Math.min(22, level)),
+            [zlib.constants.ZSTD_c_pledgedSrcSize]: uncompressedSize
+          },
+          ...(dictionary ? { dictionary } : {})
+        });
+        break;
+      }
+      if (dictionary) {
+        throw new Error('Zstd dictionary compression requires a Node.js build with zlib zstd support');
+      }
       // Zstd requires external library (@mongodb-js/zstd or zstd-codec)
       // For now, fall back to brotli level 11 as alternative
       console.warn('Zstd compression requires @mongodb-js/zstd package. Falling back to brotli level 11.');
@@ -113,10 +150,13 @@ function compress(content, options = {}) {
  * Decompress content
  * 
  * @param {Buffer} compressedBuffer - Compressed content
- * @param {string} algorithm - 'gzip' | 'brotli' | 'zstd' | 'none'
+ * @param {string} algorithm - 'gzip' | 'brotli' | 'deflate' | 'zstd' | 'none'
+ * @param {Object} [options]
+ * @param {Buffer} [options.dictionary] - The dictionary the content was compressed with
  * @returns {Buffer} Decompressed content
  */
-function decompress(compressedBuffer, algorithm = 'gzip') {
+function decompress(compressedBuffer, algorithm = 'gzip', options = {}) {
+  const dictionary = options && options.dictionary ? options.dictionary : null;
   if (!Buffer.isBuffer(compressedBuffer)) {
     throw new Error('Compressed content must be a Buffer');
   }
@@ -130,8 +170,14 @@ function decompress(compressedBuffer, algorithm = 'gzip') {
       
     case 'brotli':
       return zlib.brotliDecompressSync(compressedBuffer);
+
+    case 'deflate':
+      return zlib.inflateRawSync(compressedBuffer, dictionary ? { dictionary } : {});
       
     case 'zstd':
+      if (NATIVE_ZSTD) {
+        return zlib.zstdDecompressSync(compressedBuffer, dictionary ? { dictionary } : {});
+      }
       console.warn('Zstd decompression requires @mongodb-js/zstd package. Cannot decompress.');
       throw new Error('Zstd decompression not available');
       
@@ -140,6 +186,48 @@ function decompress(compressedBuffer, algorithm = 'gzip') {
   }
 }
 
+/**
+ * Decompress content off the calling thread (libuv threadpool)
+ * 
+ * Same contract as decompress(); use it on request paths so a large body
+ * or bucket does not block the event loop.
+ * 
+ * @param {Buffer} compressedBuffer - Compressed data
+ * @param {string} algorithm - 'gzip' | 'brotli' | 'deflate' | 'zstd' | 'none'
+ * @param {Object} [options]
+ * @param {Buffer} [options.dictionary] - Preset dictionary the content was compressed with
+ * @returns {Promise<Buffer>} Decompressed content
+ */
+async function decompressAsync(compressedBuffer, algorithm = 'gzip', options = {}) {
+  const dictionary = options && options.dictionary ? options.dictionary : null;
+  if (!Buffer.isBuffer(compressedBuffer)) {
+    throw new Error('Compressed content must be a Buffer');
+  }
+
+  switch (algorithm) {
+    case 'none':
+      return compressedBuffer;
+
+    case 'gzip':
+      return gunzipAsync(compressedBuffer);
+
+    case 'brotli':
+      return brotliDecompressAsync(compressedBuffer);
+
+    case 'deflate':
+      return inflateRawAsync(compressedBuffer, dictionary ? { dictionary } : {});
+
+    case 'zstd':
+      if (zstdDecompressAsync) {
+        return zstdDecompressAsync(compressedBuffer, dictionary ? { dictionary } : {});
+      }
+      throw new Error('Zstd decompression not available');
+
+    default:
+      throw new Error(`Unknown compression algorithm: ${algorithm}`);
+  }
+}
+
 /**
  * Get compression type from database by name
  * 
@@ -242,7 +330,8 @@ function compressAndStore(db, content, options = {}) {
     algorithm: type.algorithm,
     level: type.level,
     windowBits: type.window_bits,
-    blockBits: type.block_bits
+    blockBits: type.block_bits,
+    dictionary: type.dictionary_blob || undefined
   });
   
   // Store in content_storage
@@ -290,7 +379,31 @@ function compressAndStore(db, content, options = {}) {
  */
 function retrieveAndDecompress(db, contentId) {
   const content = db.prepare(`
-    SELECT cs.content_blob, ct.algorithm
+    SELECT cs.content_blob, ct.algorithm, ct.id AS compression_type_id
+    FROM content_storage cs
+    JOIN compression_types ct ON cs.compression_type_id = ct.id
+    WHERE cs.id = ?
+  `).get(contentId);
+  
+  if (!content) {
+    throw new Error(`Content not found: ${contentId}`);
+  }
+  
+  return decompress(content.content_blob, content.algorithm, {
+    dictionary: getTypeDictionary(db, content.compression_type_id, content.algorithm)
+  });
+}
+
+/**
+ * Retrieve content from database and decompress it off the calling thread
+ * 
+ * @param {Database} db - better-sqlite3 database instance
+ * @param {number} contentId - Content storage ID
+ * @returns {Promise<Buffer>} Decompressed content
+ */
+async function retrieveAndDecompressAsync(db, contentId) {
+  const content = db.prepare(`
+    SELECT cs.content_blob, ct.algorithm, ct.id AS compression_type_id
     FROM content_storage cs
     JOIN compression_types ct ON cs.compression_type_id = ct.id
     WHERE cs.id = ?
@@ -300,14 +413,53 @@ function retrieveAndDecompress(db, contentId) {
     throw new Error(`Content not found: ${contentId}`);
   }
   
-  return decompress(content.content_blob, content.algorithm);
+  return decompressAsync(content.content_blob, content.algorithm, {
+    dictionary: getTypeDictionary(db, content.compression_type_id, content.algorithm)
+  });
+}
+
+const TYPE_DICTIONARIES = new WeakMap(); // db -> Map(compression_type_id -> Buffer|null)
+
+/**
+ * Dictionary stored on a compression_types row (null for ordinary types).
+ * Dictionaries never change once written (retraining adds a new type), so
+ * they are cached per connection.
+ *
+ * @param {Database} db - better-sqlite3 database instance
+ * @param {number} typeId - compression_types.id
+ * @param {string} [algorithm] - Skips the lookup for algorithms without dictionaries
+ * @returns {Buffer|null}
+ */
+function getTypeDictionary(db, typeId, algorithm = null) {
+  if (typeId == null || (algorithm && algorithm !== 'deflate' && algorithm !== 'zstd')) {
+    return null;
+  }
+  let cache = TYPE_DICTIONARIES.get(db);
+  if (!cache) {
+    cache = new Map();
+    TYPE_DICTIONARIES.set(db, cache);
+  }
+  if (!cache.has(typeId)) {
+    let dictionary = null;
+    try {
+      dictionary = getDictionaryBlob(db, typeId);
+    } catch (_) {
+      // Dictionary migration not applied: no dictionaries have been trained on this DB
+    }
+    cache.set(typeId, dictionary);
+  }
+  return cache.get(typeId);
 }
 
 module.exports = {
   compress,
   decompress,
+  decompressAsync,
   getCompressionType,
   selectCompressionType,
   compressAndStore,
-  retrieveAndDecompress
+  retrieveAndDecompress,
+  retrieveAndDecompressAsync,
+  getTypeDictionary,
+  NATIVE_ZSTD
 };
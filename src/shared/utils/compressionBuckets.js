@@ -3,6 +3,8 @@
  * 
  * Manages compression buckets that store multiple similar files in a single compressed archive.
  * Uses tar format for packaging and applies compression algorithms (gzip/brotli) to the entire archive.
+ * Seekable buckets (seekableBucket.js) instead compress entries in independent frames so a read only
+ * decompresses the frame holding its entry; migrateBucketsToSeekable converts legacy tar buckets to that layout.
  * 
  * Uses CompressionFacade for all compression operations, ensuring consistent algorithm
  * validation, preset definitions, and stats calculation across bucket operations.
@@ -18,6 +20,15 @@ const {
   createStatsObject,
   PRESETS
 } = require('./CompressionFacade');
+const {
+  assertSeekableBucketSchema,
+  buildFrames,
+  frameIndexJson,
+  readTarEntries,
+  readBucketLayout,
+  readFrame,
+  sliceEntry
+} = require('./seekableBucket');
 
 /**
  * Create a compression bucket from multiple items
@@ -31,12 +42,14 @@ const {
  * @param {string} options.items[].key - Unique key for this item (e.g., SHA256 or article ID)
  * @param {Buffer|string} options.items[].content - Content to store
  * @param {Object} [options.items[].metadata] - Optional metadata (stored in index)
- * @returns {Object} { bucketId, compressionType, algorithm, itemCount, uncompressedSize, compressedSize, ratio, tarArchiveSize }
+ * @param {string} [options.format='tar'] - 'tar' (one compressed archive) or 'seekable' (independent frames)
+ * @param {number} [options.frameBytes] - Target uncompressed frame size for seekable buckets
+ * @returns {Object} { bucketId, compressionType, algorithm, itemCount, uncompressedSize, compressedSize, ratio, tarArchiveSize, format, frameCount }
  */
 function createBucket(db, options) {
   return new Promise((resolve, reject) => {
     try {
-      const { bucketType, domainPattern, compressionType = PRESETS.BROTLI_11, items } = options;
+      const { bucketType, domainPattern, compressionType = PRESETS.BROTLI_11, items, format = 'tar' } = options;
 
       if (!items || items.length === 0) {
         return reject(new Error('Cannot create empty bucket'));
@@ -52,6 +65,13 @@ function createBucket(db, options) {
         return reject(new Error(`Compression type not found: ${presetName}`));
       }
 
+      if (format === 'seekable') {
+        return resolve(createSeekableBucket(db, { bucketType, domainPattern, presetName, type, items, frameBytes: options.frameBytes }));
+      }
+      if (format !== 'tar') {
+        return reject(new Error(`Unknown bucket format: ${format}`));
+      }
+
       const pack = tar.pack();
       const chunks = [];
 
@@ -104,12 +124,7 @@ function createBucket(db, options) {
       pack.on('end', () => {
         try {
           const tarBuffer = Buffer.concat(chunks);
-          const presetConfig = getCompressionConfigPreset(presetName);
-          const result = compress(tarBuffer, {
-            preset: presetName,
-            windowBits: type.window_bits ?? presetConfig?.windowBits ?? undefined,
-            blockBits: type.block_bits ?? presetConfig?.blockBits ?? undefined
-          });
+          const result = compress(tarBuffer, bucketCompressOptions(type, presetName));
 
           const stats = createStatsObject({
             ...result,
@@ -150,7 +165,9 @@ function createBucket(db, options) {
             uncompressedSize: stats.uncompressedSize,
             compressedSize: stats.compressedSize,
             ratio: stats.ratio,
-            tarArchiveSize: result.uncompressedSize
+            tarArchiveSize: result.uncompressedSize,
+            format: 'tar',
+            frameCount: null
           });
         } catch (error) {
           reject(error);
@@ -170,6 +187,86 @@ function createBucket(db, options) {
   });
 }
 
+function bucketCompressOptions(type, presetName) {
+  const presetConfig = getCompressionConfigPreset(presetName);
+  return {
+    preset: presetName,
+    windowBits: type.window_bits ?? presetConfig?.windowBits ?? undefined,
+    blockBits: type.block_bits ?? presetConfig?.blockBits ?? undefined
+  };
+}
+
+function createSeekableBucket(db, { bucketType, domainPattern, presetName, type, items, frameBytes }) {
+  const index = {};
+  const entries = [];
+  let aggregatedContentSize = 0;
+
+  for (const { key, content, metadata } of items) {
+    if (!key) {
+      throw new Error('Each item must have a key');
+    }
+    if (index[key]) {
+      throw new Error(`Duplicate key found: ${key}`);
+    }
+    const buffer = Buffer.isBuffer(content) ? content : Buffer.from(content, 'utf8');
+    aggregatedContentSize += buffer.length;
+    index[key] = { filename: sanitizeFilename(key), size: buffer.length, offset: null, metadata: metadata || null };
+    entries.push({ key, buffer });
+  }
+
+  const { blob, frames, placements } = buildFrames(entries, bucketCompressOptions(type, presetName), { frameBytes });
+  for (const [key, placement] of placements) {
+    Object.assign(index[key], placement);
+  }
+
+  const stats = createStatsObject({
+    compressed: blob,
+    preset: presetName,
+    uncompressedSize: aggregatedContentSize
+  });
+
+  assertSeekableBucketSchema(db);
+  const insertResult = db.prepare(`
+    INSERT INTO compression_buckets (
+      bucket_type,
+      domain_pattern,
+      compression_type_id,
+      bucket_blob,
+      content_count,
+      uncompressed_size,
+      compressed_size,
+      compression_ratio,
+      index_json,
+      frame_index_json
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    RETURNING id
+  `).get(
+    bucketType,
+    domainPattern || null,
+    type.id,
+    blob,
+    items.length,
+    stats.uncompressedSize,
+    stats.compressedSize,
+    stats.ratio,
+    JSON.stringify(index),
+    frameIndexJson(frames)
+  );
+
+  return {
+    bucketId: insertResult.id,
+    compressionType: presetName,
+    algorithm: type.algorithm,
+    itemCount: items.length,
+    uncompressedSize: stats.uncompressedSize,
+    compressedSize: stats.compressedSize,
+    ratio: stats.ratio,
+    tarArchiveSize: null,
+    format: 'seekable',
+    frameCount: frames.length
+  };
+}
+
 
 /**
  * Retrieve an item from a compression bucket
@@ -177,38 +274,37 @@ function createBucket(db, options) {
  * @param {Database} db - better-sqlite3 database instance
  * @param {number} bucketId - Bucket ID
  * @param {string} entryKey - Entry key to retrieve
- * @param {Buffer} [cachedTarBuffer] - Optional cached decompressed tar buffer (for performance)
+ * @param {Buffer} [cachedTarBuffer] - Optional cached decompressed tar buffer (for performance; ignored for seekable buckets)
  * @returns {Object} { content: Buffer, metadata: Object }
  */
 async function retrieveFromBucket(db, bucketId, entryKey, cachedTarBuffer = null) {
-  // Fetch bucket metadata
-  const bucket = db.prepare(`
-    SELECT cb.bucket_blob, cb.index_json, ct.algorithm
-    FROM compression_buckets cb
-    JOIN compression_types ct ON cb.compression_type_id = ct.id
-    WHERE cb.id = ?
-  `).get(bucketId);
+  // Fetch bucket metadata (without the blob)
+  const layout = readBucketLayout(db, bucketId);
   
-  if (!bucket) {
+  if (!layout) {
     throw new Error(`Bucket not found: ${bucketId}`);
   }
   
-  // Parse index (with error handling)
-  let index;
-  try {
-    index = JSON.parse(bucket.index_json);
-  } catch (error) {
-    throw new Error(`Corrupted bucket index for bucket ${bucketId}: ${error.message}`);
-  }
-  
-  const entry = index[entryKey];
+  const entry = layout.index[entryKey];
   
   if (!entry) {
     throw new Error(`Entry not found in bucket: ${entryKey}`);
   }
   
+  // Seekable bucket: decompress only the frame holding this entry
+  if (layout.frames) {
+    const frameBuffer = readFrame(db, bucketId, layout, entry.frame);
+    return {
+      content: Buffer.from(sliceEntry(frameBuffer, entry)),
+      metadata: entry.metadata
+    };
+  }
+  
   // Decompress tar (use cached buffer if available)
-  const tarBuffer = cachedTarBuffer || decompress(bucket.bucket_blob, bucket.algorithm);
+  const tarBuffer = cachedTarBuffer || decompress(
+    db.prepare('SELECT bucket_blob FROM compression_buckets WHERE id = ?').get(bucketId).bucket_blob,
+    layout.algorithm
+  );
   
   // Extract specific file from tar
   return new Promise((resolve, reject) => {
@@ -344,19 +440,137 @@ function getBucketStats(db, bucketId) {
 /**
  * Finalize a compression bucket (mark as immutable)
  * 
+ * The bucket keeps its format unless `seekable` is set, in which case a
+ * legacy tar bucket is rewritten as a seekable bucket on the way.
+ * 
  * @param {Database} db - better-sqlite3 database instance
  * @param {number} bucketId - Bucket ID
+ * @param {Object} [options]
+ * @param {boolean} [options.seekable=false] - Convert a legacy tar bucket to the seekable layout
+ * @param {boolean} [options.migrate=false] - Allow converting a bucket that is already finalized
+ * @param {number} [options.frameBytes] - Target uncompressed frame size
+ * @returns {Object} { bucketId, converted, frameCount }
  */
-function finalizeBucket(db, bucketId) {
-  const result = db.prepare(`
-    UPDATE compression_buckets
-    SET finalized_at = CURRENT_TIMESTAMP
-    WHERE id = ? AND finalized_at IS NULL
-  `).run(bucketId);
+function finalizeBucket(db, bucketId, options = {}) {
+  const { seekable = false, migrate = false, frameBytes } = options;
+  const bucket = db.prepare('SELECT finalized_at FROM compression_buckets WHERE id = ?').get(bucketId);
   
-  if (result.changes === 0) {
+  if (!bucket || (bucket.finalized_at != null && !migrate)) {
     throw new Error(`Bucket not found or already finalized: ${bucketId}`);
   }
+  
+  const finalize = db.transaction(() => {
+    let conversion = null;
+    if (seekable) {
+      conversion = convertToSeekable(db, bucketId, { frameBytes });
+    }
+    db.prepare(`
+      UPDATE compression_buckets
+      SET finalized_at = COALESCE(finalized_at, CURRENT_TIMESTAMP)
+      WHERE id = ?
+    `).run(bucketId);
+    return {
+      bucketId,
+      converted: Boolean(conversion && conversion.converted),
+      frameCount: conversion ? conversion.frameCount : null
+    };
+  });
+  
+  return finalize();
+}
+
+/**
+ * Rewrite a legacy tar bucket as a seekable bucket in place.
+ * Keys, filenames, sizes and metadata are kept; frame/offset are added to each index entry.
+ * 
+ * @private
+ * @returns {Object} { converted, frameCount }
+ */
+function convertToSeekable(db, bucketId, { frameBytes } = {}) {
+  const layout = readBucketLayout(db, bucketId);
+  if (layout.frames) {
+    return { converted: false, frameCount: layout.frames.length };
+  }
+  
+  const row = db.prepare(`
+    SELECT cb.bucket_blob, ct.name AS type_name
+    FROM compression_buckets cb
+    JOIN compression_types ct ON cb.compression_type_id = ct.id
+    WHERE cb.id = ?
+  `).get(bucketId);
+  const byFilename = new Map(
+    readTarEntries(decompress(row.bucket_blob, layout.algorithm)).map((file) => [file.name, file.content])
+  );
+  
+  const entries = Object.entries(layout.index).map(([key, entry]) => {
+    const buffer = byFilename.get(entry.filename);
+    if (!buffer) {
+      throw new Error(`Entry file not found in tar: ${entry.filename}`);
+    }
+    return { key, buffer };
+  });
+  
+  const presetName = resolvePresetName(row.type_name);
+  const type = presetName ? getCompressionType(db, presetName) : null;
+  const compressOptions = type
+    ? bucketCompressOptions(type, presetName)
+    : { algorithm: layout.algorithm };
+  const { blob, frames, placements } = buildFrames(entries, compressOptions, { frameBytes });
+  for (const [key, placement] of placements) {
+    Object.assign(layout.index[key], placement);
+  }
+  
+  const uncompressedSize = entries.reduce((total, entry) => total + entry.buffer.length, 0);
+  const stats = createStatsObject({ compressed: blob, uncompressedSize });
+  
+  assertSeekableBucketSchema(db);
+  db.prepare(`
+    UPDATE compression_buckets
+    SET bucket_blob = ?, compressed_size = ?, compression_ratio = ?, index_json = ?, frame_index_json = ?
+    WHERE id = ?
+  `).run(blob, stats.compressedSize, stats.ratio, JSON.stringify(layout.index), frameIndexJson(frames), bucketId);
+  
+  // The shared cache may hold this bucket's tar layout
+  require('./bucketCache').evictFromGlobalCache(bucketId);
+  
+  return { converted: true, frameCount: frames.length };
+}
+
+/**
+ * Convert finalized legacy tar buckets to the seekable layout
+ * 
+ * @param {Database} db - better-sqlite3 database instance
+ * @param {Object} [options]
+ * @param {number} [options.limit] - Maximum buckets to convert in this call
+ * @param {number} [options.frameBytes] - Target uncompressed frame size
+ * @returns {Object} { converted, failed: Array<{bucketId, error}> }
+ */
+function migrateBucketsToSeekable(db, options = {}) {
+  const { limit, frameBytes } = options;
+  assertSeekableBucketSchema(db);
+  
+  let sql = `
+    SELECT id FROM compression_buckets
+    WHERE finalized_at IS NOT NULL AND frame_index_json IS NULL
+    ORDER BY id
+  `;
+  const params = [];
+  if (limit) {
+    sql += ' LIMIT ?';
+    params.push(limit);
+  }
+  
+  let converted = 0;
+  const failed = [];
+  for (const { id } of db.prepare(sql).all(...params)) {
+    try {
+      if (finalizeBucket(db, id, { seekable: true, migrate: true, frameBytes }).converted) converted++;
+    } catch (error) {
+      failed.push({ bucketId: id, error: error.message });
+    }
+  }
+  
+  return { converted, failed };
 }
 
 /**
@@ -461,6 +675,7 @@ module.exports = {
   listBucketEntries,
   getBucketStats,
   finalizeBucket,
+  migrateBucketsToSeekable,
   deleteBucket,
   queryBuckets
 };
@@ -0,0 +1,278 @@
+/**
+ * Per-domain compression dictionaries
+ *
+ * Pages from one site share most of their markup (head, navigation, footer,
+ * script tags). Compressing each page alone pays for that boilerplate every
+ * time. Buckets avoid it by compressing many pages together, but then reading
+ * one article means decompressing the whole bucket. A dictionary trained on
+ * sample pages gives single pages most of the bucket ratio while each one
+ * still decompresses by itself.
+ *
+ * Dictionaries are stored on their own compression_types row
+ * (`<algorithm>_dict_<domain>_<n>`, dictionary_blob column; the columns come
+ * from the add_compression_dictionary_columns migration). Content rows
+ * reference that type as usual, and compression.retrieveAndDecompress picks
+ * the dictionary up from it. Retraining adds a new row, so the bytes of an
+ * existing type never change.
+ *
+ * zstd is used when this Node build exposes zstd with dictionaries. Otherwise
+ * the codec is raw deflate with a preset dictionary (32KB window).
+ */
+
+const {
+  compress,
+  decompress,
+  getTypeDictionary
+} = require('./CompressionFacade');
+const { NATIVE_ZSTD } = require('./compression');
+const {
+  missingDictionaryColumns,
+  getLatestDictionaryGeneration,
+  insertDictionaryType,
+  getLatestDomainDictionaryType,
+  listDomainContentSamples
+} = require('../../data/db/sqlite/queries/compressionDictionaries');
+
+const DEFLATE_DICTIONARY_BYTES = 32 * 1024; // deflate can only reach back 32KB
+const ZSTD_DICTIONARY_BYTES = 110 * 1024; // zstd --train default
+
+function dictionaryAlgorithm() {
+  return NATIVE_ZSTD ? 'zstd' : 'deflate';
+}
+
+function defaultDictionaryLevel(algorithm) {
+  return algorithm === 'zstd' ? 19 : 9;
+}
+
+/**
+ * Build a dictionary from sample documents.
+ *
+ * A simplified COVER selection, as used by `zstd --train`:
+ * 1. Count how many samples contain each d-byte gram.
+ * 2. Split the samples into one epoch per segment to be chosen.
+ * 3. In each epoch, take the k-byte segment whose grams are shared by the
+ *    most other samples.
+ * 4. Zero the counts of the grams just taken, so later segments add new
+ *    content rather than repeat it.
+ *
+ * The best segments go last, next to the data, where references are cheapest.
+ *
+ * @param {Array<Buffer|string>} samples
+ * @param {Object} [options]
+ * @param {number} [options.maxBytes] - Dictionary size (default depends on the codec)
+ * @param {number} [options.segmentBytes=64] - k
+ * @param {number} [options.gramBytes=8] - d
+ * @param {number} [options.maxSampleBytes=262144] - Longer samples are truncated
+ * @returns {Buffer}
+ */
+function trainDictionary(samples, options = {}) {
+  const gramBytes = Math.max(4, options.gramBytes || 8);
+  const segmentBytes = Math.max(gramBytes * 2, options.segmentBytes || 64);
+  const maxBytes = Math.max(segmentBytes, options.maxBytes
+    || (dictionaryAlgorithm() === 'zstd' ? ZSTD_DICTIONARY_BYTES : DEFLATE_DICTIONARY_BYTES));
+  const maxSampleBytes = options.maxSampleBytes || 256 * 1024;
+
+  const buffers = (samples || [])
+    .map((sample) => (Buffer.isBuffer(sample) ? sample : Buffer.from(String(sample || ''), 'utf8')))
+    .map((buffer) => (buffer.length > maxSampleBytes ? buffer.subarray(0, maxSampleBytes) : buffer))
+    .filter((buffer) => buffer.length >= segmentBytes);
+  if (buffers.length === 0) {
+    throw new Error('trainDictionary requires samples of at least segmentBytes each');
+  }
+
+  const tableBits = 20;
+  const tableMask = (1 << tableBits) - 1;
+  const counts = new Uint32Array(1 << tableBits);
+  const lastSeen = new Int32Array(1 << tableBits).fill(-1);
+  const gramHash = (buffer, at) => {
+    let h = 0x811c9dc5;
+    for (let i = 0; i < gramBytes; i++) {
+      h = Math.imul(h ^ buffer[at + i], 0x01000193);
+    }
+    return (h >>> (32 - tableBits)) & tableMask;
+  };
+
+  // Document frequency: a gram counts once per sample it appears in
+  const hashes = buffers.map((buffer, sampleIndex) => {
+    const grams = new Uint32Array(buffer.length - gramBytes + 1);
+    for (let at = 0; at < grams.length; at++) {
+      const h = gramHash(buffer, at);
+      grams[at] = h;
+      if (lastSeen[h] !== sampleIndex) {
+        lastSeen[h] = sampleIndex;
+        counts[h] += 1;
+      }
+    }
+    return grams;
+  });
+
+  // Grams only one sample has do not help the others
+  const score = (h) => (counts[h] > 1 ? counts[h] - 1 : 0);
+  const totalBytes = buffers.reduce((sum, buffer) => sum + buffer.length, 0);
+  const segmentCount = Math.ceil(maxBytes / segmentBytes);
+  const epochBytes = Math.max(segmentBytes, Math.floor(totalBytes / segmentCount));
+  const gramsPerSegment = segmentBytes - gramBytes + 1;
+
+  const chosen = [];
+  let usedBytes = 0;
+  for (let pass = 0; pass < 2 && usedBytes < maxBytes; pass++) {
+    for (let s = 0; s < buffers.length && usedBytes < maxBytes; s++) {
+      const buffer = buffers[s];
+      const grams = hashes[s];
+      for (let offset = 0; offset + segmentBytes <= buffer.length && usedBytes < maxBytes; offset += epochBytes) {
+        const end = Math.min(buffer.length, offset + epochBytes + segmentBytes - 1);
+        let best = -1;
+        let bestScore = 0;
+        let windowScore = 0;
+        for (let at = offset; at + gramBytes <= end; at++) {
+          windowScore += score(grams[at]);
+          const first = at - gramsPerSegment + 1;
+          if (first > offset) windowScore -= score(grams[first - 1]);
+          if (first >= offset && windowScore > bestScore) {
+            bestScore = windowScore;
+            best = first;
+          }
+        }
+        if (best < 0) continue;
+        for (let at = best; at < best + gramsPerSegment; at++) counts[grams[at]] = 0;
+        chosen.push({ score: bestScore, bytes: buffer.subarray(best, best + segmentBytes) });
+        usedBytes += segmentBytes;
+      }
+    }
+  }
+
+  chosen.sort((a, b) => a.score - b.score);
+  const dictionary = Buffer.concat(chosen.map((segment) => segment.bytes));
+  return dictionary.length > maxBytes ? dictionary.subarray(dictionary.length - maxBytes) : dictionary;
+}
+
+function dictionaryTypePrefix(domain, algorithm = dictionaryAlgorithm()) {
+  const slug = String(domain || '').toLowerCase().replace(/[^a-z0-9]+/g, '_').replace(/^_+|_+$/g, '');
+  if (!slug) {
+    throw new Error('Compression dictionaries require a domain');
+  }
+  return `${algorithm}_dict_${slug}`;
+}
+
+/**
+ * Store a dictionary as a new compression_types row.
+ *
+ * @param {Database} db
+ * @param {string} domain
+ * @param {Buffer} dictionary
+ * @param {Object} [options]
+ * @param {string} [options.algorithm]
+ * @param {number} [options.level]
+ * @param {number} [options.sampleCount]
+ * @returns {Object} The compression_types row
+ */
+function saveDomainDictionary(db, domain, dictionary, options = {}) {
+  if (!Buffer.isBuffer(dictionary) || dictionary.length === 0) {
+    throw new Error('saveDomainDictionary requires a non-empty dictionary Buffer');
+  }
+  const missing = missingDictionaryColumns(db);
+  if (missing.length > 0) {
+    throw new Error(`compression_types is missing ${missing.map(([name]) => name).join(', ')}; run node tools/migrations/project-migrations.js`);
+  }
+  const algorithm = options.algorithm || dictionaryAlgorithm();
+  const level = options.level ?? defaultDictionaryLevel(algorithm);
+  const prefix = dictionaryTypePrefix(domain, algorithm);
+  const name = `${prefix}_${getLatestDictionaryGeneration(db, prefix) + 1}`;
+
+  return insertDictionaryType(db, {
+    name,
+    algorithm,
+    level,
+    description: `${algorithm} level ${level} with a ${Math.round(dictionary.length / 1024)}KB dictionary for ${domain}`,
+    dictionary,
+    domain: String(domain).toLowerCase(),
+    sampleCount: options.sampleCount,
+    trainedAt: new Date().toISOString()
+  });
+}
+
+/**
+ * Newest dictionary type for a domain, or null.
+ * @returns {Object|null} compression_types row (with dictionary_blob)
+ */
+function getDomainDictionaryType(db, domain) {
+  if (missingDictionaryColumns(db).length > 0) {
+    return null; // migration not applied, so no dictionaries were trained
+  }
+  return getLatestDomainDictionaryType(db, String(domain).toLowerCase());
+}
+
+/**
+ * Most recent stored pages for a host, decompressed.
+ *
+ * @param {Database} db
+ * @param {string} domain - urls.host
+ * @param {Object} [options]
+ * @param {number} [options.limit=200]
+ * @returns {Array<{contentId: number, content: Buffer}>}
+ */
+function sampleDomainContent(db, domain, options = {}) {
+  const limit = Math.max(1, options.limit || 200);
+  const rows = listDomainContentSamples(db, String(domain).toLowerCase(), limit);
+
+  const samples = [];
+  for (const row of rows) {
+    try {
+      const algorithm = row.algorithm || 'none';
+      const content = decompress(Buffer.from(row.content_blob), algorithm, {
+        dictionary: getTypeDictionary(db, row.compression_type_id, algorithm)
+      });
+      samples.push({ contentId: row.id, content });
+    } catch (_) {
+      // unreadable rows are not useful training data
+    }
+  }
+  return samples;
+}
+
+/**
+ * Sample a domain's stored pages, train a dictionary and save it as a type.
+ *
+ * @param {Database} db
+ * @param {string} domain
+ * @param {Object} [options] - sampleLimit plus trainDictionary / saveDomainDictionary options
+ * @returns {{type: Object, dictionary: Buffer, sampleCount: number}}
+ */
+function trainDomainDictionary(db, domain, options = {}) {
+  const samples = options.samples || sampleDomainContent(db, domain, { limit: options.sampleLimit || 200 }).map((s) => s.content);
+  if (samples.length < 2) {
+    throw new Error(`Not enough stored pages to train a dictionary for ${domain}`);
+  }
+  const dictionary = trainDictionary(samples, options);
+  const type = saveDomainDictionary(db, domain, dictionary, { ...options, sampleCount: samples.length });
+  return { type, dictionary, sampleCount: samples.length };
+}
+
+/**
+ * Compress one page with a dictionary type row.
+ * @returns {Object} compress() result plus compressionTypeId
+ */
+function compressWithDictionary(content, type) {
+  if (!type || !type.dictionary_blob) {
+    throw new Error('compressWithDictionary requires a dictionary compression type');
+  }
+  const result = compress(content, {
+    algorithm: type.algorithm,
+    level: type.level,
+    dictionary: Buffer.from(type.dictionary_blob)
+  });
+  return { ...result, compressionTypeId: type.id, compressionType: type.name };
+}
+
+module.exports = {
+  trainDictionary,
+  saveDomainDictionary,
+  getDomainDictionaryType,
+  sampleDomainContent,
+  trainDomainDictionary,
+  compressWithDictionary,
+  dictionaryAlgorithm,
+  dictionaryTypePrefix,
+  DEFLATE_DICTIONARY_BYTES,
+  ZSTD_DICTIONARY_BYTES
+};
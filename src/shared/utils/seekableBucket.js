@@ -0,0 +1,311 @@
+/**
+ * Seekable Bucket Format
+ *
+ * The legacy bucket_blob is one compressed tar, so reading any entry means
+ * decompressing the whole bucket. A seekable bucket_blob is a run of frames.
+ * Each frame is a few hundred KB of entries, compressed on its own. Reading
+ * an entry then costs one frame. SQLite can return just that frame's bytes
+ * with substr(bucket_blob, ...).
+ *
+ * Layout:
+ *   compression_buckets.bucket_blob       frame 0 | frame 1 | ... (no header)
+ *   compression_buckets.frame_index_json  { version, frames: [[offset, length, size], ...] }
+ *                                         (compressed byte offset/length, uncompressed size)
+ *   compression_buckets.index_json        key -> { filename, size, metadata, frame, offset }
+ *                                         (offset = byte offset inside the decompressed frame)
+ *
+ * Buckets with a NULL frame_index_json are legacy tars. migrateBucketsToSeekable
+ * (or finalizeBucket with { seekable: true }) turns them into seekable buckets.
+ */
+
+const { compress, decompress, decompressAsync } = require('./CompressionFacade');
+
+const FRAME_INDEX_VERSION = 1;
+const DEFAULT_FRAME_BYTES = 256 * 1024;
+const TAR_BLOCK = 512;
+
+const frameColumnKnown = new WeakSet(); // dbs where compression_buckets.frame_index_json exists
+
+/**
+ * True when the add_bucket_frame_index_column migration has run. Only a
+ * positive answer is cached, so a migration applied later on the same
+ * handle is picked up.
+ * @param {Database} db - better-sqlite3 database instance
+ * @returns {boolean}
+ */
+function hasFrameColumn(db) {
+  if (frameColumnKnown.has(db)) return true;
+  try {
+    const columns = db.prepare('PRAGMA table_info(compression_buckets)').all().map((column) => column.name);
+    if (!columns.includes('frame_index_json')) return false;
+  } catch (_) {
+    return false;
+  }
+  frameColumnKnown.add(db);
+  return true;
+}
+
+/**
+ * Throw unless seekable buckets can be written to this DB.
+ * @param {Database} db - better-sqlite3 database instance
+ */
+function assertSeekableBucketSchema(db) {
+  if (!hasFrameColumn(db)) {
+    throw new Error('compression_buckets has no frame_index_json column; run node tools/migrations/project-migrations.js');
+  }
+}
+
+/**
+ * Compress entries into independently decodable frames.
+ *
+ * Entries are packed in order. A frame is closed once it reaches
+ * `frameBytes`, and an entry never spans two frames, so an entry larger than
+ * the target gets a frame to itself.
+ *
+ * @param {Array<{key: string, buffer: Buffer}>} entries
+ * @param {Object} compressOptions - CompressionFacade.compress options (preset/algorithm/level/...)
+ * @param {Object} [options]
+ * @param {number} [options.frameBytes=262144] - Target uncompressed bytes per frame
+ * @returns {{blob: Buffer, frames: Array<Array<number>>, placements: Map<string, {frame: number, offset: number}>}}
+ */
+function buildFrames(entries, compressOptions, options = {}) {
+  const frameBytes = Math.max(1, options.frameBytes || DEFAULT_FRAME_BYTES);
+  const frames = [];
+  const blobs = [];
+  const placements = new Map();
+  let pending = [];
+  let pendingBytes = 0;
+  let blobOffset = 0;
+
+  const flush = () => {
+    if (pending.length === 0) return;
+    const raw = Buffer.concat(pending, pendingBytes);
+    const { compressed } = compress(raw, compressOptions);
+    frames.push([blobOffset, compressed.length, raw.length]);
+    blobs.push(compressed);
+    blobOffset += compressed.length;
+    pending = [];
+    pendingBytes = 0;
+  };
+
+  for (const { key, buffer } of entries) {
+    if (pendingBytes > 0 && pendingBytes + buffer.length > frameBytes) {
+      flush();
+    }
+    placements.set(key, { frame: frames.length, offset: pendingBytes });
+    pending.push(buffer);
+    pendingBytes += buffer.length;
+  }
+  flush();
+
+  return { blob: Buffer.concat(blobs, blobOffset), frames, placements };
+}
+
+function frameIndexJson(frames) {
+  return JSON.stringify({ version: FRAME_INDEX_VERSION, frames });
+}
+
+function parseFrameIndex(json) {
+  if (!json) return null;
+  const parsed = typeof json === 'string' ? JSON.parse(json) : json;
+  if (!parsed || parsed.version !== FRAME_INDEX_VERSION || !Array.isArray(parsed.frames)) {
+    throw new Error(`Unsupported bucket frame index version: ${parsed && parsed.version}`);
+  }
+  return parsed.frames;
+}
+
+/**
+ * Read the members of a ustar archive (the legacy bucket payload) without
+ * streaming. Only regular files are returned.
+ *
+ * @param {Buffer} tarBuffer
+ * @returns {Array<{name: string, content: Buffer}>}
+ */
+function readTarEntries(tarBuffer) {
+  const entries = [];
+  let position = 0;
+  let paxPath = null; // tar-stream writes names over 100 chars as a PAX 'path' record
+  while (position + TAR_BLOCK <= tarBuffer.length) {
+    const header = tarBuffer.subarray(position, position + TAR_BLOCK);
+    if (header.every((byte) => byte === 0)) break;
+
+    const field = (start, length) => {
+      const raw = header.subarray(start, start + length);
+      const end = raw.indexOf(0);
+      return raw.toString('utf8', 0, end === -1 ? raw.length : end);
+    };
+    const prefix = field(345, 155);
+    const name = prefix ? `${prefix}/${field(0, 100)}` : field(0, 100);
+    const size = parseInt(field(124, 12).trim() || '0', 8);
+    const type = String.fromCharCode(header[156] || 48);
+    const start = position + TAR_BLOCK;
+    if (!Number.isFinite(size) || start + size > tarBuffer.length) {
+      throw new Error(`Truncated tar entry: ${name}`);
+    }
+    if (type === 'x') {
+      const match = /\d+ path=([^\n]*)\n/.exec(tarBuffer.toString('utf8', start, start + size));
+      paxPath = match ? match[1] : null;
+    } else if (type === '0' || type === '\0') {
+      entries.push({ name: paxPath || name, content: tarBuffer.subarray(start, start + size) });
+      paxPath = null;
+    }
+    position = start + Math.ceil(size / TAR_BLOCK) * TAR_BLOCK;
+  }
+  return entries;
+}
+
+function tarHeader(name, size, type) {
+  const header = Buffer.alloc(TAR_BLOCK, 0);
+  header.write(name.slice(0, 100), 0, 'utf8');
+  header.write('0000644\0', 100, 'ascii');
+  header.write('0000000\0', 108, 'ascii');
+  header.write('0000000\0', 116, 'ascii');
+  header.write(`${size.toString(8).padStart(11, '0')}\0`, 124, 'ascii');
+  header.write('00000000000\0', 136, 'ascii');
+  header.write(type, 156, 'ascii');
+  header.write('ustar\0' + '00', 257, 'ascii');
+  header.fill(0x20, 148, 156); // checksum is computed with its own field as spaces
+  let checksum = 0;
+  for (const byte of header) checksum += byte;
+  header.write(`${checksum.toString(8).padStart(6, '0')}\0 `, 148, 'ascii');
+  return header;
+}
+
+function tarPadding(size) {
+  const remainder = size % TAR_BLOCK;
+  return remainder === 0 ? null : Buffer.alloc(TAR_BLOCK - remainder, 0);
+}
+
+/**
+ * Write a ustar archive in the layout readTarEntries (and tar-stream) reads.
+ * Names over 100 bytes get a PAX 'path' record, as tar-stream writes them.
+ *
+ * @param {Array<{name: string, content: Buffer}>} entries
+ * @returns {Buffer}
+ */
+function writeTarEntries(entries) {
+  const parts = [];
+  const append = (name, type, content) => {
+    parts.push(tarHeader(name, content.length, type), content);
+    const padding = tarPadding(content.length);
+    if (padding) parts.push(padding);
+  };
+  for (const { name, content } of entries) {
+    if (Buffer.byteLength(name) > 100) {
+      const record = ` path=${name}\n`;
+      let length = Buffer.byteLength(record);
+      length += String(length + String(length).length).length;
+      append('PaxHeader', 'x', Buffer.from(`${length}${record}`, 'utf8'));
+    }
+    append(name, '0', content);
+  }
+  parts.push(Buffer.alloc(TAR_BLOCK * 2, 0));
+  return Buffer.concat(parts);
+}
+
+/**
+ * Rebuild a legacy tar payload from the decompressed frames of a seekable
+ * bucket, for callers that want the whole bucket at once.
+ *
+ * @param {Object} layout - readBucketLayout() result with frames
+ * @param {Array<Buffer>} frameBuffers - Decompressed frames, in frame order
+ * @returns {Buffer}
+ */
+function framesToTar(layout, frameBuffers) {
+  return writeTarEntries(Object.values(layout.index).map((entry) => ({
+    name: entry.filename,
+    content: sliceEntry(frameBuffers[entry.frame], entry)
+  })));
+}
+
+/**
+ * Split a seekable bucket_blob into its compressed frames.
+ * @returns {Array<Buffer>}
+ */
+function splitFrames(blob, layout) {
+  return layout.frames.map(([offset, length]) => blob.subarray(offset, offset + length));
+}
+
+/**
+ * Index, frame table and algorithm for a bucket, without its blob.
+ * @returns {{index: Object, frames: Array|null, algorithm: string, compressionTypeId: number}|null}
+ */
+function readBucketLayout(db, bucketId) {
+  const row = db.prepare(`
+    SELECT cb.index_json, ${hasFrameColumn(db) ? 'cb.frame_index_json' : 'NULL'} AS frame_index_json,
+           cb.compression_type_id, ct.algorithm
+    FROM compression_buckets cb
+    JOIN compression_types ct ON cb.compression_type_id = ct.id
+    WHERE cb.id = ?
+  `).get(bucketId);
+  if (!row) return null;
+
+  let index;
+  try {
+    index = JSON.parse(row.index_json);
+  } catch (error) {
+    throw new Error(`Corrupted bucket index for bucket ${bucketId}: ${error.message}`);
+  }
+  return {
+    index,
+    frames: parseFrameIndex(row.frame_index_json),
+    algorithm: row.algorithm,
+    compressionTypeId: row.compression_type_id
+  };
+}
+
+/**
+ * Fetch and decompress one frame. Only the frame's bytes leave SQLite.
+ * @returns {Buffer}
+ */
+function readFrame(db, bucketId, layout, frameNumber) {
+  return decompress(readFrameBytes(db, bucketId, layout, frameNumber), layout.algorithm);
+}
+
+/**
+ * readFrame() with the decompression moved off the calling thread.
+ * @returns {Promise<Buffer>}
+ */
+async function readFrameAsync(db, bucketId, layout, frameNumber) {
+  return decompressAsync(readFrameBytes(db, bucketId, layout, frameNumber), layout.algorithm);
+}
+
+function readFrameBytes(db, bucketId, layout, frameNumber) {
+  const frame = layout.frames[frameNumber];
+  if (!frame) {
+    throw new Error(`Frame ${frameNumber} not found in bucket ${bucketId}`);
+  }
+  const [offset, length] = frame;
+  const row = db.prepare('SELECT substr(bucket_blob, ?, ?) AS bytes FROM compression_buckets WHERE id = ?')
+    .get(offset + 1, length, bucketId);
+  if (!row || !row.bytes || row.bytes.length !== length) {
+    throw new Error(`Frame ${frameNumber} of bucket ${bucketId} is truncated`);
+  }
+  return Buffer.from(row.bytes);
+}
+
+/**
+ * Slice an entry out of its decompressed frame.
+ * @returns {Buffer}
+ */
+function sliceEntry(frameBuffer, entry) {
+  return frameBuffer.subarray(entry.offset, entry.offset + entry.size);
+}
+
+module.exports = {
+  FRAME_INDEX_VERSION,
+  DEFAULT_FRAME_BYTES,
+  hasFrameColumn,
+  assertSeekableBucketSchema,
+  buildFrames,
+  frameIndexJson,
+  parseFrameIndex,
+  readTarEntries,
+  writeTarEntries,
+  framesToTar,
+  splitFrames,
+  readBucketLayout,
+  readFrame,
+  readFrameAsync,
+  sliceEntry
+};
@@ -0,0 +1,179 @@
+/**
+ * Stored Content Reader
+ *
+ * Async reads of stored bodies for request handlers and bulk export. Every
+ * decompression runs on the libuv threadpool (decompressAsync / the async
+ * BucketCache methods), so one large export does not stall other requests.
+ *
+ * readAll() keeps a small window of reads in flight and returns results in
+ * input order. It also prefetches the buckets (or seekable frames) for the
+ * rows just beyond that window. Rows from the same bucket share one
+ * decompression through BucketCache request coalescing.
+ */
+
+const { decompressAsync, retrieveAndDecompressAsync, getTypeDictionary } = require('./CompressionFacade');
+const { getGlobalCache } = require('./bucketCache');
+
+/**
+ * Work out where a row's body lives. Accepts content_storage-shaped rows
+ * (compression_bucket_id / bucket_entry_key / content_blob), articles rows
+ * (compression_bucket_key) and plain { contentId } references.
+ *
+ * @param {Object} row
+ * @returns {Object|null} { kind: 'bucket'|'inline'|'stored'|'text', ... } or null when there is no body
+ */
+function describeContentSource(row) {
+  if (!row) return null;
+  const bucketId = row.compression_bucket_id ?? row.bucketId ?? null;
+  const entryKey = row.bucket_entry_key ?? row.compression_bucket_key ?? row.entryKey ?? null;
+  if (bucketId != null && entryKey != null) {
+    return { kind: 'bucket', bucketId, entryKey };
+  }
+  const blob = row.content_blob ?? row.contentBlob ?? null;
+  if (blob != null) {
+    return {
+      kind: 'inline',
+      blob: Buffer.isBuffer(blob) ? blob : Buffer.from(blob),
+      algorithm: (row.compression_algorithm ?? row.compressionAlgorithm ?? row.algorithm ?? 'none').toLowerCase(),
+      compressionTypeId: row.compression_type_id ?? row.compressionTypeId ?? null
+    };
+  }
+  if (typeof row.html === 'string') {
+    return { kind: 'text', text: row.html };
+  }
+  const contentId = row.content_id ?? row.contentId ?? null;
+  if (contentId != null) {
+    return { kind: 'stored', contentId };
+  }
+  return null;
+}
+
+class StoredContentReader {
+  /**
+   * @param {Object} options
+   * @param {Database} options.db - better-sqlite3 database instance
+   * @param {BucketCache} [options.bucketCache] - Defaults to the global cache
+   * @param {number} [options.concurrency=4] - Reads in flight during readAll()
+   * @param {number} [options.prefetchBuckets=2] - Distinct upcoming buckets/frames to warm ahead of the window
+   * @param {number} [options.lookahead=32] - Rows buffered beyond the window to find upcoming buckets
+   */
+  constructor(options = {}) {
+    if (!options.db) {
+      throw new Error('StoredContentReader requires a database connection');
+    }
+    this.db = options.db;
+    this.bucketCache = options.bucketCache || getGlobalCache();
+    this.concurrency = Math.max(1, options.concurrency || 4);
+    this.prefetchBuckets = Math.max(0, options.prefetchBuckets ?? 2);
+    this.lookahead = Math.max(0, options.lookahead ?? 32);
+  }
+
+  /**
+   * Read and decompress one row's body
+   *
+   * @param {Object} row - See describeContentSource()
+   * @returns {Promise<Buffer|null>} Body, or null when the row has none
+   */
+  async read(row) {
+    const source = describeContentSource(row);
+    if (!source) return null;
+
+    switch (source.kind) {
+      case 'bucket': {
+        const { content } = await this.bucketCache.getEntryAsync(this.db, source.bucketId, source.entryKey);
+        return content;
+      }
+      case 'inline': {
+        const dictionary = getTypeDictionary(this.db, source.compressionTypeId, source.algorithm);
+        return decompressAsync(source.blob, source.algorithm, dictionary ? { dictionary } : {});
+      }
+      case 'stored':
+        return retrieveAndDecompressAsync(this.db, source.contentId);
+      default:
+        return Buffer.from(source.text, 'utf8');
+    }
+  }
+
+  /**
+   * Read many rows in order with bounded concurrency and bucket prefetch.
+   * A failed row yields { error } instead of ending the iteration.
+   *
+   * @param {Iterable<Object>|AsyncIterable<Object>} rows
+   * @returns {AsyncGenerator<{row: Object, content: Buffer|null, error: Error|null}>}
+   */
+  async *readAll(rows) {
+    const iterator = typeof rows[Symbol.asyncIterator] === 'function'
+      ? rows[Symbol.asyncIterator]()
+      : rows[Symbol.iterator]();
+    const queue = []; // { row, promise|null }
+    let exhausted = false;
+
+    const fill = async () => {
+      while (!exhausted && queue.length < this.concurrency + this.lookahead) {
+        const next = await iterator.next();
+        if (next.done) {
+          exhausted = true;
+        } else {
+          queue.push({ row: next.value, promise: null });
+        }
+      }
+    };
+
+    try {
+      await fill();
+      while (queue.length > 0) {
+        for (let i = 0; i < Math.min(this.concurrency, queue.length); i++) {
+          if (!queue[i].promise) {
+            const { row } = queue[i];
+            queue[i].promise = this.read(row).then(
+              (content) => ({ row, content, error: null }),
+              (error) => ({ row, content: null, error })
+            );
+          }
+        }
+        this._prefetchBeyond(queue);
+
+        const result = await queue[0].promise;
+        queue.shift();
+        yield result;
+        await fill();
+      }
+    } finally {
+      if (typeof iterator.return === 'function') {
+        await iterator.return();
+      }
+    }
+  }
+
+  /**
+   * Warm the next few distinct buckets/frames queued after the read window
+   * @private
+   */
+  _prefetchBeyond(queue) {
+    if (this.prefetchBuckets === 0) return;
+    const refs = [];
+    const seen = new Set();
+    for (let i = this.concurrency; i < queue.length && refs.length < this.prefetchBuckets; i++) {
+      const source = describeContentSource(queue[i].row);
+      if (!source || source.kind !== 'bucket') continue;
+      const layout = this._layoutKey(source);
+      if (seen.has(layout)) continue;
+      seen.add(layout);
+      refs.push({ bucketId: source.bucketId, entryKey: source.entryKey });
+    }
+    if (refs.length > 0) {
+      this.bucketCache.prefetch(this.db, refs);
+    }
+  }
+
+  _layoutKey(source) {
+    const layout = this.bucketCache.layouts && this.bucketCache.layouts.get(source.bucketId);
+    const entry = layout && layout.frames ? layout.index[source.entryKey] : null;
+    return entry ? `${source.bucketId}:${entry.frame}` : String(source.bucketId);
+  }
+}
+
+module.exports = {
+  StoredContentReader,
+  describeContentSource
+};
@@ -0,0 +1,211 @@
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const {
+  analysePagesParallel,
+  createPendingRowReader,
+  AnalysisCheckpoint
+} = require('../analyse-pages-parallel');
+
+const quietLogger = { log() {}, info() {}, debug() {}, warn() {}, error() {} };
+
+// In-memory stand-in for NewsDatabase + createAnalysePagesCoreQueries
+function createFakeDatabase(pageCount, { keyset = false } = {}) {
+  const rows = [];
+  for (let i = 1; i <= pageCount; i++) {
+    rows.push({
+      analysis_id: i * 10,
+      content_id: i,
+      url: `https://example.com/story-${i}`,
+      title: `Story ${i}`,
+      content_blob: Buffer.from(`<html><body>story ${i}</body></html>`),
+      compression_algorithm: 'none',
+      analysis_version: 0
+    });
+  }
+  const state = { rows, updates: [], transactions: 0, reads: [] };
+  const pending = (version) => rows.filter((row) => row.analysis_version < version);
+
+  const queries = {
+    getPendingAnalyses(version, limit) {
+      state.reads.push(['drain', limit]);
+      const list = pending(version);
+      return limit == null ? list : list.slice(0, limit);
+    },
+    hasCompressionBucketSupport: () => false,
+    getCompressionBucketById: () => null,
+    updateAnalysis(update) {
+      if (state.failOn && state.failOn(update.analysis_id)) throw new Error('disk full');
+      state.updates.push(update);
+      rows.find((row) => row.analysis_id === update.analysis_id).analysis_version = update.analysis_version;
+    },
+    saveUnknownTerm: () => null,
+    getPlaceHubByUrl: () => null,
+    savePlaceHub: () => null
+  };
+  if (keyset) {
+    queries.getPendingAnalysesAfter = (version, afterId, limit) => {
+      state.reads.push(['keyset', afterId, limit]);
+      return pending(version).filter((row) => afterId == null || row.analysis_id > afterId).slice(0, limit);
+    };
+  }
+
+  return {
+    state,
+    database: {
+      db: {
+        transaction: (fn) => (...args) => {
+          state.transactions += 1;
+          return fn(...args);
+        }
+      },
+      createAnalysePagesCoreQueries: () => queries,
+      close() {}
+    }
+  };
+}
+
+function fakeAnalyze({ url, html }) {
+  return Promise.resolve({
+    analysis: { kind: 'article', meta: { wordCount: html.length } },
+    places: [{ name: 'Example' }],
+    hubCandidate: null,
+    deepAnalysis: null,
+    preparation: null,
+    timings: { overallMs: 1 },
+    url
+  });
+}
+
+describe('analysePagesParallel', () => {
+  let dir;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'analyse-pages-parallel-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  test('writes one transaction per batch and reports per-stage throughput', async () => {
+    const { database, state } = createFakeDatabase(7, { keyset: true });
+    const progress = [];
+    const summary = await analysePagesParallel({
+      database,
+      analysisVersion: 3,
+      batchSize: 3,
+      checkpointPath: path.join(dir, 'checkpoint.json'),
+      gazetteerArtifactPath: false,
+      analyze: fakeAnalyze,
+      logger: quietLogger,
+      onProgress: (payload) => progress.push(payload)
+    });
+
+    expect(summary).toMatchObject({ processed: 7, updated: 7, placesInserted: 7, batches: 3, mode: 'keyset', workers: 0 });
+    expect(state.transactions).toBe(3);
+    expect(state.reads.map((read) => read[1])).toEqual([null, 30, 60, 70]);
+    expect(state.updates.map((update) => update.analysis_version)).toEqual(new Array(7).fill(3));
+    for (const stage of ['read', 'load', 'analyse', 'persist']) {
+      expect(summary.stages[stage].pages).toBe(7);
+    }
+    expect(progress.map((payload) => payload.lastAnalysisId)).toEqual([30, 60, 70, 70]);
+    expect(progress[0].stages.persist.pages).toBe(3);
+
+    const saved = JSON.parse(fs.readFileSync(path.join(dir, 'checkpoint.json'), 'utf8'));
+    expect(saved).toMatchObject({ analysisVersion: 3, lastAnalysisId: 70, batches: 3 });
+    expect(saved.completedAt).toEqual(expect.any(String));
+    expect(new AnalysisCheckpoint(path.join(dir, 'checkpoint.json')).load(3)).toBeNull();
+  });
+
+  test('resumes after the last committed batch of an interrupted run', async () => {
+    const { database, state } = createFakeDatabase(6, { keyset: true });
+    const checkpointPath = path.join(dir, 'checkpoint.json');
+    let calls = 0;
+    const crashing = (params) => {
+      calls += 1;
+      if (calls === 3) return Promise.reject(Object.assign(new Error('killed'), { fatal: true }));
+      return fakeAnalyze(params);
+    };
+    // The failed page stays pending and is recorded; the batch still commits
+    const first = await analysePagesParallel({
+      database,
+      analysisVersion: 2,
+      batchSize: 2,
+      limit: 4,
+      checkpointPath,
+      gazetteerArtifactPath: false,
+      analyze: crashing,
+      logger: quietLogger
+    });
+    expect(first).toMatchObject({ processed: 4, updated: 3, failed: 1 });
+
+    const saved = JSON.parse(fs.readFileSync(checkpointPath, 'utf8'));
+    saved.completedAt = null; // as if the process had died after batch 2
+    fs.writeFileSync(checkpointPath, JSON.stringify(saved));
+
+    const second = await analysePagesParallel({
+      database,
+      analysisVersion: 2,
+      batchSize: 2,
+      checkpointPath,
+      gazetteerArtifactPath: false,
+      analyze: fakeAnalyze,
+      logger: quietLogger
+    });
+    expect(second).toMatchObject({ resumedFrom: 40, processed: 6, updated: 5, failed: 1, batches: 3 });
+    expect(state.reads[state.reads.length - 2]).toEqual(['keyset', 40, 2]);
+    expect(state.updates.map((update) => update.analysis_id)).toEqual([10, 20, 40, 50, 60]);
+  });
+
+  test('drains getPendingAnalyses when there is no keyset query, skipping rows that failed', async () => {
+    const { database, state } = createFakeDatabase(5);
+    state.failOn = (id) => id === 20;
+    const summary = await analysePagesParallel({
+      database,
+      analysisVersion: 1,
+      batchSize: 2,
+      checkpointPath: false,
+      gazetteerArtifactPath: false,
+      analyze: fakeAnalyze,
+      logger: quietLogger
+    });
+    expect(summary).toMatchObject({ mode: 'drain', processed: 5, updated: 4, failed: 1 });
+    expect(state.updates.map((update) => update.analysis_id)).toEqual([10, 30, 40, 50]);
+  });
+
+  test('reads in keyset mode through the db layer when the handle can prepare statements', async () => {
+    const { database, state } = createFakeDatabase(5);
+    database.db.prepare = () => ({
+      all: (afterId, version, limit) => {
+        state.reads.push(['prepared', afterId, limit]);
+        return state.rows
+          .filter((row) => row.analysis_version < version && row.analysis_id > afterId)
+          .slice(0, limit);
+      }
+    });
+    const summary = await analysePagesParallel({
+      database,
+      analysisVersion: 1,
+      batchSize: 2,
+      checkpointPath: false,
+      gazetteerArtifactPath: false,
+      analyze: fakeAnalyze,
+      logger: quietLogger
+    });
+    expect(summary).toMatchObject({ mode: 'keyset', processed: 5, updated: 5 });
+    expect(state.reads.map((read) => read[0])).not.toContain('drain');
+    expect(state.reads.map((read) => read[1])).toEqual([0, 20, 40, 50]);
+  });
+
+  test('dry runs read a sorted snapshot and write nothing', () => {
+    const { database } = createFakeDatabase(5);
+    const queries = database.createAnalysePagesCoreQueries();
+    const reader = createPendingRowReader(queries, { analysisVersion: 1, batchSize: 2, limit: 3, afterId: 10, dryRun: true });
+    expect(reader.mode).toBe('snapshot');
+    expect(reader.next().map((row) => row.analysis_id)).toEqual([20, 30]);
+    expect(reader.next().map((row) => row.analysis_id)).toEqual([40]);
+    expect(reader.next()).toEqual([]);
+  });
+});
@@ -4,11 +4,12 @@ const { performance } = require('perf_hooks');
 const { is_array } = require('lang-tools');
 let NewsDatabase = null;
 const { analyzePage } = require('../intelligence/analysis/page-analyzer');
-const { buildGazetteerMatchers } = require('../intelligence/analysis/place-extraction');
+const { loadGazetteerMatchers } = require('../intelligence/analysis/place-extraction');
 const { findProjectRoot } = require('../shared/utils/project-root');
 const { loadNonGeoTopicSlugs } = require('./nonGeoTopicSlugs');
 const { ArticleXPathService } = require('../services/ArticleXPathService');
 const { DecompressionWorkerPool } = require('../background/workers/DecompressionWorkerPool');
+const { getTypeDictionary } = require('../shared/utils/CompressionFacade');
 const SkeletonHash = require('../intelligence/analysis/structure/SkeletonHash');
 const { createLayoutSignaturesQueries } = require('news-crawler-db');
 
@@ -41,7 +42,8 @@ async function analysePages({
   benchmark = null,
   analysisOptions = {},
   timeout = 5000,
-  logSpeed = false
+  logSpeed = false,
+  gazetteerArtifactPath = null
 } = {}) {
   if (!dbPath) {
     const projectRoot = findProjectRoot(__dirname);
@@ -84,7 +86,13 @@ async function analysePages({
 
     let gazetteer = null;
     try {
-      gazetteer = buildGazetteerMatchers(db.db);
+      // Reuses data/cache/gazetteer-matchers.bin until the gazetteer tables change
+      gazetteer = loadGazetteerMatchers(db.db, {
+        artifactPath: gazetteerArtifactPath === false
+          ? null
+          : (gazetteerArtifactPath || path.join(path.dirname(dbPath), 'cache', 'gazetteer-matchers.bin')),
+        logger
+      });
     } catch (error) {
       emit(logger, 'warn', '[analyse-pages] Failed to build gazetteer matchers', verbose ? error : error?.message);
       gazetteer = null;
@@ -205,6 +213,7 @@ async function analysePages({
         bucketCache,
         hasCompressionBucketSupport,
         getCompressionBucketById,
+        getCompressionDictionary: (typeId, algorithm) => getTypeDictionary(db.db, typeId, algorithm),
         logger,
         verbose
       });
@@ -362,7 +371,7 @@ async function analysePages({
         benchmarkEntry.analysisError = null;
       }
 
-      const { analysis, places, hubCandidate, deepAnalysis, preparation } = analysisResult;
+      const { analysis, places, hubCandidate, deepAnalysis } = analysisResult;
 
       lastAnalysisResult = {
         places,
@@ -372,24 +381,7 @@ async function analysePages({
         meta: analysis.meta
       };
 
-      if (deepAnalysis) {
-        analysis.meta = analysis.meta || {};
-        analysis.meta.deepAnalysis = deepAnalysis;
-      }
-
-      if (htmlInfo.meta) {
-        analysis.meta = analysis.meta || {};
-        analysis.meta.htmlSource = htmlInfo.meta.source;
-        if (htmlInfo.meta.algorithm) analysis.meta.compression = htmlInfo.meta.algorithm;
-        if (htmlInfo.meta.bucketId) analysis.meta.bucketId = htmlInfo.meta.bucketId;
-        if (htmlInfo.meta.totalDurationMs != null) analysis.meta.decompressionMs = htmlInfo.meta.totalDurationMs;
-        if (htmlInfo.meta.decompressionWorkerMs != null) {
-          analysis.meta.decompressionWorkerMs = htmlInfo.meta.decompressionWorkerMs;
-        }
-        if (htmlInfo.meta.extractionMs != null) {
-          analysis.meta.decompressionExtractionMs = htmlInfo.meta.extractionMs;
-        }
-      }
+      annotateAnalysisMeta(analysis, deepAnalysis, htmlInfo);
 
       const htmlMeta = htmlInfo?.meta || {};
       const htmlTotalMs = Number.isFinite(htmlMeta.totalDurationMs)
@@ -447,137 +439,24 @@ async function analysePages({
         lastItemTimings = null;
       }
 
-      const wordCountForUpdate = (() => {
-        if (analysis.meta?.wordCount != null) return analysis.meta.wordCount;
-        if (preparation?.articleRow?.word_count != null) return preparation.articleRow.word_count;
-        if (row.word_count != null) return row.word_count;
-        return null;
-      })();
-
-      const articleXPathForUpdate = (() => {
-        if (analysis.meta?.articleXPath) return analysis.meta.articleXPath;
-        if (preparation?.articleRow?.article_xpath) return preparation.articleRow.article_xpath;
-        if (row.article_xpath) return row.article_xpath;
-        return null;
-      })();
-
-      if (shouldPersist) {
-        const persistStart = performance.now();
-        try {
-          queries.updateAnalysis({
-            analysis_json: JSON.stringify(analysis),
-            analysis_version: analysisVersion,
-            word_count: wordCountForUpdate,
-            article_xpath: articleXPathForUpdate,
-            analysis_id: row.analysis_id
-          });
-          updated += 1;
-        } catch (error) {
-          emit(logger, 'warn', `[analyse-pages] Failed to persist analysis for ${row.url}`, verbose ? error : error?.message);
-        } finally {
-          recordTiming('db.updateAnalysisMs', performance.now() - persistStart);
-        }
-      } else {
-        updated += 1;
-      }
-
-      if (is_array(places)) {
-        placesInserted += places.length;
-      }
-
-      if (hubCandidate) {
-        const evidenceJson = hubCandidate.evidence ? JSON.stringify(hubCandidate.evidence) : null;
-
-        if (hubCandidate.kind === 'unknown') {
-          if (Array.isArray(hubCandidate.unknownTerms) && hubCandidate.unknownTerms.length) {
-            const canonicalUrl = hubCandidate.canonicalUrl || row.url;
-            for (const term of hubCandidate.unknownTerms) {
-              if (shouldPersist) {
-                try {
-                  const saved = queries.saveUnknownTerm({
-                    host: hubCandidate.host,
-                    url: row.url,
-                    canonicalUrl,
-                    termSlug: term.slug,
-                    termLabel: term.label || null,
-                    source: term.source || null,
-                    reason: term.reason || null,
-                    confidence: term.confidence || null,
-                    evidence: evidenceJson
-                  });
-                  if (saved) {
-                    unknownInserted += 1;
-                  }
-                } catch (error) {
-                  emit(logger, 'warn', `[analyse-pages] Failed to persist unknown term for ${row.url}`, verbose ? error : error?.message);
-                }
-              } else {
-                unknownInserted += 1;
-              }
-            }
-          }
-        } else if (hubCandidate.kind === 'place') {
-          let existingHub = null;
-          try {
-            existingHub = queries.getPlaceHubByUrl(row.url) || null;
-          } catch (_) {
-            existingHub = null;
-          }
-
-          const isNewHub = !existingHub;
-          let hubPersisted = !shouldPersist;
-
-          if (shouldPersist) {
-            try {
-              queries.savePlaceHub({
-                host: hubCandidate.host,
-                url: row.url,
-                placeSlug: hubCandidate.placeSlug,
-                placeKind: hubCandidate.placeKind,
-                topicSlug: hubCandidate.topic?.slug ?? null,
-                topicLabel: hubCandidate.topic?.label ?? null,
-                topicKind: hubCandidate.topic?.kind ?? null,
-                title: row.title || null,
-                navLinksCount: hubCandidate.navLinksCount,
-                articleLinksCount: hubCandidate.articleLinksCount,
-                evidenceJson
-              });
-              hubPersisted = true;
-            } catch (error) {
-              emit(logger, 'warn', `[analyse-pages] Failed to persist place hub for ${row.url}`, verbose ? error : error?.message);
-              hubPersisted = false;
-            }
-          }
-
-          if (hubPersisted) {
-            if (isNewHub) hubsInserted += 1;
-            else hubsUpdated += 1;
-          }
-
-          if (hubAssignments && (hubLimit === 0 || hubAssignments.length < hubLimit)) {
-            const entry = {
-              host: hubCandidate.host,
-              url: row.url,
-              title: row.title || null,
-              place_slug: hubCandidate.placeSlug,
-              place_label: hubCandidate.placeLabel || null,
-              place_kind: hubCandidate.placeKind || null,
-              topic_slug: hubCandidate.topic?.slug ?? null,
-              topic_label: hubCandidate.topic?.label ?? null,
-              topic_kind: hubCandidate.topic?.kind ?? null,
-              nav_links_count: hubCandidate.navLinksCount,
-              article_links_count: hubCandidate.articleLinksCount,
-              word_count: hubCandidate.wordCount,
-              action: isNewHub ? 'insert' : 'update'
-            };
-            if (includeHubEvidence && hubCandidate.evidence) {
-              entry.evidence = hubCandidate.evidence;
-            }
-            hubAssignments.push(entry);
-          }
-        }
-      }
-
+      const counts = persistAnalysisResult({
+        queries,
+        row,
+        analysisResult,
+        analysisVersion,
+        shouldPersist,
+        hubAssignments,
+        hubLimit,
+        includeHubEvidence,
+        recordTiming,
+        logger,
+        verbose
+      });
+      updated += counts.updated;
+      placesInserted += counts.placesInserted;
+      unknownInserted += counts.unknownInserted;
+      hubsInserted += counts.hubsInserted;
+      hubsUpdated += counts.hubsUpdated;
       if (Date.now() - lastProgressAt >= 250) {
         emitProgress();
         lastProgressAt = Date.now();
@@ -633,7 +512,187 @@ async function analysePages({
   }
 }
 
-async function loadHtmlForRow(row, { decompressPool, bucketCache, hasCompressionBucketSupport, getCompressionBucketById, logger, verbose }) {
+/**
+ * Record how the HTML was loaded (and the deep analysis) on analysis.meta
+ */
+function annotateAnalysisMeta(analysis, deepAnalysis, htmlInfo) {
+  if (deepAnalysis) {
+    analysis.meta = analysis.meta || {};
+    analysis.meta.deepAnalysis = deepAnalysis;
+  }
+
+  if (htmlInfo.meta) {
+    analysis.meta = analysis.meta || {};
+    analysis.meta.htmlSource = htmlInfo.meta.source;
+    if (htmlInfo.meta.algorithm) analysis.meta.compression = htmlInfo.meta.algorithm;
+    if (htmlInfo.meta.bucketId) analysis.meta.bucketId = htmlInfo.meta.bucketId;
+    if (htmlInfo.meta.totalDurationMs != null) analysis.meta.decompressionMs = htmlInfo.meta.totalDurationMs;
+    if (htmlInfo.meta.decompressionWorkerMs != null) {
+      analysis.meta.decompressionWorkerMs = htmlInfo.meta.decompressionWorkerMs;
+    }
+    if (htmlInfo.meta.extractionMs != null) {
+      analysis.meta.decompressionExtractionMs = htmlInfo.meta.extractionMs;
+    }
+  }
+}
+
+/**
+ * Write one row's analysis, unknown terms and place hub.
+ * Shared by analysePages and the parallel engine (analyse-pages-parallel.js).
+ * @returns {{updated: number, placesInserted: number, unknownInserted: number, hubsInserted: number, hubsUpdated: number}}
+ */
+function persistAnalysisResult({
+  queries,
+  row,
+  analysisResult,
+  analysisVersion,
+  shouldPersist,
+  hubAssignments = null,
+  hubLimit = 0,
+  includeHubEvidence = false,
+  recordTiming = () => {},
+  logger,
+  verbose
+}) {
+  const { analysis, places, hubCandidate, preparation } = analysisResult;
+  const counts = { updated: 0, placesInserted: 0, unknownInserted: 0, hubsInserted: 0, hubsUpdated: 0 };
+
+  const wordCountForUpdate = (() => {
+    if (analysis.meta?.wordCount != null) return analysis.meta.wordCount;
+    if (preparation?.articleRow?.word_count != null) return preparation.articleRow.word_count;
+    if (row.word_count != null) return row.word_count;
+    return null;
+  })();
+
+  const articleXPathForUpdate = (() => {
+    if (analysis.meta?.articleXPath) return analysis.meta.articleXPath;
+    if (preparation?.articleRow?.article_xpath) return preparation.articleRow.article_xpath;
+    if (row.article_xpath) return row.article_xpath;
+    return null;
+  })();
+
+  if (shouldPersist) {
+    const persistStart = performance.now();
+    try {
+      queries.updateAnalysis({
+        analysis_json: JSON.stringify(analysis),
+        analysis_version: analysisVersion,
+        word_count: wordCountForUpdate,
+        article_xpath: articleXPathForUpdate,
+        analysis_id: row.analysis_id
+      });
+      counts.updated += 1;
+    } catch (error) {
+      emit(logger, 'warn', `[analyse-pages] Failed to persist analysis for ${row.url}`, verbose ? error : error?.message);
+    } finally {
+      recordTiming('db.updateAnalysisMs', performance.now() - persistStart);
+    }
+  } else {
+    counts.updated += 1;
+  }
+
+  if (is_array(places)) {
+    counts.placesInserted += places.length;
+  }
+
+  if (hubCandidate) {
+    const evidenceJson = hubCandidate.evidence ? JSON.stringify(hubCandidate.evidence) : null;
+
+    if (hubCandidate.kind === 'unknown') {
+      if (Array.isArray(hubCandidate.unknownTerms) && hubCandidate.unknownTerms.length) {
+        const canonicalUrl = hubCandidate.canonicalUrl || row.url;
+        for (const term of hubCandidate.unknownTerms) {
+          if (shouldPersist) {
+            try {
+              const saved = queries.saveUnknownTerm({
+                host: hubCandidate.host,
+                url: row.url,
+                canonicalUrl,
+                termSlug: term.slug,
+                termLabel: term.label || null,
+                source: term.source || null,
+                reason: term.reason || null,
+                confidence: term.confidence || null,
+                evidence: evidenceJson
+              });
+              if (saved) {
+                counts.unknownInserted += 1;
+              }
+            } catch (error) {
+              emit(logger, 'warn', `[analyse-pages] Failed to persist unknown term for ${row.url}`, verbose ? error : error?.message);
+            }
+          } else {
+            counts.unknownInserted += 1;
+          }
+        }
+      }
+    } else if (hubCandidate.kind === 'place') {
+      let existingHub = null;
+      try {
+        existingHub = queries.getPlaceHubByUrl(row.url) || null;
+      } catch (_) {
+        existingHub = null;
+      }
+
+      const isNewHub = !existingHub;
+      let hubPersisted = !shouldPersist;
+
+      if (shouldPersist) {
+        try {
+          queries.savePlaceHub({
+            host: hubCandidate.host,
+            url: row.url,
+            placeSlug: hubCandidate.placeSlug,
+            placeKind: hubCandidate.placeKind,
+            topicSlug: hubCandidate.topic?.slug ?? null,
+            topicLabel: hubCandidate.topic?.label ?? null,
+            topicKind: hubCandidate.topic?.kind ?? null,
+            title: row.title || null,
+            navLinksCount: hubCandidate.navLinksCount,
+            articleLinksCount: hubCandidate.articleLinksCount,
+            evidenceJson
+          });
+          hubPersisted = true;
+        } catch (error) {
+          emit(logger, 'warn', `[analyse-pages] Failed to persist place hub for ${row.url}`, verbose ? error : error?.message);
+          hubPersisted = false;
+        }
+      }
+
+      if (hubPersisted) {
+        if (isNewHub) counts.hubsInserted += 1;
+        else counts.hubsUpdated += 1;
+      }
+
+      if (hubAssignments && (hubLimit === 0 || hubAssignments.length < hubLimit)) {
+        const entry = {
+          host: hubCandidate.host,
+          url: row.url,
+          title: row.title || null,
+          place_slug: hubCandidate.placeSlug,
+          place_label: hubCandidate.placeLabel || null,
+          place_kind: hubCandidate.placeKind || null,
+          topic_slug: hubCandidate.topic?.slug ?? null,
+          topic_label: hubCandidate.topic?.label ?? null,
+          topic_kind: hubCandidate.topic?.kind ?? null,
+          nav_links_count: hubCandidate.navLinksCount,
+          article_links_count: hubCandidate.articleLinksCount,
+          word_count: hubCandidate.wordCount,
+          action: isNewHub ? 'insert' : 'update'
+        };
+        if (includeHubEvidence && hubCandidate.evidence) {
+          entry.evidence = hubCandidate.evidence;
+        }
+        hubAssignments.push(entry);
+      }
+    }
+  }
+
+
+  return counts;
+}
+
+async function loadHtmlForRow(row, { decompressPool, bucketCache, hasCompressionBucketSupport, getCompressionBucketById, getCompressionDictionary = null, logger, verbose }) {
   const overallStart = performance.now();
   const finalizeMeta = (meta) => {
     const totalDurationMs = Math.max(0, performance.now() - overallStart);
@@ -671,14 +730,26 @@ async function loadHtmlForRow(row, { decompressPool, bucketCache, hasCompression
           };
         }
 
-        const decompressResult = await decompressPool.decompress(bufferFrom(bucketRow.bucket_blob), bucketRow.algorithm || 'brotli', { bucketId });
-        decompressionWorkerMs = Number.isFinite(decompressResult.durationMs) ? Math.max(0, decompressResult.durationMs) : 0;
         const index = safeJsonParse(bucketRow.index_json) || {};
-        cacheEntry = {
-          tarBuffer: decompressResult.buffer,
-          index,
-          algorithm: bucketRow.algorithm || null
-        };
+        const frameIndex = safeJsonParse(bucketRow.frame_index_json);
+        if (frameIndex && Array.isArray(frameIndex.frames)) {
+          // Seekable bucket: keep the compressed blob, decompress frames on demand
+          cacheEntry = {
+            blob: bufferFrom(bucketRow.bucket_blob),
+            frames: frameIndex.frames,
+            frameBuffers: new Map(),
+            index,
+            algorithm: bucketRow.algorithm || null
+          };
+        } else {
+          const decompressResult = await decompressPool.decompress(bufferFrom(bucketRow.bucket_blob), bucketRow.algorithm || 'brotli', { bucketId });
+          decompressionWorkerMs = Number.isFinite(decompressResult.durationMs) ? Math.max(0, decompressResult.durationMs) : 0;
+          cacheEntry = {
+            tarBuffer: decompressResult.buffer,
+            index,
+            algorithm: bucketRow.algorithm || null
+          };
+        }
         bucketCache.set(bucketId, cacheEntry);
         cacheHit = false;
       }
@@ -692,6 +763,39 @@ async function loadHtmlForRow(row, { decompressPool, bucketCache, hasCompression
         };
       }
 
+      if (cacheEntry.frames) {
+        let frameBuffer = cacheEntry.frameBuffers.get(entry.frame);
+        if (!frameBuffer) {
+          const frame = cacheEntry.frames[entry.frame];
+          if (!frame) {
+            throw new Error(`Frame ${entry.frame} not found in bucket ${bucketId}`);
+          }
+          const [offset, length] = frame;
+          const decompressResult = await decompressPool.decompress(
+            cacheEntry.blob.subarray(offset, offset + length),
+            cacheEntry.algorithm || 'brotli',
+            { bucketId, frame: entry.frame }
+          );
+          decompressionWorkerMs += Number.isFinite(decompressResult.durationMs) ? Math.max(0, decompressResult.durationMs) : 0;
+          frameBuffer = decompressResult.buffer;
+          cacheEntry.frameBuffers.set(entry.frame, frameBuffer);
+          cacheHit = false;
+        }
+        return {
+          html: frameBuffer.toString('utf8', entry.offset, entry.offset + entry.size),
+          meta: finalizeMeta({
+            source: 'bucket',
+            bucketId,
+            frame: entry.frame,
+            algorithm: cacheEntry.algorithm,
+            cacheHit,
+            bucketFetchMs,
+            decompressionWorkerMs,
+            extractionMs: 0
+          })
+        };
+      }
+
       const extractionStart = performance.now();
       const contentBuffer = await extractTarEntry(cacheEntry.tarBuffer, entry.filename);
       const extractionMs = Math.max(0, performance.now() - extractionStart);
@@ -729,7 +833,16 @@ async function loadHtmlForRow(row, { decompressPool, bucketCache, hasCompression
       };
     }
 
-    const decompressResult = await decompressPool.decompress(buffer, algorithm, { contentId: row.content_id });
+    // Dictionary-compressed types (compressionDictionaries.js) need their dictionary to decode
+    const dictionary = getCompressionDictionary && row.compression_type_id != null
+      ? getCompressionDictionary(row.compression_type_id, algorithm)
+      : null;
+    const decompressResult = await decompressPool.decompress(
+      buffer,
+      algorithm,
+      { contentId: row.content_id },
+      dictionary ? { dictionary, dictionaryId: row.compression_type_id } : undefined
+    );
     const decompressionWorkerMs = Number.isFinite(decompressResult.durationMs) ? Math.max(0, decompressResult.durationMs) : 0;
     return {
       html: decompressResult.buffer.toString('utf8'),
@@ -799,5 +912,8 @@ function safeJsonParse(value) {
 }
 
 module.exports = {
-  analysePages
+  analysePages,
+  loadHtmlForRow,
+  annotateAnalysisMeta,
+  persistAnalysisResult
 };
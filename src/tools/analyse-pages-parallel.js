@@ -0,0 +1,653 @@
+'use strict';
+
+/**
+ * Parallel, resumable page analysis.
+ *
+ * analysePages() (analyse-pages-core.js) loads every pending row up front and
+ * walks them in sequence. This engine does the same work in batches:
+ *
+ *   read     pending rows, `batchSize` at a time, in analysis_id order
+ *   load     HTML through the DecompressionWorkerPool (one chain per bucket,
+ *            so a bucket is decompressed once per batch)
+ *   analyse  analyzePage on an AnalysisWorkerPool running analysePagesWorker.js,
+ *            with the gazetteer shared as a SharedArrayBuffer
+ *   persist  persistAnalysisResult for the whole batch in one transaction
+ *
+ * After each committed batch the checkpoint file records the last
+ * analysis_id. A later run with the same analysis version carries on after
+ * it. Each stage's pages/sec is included in progress events and the summary.
+ *
+ * @module analyse-pages-parallel
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { performance } = require('perf_hooks');
+const { analyzePage } = require('../intelligence/analysis/page-analyzer');
+const { loadGazetteerMatchers } = require('../intelligence/analysis/place-extraction');
+const { GazetteerArtifact } = require('../intelligence/analysis/GazetteerArtifact');
+const { findProjectRoot } = require('../shared/utils/project-root');
+const { loadNonGeoTopicSlugs } = require('./nonGeoTopicSlugs');
+const { ArticleXPathService } = require('../services/ArticleXPathService');
+const { DecompressionWorkerPool } = require('../background/workers/DecompressionWorkerPool');
+const { getTypeDictionary } = require('../shared/utils/CompressionFacade');
+const { AnalysisWorkerPool } = require('../core/crawler/pipeline/AnalysisWorkerPool');
+const { loadHtmlForRow, annotateAnalysisMeta, persistAnalysisResult } = require('./analyse-pages-core');
+const { getSearchIndexer } = require('../search/SearchIndexer');
+const { createPendingAnalysesAfterQuery } = require('../data/db/sqlite/queries/pendingAnalyses');
+
+const STAGES = ['read', 'load', 'analyse', 'persist'];
+const CHECKPOINT_VERSION = 1;
+const MAX_CACHED_BUCKETS = 16;
+
+function emit(logger, level, message, details) {
+  if (!logger) return;
+  const fn = typeof logger[level] === 'function' ? logger[level] : null;
+  if (fn) {
+    if (details !== undefined) fn.call(logger, message, details);
+    else fn.call(logger, message);
+  }
+}
+
+function toNumber(value, fallback) {
+  const num = Number(value);
+  return Number.isFinite(num) ? num : fallback;
+}
+
+/**
+ * Pages and time per stage. busyMs adds up per-page durations (which overlap
+ * across workers); wallMs adds up, per batch, the time from a stage's first
+ * start to its last finish. pagesPerSec is pages over wall time.
+ */
+class StageMeter {
+  constructor(stages = STAGES) {
+    this.stages = {};
+    for (const name of stages) {
+      this.stages[name] = { pages: 0, busyMs: 0, wallMs: 0 };
+    }
+    this._spans = {};
+  }
+
+  beginBatch() {
+    this._spans = {};
+  }
+
+  record(stage, startedAt, endedAt, pages = 1) {
+    const entry = this.stages[stage];
+    if (!entry) return;
+    entry.pages += pages;
+    entry.busyMs += Math.max(0, endedAt - startedAt);
+    const span = this._spans[stage];
+    if (!span) {
+      this._spans[stage] = { start: startedAt, end: endedAt };
+    } else {
+      if (startedAt < span.start) span.start = startedAt;
+      if (endedAt > span.end) span.end = endedAt;
+    }
+  }
+
+  endBatch() {
+    for (const [stage, span] of Object.entries(this._spans)) {
+      this.stages[stage].wallMs += Math.max(0, span.end - span.start);
+    }
+    this._spans = {};
+  }
+
+  snapshot() {
+    const out = {};
+    for (const [name, entry] of Object.entries(this.stages)) {
+      out[name] = {
+        pages: entry.pages,
+        busyMs: Math.round(entry.busyMs),
+        wallMs: Math.round(entry.wallMs),
+        pagesPerSec: entry.wallMs > 0 ? Math.round((entry.pages / entry.wallMs) * 10000) / 10 : null
+      };
+    }
+    return out;
+  }
+}
+
+/**
+ * JSON progress file, written atomically after every committed batch.
+ */
+class AnalysisCheckpoint {
+  constructor(filePath) {
+    this.filePath = filePath || null;
+    this.state = null;
+  }
+
+  /**
+   * @returns {Object|null} The saved state if it belongs to an unfinished run of `analysisVersion`
+   */
+  load(analysisVersion) {
+    if (!this.filePath) return null;
+    let saved;
+    try {
+      saved = JSON.parse(fs.readFileSync(this.filePath, 'utf8'));
+    } catch (_) {
+      return null;
+    }
+    if (!saved || saved.version !== CHECKPOINT_VERSION || saved.completedAt) return null;
+    if (analysisVersion != null && saved.analysisVersion !== analysisVersion) return null;
+    return saved;
+  }
+
+  start(analysisVersion, resumed = null) {
+    const now = new Date().toISOString();
+    this.state = resumed
+      ? { ...resumed, failedIds: (resumed.failedIds || []).slice(), updatedAt: now }
+      : {
+          version: CHECKPOINT_VERSION,
+          analysisVersion,
+          lastAnalysisId: null,
+          batches: 0,
+          counters: {},
+          failedIds: [],
+          startedAt: now,
+          updatedAt: now,
+          completedAt: null
+        };
+    return this.state;
+  }
+
+  commit({ lastAnalysisId, counters, failedIds = [] }) {
+    const state = this.state;
+    if (lastAnalysisId != null) state.lastAnalysisId = lastAnalysisId;
+    state.batches += 1;
+    state.counters = { ...counters };
+    if (failedIds.length) state.failedIds.push(...failedIds);
+    state.updatedAt = new Date().toISOString();
+    this._write();
+  }
+
+  complete(counters) {
+    this.state.counters = { ...counters };
+    this.state.completedAt = new Date().toISOString();
+    this._write();
+  }
+
+  _write() {
+    if (!this.filePath) return;
+    fs.mkdirSync(path.dirname(this.filePath), { recursive: true });
+    const tmpPath = `${this.filePath}.${process.pid}.tmp`;
+    fs.writeFileSync(tmpPath, JSON.stringify(this.state));
+    fs.renameSync(tmpPath, this.filePath);
+  }
+}
+
+/**
+ * Reads pending rows a batch at a time.
+ *
+ * - 'keyset': queries.getPendingAnalysesAfter(version, afterId, limit) returns
+ *   rows with analysis_id > afterId in id order. This is the cheap path, and
+ *   failed ids need no skipping because the cursor is already past them.
+ * - 'drain': rows leave getPendingAnalyses once their analysis_version is
+ *   written, so each batch asks for the head of the queue again, skipping the
+ *   ids that failed. Needs writes, so it is not used for dry runs.
+ * - 'snapshot': one getPendingAnalyses call, sorted and sliced (dry runs).
+ *
+ * @returns {{mode: string, next: function(): Array<Object>, skip: function(number): void}}
+ */
+function createPendingRowReader(queries, {
+  analysisVersion,
+  batchSize = 200,
+  limit = null,
+  afterId = null,
+  skipIds = [],
+  dryRun = false
+} = {}) {
+  const skipped = new Set(skipIds);
+  let cursor = afterId;
+  let remaining = limit != null && limit >= 0 ? limit : Infinity;
+  const skip = (id) => { if (id != null) skipped.add(id); };
+  const take = () => Math.min(batchSize, remaining);
+  const advance = (rows) => {
+    remaining -= rows.length;
+    if (rows.length) cursor = rows[rows.length - 1].analysis_id;
+    return rows;
+  };
+  const afterCursor = (row) => cursor == null || row.analysis_id > cursor;
+
+  if (typeof queries.getPendingAnalysesAfter === 'function') {
+    return {
+      mode: 'keyset',
+      skip,
+      next() {
+        if (take() <= 0) return [];
+        return advance(queries.getPendingAnalysesAfter(analysisVersion, cursor, take()) || []);
+      }
+    };
+  }
+
+  if (dryRun) {
+    let rows = null;
+    return {
+      mode: 'snapshot',
+      skip,
+      next() {
+        if (!rows) {
+          rows = (queries.getPendingAnalyses(analysisVersion, null) || [])
+            .filter((row) => afterCursor(row) && !skipped.has(row.analysis_id))
+            .sort((a, b) => a.analysis_id - b.analysis_id);
+        }
+        return advance(rows.splice(0, Math.max(0, take())));
+      }
+    };
+  }
+
+  return {
+    mode: 'drain',
+    skip,
+    next() {
+      const want = take();
+      if (want <= 0) return [];
+      const rows = (queries.getPendingAnalyses(analysisVersion, want + skipped.size) || [])
+        .filter((row) => !skipped.has(row.analysis_id))
+        .sort((a, b) => a.analysis_id - b.analysis_id)
+        .slice(0, want);
+      return advance(rows);
+    }
+  };
+}
+
+/**
+ * Give the adapter's query set a keyset getPendingAnalysesAfter from the db
+ * layer when it has none, so real databases read in 'keyset' mode.
+ */
+function withKeysetReader(queries, handle, logger) {
+  if (typeof queries.getPendingAnalysesAfter === 'function') return queries;
+  if (!handle || typeof handle.prepare !== 'function') return queries;
+  try {
+    const getPendingAnalysesAfter = createPendingAnalysesAfterQuery(handle);
+    return Object.assign(Object.create(queries), { getPendingAnalysesAfter });
+  } catch (error) {
+    emit(logger, 'warn', '[analyse-pages] Keyset pending query unavailable; draining instead', error?.message);
+    return queries;
+  }
+}
+
+function withTimeout(promise, timeout) {
+  if (!(timeout > 0)) return promise;
+  let timer = null;
+  const timeoutPromise = new Promise((_, reject) => {
+    timer = setTimeout(() => {
+      const error = new Error(`Analysis timed out after ${timeout}ms`);
+      error.timedOut = true;
+      reject(error);
+    }, timeout);
+  });
+  return Promise.race([promise, timeoutPromise]).finally(() => clearTimeout(timer));
+}
+
+function timeoutResult(durationMs) {
+  return {
+    analysis: {
+      kind: 'error',
+      error: 'Timeout',
+      meta: { durationMs, error: 'Timeout', timedOut: true }
+    },
+    places: [],
+    hubCandidate: null,
+    deepAnalysis: null,
+    preparation: null,
+    timings: { overallMs: durationMs }
+  };
+}
+
+function rowPayload(row) {
+  return {
+    title: row.title || null,
+    section: row.section || null,
+    articleRow: {
+      text: null,
+      word_count: toNumber(row.word_count, null),
+      article_xpath: row.article_xpath || null
+    },
+    fetchRow: {
+      classification: row.classification || null,
+      nav_links_count: toNumber(row.nav_links_count, null),
+      article_links_count: toNumber(row.article_links_count, null),
+      word_count: toNumber(row.word_count, null),
+      http_status: row.http_status || null
+    }
+  };
+}
+
+function sharedGazetteerBuffer(gazetteer, logger) {
+  if (!gazetteer) return null;
+  if (gazetteer.sharedBuffer) return gazetteer.sharedBuffer;
+  try {
+    const bytes = GazetteerArtifact.build(gazetteer, { fingerprint: 'in-memory' });
+    const shared = Buffer.from(new SharedArrayBuffer(bytes.length));
+    bytes.copy(shared);
+    return shared.buffer;
+  } catch (error) {
+    emit(logger, 'warn', '[analyse-pages] Failed to share gazetteer with workers', error?.message);
+    return null;
+  }
+}
+
+/**
+ * @param {Object} options
+ * @param {string} [options.dbPath]
+ * @param {number} [options.analysisVersion=1]
+ * @param {number} [options.limit] - Pages for the whole run, resumed batches included
+ * @param {number} [options.batchSize=200]
+ * @param {number} [options.workers] - Analysis threads (default min(4, cpus - 1)); 0 analyses in-process
+ * @param {string|false} [options.checkpointPath] - Default <db dir>/cache/analysis-run.checkpoint.json
+ * @param {boolean} [options.resume=true] - Continue an unfinished checkpoint for this version
+ * @param {Object} [options.database] - Open NewsDatabase to use instead of opening dbPath (not closed)
+ * @param {Function} [options.analyze] - analyzePage replacement; implies workers: 0
+ * @returns {Promise<Object>} analysePages-style summary plus batches, resumedFrom and stages
+ */
+async function analysePagesParallel({
+  dbPath,
+  analysisVersion = 1,
+  limit = null,
+  batchSize = 200,
+  workers = null,
+  checkpointPath = null,
+  resume = true,
+  dryRun = false,
+  verbose = false,
+  logger = console,
+  onProgress = null,
+  timeout = 5000,
+  analysisOptions = {},
+  gazetteerArtifactPath = null,
+  decompressionPoolSize = null,
+  collectHubSummary = false,
+  hubSummaryLimit = 100,
+  includeHubEvidence = false,
+  database = null,
+  analyze = null
+} = {}) {
+  if (!dbPath && !database) {
+    dbPath = path.join(findProjectRoot(__dirname), 'data', 'news.db');
+  }
+  const size = Math.max(1, Math.floor(toNumber(batchSize, 200)));
+  const analyzeInProcess = typeof analyze === 'function' ? analyze : analyzePage;
+  const cpuCount = Math.max(1, os.cpus()?.length || 1);
+  const workerCount = typeof analyze === 'function'
+    ? 0
+    : Math.max(0, Math.floor(toNumber(workers, Math.max(1, Math.min(4, cpuCount - 1)))));
+
+  const db = database || new (require('../db'))(dbPath);
+  const decompressPool = new DecompressionWorkerPool({ poolSize: decompressionPoolSize || undefined });
+  const bucketCache = new Map();
+  let analysisPool = null;
+
+  const checkpoint = new AnalysisCheckpoint(dryRun || checkpointPath === false
+    ? null
+    : (checkpointPath || (dbPath ? path.join(path.dirname(dbPath), 'cache', 'analysis-run.checkpoint.json') : null)));
+  const resumed = resume ? checkpoint.load(analysisVersion) : null;
+  checkpoint.start(analysisVersion, resumed);
+
+  const counters = {
+    processed: 0,
+    updated: 0,
+    placesInserted: 0,
+    hubsInserted: 0,
+    hubsUpdated: 0,
+    unknownInserted: 0,
+    skipped: 0,
+    failed: 0,
+    ...(resumed ? resumed.counters : {})
+  };
+  const meter = new StageMeter();
+  const runStartedAt = performance.now();
+  const hubLimit = Number.isFinite(Number(hubSummaryLimit)) && Number(hubSummaryLimit) >= 0 ? Number(hubSummaryLimit) : 0;
+  const hubAssignments = collectHubSummary === true ? [] : null;
+
+  const emitProgress = (extra = {}) => {
+    if (typeof onProgress !== 'function') return;
+    try {
+      const elapsedMs = performance.now() - runStartedAt;
+      onProgress({
+        ...counters,
+        total: null,
+        dryRun,
+        batches: checkpoint.state.batches,
+        lastAnalysisId: checkpoint.state.lastAnalysisId,
+        pagesPerSec: elapsedMs > 0 ? Math.round((meter.stages.read.pages / elapsedMs) * 10000) / 10 : null,
+        stages: meter.snapshot(),
+        ts: Date.now(),
+        ...extra
+      });
+    } catch (_) {
+      // ignore consumer errors
+    }
+  };
+
+  try {
+    try {
+      await decompressPool.initialize();
+    } catch (error) {
+      emit(logger, 'warn', '[analyse-pages] Failed to initialize decompression pool', verbose ? error : error?.message);
+    }
+
+    let gazetteer = null;
+    try {
+      gazetteer = loadGazetteerMatchers(db.db, {
+        artifactPath: gazetteerArtifactPath === false || !dbPath
+          ? null
+          : (gazetteerArtifactPath || path.join(path.dirname(dbPath), 'cache', 'gazetteer-matchers.bin')),
+        logger
+      });
+    } catch (error) {
+      emit(logger, 'warn', '[analyse-pages] Failed to build gazetteer matchers', verbose ? error : error?.message);
+    }
+
+    let xpathService = null;
+    let nonGeoTopicSlugs = new Set();
+    try {
+      xpathService = new ArticleXPathService({ db, logger });
+      nonGeoTopicSlugs = loadNonGeoTopicSlugs(db.db).slugs;
+    } catch (error) {
+      emit(logger, 'warn', '[analyse-pages] Analysis context unavailable', verbose ? error : error?.message);
+    }
+
+    if (workerCount > 0) {
+      analysisPool = new AnalysisWorkerPool({
+        poolSize: workerCount,
+        maxPending: workerCount * 2,
+        workerPath: path.join(__dirname, 'analysePagesWorker.js'),
+        workerData: {
+          dbPath,
+          gazetteerBuffer: sharedGazetteerBuffer(gazetteer, logger),
+          analysisVersion,
+          analysisOptions,
+          nonGeoTopicSlugs: Array.from(nonGeoTopicSlugs)
+        }
+      });
+      analysisPool.initialize();
+    }
+
+    const queries = withKeysetReader(db.createAnalysePagesCoreQueries(), db.db, logger);
+    const hasCompressionBucketSupport = queries.hasCompressionBucketSupport();
+    const getCompressionBucketById = queries.getCompressionBucketById;
+    const reader = createPendingRowReader(queries, {
+      analysisVersion,
+      batchSize: size,
+      limit: limit != null ? Math.max(0, limit - counters.processed) : null,
+      afterId: resumed ? resumed.lastAnalysisId : null,
+      skipIds: resumed ? resumed.failedIds : [],
+      dryRun
+    });
+    if (resumed) {
+      emit(logger, 'info', `[analyse-pages] Resuming v${analysisVersion} after analysis_id ${resumed.lastAnalysisId} (${counters.processed} already processed)`);
+    }
+
+    const runAnalysis = (row, html) => {
+      if (analysisPool && html) {
+        return analysisPool.analyze({ html, url: row.url, payload: rowPayload(row) });
+      }
+      return analyzeInProcess({
+        url: row.url,
+        ...rowPayload(row),
+        html,
+        gazetteer,
+        db: db.db,
+        targetVersion: analysisVersion,
+        nonGeoTopicSlugs,
+        xpathService,
+        analysisOptions
+      });
+    };
+
+    const analyseRow = async (row) => {
+      const loadStart = performance.now();
+      const htmlInfo = await loadHtmlForRow(row, {
+        decompressPool,
+        bucketCache,
+        hasCompressionBucketSupport,
+        getCompressionBucketById,
+        getCompressionDictionary: db.db ? (typeId, algorithm) => getTypeDictionary(db.db, typeId, algorithm) : null,
+        logger,
+        verbose
+      });
+      meter.record('load', loadStart, performance.now());
+      if (htmlInfo.error) {
+        counters.skipped += 1;
+        emit(logger, 'warn', `[analyse-pages] Failed to load HTML for ${row.url}`, verbose ? htmlInfo.error : htmlInfo.error?.message || htmlInfo.error);
+      }
+
+      const analyseStart = performance.now();
+      let analysisResult = null;
+      try {
+        analysisResult = await withTimeout(Promise.resolve(runAnalysis(row, htmlInfo.html)), timeout);
+      } catch (error) {
+        if (error?.timedOut) {
+          emit(logger, 'warn', `[analyse-pages] Timeout analyzing ${row.url} (${timeout}ms)`);
+          analysisResult = timeoutResult(performance.now() - analyseStart);
+        } else {
+          emit(logger, 'warn', `[analyse-pages] Failed to analyse ${row.url}`, verbose ? error : error?.message);
+          return { row, analysisResult: null };
+        }
+      } finally {
+        meter.record('analyse', analyseStart, performance.now());
+      }
+      annotateAnalysisMeta(analysisResult.analysis, analysisResult.deepAnalysis, htmlInfo);
+      return { row, analysisResult };
+    };
+
+    // Rows from one bucket share a chain so the bucket is decompressed once
+    const analyseBatch = (rows) => {
+      const chains = new Map();
+      for (const row of rows) {
+        const key = row.compression_bucket_id && row.bucket_entry_key ? `bucket:${row.compression_bucket_id}` : `row:${row.analysis_id}`;
+        if (!chains.has(key)) chains.set(key, []);
+        chains.get(key).push(row);
+      }
+      const results = new Map();
+      return Promise.all(Array.from(chains.values(), async (chain) => {
+        for (const row of chain) {
+          results.set(row, await analyseRow(row));
+        }
+      })).then(() => rows.map((row) => results.get(row)));
+    };
+
+    const persistBatch = (outcomes) => {
+      const batchCounts = { updated: 0, placesInserted: 0, unknownInserted: 0, hubsInserted: 0, hubsUpdated: 0 };
+      const failedIds = [];
+      const write = () => {
+        for (const { row, analysisResult } of outcomes) {
+          if (!analysisResult) {
+            failedIds.push(row.analysis_id);
+            continue;
+          }
+          const start = performance.now();
+          const counts = persistAnalysisResult({
+            queries,
+            row,
+            analysisResult,
+            analysisVersion,
+            shouldPersist: !dryRun,
+            hubAssignments,
+            hubLimit,
+            includeHubEvidence,
+            logger,
+            verbose
+          });
+          meter.record('persist', start, performance.now());
+          if (!counts.updated) failedIds.push(row.analysis_id);
+          for (const key of Object.keys(batchCounts)) batchCounts[key] += counts[key];
+        }
+      };
+      if (!dryRun && db.db && typeof db.db.transaction === 'function') {
+        db.db.transaction(write)();
+        flushSearchIndex();
+      } else {
+        write();
+      }
+      return { batchCounts, failedIds };
+    };
+
+    // With deferred search indexing, rows written by this batch are indexed
+    // in one FTS transaction instead of one trigger run per UPDATE
+    const flushSearchIndex = () => {
+      try {
+        const indexer = getSearchIndexer(db.db);
+        if (indexer.isDeferred()) indexer.flush({ limit: Math.max(size, indexer.batchSize) });
+      } catch (error) {
+        emit(logger, 'warn', '[analyse-pages] Failed to flush search index queue', error?.message);
+      }
+    };
+
+    for (;;) {
+      meter.beginBatch();
+      const readStart = performance.now();
+      const rows = reader.next();
+      if (!rows.length) break;
+      meter.record('read', readStart, performance.now(), rows.length);
+
+      const outcomes = await analyseBatch(rows);
+      const { batchCounts, failedIds } = persistBatch(outcomes);
+      meter.endBatch();
+
+      counters.processed += rows.length;
+      counters.failed += failedIds.length;
+      for (const key of Object.keys(batchCounts)) counters[key] += batchCounts[key];
+      for (const id of failedIds) reader.skip(id);
+      checkpoint.commit({ lastAnalysisId: rows[rows.length - 1].analysis_id, counters, failedIds });
+      if (bucketCache.size > MAX_CACHED_BUCKETS) bucketCache.clear();
+
+      emitProgress({ url: rows[rows.length - 1].url || null });
+    }
+
+    checkpoint.complete(counters);
+    const elapsedMs = performance.now() - runStartedAt;
+    emitProgress();
+
+    return {
+      analysed: counters.processed,
+      ...counters,
+      version: analysisVersion,
+      dryRun,
+      mode: reader.mode,
+      workers: workerCount,
+      batchSize: size,
+      batches: checkpoint.state.batches,
+      resumedFrom: resumed ? resumed.lastAnalysisId : null,
+      elapsedMs: Math.round(elapsedMs),
+      stages: meter.snapshot(),
+      hubAssignments: hubAssignments || undefined
+    };
+  } finally {
+    if (analysisPool) {
+      try { await analysisPool.shutdown(); } catch (_) {}
+    }
+    try { await decompressPool.shutdown(); } catch (_) {}
+    if (!database) {
+      try { db.close(); } catch (_) {}
+    }
+  }
+}
+
+module.exports = {
+  analysePagesParallel,
+  createPendingRowReader,
+  AnalysisCheckpoint,
+  StageMeter
+};
@@ -0,0 +1,96 @@
+'use strict';
+
+/**
+ * Worker thread for analyse-pages-parallel.js
+ *
+ * Runs analyzePage for one page per 'analyze' message (the AnalysisWorkerPool
+ * protocol). Each worker opens its own DB connection for the context and XPath
+ * lookups. It builds gazetteer matchers from the SharedArrayBuffer artifact in
+ * workerData, so no worker rebuilds them. Results go back to the parent
+ * thread, which does all the analysis writes.
+ *
+ * workerData: { dbPath, gazetteerBuffer, analysisVersion, analysisOptions, nonGeoTopicSlugs }
+ */
+
+const { parentPort, workerData, threadId } = require('worker_threads');
+const { analyzePage } = require('../intelligence/analysis/page-analyzer');
+const { gazetteerMatchersFromArtifact } = require('../intelligence/analysis/place-extraction');
+const { ArticleXPathService } = require('../services/ArticleXPathService');
+
+if (!parentPort) {
+  throw new Error('analyse-pages worker must be run as a worker thread');
+}
+
+const decoder = new TextDecoder('utf-8');
+const quietLogger = { log() {}, info() {}, debug() {}, warn: console.warn, error: console.error };
+let context = null;
+
+function getContext() {
+  if (!context) {
+    const NewsDatabase = require('../db');
+    const db = new NewsDatabase(workerData.dbPath);
+    context = {
+      db,
+      gazetteer: workerData.gazetteerBuffer ? gazetteerMatchersFromArtifact(workerData.gazetteerBuffer) : null,
+      xpathService: new ArticleXPathService({ db, logger: quietLogger }),
+      nonGeoTopicSlugs: new Set(workerData.nonGeoTopicSlugs || [])
+    };
+  }
+  return context;
+}
+
+// Only what the parent persists; preparation also carries DOM-derived state
+function toMessage(result) {
+  return {
+    analysis: result.analysis,
+    places: result.places,
+    hubCandidate: result.hubCandidate,
+    deepAnalysis: result.deepAnalysis,
+    preparation: result.preparation ? { articleRow: result.preparation.articleRow } : null,
+    timings: result.timings
+  };
+}
+
+parentPort.on('message', async (msg) => {
+  if (!msg || msg.type !== 'analyze' || !msg.taskId) {
+    return;
+  }
+
+  const start = Date.now();
+  try {
+    const { db, gazetteer, xpathService, nonGeoTopicSlugs } = getContext();
+    const bytes = new Uint8Array(msg.buffer, msg.byteOffset || 0, msg.byteLength);
+    const payload = msg.payload || {};
+    const result = await analyzePage({
+      url: msg.url,
+      title: payload.title || null,
+      section: payload.section || null,
+      articleRow: payload.articleRow || null,
+      fetchRow: payload.fetchRow || null,
+      html: decoder.decode(bytes),
+      gazetteer,
+      db: db.db,
+      targetVersion: workerData.analysisVersion,
+      nonGeoTopicSlugs,
+      xpathService,
+      analysisOptions: workerData.analysisOptions || {}
+    });
+
+    let message = toMessage(result);
+    try {
+      parentPort.postMessage({ type: 'analyzed', taskId: msg.taskId, threadId, result: message, durationMs: Date.now() - start });
+    } catch (_) {
+      // Not structured-clonable (functions, DOM nodes): fall back to what JSON keeps
+      message = JSON.parse(JSON.stringify(message));
+      parentPort.postMessage({ type: 'analyzed', taskId: msg.taskId, threadId, result: message, durationMs: Date.now() - start });
+    }
+  } catch (error) {
+    parentPort.postMessage({
+      type: 'error',
+      taskId: msg.taskId,
+      threadId,
+      error: error?.message || String(error),
+      durationMs: Date.now() - start
+    });
+  }
+});
@@ -20,6 +20,7 @@ const {
 } = require('news-crawler-db');
 const { awardMilestones } = require('./milestones');
 const { analysePages } = require('./analyse-pages-core');
+const { analysePagesParallel, AnalysisCheckpoint } = require('./analyse-pages-parallel');
 const { countArticlesNeedingAnalysis } = require('news-crawler-db');
 let NewsDatabase;
 
@@ -42,7 +43,11 @@ function createArgumentParser() {
     .add('--dry-run', 'Preview milestone awarding without writes', false, 'boolean')
     .add('--verbose', 'Enable verbose logging output', false, 'boolean')
     .add('--benchmark', 'Collect benchmark timings', false, 'boolean')
-    .add('--piechart', 'Emit pie chart SVG for benchmark breakdown', false, 'boolean');
+    .add('--piechart', 'Emit pie chart SVG for benchmark breakdown', false, 'boolean')
+    .add('--workers <number>', 'Analyse pages on N worker threads in resumable batches', undefined, 'int')
+    .add('--batch-size <number>', 'Pages per batch (and per transaction) with --workers', 200, 'int')
+    .add('--checkpoint <path>', 'Checkpoint file for --workers runs (defaults to <db dir>/cache/analysis-run.checkpoint.json)')
+    .add('--fresh', 'Ignore an unfinished --workers checkpoint and start over', false, 'boolean');
 
   const program = parser.getProgram();
   program.option('--no-progress-logging', 'Disable CLI progress logging');
@@ -595,11 +600,30 @@ async function runAnalysis(rawOptions = {}) {
   const verbose = boolArg(getOption(options, 'verbose'), false);
   const benchmark = boolArg(getOption(options, 'benchmark'), false);
   const piechart = boolArg(getOption(options, 'piechart'), false);
+  const workersRaw = getOption(options, 'workers');
+  const workers = workersRaw != null && workersRaw !== '' ? Number(workersRaw) : undefined;
+  const parallelWorkers = Number.isFinite(workers) && workers > 0 ? Math.floor(workers) : null;
+  const batchSizeRaw = getOption(options, 'batch-size', 'batchSize');
+  const batchSize = Number.isFinite(Number(batchSizeRaw)) && Number(batchSizeRaw) > 0 ? Number(batchSizeRaw) : 200;
+  const checkpointPath = getOption(options, 'checkpoint', 'checkpointPath')
+    || path.join(path.dirname(dbPath), 'cache', 'analysis-run.checkpoint.json');
+  const fresh = boolArg(getOption(options, 'fresh'), false);
   const progressLoggingEnabled = options.progressLogging !== false;
   const userProgressHandler = typeof options.onProgress === 'function' ? options.onProgress : null;
 
   // Determine analysis version - if not specified, auto-increment to force re-analysis
   let effectiveAnalysisVersion = safeAnalysisVersion;
+  if (!effectiveAnalysisVersion && parallelWorkers && !fresh && !dryRun && !skipPages) {
+    // An interrupted --workers run resumes at the version it was writing
+    const unfinished = new AnalysisCheckpoint(checkpointPath).load(null);
+    if (unfinished && Number.isFinite(unfinished.analysisVersion)) {
+      effectiveAnalysisVersion = unfinished.analysisVersion;
+      logInfo('Resuming unfinished page analysis', {
+        analysisVersion: effectiveAnalysisVersion,
+        lastAnalysisId: unfinished.lastAnalysisId
+      });
+    }
+  }
   if (!effectiveAnalysisVersion) {
     try {
       if (!NewsDatabase) {
@@ -636,7 +660,9 @@ async function runAnalysis(rawOptions = {}) {
       skipPages,
       skipDomains,
       dryRun,
-      verbose
+      verbose,
+      workers: parallelWorkers,
+      batchSize: parallelWorkers ? batchSize : null
     },
     steps: {}
   };
@@ -940,12 +966,17 @@ async function runAnalysis(rawOptions = {}) {
         : null;
       let summary = null;
       try {
-        summary = await analysePages({
+        const runPages = parallelWorkers ? analysePagesParallel : analysePages;
+        summary = await runPages({
           dbPath,
           analysisVersion: effectiveAnalysisVersion,
           limit: safeLimit,
           verbose,
           logger: console,
+          workers: parallelWorkers || undefined,
+          batchSize,
+          checkpointPath,
+          resume: !fresh,
           onProgress(payload) {
             const processedTotal = Number.isFinite(payload?.processed) ? payload.processed : null;
             const updatedTotal = Number.isFinite(payload?.updated) ? payload.updated : null;
@@ -54,7 +54,7 @@ const EVENT_CATEGORIES = {
   lifecycle: ['crawl:started', 'crawl:stopped', 'crawl:paused', 'crawl:resumed', 'crawl:completed', 'crawl:failed'],
   phase: ['crawl:phase:changed'],
   progress: ['crawl:progress'],
-  url: ['crawl:url:visited', 'crawl:url:queued', 'crawl:url:error', 'crawl:url:skipped', 'crawl:url:batch'],
+  url: ['crawl:url:visited', 'crawl:url:queued', 'crawl:url:error', 'crawl:url:skipped', 'crawl:url:batch', 'crawl:url:summary'],
   goal: ['crawl:goal:satisfied', 'crawl:goal:progress'],
   budget: ['crawl:budget:updated', 'crawl:budget:exhausted'],
   worker: ['crawl:worker:spawned', 'crawl:worker:stopped', 'crawl:worker:scaled'],
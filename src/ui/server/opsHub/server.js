@@ -18,6 +18,7 @@ const jsgui = require('jsgui3-html');
 
 const { OpsHubView } = require('./views/OpsHubView');
 const { wrapServerForCheck } = require('../utils/serverStartupCheck');
+const { getNodeRegistry } = require('../../../distributed/NodeRegistry');
 
 const DEFAULT_PORT = 3000;
 
@@ -123,6 +124,31 @@ async function getDashboardsWithStatus() {
   return results;
 }
 
+// ─────────────────────────────────────────────────────────────
+// Distributed Nodes - per-node throughput and shard steals
+// ─────────────────────────────────────────────────────────────
+
+async function getDistributedNodeStats({ registry = getNodeRegistry(), timeoutMs = 2000, fetchImpl = globalThis.fetch } = {}) {
+  const nodes = registry.listEnabledNodes();
+  return Promise.all(nodes.map(async (node) => {
+    try {
+      const res = await fetchImpl(`${node.workerUrl}/api/status`, { signal: AbortSignal.timeout(timeoutMs) });
+      if (!res.ok) return { nodeId: node.id, workerUrl: node.workerUrl, ok: false, error: `HTTP ${res.status}` };
+      const body = await res.json();
+      return {
+        nodeId: node.id,
+        workerUrl: node.workerUrl,
+        ok: true,
+        peerNodeId: body.nodeId || null,
+        running: body.running ?? null,
+        workStealing: body.workStealing || null
+      };
+    } catch (err) {
+      return { nodeId: node.id, workerUrl: node.workerUrl, ok: false, error: err.message };
+    }
+  }));
+}
+
 // ─────────────────────────────────────────────────────────────
 // Express App
 // ─────────────────────────────────────────────────────────────
@@ -153,6 +179,25 @@ app.get('/api/status', async (req, res) => {
   }
 });
 
+// API: Distributed crawl nodes (throughput, queued shards, steal counts)
+app.get('/api/distributed', async (req, res) => {
+  try {
+    const nodes = await getDistributedNodeStats();
+    const totals = nodes.reduce((acc, n) => {
+      const ws = n.workStealing;
+      if (ws) {
+        acc.throughputPerMin += ws.throughputPerMin || 0;
+        acc.steals += ws.steals || 0;
+        acc.shardsStolen += ws.shardsStolen || 0;
+      }
+      return acc;
+    }, { throughputPerMin: 0, steals: 0, shardsStolen: 0 });
+    res.json({ nodes, totals, timestamp: new Date().toISOString() });
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
 // API: Get raw registry (for clients)
 app.get('/api/registry', (req, res) => {
   res.json({ dashboards: DASHBOARDS });
@@ -192,5 +237,5 @@ if (require.main === module) {
   });
 }
 
-module.exports = { app, DASHBOARDS, checkServerHealth, getDashboardsWithStatus };
+module.exports = { app, DASHBOARDS, checkServerHealth, getDashboardsWithStatus, getDistributedNodeStats };
 
@@ -6,7 +6,7 @@ const {
   listArticlesWithContent,
   countArticlesWithContent
 } = require('news-crawler-db');
-const { decompress } = require('../../../shared/utils/compression');
+const { decompress, decompressAsync } = require('../../../shared/utils/compression');
 const { HtmlArticleExtractor } = require('../../../shared/utils/HtmlArticleExtractor');
 
 const extractor = new HtmlArticleExtractor({ minWordCount: 20 });
@@ -22,14 +22,26 @@ function decompressContent(contentBlob, algorithm = 'none') {
   }
 }
 
+// Request handlers use this one so large bodies decompress off the event loop
+async function decompressContentAsync(contentBlob, algorithm = 'none') {
+  if (!contentBlob) return null;
+  try {
+    const decompressed = await decompressAsync(contentBlob, algorithm);
+    return decompressed.toString('utf-8');
+  } catch (err) {
+    console.error('Decompression error:', err.message);
+    return null;
+  }
+}
+
 function extractArticleFromHtml(html, url) {
   return extractor.extract(html, url);
 }
 
-function getExtractedArticle(db, fetchId) {
+async function getExtractedArticle(db, fetchId) {
   const article = getArticleContentByFetchId(db, fetchId);
   if (!article) return null;
-  const html = decompressContent(article.contentBlob, article.compressionAlgorithm);
+  const html = await decompressContentAsync(article.contentBlob, article.compressionAlgorithm);
   if (!html) {
     return {
       ...article,
@@ -46,10 +58,10 @@ function getExtractedArticle(db, fetchId) {
   };
 }
 
-function getExtractedArticleByUrlId(db, urlId) {
+async function getExtractedArticleByUrlId(db, urlId) {
   const article = getArticleContentByUrlId(db, urlId);
   if (!article) return null;
-  const html = decompressContent(article.contentBlob, article.compressionAlgorithm);
+  const html = await decompressContentAsync(article.contentBlob, article.compressionAlgorithm);
   if (!html) {
     return {
       ...article,
@@ -70,6 +82,7 @@ module.exports = {
   getArticleContentByFetchId,
   getArticleContentByUrlId,
   decompressContent,
+  decompressContentAsync,
   extractArticleFromHtml,
   getExtractedArticle,
   getExtractedArticleByUrlId,
@@ -0,0 +1,87 @@
+'use strict';
+
+/**
+ * SimHashIndex Tests
+ *
+ * Multi-index lookups must return exactly what a brute-force scan returns.
+ */
+
+const { SimHashIndex, popcount32 } = require('../../../src/intelligence/analysis/similarity/SimHashIndex');
+
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+function fingerprint(lo, hi) {
+  const buffer = Buffer.alloc(8);
+  buffer.writeUInt32LE(lo >>> 0, 0);
+  buffer.writeUInt32LE(hi >>> 0, 4);
+  return buffer;
+}
+
+// Flip `bits` distinct random bit positions
+function perturb(buffer, bits, rand) {
+  const copy = Buffer.from(buffer);
+  const positions = new Set();
+  while (positions.size < bits) positions.add(rand() % 64);
+  for (const pos of positions) copy[pos >> 3] ^= 1 << (pos & 7);
+  return copy;
+}
+
+function bruteForce(entries, query, threshold) {
+  const qlo = query.readUInt32LE(0);
+  const qhi = query.readUInt32LE(4);
+  return entries
+    .map(([id, fp]) => ({ contentId: id, distance: popcount32(fp.readUInt32LE(0) ^ qlo) + popcount32(fp.readUInt32LE(4) ^ qhi) }))
+    .filter(r => r.distance <= threshold)
+    .sort((a, b) => a.contentId - b.contentId);
+}
+
+describe('SimHashIndex', () => {
+  const rand = mulberry32(7);
+  const entries = [];
+  for (let i = 0; i < 2000; i++) {
+    // Clusters of near-duplicates around a few hundred seeds
+    const base = i % 5 === 0 ? fingerprint(rand(), rand()) : perturb(entries[i - (i % 5)][1], i % 5, rand);
+    entries.push([i + 1, base]);
+  }
+
+  it('matches a brute-force scan at every radius', () => {
+    const index = new SimHashIndex({ initialCapacity: 16 });
+    for (const [id, fp] of entries) index.add(id, fp);
+
+    expect(index.size).toBe(2000);
+    for (let q = 0; q < 100; q++) {
+      const query = perturb(entries[(q * 37) % entries.length][1], q % 4, rand);
+      for (const threshold of [0, 1, 3, 6]) {
+        const found = index.search(query, { threshold }).sort((a, b) => a.contentId - b.contentId);
+        expect(found).toEqual(bruteForce(entries, query, threshold));
+      }
+    }
+  });
+
+  it('removes, replaces and reuses slots', () => {
+    const index = new SimHashIndex();
+    const [id, fp] = entries[0];
+    index.add(id, fp);
+    index.add(99, fp);
+    expect(index.get(id).equals(fp)).toBe(true);
+    expect(index.search(fp, { excludeId: 99 })).toEqual([{ contentId: id, distance: 0 }]);
+
+    expect(index.remove(id)).toBe(true);
+    expect(index.remove(id)).toBe(false);
+    expect(index.search(fp)).toEqual([{ contentId: 99, distance: 0 }]);
+
+    const moved = perturb(fp, 10, rand);
+    index.add(99, moved);
+    expect(index.search(fp)).toEqual([]);
+    expect(index.distance(99, fp)).toBe(10);
+    index.add(5, fp);
+    expect(index.getStats()).toMatchObject({ size: 2, capacity: 1024, tables: 4, blockBits: [16, 16, 16, 16] });
+  });
+});
@@ -0,0 +1,249 @@
+'use strict';
+
+/**
+ * SimilaritySnapshot / SimilarityIndexStore Tests
+ *
+ * A snapshot-backed index must answer exactly like the in-memory index it
+ * was built from, including after later adds and removes.
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { SimilarityIndex } = require('../../../src/intelligence/analysis/similarity/SimilarityIndex');
+const { SimilaritySnapshot } = require('../../../src/intelligence/analysis/similarity/SimilaritySnapshot');
+const { SimilarityIndexStore } = require('../../../src/intelligence/analysis/similarity/SimilarityIndexStore');
+const { DuplicateDetector } = require('../../../src/intelligence/analysis/similarity/DuplicateDetector');
+
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+// Random fingerprints in families that share SimHash bits and MinHash bands
+function buildItems(count, rand) {
+  const items = [];
+  for (let i = 0; i < count; i++) {
+    const family = items[i - (i % 4)];
+    const simhash = family ? Buffer.from(family.simhash) : Buffer.alloc(8);
+    const minhash = family ? Buffer.from(family.minhash) : Buffer.alloc(512);
+    if (family) {
+      simhash[rand() % 8] ^= 1 << (rand() % 8);
+      for (let k = 0; k < 200; k++) minhash[rand() % 512] = rand() & 0xFF;
+    } else {
+      for (let k = 0; k < 8; k++) simhash[k] = rand() & 0xFF;
+      for (let k = 0; k < 512; k++) minhash[k] = rand() & 0xFF;
+    }
+    items.push({ contentId: 1000 - i, simhash, minhash: i % 10 === 9 ? null : minhash });
+  }
+  return items;
+}
+
+function answers(index, items) {
+  return items.slice(0, 40).map(item => ({
+    dups: index.findDuplicates(item.simhash).map(r => [r.contentId, r.distance]).sort((a, b) => a[0] - b[0]),
+    similar: index.query(item.simhash, item.minhash, { limit: 50, minSimilarity: 0, excludeId: item.contentId })
+      .map(r => [r.contentId, r.similarity]).sort((a, b) => a[0] - b[0])
+  }));
+}
+
+describe('SimilaritySnapshot', () => {
+  const items = buildItems(400, mulberry32(11));
+
+  it('answers like the in-memory index it was built from', () => {
+    const memory = new SimilarityIndex();
+    for (const item of items) memory.add(item.contentId, item.simhash, item.minhash);
+
+    const loaded = new SimilarityIndex();
+    loaded.loadSnapshot(memory.toSnapshot());
+
+    expect(loaded.size).toBe(400);
+    expect(loaded.pendingSize).toBe(0);
+    expect(loaded.get(items[9].contentId)).toEqual({ simhash: items[9].simhash, minhash: null });
+    expect(loaded.get(items[3].contentId).minhash.equals(items[3].minhash)).toBe(true);
+    expect(answers(loaded, items)).toEqual(answers(memory, items));
+  });
+
+  it('layers adds and removes over the snapshot and compacts them in', () => {
+    const memory = new SimilarityIndex();
+    const loaded = new SimilarityIndex();
+    for (const item of items.slice(0, 300)) memory.add(item.contentId, item.simhash, item.minhash);
+    loaded.loadSnapshot(SimilaritySnapshot.fromBuffer(memory.toSnapshot()));
+
+    for (const item of items.slice(300)) {
+      memory.add(item.contentId, item.simhash, item.minhash);
+      loaded.add(item.contentId, item.simhash, item.minhash);
+    }
+    for (const item of items.slice(0, 40).filter((_, i) => i % 3 === 0)) {
+      expect(memory.remove(item.contentId)).toBe(true);
+      expect(loaded.remove(item.contentId)).toBe(true);
+      expect(loaded.remove(item.contentId)).toBe(false);
+    }
+    // Replacing a snapshot item moves it to the in-memory layer
+    memory.add(items[1].contentId, items[2].simhash, items[2].minhash);
+    loaded.add(items[1].contentId, items[2].simhash, items[2].minhash);
+
+    expect(loaded.size).toBe(memory.size);
+    expect(answers(loaded, items)).toEqual(answers(memory, items));
+
+    loaded.compact();
+    expect(loaded.pendingSize).toBe(0);
+    expect(loaded.getStats().snapshot).toMatchObject({ itemCount: memory.size, removed: 0 });
+    expect(answers(loaded, items)).toEqual(answers(memory, items));
+  });
+
+  it('rejects foreign or mismatched files', () => {
+    expect(() => SimilaritySnapshot.fromBuffer(Buffer.from('not a snapshot at all, definitely not'))).toThrow('Not a similarity index snapshot');
+    const bytes = new SimilarityIndex().toSnapshot();
+    expect(() => new SimilarityIndex({ numBands: 8, rowsPerBand: 16 }).loadSnapshot(bytes)).toThrow('does not match');
+  });
+});
+
+describe('SimilarityIndexStore', () => {
+  let dir;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'similarity-store-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  it('replays the append log on load, ignoring a torn record', () => {
+    const items = buildItems(20, mulberry32(5));
+    const file = path.join(dir, 'index.simsnap');
+    const logger = { warn: jest.fn(), log: () => {}, error: () => {} };
+
+    const index = new SimilarityIndex();
+    const store = new SimilarityIndexStore({ path: file, index, compactEvery: 1000, logger });
+    for (const item of items.slice(0, 10)) index.add(item.contentId, item.simhash, item.minhash);
+    store.compact();
+    for (const item of items.slice(10)) {
+      index.add(item.contentId, item.simhash, item.minhash);
+      store.append(item.contentId, item.simhash, item.minhash);
+    }
+    index.remove(items[0].contentId);
+    store.appendRemove(items[0].contentId);
+    store.close();
+    fs.appendFileSync(`${file}.log`, Buffer.alloc(7));
+
+    const reopened = new SimilarityIndex();
+    const result = new SimilarityIndexStore({ path: file, index: reopened, logger }).load();
+    expect(result).toMatchObject({ loaded: true, snapshotItems: 10, replayed: 11 });
+    expect(logger.warn).toHaveBeenCalledTimes(1);
+    expect(reopened.size).toBe(19);
+    expect(reopened.has(items[0].contentId)).toBe(false);
+    expect(reopened.get(items[15].contentId).simhash.equals(items[15].simhash)).toBe(true);
+  });
+
+  it('records the DB watermark in the header and advances it with the log', () => {
+    const items = buildItems(6, mulberry32(11));
+    const file = path.join(dir, 'index.simsnap');
+    const index = new SimilarityIndex();
+    const store = new SimilarityIndexStore({ path: file, index });
+    for (const item of items.slice(0, 4)) index.add(item.contentId, item.simhash, item.minhash);
+    store.compact({ rows: 40, maxContentId: 5000 });
+    for (const item of items.slice(4)) {
+      index.add(item.contentId, item.simhash, item.minhash);
+      store.append(item.contentId, item.simhash, item.minhash);
+    }
+    store.close();
+
+    const snapshot = SimilaritySnapshot.load(file);
+    expect(snapshot.sourceRows).toBe(40);
+    expect(snapshot.sourceMaxId).toBe(5000);
+    const result = new SimilarityIndexStore({ path: file, index: new SimilarityIndex() }).load();
+    expect(result.source).toEqual({ rows: 42, maxContentId: 5000 });
+  });
+
+  it('compacts once the log reaches compactEvery', () => {
+    const items = buildItems(5, mulberry32(9));
+    const file = path.join(dir, 'nested', 'index.simsnap');
+    const index = new SimilarityIndex();
+    const store = new SimilarityIndexStore({ path: file, index, compactEvery: 3 });
+
+    for (const item of items) {
+      index.add(item.contentId, item.simhash, item.minhash);
+      store.append(item.contentId, item.simhash, item.minhash);
+    }
+
+    expect(store.logRecords).toBe(2);
+    expect(index.snapshot.count).toBe(3);
+    expect(index.pendingSize).toBe(2);
+    store.close();
+    expect(fs.statSync(`${file}.log`).size).toBe(2 * store.recordBytes);
+  });
+});
+
+describe('DuplicateDetector snapshot freshness', () => {
+  let dir;
+  const logger = { log: () => {}, warn: jest.fn(), error: () => {} };
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'similarity-detector-'));
+    logger.warn.mockClear();
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  function createAdapter(items) {
+    const rows = new Map(items.map(item => [item.contentId, item]));
+    return {
+      rows,
+      getAllFingerprints: jest.fn(() => Array.from(rows.values())),
+      getStats: () => ({
+        totalFingerprints: rows.size,
+        maxContentId: rows.size ? Math.max(...rows.keys()) : null
+      })
+    };
+  }
+
+  it('trusts a snapshot that matches the database', async () => {
+    const items = buildItems(8, mulberry32(21));
+    const snapshotPath = path.join(dir, 'index.simsnap');
+    const adapter = createAdapter(items);
+    const first = new DuplicateDetector({ similarityAdapter: adapter, snapshotPath, logger });
+    await first.initialize();
+    first.close();
+
+    adapter.getAllFingerprints.mockClear();
+    const second = new DuplicateDetector({ similarityAdapter: adapter, snapshotPath, logger });
+    expect(await second.initialize()).toBe(8);
+    expect(adapter.getAllFingerprints).not.toHaveBeenCalled();
+    second.close();
+  });
+
+  it('rebuilds when fingerprints were written behind the snapshot', async () => {
+    const items = buildItems(8, mulberry32(22));
+    const snapshotPath = path.join(dir, 'index.simsnap');
+    const adapter = createAdapter(items.slice(0, 6));
+    const first = new DuplicateDetector({ similarityAdapter: adapter, snapshotPath, logger });
+    await first.initialize();
+    first.close();
+
+    // Another writer adds fingerprints, and one is replaced under the same count
+    for (const item of items.slice(6)) adapter.rows.set(item.contentId, item);
+    const second = new DuplicateDetector({ similarityAdapter: adapter, snapshotPath, logger });
+    expect(await second.initialize()).toBe(8);
+    expect(logger.warn).toHaveBeenCalledTimes(1);
+    expect(second.index.has(items[7].contentId)).toBe(true);
+    second.close();
+
+    // Same row count, different newest id
+    adapter.rows.delete(items[0].contentId);
+    adapter.rows.set(2000, { ...items[0], contentId: 2000 });
+    const third = new DuplicateDetector({ similarityAdapter: adapter, snapshotPath, logger });
+    await third.initialize();
+    expect(logger.warn).toHaveBeenCalledTimes(2);
+    expect(third.index.has(2000)).toBe(true);
+    expect(third.index.has(items[0].contentId)).toBe(false);
+    third.close();
+  });
+});
@@ -0,0 +1,149 @@
+'use strict';
+
+/**
+ * ClusterIndex Tests
+ *
+ * Candidate retrieval for StoryClustering.findMatchingCluster.
+ */
+
+const { ClusterIndex } = require('../../../src/intelligence/analysis/topics/ClusterIndex');
+const { StoryClustering, calculateEntityOverlap } = require('../../../src/intelligence/analysis/topics/StoryClustering');
+
+function simhash(hex) {
+  return Buffer.from(hex, 'hex');
+}
+
+// Differs from `base` in `bits` low-order bits of the first byte
+function flip(base, bits) {
+  const copy = Buffer.from(base);
+  copy[0] ^= (1 << bits) - 1;
+  return copy;
+}
+
+describe('ClusterIndex', () => {
+  const fed = simhash('0123456789abcdef');
+  const sport = simhash('fedcba9876543210');
+
+  it('returns only clusters with a representative within range', () => {
+    const index = new ClusterIndex({ maxHammingDistance: 3 });
+    index.upsertCluster({ id: 1, headline: 'Fed', articleIds: [10, 11] });
+    index.upsertCluster({ id: 2, headline: 'Sport', articleIds: [20] });
+    index.addRepresentative(1, 10, { simhash: fed });
+    index.addRepresentative(1, 11, { simhash: flip(fed, 2) });
+    index.addRepresentative(2, 20, { simhash: sport.toString('hex') });
+
+    expect([...index.candidatesBySimhash(flip(fed, 3))]).toEqual([[1, 1]]);
+    expect(index.candidatesBySimhash(flip(sport, 4)).size).toBe(0);
+    expect(index.candidatesBySimhash(null).size).toBe(0);
+
+    index.removeCluster(1);
+    expect(index.candidatesBySimhash(fed).size).toBe(0);
+    expect(index.getStats()).toMatchObject({ clusters: 1, representatives: 1 });
+  });
+
+  it('counts entity overlap like calculateEntityOverlap', () => {
+    const index = new ClusterIndex();
+    const clusterEntities = [
+      [{ text: 'Jerome Powell' }, { text: 'Federal Reserve' }],
+      [{ entity_text: 'jerome powell ' }, { text: 'Washington' }]
+    ];
+    index.upsertCluster({ id: 7, articleIds: [1, 2] });
+    clusterEntities.forEach((entities, i) => index.addRepresentative(7, i + 1, { entities }));
+
+    const article = [{ text: 'JEROME POWELL' }, { text: 'Washington' }, { text: 'Nasdaq' }];
+    const expected = calculateEntityOverlap(article, clusterEntities.flat());
+    const overlap = index.entityOverlaps(article).get(7);
+
+    expect(overlap.count).toBe(expected.count);
+    expect(overlap.shared.sort()).toEqual(expected.shared.sort());
+  });
+
+  it('caps representatives per cluster and prunes by last update', () => {
+    const index = new ClusterIndex({ representatives: 2 });
+    index.upsertCluster({ id: 1, articleIds: [], lastUpdated: new Date('2025-01-01T00:00:00Z') });
+    index.upsertCluster({ id: 2, articleIds: [], lastUpdated: new Date('2025-01-03T00:00:00Z') });
+    expect(index.addRepresentative(1, 1, { simhash: fed })).toBe(true);
+    expect(index.addRepresentative(1, 2, { simhash: fed })).toBe(true);
+    expect(index.addRepresentative(1, 3, { simhash: fed })).toBe(false);
+    expect(index.get(1).articleIds.size).toBe(3);
+
+    index.touch(2, 9, new Date('2025-01-05T00:00:00Z'));
+    expect(index.pruneBefore(new Date('2025-01-04T00:00:00Z'))).toBe(1);
+    expect(index.get(1)).toBeUndefined();
+    expect(index.get(2).articleIds.has(9)).toBe(true);
+  });
+});
+
+describe('StoryClustering.findMatchingCluster', () => {
+  const story = simhash('0123456789abcdef');
+  const fingerprints = { 1: story, 2: flip(story, 1), 3: simhash('fedcba9876543210') };
+  const entities = {
+    1: [{ text: 'Jerome Powell', type: 'PERSON' }],
+    2: [{ text: 'Federal Reserve', type: 'ORG' }],
+    3: [{ text: 'Jerome Powell', type: 'PERSON' }]
+  };
+
+  function build() {
+    const similarityAdapter = { getFingerprint: jest.fn(id => (fingerprints[id] ? { simhash: fingerprints[id] } : null)) };
+    const tagAdapter = { getEntities: jest.fn(id => entities[id] || []) };
+    const topicAdapter = {
+      getStoryClusters: jest.fn().mockReturnValue([
+        { id: 100, headline: 'Fed raises rates', article_ids: '[1, 2]', last_updated: '2025-01-01T12:00:00Z', is_active: 1 },
+        { id: 200, headline: 'Unrelated', article_ids: '[3]', last_updated: '2025-01-01T12:00:00Z', is_active: 1 }
+      ]),
+      getStoryCluster: jest.fn(id => ({ id, article_ids: id === 100 ? '[1, 2]' : '[3]' })),
+      updateStoryCluster: jest.fn()
+    };
+    const clustering = new StoryClustering({
+      topicAdapter,
+      similarityAdapter,
+      tagAdapter,
+      logger: { log: jest.fn(), error: jest.fn() }
+    });
+    return { clustering, similarityAdapter, tagAdapter, topicAdapter };
+  }
+
+  it('scores only indexed candidates without per-cluster DB reads', async () => {
+    const { clustering, similarityAdapter, tagAdapter, topicAdapter } = build();
+    await clustering.initialize();
+    const readsAfterInit = similarityAdapter.getFingerprint.mock.calls.length + tagAdapter.getEntities.mock.calls.length;
+
+    const match = await clustering.findMatchingCluster({
+      id: 50,
+      simhash: flip(story, 2),
+      entities: [{ text: 'Federal Reserve' }],
+      publishedAt: '2025-01-02T00:00:00Z'
+    });
+
+    expect(match).toMatchObject({ hammingDistance: 1, sharedEntities: ['federal reserve'] });
+    expect(match.cluster).toMatchObject({ id: 100, headline: 'Fed raises rates' });
+    expect(similarityAdapter.getFingerprint.mock.calls.length + tagAdapter.getEntities.mock.calls.length).toBe(readsAfterInit);
+    expect(topicAdapter.getStoryClusters).toHaveBeenCalledTimes(1);
+  });
+
+  it('applies the time window and entity requirement to candidates', async () => {
+    const { clustering } = build();
+    await clustering.initialize();
+
+    expect(await clustering.findMatchingCluster({
+      id: 51, simhash: story, entities: [{ text: 'Jerome Powell' }], publishedAt: '2025-01-10T00:00:00Z'
+    })).toBeNull();
+    expect(await clustering.findMatchingCluster({
+      id: 52, simhash: story, entities: [{ text: 'Nobody' }], publishedAt: '2025-01-02T00:00:00Z'
+    })).toBeNull();
+  });
+
+  it('keeps the index current as articles join clusters', async () => {
+    const { clustering } = build();
+    await clustering.initialize();
+    fingerprints[60] = simhash('00000000ffffffff');
+    entities[60] = [{ text: 'Jerome Powell' }];
+
+    clustering.addToCluster(100, 60);
+    const match = await clustering.findMatchingCluster({
+      id: 61, simhash: simhash('01000000ffffffff'), entities: [{ text: 'Jerome Powell' }], publishedAt: new Date()
+    });
+    expect(match.cluster.id).toBe(100);
+    expect(match.cluster.articleIds.has(60)).toBe(true);
+  });
+});
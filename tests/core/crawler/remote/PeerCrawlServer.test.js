@@ -5,7 +5,7 @@ const assert = require('node:assert/strict');
 const EventEmitter = require('events');
 
 const { createPeerServer, createPeerApp } = require('../../../../src/core/crawler/remote/PeerCrawlServer');
-const { MessageTypes, createAnnouncement } = require('../../../../src/core/crawler/remote/PeerProtocol');
+const { MessageTypes, createAnnouncement, createShardStealRequest } = require('../../../../src/core/crawler/remote/PeerProtocol');
 
 // ── Test helpers ────────────────────────────────────────────
 
@@ -73,6 +73,31 @@ describe('PeerCrawlServer', () => {
       assert.ok(orchestrator.nodeId);
       assert.equal(orchestrator.workers.size, 1);
     });
+
+    it('hands over only unstarted host shards and adopts stolen ones', () => {
+      const factory = (domain, opts) => createMockCrawler(domain, opts);
+      const victim = createPeerApp({
+        crawlerFactory: factory,
+        domains: ['a.com', 'b.com', { domain: 'c.com', seedUrls: ['https://c.com/x'] }, 'd.com'],
+      }).orchestrator;
+      victim.getWorker('a.com').state = 'running';
+
+      const shards = victim.takeShards(4);
+      assert.equal(shards.length, 1); // half of the three idle shards
+      assert.ok(!shards.some(s => s.domain === 'a.com'));
+      assert.ok(!victim.workers.has(shards[0].domain));
+
+      const thief = createPeerApp({ crawlerFactory: factory, maxConcurrent: 1 }).orchestrator;
+      const accepted = thief.acceptShards([...shards, { domain: 'c.com', seedUrls: ['https://c.com/x'] }]);
+      assert.equal(accepted[0].state, 'running');
+      assert.equal(accepted[accepted.length - 1].state, 'idle');
+      assert.deepEqual(thief.getWorker('c.com').pendingSeeds, ['https://c.com/x']);
+
+      const stats = victim.getWorkStealingStats();
+      assert.equal(stats.shardsGiven, 1);
+      assert.equal(stats.runningShards, 1);
+      assert.equal(stats.queuedShards, 2);
+    });
   });
 
   describe('HTTP API', () => {
@@ -226,6 +251,23 @@ describe('PeerCrawlServer', () => {
       assert.ok(body.peerCount >= 2);
     });
 
+    it('POST /api/shards/steal returns a shard transfer', async () => {
+      const res = await fetch(`${baseUrl}/api/shards/steal`, {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify(createShardStealRequest({ nodeId: 'idle-peer', maxShards: 1 })),
+      });
+      const body = await res.json();
+
+      assert.equal(body.type, MessageTypes.SHARD_TRANSFER);
+      assert.equal(body.targetNodeId, 'idle-peer');
+      assert.ok(Array.isArray(body.shards));
+
+      const statusRes = await fetch(`${baseUrl}/api/status`);
+      const status = await statusRes.json();
+      assert.equal(status.workStealing.stealRequestsServed, 1);
+    });
+
     it('GET /api/config returns config', async () => {
       const res = await fetch(`${baseUrl}/api/config`);
       const body = await res.json();
@@ -0,0 +1,238 @@
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const os = require('os');
+const CheckpointJournal = require('../../../src/core/crawler/checkpoint/CheckpointJournal');
+const CheckpointManager = require('../../../src/core/crawler/checkpoint/CheckpointManager');
+const { CrawlOrchestrator } = require('../../../src/core/crawler/orchestration');
+const { CrawlContext } = require('../../../src/core/crawler/context');
+const QueueManager = require('../../../src/core/crawler/QueueManager');
+const { CrawlerState } = require('../../../src/core/crawler/CrawlerState');
+
+function checkpoint(jobId, extra = {}) {
+  return { version: '1.0', timestamp: new Date().toISOString(), jobId, context: { jobId }, ...extra };
+}
+
+describe('CheckpointJournal', () => {
+  let tempDir;
+
+  beforeEach(() => {
+    tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'checkpoint-journal-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  });
+
+  it('writes only the changes since the previous commit', () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job' });
+    for (let i = 0; i < 1000; i++) {
+      journal.recordEnqueued({ url: `https://a.test/${i}`, depth: 1, type: 'nav', priority: i });
+    }
+    const first = journal.commit({ pages: 0 });
+    expect(first).toMatchObject({ seq: 1, records: 1000 });
+
+    journal.recordDequeued('https://a.test/0');
+    journal.recordVisited('https://a.test/0');
+    const second = journal.commit({ pages: 1 });
+    expect(second).toMatchObject({ seq: 2, records: 2 });
+    expect(second.bytes).toBeLessThan(first.bytes / 100);
+  });
+
+  it('restores frontier, visited set and latest meta by streaming replay', async () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job', writeBatchSize: 2 });
+    journal.recordEnqueued({ url: 'https://a.test/1', depth: 0 });
+    journal.recordEnqueued({ url: 'https://a.test/2', depth: 1, priority: 5 });
+    journal.recordEnqueued({ url: 'https://a.test/3', depth: 1 });
+    journal.commit({ pages: 0 });
+    journal.recordDequeued('https://a.test/1');
+    journal.recordVisited('https://a.test/1');
+    journal.recordEnqueued({ url: 'https://a.test/2', depth: 1, priority: 1 });
+    journal.commit({ pages: 1 });
+    // Simulate a crash mid-append
+    fs.appendFileSync(journal.livePath, '{"t":"v","u":"https://a.te');
+
+    const restored = await new CheckpointJournal({ dir: tempDir, name: 'job' }).restore();
+    expect(restored.meta).toEqual({ pages: 1 });
+    expect(restored.seq).toBe(2);
+    expect(restored.frontier).toEqual([
+      { url: 'https://a.test/3', depth: 1, type: null, priority: null },
+      { url: 'https://a.test/2', depth: 1, type: null, priority: 1 }
+    ]);
+    expect([...restored.visited]).toEqual(['https://a.test/1']);
+    expect(restored.corruptLines).toBe(1);
+  });
+
+  it('applies only committed deltas, and a resumed journal does not revive the rest', async () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job', writeBatchSize: 1 });
+    journal.recordEnqueued({ url: 'https://a.test/1' });
+    journal.commit({ pages: 0 });
+    // Reaches the live segment (batch size 1) but the crash comes before its commit
+    journal.recordVisited('https://a.test/1');
+    journal.recordEnqueued({ url: 'https://a.test/2' });
+    expect(fs.readFileSync(journal.livePath, 'utf8')).toContain('https://a.test/2');
+
+    const resumed = new CheckpointJournal({ dir: tempDir, name: 'job' });
+    const restored = await resumed.restore();
+    expect(restored).toMatchObject({ meta: { pages: 0 }, discarded: 2 });
+    expect(restored.frontier.map((item) => item.url)).toEqual(['https://a.test/1']);
+    expect(restored.visited.size).toBe(0);
+
+    resumed.recordEnqueued({ url: 'https://a.test/3' });
+    resumed.commit({ pages: 0 });
+    const again = await new CheckpointJournal({ dir: tempDir, name: 'job' }).restore();
+    expect(again.frontier.map((item) => item.url)).toEqual(['https://a.test/1', 'https://a.test/3']);
+    expect(again.visited.size).toBe(0);
+  });
+
+  it('keeps an uncommitted tail across compaction until its commit', async () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job', compactAfterRecords: 0 });
+    journal.recordVisited('https://a.test/1');
+    journal.commit({ pages: 1 });
+    journal.recordVisited('https://a.test/2');
+    await journal.compact();
+    expect((await journal.restore()).visited.size).toBe(1);
+
+    journal.recordVisited('https://a.test/3');
+    journal.commit({ pages: 3 });
+    const restored = await journal.restore();
+    expect(restored.meta).toEqual({ pages: 3 });
+    expect([...restored.visited]).toEqual(['https://a.test/1', 'https://a.test/3']);
+  });
+
+  it('compacts deltas into a base snapshot while new deltas keep appending', async () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job', compactAfterRecords: 0 });
+    for (let i = 0; i < 50; i++) {
+      journal.recordEnqueued({ url: `https://a.test/${i}` });
+      if (i % 2 === 0) {
+        journal.recordDequeued(`https://a.test/${i}`);
+        journal.recordVisited(`https://a.test/${i}`);
+      }
+    }
+    journal.commit({ pages: 25 });
+
+    const compaction = journal.compact();
+    journal.recordVisited('https://a.test/1');
+    journal.recordDequeued('https://a.test/1');
+    journal.commit({ pages: 26 });
+    await expect(compaction).resolves.toMatchObject({ frontier: 25, visited: 25 });
+
+    expect(journal.getStats()).toMatchObject({ compactions: 1, sealedSegments: 0 });
+    const baseLines = fs.readFileSync(journal.basePath, 'utf8').trim().split('\n');
+    expect(baseLines).toHaveLength(51);
+
+    const restored = await journal.restore();
+    expect(restored.meta).toEqual({ pages: 26 });
+    expect(restored.frontier).toHaveLength(24);
+    expect(restored.visited.size).toBe(26);
+  });
+
+  it('compacts in the background once enough deltas pile up', async () => {
+    const journal = new CheckpointJournal({ dir: tempDir, name: 'job', compactAfterRecords: 10 });
+    const compacted = new Promise((resolve) => journal.once('compacted', resolve));
+    for (let i = 0; i < 12; i++) journal.recordVisited(`https://a.test/${i}`);
+    journal.commit({ pages: 12 });
+    await expect(compacted).resolves.toMatchObject({ visited: 12 });
+    expect(fs.existsSync(journal.basePath)).toBe(true);
+  });
+});
+
+describe('CheckpointManager journal mode', () => {
+  let tempDir;
+
+  beforeEach(() => {
+    tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'checkpoint-delta-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  });
+
+  it('commits saves to the job journal and restores them', async () => {
+    const manager = new CheckpointManager({ checkpointDir: tempDir, prefix: 'cp', journal: { compactAfterRecords: 0 } });
+    const barrier = jest.fn();
+    manager.addSaveBarrier(barrier);
+    const journal = manager.journalFor('job1');
+    journal.recordEnqueued({ url: 'https://a.test/next', depth: 2 });
+    journal.recordVisited('https://a.test/');
+
+    manager.save(checkpoint('job1', { seenUrls: { bits: 'x'.repeat(1000) } }));
+    expect(barrier).toHaveBeenCalledTimes(1);
+    expect(manager.list('job1')).toHaveLength(0);
+
+    const restored = await new CheckpointManager({ checkpointDir: tempDir, prefix: 'cp', journal: true }).restore('job1');
+    expect(restored.checkpoint).toMatchObject({ jobId: 'job1', context: { jobId: 'job1' } });
+    expect(restored.checkpoint.seenUrls).toBeUndefined();
+    expect(restored.frontier).toEqual([expect.objectContaining({ url: 'https://a.test/next', depth: 2 })]);
+    expect(restored.visited.has('https://a.test/')).toBe(true);
+
+    expect(await manager.restore('other')).toBeNull();
+    expect(manager.deleteForJob('job1')).toBe(1);
+    expect(await manager.restore('job1')).toBeNull();
+  });
+});
+
+describe('resuming a crawl from its checkpoint journal', () => {
+  let tempDir;
+
+  beforeEach(() => {
+    tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'checkpoint-resume-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  });
+
+  function createCrawler() {
+    const state = new CrawlerState();
+    const urlEligibilityService = {
+      evaluate: ({ url }) => (state.visited.has(url)
+        ? { status: 'drop', reason: 'visited', normalized: url }
+        : { status: 'allow', normalized: url, kind: 'article', queueKey: url })
+    };
+    const queue = new QueueManager({
+      urlEligibilityService,
+      usePriorityQueue: false,
+      isTotalPrioritisationEnabled: () => false
+    });
+    return { state, queue, urlEligibilityService };
+  }
+
+  async function crawlOne(crawler) {
+    const { item } = await crawler.queue.pullNext();
+    crawler.state.addVisited(item.url);
+    return item.url;
+  }
+
+  it('replays the committed frontier and visited set into a fresh queue and state', async () => {
+    const crawler = createCrawler();
+    const orchestrator = new CrawlOrchestrator({ crawler, context: CrawlContext.create({ jobId: 'job1' }) });
+    new CheckpointManager({ checkpointDir: tempDir, prefix: 'cp', journal: { compactAfterRecords: 0 } }).attach(orchestrator);
+    const saved = new Promise((resolve) => orchestrator.once('checkpoint:saved', resolve));
+
+    for (const n of [1, 2, 3, 4]) crawler.queue.enqueue({ url: `https://a.test/${n}`, depth: 1, type: 'article' });
+    expect(await crawlOne(crawler)).toBe('https://a.test/1');
+    orchestrator._saveCheckpoint();
+    await saved;
+    // Progress after the last checkpoint is lost with the crash
+    await crawlOne(crawler);
+    crawler.queue.enqueue({ url: 'https://a.test/5', depth: 2, type: 'article' });
+    crawler.queue.journal.flush();
+
+    const resumedCrawler = createCrawler();
+    const manager = new CheckpointManager({ checkpointDir: tempDir, prefix: 'cp', journal: true });
+    const resumed = await CrawlOrchestrator.resume(manager, 'job1', { crawler: resumedCrawler });
+
+    expect(resumed.context.jobId).toBe('job1');
+    expect([...resumedCrawler.state.visited]).toEqual(['https://a.test/1']);
+    expect(resumedCrawler.queue.size()).toBe(3);
+    expect(await crawlOne(resumedCrawler)).toBe('https://a.test/2');
+    // Re-enqueued items were not journaled again; new progress still is
+    expect(manager.journalFor('job1').getStats()).toMatchObject({ pendingRecords: 2 });
+    resumed.stop();
+    orchestrator.stop();
+
+    expect(await CrawlOrchestrator.resume(manager, 'missing', { crawler: createCrawler() })).toBeNull();
+  });
+});
@@ -0,0 +1,118 @@
+'use strict';
+
+const EventEmitter = require('events');
+const { AdaptiveConcurrencyLimiter } = require('../../../src/core/crawler/concurrency/AdaptiveConcurrencyLimiter');
+const ConcurrencyController = require('../../../src/core/crawler/concurrency/ConcurrencyController');
+
+describe('AdaptiveConcurrencyLimiter', () => {
+  const quiet = { lagProvider: () => 0, heapProvider: () => 0.2 };
+
+  // Fill the limit, then finish every request with the given latency
+  function runWindow(limiter, host, latencyMs, { status = 200, requests = 20 } = {}) {
+    let done = 0;
+    while (done < requests) {
+      const leased = [];
+      while (leased.length < requests - done && limiter.tryAcquire(host)) leased.push(host);
+      if (leased.length === 0) break;
+      for (const h of leased) limiter.release(h, { latencyMs, status });
+      done += leased.length;
+    }
+    return limiter.evaluate();
+  }
+
+  it('adds one per healthy window and cuts on latency growth', () => {
+    const limiter = new AdaptiveConcurrencyLimiter({ ...quiet, initialLimit: 4, maxHostLimit: 32, initialHostLimit: 32 });
+
+    runWindow(limiter, 'a.test', 100);
+    runWindow(limiter, 'a.test', 110);
+    expect(limiter.getLimit()).toBe(6);
+
+    const decisions = runWindow(limiter, 'a.test', 400);
+    const global = decisions.find(d => d.scope === 'global');
+    expect(global).toMatchObject({ from: 6, to: 4 });
+    expect(global.reason).toMatch(/p99 \d+ms > 2x baseline/);
+    expect(global.signals).toMatchObject({ samples: 20, rateLimits: 0 });
+  });
+
+  it('does not grow a limit that is not being used', () => {
+    const limiter = new AdaptiveConcurrencyLimiter({ ...quiet, initialLimit: 8 });
+    for (let i = 0; i < 12; i++) limiter.recordLatency('a.test', 50);
+    expect(limiter.evaluate()).toEqual([]);
+    expect(limiter.getLimit()).toBe(8);
+  });
+
+  it('halves the host limit on 429s, including via RateLimitTracker events', () => {
+    const tracker = new EventEmitter();
+    const limiter = new AdaptiveConcurrencyLimiter({ ...quiet, initialLimit: 16, maxHostLimit: 8, initialHostLimit: 8, rateLimitTracker: tracker });
+
+    expect(limiter.tryAcquire('slow.test')).toBe(true);
+    limiter.release('slow.test', { latencyMs: 200, status: 429 });
+    tracker.emit('rateLimit', { domain: 'slow.test', statusCode: 429, interval: 2000 });
+    const decisions = limiter.evaluate();
+
+    expect(limiter.getLimit('slow.test')).toBe(4);
+    expect(limiter.getLimit()).toBe(8);
+    expect(decisions.find(d => d.host === 'slow.test').reason).toBe('429 x2');
+    expect(limiter.getLimit('fast.test')).toBe(8);
+
+    limiter.stop();
+    expect(tracker.listenerCount('rateLimit')).toBe(0);
+  });
+
+  it('backs off on event-loop lag and heap pressure', () => {
+    let lag = 250;
+    let heap = 0.2;
+    const limiter = new AdaptiveConcurrencyLimiter({ initialLimit: 8, lagProvider: () => lag, heapProvider: () => heap });
+    expect(limiter.evaluate()[0]).toMatchObject({ from: 8, to: 6, reason: 'event-loop lag 250ms > 100ms' });
+    lag = 5;
+    heap = 0.95;
+    expect(limiter.evaluate()[0].reason).toBe('heap 95% > 85%');
+    expect(limiter.getLimit()).toBe(4);
+  });
+
+  it('enforces global and per-host limits in tryAcquire', () => {
+    const limiter = new AdaptiveConcurrencyLimiter({ ...quiet, initialLimit: 3, initialHostLimit: 2 });
+    expect(limiter.tryAcquire('a.test')).toBe(true);
+    expect(limiter.tryAcquire('a.test')).toBe(true);
+    expect(limiter.tryAcquire('a.test')).toBe(false);
+    expect(limiter.tryAcquire('b.test')).toBe(true);
+    expect(limiter.tryAcquire('c.test')).toBe(false);
+    expect(limiter.getStats()).toMatchObject({ limit: 3, inFlight: 3, metrics: { rejected: 2 } });
+  });
+
+  it('reports decisions through emitWorkerScaled', () => {
+    const telemetry = { emitWorkerScaled: jest.fn() };
+    const limiter = new AdaptiveConcurrencyLimiter({ initialLimit: 8, lagProvider: () => 500, heapProvider: () => 0, telemetry });
+    limiter.evaluate();
+    expect(telemetry.emitWorkerScaled).toHaveBeenCalledWith({ from: 8, to: 6, reason: 'event-loop lag 500ms > 100ms' });
+  });
+});
+
+describe('ConcurrencyController with an adaptive limiter', () => {
+  let controller;
+
+  const worker = async ({ shouldContinue }) => {
+    await new Promise(r => setTimeout(r, 20));
+    if (!shouldContinue()) return;
+  };
+
+  afterEach(async () => {
+    if (controller && !controller.isShutdown) controller.shutdown();
+    await new Promise(r => setTimeout(r, 50));
+  });
+
+  it('caps queue-driven scale-up at the limit and sheds workers on back-off', async () => {
+    let lag = 0;
+    const limiter = new AdaptiveConcurrencyLimiter({ initialLimit: 3, lagProvider: () => lag, heapProvider: () => 0 });
+    const telemetry = { emitWorkerScaled: jest.fn() };
+    controller = new ConcurrencyController({ minWorkers: 1, maxWorkers: 10, cooldownMs: 0, limiter, telemetry });
+
+    expect(controller.autoScale(100, worker)).toBe(3);
+    expect(telemetry.emitWorkerScaled.mock.calls.at(-1)[0]).toEqual({ from: 0, to: 3, reason: 'adaptive limit 3' });
+
+    lag = 300;
+    limiter.evaluate();
+    expect(controller.getMetrics()).toMatchObject({ targetWorkers: 2, limiterScaleDowns: 1 });
+    expect(telemetry.emitWorkerScaled.mock.calls.at(-1)[0]).toEqual({ from: 3, to: 2, reason: 'adaptive: event-loop lag 300ms > 100ms' });
+  });
+});
@@ -330,10 +330,10 @@ describe('pageProcessingPipeline', () => {
   });
 
   describe('buildPageProcessingSteps', () => {
-    it('returns array of 10 steps', () => {
+    it('returns array of 11 steps', () => {
       const deps = createMockDeps();
       const steps = buildPageProcessingSteps(deps);
-      expect(steps).toHaveLength(10);
+      expect(steps).toHaveLength(11);
     });
 
     it('steps are in correct order', () => {
@@ -347,6 +347,7 @@ describe('pageProcessingPipeline', () => {
         'fetch',
         'parseHtml',
         'detectArticle',
+        'offloadAnalysis',
         'extractLinks',
         'enqueueLinks',
         'processArticle',
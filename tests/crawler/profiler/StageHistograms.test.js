@@ -0,0 +1,128 @@
+'use strict';
+
+const {
+  LatencyHistogram,
+  StageHistograms,
+  ProfileReporter,
+  OTHER_HOST
+} = require('../../../src/core/crawler/profiler');
+const { runPipeline, createStep } = require('../../../src/core/crawler/pipeline/runPipeline');
+
+describe('LatencyHistogram', () => {
+  test('reports percentiles within the bucket precision', () => {
+    const hist = new LatencyHistogram();
+    for (let ms = 1; ms <= 1000; ms++) {
+      hist.recordNs(BigInt(ms) * 1000000n);
+    }
+
+    const summary = hist.summary();
+    expect(summary.count).toBe(1000);
+    expect(summary.minMs).toBe(1);
+    expect(summary.maxMs).toBe(1000);
+    for (const [p, expected] of [[50, 500], [99, 990], [99.9, 999]]) {
+      const value = hist.percentile(p);
+      expect(value).toBeGreaterThanOrEqual(expected);
+      expect(Math.abs(value - expected) / expected).toBeLessThan(1 / 32);
+    }
+    expect(hist.percentile(100)).toBe(1000);
+  });
+
+  test('uses fixed memory regardless of the values recorded', () => {
+    const hist = new LatencyHistogram({ precisionBits: 5 });
+    const buckets = hist.bucketCount;
+    hist.recordMs(0);
+    hist.recordMs(-5);
+    hist.recordNs(10n ** 15n);
+    hist.recordMs(3.25);
+    expect(hist.bucketCount).toBe(buckets);
+    expect(hist.count).toBe(4);
+    expect(hist.percentile(50)).toBe(0);
+    expect(hist.summary().maxMs).toBeCloseTo(2147483.647, 3);
+  });
+
+  test('merges and round-trips through JSON', () => {
+    const a = new LatencyHistogram();
+    const b = new LatencyHistogram();
+    [5, 10, 15].forEach((ms) => a.recordMs(ms));
+    [200, 400].forEach((ms) => b.recordMs(ms));
+    a.merge(b);
+
+    const restored = LatencyHistogram.fromJSON(JSON.parse(JSON.stringify(a)));
+    expect(restored.summary()).toEqual(a.summary());
+    expect(restored.count).toBe(5);
+    expect(() => a.merge(new LatencyHistogram({ precisionBits: 3 }))).toThrow('same precision');
+  });
+});
+
+describe('StageHistograms', () => {
+  test('tracks stages per host with a bounded host set', () => {
+    const stages = new StageHistograms({ maxHosts: 2 });
+    stages.recordMs('firstByte', 'a.example', 10);
+    stages.recordMs('firstByte', 'b.example', 20);
+    stages.recordMs('firstByte', 'c.example', 30);
+    stages.recordMs('firstByte', 'd.example', 40);
+    stages.recordMs('download', null, 5);
+
+    const { stages: snapshot } = stages.snapshot();
+    expect(Object.keys(snapshot.firstByte.hosts)).toEqual(['a.example', 'b.example', OTHER_HOST]);
+    expect(snapshot.firstByte.hosts[OTHER_HOST].count).toBe(2);
+    expect(snapshot.firstByte).toMatchObject({ count: 4, minMs: 10, maxMs: 40 });
+    expect(snapshot.firstByte.p50).toBeCloseTo(20, 0);
+    expect(snapshot.download.hosts).toEqual({});
+    expect(stages.get('firstByte', 'd.example')).toBe(stages.get('firstByte', OTHER_HOST));
+  });
+
+  test('times pipeline steps with hrtime when passed as a dependency', async () => {
+    const stages = new StageHistograms();
+    const steps = [
+      createStep('fetch', async () => {
+        await new Promise((resolve) => setTimeout(resolve, 5));
+        return { ok: true };
+      }),
+      createStep('parseHtml', () => ({ ok: false, reason: 'bad-html' }), { optional: true }),
+      createStep('persist', () => { throw new Error('db down'); }, { optional: true })
+    ];
+    const logger = { info() {}, warn() {}, error() {}, debug() {} };
+    await runPipeline(steps, { url: 'https://News.Example.com/a' }, { logger, stageHistograms: stages });
+
+    expect(stages.getStages()).toEqual(['fetch', 'parseHtml', 'persist']);
+    const fetch = stages.get('fetch', 'news.example.com');
+    expect(fetch.count).toBe(1);
+    expect(fetch.percentile(50)).toBeGreaterThanOrEqual(4);
+    expect(stages.get('persist', 'news.example.com').count).toBe(1);
+  });
+});
+
+describe('ProfileReporter histogram diff', () => {
+  function run(scale) {
+    const stages = new StageHistograms();
+    for (let i = 1; i <= 100; i++) {
+      stages.recordMs('firstByte', 'a.example', i * scale);
+      stages.recordMs('parseHtml', 'a.example', 2);
+    }
+    return stages;
+  }
+
+  test('compares p50/p99/p999 between two runs, including saved ones', () => {
+    const reporter = new ProfileReporter();
+    const baseline = JSON.parse(JSON.stringify(run(1)));
+    const current = run(2);
+    current.recordMs('readability', 'a.example', 12);
+
+    const diff = reporter.diffHistograms(baseline, current, { hosts: true });
+    const firstByte = diff.stages.find((row) => row.stage === 'firstByte' && row.host === null);
+    expect(firstByte.baseline).toMatchObject({ count: 100, p99: 100 });
+    expect(firstByte.baseline.p50).toBeCloseTo(50, 0);
+    expect(firstByte.current).toMatchObject({ count: 100 });
+    expect(firstByte.change.p50).toBeGreaterThan(90);
+    expect(firstByte.change.p50).toBeLessThan(110);
+    expect(diff.stages.find((row) => row.stage === 'parseHtml' && row.host === null).change.p99).toBe(0);
+    expect(diff.stages.find((row) => row.stage === 'readability' && row.host === null).baseline).toBeNull();
+    expect(diff.stages.filter((row) => row.host === 'a.example')).toHaveLength(3);
+
+    const ascii = reporter.reportHistogramDiff(baseline, current);
+    expect(ascii).toContain('STAGE LATENCY COMPARISON');
+    expect(ascii).toMatch(/firstByte\s+50\.\d+ms → \d+ms \(\+\d/);
+    expect(reporter.reportHistogramDiff(baseline, current.snapshot(), { format: 'markdown' })).toContain('| readability | 0 → 1 |');
+  });
+});
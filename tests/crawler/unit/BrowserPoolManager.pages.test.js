@@ -0,0 +1,216 @@
+'use strict';
+
+/**
+ * BrowserPoolManager page pool tests
+ *
+ * Uses a fake launch() so no real browser is needed: warm per-domain pages,
+ * request blocking, and page-count / RSS recycling.
+ */
+
+const EventEmitter = require('events');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { BrowserPoolManager, readBrowserRssMb } = require('../../../src/core/crawler/BrowserPoolManager');
+
+function fakeRequest(url, type) {
+  return {
+    url: () => url,
+    resourceType: () => type,
+    abort: jest.fn(async () => {}),
+    continue: jest.fn(async () => {})
+  };
+}
+
+function fakePage() {
+  const page = new EventEmitter();
+  page.closed = false;
+  page.setViewport = jest.fn(async () => {});
+  page.setRequestInterception = jest.fn(async () => {});
+  page.goto = jest.fn(async () => null);
+  page.close = jest.fn(async () => { page.closed = true; });
+  page.isClosed = () => page.closed;
+  return page;
+}
+
+function fakeLaunch() {
+  const browsers = [];
+  const launch = jest.fn(async () => {
+    const browser = {
+      contexts: [],
+      pages: [],
+      connected: true,
+      version: async () => 'fake/1.0',
+      process: () => ({ pid: 0 }),
+      createBrowserContext: async () => {
+        const context = {
+          newPage: async () => {
+            const page = fakePage();
+            browser.pages.push(page);
+            return page;
+          },
+          close: async () => {}
+        };
+        browser.contexts.push(context);
+        return context;
+      },
+      newPage: async () => fakePage(),
+      close: jest.fn(async () => { browser.connected = false; }),
+      on: () => {}
+    };
+    browsers.push(browser);
+    return browser;
+  });
+  return { launch, browsers };
+}
+
+const quietLogger = { info: () => {}, warn: () => {}, error: () => {}, debug: () => {} };
+
+describe('BrowserPoolManager page pool', () => {
+  let pool;
+
+  afterEach(async () => {
+    if (pool) await pool.destroy();
+    pool = null;
+  });
+
+  it('reuses warm pages within a per-domain context', async () => {
+    const { launch, browsers } = fakeLaunch();
+    pool = new BrowserPoolManager({ launch, maxBrowsers: 1, maxBrowserRssMb: 0, logger: quietLogger });
+
+    const first = await pool.acquirePage('https://news.example/a');
+    expect(first.reused).toBe(false);
+    await first.release();
+    await first.release();
+
+    const second = await pool.acquirePage('https://news.example/b');
+    expect(second.reused).toBe(true);
+    expect(second.page).toBe(first.page);
+    expect(first.page.goto).toHaveBeenCalledWith('about:blank', expect.any(Object));
+
+    const other = await pool.acquirePage('https://other.example/');
+    expect(other.reused).toBe(false);
+    expect(browsers[0].contexts).toHaveLength(2);
+    await second.release();
+    await other.release(new Error('boom'));
+
+    const stats = pool.getStats();
+    expect(launch).toHaveBeenCalledTimes(1);
+    expect(stats.pages).toMatchObject({ warm: 1, acquires: 3, created: 2, reused: 1, closed: 1, domains: 2 });
+    expect(stats.render.count).toBe(3);
+    expect(stats.pages.pagesPerBrowser).toBe(3);
+  });
+
+  it('blocks images, media, fonts and ad hosts by default', async () => {
+    const { launch } = fakeLaunch();
+    pool = new BrowserPoolManager({ launch, maxBrowsers: 1, maxBrowserRssMb: 0, logger: quietLogger });
+
+    const lease = await pool.acquirePage('https://news.example/');
+    expect(lease.page.setRequestInterception).toHaveBeenCalledWith(true);
+    const requests = [
+      fakeRequest('https://news.example/', 'document'),
+      fakeRequest('https://news.example/app.js', 'script'),
+      fakeRequest('https://cdn.news.example/hero.jpg', 'image'),
+      fakeRequest('https://cdn.news.example/font.woff2', 'font'),
+      fakeRequest('https://securepubads.g.doubleclick.net/tag.js', 'script')
+    ];
+    for (const request of requests) lease.page.emit('request', request);
+    lease.page.emit('response', { headers: () => ({ 'content-length': '2048' }) });
+    await lease.release();
+
+    expect(requests[0].continue).toHaveBeenCalled();
+    expect(requests[1].continue).toHaveBeenCalled();
+    expect(requests[2].abort).toHaveBeenCalled();
+    expect(requests[4].abort).toHaveBeenCalled();
+    expect(pool.getStats().blocking).toMatchObject({
+      enabled: true,
+      blockedRequests: 3,
+      allowedRequests: 2,
+      blockedByType: { image: 1, font: 1, ads: 1 },
+      loadedBytes: 2048
+    });
+  });
+
+  it('recycles browsers after N pages or when RSS crosses the cap', async () => {
+    const { launch, browsers } = fakeLaunch();
+    let rss = 100;
+    pool = new BrowserPoolManager({
+      launch,
+      maxBrowsers: 1,
+      maxPagesPerBrowser: 2,
+      maxBrowserRssMb: 500,
+      rssProvider: () => rss,
+      logger: quietLogger
+    });
+
+    for (let i = 0; i < 2; i++) {
+      const lease = await pool.acquirePage(`https://news.example/${i}`);
+      await lease.release();
+    }
+    expect(browsers[0].close).toHaveBeenCalled();
+    // Let the min-pool replacement launch settle
+    await new Promise((resolve) => setImmediate(resolve));
+
+    rss = 900;
+    const lease = await pool.acquirePage('https://news.example/2');
+    expect(launch).toHaveBeenCalledTimes(2);
+    await lease.release();
+    expect(browsers[1].close).toHaveBeenCalled();
+
+    const stats = pool.getStats();
+    expect(stats.telemetry).toMatchObject({ browserRetirements: 1, rssRecycles: 1, retiredBrowsers: 2 });
+    expect(stats.pages.warm).toBe(0);
+  });
+
+  it('samples RSS on the first release, every Nth release and on health checks', async () => {
+    const { launch, browsers } = fakeLaunch();
+    const rssProvider = jest.fn(() => 100);
+    pool = new BrowserPoolManager({
+      launch,
+      maxBrowsers: 1,
+      maxPagesPerBrowser: 100,
+      maxBrowserRssMb: 500,
+      rssCheckEveryReleases: 5,
+      rssProvider,
+      logger: quietLogger
+    });
+
+    for (let i = 0; i < 11; i++) {
+      const lease = await pool.acquirePage(`https://news.example/${i}`);
+      await lease.release();
+    }
+    expect(rssProvider).toHaveBeenCalledTimes(3);
+
+    browsers[0].version = jest.fn(async () => 'HeadlessChrome');
+    rssProvider.mockReturnValue(900);
+    await pool._performHealthCheck();
+    expect(rssProvider).toHaveBeenCalledTimes(4);
+    expect(browsers[0].close).toHaveBeenCalled();
+    expect(pool.getStats().telemetry).toMatchObject({ rssRecycles: 1 });
+  });
+
+  it('sums RSS over the whole browser process tree', () => {
+    const procRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'fake-proc-'));
+    // browser 100 -> zygote 200 (started by a second thread) -> renderers 300, 301
+    const processes = {
+      100: { rssKb: 1024, tasks: { 100: [], 101: [200] } },
+      200: { rssKb: 2048, tasks: { 200: [300, 301] } },
+      300: { rssKb: 4096, tasks: { 300: [] } },
+      301: { rssKb: 3072, tasks: { 301: [100] } }
+    };
+    try {
+      for (const [pid, info] of Object.entries(processes)) {
+        fs.mkdirSync(path.join(procRoot, pid), { recursive: true });
+        fs.writeFileSync(path.join(procRoot, pid, 'status'), `Name:\tchrome\nVmRSS:\t${info.rssKb} kB\n`);
+        for (const [task, children] of Object.entries(info.tasks)) {
+          fs.mkdirSync(path.join(procRoot, pid, 'task', task), { recursive: true });
+          fs.writeFileSync(path.join(procRoot, pid, 'task', task, 'children'), children.length ? `${children.join(' ')} ` : '');
+        }
+      }
+      expect(readBrowserRssMb({ process: () => ({ pid: 100 }) }, procRoot)).toBe(10);
+      expect(readBrowserRssMb({ process: () => ({ pid: 999 }) }, procRoot)).toBeNull();
+    } finally {
+      fs.rmSync(procRoot, { recursive: true, force: true });
+    }
+  });
+});
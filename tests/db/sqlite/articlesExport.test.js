@@ -0,0 +1,92 @@
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { openNewsCrawlerDb } = require('../../../src/db/openNewsCrawlerDb');
+const { createArticlesExportCursor } = require('../../../src/data/db/sqlite/queries/articlesExport');
+const { ExportService } = require('../../../src/data/export/ExportService');
+
+const ROWS = 2300;
+
+async function collect(stream) {
+  let output = '';
+  for await (const chunk of stream) output += chunk;
+  return output;
+}
+
+describe('articles export cursor', () => {
+  let dir;
+  let db;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'articles-export-'));
+    db = openNewsCrawlerDb(path.join(dir, 'news.db'));
+    db.exec(`
+      CREATE TABLE urls(id INTEGER PRIMARY KEY, url TEXT, host TEXT);
+      CREATE TABLE http_responses(id INTEGER PRIMARY KEY, url_id INTEGER, http_status INTEGER, fetched_at TEXT);
+      CREATE TABLE compression_types(id INTEGER PRIMARY KEY, name TEXT, algorithm TEXT);
+      CREATE TABLE content_storage(id INTEGER PRIMARY KEY, http_response_id INTEGER, content_blob BLOB,
+        compression_type_id INTEGER, compression_bucket_id INTEGER, bucket_entry_key TEXT);
+      CREATE TABLE content_analysis(id INTEGER PRIMARY KEY, content_id INTEGER, title TEXT, date TEXT,
+        section TEXT, word_count INTEGER, classification TEXT);
+      INSERT INTO compression_types(id, name, algorithm) VALUES (1, 'none', 'none');
+    `);
+    const insertUrl = db.prepare('INSERT INTO urls(id, url, host) VALUES (?, ?, ?)');
+    const insertResponse = db.prepare('INSERT INTO http_responses(id, url_id, http_status, fetched_at) VALUES (?, ?, 200, ?)');
+    const insertContent = db.prepare('INSERT INTO content_storage(id, http_response_id, content_blob, compression_type_id) VALUES (?, ?, ?, 1)');
+    const insertAnalysis = db.prepare(`
+      INSERT INTO content_analysis(id, content_id, title, date, section, word_count, classification)
+      VALUES (?, ?, ?, ?, 'news', 100, 'article')
+    `);
+    db.transaction(() => {
+      for (let i = 1; i <= ROWS; i += 1) {
+        const host = i % 2 ? 'odd.example.com' : 'even.example.com';
+        const day = String(1 + (i % 28)).padStart(2, '0');
+        insertUrl.run(i, `https://${host}/${i}`, host);
+        insertResponse.run(i, i, `2026-02-${day}T00:00:00Z`);
+        insertContent.run(i, i, Buffer.from(`<p>${i}</p>`));
+        // Gaps in content_analysis ids, as deletes leave them
+        insertAnalysis.run(i * 3, i, `Story ${i}`, `2026-02-${day}`);
+      }
+    })();
+  });
+
+  afterEach(() => {
+    db.close();
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  test('pages by id and applies host, date and limit filters', () => {
+    const iterate = createArticlesExportCursor(db, { pageSize: 100 });
+    const all = Array.from(iterate());
+    expect(all).toHaveLength(ROWS);
+    expect(all[0]).toMatchObject({
+      id: 3,
+      url: 'https://odd.example.com/1',
+      host: 'odd.example.com',
+      title: 'Story 1',
+      category: 'news',
+      content_id: 1
+    });
+    expect(all.every((row, i) => i === 0 || row.id > all[i - 1].id)).toBe(true);
+
+    const even = Array.from(iterate({ host: 'even.example.com', since: '2026-02-11T00:00:00Z', until: '2026-02-11T23:59:59Z' }));
+    expect(even.length).toBeGreaterThan(0);
+    expect(even.every((row) => row.host === 'even.example.com' && row.fetched_at.startsWith('2026-02-11'))).toBe(true);
+
+    expect(Array.from(iterate({ limit: 250 })).map((row) => row.id)).toEqual(all.slice(0, 250).map((row) => row.id));
+  });
+
+  test('ExportService streams every row by keyset, with bodies read on the same connection', async () => {
+    const service = new ExportService({
+      articlesAdapter: { exportArticlesBatch: () => { throw new Error('OFFSET paging should not run'); } },
+      contentDb: db,
+      logger: { log() {}, error() {} }
+    });
+    expect(service.hasArticleCursor()).toBe(true);
+
+    const output = await collect(service.createExportStream('articles', 'jsonl', { includeBody: true }));
+    const rows = output.trim().split('\n').map((line) => JSON.parse(line));
+    expect(rows).toHaveLength(ROWS);
+    expect(rows[ROWS - 1]).toMatchObject({ id: ROWS * 3, html: `<p>${ROWS}</p>` });
+  });
+});
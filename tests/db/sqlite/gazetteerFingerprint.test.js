@@ -0,0 +1,45 @@
+const { openNewsCrawlerDb } = require('../../../src/db/openNewsCrawlerDb');
+const { computeGazetteerFingerprint } = require('../../../src/intelligence/analysis/place-extraction');
+
+describe('gazetteer fingerprint', () => {
+  let db;
+
+  beforeEach(() => {
+    db = openNewsCrawlerDb(':memory:');
+    db.exec(`
+      CREATE TABLE places(id INTEGER PRIMARY KEY, kind TEXT, country_code TEXT, population INTEGER, canonical_name_id INTEGER);
+      CREATE TABLE place_names(id INTEGER PRIMARY KEY, place_id INTEGER, name TEXT, normalized TEXT);
+      CREATE TABLE place_hierarchy(parent_id INTEGER, child_id INTEGER);
+      INSERT INTO places(id, kind, country_code, population, canonical_name_id) VALUES (1, 'country', 'IE', 5000000, 1), (2, 'city', 'IE', 550000, 2);
+      INSERT INTO place_names(id, place_id, name, normalized) VALUES (1, 1, 'Ireland', 'ireland'), (2, 2, 'Dublin', 'dublin');
+      INSERT INTO place_hierarchy(parent_id, child_id) VALUES (1, 2);
+    `);
+  });
+
+  afterEach(() => {
+    if (db) {
+      try { db.close(); } catch (_) {}
+    }
+    db = null;
+  });
+
+  it('is stable while the tables are unchanged', () => {
+    expect(computeGazetteerFingerprint(db)).toBeTruthy();
+    expect(computeGazetteerFingerprint(db)).toBe(computeGazetteerFingerprint(db));
+  });
+
+  it('changes on edits that keep counts and ids', () => {
+    const before = computeGazetteerFingerprint(db);
+    db.exec("UPDATE place_names SET name = 'Baile Atha Cliath' WHERE id = 2");
+    const renamed = computeGazetteerFingerprint(db);
+    expect(renamed).not.toBe(before);
+
+    db.exec("UPDATE places SET kind = 'town', country_code = 'GB' WHERE id = 2");
+    expect(computeGazetteerFingerprint(db)).not.toBe(renamed);
+  });
+
+  it('returns null when the gazetteer tables are missing', () => {
+    db.exec('DROP TABLE place_hierarchy');
+    expect(computeGazetteerFingerprint(db)).toBeNull();
+  });
+});
@@ -0,0 +1,57 @@
+const { openNewsCrawlerDb } = require('../../../src/db/openNewsCrawlerDb');
+const { createPendingAnalysesAfterQuery } = require('../../../src/data/db/sqlite/queries/pendingAnalyses');
+
+describe('pending analyses keyset query', () => {
+  let db;
+
+  beforeEach(() => {
+    db = openNewsCrawlerDb(':memory:');
+    db.exec(`
+      CREATE TABLE urls(id INTEGER PRIMARY KEY, url TEXT);
+      CREATE TABLE http_responses(id INTEGER PRIMARY KEY, url_id INTEGER, http_status INTEGER);
+      CREATE TABLE compression_types(id INTEGER PRIMARY KEY, algorithm TEXT);
+      CREATE TABLE content_storage(id INTEGER PRIMARY KEY, http_response_id INTEGER, content_blob BLOB,
+        compression_type_id INTEGER, compression_bucket_id INTEGER, bucket_entry_key TEXT);
+      CREATE TABLE content_analysis(id INTEGER PRIMARY KEY, content_id INTEGER, analysis_version INTEGER,
+        classification TEXT, title TEXT, section TEXT, word_count INTEGER, article_xpath TEXT,
+        nav_links_count INTEGER, article_links_count INTEGER);
+      INSERT INTO compression_types(id, algorithm) VALUES (1, 'none');
+    `);
+    const insertUrl = db.prepare('INSERT INTO urls(id, url) VALUES (?, ?)');
+    const insertResponse = db.prepare('INSERT INTO http_responses(id, url_id, http_status) VALUES (?, ?, 200)');
+    const insertContent = db.prepare('INSERT INTO content_storage(id, http_response_id, content_blob, compression_type_id) VALUES (?, ?, ?, 1)');
+    const insertAnalysis = db.prepare('INSERT INTO content_analysis(id, content_id, analysis_version, title) VALUES (?, ?, ?, ?)');
+    for (let i = 1; i <= 6; i += 1) {
+      insertUrl.run(i, `https://example.com/${i}`);
+      insertResponse.run(i, i);
+      insertContent.run(i, i, Buffer.from(`<p>${i}</p>`));
+      // Row 3 is already at version 2; row 5 has never been versioned
+      insertAnalysis.run(i * 10, i, i === 3 ? 2 : (i === 5 ? null : 1), `Story ${i}`);
+    }
+  });
+
+  afterEach(() => {
+    if (db) {
+      try { db.close(); } catch (_) {}
+    }
+    db = null;
+  });
+
+  it('pages pending rows in id order from a cursor', () => {
+    const getPendingAnalysesAfter = createPendingAnalysesAfterQuery(db);
+
+    const first = getPendingAnalysesAfter(2, null, 2);
+    expect(first.map((row) => row.analysis_id)).toEqual([10, 20]);
+    expect(first[0]).toMatchObject({ url: 'https://example.com/1', http_status: 200, compression_algorithm: 'none', content_id: 1 });
+
+    const second = getPendingAnalysesAfter(2, 20, 2);
+    expect(second.map((row) => row.analysis_id)).toEqual([40, 50]);
+    expect(getPendingAnalysesAfter(2, 50, 10).map((row) => row.analysis_id)).toEqual([60]);
+  });
+
+  it('does not revisit rows behind the cursor that are still pending', () => {
+    const getPendingAnalysesAfter = createPendingAnalysesAfterQuery(db);
+    // Row 10 failed and stays pending; the next batch starts past it anyway
+    expect(getPendingAnalysesAfter(2, 10, 1).map((row) => row.analysis_id)).toEqual([20]);
+  });
+});
@@ -50,6 +50,7 @@ const WRITE_ALLOWLIST = new Set([
   'src/core/crawler/PuppeteerDomainManager.js',                       // domain state file (migration planned)
   'tools/crawl/lib/sync-ledger.js',                                   // migration planned (plan §1)
   'tools/crawl/run.js',                                               // UI log plumbing (operational)
+  'src/core/crawler/frontier/FrontierSpillStore.js',                  // transient queue-overflow segments, deleted on drain (operational)
 ]);
 
 function walk(dir, acc = []) {
@@ -0,0 +1,255 @@
+'use strict';
+
+const { openNewsCrawlerDb } = require('../../src/db/openNewsCrawlerDb');
+/**
+ * SearchIndexer / SearchResultCache Tests
+ *
+ * Covers:
+ *   - Deferred (queued) index updates and batched flush
+ *   - Incremental merge steps
+ *   - Result/facet cache keyed on parsed query and index generation
+ *   - Hits and facets from a single pass
+ */
+const { SearchService } = require('../../src/search/SearchService');
+const { SearchIndexer, startDeferredIndexing, stopDeferredIndexing } = require('../../src/search/SearchIndexer');
+const { applyProjectMigrations } = require('../../src/data/db/sqlite/projectMigrations');
+const { SearchResultCache } = require('../../src/search/SearchResultCache');
+
+function createSchema(db) {
+  db.exec(`
+    CREATE TABLE urls (id INTEGER PRIMARY KEY, url TEXT NOT NULL UNIQUE, host TEXT);
+    CREATE TABLE http_responses (id INTEGER PRIMARY KEY, url_id INTEGER NOT NULL, fetched_at TEXT, http_status INTEGER);
+    CREATE TABLE content_storage (id INTEGER PRIMARY KEY, http_response_id INTEGER NOT NULL, storage_type TEXT);
+    CREATE TABLE content_analysis (
+      id INTEGER PRIMARY KEY, content_id INTEGER NOT NULL, title TEXT, body_text TEXT, byline TEXT,
+      authors TEXT, date TEXT, section TEXT, word_count INTEGER, classification TEXT,
+      analyzed_at TEXT, analysis_json TEXT
+    );
+    CREATE VIRTUAL TABLE articles_fts USING fts5(
+      title, body_text, byline, authors,
+      content='content_analysis', content_rowid='id', tokenize='porter unicode61'
+    );
+    CREATE TRIGGER articles_fts_insert AFTER INSERT ON content_analysis BEGIN
+      INSERT INTO articles_fts(rowid, title, body_text, byline, authors)
+      VALUES (NEW.id, NEW.title, NEW.body_text, NEW.byline, NEW.authors);
+    END;
+    CREATE TRIGGER articles_fts_update AFTER UPDATE ON content_analysis BEGIN
+      INSERT INTO articles_fts(articles_fts, rowid, title, body_text, byline, authors)
+      VALUES ('delete', OLD.id, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+      INSERT INTO articles_fts(rowid, title, body_text, byline, authors)
+      VALUES (NEW.id, NEW.title, NEW.body_text, NEW.byline, NEW.authors);
+    END;
+    CREATE TRIGGER articles_fts_delete AFTER DELETE ON content_analysis BEGIN
+      INSERT INTO articles_fts(articles_fts, rowid, title, body_text, byline, authors)
+      VALUES ('delete', OLD.id, OLD.title, OLD.body_text, OLD.byline, OLD.authors);
+    END;
+  `);
+}
+
+function insertArticle(db, { url, title, body_text, authors, date }) {
+  const urlId = db.prepare('INSERT INTO urls (url, host) VALUES (?, ?)').run(url, new URL(url).hostname).lastInsertRowid;
+  const responseId = db.prepare('INSERT INTO http_responses (url_id, fetched_at, http_status) VALUES (?, ?, 200)').run(urlId, date).lastInsertRowid;
+  const storageId = db.prepare("INSERT INTO content_storage (http_response_id, storage_type) VALUES (?, 'inline')").run(responseId).lastInsertRowid;
+  return db.prepare(`
+    INSERT INTO content_analysis (content_id, title, body_text, authors, date) VALUES (?, ?, ?, ?, ?)
+  `).run(storageId, title, body_text, JSON.stringify(authors), date).lastInsertRowid;
+}
+
+const articles = [
+  { url: 'https://example.com/a', title: 'Harbour bridge reopens', body_text: 'The harbour bridge reopened after repairs.', authors: ['Ann Lee'], date: '2025-01-10' },
+  { url: 'https://example.com/b', title: 'Council budget vote', body_text: 'The council approved harbour dredging in its budget.', authors: ['Ann Lee', 'Bo Park'], date: '2025-01-12' },
+  { url: 'https://news.example.org/c', title: 'Harbour festival', body_text: 'Crowds came to the harbour festival.', authors: ['Bo Park'], date: '2025-01-15' },
+  { url: 'https://news.example.org/d', title: 'Rail strike', body_text: 'Trains stopped for a day.', authors: ['Cy Diaz'], date: '2025-01-18' }
+];
+
+describe('SearchIndexer', () => {
+  let db;
+  let ids;
+
+  beforeEach(() => {
+    db = openNewsCrawlerDb(':memory:');
+    createSchema(db);
+    applyProjectMigrations(db);
+    ids = articles.map((article) => insertArticle(db, article));
+  });
+
+  afterEach(() => {
+    db.close();
+  });
+
+  test('search with facets returns hits and facets from one pass', () => {
+    const service = new SearchService(db, { cache: false, indexer: new SearchIndexer(db) });
+    const result = service.search('harbour', { includeFacets: true, includeHighlights: false, limit: 2 });
+
+    expect(result.success).toBe(true);
+    expect(result.results).toHaveLength(2);
+    expect(result.pagination).toMatchObject({ total: 3, hasMore: true });
+    expect(result.results[0]).toMatchObject({ id: expect.any(Number), host: expect.any(String) });
+    expect(result.facets.domains).toEqual([
+      { domain: 'example.com', count: 2 },
+      { domain: 'news.example.org', count: 1 }
+    ]);
+    expect(result.facets.authors).toEqual([
+      { author: 'Ann Lee', count: 2 },
+      { author: 'Bo Park', count: 2 }
+    ]);
+    expect(result.facets.dateRange).toEqual({ min_date: '2025-01-10', max_date: '2025-01-15', count: 3 });
+    expect(service.getFacets('harbour')).toEqual(result.facets);
+
+    const filtered = service.search('harbour', { includeFacets: true, includeHighlights: false, domain: 'news.example.org' });
+    expect(filtered.results.map((row) => row.id)).toEqual([ids[2]]);
+    expect(filtered.facets.domains).toHaveLength(2);
+  });
+
+  test('deferred indexing queues only indexed-column changes and applies them in a batch', () => {
+    const indexer = new SearchIndexer(db);
+    const service = new SearchService(db, { cache: false, indexer });
+    indexer.enableDeferredIndexing();
+    expect(indexer.isDeferred()).toBe(true);
+
+    db.prepare("UPDATE content_analysis SET analysis_json = '{}' WHERE id = ?").run(ids[0]);
+    expect(indexer.pendingCount()).toBe(0);
+
+    db.prepare("UPDATE content_analysis SET title = 'Tram depot opens' WHERE id = ?").run(ids[3]);
+    db.prepare("UPDATE content_analysis SET title = 'Tram depot opens today' WHERE id = ?").run(ids[3]);
+    db.prepare('DELETE FROM content_analysis WHERE id = ?').run(ids[2]);
+    const added = insertArticle(db, { url: 'https://example.com/e', title: 'Tram timetable', body_text: 'New tram times.', authors: [], date: '2025-01-20' });
+    expect(indexer.pendingCount()).toBe(3);
+
+    const search = (query) => service.getFacets(query).dateRange.count;
+    expect(search('tram')).toBe(0);
+    expect(search('rail')).toBe(1);
+
+    const generation = indexer.generation();
+    expect(indexer.flush({ limit: 2 })).toEqual({ indexed: 1, removed: 2, pending: 1 });
+    expect(indexer.flushAll()).toMatchObject({ indexed: 1, batches: 1 });
+    expect(indexer.generation()).toBeGreaterThan(generation);
+
+    expect(search('tram')).toBe(2);
+    expect(search('rail')).toBe(0);
+    expect(search('festival')).toBe(0);
+    expect(db.prepare("SELECT rowid FROM articles_fts WHERE articles_fts MATCH 'timetable'").all()).toEqual([{ rowid: added }]);
+    expect(db.prepare("INSERT INTO articles_fts(articles_fts, rank) VALUES ('integrity-check', 1)").run()).toBeDefined();
+
+    indexer.disableDeferredIndexing();
+    expect(indexer.isDeferred()).toBe(false);
+    db.prepare("UPDATE content_analysis SET title = 'Ferry news' WHERE id = ?").run(ids[0]);
+    expect(search('ferry')).toBe(1);
+  });
+
+  test('queue tables come from the migration, and enabling needs them', () => {
+    const bare = openNewsCrawlerDb(':memory:');
+    try {
+      createSchema(bare);
+      expect(() => new SearchIndexer(bare).enableDeferredIndexing()).toThrow(/project-migrations/);
+      expect(startDeferredIndexing(bare, { logger: { warn() {} } })).toBeNull();
+      expect(new SearchIndexer(bare).isDeferred()).toBe(false);
+    } finally {
+      bare.close();
+    }
+
+    const indexer = new SearchIndexer(db);
+    indexer.enableDeferredIndexing();
+    indexer.disableDeferredIndexing();
+    const tables = db.prepare("SELECT name FROM sqlite_master WHERE type = 'table' AND name LIKE 'search_index_%' ORDER BY name").all();
+    expect(tables.map((row) => row.name)).toEqual(['search_index_queue', 'search_index_state']);
+  });
+
+  test('startDeferredIndexing switches the handle over once and stopDeferredIndexing drains the queue', () => {
+    const indexer = startDeferredIndexing(db);
+    expect(indexer).not.toBeNull();
+    expect(indexer.isDeferred()).toBe(true);
+    // Another process opening the same database sees the queue triggers
+    expect(new SearchIndexer(db).isDeferred()).toBe(true);
+    const generation = indexer.generation();
+    expect(startDeferredIndexing(db)).toBe(indexer);
+    expect(indexer.generation()).toBe(generation);
+
+    insertArticle(db, { url: 'https://example.com/g', title: 'Ferry timetable', body_text: 'Ferries run hourly.', authors: [], date: '2025-02-02' });
+    expect(indexer.pendingCount()).toBe(1);
+    stopDeferredIndexing(db);
+    expect(indexer.pendingCount()).toBe(0);
+    expect(db.prepare("SELECT rowid FROM articles_fts WHERE articles_fts MATCH 'ferry'").all()).toHaveLength(1);
+  });
+
+  test('merge runs in bounded steps until the index is compact', () => {
+    const indexer = new SearchIndexer(db, { mergePages: 2 });
+    indexer.configureMerge({ automerge: 0 });
+    for (let i = 0; i < 40; i++) {
+      insertArticle(db, { url: `https://example.com/bulk/${i}`, title: `Bulk ${i}`, body_text: 'harbour '.repeat(50), authors: [], date: '2025-02-01' });
+    }
+    let outcome;
+    let rounds = 0;
+    do {
+      outcome = indexer.merge({ budgetMs: 1000 });
+      rounds += 1;
+    } while (!outcome.complete && rounds < 50);
+    expect(outcome.complete).toBe(true);
+    expect(indexer.mergeStep()).toBe(false);
+  });
+});
+
+describe('SearchResultCache', () => {
+  let db;
+
+  beforeEach(() => {
+    db = openNewsCrawlerDb(':memory:');
+    createSchema(db);
+    applyProjectMigrations(db);
+    articles.forEach((article) => insertArticle(db, article));
+  });
+
+  afterEach(() => {
+    db.close();
+  });
+
+  test('keys on the normalized parsed query and drops entries on a new generation', () => {
+    const indexer = new SearchIndexer(db);
+    const cache = new SearchResultCache({ maxEntries: 2 });
+    const service = new SearchService(db, { cache, indexer });
+    const options = { includeFacets: true, includeHighlights: false };
+
+    const first = service.search('harbour', options);
+    const second = service.search('  harbour ', options);
+    expect(first.metrics.cached).toBeUndefined();
+    expect(second.metrics.cached).toBe(true);
+    expect(second.results).toEqual(first.results);
+    expect(service.search('harbour', { ...options, limit: 1 }).metrics.cached).toBeUndefined();
+
+    indexer.enableDeferredIndexing();
+    insertArticle(db, { url: 'https://example.com/f', title: 'Harbour lights', body_text: 'Lights on the harbour.', authors: [], date: '2025-01-30' });
+    expect(service.search('harbour', options).pagination.total).toBe(3);
+    indexer.flush();
+    const fresh = service.search('harbour', options);
+    expect(fresh.metrics.cached).toBeUndefined();
+    expect(fresh.pagination.total).toBe(4);
+
+    service.search('festival', options);
+    expect(cache.getStats()).toMatchObject({ hits: 1, stale: 2, size: 2, evictions: 1 });
+  });
+
+  test('caches by default only when deferred indexing tracks the generation', () => {
+    const indexer = new SearchIndexer(db);
+    expect(new SearchService(db, { indexer }).getIndexStats().cache).toBeNull();
+
+    indexer.enableDeferredIndexing();
+    const service = new SearchService(db, { indexer });
+    service.search('harbour', { includeHighlights: false });
+    expect(service.search('harbour', { includeHighlights: false }).metrics.cached).toBe(true);
+  });
+
+  test('expires entries after the TTL', () => {
+    const cache = new SearchResultCache({ ttlMs: 5 });
+    cache.set('k', 1, { value: true });
+    expect(cache.get('k', 1)).toEqual({ value: true });
+    expect(cache.get('k', 2)).toBeNull();
+    cache.set('k', 1, { value: true });
+    const realNow = Date.now;
+    Date.now = () => realNow() + 10;
+    try {
+      expect(cache.get('k', 1)).toBeNull();
+    } finally {
+      Date.now = realNow;
+    }
+  });
+});
@@ -30,5 +30,21 @@ describe('CrawlerServiceWiring', () => {
     expect(crawler.resilienceService).toBeDefined();
     expect(crawler.contentValidationService).toBeDefined();
   });
+
+  it('routes page and robots fetches through an injected fetchFn', () => {
+    const fetchFn = jest.fn();
+    crawler = new NewsCrawler('https://example.com', { enableDb: false, concurrency: 1, fetchFn });
+
+    expect(crawler.fetchPipeline.fetchFn).toBe(fetchFn);
+    expect(crawler.robotsCoordinator.fetch).toBe(fetchFn);
+  });
+
+  it('passes the latency histogram options through to the wiring', () => {
+    crawler = new NewsCrawler('https://example.com', { enableDb: false, concurrency: 1, latencyHistogramHosts: 4 });
+    expect(crawler.stageHistograms.maxHosts).toBe(4);
+
+    crawler = new NewsCrawler('https://example.com', { enableDb: false, concurrency: 1, latencyHistograms: false });
+    expect(crawler.stageHistograms).toBeNull();
+  });
 });
 
@@ -0,0 +1,533 @@
+/**
+ * Crawl replay benchmark: end-to-end NewsCrawler throughput without live
+ * sites.
+ *
+ * A corpus of httpRecordReplay fixtures is loaded into memory and served to
+ * one NewsCrawler per host (through the crawler's fetchFn option) by a
+ * simulated network:
+ *  - latency:    each host gets a seeded base latency, and every response
+ *                waits base + jitter before its headers arrive. Jitter is
+ *                drawn per URL and attempt, not in arrival order, so a
+ *                page's latency does not depend on how requests interleave.
+ *  - rate limit: each host accepts --rate requests per window and answers
+ *                the rest with 429 + Retry-After, as a real news site would.
+ *                Windows run on a virtual clock: every request to a host
+ *                advances it by one mean request slot (mean latency /
+ *                --concurrency), so the count of 429s follows the host's
+ *                request sequence rather than timer scheduling. The default
+ *                (1000/1000) is above what the default load can reach (at
+ *                most about 400 requests per virtual second per host).
+ *                The crawler blacks a host out for 30s+ after a 429, so a
+ *                tight --rate measures back-off cost rather than hot paths;
+ *                --budget-ms stops a run that would stall and flags it.
+ * Every random choice is seeded, so two runs over the same corpus see the
+ * same pages, latencies and 429s, and pages/sec only moves when the
+ * crawler's own hot paths (fetch pipeline, body reading, parsing, link
+ * extraction, queueing) do. --latency 0 --rate 0 leaves pure CPU.
+ *
+ * Corpus: fixtures under --corpus (default tests/fixtures/http/crawl-replay,
+ * one fixture per request, as httpRecordReplay writes them). --record
+ * crawls the --sites live first and records them there. When no corpus
+ * exists a synthetic one is generated from --seed (noted in the results).
+ *
+ * Reports pages/sec, CPU ms per page, heap peak, event-loop delay and the
+ * crawlers' per-stage latency histograms, and writes the run to
+ * tools/benchmarks/results/crawl-replay-results.json. With --baseline the
+ * run is compared against an earlier results file and exits non-zero when
+ * pages/sec or CPU per page regress by more than --tolerance.
+ *
+ * Usage: node tools/benchmarks/benchmark-crawl-replay.js [--corpus dir] [--record --sites a.com,b.com]
+ *        [--hosts 4] [--pages 400] [--concurrency 4] [--latency 20] [--jitter 10] [--rate 1000/1000]
+ *        [--seed 42] [--budget-ms 120000] [--output file] [--baseline file] [--tolerance 0.1] [--verbose] [--json]
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { monitorEventLoopDelay } = require('perf_hooks');
+
+const { createHttpRecordReplay, generateFixtureKey } = require('../../src/shared/utils/fetch/httpRecordReplay');
+const { LatencyHistogram } = require('../../src/core/crawler/profiler/LatencyHistogram');
+
+const ROOT = path.join(__dirname, '..', '..');
+const args = process.argv.slice(2);
+const CORPUS_DIR = path.resolve(readArg('--corpus', path.join(ROOT, 'tests', 'fixtures', 'http', 'crawl-replay')));
+const RECORD = args.includes('--record');
+const SITES = String(readArg('--sites', '')).split(',').map(s => s.trim()).filter(Boolean);
+const HOSTS = Number(readArg('--hosts', 4));
+const PAGES = Number(readArg('--pages', 400));
+const CONCURRENCY = Number(readArg('--concurrency', 4));
+const LATENCY_MS = Number(readArg('--latency', 20));
+const JITTER_MS = Number(readArg('--jitter', 10));
+const RATE = parseRate(readArg('--rate', '1000/1000'));
+const SEED = Number(readArg('--seed', 42));
+const BUDGET_MS = Number(readArg('--budget-ms', 120000));
+const OUTPUT = path.resolve(readArg('--output', path.join(__dirname, 'results', 'crawl-replay-results.json')));
+const BASELINE = readArg('--baseline', null);
+const TOLERANCE = Number(readArg('--tolerance', 0.1));
+const VERBOSE = args.includes('--verbose');
+const JSON_OUTPUT = args.includes('--json');
+
+// NewsCrawler's CLI logger binds console.log when it loads, so crawl output
+// is muted through this switch rather than by swapping console methods later
+let quiet = false;
+for (const method of ['log', 'info', 'warn', 'debug']) {
+  const original = console[method].bind(console);
+  console[method] = (...parts) => {
+    if (!quiet) original(...parts);
+  };
+}
+
+const NO_BODY_STATUSES = new Set([101, 204, 205, 304]);
+// Recorded bodies are stored decoded, so these no longer describe them
+const STRIPPED_HEADERS = new Set(['content-encoding', 'content-length', 'transfer-encoding']);
+
+function readArg(name, fallback) {
+  const idx = args.indexOf(name);
+  return idx >= 0 && args[idx + 1] ? args[idx + 1] : fallback;
+}
+
+function parseRate(value) {
+  const [requests, windowMs] = String(value).split('/').map(Number);
+  return { requests: requests > 0 ? requests : 0, windowMs: windowMs > 0 ? windowMs : 1000 };
+}
+
+// Deterministic PRNG so every run sees the same corpus and network
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function hashString(value) {
+  let h = 2166136261;
+  for (let i = 0; i < value.length; i++) {
+    h ^= value.charCodeAt(i);
+    h = Math.imul(h, 16777619);
+  }
+  return h >>> 0;
+}
+
+// --- Corpus -----------------------------------------------------------------
+
+const WORDS = ('government minister council election market economy city police court report health '
+  + 'school climate energy water border trade union strike weather storm museum football season '
+  + 'league transfer coach budget inflation housing rail airport hospital research university '
+  + 'festival film music theatre review analysis interview village river coast diplomat summit').split(' ');
+const SECTIONS = ['world', 'politics', 'business', 'science', 'sport', 'culture'];
+const MONTHS = ['jan', 'feb', 'mar', 'apr', 'may', 'jun', 'jul', 'aug', 'sep', 'oct', 'nov', 'dec'];
+
+function sentence(rand, words) {
+  const out = [];
+  for (let i = 0; i < words; i++) out.push(WORDS[Math.floor(rand() * WORDS.length)]);
+  out[0] = out[0][0].toUpperCase() + out[0].slice(1);
+  return `${out.join(' ')}.`;
+}
+
+function htmlFixture(url, html) {
+  return { url, method: 'GET', status: 200, headers: { 'content-type': 'text/html; charset=utf-8' }, body: html, bodyEncoding: 'utf8' };
+}
+
+function page(title, nav, main) {
+  return `<!doctype html><html lang="en"><head><meta charset="utf-8"><title>${title}</title>`
+    + `<meta name="viewport" content="width=device-width"><link rel="stylesheet" href="/static/site.css"></head>`
+    + `<body><header><nav>${nav}</nav></header><main>${main}</main>`
+    + '<footer><a href="/about">About</a> <a href="/contact">Contact</a></footer></body></html>';
+}
+
+/**
+ * Synthetic news sites: a home page, section fronts and dated article pages
+ * (~600-1500 words, bylines, related links), so the crawler exercises the
+ * same hub/article paths it would on a real site.
+ */
+function buildSyntheticCorpus({ hosts, pagesPerHost, seed }) {
+  const rand = mulberry32(seed);
+  const fixtures = [];
+  for (let h = 0; h < hosts; h++) {
+    const host = `news${h}.example`;
+    const origin = `https://${host}`;
+    const nav = SECTIONS.map(s => `<a href="/${s}">${s}</a>`).join(' ');
+    const articleCount = Math.max(1, pagesPerHost - SECTIONS.length - 3);
+    const articles = [];
+    for (let i = 0; i < articleCount; i++) {
+      const section = SECTIONS[i % SECTIONS.length];
+      const day = String(1 + Math.floor(rand() * 28)).padStart(2, '0');
+      const slug = sentence(rand, 4).slice(0, -1).toLowerCase().replace(/\s+/g, '-');
+      articles.push({ section, title: sentence(rand, 8), path: `/${section}/2025/${MONTHS[i % 12]}/${day}/${slug}-${i}` });
+    }
+
+    fixtures.push({ url: `${origin}/robots.txt`, method: 'GET', status: 200, headers: { 'content-type': 'text/plain' }, body: 'User-agent: *\nAllow: /\n', bodyEncoding: 'utf8' });
+    for (const extra of ['about', 'contact']) {
+      fixtures.push(htmlFixture(`${origin}/${extra}`, page(`${extra} | ${host}`, nav, `<h1>${extra}</h1><p>${sentence(rand, 30)}</p>`)));
+    }
+    const latest = articles.slice(0, 20).map(a => `<li><a href="${a.path}">${a.title}</a></li>`).join('');
+    fixtures.push(htmlFixture(`${origin}/`, page(host, nav, `<h1>${host}</h1><ul>${latest}</ul>`)));
+    for (const section of SECTIONS) {
+      const list = articles.filter(a => a.section === section)
+        .map(a => `<article class="card"><h3><a href="${a.path}">${a.title}</a></h3><p>${sentence(rand, 18)}</p></article>`)
+        .join('');
+      const html = page(`${section} | ${host}`, nav, `<h1>${section}</h1>${list}`);
+      // The crawler also probes section fronts with a trailing slash
+      fixtures.push(htmlFixture(`${origin}/${section}`, html), htmlFixture(`${origin}/${section}/`, html));
+    }
+    for (const article of articles) {
+      const paragraphs = [];
+      const count = 12 + Math.floor(rand() * 20);
+      for (let p = 0; p < count; p++) paragraphs.push(`<p>${sentence(rand, 15)} ${sentence(rand, 20)} ${sentence(rand, 12)}</p>`);
+      const related = Array.from({ length: 3 }, () => articles[Math.floor(rand() * articles.length)])
+        .map(a => `<li><a href="${a.path}">${a.title}</a></li>`).join('');
+      const body = `<article><h1>${article.title}</h1><p class="byline">By ${sentence(rand, 2).slice(0, -1)}</p>`
+        + `<time datetime="2025-01-01T09:00:00Z">1 January 2025</time>${paragraphs.join('')}</article>`
+        + `<aside><h2>Related</h2><ul>${related}</ul></aside>`;
+      fixtures.push(htmlFixture(`${origin}${article.path}`, page(`${article.title} | ${host}`, nav, body)));
+    }
+  }
+  return fixtures;
+}
+
+function loadCorpus(dir) {
+  if (!fs.existsSync(dir)) return [];
+  const fixtures = [];
+  for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+    const full = path.join(dir, entry.name);
+    if (entry.isDirectory()) {
+      fixtures.push(...loadCorpus(full));
+    } else if (entry.name.endsWith('.json')) {
+      try {
+        const fixture = JSON.parse(fs.readFileSync(full, 'utf8'));
+        if (fixture && fixture.url) fixtures.push(fixture);
+      } catch (_) {
+        // Not a fixture
+      }
+    }
+  }
+  return fixtures;
+}
+
+// --- Simulated network ----------------------------------------------------
+
+/**
+ * fetch() over an in-memory corpus with per-host latency and rate limits.
+ * Fixtures are keyed by generateFixtureKey so lookups match what
+ * httpRecordReplay recorded; unknown URLs answer 404.
+ */
+function createReplayNetwork(fixtures, { latencyMs, jitterMs, rate, seed, concurrency = 1 }) {
+  const byKey = new Map();
+  for (const fixture of fixtures) {
+    byKey.set(generateFixtureKey(fixture.url, { method: fixture.method }), fixture);
+  }
+  const hosts = new Map();
+  const stats = { requests: 0, served: 0, notFound: 0, rateLimited: 0 };
+  const missing = [];
+
+  const hostState = (host) => {
+    let state = hosts.get(host);
+    if (!state) {
+      const baseMs = latencyMs * (0.5 + mulberry32(seed ^ hashString(host))());
+      state = {
+        baseMs,
+        // Virtual-clock advance per request; 1ms floor so --latency 0 still moves it
+        slotMs: Math.max(1, baseMs + jitterMs / 2) / Math.max(1, concurrency),
+        clockMs: 0,
+        windowStart: 0,
+        windowCount: 0,
+        attempts: new Map(), // url -> requests so far
+        requests: 0,
+        rateLimited: 0
+      };
+      hosts.set(host, state);
+    }
+    return state;
+  };
+
+  async function fetch(url, init = {}) {
+    const host = new URL(url).hostname;
+    const state = hostState(host);
+    stats.requests++;
+    state.requests++;
+
+    // Checked on arrival against the host's virtual clock
+    const now = state.clockMs;
+    state.clockMs += state.slotMs;
+    let limited = false;
+    if (rate.requests > 0) {
+      if (now - state.windowStart >= rate.windowMs) {
+        state.windowStart = Math.floor(now / rate.windowMs) * rate.windowMs;
+        state.windowCount = 0;
+      }
+      limited = ++state.windowCount > rate.requests;
+    }
+
+    const attempt = (state.attempts.get(url) || 0) + 1;
+    state.attempts.set(url, attempt);
+    const jitter = jitterMs > 0 ? mulberry32(seed ^ hashString(url) ^ Math.imul(attempt, 0x9E3779B1))() * jitterMs : 0;
+    const delay = state.baseMs + jitter;
+    if (delay > 0) await sleep(delay, init.signal);
+
+    if (limited) {
+      stats.rateLimited++;
+      state.rateLimited++;
+      const retryAfter = Math.max(1, Math.ceil((state.windowStart + rate.windowMs - now) / 1000));
+      return toResponse(url, { status: 429, headers: { 'content-type': 'text/plain', 'retry-after': String(retryAfter) }, body: 'Too Many Requests' });
+    }
+
+    const fixture = byKey.get(generateFixtureKey(url, { method: init.method }));
+    if (!fixture) {
+      stats.notFound++;
+      if (missing.length < 20) missing.push(url);
+      return toResponse(url, { status: 404, headers: { 'content-type': 'text/html' }, body: '<html><body>Not found</body></html>' });
+    }
+    stats.served++;
+    return toResponse(url, fixture);
+  }
+
+  return {
+    fetch,
+    fixtures: byKey.size,
+    getStats: () => ({
+      ...stats,
+      missing,
+      hosts: Object.fromEntries([...hosts].map(([host, s]) => [host, { baseLatencyMs: Math.round(s.baseMs), requests: s.requests, rateLimited: s.rateLimited }]))
+    })
+  };
+}
+
+function toResponse(url, fixture) {
+  const headers = new Headers();
+  for (const [key, value] of Object.entries(fixture.headers || {})) {
+    if (!STRIPPED_HEADERS.has(key.toLowerCase())) headers.set(key, value);
+  }
+  const body = NO_BODY_STATUSES.has(fixture.status)
+    ? null
+    : (fixture.bodyEncoding === 'base64' ? Buffer.from(fixture.body || '', 'base64') : (fixture.body || ''));
+  const response = new Response(body, { status: fixture.status, statusText: fixture.statusText || '', headers });
+  Object.defineProperty(response, 'url', { value: url });
+  return response;
+}
+
+function sleep(ms, signal) {
+  return new Promise((resolve, reject) => {
+    if (signal && signal.aborted) return reject(signal.reason || new Error('aborted'));
+    const timer = setTimeout(resolve, ms);
+    if (signal) {
+      signal.addEventListener('abort', () => {
+        clearTimeout(timer);
+        reject(signal.reason || new Error('aborted'));
+      }, { once: true });
+    }
+  });
+}
+
+// --- Crawl --------------------------------------------------------------------
+
+function crawlerOptions(fetchFn, maxDownloads) {
+  return {
+    fetchFn,
+    enableDb: false,
+    useSitemap: false,
+    preferCache: false,
+    concurrency: CONCURRENCY,
+    maxDownloads,
+    maxDepth: 4,
+    rateLimitMs: 0,
+    pacerJitterMinMs: 0,
+    pacerJitterMaxMs: 0,
+    loggingNetwork: false,
+    loggingFetching: false,
+    jobId: 'crawl-replay-benchmark'
+  };
+}
+
+async function crawlHosts(hosts, fetchFn, maxDownloads) {
+  // Loaded here so its CLI logger binds the muted console above
+  const NewsCrawler = require('../../src/crawl');
+  const crawlers = hosts.map((host) => {
+    const crawler = new NewsCrawler(`https://${host}/`, crawlerOptions(fetchFn, maxDownloads));
+    // Keep the run independent of whatever pages data/news.db already holds
+    crawler.cache.setDb(null);
+    return crawler;
+  });
+  let stalled = false;
+  const budget = setTimeout(() => {
+    stalled = true;
+    for (const crawler of crawlers) crawler.state.requestAbort();
+  }, BUDGET_MS);
+  try {
+    await Promise.all(crawlers.map(crawler => crawler.crawl()));
+  } finally {
+    clearTimeout(budget);
+    for (const crawler of crawlers) {
+      try { crawler.close(); } catch (_) {}
+    }
+  }
+  return { crawlers, stalled };
+}
+
+async function recordCorpus(sites) {
+  const recorder = createHttpRecordReplay({ mode: 'record', fixtureDir: path.dirname(CORPUS_DIR), namespace: path.basename(CORPUS_DIR), logger: console });
+  quiet = !VERBOSE;
+  try {
+    await crawlHosts(sites, recorder.fetch, Math.ceil(PAGES / sites.length));
+  } finally {
+    quiet = false;
+  }
+  return recorder.listFixtures().length;
+}
+
+function stageSummary(crawlers) {
+  const stages = {};
+  for (const crawler of crawlers) {
+    const histograms = crawler.stageHistograms;
+    if (!histograms) continue;
+    for (const stage of histograms.getStages()) {
+      const hist = histograms.get(stage);
+      if (!hist || hist.count === 0) continue;
+      if (!stages[stage]) stages[stage] = { all: new LatencyHistogram(), hosts: {} };
+      stages[stage].all.merge(hist);
+      stages[stage].hosts[crawler.domain] = hist.summary();
+    }
+  }
+  return Object.fromEntries(Object.entries(stages).map(([stage, entry]) => [stage, { ...entry.all.summary(), hosts: entry.hosts }]));
+}
+
+async function runBenchmark(fixtures, source) {
+  const network = createReplayNetwork(fixtures, { latencyMs: LATENCY_MS, jitterMs: JITTER_MS, rate: RATE, seed: SEED, concurrency: CONCURRENCY });
+  const hosts = [...new Set(fixtures.map(f => new URL(f.url).hostname))].sort();
+  const maxDownloads = Math.max(1, Math.ceil(PAGES / hosts.length));
+
+  const loopDelay = monitorEventLoopDelay({ resolution: 10 });
+  let heapPeak = process.memoryUsage().heapUsed;
+  const heapSampler = setInterval(() => {
+    heapPeak = Math.max(heapPeak, process.memoryUsage().heapUsed);
+  }, 25);
+  heapSampler.unref();
+
+  quiet = !VERBOSE;
+  loopDelay.enable();
+  const cpuStart = process.cpuUsage();
+  const wallStart = process.hrtime.bigint();
+  let run;
+  try {
+    run = await crawlHosts(hosts, network.fetch, maxDownloads);
+  } finally {
+    quiet = false;
+    loopDelay.disable();
+    clearInterval(heapSampler);
+  }
+  const wallMs = Number(process.hrtime.bigint() - wallStart) / 1e6;
+  const cpu = process.cpuUsage(cpuStart);
+  heapPeak = Math.max(heapPeak, process.memoryUsage().heapUsed);
+
+  const { crawlers, stalled } = run;
+  const pages = crawlers.reduce((sum, c) => sum + (c.stats.pagesDownloaded || 0), 0);
+  const cpuMs = (cpu.user + cpu.system) / 1000;
+  return {
+    metadata: {
+      generatedAt: new Date().toISOString(),
+      hostname: os.hostname(),
+      platform: process.platform,
+      node: process.version,
+      cpus: os.cpus().length,
+      corpus: { source, dir: source === 'synthetic' ? null : path.relative(ROOT, CORPUS_DIR), fixtures: network.fixtures, hosts: hosts.length },
+      config: { pages: PAGES, concurrency: CONCURRENCY, latencyMs: LATENCY_MS, jitterMs: JITTER_MS, rate: RATE, seed: SEED }
+    },
+    summary: {
+      stalled,
+      pages,
+      articles: crawlers.reduce((sum, c) => sum + (c.stats.articlesFound || 0), 0),
+      bytes: crawlers.reduce((sum, c) => sum + (c.stats.bytesDownloaded || 0), 0),
+      errors: crawlers.reduce((sum, c) => sum + (c.stats.errors || 0), 0),
+      wallMs: round(wallMs),
+      pagesPerSec: round(pages / Math.max(wallMs / 1000, 1e-9)),
+      cpuMs: round(cpuMs),
+      cpuMsPerPage: round(cpuMs / Math.max(1, pages)),
+      heapPeakMb: round(heapPeak / 1048576),
+      eventLoopDelayP99Ms: round(loopDelay.percentile(99) / 1e6)
+    },
+    network: network.getStats(),
+    stages: stageSummary(crawlers)
+  };
+}
+
+function round(value) {
+  return Number(value.toFixed(2));
+}
+
+/**
+ * Throughput regressions against a stored run. Only comparable when the
+ * simulated network matches, so a config mismatch is reported instead.
+ */
+function compareToBaseline(result, baseline) {
+  const same = JSON.stringify(baseline?.metadata?.config) === JSON.stringify(result.metadata.config)
+    && baseline?.metadata?.corpus?.source === result.metadata.corpus.source;
+  if (!same) return { comparable: false, regressions: [] };
+  const checks = [
+    ['pagesPerSec', (now, was) => now < was * (1 - TOLERANCE)],
+    ['cpuMsPerPage', (now, was) => now > was * (1 + TOLERANCE)],
+    ['heapPeakMb', (now, was) => now > was * (1 + TOLERANCE)]
+  ];
+  const deltas = {};
+  const regressions = [];
+  for (const [metric, regressed] of checks) {
+    const now = result.summary[metric];
+    const was = baseline.summary?.[metric];
+    if (typeof was !== 'number' || was === 0) continue;
+    deltas[metric] = { baseline: was, current: now, change: round((now - was) / was) };
+    if (regressed(now, was)) regressions.push(metric);
+  }
+  return { comparable: true, tolerance: TOLERANCE, deltas, regressions };
+}
+
+async function main() {
+  if (RECORD) {
+    if (SITES.length === 0) throw new Error('--record requires --sites host1,host2');
+    const recorded = await recordCorpus(SITES);
+    if (!JSON_OUTPUT) console.log(`📼 Recorded ${recorded} fixtures into ${path.relative(ROOT, CORPUS_DIR)}`);
+  }
+
+  let fixtures = loadCorpus(CORPUS_DIR);
+  let source = 'recorded';
+  if (fixtures.length === 0) {
+    fixtures = buildSyntheticCorpus({ hosts: HOSTS, pagesPerHost: Math.ceil(PAGES / HOSTS), seed: SEED });
+    source = 'synthetic';
+  }
+
+  const result = await runBenchmark(fixtures, source);
+  if (BASELINE) {
+    result.baseline = compareToBaseline(result, JSON.parse(fs.readFileSync(path.resolve(BASELINE), 'utf8')));
+  }
+  fs.mkdirSync(path.dirname(OUTPUT), { recursive: true });
+  fs.writeFileSync(OUTPUT, JSON.stringify(result, null, 2));
+
+  if (JSON_OUTPUT) {
+    console.log(JSON.stringify(result, null, 2));
+  } else {
+    const { corpus } = result.metadata;
+    console.log(`📊 Crawl replay benchmark: ${corpus.source} corpus, ${corpus.fixtures} fixtures across ${corpus.hosts} hosts\n`);
+    console.table([result.summary]);
+    console.table(Object.entries(result.stages).map(([stage, s]) => ({ stage, count: s.count, p50Ms: s.p50, p90Ms: s.p90, p99Ms: s.p99, maxMs: s.maxMs })));
+    console.log(`Network: ${result.network.served} served, ${result.network.rateLimited} rate-limited, ${result.network.notFound} not found`);
+    console.log(`Results written to ${path.relative(ROOT, OUTPUT)}`);
+    if (result.baseline) {
+      if (!result.baseline.comparable) console.log('⚠️  Baseline was run with a different corpus/config; not compared');
+      else console.table(result.baseline.deltas);
+    }
+  }
+
+  if (result.summary.stalled) {
+    console.error(`❌ Crawl did not finish within ${BUDGET_MS}ms (see network.rateLimited)`);
+    process.exitCode = 1;
+  }
+  if (result.baseline && result.baseline.regressions.length > 0) {
+    console.error(`❌ Regression vs baseline (>${TOLERANCE * 100}%): ${result.baseline.regressions.join(', ')}`);
+    process.exitCode = 1;
+  }
+}
+
+main().catch((err) => {
+  console.error(`❌ Benchmark failed: ${err.message}`);
+  process.exit(1);
+});
@@ -0,0 +1,162 @@
+/**
+ * Frontier pull benchmark: host-sharded ready-time queue vs the legacy
+ * single heap with a 64-item deferral scan.
+ *
+ * Workload: 500 hosts with Zipf-skewed URL counts (the top hosts hold most
+ * of the frontier). Two scenarios:
+ *  - blocked-hot: the 10 largest hosts are rate-limited/paused for the whole
+ *    run, so every pull has to get past their URLs.
+ *  - politeness:  every host gets a short crawl delay after each fetch, as
+ *    DomainThrottleManager would set, so hot hosts keep cycling through
+ *    blocked/ready.
+ *
+ * Reports wall time, pulls per second and how many URLs were inspected
+ * (readiness lookups) per served URL. A run that cannot drain the servable
+ * URLs within the time budget is reported as stalled: the legacy scan
+ * re-pushes blocked URLs at their original priority, so once more than 64
+ * of them outrank every open URL it only ever sees blocked hosts.
+ *
+ * Usage: node tools/benchmarks/benchmark-frontier-sharding.js [--urls 50000] [--budget-ms 15000] [--json]
+ */
+
+const QueueManager = require('../../src/core/crawler/QueueManager');
+
+const HOSTS = 500;
+const args = process.argv.slice(2);
+const URLS = Number(readArg('--urls', 50000));
+const BUDGET_MS = Number(readArg('--budget-ms', 15000));
+const JSON_OUTPUT = args.includes('--json');
+
+function readArg(name, fallback) {
+  const idx = args.indexOf(name);
+  return idx >= 0 && args[idx + 1] ? args[idx + 1] : fallback;
+}
+
+// Deterministic PRNG so both queue implementations see the same workload
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function buildWorkload(count) {
+  const rand = mulberry32(42);
+  const weights = [];
+  let total = 0;
+  for (let i = 0; i < HOSTS; i += 1) {
+    const w = 1 / Math.pow(i + 1, 1.1);
+    weights.push(w);
+    total += w;
+  }
+  const cumulative = [];
+  let acc = 0;
+  for (const w of weights) {
+    acc += w / total;
+    cumulative.push(acc);
+  }
+  const urls = [];
+  for (let i = 0; i < count; i += 1) {
+    const r = rand();
+    let host = cumulative.findIndex((c) => r <= c);
+    if (host < 0) host = HOSTS - 1;
+    urls.push({ url: `https://host${host}.example.com/story/${i}`, priority: Math.floor(rand() * 100) });
+  }
+  return urls;
+}
+
+function createQueue({ shardByHost, isHostRateLimited, getHostResumeTime, counters }) {
+  const byUrl = new Map();
+  const qm = new QueueManager({
+    usePriorityQueue: true,
+    shardByHost,
+    maxQueue: URLS * 2,
+    isTotalPrioritisationEnabled: () => false,
+    urlEligibilityService: {
+      evaluate: ({ url }) => ({ status: 'allow', normalized: url, kind: 'article', queueKey: url })
+    },
+    computeEnhancedPriority: ({ url }) => ({ priority: byUrl.get(url), prioritySource: 'base' }),
+    safeHostFromUrl: (url) => url.slice(8, url.indexOf('/', 8)),
+    isHostRateLimited: (host) => { counters.inspections += 1; return isHostRateLimited(host); },
+    getHostResumeTime
+  });
+  return { qm, byUrl };
+}
+
+async function runScenario(name, { shardByHost, workload, blockedHosts = new Set(), politenessMs = 0 }) {
+  const counters = { inspections: 0, served: 0, idleWaits: 0 };
+  const resumeAt = new Map();
+  const { qm, byUrl } = createQueue({
+    shardByHost,
+    counters,
+    isHostRateLimited: (host) => blockedHosts.has(host),
+    getHostResumeTime: (host) => (blockedHosts.has(host) ? Date.now() + 60_000 : resumeAt.get(host) || null)
+  });
+
+  for (const entry of workload) {
+    byUrl.set(entry.url, entry.priority);
+    qm.enqueue({ url: entry.url, depth: 1, type: 'article' });
+  }
+
+  const target = workload.filter((e) => !blockedHosts.has(e.url.slice(8, e.url.indexOf('/', 8)))).length;
+  const started = process.hrtime.bigint();
+  const deadline = Date.now() + BUDGET_MS;
+  while (counters.served < target && Date.now() < deadline) {
+    const next = await qm.pullNext();
+    if (next && next.item) {
+      counters.served += 1;
+      if (politenessMs) {
+        resumeAt.set(qm.safeHostFromUrl(next.item.url), Date.now() + politenessMs);
+      }
+      continue;
+    }
+    if (!next) break;
+    counters.idleWaits += 1;
+    const waitMs = Math.max(0, (next.wakeAt || Date.now()) - Date.now());
+    await new Promise((resolve) => setTimeout(resolve, Math.min(waitMs, 5)));
+  }
+  const elapsedMs = Number(process.hrtime.bigint() - started) / 1e6;
+
+  return {
+    scenario: name,
+    mode: shardByHost ? 'host-sharded' : 'legacy-scan',
+    served: counters.served,
+    servable: target,
+    stalled: counters.served < target,
+    elapsedMs: Math.round(elapsedMs),
+    pullsPerSec: Math.round(counters.served / (elapsedMs / 1000)),
+    inspectionsPerPull: Number((counters.inspections / Math.max(1, counters.served)).toFixed(2)),
+    idleWaits: counters.idleWaits
+  };
+}
+
+async function main() {
+  const workload = buildWorkload(URLS);
+  const blockedHosts = new Set(Array.from({ length: 10 }, (_, i) => `host${i}.example.com`));
+  const scenarios = [
+    ['blocked-hot', { blockedHosts }],
+    ['politeness', { politenessMs: 2 }]
+  ];
+
+  const results = [];
+  for (const [name, config] of scenarios) {
+    for (const shardByHost of [false, true]) {
+      results.push(await runScenario(name, { ...config, shardByHost, workload }));
+    }
+  }
+
+  if (JSON_OUTPUT) {
+    console.log(JSON.stringify({ urls: URLS, hosts: HOSTS, results }, null, 2));
+    return;
+  }
+
+  console.log(`📊 Frontier pull benchmark: ${URLS} URLs across ${HOSTS} hosts (Zipf-skewed)\n`);
+  console.table(results);
+}
+
+main().catch((err) => {
+  console.error(`❌ Benchmark failed: ${err.message}`);
+  process.exit(1);
+});
@@ -0,0 +1,160 @@
+/**
+ * SimHash near-duplicate lookup benchmark: multi-index tables over packed
+ * columns (SimHashIndex) vs the legacy scan over a Map of 8-byte Buffers.
+ *
+ * Workload: N random 64-bit fingerprints, with 10% of them being
+ * near-duplicates (1-3 flipped bits) of an earlier entry, which is what
+ * syndicated wire copy looks like. Queries are perturbed copies of stored
+ * fingerprints at radius <= 3, matching DuplicateDetector.processArticle.
+ *
+ * Reports build time, heap growth, and query latency (mean/p50/p99) for the
+ * index. The legacy scan runs a few queries only, since each one walks all N
+ * entries. Both sides are checked to return the same match sets.
+ *
+ * Usage: node --max-old-space-size=8192 tools/benchmarks/benchmark-simhash-index.js [--sizes 1000000,5000000,10000000] [--queries 2000] [--json]
+ */
+
+const { SimHashIndex, popcount32 } = require('../../src/intelligence/analysis/similarity/SimHashIndex');
+
+const args = process.argv.slice(2);
+const SIZES = String(readArg('--sizes', '1000000,5000000,10000000')).split(',').map(Number).filter(n => n > 0);
+const QUERIES = Number(readArg('--queries', 2000));
+const LEGACY_QUERIES = Number(readArg('--legacy-queries', 5));
+const JSON_OUTPUT = args.includes('--json');
+
+function readArg(name, fallback) {
+  const idx = args.indexOf(name);
+  return idx >= 0 && args[idx + 1] ? args[idx + 1] : fallback;
+}
+
+// Deterministic PRNG so every run sees the same workload
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+function perturb(buffer, bits, rand) {
+  const copy = Buffer.from(buffer);
+  for (let i = 0; i < bits; i++) {
+    const pos = rand() % 64;
+    copy[pos >> 3] ^= 1 << (pos & 7);
+  }
+  return copy;
+}
+
+function buildFingerprints(count, rand) {
+  const fps = new Array(count);
+  for (let i = 0; i < count; i++) {
+    if (i > 0 && rand() % 10 === 0) {
+      fps[i] = perturb(fps[rand() % i], 1 + (rand() % 3), rand);
+    } else {
+      const fp = Buffer.alloc(8);
+      fp.writeUInt32LE(rand(), 0);
+      fp.writeUInt32LE(rand(), 4);
+      fps[i] = fp;
+    }
+  }
+  return fps;
+}
+
+// The pre-index findDuplicates: BigInt XOR + popcount per Map entry
+function legacyFindDuplicates(map, query, threshold) {
+  const q = query.readBigUInt64LE();
+  const results = [];
+  for (const [id, fp] of map) {
+    let x = fp.readBigUInt64LE() ^ q;
+    let distance = 0;
+    while (x !== 0n) { x &= x - 1n; distance++; }
+    if (distance <= threshold) results.push(id);
+  }
+  return results;
+}
+
+function percentile(sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+function heapMB() {
+  if (global.gc) global.gc();
+  return process.memoryUsage().heapUsed / 1048576;
+}
+
+function runSize(size) {
+  const rand = mulberry32(size);
+  const fingerprints = buildFingerprints(size, rand);
+  const queries = [];
+  for (let i = 0; i < QUERIES; i++) {
+    queries.push(perturb(fingerprints[rand() % size], rand() % 4, rand));
+  }
+
+  const heapBefore = heapMB();
+  const buildStart = process.hrtime.bigint();
+  const index = new SimHashIndex({ initialCapacity: size });
+  for (let i = 0; i < size; i++) index.add(i + 1, fingerprints[i]);
+  const buildMs = Number(process.hrtime.bigint() - buildStart) / 1e6;
+  const heapAfter = heapMB();
+
+  const latencies = [];
+  let matches = 0;
+  for (const query of queries) {
+    const start = process.hrtime.bigint();
+    matches += index.search(query, { threshold: 3 }).length;
+    latencies.push(Number(process.hrtime.bigint() - start) / 1e6);
+  }
+  latencies.sort((a, b) => a - b);
+
+  // Legacy scan on a handful of queries; also confirms identical results
+  const legacyMap = new Map();
+  for (let i = 0; i < size; i++) legacyMap.set(i + 1, fingerprints[i]);
+  let legacyTotalMs = 0;
+  let mismatches = 0;
+  for (const query of queries.slice(0, LEGACY_QUERIES)) {
+    const start = process.hrtime.bigint();
+    const legacy = legacyFindDuplicates(legacyMap, query, 3).sort((a, b) => a - b);
+    legacyTotalMs += Number(process.hrtime.bigint() - start) / 1e6;
+    const indexed = index.search(query, { threshold: 3 }).map(r => r.contentId).sort((a, b) => a - b);
+    if (legacy.join(',') !== indexed.join(',')) mismatches++;
+  }
+
+  const stats = index.getStats();
+  return {
+    size,
+    buildMs: Math.round(buildMs),
+    indexHeapMB: Math.round(heapAfter - heapBefore),
+    maxBucketSize: stats.maxBucketSize,
+    queryMeanMs: Number((latencies.reduce((a, b) => a + b, 0) / latencies.length).toFixed(4)),
+    queryP50Ms: Number(percentile(latencies, 0.5).toFixed(4)),
+    queryP99Ms: Number(percentile(latencies, 0.99).toFixed(4)),
+    matchesPerQuery: Number((matches / queries.length).toFixed(2)),
+    legacyQueryMs: LEGACY_QUERIES > 0 ? Math.round(legacyTotalMs / Math.min(LEGACY_QUERIES, queries.length)) : null,
+    mismatches
+  };
+}
+
+function main() {
+  const results = [];
+  for (const size of SIZES) {
+    const result = runSize(size);
+    results.push(result);
+    if (!JSON_OUTPUT) {
+      const speedup = result.legacyQueryMs ? Math.round(result.legacyQueryMs / Math.max(result.queryMeanMs, 0.0001)) : 'n/a';
+      console.log(
+        `${String(size).padStart(9)} entries | build ${result.buildMs}ms, heap +${result.indexHeapMB}MB | ` +
+        `query mean ${result.queryMeanMs}ms p50 ${result.queryP50Ms}ms p99 ${result.queryP99Ms}ms | ` +
+        `legacy scan ${result.legacyQueryMs}ms (${speedup}x) | mismatches ${result.mismatches}`
+      );
+    }
+  }
+  if (JSON_OUTPUT) {
+    console.log(JSON.stringify({ queries: QUERIES, results }, null, 2));
+  }
+  if (results.some(r => r.mismatches > 0)) {
+    process.exitCode = 1;
+  }
+}
+
+main();
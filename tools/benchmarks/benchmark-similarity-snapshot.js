@@ -0,0 +1,92 @@
+/**
+ * DuplicateDetector startup benchmark: rebuilding the SimilarityIndex from
+ * fingerprint rows (what initialize() does against the DB) vs loading a
+ * SimilaritySnapshot of the same fingerprints.
+ *
+ * Fingerprints are synthetic (random SimHash, 512-byte MinHash); the DB read
+ * itself is not measured, so the rebuild figure is a lower bound.
+ *
+ * Usage: node --expose-gc tools/benchmarks/benchmark-similarity-snapshot.js [--items 200000] [--json]
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { SimilarityIndex } = require('../../src/intelligence/analysis/similarity/SimilarityIndex');
+const { SimilaritySnapshot } = require('../../src/intelligence/analysis/similarity/SimilaritySnapshot');
+
+const args = process.argv.slice(2);
+const ITEMS = Number(readArg('--items', 200000));
+const JSON_OUTPUT = args.includes('--json');
+
+function readArg(name, fallback) {
+  const idx = args.indexOf(name);
+  return idx >= 0 && args[idx + 1] ? args[idx + 1] : fallback;
+}
+
+function mulberry32(seed) {
+  return () => {
+    seed |= 0; seed = (seed + 0x6D2B79F5) | 0;
+    let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+function heapMB() {
+  if (global.gc) global.gc();
+  return process.memoryUsage().heapUsed / 1048576;
+}
+
+function main() {
+  const rand = mulberry32(1);
+  const rows = [];
+  for (let i = 0; i < ITEMS; i++) {
+    const simhash = Buffer.alloc(8);
+    const minhash = Buffer.alloc(512);
+    for (let k = 0; k < 8; k += 4) simhash.writeUInt32LE(rand(), k);
+    for (let k = 0; k < 512; k += 4) minhash.writeUInt32LE(rand(), k);
+    rows.push({ contentId: i + 1, simhash, minhash });
+  }
+
+  let heapBefore = heapMB();
+  let start = Date.now();
+  let rebuilt = new SimilarityIndex();
+  for (const row of rows) rebuilt.add(row.contentId, row.simhash, row.minhash);
+  const rebuildMs = Date.now() - start;
+  const rebuildHeapMB = heapMB() - heapBefore;
+
+  const file = path.join(fs.mkdtempSync(path.join(os.tmpdir(), 'simsnap-bench-')), 'index.simsnap');
+  start = Date.now();
+  fs.writeFileSync(file, rebuilt.toSnapshot());
+  const writeMs = Date.now() - start;
+  rebuilt = null;
+
+  heapBefore = heapMB();
+  start = Date.now();
+  const loaded = new SimilarityIndex();
+  loaded.loadSnapshot(SimilaritySnapshot.load(file));
+  const loadMs = Date.now() - start;
+  const loadHeapMB = heapMB() - heapBefore;
+  const fileMB = fs.statSync(file).size / 1048576;
+  fs.rmSync(path.dirname(file), { recursive: true, force: true });
+
+  const result = {
+    items: ITEMS,
+    rebuildMs,
+    rebuildHeapMB: Math.round(rebuildHeapMB),
+    snapshotWriteMs: writeMs,
+    snapshotLoadMs: loadMs,
+    snapshotHeapMB: Math.round(loadHeapMB),
+    snapshotFileMB: Math.round(fileMB),
+    loadedItems: loaded.size
+  };
+  if (JSON_OUTPUT) {
+    console.log(JSON.stringify(result, null, 2));
+  } else {
+    console.log(`${ITEMS} items | rebuild ${rebuildMs}ms, heap +${result.rebuildHeapMB}MB | ` +
+      `snapshot write ${writeMs}ms, load ${loadMs}ms, heap +${result.snapshotHeapMB}MB (file ${result.snapshotFileMB}MB, off-heap)`);
+  }
+}
+
+main();
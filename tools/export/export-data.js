@@ -227,9 +227,11 @@ async function main() {
   }
 
   // Create export service
+  // contentDb lets --stream read articles by keyset instead of OFFSET pages
   const exportService = new ExportService({
     articlesAdapter: dataExportAdapter,
     domainsAdapter: dataExportAdapter,
+    contentDb: db,
     logger: options.verbose ? console : { log: () => {}, error: console.error }
   });
 
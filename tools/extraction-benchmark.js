@@ -12,6 +12,7 @@
  *   node tools/extraction-benchmark.js --fixture foreign/arabic-energy-news
  *   node tools/extraction-benchmark.js --json --output results.json
  *   node tools/extraction-benchmark.js --extractor readability
+ *   node tools/extraction-benchmark.js --links --iterations 50
  * 
  * Options:
  *   --fixture <path>    Run only on specific fixture
@@ -20,6 +21,8 @@
  *   --json              Output results as JSON
  *   --output <file>     Write results to file
  *   --verbose           Show detailed extraction output
+ *   --links             Benchmark link classification (links.js vs LinkClassifier)
+ *   --iterations <n>    Passes over the fixtures in --links mode (default: 20)
  *   --help              Show this help
  */
 
@@ -50,6 +53,8 @@ Options:
   --json              Output results as JSON
   --output <file>     Write results to file
   --verbose           Show detailed extraction output
+  --links             Benchmark link classification (links.js vs LinkClassifier)
+  --iterations <n>    Passes over the fixtures in --links mode (default: 20)
   --help              Show this help
 
 Examples:
@@ -66,6 +71,8 @@ const extractorFilter = getArg('--extractor');
 const jsonOutput = args.includes('--json');
 const outputFile = getArg('--output');
 const verbose = args.includes('--verbose');
+const linksMode = args.includes('--links');
+const iterations = Math.max(1, parseInt(getArg('--iterations') || '20', 10) || 20);
 
 const FIXTURES_DIR = path.join(__dirname, '../tests/golden/fixtures');
 
@@ -419,7 +426,95 @@ function benchmarkFixture(fixture, extractors) {
   };
 }
 
+/**
+ * Link classification benchmark: the selector-by-selector links.js path
+ * against LinkClassifier, both normalizing through UrlPolicy the way the
+ * crawler does. One classifier is shared per fixture host across
+ * iterations, like one crawl revisiting pages with the same menus.
+ */
+function runLinkBenchmark(fixtures) {
+  const cheerio = require('cheerio');
+  const Links = require('../src/core/crawler/links');
+  const { LinkClassifier } = require('../src/core/crawler/LinkClassifier');
+  const { UrlPolicy } = require('../src/core/crawler/urlPolicy');
+  const ArticleSignalsService = require('../src/core/crawler/ArticleSignalsService');
+
+  const pages = fixtures.map((fixture) => {
+    const baseUrl = fixture.url;
+    const host = new URL(baseUrl).hostname;
+    const policy = new UrlPolicy({ baseUrl });
+    const signals = new ArticleSignalsService({ baseUrl });
+    const counters = { legacy: 0, classifier: 0 };
+    const normalizer = (key) => (href) => {
+      counters[key] += 1;
+      const analysis = policy.analyze(href);
+      return analysis && !analysis.invalid ? analysis.normalized : null;
+    };
+    const isOnDomain = (url) => {
+      try { return new URL(url, baseUrl).hostname === host; } catch (_) { return false; }
+    };
+    const looksLikeArticle = (url) => signals.looksLikeArticle(url);
+    return {
+      fixture,
+      $: cheerio.load(fs.readFileSync(fixture.htmlPath, 'utf8')),
+      counters,
+      legacy: { normalizeUrl: normalizer('legacy'), isOnDomain, looksLikeArticle },
+      classifier: new LinkClassifier({ normalizeUrl: normalizer('classifier'), isOnDomain, looksLikeArticle })
+    };
+  });
+
+  const time = (fn) => {
+    const started = process.hrtime.bigint();
+    for (let i = 0; i < iterations; i += 1) {
+      for (const page of pages) fn(page);
+    }
+    return Number(process.hrtime.bigint() - started) / 1e6;
+  };
+
+  const legacyMs = time((page) => {
+    const { normalizeUrl, isOnDomain, looksLikeArticle } = page.legacy;
+    Links.findNavigationLinks(page.$, normalizeUrl, isOnDomain).filter((link) => link.onDomain);
+    Links.findArticleLinks(page.$, normalizeUrl, looksLikeArticle, isOnDomain);
+  });
+  const classifierMs = time((page) => page.classifier.classify(page.$));
+
+  const normalizeCalls = pages.reduce((acc, page) => {
+    acc.legacy += page.counters.legacy;
+    acc.classifier += page.counters.classifier;
+    return acc;
+  }, { legacy: 0, classifier: 0 });
+  const result = {
+    fixtures: pages.length,
+    iterations,
+    legacyMs: Number(legacyMs.toFixed(1)),
+    classifierMs: Number(classifierMs.toFixed(1)),
+    speedup: classifierMs > 0 ? Number((legacyMs / classifierMs).toFixed(2)) : null,
+    normalizeCalls
+  };
+
+  if (jsonOutput) {
+    console.log(JSON.stringify(result, null, 2));
+  } else {
+    console.log('🔗 Link classification benchmark');
+    console.log(`   Fixtures: ${result.fixtures} × ${iterations} iterations`);
+    console.log(`   links.js:       ${result.legacyMs}ms (${normalizeCalls.legacy} normalizeUrl calls)`);
+    console.log(`   LinkClassifier: ${result.classifierMs}ms (${normalizeCalls.classifier} normalizeUrl calls)`);
+    console.log(`   Speedup: ${result.speedup}×`);
+  }
+  return result;
+}
+
 async function main() {
+  if (linksMode) {
+    const fixtures = discoverFixtures();
+    if (fixtures.length === 0) {
+      console.error('❌ No fixtures found.');
+      process.exit(1);
+    }
+    runLinkBenchmark(fixtures);
+    return;
+  }
+
   const extractors = loadExtractors();
   const extractorNames = Object.keys(extractors);
   
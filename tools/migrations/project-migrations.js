@@ -0,0 +1,62 @@
+#!/usr/bin/env node
+'use strict';
+
+/**
+ * Apply the project-owned schema migrations (src/data/db/sqlite/projectMigrations.js)
+ *
+ * ensureDb applies these on open; this runs them against a database without
+ * going through the crawler.
+ *
+ * Usage:
+ *   node tools/migrations/project-migrations.js            # apply to data/news.db
+ *   node tools/migrations/project-migrations.js --db path/to/news.db
+ *   node tools/migrations/project-migrations.js --status   # check only, no writes
+ */
+
+const path = require('path');
+const { openNewsCrawlerDb } = require('../../src/db/openNewsCrawlerDb');
+const { findProjectRoot } = require('../../src/shared/utils/project-root');
+const {
+  applyProjectMigrations,
+  getProjectMigrationStatus
+} = require('../../src/data/db/sqlite/projectMigrations');
+
+async function main() {
+  const args = process.argv.slice(2);
+  let dbPath;
+  const dbIndex = args.indexOf('--db');
+  if (dbIndex !== -1 && args[dbIndex + 1]) {
+    dbPath = args[dbIndex + 1];
+  } else {
+    dbPath = path.join(findProjectRoot(__dirname), 'data', 'news.db');
+  }
+
+  console.log(`[Migration] Using database: ${dbPath}`);
+
+  const db = openNewsCrawlerDb(dbPath);
+  try {
+    if (args.includes('--status')) {
+      const status = getProjectMigrationStatus(db);
+      for (const entry of status) {
+        console.log(`[Migration] ${entry.name}: ${entry.applied ? 'applied' : 'pending'}`);
+      }
+      return status;
+    }
+    const applied = applyProjectMigrations(db);
+    console.log(applied.length
+      ? `[Migration] Applied: ${applied.join(', ')}`
+      : '[Migration] Already applied; nothing to do.');
+    return applied;
+  } finally {
+    await db.close();
+  }
+}
+
+if (require.main === module) {
+  main().then(() => process.exit(0)).catch((error) => {
+    console.error('[Migration] Failed:', error.message);
+    process.exit(1);
+  });
+}
+
+module.exports = { main };